@@ -0,0 +1,288 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/AnchoredRegex.h"
+
+#include <re2/re2.h>
+
+#include <cctype>
+#include <cstring>
+#include <vector>
+
+#include "common/StringTools.h"
+
+using namespace std;
+
+namespace logtail {
+
+// Longer prefixes hardly reject more lines.
+static const int kMaxPrefilterLength = 16;
+
+// boost::regex matches \s against \v as well.
+static const char kSpaceChars[] = "\\t\\n\\v\\f\\r ";
+// boost::regex matches $ at the end or before a line separator, and the separator can be consumed as long as nothing
+// follows $ in the pattern.
+static const char kEndOfLine[] = "(?:[\\n\\f\\r]|\\z)";
+
+// TranslateForRE2 rewrites @pattern so that RE2 matches the same as boost::regex with perl syntax, where ^ and $
+// match at line separators (\n, \f and \r), \s matches \v, and (?i) only folds ASCII letters.
+// @return false if the pattern contains constructs that cannot be translated, e.g. ^ or $ in the middle of the
+//   pattern, \S in a character class, inline flags other than i, or case folding with non-ASCII characters.
+static bool TranslateForRE2(const string& pattern, string& res) {
+    res.clear();
+    res.reserve(pattern.size());
+    bool caseInsensitive = false;
+    bool hasNonAscii = false;
+    // whether nothing is consumed before the current position, for each open group
+    vector<bool> groupAtStart;
+    bool atStart = true;
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        char c = pattern[i];
+        if (static_cast<unsigned char>(c) >= 0x80) {
+            hasNonAscii = true;
+        }
+        switch (c) {
+            case '\\': {
+                if (i + 1 == pattern.size()) {
+                    return false;
+                }
+                char next = pattern[++i];
+                if (next == 's') {
+                    res.append("[").append(kSpaceChars).append("]");
+                } else if (next == 'S') {
+                    res.append("[^").append(kSpaceChars).append("]");
+                } else if (next == 'v' || next == '\'' || next == '`') {
+                    // vertical whitespace and buffer boundaries in boost::regex
+                    return false;
+                } else if (next == 'Q') {
+                    size_t end = pattern.find("\\E", i + 1);
+                    end = end == string::npos ? pattern.size() : end + 2;
+                    res.append(pattern, i - 1, end - i + 1);
+                    for (size_t j = i + 1; j < end; ++j) {
+                        hasNonAscii |= static_cast<unsigned char>(pattern[j]) >= 0x80;
+                    }
+                    i = end - 1;
+                } else {
+                    // escaped code points may be non-ASCII
+                    hasNonAscii |= next == 'x' || (next >= '0' && next <= '9')
+                        || static_cast<unsigned char>(next) >= 0x80;
+                    res.push_back(c);
+                    res.push_back(next);
+                }
+                if (next != 'A' && next != 'b' && next != 'B') {
+                    atStart = false;
+                }
+                break;
+            }
+            case '[': {
+                res.push_back(c);
+                size_t j = i + 1;
+                if (j < pattern.size() && pattern[j] == '^') {
+                    res.push_back(pattern[j++]);
+                }
+                if (j < pattern.size() && pattern[j] == ']') {
+                    res.push_back(pattern[j++]);
+                }
+                for (; j < pattern.size() && pattern[j] != ']'; ++j) {
+                    hasNonAscii |= static_cast<unsigned char>(pattern[j]) >= 0x80;
+                    if (pattern[j] == '[' && j + 1 < pattern.size() && pattern[j + 1] == ':') {
+                        size_t end = pattern.find(":]", j + 2);
+                        if (end != string::npos) {
+                            res.append(pattern, j, end + 2 - j);
+                            j = end + 1;
+                            continue;
+                        }
+                    }
+                    if (pattern[j] == '\\' && j + 1 < pattern.size()) {
+                        char next = pattern[++j];
+                        if (next == 's') {
+                            res.append(kSpaceChars);
+                        } else if (next == 'S' || next == 'v') {
+                            return false;
+                        } else {
+                            hasNonAscii |= next == 'x' || (next >= '0' && next <= '9')
+                                || static_cast<unsigned char>(next) >= 0x80;
+                            res.push_back('\\');
+                            res.push_back(next);
+                        }
+                        continue;
+                    }
+                    res.push_back(pattern[j]);
+                }
+                if (j == pattern.size()) {
+                    return false;
+                }
+                res.push_back(']');
+                i = j;
+                atStart = false;
+                break;
+            }
+            case '(': {
+                res.push_back(c);
+                if (i + 1 < pattern.size() && pattern[i + 1] == '?') {
+                    size_t j = i + 2;
+                    while (j < pattern.size() && pattern[j] == 'i') {
+                        ++j;
+                    }
+                    caseInsensitive |= j > i + 2;
+                    if (j == pattern.size()) {
+                        return false;
+                    }
+                    if (pattern[j] == ')') {
+                        // flags for the rest of the enclosing group, e.g. (?i)
+                        res.append(pattern, i + 1, j - i);
+                        i = j;
+                        break;
+                    }
+                    if (pattern[j] == 'P' && j + 1 < pattern.size() && pattern[j + 1] == '<') {
+                        j = pattern.find('>', j);
+                        if (j == string::npos) {
+                            return false;
+                        }
+                    } else if (isalpha(static_cast<unsigned char>(pattern[j])) || pattern[j] == '-') {
+                        return false;
+                    }
+                    // the group prefix, e.g. "?:" or "?P<name>", lookarounds are rejected by RE2 anyway
+                    res.append(pattern, i + 1, j - i);
+                    i = j;
+                }
+                groupAtStart.push_back(atStart);
+                break;
+            }
+            case ')':
+                res.push_back(c);
+                if (!groupAtStart.empty()) {
+                    groupAtStart.pop_back();
+                }
+                atStart = false;
+                break;
+            case '|':
+                res.push_back(c);
+                atStart = groupAtStart.empty() ? true : groupAtStart.back();
+                break;
+            case '^':
+                if (!atStart) {
+                    return false;
+                }
+                res.push_back(c);
+                break;
+            case '$': {
+                size_t j = i + 1;
+                size_t depth = groupAtStart.size();
+                while (j < pattern.size() && pattern[j] == ')' && depth > 0) {
+                    ++j;
+                    --depth;
+                }
+                if (j < pattern.size() && !(pattern[j] == '|' && depth == 0)) {
+                    return false;
+                }
+                res.append(kEndOfLine);
+                atStart = false;
+                break;
+            }
+            case '*':
+            case '+':
+            case '?':
+            case '{':
+                // quantifiers keep the position unchanged
+                res.push_back(c);
+                break;
+            default:
+                res.push_back(c);
+                atStart = false;
+                break;
+        }
+    }
+    return !(caseInsensitive && hasNonAscii);
+}
+
+AnchoredRegex::AnchoredRegex() = default;
+
+AnchoredRegex::~AnchoredRegex() = default;
+
+bool AnchoredRegex::Init(const string& pattern) {
+    mRE2.reset();
+    mBoostRegex.reset();
+    mLiteralPrefix.clear();
+    mHasNextByteRange = false;
+
+    // Match bytes as boost::regex does, where '.' matches '\n' as well.
+    RE2::Options options;
+    options.set_encoding(RE2::Options::EncodingLatin1);
+    options.set_dot_nl(true);
+    options.set_never_capture(true);
+    options.set_log_errors(false);
+    string re2Pattern;
+    unique_ptr<re2::RE2> re2;
+    if (TranslateForRE2(pattern, re2Pattern)) {
+        re2.reset(new re2::RE2(re2Pattern, options));
+    }
+    if (re2 && re2->ok()) {
+        mRE2 = std::move(re2);
+        InitPrefilter();
+        return true;
+    }
+    try {
+        mBoostRegex.reset(new boost::regex(pattern));
+    } catch (...) {
+        return false;
+    }
+    return true;
+}
+
+void AnchoredRegex::InitPrefilter() {
+    string min, max;
+    if (!mRE2->PossibleMatchRange(&min, &max, kMaxPrefilterLength)) {
+        return;
+    }
+    // Any match m satisfies min <= m <= max, so m starts with the common prefix of min and max.
+    size_t prefixLen = 0;
+    while (prefixLen < min.size() && prefixLen < max.size() && min[prefixLen] == max[prefixLen]) {
+        ++prefixLen;
+    }
+    mLiteralPrefix = min.substr(0, prefixLen);
+    // If min is longer than the prefix, m is longer than the prefix as well, and its next byte is bounded.
+    if (prefixLen < min.size() && prefixLen < max.size()) {
+        mHasNextByteRange = true;
+        mNextByteMin = static_cast<unsigned char>(min[prefixLen]);
+        mNextByteMax = static_cast<unsigned char>(max[prefixLen]);
+    }
+}
+
+bool AnchoredRegex::Prefilter(const char* data, size_t size) const {
+    if (size < mLiteralPrefix.size() || memcmp(data, mLiteralPrefix.data(), mLiteralPrefix.size()) != 0) {
+        return false;
+    }
+    if (mHasNextByteRange) {
+        if (size == mLiteralPrefix.size()) {
+            return false;
+        }
+        auto next = static_cast<unsigned char>(data[mLiteralPrefix.size()]);
+        return next >= mNextByteMin && next <= mNextByteMax;
+    }
+    return true;
+}
+
+bool AnchoredRegex::Match(const char* data, size_t size, string& exception) const {
+    if (mRE2) {
+        return Prefilter(data, size)
+            && mRE2->Match(re2::StringPiece(data, size), 0, size, RE2::ANCHOR_START, nullptr, 0);
+    }
+    if (mBoostRegex) {
+        return BoostRegexSearch(data, size, *mBoostRegex, exception);
+    }
+    return false;
+}
+
+} // namespace logtail
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include <boost/regex.hpp>
+
+namespace re2 {
+class RE2;
+}
+
+namespace logtail {
+
+// AnchoredRegex tells whether a regex matches at the beginning of a string, the same as BoostRegexSearch
+// (boost::match_continuous). It is meant for patterns evaluated against every line, e.g. multiline patterns.
+// The pattern is compiled by RE2 into a DFA whenever RE2 supports it. Since RE2 differs from boost::regex in a few
+// places, the pattern is translated first: \s matches \v as well, and a trailing $ matches before \n, \f and \r.
+// Patterns that cannot be translated (^ or $ in the middle, \v, inline flags other than i, case folding with
+// non-ASCII characters, etc.) and those RE2 does not support (backreferences, lookarounds, etc.) use boost::regex.
+// Besides, a prefilter is extracted from the pattern: the literal prefix all matches start with and the range of the
+// byte following it (e.g. '0'-'9' for a timestamp), so that most unmatched lines are rejected by comparing a few bytes.
+// Match is thread-safe.
+class AnchoredRegex {
+public:
+    AnchoredRegex();
+    ~AnchoredRegex();
+
+    // @return false if @pattern is supported by neither RE2 nor boost::regex.
+    bool Init(const std::string& pattern);
+    // @param exception is appended with the reason if boost::regex throws.
+    bool Match(const char* data, size_t size, std::string& exception) const;
+
+    bool IsDfaCompiled() const { return mRE2 != nullptr; }
+
+private:
+    void InitPrefilter();
+    bool Prefilter(const char* data, size_t size) const;
+
+    std::unique_ptr<re2::RE2> mRE2;
+    std::unique_ptr<boost::regex> mBoostRegex;
+    std::string mLiteralPrefix;
+    bool mHasNextByteRange = false;
+    unsigned char mNextByteMin = 0;
+    unsigned char mNextByteMax = 0xff;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class AnchoredRegexUnittest;
+#endif
+};
+
+} // namespace logtail
@@ -13,10 +13,17 @@
 // limitations under the License.
 
 #include "EncodingConverter.h"
+
+#include <cstdint>
+#include <cstring>
+
 #include "AlarmManager.h"
 #include "logger/Logger.h"
 #if defined(__linux__)
 #include <iconv.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 #elif defined(_MSC_VER)
 #include <Windows.h>
 #endif
@@ -24,68 +31,182 @@
 namespace logtail {
 
 #if defined(__linux__)
-static iconv_t mGbk2Utf8Cd = (iconv_t)-1;
+namespace {
+
+// UTF-8 encoding of a GBK char, mLen is 0 if the char is invalid. GBK only covers BMP, so 3 bytes are enough.
+struct Utf8Char {
+    uint8_t mLen = 0;
+    char mBytes[3] = {0, 0, 0};
+};
+
+const uint8_t kGbkLeadMin = 0x81, kGbkLeadMax = 0xFE, kGbkTrailMin = 0x40, kGbkTrailMax = 0xFE;
+const size_t kGbkTrailCount = kGbkTrailMax - kGbkTrailMin + 1;
+
+// Both tables are generated by iconv once, so conversion results are exactly the same as iconv's.
+// sGbkSingleTable is indexed by bytes in [0x80, 0xFF], e.g. 0x80 is € in GBK of glibc.
+std::vector<Utf8Char> sGbkSingleTable;
+// sGbkDoubleTable is indexed by (lead - kGbkLeadMin) * kGbkTrailCount + (trail - kGbkTrailMin).
+std::vector<Utf8Char> sGbkDoubleTable;
+
+Utf8Char ConvertWithIconv(iconv_t cd, const char* gbk, size_t len) {
+    Utf8Char res;
+    char* src = const_cast<char*>(gbk);
+    char buf[8];
+    char* des = buf;
+    size_t srcLeft = len, desLeft = sizeof(buf);
+    iconv(cd, NULL, NULL, NULL, NULL);
+    if (iconv(cd, &src, &srcLeft, &des, &desLeft) != (size_t)(-1) && srcLeft == 0) {
+        size_t outLen = des - buf;
+        // a valid char converted from the whole input, rather than an ASCII char followed by another one
+        if (outLen > 0 && outLen <= sizeof(res.mBytes) && static_cast<uint8_t>(buf[0]) >= 0x80) {
+            res.mLen = outLen;
+            memcpy(res.mBytes, buf, outLen);
+        }
+    }
+    return res;
+}
+
+// ConvertGbk2Utf8Lines converts @src to @des, which must be able to hold 3 * @srcLen bytes. A line containing any
+// invalid or incomplete GBK char is copied to @des as it is, and the number of such lines is returned in
+// @failedLines. GBK trail bytes never conflict with ASCII chars, so lines can be split after conversion starts.
+size_t ConvertGbk2Utf8Lines(const char* src, size_t srcLen, char* des, size_t& failedLines) {
+    const uint8_t* s = reinterpret_cast<const uint8_t*>(src);
+    char* d = des;
+    size_t i = 0;
+    failedLines = 0;
+    while (i < srcLen) {
+        // ASCII fast path. At most 3 bytes are written for each byte read (e.g. 0x80 is €), so d <= des + 3 * i,
+        // and stores of whole blocks never exceed @des.
+#if defined(__SSE2__)
+        while (i + 16 <= srcLen) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d), block);
+            int mask = _mm_movemask_epi8(block);
+            if (mask != 0) {
+                int asciiLen = __builtin_ctz(mask);
+                i += asciiLen;
+                d += asciiLen;
+                break;
+            }
+            i += 16;
+            d += 16;
+        }
+#else
+        while (i + 8 <= srcLen) {
+            uint64_t block;
+            memcpy(&block, s + i, 8);
+            if (block & 0x8080808080808080ULL) {
+                break;
+            }
+            memcpy(d, &block, 8);
+            i += 8;
+            d += 8;
+        }
+#endif
+        while (i < srcLen && s[i] < 0x80) {
+            *d++ = s[i++];
+        }
+
+        while (i < srcLen && s[i] >= 0x80) {
+            const Utf8Char* ch = &sGbkSingleTable[s[i] - 0x80];
+            size_t gbkLen = 1;
+            if (ch->mLen == 0 && s[i] >= kGbkLeadMin && s[i] <= kGbkLeadMax && i + 1 < srcLen
+                && s[i + 1] >= kGbkTrailMin && s[i + 1] <= kGbkTrailMax) {
+                ch = &sGbkDoubleTable[(s[i] - kGbkLeadMin) * kGbkTrailCount + (s[i + 1] - kGbkTrailMin)];
+                gbkLen = 2;
+            }
+            if (ch->mLen > 0) {
+                memcpy(d, ch->mBytes, ch->mLen);
+                d += ch->mLen;
+                i += gbkLen;
+                continue;
+            }
+
+            // copy the whole line as it is, the line has been converted from @lineBegin to i so far
+            ++failedLines;
+            size_t lineBegin = i;
+            while (lineBegin > 0 && s[lineBegin - 1] != '\n') {
+                --lineBegin;
+            }
+            for (size_t j = lineBegin; j < i;) {
+                if (s[j] < 0x80) {
+                    --d;
+                    ++j;
+                } else {
+                    const Utf8Char& single = sGbkSingleTable[s[j] - 0x80];
+                    if (single.mLen > 0) {
+                        d -= single.mLen;
+                        ++j;
+                    } else {
+                        d -= sGbkDoubleTable[(s[j] - kGbkLeadMin) * kGbkTrailCount + (s[j + 1] - kGbkTrailMin)].mLen;
+                        j += 2;
+                    }
+                }
+            }
+            const void* lineFeed = memchr(s + i, '\n', srcLen - i);
+            size_t lineEnd = lineFeed == nullptr ? srcLen : static_cast<const uint8_t*>(lineFeed) - s + 1;
+            memcpy(d, s + lineBegin, lineEnd - lineBegin);
+            d += lineEnd - lineBegin;
+            i = lineEnd;
+            break;
+        }
+    }
+    return d - des;
+}
+
+} // namespace
 #endif
 
 EncodingConverter::EncodingConverter() {
 #if defined(__linux__)
-    mGbk2Utf8Cd = iconv_open("UTF-8", "GBK");
-    if (mGbk2Utf8Cd == (iconv_t)(-1))
+    iconv_t cd = iconv_open("UTF-8", "GBK");
+    if (cd == (iconv_t)(-1)) {
         LOG_ERROR(sLogger, ("create Gbk2Utf8 iconv descriptor fail, errno", strerror(errno)));
-    else
-        iconv(mGbk2Utf8Cd, NULL, NULL, NULL, NULL);
+        return;
+    }
+    sGbkSingleTable.resize(0x80);
+    for (size_t b = 0x80; b <= 0xFF; ++b) {
+        char gbk[1] = {static_cast<char>(b)};
+        sGbkSingleTable[b - 0x80] = ConvertWithIconv(cd, gbk, 1);
+    }
+    sGbkDoubleTable.resize((kGbkLeadMax - kGbkLeadMin + 1) * kGbkTrailCount);
+    for (size_t lead = kGbkLeadMin; lead <= kGbkLeadMax; ++lead) {
+        for (size_t trail = kGbkTrailMin; trail <= kGbkTrailMax; ++trail) {
+            char gbk[2] = {static_cast<char>(lead), static_cast<char>(trail)};
+            sGbkDoubleTable[(lead - kGbkLeadMin) * kGbkTrailCount + (trail - kGbkTrailMin)]
+                = ConvertWithIconv(cd, gbk, 2);
+        }
+    }
+    iconv_close(cd);
 #endif
 }
 
 EncodingConverter::~EncodingConverter() {
-#if defined(__linux__)
-    if (mGbk2Utf8Cd != (iconv_t)(-1))
-        iconv_close(mGbk2Utf8Cd);
-#endif
 }
 
 // TODO: Refactor it, do not use the output params to do calculations, set them before return.
 size_t EncodingConverter::ConvertGbk2Utf8(
     const char* src, size_t* srcLength, char* desOut, size_t desLength, const std::vector<long>& linePosVec) const {
 #if defined(__linux__)
-    if (src == NULL || *srcLength == 0 || mGbk2Utf8Cd == (iconv_t)(-1)) {
-        LOG_ERROR(sLogger, ("invalid iconv descriptor fail or invalid buffer pointer, cd", mGbk2Utf8Cd));
+    if (src == NULL || *srcLength == 0 || sGbkDoubleTable.empty()) {
+        LOG_ERROR(sLogger, ("invalid GBK conversion table or invalid buffer pointer, src length", *srcLength));
         return 0;
     }
-    size_t maxRequire = *srcLength * 2;
+    // a single byte char may take 3 bytes in UTF-8
+    size_t maxRequire = *srcLength * 3;
     if (desOut == nullptr) {
         return maxRequire;
     }
     if (desLength < maxRequire + 1) {
         return 0;
     }
-    char* des = desOut;
-    des[*srcLength * 2] = '\0';
-    const char* originSrc = src;
-    char* originDes = des;
-    size_t beginIndex = 0;
-    size_t endIndex = *srcLength;
-    size_t destIndex = 0;
-    size_t maxDestSize = desLength;
-    for (size_t i = 0; i < linePosVec.size(); ++i) {
-        endIndex = linePosVec[i];
-        src = originSrc + beginIndex;
-        des = originDes + destIndex;
-        // include '\n'
-        *srcLength = endIndex - beginIndex + 1;
-        desLength = maxDestSize - destIndex;
-        size_t ret = iconv(mGbk2Utf8Cd, const_cast<char**>(&src), srcLength, &des, &desLength);
-        if (ret == (size_t)(-1)) {
-            LOG_ERROR(sLogger, ("convert GBK to UTF8 fail, errno", strerror(errno)));
-            iconv(mGbk2Utf8Cd, NULL, NULL, NULL, NULL); // Clear status.
-            AlarmManager::GetInstance()->SendAlarm(ENCODING_CONVERT_ALARM, "convert GBK to UTF8 fail");
-            // use memcpy
-            memcpy(originDes + destIndex, originSrc + beginIndex, endIndex - beginIndex + 1);
-            destIndex += endIndex - beginIndex + 1;
-        } else {
-            destIndex = des - originDes;
-        }
-        beginIndex = endIndex + 1;
+    desOut[maxRequire] = '\0';
+    size_t failedLines = 0;
+    size_t destIndex = ConvertGbk2Utf8Lines(src, *srcLength, desOut, failedLines);
+    desOut[destIndex] = '\0';
+    if (failedLines > 0) {
+        LOG_ERROR(sLogger, ("convert GBK to UTF8 fail, lines copied without conversion", failedLines));
+        AlarmManager::GetInstance()->SendAlarm(ENCODING_CONVERT_ALARM, "convert GBK to UTF8 fail");
     }
     return destIndex;
 
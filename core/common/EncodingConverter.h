@@ -46,7 +46,7 @@ public:
     //          This API design mimics snprintf.
     //
     // Different platforms have different implementations:
-    // - For Linux, ConvertGbk2Utf8 converts line by line according to @linePosVec.
+    // - For Linux, ConvertGbk2Utf8 converts whole @src with tables generated by iconv (ignore @linePosVec).
     //   If there is error happened during converting, corresponding line will be copied
     //   to @des without converting.
     // - For Windows, ConvertGbk2Utf8 converts whole @src, if any errors happened,
@@ -274,6 +274,21 @@ FILE* FileWriteOnlyOpen(const char* filePath, const char* mode) {
 #endif
 }
 
+FILE* FileReadWriteOpen(const char* filePath, const char* mode) {
+#if defined(__linux__)
+    return fopen(filePath, mode);
+#elif defined(_MSC_VER)
+    HANDLE hFile = CreateFile(filePath,
+                              GENERIC_READ | GENERIC_WRITE,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              NULL,
+                              OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL,
+                              NULL);
+    return FromFileHandle(hFile, _O_RDWR, mode);
+#endif
+}
+
 FILE* FileAppendOpen(const char* filePath, const char* mode) {
 #if defined(__linux__)
     FILE* f = fopen(filePath, mode);
@@ -108,6 +108,8 @@ bool GetAllFiles(const std::string& dirPath, const std::string& filePattern, std
 // Functions will not check the @mode param, make sure what you pass is right.
 FILE* FileReadOnlyOpen(const char* filePath, const char* mode = "r");
 FILE* FileWriteOnlyOpen(const char* filePath, const char* mode = "w");
+// opens an existing file for both reading and writing
+FILE* FileReadWriteOpen(const char* filePath, const char* mode = "rb+");
 FILE* FileAppendOpen(const char* filePath, const char* mode = "a");
 
 // Logtail will ignore files with special suffix.
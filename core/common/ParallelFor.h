@@ -0,0 +1,57 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace logtail {
+
+// ParallelFor calls @func(i) for each i in [0, @count) on at most @maxThreadNum threads, the calling thread
+// included, and returns after all calls finish. Indexes are handed out one by one, so calls of uneven cost
+// are balanced among threads. @func must be safe to be called concurrently.
+template <typename Func>
+void ParallelFor(size_t count, size_t maxThreadNum, const Func& func) {
+    size_t threadNum = std::min(std::max(maxThreadNum, static_cast<size_t>(1)), count);
+    if (threadNum <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            func(i);
+        }
+        return;
+    }
+
+    std::atomic_size_t next(0);
+    auto worker = [&]() {
+        for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+            func(i);
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(threadNum - 1);
+    for (size_t i = 0; i + 1 < threadNum; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+} // namespace logtail
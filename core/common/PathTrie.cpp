@@ -0,0 +1,130 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/PathTrie.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "common/FileSystemUtil.h"
+
+using namespace std;
+
+namespace logtail {
+
+bool PathTrie::NextComponent(const string& path, size_t& pos, StringView& component) {
+    const char sep = PATH_SEPARATOR[0];
+    while (pos < path.size() && path[pos] == sep) {
+        ++pos;
+    }
+    if (pos >= path.size()) {
+        return false;
+    }
+    size_t end = path.find(sep, pos);
+    if (end == string::npos) {
+        end = path.size();
+    }
+    component = StringView(path.data() + pos, end - pos);
+    pos = end;
+    return true;
+}
+
+void PathTrie::Insert(const string& path, size_t value) {
+    Node* node = &mRoot;
+    size_t pos = 0;
+    StringView component;
+    while (NextComponent(path, pos, component)) {
+        auto iter = node->mChildren.find(component);
+        if (iter == node->mChildren.end()) {
+            iter = node->mChildren.emplace(string(component.data(), component.size()), make_unique<Node>()).first;
+        }
+        node = iter->second.get();
+    }
+    node->mValues.push_back(value);
+    ++mSize;
+}
+
+bool PathTrie::Erase(const string& path, size_t value) {
+    // Record nodes on the path, so that nodes left empty can be removed from the deepest.
+    vector<pair<Node*, StringView>> parents;
+    Node* node = &mRoot;
+    size_t pos = 0;
+    StringView component;
+    while (NextComponent(path, pos, component)) {
+        auto iter = node->mChildren.find(component);
+        if (iter == node->mChildren.end()) {
+            return false;
+        }
+        parents.emplace_back(node, component);
+        node = iter->second.get();
+    }
+    auto valueIter = find(node->mValues.begin(), node->mValues.end(), value);
+    if (valueIter == node->mValues.end()) {
+        return false;
+    }
+    node->mValues.erase(valueIter);
+    --mSize;
+
+    while (!parents.empty() && node->mValues.empty() && node->mChildren.empty()) {
+        node = parents.back().first;
+        node->mChildren.erase(node->mChildren.find(parents.back().second));
+        parents.pop_back();
+    }
+    return true;
+}
+
+void PathTrie::Clear() {
+    mRoot.mChildren.clear();
+    mRoot.mValues.clear();
+    mSize = 0;
+}
+
+bool PathTrie::FindLongestPrefix(const string& path, size_t& value) const {
+    const Node* found = mRoot.mValues.empty() ? nullptr : &mRoot;
+    const Node* node = &mRoot;
+    size_t pos = 0;
+    StringView component;
+    while (NextComponent(path, pos, component)) {
+        auto iter = node->mChildren.find(component);
+        if (iter == node->mChildren.end()) {
+            break;
+        }
+        node = iter->second.get();
+        if (!node->mValues.empty()) {
+            found = node;
+        }
+    }
+    if (found == nullptr) {
+        return false;
+    }
+    value = *min_element(found->mValues.begin(), found->mValues.end());
+    return true;
+}
+
+void PathTrie::FindAllPrefixes(const string& path, vector<size_t>& values) const {
+    const Node* node = &mRoot;
+    values.insert(values.end(), node->mValues.begin(), node->mValues.end());
+    size_t pos = 0;
+    StringView component;
+    while (NextComponent(path, pos, component)) {
+        auto iter = node->mChildren.find(component);
+        if (iter == node->mChildren.end()) {
+            break;
+        }
+        node = iter->second.get();
+        values.insert(values.end(), node->mValues.begin(), node->mValues.end());
+    }
+}
+
+} // namespace logtail
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "models/StringView.h"
+
+namespace logtail {
+
+// PathTrie indexes absolute paths by their components, each path is associated with one or more
+// values (e.g. positions in a vector). Finding indexed paths which contain a given path costs
+// O(path length) regardless of the number of indexed paths.
+// Empty components are ignored, so /a//b/ and /a/b are the same path. Not thread-safe.
+class PathTrie {
+public:
+    void Insert(const std::string& path, size_t value);
+    // @return false if @value is not associated with @path.
+    bool Erase(const std::string& path, size_t value);
+    void Clear();
+
+    // FindLongestPrefix finds the deepest indexed path that is @path itself or an ancestor of @path.
+    // If multiple values are associated with the found path, the smallest one is returned.
+    // @return false if no such path is indexed.
+    bool FindLongestPrefix(const std::string& path, size_t& value) const;
+    // FindAllPrefixes appends values of all indexed paths that are @path itself or ancestors of @path,
+    // from the shallowest to the deepest.
+    void FindAllPrefixes(const std::string& path, std::vector<size_t>& values) const;
+
+    size_t Size() const { return mSize; }
+
+private:
+    struct Node {
+        std::map<std::string, std::unique_ptr<Node>, std::less<>> mChildren;
+        std::vector<size_t> mValues;
+    };
+
+    // NextComponent gets the component of @path starting from @pos and moves @pos to its end.
+    // @return false if there are no more components.
+    static bool NextComponent(const std::string& path, size_t& pos, StringView& component);
+
+    Node mRoot;
+    size_t mSize = 0;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class PathTrieUnittest;
+#endif
+};
+
+} // namespace logtail
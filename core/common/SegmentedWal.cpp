@@ -0,0 +1,378 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/SegmentedWal.h"
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <xxhash/xxhash.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/ErrorUtil.h"
+#include "common/FileSystemUtil.h"
+#include "common/StringTools.h"
+
+using namespace std;
+
+namespace logtail {
+
+const char kWalSegmentMagic[8] = {'L', 'W', 'A', 'L', 'S', 'E', 'G', '1'};
+
+static const size_t kSequenceWidth = 20;
+
+bool WalSegment::Create(const string& path, size_t size, string& errorMsg) {
+    Close();
+    if (size < kHeaderSize + kRecordHeaderSize) {
+        errorMsg = "segment size is too small: " + ToString(size);
+        return false;
+    }
+    mPath = path;
+    mSize = size;
+#if defined(__linux__)
+    mFd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (mFd < 0) {
+        errorMsg = "failed to create segment " + path + ": " + ErrnoToString(GetErrno());
+        return false;
+    }
+    // preallocated, so that appending never extends the file and a full disk is detected on creation
+    int err = posix_fallocate(mFd, 0, static_cast<off_t>(size));
+    if (err != 0 && (err != EOPNOTSUPP || ftruncate(mFd, static_cast<off_t>(size)) != 0)) {
+        errorMsg = "failed to allocate segment " + path + ": " + ErrnoToString(err);
+        Close();
+        remove(path.c_str());
+        return false;
+    }
+#else
+    mFile = FileWriteOnlyOpen(path.c_str(), "wb+");
+    if (mFile == nullptr) {
+        errorMsg = "failed to create segment " + path + ": " + ErrnoToString(GetErrno());
+        return false;
+    }
+    mBuffer.assign(size, '\0');
+    if (fwrite(mBuffer.data(), size, 1, mFile) != 1) {
+        errorMsg = "failed to allocate segment " + path + ": " + ErrnoToString(GetErrno());
+        Close();
+        remove(path.c_str());
+        return false;
+    }
+#endif
+    if (!Map(errorMsg)) {
+        Close();
+        remove(path.c_str());
+        return false;
+    }
+    uint64_t replayedOffset = kHeaderSize;
+    memcpy(mData, kWalSegmentMagic, sizeof(kWalSegmentMagic));
+    memcpy(mData + sizeof(kWalSegmentMagic), &replayedOffset, sizeof(replayedOffset));
+    mWriteOffset = kHeaderSize;
+    mSyncedOffset = 0;
+    return true;
+}
+
+bool WalSegment::Open(const string& path, string& errorMsg) {
+    Close();
+    mPath = path;
+#if defined(__linux__)
+    mFd = open(path.c_str(), O_RDWR);
+    if (mFd < 0) {
+        errorMsg = "failed to open segment " + path + ": " + ErrnoToString(GetErrno());
+        return false;
+    }
+    struct stat st;
+    if (fstat(mFd, &st) != 0) {
+        errorMsg = "failed to stat segment " + path + ": " + ErrnoToString(GetErrno());
+        Close();
+        return false;
+    }
+    mSize = static_cast<size_t>(st.st_size);
+#else
+    mFile = FileReadWriteOpen(path.c_str(), "rb+");
+    if (mFile == nullptr) {
+        errorMsg = "failed to open segment " + path + ": " + ErrnoToString(GetErrno());
+        return false;
+    }
+    fseek(mFile, 0, SEEK_END);
+    mSize = static_cast<size_t>(ftell(mFile));
+    fseek(mFile, 0, SEEK_SET);
+    mBuffer.resize(mSize);
+    if (mSize > 0 && fread(&mBuffer[0], mSize, 1, mFile) != 1) {
+        errorMsg = "failed to read segment " + path + ": " + ErrnoToString(GetErrno());
+        Close();
+        return false;
+    }
+#endif
+    if (mSize < kHeaderSize) {
+        errorMsg = "segment " + path + " is truncated";
+        Close();
+        return false;
+    }
+    if (!Map(errorMsg)) {
+        Close();
+        return false;
+    }
+    if (memcmp(mData, kWalSegmentMagic, sizeof(kWalSegmentMagic)) != 0) {
+        errorMsg = "not a segment: " + path;
+        Close();
+        return false;
+    }
+    uint64_t replayedOffset = 0;
+    memcpy(&replayedOffset, mData + sizeof(kWalSegmentMagic), sizeof(replayedOffset));
+    mReadOffset = static_cast<size_t>(min<uint64_t>(max<uint64_t>(replayedOffset, kHeaderSize), mSize));
+    mReplayedOffset = mReadOffset;
+    mCommittedOffset = mReadOffset;
+    mWriteOffset = mSize;
+    mSyncedOffset = mSize;
+    return true;
+}
+
+bool WalSegment::Map(string& errorMsg) {
+#if defined(__linux__)
+    void* addr = mmap(nullptr, mSize, PROT_READ | PROT_WRITE, MAP_SHARED, mFd, 0);
+    if (addr == MAP_FAILED) {
+        errorMsg = "failed to map segment " + mPath + ": " + ErrnoToString(GetErrno());
+        return false;
+    }
+    mData = static_cast<char*>(addr);
+#else
+    mData = &mBuffer[0];
+#endif
+    return true;
+}
+
+void WalSegment::Close() {
+#if defined(__linux__)
+    if (mData != nullptr) {
+        munmap(mData, mSize);
+    }
+    if (mFd >= 0) {
+        close(mFd);
+        mFd = -1;
+    }
+#else
+    if (mFile != nullptr) {
+        fclose(mFile);
+        mFile = nullptr;
+    }
+    string().swap(mBuffer);
+#endif
+    mData = nullptr;
+    mSize = 0;
+    mWriteOffset = 0;
+    mSyncedOffset = 0;
+    mReadOffset = 0;
+    mReplayedOffset = 0;
+    mCommittedOffset = 0;
+    mCorrupted = false;
+}
+
+bool WalSegment::Append(initializer_list<StringView> parts) {
+    if (mData == nullptr) {
+        return false;
+    }
+    size_t payloadSize = 0;
+    for (const auto& part : parts) {
+        payloadSize += part.size();
+    }
+    if (payloadSize == 0 || payloadSize > UINT32_MAX || mSize - mWriteOffset < kRecordHeaderSize + payloadSize) {
+        return false;
+    }
+    char* payload = mData + mWriteOffset + kRecordHeaderSize;
+    char* cur = payload;
+    for (const auto& part : parts) {
+        memcpy(cur, part.data(), part.size());
+        cur += part.size();
+    }
+    // the size is written last, so that a torn record is either invisible or fails the checksum
+    uint32_t hash = XXH32(payload, payloadSize, 0);
+    memcpy(mData + mWriteOffset + 4, &hash, sizeof(hash));
+    uint32_t size = static_cast<uint32_t>(payloadSize);
+    memcpy(mData + mWriteOffset, &size, sizeof(size));
+    mWriteOffset += kRecordHeaderSize + payloadSize;
+    return true;
+}
+
+bool WalSegment::Sync() {
+    if (mData == nullptr || mSyncedOffset == mWriteOffset) {
+        return true;
+    }
+#if defined(__linux__)
+    static const size_t sPageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t begin = mSyncedOffset / sPageSize * sPageSize;
+    if (msync(mData + begin, mWriteOffset - begin, MS_SYNC) != 0) {
+        return false;
+    }
+#else
+    fseek(mFile, static_cast<long>(mSyncedOffset), SEEK_SET);
+    if (fwrite(mData + mSyncedOffset, mWriteOffset - mSyncedOffset, 1, mFile) != 1 || fflush(mFile) != 0) {
+        return false;
+    }
+#endif
+    mSyncedOffset = mWriteOffset;
+    return true;
+}
+
+bool WalSegment::Next(StringView& payload) {
+    if (mData == nullptr || mCorrupted || mSize - mReadOffset < kRecordHeaderSize) {
+        return false;
+    }
+    uint32_t size = 0;
+    uint32_t hash = 0;
+    memcpy(&size, mData + mReadOffset, sizeof(size));
+    memcpy(&hash, mData + mReadOffset + 4, sizeof(hash));
+    if (size == 0) {
+        return false;
+    }
+    const char* data = mData + mReadOffset + kRecordHeaderSize;
+    if (mSize - mReadOffset - kRecordHeaderSize < size || XXH32(data, size, 0) != hash) {
+        mCorrupted = true;
+        return false;
+    }
+    payload = StringView(data, size);
+    mReadOffset += kRecordHeaderSize + size;
+    return true;
+}
+
+bool WalSegment::CommitReplayedOffset() {
+    if (mData == nullptr) {
+        return false;
+    }
+    if (mReplayedOffset == mCommittedOffset) {
+        return true;
+    }
+    uint64_t replayedOffset = mReplayedOffset;
+    memcpy(mData + sizeof(kWalSegmentMagic), &replayedOffset, sizeof(replayedOffset));
+#if defined(__linux__)
+    if (msync(mData, kHeaderSize, MS_SYNC) != 0) {
+        return false;
+    }
+#else
+    fseek(mFile, static_cast<long>(sizeof(kWalSegmentMagic)), SEEK_SET);
+    if (fwrite(&replayedOffset, sizeof(replayedOffset), 1, mFile) != 1 || fflush(mFile) != 0) {
+        return false;
+    }
+#endif
+    mCommittedOffset = mReplayedOffset;
+    return true;
+}
+
+bool SegmentedWal::Init(const string& dir, const string& prefix, size_t segmentSize, size_t maxSegmentCnt) {
+    lock_guard<mutex> lock(mMux);
+    mDir = dir;
+    mPrefix = prefix;
+    mSegmentSize = segmentSize;
+    mMaxSegmentCnt = maxSegmentCnt;
+    mNextSequence = 0;
+    for (const auto& path : ListSegments()) {
+        try {
+            mNextSequence = max(mNextSequence, StringTo<uint64_t>(path.substr(path.size() - kSequenceWidth)) + 1);
+        } catch (...) {
+        }
+    }
+    return mSegmentSize > WalSegment::kHeaderSize + WalSegment::kRecordHeaderSize;
+}
+
+void SegmentedWal::Stop() {
+    Seal();
+}
+
+bool SegmentedWal::Append(initializer_list<StringView> parts) {
+    size_t payloadSize = 0;
+    for (const auto& part : parts) {
+        payloadSize += part.size();
+    }
+    lock_guard<mutex> lock(mMux);
+    if (payloadSize > GetMaxRecordSize(mSegmentSize)) {
+        return false;
+    }
+    for (int i = 0; i < 2; ++i) {
+        if (!mHasActiveSegment) {
+            string seq = ToString(mNextSequence++);
+            string path = PathJoin(mDir, mPrefix + string(kSequenceWidth - min(seq.size(), kSequenceWidth), '0') + seq);
+            string errorMsg;
+            if (!mActiveSegment.Create(path, mSegmentSize, errorMsg)) {
+                return false;
+            }
+            mHasActiveSegment = true;
+        }
+        if (mActiveSegment.Append(parts)) {
+            return true;
+        }
+        // the active segment is full
+        mActiveSegment.Sync();
+        mActiveSegment.Close();
+        mHasActiveSegment = false;
+    }
+    return false;
+}
+
+bool SegmentedWal::Sync() {
+    lock_guard<mutex> lock(mMux);
+    return !mHasActiveSegment || mActiveSegment.Sync();
+}
+
+void SegmentedWal::Seal() {
+    lock_guard<mutex> lock(mMux);
+    if (!mHasActiveSegment) {
+        return;
+    }
+    mActiveSegment.Sync();
+    mActiveSegment.Close();
+    mHasActiveSegment = false;
+}
+
+vector<string> SegmentedWal::GetSealedSegments() {
+    lock_guard<mutex> lock(mMux);
+    auto segments = ListSegments();
+    if (mHasActiveSegment) {
+        segments.erase(remove(segments.begin(), segments.end(), mActiveSegment.GetPath()), segments.end());
+    }
+    return segments;
+}
+
+size_t SegmentedWal::RemoveExcessSegments() {
+    auto segments = GetSealedSegments();
+    size_t cnt = 0;
+    for (size_t i = 0; i + mMaxSegmentCnt < segments.size(); ++i) {
+        if (remove(segments[i].c_str()) == 0) {
+            ++cnt;
+        }
+    }
+    return cnt;
+}
+
+vector<string> SegmentedWal::ListSegments() const {
+    vector<string> res;
+    fsutil::Dir dir(mDir);
+    if (!dir.Open()) {
+        return res;
+    }
+    fsutil::Entry ent;
+    while ((ent = dir.ReadNext(false))) {
+        const string& name = ent.Name();
+        if (name.size() == mPrefix.size() + kSequenceWidth && StartWith(name, mPrefix)
+            && all_of(name.begin() + mPrefix.size(), name.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            res.push_back(PathJoin(mDir, name));
+        }
+    }
+    sort(res.begin(), res.end());
+    return res;
+}
+
+} // namespace logtail
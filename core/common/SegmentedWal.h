@@ -0,0 +1,132 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "models/StringView.h"
+
+namespace logtail {
+
+// Segment file layout, all integers are in host byte order since segments never leave the host:
+//   segment := header record* zero padding
+//   header  := magic "LWALSEG1", u64 replayed offset
+//   record  := u32 payload size, u32 XXH32 of payload, payload
+// Segments are preallocated to a fixed size. On Linux they are accessed through shared mappings, so appending a record
+// is a memcpy and a group commit is a single msync covering all records appended since the previous one. A record
+// with zero size marks the end of a segment that was sealed before it was full.
+extern const char kWalSegmentMagic[8];
+
+class WalSegment {
+public:
+    static constexpr size_t kHeaderSize = 16;
+    static constexpr size_t kRecordHeaderSize = 8;
+
+    WalSegment() = default;
+    WalSegment(const WalSegment&) = delete;
+    WalSegment& operator=(const WalSegment&) = delete;
+    ~WalSegment() { Close(); }
+
+    // creates a new segment of the given size for appending
+    bool Create(const std::string& path, size_t size, std::string& errorMsg);
+    // opens an existing segment for replaying, starting from the replayed offset stored in the header
+    bool Open(const std::string& path, std::string& errorMsg);
+    void Close();
+
+    // payload is the concatenation of parts. Returns false if the record does not fit into the remaining space.
+    bool Append(std::initializer_list<StringView> parts);
+    // flushes records appended since the last call to disk
+    bool Sync();
+
+    // the returned view stays valid until the segment is closed. Returns false at the end of the segment or on a
+    // corrupted record, in which case IsCorrupted returns true.
+    bool Next(StringView& payload);
+    // marks the records returned by Next so far as replayed, which is only kept in memory until committed
+    void MarkReplayed() { mReplayedOffset = mReadOffset; }
+    // persists the offset marked by MarkReplayed, so that replay is resumed from there on reopening. Commits can be
+    // batched, since records replayed but not committed are only replayed again.
+    bool CommitReplayedOffset();
+
+    bool IsCorrupted() const { return mCorrupted; }
+    const std::string& GetPath() const { return mPath; }
+    size_t GetWriteOffset() const { return mWriteOffset; }
+
+private:
+    bool Map(std::string& errorMsg);
+
+    std::string mPath;
+    char* mData = nullptr;
+    size_t mSize = 0;
+    size_t mWriteOffset = 0;
+    size_t mSyncedOffset = 0;
+    size_t mReadOffset = 0;
+    size_t mReplayedOffset = 0;
+    size_t mCommittedOffset = 0;
+    bool mCorrupted = false;
+#if defined(__linux__)
+    int mFd = -1;
+#else
+    // where shared mappings are not available, segments are kept in memory and written through with stdio
+    FILE* mFile = nullptr;
+    std::string mBuffer;
+#endif
+};
+
+// A directory of segments named <prefix><sequence>. Records are appended to the active segment, which is sealed when
+// full or on demand. Only sealed segments are returned for replay. All methods are thread-safe.
+class SegmentedWal {
+public:
+    bool Init(const std::string& dir, const std::string& prefix, size_t segmentSize, size_t maxSegmentCnt);
+    void Stop();
+
+    // returns false if the record is larger than a segment or the segment cannot be created
+    bool Append(std::initializer_list<StringView> parts);
+    bool Sync();
+    void Seal();
+
+    // sorted from the oldest
+    std::vector<std::string> GetSealedSegments();
+    // the oldest sealed segments are removed when the count exceeds the limit, returns the number removed
+    size_t RemoveExcessSegments();
+
+    static size_t GetMaxRecordSize(size_t segmentSize) {
+        return segmentSize - WalSegment::kHeaderSize - WalSegment::kRecordHeaderSize;
+    }
+
+private:
+    std::vector<std::string> ListSegments() const;
+
+    std::mutex mMux;
+    std::string mDir;
+    std::string mPrefix;
+    size_t mSegmentSize = 0;
+    size_t mMaxSegmentCnt = 0;
+    uint64_t mNextSequence = 0;
+    WalSegment mActiveSegment;
+    bool mHasActiveSegment = false;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class SegmentedWalUnittest;
+#endif
+};
+
+} // namespace logtail
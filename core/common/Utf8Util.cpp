@@ -0,0 +1,138 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/Utf8Util.h"
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "models/LogEvent.h"
+
+namespace logtail {
+
+namespace {
+
+// SkipAscii returns the offset of the first non-ASCII byte in [@pos, @len), or @len if there is none.
+inline size_t SkipAscii(const uint8_t* s, size_t pos, size_t len) {
+#if defined(__SSE2__)
+    while (pos + 16 <= len) {
+        int mask = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + pos)));
+        if (mask != 0) {
+            return pos + __builtin_ctz(mask);
+        }
+        pos += 16;
+    }
+#else
+    while (pos + 8 <= len) {
+        uint64_t block;
+        memcpy(&block, s + pos, 8);
+        if (block & 0x8080808080808080ULL) {
+            break;
+        }
+        pos += 8;
+    }
+#endif
+    while (pos < len && s[pos] < 0x80) {
+        ++pos;
+    }
+    return pos;
+}
+
+inline bool IsContinuation(uint8_t c) {
+    return (c & 0xC0) == 0x80;
+}
+
+// CharLength returns the length of the valid multi-byte char starting at @s, or 0 if it is invalid.
+inline size_t CharLength(const uint8_t* s, size_t left) {
+    uint8_t c = s[0];
+    if (c < 0xC2) {
+        // continuation byte, or overlong 2-byte char
+        return 0;
+    }
+    if (c < 0xE0) {
+        return left >= 2 && IsContinuation(s[1]) ? 2 : 0;
+    }
+    if (c < 0xF0) {
+        if (left < 3 || !IsContinuation(s[1]) || !IsContinuation(s[2]) || (c == 0xE0 && s[1] < 0xA0)) {
+            return 0;
+        }
+        return 3;
+    }
+    if (c < 0xF5) {
+        if (left < 4 || !IsContinuation(s[1]) || !IsContinuation(s[2]) || !IsContinuation(s[3])
+            || (c == 0xF0 && s[1] < 0x90) || (c == 0xF4 && s[1] >= 0x90)) {
+            return 0;
+        }
+        return 4;
+    }
+    return 0;
+}
+
+} // namespace
+
+size_t FindNonUtf8(const char* data, size_t len) {
+    const uint8_t* s = reinterpret_cast<const uint8_t*>(data);
+    size_t pos = SkipAscii(s, 0, len);
+    while (pos < len) {
+        size_t charLen = CharLength(s + pos, len - pos);
+        if (charLen == 0) {
+            return pos;
+        }
+        pos = SkipAscii(s, pos + charLen, len);
+    }
+    return len;
+}
+
+size_t ReplaceNonUtf8(char* data, size_t len, char replacement) {
+    const uint8_t* s = reinterpret_cast<const uint8_t*>(data);
+    size_t replaced = 0;
+    for (size_t pos = FindNonUtf8(data, len); pos < len;) {
+        size_t charLen = CharLength(s + pos, len - pos);
+        if (charLen == 0) {
+            data[pos] = replacement;
+            ++replaced;
+            charLen = 1;
+        }
+        pos = SkipAscii(s, pos + charLen, len);
+    }
+    return replaced;
+}
+
+void ReplaceNonUtf8Contents(LogEvent& e) {
+    auto replace = [&e](StringView str) {
+        StringBuffer buffer = e.GetSourceBuffer()->CopyString(str);
+        ReplaceNonUtf8(buffer.data, buffer.size);
+        return StringView(buffer.data, buffer.size);
+    };
+    std::vector<std::pair<StringView, StringView>> newContents;
+    for (auto& content : e) {
+        if (!IsValidUtf8(content.second)) {
+            content.second = replace(content.second);
+        }
+        if (!IsValidUtf8(content.first)) {
+            newContents.emplace_back(replace(content.first), content.second);
+            e.DelContent(content.first);
+        }
+    }
+    for (auto& content : newContents) {
+        e.SetContentNoCopy(content.first, content.second);
+    }
+}
+
+} // namespace logtail
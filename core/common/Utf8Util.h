@@ -0,0 +1,48 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "models/StringView.h"
+
+namespace logtail {
+
+class LogEvent;
+
+// UTF-8 validation and repair over whole buffers. Runs of ASCII chars are checked a block at a time, so mostly
+// ASCII logs are scanned at near memcpy speed, and other chars are checked one by one.
+// Surrogates (U+D800 - U+DFFF) are accepted, which is what DiscardingNonUTF8 of processor_filter_regex_native
+// has always done; overlong encodings and code points beyond U+10FFFF are not.
+
+// FindNonUtf8 returns the offset of the first byte which is not part of a valid UTF-8 char, or @len if there is none.
+size_t FindNonUtf8(const char* data, size_t len);
+
+inline bool IsValidUtf8(StringView str) {
+    return FindNonUtf8(str.data(), str.size()) == str.size();
+}
+
+// ReplaceNonUtf8 replaces each byte which is not part of a valid UTF-8 char with @replacement in place, and returns
+// the number of bytes replaced. A byte is checked again as the start of a char after the one before it is replaced,
+// so only the lead byte of an invalid sequence is replaced if the bytes after it are valid by themselves.
+size_t ReplaceNonUtf8(char* data, size_t len, char replacement = ' ');
+
+// ReplaceNonUtf8Contents replaces bytes of invalid UTF-8 chars in keys and values of @e with spaces. Contents may refer
+// to memory not owned by the event, so only invalid ones are copied to the source buffer of @e and replaced there.
+void ReplaceNonUtf8Contents(LogEvent& e);
+
+} // namespace logtail
@@ -30,6 +30,7 @@ void Compressor::SetMetricRecordRef(MetricLabels&& labels, DynamicMetricLabels&&
     mOutItemsTotal = mMetricsRecordRef.CreateCounter(METRIC_COMPONENT_OUT_ITEMS_TOTAL);
     mOutItemSizeBytes = mMetricsRecordRef.CreateCounter(METRIC_COMPONENT_OUT_SIZE_BYTES);
     mTotalProcessMs = mMetricsRecordRef.CreateTimeCounter(METRIC_COMPONENT_TOTAL_PROCESS_TIME_MS);
+    mProcessLatencyUs = mMetricsRecordRef.CreateHistogram(METRIC_COMPONENT_PROCESS_LATENCY_US);
     mDiscardedItemsTotal = mMetricsRecordRef.CreateCounter(METRIC_COMPONENT_DISCARDED_ITEMS_TOTAL);
     mDiscardedItemSizeBytes = mMetricsRecordRef.CreateCounter(METRIC_COMPONENT_DISCARDED_SIZE_BYTES);
 }
@@ -44,7 +45,9 @@ bool Compressor::DoCompress(const string& input, string& output, string& errorMs
     auto res = Compress(input, output, errorMsg);
 
     if (mMetricsRecordRef != nullptr) {
-        mTotalProcessMs->Add(chrono::system_clock::now() - before);
+        auto cost = chrono::system_clock::now() - before;
+        mTotalProcessMs->Add(cost);
+        mProcessLatencyUs->Add(cost);
         if (res) {
             mOutItemsTotal->Add(1);
             mOutItemSizeBytes->Add(output.size());
@@ -47,6 +47,7 @@ protected:
     CounterPtr mDiscardedItemsTotal;
     CounterPtr mDiscardedItemSizeBytes;
     TimeCounterPtr mTotalProcessMs;
+    HistogramPtr mProcessLatencyUs;
 
 private:
     virtual bool Compress(const std::string& input, std::string& output, std::string& errorMsg) = 0;
@@ -14,6 +14,8 @@
 
 #include "common/timer/Timer.h"
 
+#include <vector>
+
 #include "logger/Logger.h"
 
 using namespace std;
@@ -44,43 +46,46 @@ void Timer::Stop() {
 
 void Timer::PushEvent(unique_ptr<TimerEvent>&& e) {
     lock_guard<mutex> lock(mQueueMux);
-    if (mQueue.empty() || e->GetExecTime() < mQueue.top()->GetExecTime()) {
-        mQueue.push(std::move(e));
+    auto execTime = e->GetExecTime();
+    mQueue.Add(execTime, std::move(e));
+    if (execTime < mNextWakeUpTime) {
+        mNextWakeUpTime = execTime;
         mCV.notify_one();
-    } else {
-        mQueue.push(std::move(e));
     }
 }
 
 void Timer::Run() {
     LOG_INFO(sLogger, ("timer", "started"));
+    vector<unique_ptr<TimerEvent>> events;
     unique_lock<mutex> threadLock(mThreadRunningMux);
     while (mIsThreadRunning) {
-        unique_lock<mutex> queueLock(mQueueMux);
-        if (mQueue.empty()) {
-            queueLock.unlock();
-            mCV.wait(threadLock, [this]() { return !mIsThreadRunning || !mQueue.empty(); });
-        } else {
-            auto now = chrono::steady_clock::now();
-            while (!mQueue.empty()) {
-                auto& e = mQueue.top();
-                if (now < e->GetExecTime()) {
-                    auto timeout = e->GetExecTime() - now + chrono::milliseconds(1);
-                    queueLock.unlock();
-                    mCV.wait_for(threadLock, timeout);
-                    break;
+        chrono::steady_clock::time_point nextTime;
+        {
+            lock_guard<mutex> queueLock(mQueueMux);
+            mQueue.Advance(chrono::steady_clock::now(), events);
+            nextTime = mQueue.GetNextCheckTime();
+            mNextWakeUpTime = nextTime;
+        }
+        if (!events.empty()) {
+            // events are executed without lock, since execution may push new events
+            for (auto& e : events) {
+                if (!e->IsValid()) {
+                    LOG_INFO(sLogger, ("invalid timer event", "task is cancelled"));
                 } else {
-                    auto e = std::move(const_cast<unique_ptr<TimerEvent>&>(mQueue.top()));
-                    mQueue.pop();
-                    queueLock.unlock();
-                    if (!e->IsValid()) {
-                        LOG_INFO(sLogger, ("invalid timer event", "task is cancelled"));
-                    } else {
-                        e->Execute();
-                    }
-                    queueLock.lock();
+                    e->Execute();
                 }
             }
+            events.clear();
+            continue;
+        }
+        auto pred = [this, nextTime]() {
+            lock_guard<mutex> queueLock(mQueueMux);
+            return !mIsThreadRunning || mNextWakeUpTime < nextTime;
+        };
+        if (nextTime == chrono::steady_clock::time_point::max()) {
+            mCV.wait(threadLock, pred);
+        } else {
+            mCV.wait_until(threadLock, nextTime, pred);
         }
     }
 }
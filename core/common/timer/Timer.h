@@ -20,18 +20,12 @@
 #include <future>
 #include <memory>
 #include <mutex>
-#include <queue>
 
 #include "common/timer/TimerEvent.h"
+#include "common/timer/TimingWheel.h"
 
 namespace logtail {
 
-struct TimerEventCompare {
-    bool operator()(const std::unique_ptr<TimerEvent>& lhs, const std::unique_ptr<TimerEvent>& rhs) const {
-        return lhs->GetExecTime() > rhs->GetExecTime();
-    }
-};
-
 class Timer {
 public:
     void Init();
@@ -42,8 +36,9 @@ private:
     void Run();
 
     mutable std::mutex mQueueMux;
-    std::priority_queue<std::unique_ptr<TimerEvent>, std::vector<std::unique_ptr<TimerEvent>>, TimerEventCompare>
-        mQueue;
+    TimingWheel<std::unique_ptr<TimerEvent>> mQueue;
+    // the time at which the timer thread will wake up next, guarded by mQueueMux
+    std::chrono::steady_clock::time_point mNextWakeUpTime = std::chrono::steady_clock::time_point::max();
 
     std::future<void> mThreadRes;
     mutable std::mutex mThreadRunningMux;
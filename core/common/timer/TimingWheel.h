@@ -0,0 +1,213 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace logtail {
+
+// Hierarchical timing wheel with millisecond ticks.
+//
+// Level 0 has one slot per tick, and each higher level has one slot per full revolution of the level below it, so
+// 4 levels of 64 slots cover 2^24 ms (about 4.6 hours). Entries farther in the future are parked in the last slot of
+// the top level and re-placed when that slot cascades. Add, Cancel and Reschedule are O(1); Advance only visits ticks
+// that actually hold entries or need cascading, so its cost does not depend on how long the wheel has been idle.
+//
+// An entry becomes due at the tick its expire time falls in, i.e. it may be returned up to one tick early.
+//
+// This class is not thread safe, callers must hold their own lock.
+template <typename T>
+class TimingWheel {
+public:
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    static constexpr uint32_t sLevelBits = 6;
+    static constexpr uint32_t sLevelSize = 1U << sLevelBits;
+    static constexpr uint32_t sLevelCnt = 4;
+    static constexpr int64_t sMaxTicks = (1LL << (sLevelBits * sLevelCnt)) - 1;
+
+    explicit TimingWheel(TimePoint start = std::chrono::steady_clock::now()) : mStartTime(start) {}
+
+    // returns a non-zero id which can be used to cancel or reschedule the entry
+    uint64_t Add(TimePoint expireTime, T&& data) {
+        uint64_t id = ++mLastId;
+        std::list<Entry> tmp;
+        tmp.push_back({id, ToTick(expireTime), std::move(data)});
+        auto it = tmp.begin();
+        auto& slot = GetSlot(it->mExpireTick);
+        slot.splice(slot.end(), tmp, it);
+        mIndex.try_emplace(id, &slot, it);
+        return id;
+    }
+
+    bool Cancel(uint64_t id) {
+        auto it = mIndex.find(id);
+        if (it == mIndex.end()) {
+            return false;
+        }
+        it->second.first->erase(it->second.second);
+        mIndex.erase(it);
+        return true;
+    }
+
+    bool Reschedule(uint64_t id, TimePoint expireTime) {
+        auto it = mIndex.find(id);
+        if (it == mIndex.end()) {
+            return false;
+        }
+        auto entry = it->second.second;
+        entry->mExpireTick = ToTick(expireTime);
+        auto& slot = GetSlot(entry->mExpireTick);
+        slot.splice(slot.end(), *it->second.first, entry);
+        it->second.first = &slot;
+        return true;
+    }
+
+    // move the data of all entries due at now into expired, in expiration order
+    void Advance(TimePoint now, std::vector<T>& expired) {
+        int64_t target = ToTick(now);
+        while (mCurrentTick < target) {
+            int64_t next = GetNextCheckTick();
+            if (next > target) {
+                mCurrentTick = target;
+                break;
+            }
+            mCurrentTick = next;
+            Cascade();
+            auto& slot = mSlots[0][mCurrentTick & (sLevelSize - 1)];
+            MoveToDue(slot);
+        }
+        for (auto& entry : mDueList) {
+            mIndex.erase(entry.mId);
+            expired.emplace_back(std::move(entry.mData));
+        }
+        mDueList.clear();
+    }
+
+    // the earliest time at which Advance may return something, or TimePoint::max() if the wheel is empty
+    TimePoint GetNextCheckTime() const {
+        if (!mDueList.empty()) {
+            return mStartTime + std::chrono::milliseconds(mCurrentTick);
+        }
+        if (mIndex.empty()) {
+            return TimePoint::max();
+        }
+        return mStartTime + std::chrono::milliseconds(GetNextCheckTick());
+    }
+
+    size_t Size() const { return mIndex.size(); }
+    bool Empty() const { return mIndex.empty(); }
+
+    void Clear() {
+        for (auto& level : mSlots) {
+            for (auto& slot : level) {
+                slot.clear();
+            }
+        }
+        mDueList.clear();
+        mIndex.clear();
+    }
+
+private:
+    struct Entry {
+        uint64_t mId;
+        int64_t mExpireTick;
+        T mData;
+    };
+
+    int64_t ToTick(TimePoint t) const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(t - mStartTime).count();
+    }
+
+    std::list<Entry>& GetSlot(int64_t expireTick) {
+        if (expireTick <= mCurrentTick) {
+            return mDueList;
+        }
+        int64_t delta = expireTick - mCurrentTick;
+        if (delta > sMaxTicks) {
+            expireTick = mCurrentTick + sMaxTicks;
+            delta = sMaxTicks;
+        }
+        uint32_t level = 0;
+        while (level + 1 < sLevelCnt && delta >= (1LL << (sLevelBits * (level + 1)))) {
+            ++level;
+        }
+        return mSlots[level][(expireTick >> (sLevelBits * level)) & (sLevelSize - 1)];
+    }
+
+    // the first tick after the current one at which some level-0 slot is due or some higher level slot cascades
+    int64_t GetNextCheckTick() const {
+        int64_t res = mCurrentTick + sMaxTicks + 1;
+        for (uint32_t level = 0; level < sLevelCnt; ++level) {
+            uint32_t shift = sLevelBits * level;
+            for (int64_t d = 1; d <= sLevelSize; ++d) {
+                int64_t tick = ((mCurrentTick >> shift) + d) << shift;
+                if (tick >= res) {
+                    break;
+                }
+                if (!mSlots[level][(tick >> shift) & (sLevelSize - 1)].empty()) {
+                    res = tick;
+                    break;
+                }
+            }
+        }
+        return res;
+    }
+
+    // re-place entries of higher level slots whose range starts at the current tick
+    void Cascade() {
+        for (uint32_t level = 1; level < sLevelCnt; ++level) {
+            uint32_t shift = sLevelBits * level;
+            if ((mCurrentTick & ((1LL << shift) - 1)) != 0) {
+                break;
+            }
+            auto& slot = mSlots[level][(mCurrentTick >> shift) & (sLevelSize - 1)];
+            while (!slot.empty()) {
+                auto it = slot.begin();
+                auto& dst = GetSlot(it->mExpireTick);
+                dst.splice(dst.end(), slot, it);
+                mIndex[it->mId].first = &dst;
+            }
+        }
+    }
+
+    void MoveToDue(std::list<Entry>& slot) {
+        for (auto it = slot.begin(); it != slot.end(); ++it) {
+            mIndex[it->mId].first = &mDueList;
+        }
+        mDueList.splice(mDueList.end(), slot);
+    }
+
+    const TimePoint mStartTime;
+    int64_t mCurrentTick = 0;
+    uint64_t mLastId = 0;
+    std::array<std::array<std::list<Entry>, sLevelSize>, sLevelCnt> mSlots;
+    std::list<Entry> mDueList;
+    std::unordered_map<uint64_t, std::pair<std::list<Entry>*, typename std::list<Entry>::iterator>> mIndex;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class TimingWheelUnittest;
+#endif
+};
+
+} // namespace logtail
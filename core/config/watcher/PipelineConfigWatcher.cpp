@@ -14,10 +14,13 @@
 
 #include "config/watcher/PipelineConfigWatcher.h"
 
+#include <algorithm>
 #include <memory>
 #include <unordered_set>
 
 #include "common/FileSystemUtil.h"
+#include "common/Flags.h"
+#include "common/ParallelFor.h"
 #include "config/ConfigUtil.h"
 #include "logger/Logger.h"
 #include "pipeline/PipelineManager.h"
@@ -25,6 +28,8 @@
 
 using namespace std;
 
+DEFINE_FLAG_INT32(config_load_thread_num, "max threads to load and parse config files, 1 for loading one by one", 8);
+
 namespace logtail {
 
 PipelineConfigWatcher::PipelineConfigWatcher()
@@ -55,6 +60,8 @@ pair<PipelineConfigDiff, TaskConfigDiff> PipelineConfigWatcher::CheckConfigDiff(
                         ("config dir path is not a directory", "skip current object")("dir path", dir.string()));
             continue;
         }
+        // config files to load, which are loaded and parsed in parallel afterwards
+        vector<pair<filesystem::path, bool>> configFiles;
         for (auto const& entry : filesystem::directory_iterator(dir, ec)) {
             // lock the dir if it is provided by config provider
             unique_lock<mutex> lock;
@@ -84,10 +91,40 @@ pair<PipelineConfigDiff, TaskConfigDiff> PipelineConfigWatcher::CheckConfigDiff(
             filesystem::file_time_type mTime = filesystem::last_write_time(path, ec);
             if (iter == mFileInfoMap.end()) {
                 mFileInfoMap[filepath] = make_pair(size, mTime);
-                unique_ptr<Json::Value> detail = make_unique<Json::Value>();
-                if (!LoadConfigDetailFromFile(path, *detail)) {
-                    continue;
-                }
+                configFiles.emplace_back(path, true);
+            } else if (iter->second.first != size || iter->second.second != mTime) {
+                // for config currently running, we leave it untouched if new config is invalid
+                mFileInfoMap[filepath] = make_pair(size, mTime);
+                configFiles.emplace_back(path, false);
+            } else {
+                LOG_DEBUG(sLogger, ("existing config file unchanged", "skip current object"));
+            }
+        }
+
+        vector<unique_ptr<Json::Value>> details(configFiles.size());
+        {
+            unique_lock<mutex> lock;
+            auto itr = mDirMutexMap.find(dir.string());
+            if (itr != mDirMutexMap.end()) {
+                lock = unique_lock<mutex>(*itr->second);
+            }
+            ParallelFor(configFiles.size(),
+                        static_cast<size_t>(max(INT32_FLAG(config_load_thread_num), 1)),
+                        [&](size_t i) {
+                            auto detail = make_unique<Json::Value>();
+                            if (LoadConfigDetailFromFile(configFiles[i].first, *detail)) {
+                                details[i] = std::move(detail);
+                            }
+                        });
+        }
+
+        for (size_t i = 0; i < configFiles.size(); ++i) {
+            const string& configName = configFiles[i].first.stem().string();
+            unique_ptr<Json::Value>& detail = details[i];
+            if (!detail) {
+                continue;
+            }
+            if (configFiles[i].second) {
                 if (!IsConfigEnabled(configName, *detail)) {
                     LOG_INFO(sLogger, ("new config found and disabled", "skip current object")("config", configName));
                     continue;
@@ -95,13 +132,7 @@ pair<PipelineConfigDiff, TaskConfigDiff> PipelineConfigWatcher::CheckConfigDiff(
                 if (!CheckAddedConfig(configName, std::move(detail), pDiff, tDiff)) {
                     continue;
                 }
-            } else if (iter->second.first != size || iter->second.second != mTime) {
-                // for config currently running, we leave it untouched if new config is invalid
-                mFileInfoMap[filepath] = make_pair(size, mTime);
-                unique_ptr<Json::Value> detail = make_unique<Json::Value>();
-                if (!LoadConfigDetailFromFile(path, *detail)) {
-                    continue;
-                }
+            } else {
                 if (!IsConfigEnabled(configName, *detail)) {
                     switch (GetConfigType(*detail)) {
                         case ConfigType::Pipeline:
@@ -134,8 +165,6 @@ pair<PipelineConfigDiff, TaskConfigDiff> PipelineConfigWatcher::CheckConfigDiff(
                 if (!CheckModifiedConfig(configName, std::move(detail), pDiff, tDiff)) {
                     continue;
                 }
-            } else {
-                LOG_DEBUG(sLogger, ("existing config file unchanged", "skip current object"));
             }
         }
     }
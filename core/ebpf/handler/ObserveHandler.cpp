@@ -24,6 +24,7 @@
 #include "models/PipelineEventGroup.h"
 #include "models/PipelineEvent.h"
 #include "logger/Logger.h"
+#include "monitor/LatencyTraceRecorder.h"
 #include "pipeline/queue/ProcessQueueManager.h"
 #include "pipeline/queue/ProcessQueueItem.h"
 
@@ -77,6 +78,7 @@ void OtelMeterHandler::handle(std::vector<std::unique_ptr<ApplicationBatchMeasur
 #ifdef APSARA_UNIT_TEST_MAIN
         continue;
 #endif
+        eventGroup.SetLatencyTrace(LatencyTraceRecorder::StartTrace());
         std::unique_ptr<ProcessQueueItem> item = std::make_unique<ProcessQueueItem>(std::move(eventGroup), mPluginIdx);
         if (ProcessQueueManager::GetInstance()->PushQueue(mQueueKey, std::move(item))) {
             LOG_WARNING(sLogger, ("configName", mCtx->GetConfigName())("pluginIdx",mPluginIdx)("[Otel Metrics] push queue failed!", ""));
@@ -108,6 +110,7 @@ void OtelSpanHandler::handle(std::vector<std::unique_ptr<ApplicationBatchSpan>>&
 #ifdef APSARA_UNIT_TEST_MAIN
         continue;
 #endif
+        eventGroup.SetLatencyTrace(LatencyTraceRecorder::StartTrace());
         std::unique_ptr<ProcessQueueItem> item = std::make_unique<ProcessQueueItem>(std::move(eventGroup), mPluginIdx);
         if (ProcessQueueManager::GetInstance()->PushQueue(mQueueKey, std::move(item))) {
             LOG_WARNING(sLogger, ("configName", mCtx->GetConfigName())("pluginIdx",mPluginIdx)("[Span] push queue failed!", ""));
@@ -141,6 +144,7 @@ void EventHandler::handle(std::vector<std::unique_ptr<ApplicationBatchEvent>>&&
 #ifdef APSARA_UNIT_TEST_MAIN
         continue;
 #endif
+        eventGroup.SetLatencyTrace(LatencyTraceRecorder::StartTrace());
         std::unique_ptr<ProcessQueueItem> item = std::make_unique<ProcessQueueItem>(std::move(eventGroup), mPluginIdx);
         if (ProcessQueueManager::GetInstance()->PushQueue(mQueueKey, std::move(item))) {
             LOG_WARNING(sLogger, ("configName", mCtx->GetConfigName())("pluginIdx",mPluginIdx)("[Event] push queue failed!", ""));
@@ -218,6 +222,7 @@ void ArmsSpanHandler::handle(std::vector<std::unique_ptr<ApplicationBatchSpan>>&
 #ifdef APSARA_UNIT_TEST_MAIN
         continue;
 #endif
+        eventGroup.SetLatencyTrace(LatencyTraceRecorder::StartTrace());
         std::unique_ptr<ProcessQueueItem> item = std::make_unique<ProcessQueueItem>(std::move(eventGroup), mPluginIdx);
         if (ProcessQueueManager::GetInstance()->PushQueue(mQueueKey, std::move(item))) {
             LOG_WARNING(sLogger, ("configName", mCtx->GetConfigName())("pluginIdx",mPluginIdx)("[Span] push queue failed!", ""));
@@ -260,6 +265,7 @@ void ArmsMeterHandler::handle(std::vector<std::unique_ptr<ApplicationBatchMeasur
 #ifdef APSARA_UNIT_TEST_MAIN
         continue;
 #endif
+        eventGroup.SetLatencyTrace(LatencyTraceRecorder::StartTrace());
         std::unique_ptr<ProcessQueueItem> item = std::make_unique<ProcessQueueItem>(std::move(eventGroup), mPluginIdx);
         if (ProcessQueueManager::GetInstance()->PushQueue(mQueueKey, std::move(item))) {
             LOG_WARNING(sLogger, ("configName", mCtx->GetConfigName())("pluginIdx",mPluginIdx)("[Metrics] push queue failed!", ""));
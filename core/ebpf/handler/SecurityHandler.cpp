@@ -14,6 +14,7 @@
 
 #include "ebpf/handler/SecurityHandler.h"
 #include "logger/Logger.h"
+#include "monitor/LatencyTraceRecorder.h"
 #include "pipeline/PipelineContext.h"
 #include "common/RuntimeUtil.h"
 #include "ebpf/SourceManager.h"
@@ -60,6 +61,7 @@ void SecurityHandler::handle(std::vector<std::unique_ptr<AbstractSecurityEvent>>
 #ifdef APSARA_UNIT_TEST_MAIN
     return;
 #endif
+    event_group.SetLatencyTrace(LatencyTraceRecorder::StartTrace());
     std::unique_ptr<ProcessQueueItem> item = 
             std::unique_ptr<ProcessQueueItem>(new ProcessQueueItem(std::move(event_group), mPluginIdx));
     
@@ -41,6 +41,7 @@
 #include "common/FileSystemUtil.h"
 #include "common/HashUtil.h"
 #include "common/JsonUtil.h"
+#include "common/PathTrie.h"
 #include "common/RuntimeUtil.h"
 #include "common/StringTools.h"
 #include "common/TimeUtil.h"
@@ -91,6 +92,9 @@ using namespace std;
 // DEFINE_FLAG_INT32(default_plugin_log_queue_size, "", 10);
 
 DEFINE_FLAG_INT32(wildcard_max_sub_dir_count, "", 1000);
+DEFINE_FLAG_BOOL(enable_lazy_dir_registration,
+                 "register sub dirs of base dirs in the background, except those containing checkpointed files",
+                 true);
 DEFINE_FLAG_INT32(config_match_max_cache_size, "", 1000000);
 DEFINE_FLAG_INT32(multi_config_alarm_interval, "second", 600);
 
@@ -306,7 +310,7 @@ void ConfigManager::RegisterWildcardPath(const FileDiscoveryConfig& config, cons
                 return;
             }
             if (EventDispatcher::GetInstance()->RegisterEventHandler(item.c_str(), config, mSharedHandler)) {
-                RegisterDescendants(
+                RegisterDescendantsLazily(
                     item, config, config.first->mMaxDirSearchDepth < 0 ? 100 : config.first->mMaxDirSearchDepth);
             }
         } else {
@@ -382,7 +386,7 @@ void ConfigManager::RegisterWildcardPath(const FileDiscoveryConfig& config, cons
                     return;
                 }
                 if (EventDispatcher::GetInstance()->RegisterEventHandler(item.c_str(), config, mSharedHandler)) {
-                    RegisterDescendants(
+                    RegisterDescendantsLazily(
                         item, config, config.first->mMaxDirSearchDepth < 0 ? 100 : config.first->mMaxDirSearchDepth);
                 }
             } else {
@@ -427,7 +431,7 @@ bool ConfigManager::RegisterHandlers(const string& basePath, const FileDiscovery
         return result;
 
     if (config.first->mPreservedDirDepth < 0)
-        result = RegisterDescendants(
+        result = RegisterDescendantsLazily(
             basePath, config, config.first->mMaxDirSearchDepth < 0 ? 100 : config.first->mMaxDirSearchDepth);
     else {
         // preserve_depth register
@@ -495,7 +499,10 @@ bool ConfigManager::RegisterHandlersWithinDepth(const std::string& path, const F
 }
 
 // path not terminated by '/', path already registered
-bool ConfigManager::RegisterDescendants(const string& path, const FileDiscoveryConfig& config, int withinDepth) {
+bool ConfigManager::RegisterDescendants(const string& path,
+                                        const FileDiscoveryConfig& config,
+                                        int withinDepth,
+                                        bool lazy) {
     if (AppConfig::GetInstance()->IsHostPathMatchBlacklist(path)) {
         LOG_INFO(sLogger, ("ignore path matching host path blacklist", path));
         return false;
@@ -521,13 +528,109 @@ bool ConfigManager::RegisterDescendants(const string& path, const FileDiscoveryC
         string item = PathJoin(path, ent.Name());
         if (ent.IsDir() && !config.first->IsDirectoryInBlacklist(item)) {
             result = EventDispatcher::GetInstance()->RegisterEventHandler(item.c_str(), config, mSharedHandler);
-            if (result)
-                RegisterDescendants(item, config, withinDepth - 1);
+            if (result) {
+                if (lazy) {
+                    AddPendingDir(item, config, withinDepth - 1);
+                } else {
+                    RegisterDescendants(item, config, withinDepth - 1);
+                }
+            }
         }
     }
     return result;
 }
 
+bool ConfigManager::RegisterDescendantsLazily(const string& path, const FileDiscoveryConfig& config, int withinDepth) {
+    // exactly once checkpoints are dropped if their dirs are not registered on start, which cannot be told apart
+    // from v1 checkpoints here, so exactly once configs are registered at once.
+    if (!BOOL_FLAG(enable_lazy_dir_registration) || config.second->IsExactlyOnceEnabled()) {
+        return RegisterDescendants(path, config, withinDepth);
+    }
+    AddPendingDir(path, config, withinDepth);
+    return true;
+}
+
+void ConfigManager::AddPendingDir(const string& path, const FileDiscoveryConfig& config, int withinDepth) {
+    if (withinDepth <= 0) {
+        return;
+    }
+    // base dirs are checked periodically, do not walk the same tree again if it is still pending
+    if (!mPendingDirSet.emplace(path, config.first).second) {
+        return;
+    }
+    mPendingDirs.push_back({path, config, withinDepth});
+}
+
+size_t ConfigManager::RegisterPendingDirs(size_t maxDirCount) {
+    size_t cnt = 0;
+    for (; cnt < maxDirCount && !mPendingDirs.empty(); ++cnt) {
+        PendingDir dir = std::move(mPendingDirs.front());
+        mPendingDirs.pop_front();
+        mPendingDirSet.erase(make_pair(dir.mPath, dir.mConfig.first));
+        // sub dirs are appended to the end, so that trees are walked breadth first and shallow dirs come first
+        RegisterDescendants(dir.mPath, dir.mConfig, dir.mWithinDepth, true);
+    }
+    if (cnt > 0 && mPendingDirs.empty()) {
+        LOG_INFO(sLogger, ("lazy dir registration", "done"));
+    }
+    return cnt;
+}
+
+void ConfigManager::ClearPendingDirs() {
+    mPendingDirs.clear();
+    mPendingDirSet.clear();
+}
+
+void ConfigManager::RegisterCheckPointDirs() {
+    if (mPendingDirs.empty()) {
+        return;
+    }
+    PathTrie pendingDirIndex;
+    for (size_t i = 0; i < mPendingDirs.size(); ++i) {
+        pendingDirIndex.Insert(mPendingDirs[i].mPath, i);
+    }
+    unordered_set<string> checkedDirs;
+    vector<size_t> idxs;
+    for (const auto& item : CheckPointManager::Instance()->GetAllFileCheckPoint()) {
+        const string& filePath = item.second->mFileName;
+        size_t lastSeparator = filePath.find_last_of(PATH_SEPARATOR);
+        if (lastSeparator == string::npos || lastSeparator == 0) {
+            continue;
+        }
+        string dir = filePath.substr(0, lastSeparator);
+        if (!checkedDirs.insert(dir).second || !CheckExistance(dir)) {
+            continue;
+        }
+        idxs.clear();
+        pendingDirIndex.FindAllPrefixes(dir, idxs);
+        for (size_t idx : idxs) {
+            RegisterDirsOnPath(mPendingDirs[idx], dir);
+        }
+    }
+    LOG_INFO(sLogger,
+             ("dirs of checkpointed files", "registered")("checkpointed dir count", checkedDirs.size())(
+                 "pending dir count", mPendingDirs.size()));
+}
+
+void ConfigManager::RegisterDirsOnPath(const PendingDir& from, const string& to) {
+    const FileDiscoveryConfig& config = from.mConfig;
+    int withinDepth = from.mWithinDepth;
+    size_t pos = from.mPath.size();
+    while (withinDepth > 0) {
+        pos = to.find_first_not_of(PATH_SEPARATOR, pos);
+        if (pos == string::npos) {
+            break;
+        }
+        pos = to.find_first_of(PATH_SEPARATOR, pos);
+        string item = to.substr(0, pos);
+        if (AppConfig::GetInstance()->IsHostPathMatchBlacklist(item) || config.first->IsDirectoryInBlacklist(item)
+            || !EventDispatcher::GetInstance()->RegisterEventHandler(item.c_str(), config, mSharedHandler)) {
+            break;
+        }
+        --withinDepth;
+    }
+}
+
 void ConfigManager::ClearConfigMatchCache() {
     static const int32_t FORCE_CLEAR_INTERVAL = 6 * 3600;
     static int32_t s_lastClearTime = (int32_t)time(NULL) - rand() % 600;
@@ -565,42 +668,37 @@ FileDiscoveryConfig ConfigManager::FindBestMatch(const string& path, const strin
             }
         }
     }
-    const auto& nameConfigMap = FileServer::GetInstance()->GetAllFileDiscoveryConfigs();
-    auto itr = nameConfigMap.begin();
+    vector<FileDiscoveryConfig> candidates;
+    FileServer::GetInstance()->GetFileDiscoveryConfigIndex().FindCandidates(path, candidates);
     FileDiscoveryConfig prevMatch(nullptr, nullptr);
     size_t prevLen = 0;
     size_t curLen = 0;
     uint32_t nameRepeat = 0;
     string logNameList;
     vector<FileDiscoveryConfig> multiConfigs;
-    for (; itr != nameConfigMap.end(); ++itr) {
-        const FileDiscoveryOptions* config = itr->second.first;
-        // // exclude __FUSE_CONFIG__
-        // if (itr->first == STRING_FLAG(fuse_customized_config_name)) {
-        //     continue;
-        // }
-
+    for (const auto& candidate : candidates) {
+        const FileDiscoveryOptions* config = candidate.first;
         bool match = config->IsMatch(path, name);
         if (match) {
             // if force multi config, do not send alarm
             if (!name.empty() && !config->mAllowingIncludedByMultiConfigs) {
                 nameRepeat++;
                 logNameList.append("logstore:");
-                logNameList.append(itr->second.second->GetLogstoreName());
+                logNameList.append(candidate.second->GetLogstoreName());
                 logNameList.append(",config:");
-                logNameList.append(itr->second.second->GetConfigName());
+                logNameList.append(candidate.second->GetConfigName());
                 logNameList.append(" ");
-                multiConfigs.push_back(itr->second);
+                multiConfigs.push_back(candidate);
             }
 
             // note: best config is the one which length is longest and create time is nearest
             curLen = config->GetBasePath().size();
             if (prevLen < curLen) {
-                prevMatch = itr->second;
+                prevMatch = candidate;
                 prevLen = curLen;
             } else if (prevLen == curLen && prevMatch.first) {
-                if (prevMatch.second->GetCreateTime() > itr->second.second->GetCreateTime()) {
-                    prevMatch = itr->second;
+                if (prevMatch.second->GetCreateTime() > candidate.second->GetCreateTime()) {
+                    prevMatch = candidate;
                     prevLen = curLen;
                 }
             }
@@ -654,18 +752,13 @@ int32_t ConfigManager::FindAllMatch(vector<FileDiscoveryConfig>& allConfig,
         }
     }
     bool alarmFlag = false;
-    auto nameConfigMap = FileServer::GetInstance()->GetAllFileDiscoveryConfigs();
-    auto itr = nameConfigMap.begin();
-    for (; itr != nameConfigMap.end(); ++itr) {
-        const FileDiscoveryOptions* config = itr->second.first;
-        // // exclude __FUSE_CONFIG__
-        // if (itr->first == STRING_FLAG(fuse_customized_config_name)) {
-        //     continue;
-        // }
-
+    vector<FileDiscoveryConfig> candidates;
+    FileServer::GetInstance()->GetFileDiscoveryConfigIndex().FindCandidates(path, candidates);
+    for (const auto& candidate : candidates) {
+        const FileDiscoveryOptions* config = candidate.first;
         bool match = config->IsMatch(path, name);
         if (match) {
-            allConfig.push_back(itr->second);
+            allConfig.push_back(candidate);
         }
     }
 
@@ -702,21 +795,15 @@ int32_t ConfigManager::FindMatchWithForceFlag(std::vector<FileDiscoveryConfig>&
             }
         }
     }
-    auto nameConfigMap = FileServer::GetInstance()->GetAllFileDiscoveryConfigs();
-    auto itr = nameConfigMap.begin();
+    vector<FileDiscoveryConfig> candidates;
+    FileServer::GetInstance()->GetFileDiscoveryConfigIndex().FindCandidates(path, candidates);
     FileDiscoveryConfig prevMatch = make_pair(nullptr, nullptr);
     size_t prevLen = 0;
     size_t curLen = 0;
     uint32_t nameRepeat = 0;
     string logNameList;
     vector<FileDiscoveryConfig> multiConfigs;
-    for (; itr != nameConfigMap.end(); ++itr) {
-        FileDiscoveryConfig config = itr->second;
-        // // exclude __FUSE_CONFIG__
-        // if (itr->first == STRING_FLAG(fuse_customized_config_name)) {
-        //     continue;
-        // }
-
+    for (const auto& config : candidates) {
         bool match = config.first->IsMatch(path, name);
         if (match) {
             // if force multi config, do not send alarm
@@ -17,6 +17,8 @@
 #pragma once
 
 #include <cstdint>
+#include <deque>
+#include <set>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -77,6 +79,14 @@ protected:
     EventHandler* mSharedHandler;
     // one modify handler corresponds to one "leaf" directory
     std::unordered_map<std::string, EventHandler*> mDirEventHandlerMap;
+    // dirs whose descendants are to be registered
+    struct PendingDir {
+        std::string mPath;
+        FileDiscoveryConfig mConfig;
+        int mWithinDepth;
+    };
+    std::deque<PendingDir> mPendingDirs;
+    std::set<std::pair<std::string, const FileDiscoveryOptions*>> mPendingDirSet;
     // ThreadPtr mUUIDthreadPtr;
     // 商业版
     // volatile bool mThreadIsRunning;
@@ -260,6 +270,16 @@ public:
     bool RegisterHandlers(const std::string& basePath, const FileDiscoveryConfig& config);
     bool RegisterHandlers();
     bool RegisterHandlersRecursively(const std::string& dir, const FileDiscoveryConfig& config, bool checkTimeout);
+    // When lazy dir registration is enabled, RegisterHandlers only registers base dirs, and their descendants are
+    // left pending. RegisterCheckPointDirs registers dirs of checkpointed files among them at once, so that readers
+    // can be restored from checkpoints on start, and the others are registered breadth first by RegisterPendingDirs
+    // in the event handling thread.
+    void RegisterCheckPointDirs();
+    // @return count of pending dirs walked, at most @maxDirCount.
+    size_t RegisterPendingDirs(size_t maxDirCount);
+    bool HasPendingDirs() const { return !mPendingDirs.empty(); }
+    // pending dirs refer to configs, thus must be cleared before configs are updated.
+    void ClearPendingDirs();
     // 废弃，蚂蚁
     // /**
     //  * @brief HasFuseConfig
@@ -511,7 +531,13 @@ private:
      * @depth is the num of sub dir layers that should be registered
      */
     bool RegisterHandlersWithinDepth(const std::string& path, const FileDiscoveryConfig& config, int depth);
-    bool RegisterDescendants(const std::string& path, const FileDiscoveryConfig& config, int withinDepth);
+    // @lazy: sub dirs are registered, while their descendants are left pending.
+    bool
+    RegisterDescendants(const std::string& path, const FileDiscoveryConfig& config, int withinDepth, bool lazy = false);
+    bool RegisterDescendantsLazily(const std::string& path, const FileDiscoveryConfig& config, int withinDepth);
+    void AddPendingDir(const std::string& path, const FileDiscoveryConfig& config, int withinDepth);
+    // registers dirs from the sub dir of @from down to @to, @to must be a descendant of @from.
+    void RegisterDirsOnPath(const PendingDir& from, const std::string& to);
     // bool CheckLogType(const std::string& logTypeStr, LogType& logType);
     // 废弃
     // std::vector<std::string> GetStringVector(const Json::Value& value);
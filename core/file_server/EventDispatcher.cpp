@@ -85,6 +85,17 @@ DEFINE_FLAG_INT32(existed_file_active_timeout,
 DEFINE_FLAG_INT32(checkpoint_find_max_cache_size, "", 100000);
 DEFINE_FLAG_INT32(max_watch_dir_count, "", 100 * 1000);
 DEFINE_FLAG_INT32(default_max_inotify_watch_num, "the max allowed inotify watch dir number", 3000);
+DEFINE_FLAG_INT32(inotify_max_user_watches_usage_percent,
+                  "max percent of fs.inotify.max_user_watches used by inotify watch dirs, the rest is left to others",
+                  50);
+DEFINE_FLAG_INT32(inotify_watch_soft_limit_percent,
+                  "when inotify watch dir number exceeds this percent of limit, cold dirs are left to polling",
+                  80);
+DEFINE_FLAG_INT32(inotify_cold_dir_threshold,
+                  "seconds, dir is cold if neither it nor any file in it is modified within this time",
+                  3600);
+
+DECLARE_FLAG_BOOL(enable_polling_discovery);
 
 namespace logtail {
 
@@ -122,6 +133,8 @@ EventDispatcher::EventDispatcher() : mWatchNum(0), mInotifyWatchNum(0) {
      */
     mTimeoutHandler = new TimeoutHandler();
     mNonInotifyWd = -1;
+    mMaxUserWatches = ReadMaxUserWatches();
+    mInotifyWatchCap = INT_MAX;
 }
 
 EventDispatcher::~EventDispatcher() {
@@ -226,12 +239,20 @@ bool EventDispatcher::RegisterEventHandler(const char* path,
     }
 
     wd = -1;
-    if (mInotifyWatchNum >= INT32_FLAG(default_max_inotify_watch_num)) {
+    int inotifyWatchLimit = GetInotifyWatchLimit();
+    if (mInotifyWatchNum >= inotifyWatchLimit) {
         LOG_INFO(sLogger,
-                 ("failed to add inotify watcher for dir", path)("max allowd inotify watchers",
-                                                                 INT32_FLAG(default_max_inotify_watch_num)));
+                 ("failed to add inotify watcher for dir", path)("max allowd inotify watchers", inotifyWatchLimit));
         AlarmManager::GetInstance()->SendAlarm(INOTIFY_DIR_NUM_LIMIT_ALARM,
                                                string("failed to register inotify watcher for dir") + path);
+    } else if (BOOL_FLAG(enable_polling_discovery)
+               && mInotifyWatchNum >= (int64_t)inotifyWatchLimit * INT32_FLAG(inotify_watch_soft_limit_percent) / 100
+               && IsColdDir(path, statBuf)) {
+        // inotify watchers left are saved for active dirs, cold dirs are still discovered by polling
+        LOG_DEBUG(sLogger,
+                  ("inotify watchers near limit, cold dir is left to polling", path)("inotify watchers",
+                                                                                    mInotifyWatchNum)(
+                      "max allowd inotify watchers", inotifyWatchLimit));
     } else {
         // need check mEventListener valid
         if (mEventListener->IsInit() && !AppConfig::GetInstance()->IsInInotifyBlackList(path)) {
@@ -240,6 +261,13 @@ bool EventDispatcher::RegisterEventHandler(const char* path,
                 string str = ErrnoToString(GetErrno());
                 LOG_WARNING(sLogger, ("failed to register dir", path)("reason", str));
 #if defined(__linux__)
+                // fs.inotify.max_user_watches is reached, possibly due to watchers of other processes, stop adding
+                // watchers until some of ours are removed
+                if (errno == ENOSPC) {
+                    mInotifyWatchCap = mInotifyWatchNum;
+                    LOG_WARNING(sLogger,
+                                ("fs.inotify.max_user_watches is reached, limit inotify watchers to", mInotifyWatchCap));
+                }
                 // work around bug 13229654
                 if (errno == EINVAL || errno == EBADF) {
                     LOG_ERROR(sLogger,
@@ -316,6 +344,50 @@ bool EventDispatcher::RegisterEventHandler(const char* path,
     return true;
 }
 
+int64_t EventDispatcher::ReadMaxUserWatches() {
+#if defined(__linux__)
+    string content;
+    if (ReadFileContent("/proc/sys/fs/inotify/max_user_watches", content)) {
+        int64_t maxUserWatches = strtoll(content.c_str(), NULL, 10);
+        if (maxUserWatches > 0) {
+            return maxUserWatches;
+        }
+    }
+#endif
+    return -1;
+}
+
+int EventDispatcher::GetInotifyWatchLimit() const {
+    int64_t limit = min((int64_t)INT32_FLAG(default_max_inotify_watch_num), mInotifyWatchCap);
+    if (mMaxUserWatches > 0) {
+        limit = min(limit, mMaxUserWatches * INT32_FLAG(inotify_max_user_watches_usage_percent) / 100);
+    }
+    return static_cast<int>(limit);
+}
+
+bool EventDispatcher::IsColdDir(const char* path, const fsutil::PathStat& statBuf) const {
+    time_t threshold = time(NULL) - INT32_FLAG(inotify_cold_dir_threshold);
+    if (statBuf.GetMtime() >= threshold) {
+        return false;
+    }
+    // appending to a file does not change mtime of its dir
+    fsutil::Dir dir(path);
+    if (!dir.Open()) {
+        return false;
+    }
+    fsutil::Entry ent;
+    while ((ent = dir.ReadNext(false))) {
+        if (!ent.IsRegFile()) {
+            continue;
+        }
+        fsutil::PathStat fileStat;
+        if (fsutil::PathStat::stat(PathJoin(path, ent.Name()), fileStat) && fileStat.GetMtime() >= threshold) {
+            return false;
+        }
+    }
+    return true;
+}
+
 // read files when add dir inotify watcher at first time
 void EventDispatcher::AddExistedFileEvents(const char* path, int wd) {
     fsutil::Dir dir(path);
@@ -839,6 +911,11 @@ void EventDispatcher::UnregisterEventHandler(const char* path) {
     if (mEventListener->IsValidID(wd) && mEventListener->IsInit()) {
         mEventListener->RemoveWatch(wd);
         mInotifyWatchNum--;
+        // fs.inotify.max_user_watches may not be reached any more, the cap is set again on the next ENOSPC
+        if (mInotifyWatchCap != INT_MAX) {
+            LOG_INFO(sLogger, ("inotify watcher removed, lift the limit of inotify watchers", mInotifyWatchCap));
+            mInotifyWatchCap = INT_MAX;
+        }
     }
     mWatchNum--;
     LOG_INFO(sLogger, ("remove the watcher for dir", path)("wd", wd));
@@ -233,6 +233,11 @@ protected:
      */
     bool AddTimeoutWatch(const char* path);
     void AddExistedFileEvents(const char* path, int wd);
+    // ReadMaxUserWatches returns fs.inotify.max_user_watches, or -1 if unknown.
+    static int64_t ReadMaxUserWatches();
+    int GetInotifyWatchLimit() const;
+    // IsColdDir returns true if neither @path nor any file in it is modified within inotify_cold_dir_threshold.
+    bool IsColdDir(const char* path, const fsutil::PathStat& statBuf) const;
 
     enum class ValidateCheckpointResult {
         kNormal,
@@ -257,6 +262,9 @@ protected:
     // int mEpollFd;
     // int mStreamLogTcpFd;
     int mNonInotifyWd;
+    int64_t mMaxUserWatches;
+    // number of inotify watchers when fs.inotify.max_user_watches was reached
+    int64_t mInotifyWatchCap;
     EventHandler* mTimeoutHandler;
     // work around due to c++'s lack of typedef for template
     // substitute by std::map if stl's map is preferred
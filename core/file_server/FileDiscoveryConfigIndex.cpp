@@ -0,0 +1,103 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "file_server/FileDiscoveryConfigIndex.h"
+
+#include <algorithm>
+
+#include "common/FileSystemUtil.h"
+
+using namespace std;
+
+namespace logtail {
+
+void FileDiscoveryConfigIndex::Add(const string& name, const FileDiscoveryConfig& config) {
+    Remove(name);
+
+    size_t idx = 0;
+    if (mFreeSlots.empty()) {
+        idx = mSlots.size();
+        mSlots.emplace_back();
+    } else {
+        idx = mFreeSlots.back();
+        mFreeSlots.pop_back();
+    }
+    Slot& slot = mSlots[idx];
+    slot.mConfig = config;
+    slot.mAlwaysCandidate = config.first->IsContainerDiscoveryEnabled();
+    if (slot.mAlwaysCandidate) {
+        slot.mIndexedDir.clear();
+        mAlwaysCandidateSlots.push_back(idx);
+    } else {
+        slot.mIndexedDir = GetLiteralDir(config.first->GetBasePath());
+        mDirIndex.Insert(slot.mIndexedDir, idx);
+    }
+    mNameSlotMap[name] = idx;
+}
+
+void FileDiscoveryConfigIndex::Remove(const string& name) {
+    auto iter = mNameSlotMap.find(name);
+    if (iter == mNameSlotMap.end()) {
+        return;
+    }
+    size_t idx = iter->second;
+    mNameSlotMap.erase(iter);
+
+    Slot& slot = mSlots[idx];
+    if (slot.mAlwaysCandidate) {
+        mAlwaysCandidateSlots.erase(find(mAlwaysCandidateSlots.begin(), mAlwaysCandidateSlots.end(), idx));
+    } else {
+        mDirIndex.Erase(slot.mIndexedDir, idx);
+    }
+    slot = Slot();
+    mFreeSlots.push_back(idx);
+}
+
+void FileDiscoveryConfigIndex::Clear() {
+    mNameSlotMap.clear();
+    mSlots.clear();
+    mFreeSlots.clear();
+    mDirIndex.Clear();
+    mAlwaysCandidateSlots.clear();
+}
+
+void FileDiscoveryConfigIndex::FindCandidates(const string& path, vector<FileDiscoveryConfig>& candidates) const {
+    vector<size_t> idxs;
+    mDirIndex.FindAllPrefixes(path, idxs);
+    idxs.insert(idxs.end(), mAlwaysCandidateSlots.begin(), mAlwaysCandidateSlots.end());
+    for (size_t idx : idxs) {
+        candidates.push_back(mSlots[idx].mConfig);
+    }
+}
+
+string FileDiscoveryConfigIndex::GetLiteralDir(const string& basePath) {
+    // Besides * and ?, [ starts a bracket expression and \ escapes in fnmatch, except that \ is the path
+    // separator on Windows.
+#if defined(_MSC_VER)
+    static const char* kGlobChars = "*?[";
+#else
+    static const char* kGlobChars = "*?[\\";
+#endif
+    size_t globPos = basePath.find_first_of(kGlobChars);
+    if (globPos == string::npos) {
+        return basePath;
+    }
+    size_t sepPos = basePath.rfind(PATH_SEPARATOR[0], globPos);
+    if (sepPos == string::npos) {
+        return string();
+    }
+    return basePath.substr(0, sepPos);
+}
+
+} // namespace logtail
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/PathTrie.h"
+#include "file_server/FileDiscoveryOptions.h"
+
+namespace logtail {
+
+// FileDiscoveryConfigIndex narrows down the file discovery configs which may match a path, so that
+// FileDiscoveryOptions::IsMatch (fnmatch over base path, wildcard paths and blacklists) is only run for
+// a few configs instead of all of them.
+// Each config is indexed by the literal directory its base path starts with, i.e. components before the
+// first one containing a glob character (e.g. /var/log for /var/log/*/app/**). All configs whose literal
+// directory is the path itself or an ancestor of it are found in a single walk of the path. Configs with
+// container discovery enabled match paths under container dirs, which change without config update, so
+// they are always candidates and left to IsMatch, which looks up their own container path index.
+// The index is updated along with config addition and removal. Not thread-safe.
+class FileDiscoveryConfigIndex {
+public:
+    // Add replaces the config of the same name, if any.
+    void Add(const std::string& name, const FileDiscoveryConfig& config);
+    void Remove(const std::string& name);
+    void Clear();
+
+    // FindCandidates appends configs which may match @path, each config appears at most once.
+    void FindCandidates(const std::string& path, std::vector<FileDiscoveryConfig>& candidates) const;
+
+    size_t Size() const { return mNameSlotMap.size(); }
+
+    // GetLiteralDir returns components of @basePath before the first one containing a glob character.
+    static std::string GetLiteralDir(const std::string& basePath);
+
+private:
+    struct Slot {
+        FileDiscoveryConfig mConfig{nullptr, nullptr};
+        std::string mIndexedDir;
+        bool mAlwaysCandidate = false;
+    };
+
+    std::unordered_map<std::string, size_t> mNameSlotMap;
+    std::vector<Slot> mSlots;
+    std::vector<size_t> mFreeSlots;
+    PathTrie mDirIndex;
+    std::vector<size_t> mAlwaysCandidateSlots;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class FileDiscoveryConfigIndexUnittest;
+#endif
+};
+
+} // namespace logtail
@@ -511,7 +511,9 @@ bool FileDiscoveryOptions::IsMatch(const string& path, const string& name) const
         }
 
         // Normal base path.
-        for (size_t i = 0; i < mContainerInfos->size(); ++i) {
+        vector<size_t> containerIdxs;
+        mContainerPathIndex.FindAllPrefixes(path, containerIdxs);
+        for (size_t i : containerIdxs) {
             const string& containerBasePath = (*mContainerInfos)[i].mRealBaseDir;
             if (_IsPathMatched(containerBasePath, path, mMaxDirSearchDepth)) {
                 if (!mHasBlacklist) {
@@ -645,12 +647,26 @@ ContainerInfo* FileDiscoveryOptions::GetContainerPathByLogPath(const string& log
     if (!mContainerInfos) {
         return NULL;
     }
+    size_t idx = 0;
+    if (!mContainerPathIndex.FindLongestPrefix(logPath, idx)) {
+        return NULL;
+    }
+    return &(*mContainerInfos)[idx];
+}
+
+void FileDiscoveryOptions::SetContainerInfo(const shared_ptr<vector<ContainerInfo>>& info) {
+    mContainerInfos = info;
+    RebuildContainerPathIndex();
+}
+
+void FileDiscoveryOptions::RebuildContainerPathIndex() {
+    mContainerPathIndex.Clear();
+    if (!mContainerInfos) {
+        return;
+    }
     for (size_t i = 0; i < mContainerInfos->size(); ++i) {
-        if (_IsSubPath((*mContainerInfos)[i].mRealBaseDir, logPath)) {
-            return &(*mContainerInfos)[i];
-        }
+        mContainerPathIndex.Insert((*mContainerInfos)[i].mRealBaseDir, i);
     }
-    return NULL;
 }
 
 bool FileDiscoveryOptions::IsSameContainerInfo(const Json::Value& paramsJSON, const PipelineContext* ctx) {
@@ -725,11 +741,14 @@ bool FileDiscoveryOptions::UpdateContainerInfo(const Json::Value& paramsJSON, co
         for (size_t i = 0; i < mContainerInfos->size(); ++i) {
             if ((*mContainerInfos)[i].mID == containerInfo.mID) {
                 // update
+                mContainerPathIndex.Erase((*mContainerInfos)[i].mRealBaseDir, i);
+                mContainerPathIndex.Insert(containerInfo.mRealBaseDir, i);
                 (*mContainerInfos)[i] = containerInfo;
                 return true;
             }
         }
         // add
+        mContainerPathIndex.Insert(containerInfo.mRealBaseDir, mContainerInfos->size());
         mContainerInfos->push_back(containerInfo);
         return true;
     }
@@ -744,10 +763,12 @@ bool FileDiscoveryOptions::UpdateContainerInfo(const Json::Value& paramsJSON, co
     }
     // if update all, clear and reset
     mContainerInfos->clear();
+    mContainerPathIndex.Clear();
     for (unordered_map<string, ContainerInfo>::iterator iter = allPathMap.begin(); iter != allPathMap.end(); ++iter) {
         if (!mDeduceAndSetContainerBaseDirFunc(iter->second, ctx, this)) {
             return false;
         }
+        mContainerPathIndex.Insert(iter->second.mRealBaseDir, mContainerInfos->size());
         mContainerInfos->push_back(iter->second);
     }
     return true;
@@ -763,9 +784,17 @@ bool FileDiscoveryOptions::DeleteContainerInfo(const Json::Value& paramsJSON) {
         LOG_ERROR(sLogger, ("invalid container info update param", errorMsg)("action", "ignore current cmd"));
         return false;
     }
-    for (vector<ContainerInfo>::iterator iter = mContainerInfos->begin(); iter != mContainerInfos->end(); ++iter) {
-        if (iter->mID == containerInfo.mID) {
-            mContainerInfos->erase(iter);
+    for (size_t i = 0; i < mContainerInfos->size(); ++i) {
+        if ((*mContainerInfos)[i].mID == containerInfo.mID) {
+            // Move the last one to the deleted position, so that only one item has to be reindexed.
+            size_t last = mContainerInfos->size() - 1;
+            mContainerPathIndex.Erase((*mContainerInfos)[i].mRealBaseDir, i);
+            if (i != last) {
+                mContainerPathIndex.Erase((*mContainerInfos)[last].mRealBaseDir, last);
+                mContainerPathIndex.Insert((*mContainerInfos)[last].mRealBaseDir, i);
+                (*mContainerInfos)[i] = std::move((*mContainerInfos)[last]);
+            }
+            mContainerInfos->pop_back();
             break;
         }
     }
@@ -24,6 +24,7 @@
 #include <utility>
 #include <vector>
 
+#include "common/PathTrie.h"
 #include "file_server/ContainerInfo.h"
 #include "pipeline/PipelineContext.h"
 
@@ -44,7 +45,7 @@ public:
     bool IsContainerDiscoveryEnabled() const { return mEnableContainerDiscovery; }
     void SetEnableContainerDiscoveryFlag(bool flag) { mEnableContainerDiscovery = true; }
     const std::shared_ptr<std::vector<ContainerInfo>>& GetContainerInfo() const { return mContainerInfos; }
-    void SetContainerInfo(const std::shared_ptr<std::vector<ContainerInfo>>& info) { mContainerInfos = info; }
+    void SetContainerInfo(const std::shared_ptr<std::vector<ContainerInfo>>& info);
     void SetDeduceAndSetContainerBaseDirFunc(bool (*f)(ContainerInfo&,
                                                        const PipelineContext*,
                                                        const FileDiscoveryOptions*)) {
@@ -78,6 +79,7 @@ private:
     bool IsObjectInBlacklist(const std::string& path, const std::string& name) const;
     bool IsFileNameInBlacklist(const std::string& fileName) const;
     bool IsWildcardPathMatch(const std::string& path, const std::string& name = "") const;
+    void RebuildContainerPathIndex();
 
     std::string mBasePath;
     std::string mFilePattern;
@@ -109,6 +111,8 @@ private:
 
     bool mEnableContainerDiscovery = false;
     std::shared_ptr<std::vector<ContainerInfo>> mContainerInfos; // must not be null if container discovery is enabled
+    // Positions in mContainerInfos indexed by mRealBaseDir, updated along with mContainerInfos.
+    PathTrie mContainerPathIndex;
     bool (*mDeduceAndSetContainerBaseDirFunc)(ContainerInfo& containerInfo,
                                               const PipelineContext*,
                                               const FileDiscoveryOptions*)
@@ -43,6 +43,8 @@ void FileServer::Start() {
     ConfigManager::GetInstance()->LoadDockerConfig();
     CheckPointManager::Instance()->LoadCheckPoint();
     ConfigManager::GetInstance()->RegisterHandlers();
+    // checkpoints of files in unregistered dirs are deleted below, so their dirs are registered ahead of others
+    ConfigManager::GetInstance()->RegisterCheckPointDirs();
     LOG_INFO(sLogger, ("watch dirs", "succeeded"));
     EventDispatcher::GetInstance()->AddExistedCheckPointFileEvents();
     // the dump time must be reset after dir registration, since it may take long on NFS.
@@ -59,6 +61,7 @@ void FileServer::Start() {
 void FileServer::Pause(bool isConfigUpdate) {
     PauseInner();
     if (isConfigUpdate) {
+        ConfigManager::GetInstance()->ClearPendingDirs();
         EventDispatcher::GetInstance()->DumpAllHandlersMeta(true);
         CheckPointManager::Instance()->DumpCheckPointToLocal();
         EventDispatcher::GetInstance()->ClearBrokenLinkSet();
@@ -95,6 +98,10 @@ void FileServer::Resume(bool isConfigUpdate) {
 
     LOG_INFO(sLogger, ("file server resume", "starts"));
     ConfigManager::GetInstance()->RegisterHandlers();
+    if (isConfigUpdate) {
+        // all dirs were unregistered on pause, and checkpoints of files in unregistered dirs are deleted below
+        ConfigManager::GetInstance()->RegisterCheckPointDirs();
+    }
     LOG_INFO(sLogger, ("watch dirs", "succeeded"));
     if (isConfigUpdate) {
         EventDispatcher::GetInstance()->AddExistedCheckPointFileEvents();
@@ -128,12 +135,14 @@ FileDiscoveryConfig FileServer::GetFileDiscoveryConfig(const string& name) const
 void FileServer::AddFileDiscoveryConfig(const string& name, FileDiscoveryOptions* opts, const PipelineContext* ctx) {
     WriteLock lock(mReadWriteLock);
     mPipelineNameFileDiscoveryConfigsMap[name] = make_pair(opts, ctx);
+    mFileDiscoveryConfigIndex.Add(name, make_pair(opts, ctx));
 }
 
 // 移除给定名称的文件发现配置
 void FileServer::RemoveFileDiscoveryConfig(const string& name) {
     WriteLock lock(mReadWriteLock);
     mPipelineNameFileDiscoveryConfigsMap.erase(name);
+    mFileDiscoveryConfigIndex.Remove(name);
 }
 
 // 获取给定名称的文件读取器配置
@@ -21,6 +21,7 @@
 #include <utility>
 
 #include "common/Lock.h"
+#include "file_server/FileDiscoveryConfigIndex.h"
 #include "file_server/FileDiscoveryOptions.h"
 #include "file_server/MultilineOptions.h"
 #include "file_server/reader/FileReaderOptions.h"
@@ -49,6 +50,8 @@ public:
     const std::unordered_map<std::string, FileDiscoveryConfig>& GetAllFileDiscoveryConfigs() const {
         return mPipelineNameFileDiscoveryConfigsMap;
     }
+    // Index of all file discovery configs to find configs which may match a path.
+    const FileDiscoveryConfigIndex& GetFileDiscoveryConfigIndex() const { return mFileDiscoveryConfigIndex; }
     void AddFileDiscoveryConfig(const std::string& name, FileDiscoveryOptions* opts, const PipelineContext* ctx);
     void RemoveFileDiscoveryConfig(const std::string& name);
 
@@ -99,6 +102,7 @@ private:
     mutable ReadWriteLock mReadWriteLock;
 
     std::unordered_map<std::string, FileDiscoveryConfig> mPipelineNameFileDiscoveryConfigsMap;
+    FileDiscoveryConfigIndex mFileDiscoveryConfigIndex;
     std::unordered_map<std::string, FileReaderConfig> mPipelineNameFileReaderConfigsMap;
     std::unordered_map<std::string, MultilineConfig> mPipelineNameMultilineConfigsMap;
     std::unordered_map<std::string, std::shared_ptr<std::vector<ContainerInfo>>> mAllContainerInfoMap;
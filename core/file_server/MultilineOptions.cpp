@@ -199,7 +199,7 @@ bool MultilineOptions::Init(const Json::Value& config, const PipelineContext& ct
     return true;
 }
 
-bool MultilineOptions::ParseRegex(const string& pattern, shared_ptr<boost::regex>& reg) {
+bool MultilineOptions::ParseRegex(const string& pattern, shared_ptr<AnchoredRegex>& reg) {
     string regexPattern = pattern;
     if (!regexPattern.empty() && EndWith(regexPattern, "$")) {
         regexPattern = regexPattern.substr(0, regexPattern.size() - 1);
@@ -210,9 +210,9 @@ bool MultilineOptions::ParseRegex(const string& pattern, shared_ptr<boost::regex
     if (regexPattern.empty()) {
         return true;
     }
-    try {
-        reg.reset(new boost::regex(regexPattern));
-    } catch (...) {
+    reg = make_shared<AnchoredRegex>();
+    if (!reg->Init(regexPattern)) {
+        reg.reset();
         return false;
     }
     return true;
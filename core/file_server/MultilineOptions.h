@@ -18,10 +18,11 @@
 
 #include <json/json.h>
 
+#include <memory>
 #include <string>
 #include <utility>
 
-#include "boost/regex.hpp"
+#include "common/AnchoredRegex.h"
 #include "pipeline/PipelineContext.h"
 
 namespace logtail {
@@ -32,9 +33,9 @@ public:
     enum class UnmatchedContentTreatment { DISCARD, SINGLE_LINE };
 
     bool Init(const Json::Value& config, const PipelineContext& ctx, const std::string& pluginType);
-    const std::shared_ptr<boost::regex>& GetStartPatternReg() const { return mStartPatternRegPtr; }
-    const std::shared_ptr<boost::regex>& GetContinuePatternReg() const { return mContinuePatternRegPtr; }
-    const std::shared_ptr<boost::regex>& GetEndPatternReg() const { return mEndPatternRegPtr; }
+    const std::shared_ptr<AnchoredRegex>& GetStartPatternReg() const { return mStartPatternRegPtr; }
+    const std::shared_ptr<AnchoredRegex>& GetContinuePatternReg() const { return mContinuePatternRegPtr; }
+    const std::shared_ptr<AnchoredRegex>& GetEndPatternReg() const { return mEndPatternRegPtr; }
     bool IsMultiline() const { return mIsMultiline; }
 
     Mode mMode = Mode::CUSTOM;
@@ -45,11 +46,11 @@ public:
     bool mIgnoringUnmatchWarning = false;
 
 private:
-    bool ParseRegex(const std::string& pattern, std::shared_ptr<boost::regex>& reg);
+    bool ParseRegex(const std::string& pattern, std::shared_ptr<AnchoredRegex>& reg);
 
-    std::shared_ptr<boost::regex> mStartPatternRegPtr;
-    std::shared_ptr<boost::regex> mContinuePatternRegPtr;
-    std::shared_ptr<boost::regex> mEndPatternRegPtr;
+    std::shared_ptr<AnchoredRegex> mStartPatternRegPtr;
+    std::shared_ptr<AnchoredRegex> mContinuePatternRegPtr;
+    std::shared_ptr<AnchoredRegex> mEndPatternRegPtr;
     bool mIsMultiline = false;
 };
 
@@ -55,6 +55,7 @@ DEFINE_FLAG_INT32(dump_inotify_watcher_interval, "seconds", 180);
 DEFINE_FLAG_INT32(clear_config_match_interval, "seconds", 600);
 DEFINE_FLAG_INT32(check_block_event_interval, "seconds", 1);
 DEFINE_FLAG_INT32(read_local_event_interval, "seconds", 60);
+DEFINE_FLAG_INT32(lazy_dir_registration_batch_size, "max dirs walked for lazy registration in each loop", 100);
 DEFINE_FLAG_BOOL(force_close_file_on_container_stopped,
                  "whether close file handler immediately when associate container stopped",
                  false);
@@ -402,6 +403,7 @@ void* LogInput::ProcessLoop() {
 
         curTime = time(NULL);
 
+        ConfigManager::GetInstance()->RegisterPendingDirs(INT32_FLAG(lazy_dir_registration_batch_size));
 
         if (curTime - lastCheckBlockedTime >= INT32_FLAG(check_block_event_interval)) {
             std::vector<Event*> pEventVec;
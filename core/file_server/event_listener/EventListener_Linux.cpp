@@ -60,14 +60,16 @@ int32_t logtail::EventListener::ReadEvents(std::vector<logtail::Event*>& eventVe
     static char* s_lastHalfEventBuf = new char[65536];
     static int32_t s_lastHalfEventSize = 0;
 
-    char* buffer = new char[len + s_lastHalfEventSize];
+    if (mEventBuffer.size() < static_cast<size_t>(len + s_lastHalfEventSize)) {
+        mEventBuffer.resize(len + s_lastHalfEventSize);
+    }
+    char* buffer = mEventBuffer.data();
     if (s_lastHalfEventSize > 0) {
         memcpy(buffer, s_lastHalfEventBuf, s_lastHalfEventSize);
     }
-    size_t readLen = read(mInotifyFd, buffer + s_lastHalfEventSize, len);
-    if (readLen == 0) {
+    ssize_t readLen = read(mInotifyFd, buffer + s_lastHalfEventSize, len);
+    if (readLen <= 0) {
         LOG_ERROR(sLogger, ("read inotify fd error", ErrnoToString(GetErrno()))("read len", len));
-        delete[] buffer;
         return 0;
     }
     // update len
@@ -76,6 +78,7 @@ int32_t logtail::EventListener::ReadEvents(std::vector<logtail::Event*>& eventVe
     s_lastHalfEventSize = 0;
     if (BOOL_FLAG(fs_events_inotify_enable)) {
         static EventDispatcher* dispatcher = EventDispatcher::GetInstance();
+        mModifiedObjects.clear();
         int n = 0;
         struct inotify_event* event;
         while (n < len) {
@@ -110,6 +113,10 @@ int32_t logtail::EventListener::ReadEvents(std::vector<logtail::Event*>& eventVe
                 etype |= event->mask & IN_MOVED_FROM ? EVENT_MOVE_FROM : 0;
                 etype |= event->mask & IN_MOVED_TO ? EVENT_MOVE_TO : 0;
                 etype |= event->mask & IN_DELETE ? EVENT_DELETE : 0;
+                if (event->len > 0 && IsCoalesced(event->wd, event->name, etype)) {
+                    n += sizeof(struct inotify_event) + event->len;
+                    continue;
+                }
                 std::string path;
                 if (etype != 0 && dispatcher->IsRegistered(event->wd, path))
                     eventVec.push_back(
@@ -118,10 +125,23 @@ int32_t logtail::EventListener::ReadEvents(std::vector<logtail::Event*>& eventVe
             n += sizeof(struct inotify_event) + event->len;
         }
     }
-    delete[] buffer;
     return (int32_t)eventVec.size();
 }
 
+// A file being written generates a modify event for each write. Repeated modify events of a file in one read are
+// coalesced into the first one, since the reader reads to the end of file on any of them. Other events are kept in
+// order, which is relied on by rotation handling, and a modify event after them is kept too, as the name may refer
+// to a new file then.
+bool logtail::EventListener::IsCoalesced(int wd, const char* name, EventType etype) {
+    std::string key(reinterpret_cast<const char*>(&wd), sizeof(wd));
+    key.append(name);
+    if (etype != EVENT_MODIFY) {
+        mModifiedObjects.erase(key);
+        return false;
+    }
+    return !mModifiedObjects.insert(std::move(key)).second;
+}
+
 bool logtail::EventListener::IsInit() {
     return mInotifyFd != -1;
 }
@@ -18,6 +18,7 @@
 #define LOGTAIL_EVENTLISTENER_H
 
 #include <string>
+#include <unordered_set>
 #include <vector>
 #include "file_server/event/Event.h"
 
@@ -47,7 +48,17 @@ public:
 
 private:
     EventListener() = default;
+    bool IsCoalesced(int wd, const char* name, EventType etype);
+
     int32_t mInotifyFd = -1;
+    // reused across reads to avoid allocation for each read
+    std::vector<char> mEventBuffer;
+    // (wd, name) of files whose modify event has been emitted in the current read
+    std::unordered_set<std::string> mModifiedObjects;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class EventListenerUnittest;
+#endif
 };
 
 } // namespace logtail
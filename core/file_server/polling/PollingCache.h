@@ -21,6 +21,7 @@
 #include <deque>
 #include <unordered_map>
 #include <ctime>
+#include "common/FileSystemUtil.h"
 #include "common/SplitedFilePath.h"
 
 namespace logtail {
@@ -59,6 +60,18 @@ private:
 typedef std::unordered_map<std::string, DirFileCache> DirCheckCacheMap;
 typedef std::unordered_map<std::string, DirFileCache> FileCheckCacheMap;
 
+// Entries of a directory, recorded when the directory was listed.
+// Last modified time of a directory changes whenever an entry is added, removed or renamed,
+// so as long as it keeps the same, the recorded entries can be used instead of listing the
+// directory, and regular files too old to be repushed to PollingModify need not to be checked.
+struct DirEntryCache {
+    // Last modified time of the directory in nanoseconds.
+    int64_t mModifyTime = 0;
+    std::vector<fsutil::Entry> mEntries;
+};
+
+typedef std::unordered_map<std::string, DirEntryCache> DirEntryCacheMap;
+
 struct ModifyCheckCache {
     ModifyCheckCache() : mDev(0), mInode(0), mFileSize(0), mNotExistTimes(0) {
         mModifyTime.tv_sec = 0;
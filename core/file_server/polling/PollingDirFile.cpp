@@ -46,8 +46,6 @@ DEFINE_FLAG_INT32(dirfile_check_interval_ms, "dir file check interval, ms", 5000
 // Windows only supports polling, check more frequently.
 DEFINE_FLAG_INT32(dirfile_check_interval_ms, "dir file check interval, ms", 1000);
 #endif
-DEFINE_FLAG_INT32(dirfile_stat_count, "sleep when dir file stat count up to", 100);
-DEFINE_FLAG_INT32(dirfile_stat_sleep, "sleep time when dir file stat up to 1000, ms", 30);
 DEFINE_FLAG_INT32(polling_dir_upperlimit, "try to remove unchanged dir if dir count is up to", 500000);
 DEFINE_FLAG_INT32(polling_file_upperlimit, "try to remove unchanged file if file count is up to", 500000);
 DEFINE_FLAG_INT32(polling_dir_timeout, "remove unchanged dir if modify time is older than time", 12 * 3600);
@@ -59,7 +57,11 @@ DEFINE_FLAG_INT32(polling_max_stat_count, "max stat count in each round", 100000
 DEFINE_FLAG_INT32(polling_max_stat_count_per_dir, "max stat count per dir in each round", 100000);
 DEFINE_FLAG_INT32(polling_max_stat_count_per_config, "max stat count per config in each round", 100000);
 DEFINE_FLAG_INT32(polling_modify_repush_interval, "polling modify event repush interval, seconds", 10);
+DEFINE_FLAG_BOOL(polling_skip_unchanged_dir, "reuse entries of directories whose modified time is unchanged", true);
+// Should be less than delete_dir_file_round, otherwise cache items of skipped files might be removed.
+DEFINE_FLAG_INT32(polling_dir_full_check_round, "list all directories every such rounds", 12);
 DECLARE_FLAG_INT32(wildcard_max_sub_dir_count);
+DECLARE_FLAG_INT32(polling_stat_batch_size);
 
 using namespace std;
 
@@ -136,6 +138,7 @@ void PollingDirFile::Polling() {
             mStatCount = 0;
             mNewFileVec.clear();
             ++mCurrentRound;
+            mThrottle.Start();
 
             // Get a copy of config list from ConfigManager.
             // PollingDirFile has to be held on at first because raw pointers are used here.
@@ -375,8 +378,8 @@ bool PollingDirFile::PollingNormalConfigPath(const FileDiscoveryConfig& pConfig,
     }
 
     // Iterate directories and files in dirPath.
-    fsutil::Dir dir(dirPath);
-    if (!dir.Open()) {
+    vector<fsutil::Entry> entries;
+    if (!GetDirEntries(dirPath, statBuf, entries)) {
         auto err = GetErrno();
         if (fsutil::Dir::IsENOENT(err)) {
             LOG_DEBUG(sLogger, ("Open dir error, ENOENT, dir", dirPath.c_str()));
@@ -391,16 +394,15 @@ bool PollingDirFile::PollingNormalConfigPath(const FileDiscoveryConfig& pConfig,
         }
         return true;
     }
+
+    // Select entries to stat, then stat them in batches.
     int32_t nowStatCount = 0;
-    fsutil::Entry ent;
-    while ((ent = dir.ReadNext(false))) {
+    vector<fsutil::Entry> statEntries;
+    for (const auto& ent : entries) {
         if (!mRuningFlag || mHoldOnFlag)
-            break;
-
-        if (++mStatCount % INT32_FLAG(dirfile_stat_count) == 0) {
-            usleep(INT32_FLAG(dirfile_stat_sleep) * 1000);
-        }
+            return true;
 
+        ++mStatCount;
         if (mStatCount > INT32_FLAG(polling_max_stat_count)) {
             LOG_WARNING(sLogger,
                         ("total dir's polling stat count is exceeded", nowStatCount)(dirPath, mStatCount)(
@@ -429,59 +431,131 @@ bool PollingDirFile::PollingNormalConfigPath(const FileDiscoveryConfig& pConfig,
         // If the type of item is raw directory or file, use MatchDirPattern or FindBestMatch
         // to check if there are configs that match it.
         auto entName = ent.Name();
-        string item = PathJoin(dirPath, entName);
-        bool needCheckDirMatch = true;
-        bool needFindBestMatch = true;
         if (ent.IsDir()) {
             // Have to call MatchDirPattern, because we have no idea which config matches
             // the directory according to cache.
             // TODO: Refactor directory cache, maintain all configs that match the directory.
-            needCheckDirMatch = false;
-            if (pConfig.first->IsDirectoryInBlacklist(item)) {
+            if (pConfig.first->IsDirectoryInBlacklist(PathJoin(dirPath, entName))) {
                 continue;
             }
         } else if (ent.IsRegFile()) {
             // TODO: Add file cache looking up here: we can skip the file if it is in cache
             // and the match flag is false (no config matches it).
             // There is a cache in FindBestMatch, so the overhead is acceptable now.
-            needFindBestMatch = false;
             if (!ConfigManager::GetInstance()->FindBestMatch(dirPath, entName).first) {
                 continue;
             }
         } else {
             // Symbolic link should be passed, while other types file should ignore.
             if (!ent.IsSymbolic()) {
-                LOG_DEBUG(sLogger, ("should ignore, other type file", item.c_str()));
+                LOG_DEBUG(sLogger, ("should ignore, other type file", PathJoin(dirPath, entName).c_str()));
                 continue;
             }
         }
+        statEntries.push_back(ent);
+    }
 
+    const size_t batchSize = static_cast<size_t>(max(INT32_FLAG(polling_stat_batch_size), 1));
+    vector<string> items;
+    vector<BatchPathStat::Result> results;
+    for (size_t begin = 0; begin < statEntries.size(); begin += batchSize) {
+        if (!mRuningFlag || mHoldOnFlag)
+            break;
+
+        size_t end = min(begin + batchSize, statEntries.size());
+        items.clear();
+        for (size_t i = begin; i < end; ++i) {
+            items.push_back(PathJoin(dirPath, statEntries[i].Name()));
+        }
         // Mainly for symbolic (Linux), we need to use stat to dig out the real type.
-        fsutil::PathStat buf;
-        if (!fsutil::PathStat::stat(item, buf)) {
-            LOG_DEBUG(sLogger, ("get file info error", item.c_str())("errno", errno));
-            continue;
+        mThrottle.AddCpuTime(BatchPathStat::Stat(items, results));
+
+        for (size_t i = begin; i < end; ++i) {
+            const auto& ent = statEntries[i];
+            const auto& item = items[i - begin];
+            const auto& result = results[i - begin];
+            if (!result.mSucceeded) {
+                LOG_DEBUG(sLogger, ("get file info error", item.c_str())("errno", result.mErrno));
+                continue;
+            }
+            const fsutil::PathStat& buf = result.mStat;
+
+            // For directory, poll recursively; for file, update cache and add to mNewFileVec so that
+            // it can be pushed to PollingModify at the end of polling.
+            // If the entry is a symbolic link, we should check file type again to make sure that
+            // the original file which linked by a symbolic file is DIR or REG.
+            bool needCheckDirMatch = !ent.IsDir();
+            bool needFindBestMatch = !ent.IsRegFile();
+            auto entName = ent.Name();
+            if (buf.IsDir() && (!needCheckDirMatch || !pConfig.first->IsDirectoryInBlacklist(item))) {
+                PollingNormalConfigPath(pConfig, dirPath, entName, buf, depth + 1);
+            } else if (buf.IsRegFile()) {
+                if (CheckAndUpdateFileMatchCache(dirPath, entName, buf, needFindBestMatch)) {
+                    LOG_DEBUG(sLogger, ("add to modify event", entName)("round", mCurrentRound));
+                    mNewFileVec.push_back(SplitedFilePath(dirPath, entName));
+                }
+            } else {
+                // Ignore other file type.
+                LOG_DEBUG(sLogger, ("other type file is linked by a symbolic link, should ignore", item.c_str()));
+            }
         }
+        mThrottle.Check();
+    }
+
+    return true;
+}
 
-        // For directory, poll recursively; for file, update cache and add to mNewFileVec so that
-        // it can be pushed to PollingModify at the end of polling.
-        // If needCheckDirMatch or needFindBestMatch is true, that means the item is a symbolic link.
-        // We should check file type again to make sure that the original file which linked by
-        // a symbolic file is DIR or REG.
-        if (buf.IsDir() && (!needCheckDirMatch || !pConfig.first->IsDirectoryInBlacklist(item))) {
-            PollingNormalConfigPath(pConfig, dirPath, entName, buf, depth + 1);
-        } else if (buf.IsRegFile()) {
-            if (CheckAndUpdateFileMatchCache(dirPath, entName, buf, needFindBestMatch)) {
-                LOG_DEBUG(sLogger, ("add to modify event", entName)("round", mCurrentRound));
-                mNewFileVec.push_back(SplitedFilePath(dirPath, entName));
+bool PollingDirFile::GetDirEntries(const string& dirPath,
+                                   const fsutil::PathStat& statBuf,
+                                   vector<fsutil::Entry>& entries) {
+    int64_t sec, nsec;
+    statBuf.GetLastWriteTime(sec, nsec);
+    int64_t modifyTime = NANO_CONVERTING * sec + nsec;
+
+    // Entries are listed every polling_dir_full_check_round rounds anyway, in case that changes are
+    // missed or files are removed from PollingModify by other reasons.
+    bool useCache = BOOL_FLAG(polling_skip_unchanged_dir);
+    if (useCache && INT32_FLAG(polling_dir_full_check_round) > 1
+        && mCurrentRound % INT32_FLAG(polling_dir_full_check_round) != 0) {
+        ScopedSpinLock lock(mCacheLock);
+        auto iter = mDirEntryCacheMap.find(dirPath);
+        if (iter != mDirEntryCacheMap.end() && iter->second.mModifyTime == modifyTime) {
+            // Regular files are still returned if they might be repushed to PollingModify, see
+            // CheckAndUpdateFileMatchCache, only those too old to be repushed are skipped.
+            int64_t curTime = time(NULL);
+            entries.clear();
+            for (const auto& ent : iter->second.mEntries) {
+                if (ent.IsRegFile()) {
+                    auto fileIter = mFileCacheMap.find(PathJoin(dirPath, ent.Name()));
+                    if (fileIter != mFileCacheMap.end()
+                        && curTime - fileIter->second.GetLastModifyTime() / NANO_CONVERTING
+                            >= INT32_FLAG(polling_file_first_watch_timeout)) {
+                        fileIter->second.SetCheckRound(mCurrentRound);
+                        continue;
+                    }
+                }
+                entries.push_back(ent);
             }
-        } else {
-            // Ignore other file type.
-            LOG_DEBUG(sLogger, ("other type file is linked by a symbolic link, should ignore", item.c_str()));
-            continue;
+            return true;
         }
     }
 
+    auto listTime = time(NULL);
+    if (!ListDirEntries(dirPath, entries)) {
+        return false;
+    }
+    if (useCache) {
+        ScopedSpinLock lock(mCacheLock);
+        // For filesystems with coarse timestamps, changes right after listing might not update the
+        // last modified time, so only directories not modified for a while are recorded.
+        if (listTime - sec >= 2) {
+            auto& cache = mDirEntryCacheMap[dirPath];
+            cache.mModifyTime = modifyTime;
+            cache.mEntries = entries;
+        } else {
+            mDirEntryCacheMap.erase(dirPath);
+        }
+    }
     return true;
 }
 
@@ -576,8 +650,8 @@ bool PollingDirFile::PollingWildcardConfigPath(const FileDiscoveryConfig& pConfi
             break;
         }
 
-        if (++mStatCount % INT32_FLAG(dirfile_stat_count) == 0)
-            usleep(INT32_FLAG(dirfile_stat_sleep) * 1000);
+        ++mStatCount;
+        mThrottle.Check();
 
         if (mStatCount > INT32_FLAG(polling_max_stat_count)) {
             LOG_WARNING(sLogger,
@@ -648,6 +722,7 @@ void PollingDirFile::ClearTimeoutFileAndDir() {
             for (auto iter = mDirCacheMap.begin(); iter != mDirCacheMap.end();) {
                 if ((NANO_CONVERTING * curTime - iter->second.GetLastModifyTime())
                     > NANO_CONVERTING * INT32_FLAG(polling_dir_timeout)) {
+                    mDirEntryCacheMap.erase(iter->first);
                     iter = mDirCacheMap.erase(iter);
                 } else
                     ++iter;
@@ -694,6 +769,7 @@ void PollingDirFile::ClearUnavailableFileAndDir() {
                 if (cacheItem.HasMatchedConfig()) {
                     eventVec.push_back(new Event(iter->first, string(), EVENT_TIMEOUT | EVENT_ISDIR, 0, 0));
                 }
+                mDirEntryCacheMap.erase(iter->first);
                 iter = mDirCacheMap.erase(iter);
             } else
                 ++iter;
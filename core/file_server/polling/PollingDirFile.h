@@ -18,6 +18,7 @@
 #include <map>
 
 #include "file_server/polling/PollingCache.h"
+#include "file_server/polling/PollingStat.h"
 #include "common/Lock.h"
 #include "common/LogRunnable.h"
 #include "common/Thread.h"
@@ -48,6 +49,7 @@ public:
     void ClearCache() {
         mDirCacheMap.clear();
         mFileCacheMap.clear();
+        mDirEntryCacheMap.clear();
         mStatCount = 0;
         mNewFileVec.clear();
         mCurrentRound = 0;
@@ -77,6 +79,14 @@ private:
     // @return true if at least one directory was found during polling.
     bool PollingWildcardConfigPath(const FileDiscoveryConfig& pConfig, const std::string& dirPath, int depth);
 
+    // GetDirEntries lists entries of @dirPath. If the directory has not changed since it was listed
+    // in a previous round, recorded entries are returned instead, excluding regular files which are
+    // too old to be repushed to PollingModify (see DirEntryCache).
+    // @statBuf: stat of the directory.
+    // @return false if the directory can not be listed, use GetErrno() to get the reason.
+    bool
+    GetDirEntries(const std::string& dirPath, const fsutil::PathStat& statBuf, std::vector<fsutil::Entry>& entries);
+
     // CheckAndUpdateDirMatchCache updates dir cache (add if not existing).
     // The caller of this method should make sure that there is at least one config matches
     // @dirPath.
@@ -128,6 +138,8 @@ private:
     SpinLock mCacheLock;
     DirCheckCacheMap mDirCacheMap;
     FileCheckCacheMap mFileCacheMap;
+    // Entries of directories listed, removed along with corresponding item in mDirCacheMap.
+    DirEntryCacheMap mDirEntryCacheMap;
 
     // Record how much times stat is called, if it exceeds limit, stop polling.
     int32_t mStatCount;
@@ -135,6 +147,7 @@ private:
     std::vector<SplitedFilePath> mNewFileVec;
     // The sequence number of current round, uint64_t is used to avoid overflow.
     uint64_t mCurrentRound;
+    PollingThrottle mThrottle;
 
     IntGaugePtr mPollingDirCacheSize;
     IntGaugePtr mPollingFileCacheSize;
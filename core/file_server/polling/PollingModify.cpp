@@ -34,10 +34,9 @@ using namespace std;
 
 DEFINE_FLAG_INT32(modify_check_interval, "modify check interval ms", 1000);
 DEFINE_FLAG_INT32(ignore_file_modify_timeout, "if file modify time is up to XXX seconds, ignore it", 180);
-DEFINE_FLAG_INT32(modify_stat_count, "sleep when dir file stat count up to", 100);
-DEFINE_FLAG_INT32(modify_stat_sleepMs, "sleep time when dir file stat up to 1000, ms", 10);
 DEFINE_FLAG_INT32(modify_cache_max, "max modify chache size, if exceed, delete 0.2 oldest", 100000);
 DEFINE_FLAG_INT32(modify_cache_make_space_interval, "second", 600);
+DECLARE_FLAG_INT32(polling_stat_batch_size);
 
 namespace logtail {
 
@@ -251,44 +250,57 @@ void PollingModify::Polling() {
 
             vector<SplitedFilePath> deletedFileVec;
             vector<Event*> pollingEventVec;
-            int32_t statCount = 0;
             size_t pollingModifySizeTotal = mModifyCacheMap.size();
             LogtailMonitor::GetInstance()->UpdateMetric("polling_modify_size", pollingModifySizeTotal);
             mPollingModifySize->Set(pollingModifySizeTotal);
-            for (auto iter = mModifyCacheMap.begin(); iter != mModifyCacheMap.end(); ++iter) {
+
+            // Stat files in batches, then compare with cache one by one.
+            const size_t batchSize = static_cast<size_t>(max(INT32_FLAG(polling_stat_batch_size), 1));
+            vector<ModifyCheckCacheMap::iterator> batch;
+            vector<string> filePaths;
+            vector<BatchPathStat::Result> results;
+            mThrottle.Start();
+            for (auto iter = mModifyCacheMap.begin(); iter != mModifyCacheMap.end();) {
                 if (!mRuningFlag || mHoldOnFlag)
                     break;
 
-                const SplitedFilePath& filePath = iter->first;
-                ModifyCheckCache& modifyCache = iter->second;
-                fsutil::PathStat logFileStat;
-                if (!fsutil::PathStat::stat(PathJoin(filePath.mFileDir, filePath.mFileName), logFileStat)) {
-                    if (errno == ENOENT) {
-                        LOG_DEBUG(sLogger, ("file deleted", PathJoin(filePath.mFileDir, filePath.mFileName)));
-                        if (UpdateDeletedFile(filePath, modifyCache, pollingEventVec)) {
-                            deletedFileVec.push_back(filePath);
+                batch.clear();
+                filePaths.clear();
+                for (; iter != mModifyCacheMap.end() && batch.size() < batchSize; ++iter) {
+                    batch.push_back(iter);
+                    filePaths.push_back(PathJoin(iter->first.mFileDir, iter->first.mFileName));
+                }
+                mThrottle.AddCpuTime(BatchPathStat::Stat(filePaths, results));
+
+                for (size_t i = 0; i < batch.size(); ++i) {
+                    const SplitedFilePath& filePath = batch[i]->first;
+                    ModifyCheckCache& modifyCache = batch[i]->second;
+                    const auto& result = results[i];
+                    if (!result.mSucceeded) {
+                        if (result.mErrno == ENOENT) {
+                            LOG_DEBUG(sLogger, ("file deleted", filePaths[i]));
+                            if (UpdateDeletedFile(filePath, modifyCache, pollingEventVec)) {
+                                deletedFileVec.push_back(filePath);
+                            }
+                        } else {
+                            LOG_DEBUG(sLogger, ("get file info error", filePaths[i]));
                         }
                     } else {
-                        LOG_DEBUG(sLogger, ("get file info error", PathJoin(filePath.mFileDir, filePath.mFileName)));
+                        const fsutil::PathStat& logFileStat = result.mStat;
+                        int64_t sec, nsec;
+                        logFileStat.GetLastWriteTime(sec, nsec);
+                        timespec mtim{sec, nsec};
+                        auto devInode = logFileStat.GetDevInode();
+                        UpdateFile(filePath,
+                                   modifyCache,
+                                   devInode.dev,
+                                   devInode.inode,
+                                   logFileStat.GetFileSize(),
+                                   mtim,
+                                   pollingEventVec);
                     }
-                } else {
-                    int64_t sec, nsec;
-                    logFileStat.GetLastWriteTime(sec, nsec);
-                    timespec mtim{sec, nsec};
-                    auto devInode = logFileStat.GetDevInode();
-                    UpdateFile(filePath,
-                               modifyCache,
-                               devInode.dev,
-                               devInode.inode,
-                               logFileStat.GetFileSize(),
-                               mtim,
-                               pollingEventVec);
-                }
-
-                ++statCount;
-                if (statCount % INT32_FLAG(modify_stat_count) == 0) {
-                    usleep(1000 * INT32_FLAG(modify_stat_sleepMs));
                 }
+                mThrottle.Check();
             }
 
             if (pollingEventVec.size() > 0) {
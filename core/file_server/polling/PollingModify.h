@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "file_server/polling/PollingCache.h"
+#include "file_server/polling/PollingStat.h"
 #include "common/Lock.h"
 #include "common/LogRunnable.h"
 #include "common/Thread.h"
@@ -100,6 +101,7 @@ private:
     std::deque<SplitedFilePath> mDeletedFileNameQueue;
 
     ModifyCheckCacheMap mModifyCacheMap;
+    PollingThrottle mThrottle;
 
     IntGaugePtr mPollingModifySize;
 
@@ -0,0 +1,286 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "file_server/polling/PollingStat.h"
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(_MSC_VER)
+#include <Windows.h>
+#endif
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <ctime>
+#include <deque>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+#include "common/Flags.h"
+#include "logger/Logger.h"
+
+DEFINE_FLAG_INT32(polling_cpu_budget_percent,
+                  "cpu time of each polling thread, percent of wall time, throttling is disabled if not in (0, 100)",
+                  10);
+DEFINE_FLAG_INT32(polling_stat_thread_count, "max threads to stat files concurrently in polling", 4);
+DEFINE_FLAG_INT32(polling_stat_batch_size, "max paths to stat in a batch in polling", 1024);
+DEFINE_FLAG_INT32(polling_dir_entry_buffer_size,
+                  "buffer size to read directory entries in polling, bytes",
+                  1024 * 1024);
+
+using namespace std;
+
+namespace logtail {
+
+// Check is called for each stat, only look at the clocks from time to time.
+static const int64_t kThrottleCheckIntervalMs = 10;
+// Keep polling threads responsive to stop and hold on.
+static const int64_t kThrottleMaxSleepMs = 1000;
+// Not worth starting a thread for fewer stats.
+static const size_t kMinPathsPerStatThread = 32;
+
+void PollingThrottle::Start() {
+    mStartTime = mLastCheckTime = chrono::steady_clock::now();
+    mStartCpuTimeNs = GetThreadCpuTimeNs();
+    mExtraCpuTimeNs = 0;
+}
+
+void PollingThrottle::Check() {
+    int64_t budget = INT32_FLAG(polling_cpu_budget_percent);
+    if (budget <= 0 || budget >= 100) {
+        return;
+    }
+    auto now = chrono::steady_clock::now();
+    if (now - mLastCheckTime < chrono::milliseconds(kThrottleCheckIntervalMs)) {
+        return;
+    }
+    mLastCheckTime = now;
+
+    int64_t cpuTimeNs = GetThreadCpuTimeNs() - mStartCpuTimeNs + mExtraCpuTimeNs;
+    int64_t wallTimeNs = chrono::duration_cast<chrono::nanoseconds>(now - mStartTime).count();
+    int64_t sleepNs = cpuTimeNs * 100 / budget - wallTimeNs;
+    if (sleepNs <= 0) {
+        return;
+    }
+    this_thread::sleep_for(chrono::nanoseconds(min(sleepNs, kThrottleMaxSleepMs * 1000 * 1000)));
+    mLastCheckTime = chrono::steady_clock::now();
+}
+
+int64_t PollingThrottle::GetThreadCpuTimeNs() {
+#if defined(__linux__)
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+        return 0;
+    }
+    return static_cast<int64_t>(ts.tv_sec) * 1000 * 1000 * 1000 + ts.tv_nsec;
+#elif defined(_MSC_VER)
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+        return 0;
+    }
+    ULARGE_INTEGER kernel, user;
+    kernel.LowPart = kernelTime.dwLowDateTime;
+    kernel.HighPart = kernelTime.dwHighDateTime;
+    user.LowPart = userTime.dwLowDateTime;
+    user.HighPart = userTime.dwHighDateTime;
+    // In 100-nanosecond units.
+    return static_cast<int64_t>(kernel.QuadPart + user.QuadPart) * 100;
+#endif
+}
+
+static void StatPath(const string& path, BatchPathStat::Result& result) {
+    result.mSucceeded = fsutil::PathStat::stat(path, result.mStat);
+    result.mErrno = result.mSucceeded ? 0 : errno;
+}
+
+namespace {
+
+struct StatJob {
+    StatJob(const vector<string>& paths, vector<BatchPathStat::Result>& results) : mPaths(paths), mResults(results) {}
+
+    void Run() {
+        for (size_t i = mNextIndex++; i < mPaths.size(); i = mNextIndex++) {
+            StatPath(mPaths[i], mResults[i]);
+        }
+    }
+
+    const vector<string>& mPaths;
+    vector<BatchPathStat::Result>& mResults;
+    atomic_size_t mNextIndex{0};
+    atomic<int64_t> mWorkerCpuTimeNs{0};
+    // workers running the job, protected by the mutex of the pool
+    size_t mRunningCount = 0;
+};
+
+// Worker threads are started on first use and kept till exit, so that polling does not start threads every round.
+class StatThreadPool {
+public:
+    static StatThreadPool* GetInstance() {
+        static StatThreadPool sInstance;
+        return &sInstance;
+    }
+
+    ~StatThreadPool() {
+        {
+            lock_guard<mutex> lock(mMux);
+            mIsStopped = true;
+        }
+        mJobCond.notify_all();
+        for (auto& thread : mThreads) {
+            thread.join();
+        }
+    }
+
+    // runs the job in the calling thread and at most workerCount workers, returns when all paths are stated
+    void Run(StatJob& job, size_t workerCount) {
+        {
+            lock_guard<mutex> lock(mMux);
+            while (mThreads.size() < workerCount) {
+                try {
+                    mThreads.emplace_back(&StatThreadPool::Work, this);
+                } catch (const system_error& e) {
+                    // The remaining paths are handled by existing workers and the calling thread.
+                    LOG_WARNING(sLogger, ("failed to start polling stat thread", e.what()));
+                    break;
+                }
+            }
+            for (size_t i = 0; i < min(workerCount, mThreads.size()); ++i) {
+                mJobs.push_back(&job);
+            }
+        }
+        mJobCond.notify_all();
+        job.Run();
+        unique_lock<mutex> lock(mMux);
+        // workers busy with other jobs are not waited for
+        mJobs.erase(remove(mJobs.begin(), mJobs.end(), &job), mJobs.end());
+        mDoneCond.wait(lock, [&job]() { return job.mRunningCount == 0; });
+    }
+
+private:
+    StatThreadPool() = default;
+
+    void Work() {
+        unique_lock<mutex> lock(mMux);
+        while (true) {
+            mJobCond.wait(lock, [this]() { return mIsStopped || !mJobs.empty(); });
+            if (mIsStopped) {
+                return;
+            }
+            StatJob* job = mJobs.front();
+            mJobs.pop_front();
+            ++job->mRunningCount;
+            lock.unlock();
+            int64_t startCpuTimeNs = PollingThrottle::GetThreadCpuTimeNs();
+            job->Run();
+            job->mWorkerCpuTimeNs += PollingThrottle::GetThreadCpuTimeNs() - startCpuTimeNs;
+            lock.lock();
+            if (--job->mRunningCount == 0) {
+                mDoneCond.notify_all();
+            }
+        }
+    }
+
+    mutex mMux;
+    condition_variable mJobCond;
+    condition_variable mDoneCond;
+    deque<StatJob*> mJobs;
+    vector<thread> mThreads;
+    bool mIsStopped = false;
+};
+
+} // namespace
+
+int64_t BatchPathStat::Stat(const vector<string>& paths, vector<Result>& results) {
+    results.clear();
+    results.resize(paths.size());
+    size_t threadCount = min(static_cast<size_t>(max(INT32_FLAG(polling_stat_thread_count), 1)),
+                             paths.size() / kMinPathsPerStatThread);
+    if (threadCount <= 1) {
+        for (size_t i = 0; i < paths.size(); ++i) {
+            StatPath(paths[i], results[i]);
+        }
+        return 0;
+    }
+
+    StatJob job(paths, results);
+    StatThreadPool::GetInstance()->Run(job, threadCount - 1);
+    return job.mWorkerCpuTimeNs;
+}
+
+#if defined(__linux__)
+// Layout of struct linux_dirent64, which is not exported by glibc.
+struct LinuxDirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+#endif
+
+bool ListDirEntries(const string& dirPath, vector<fsutil::Entry>& entries) {
+    entries.clear();
+#if defined(__linux__)
+    int fd = open(dirPath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    static thread_local vector<char> sBuffer;
+    sBuffer.resize(static_cast<size_t>(max(INT32_FLAG(polling_dir_entry_buffer_size), 32 * 1024)));
+    while (true) {
+        long size = syscall(SYS_getdents64, fd, sBuffer.data(), sBuffer.size());
+        if (size <= 0) {
+            // Same as readdir, an error is treated as the end of the directory.
+            if (size < 0) {
+                LOG_DEBUG(sLogger, ("failed to read dir entries", dirPath)("errno", errno));
+            }
+            break;
+        }
+        for (long pos = 0; pos < size;) {
+            auto ent = reinterpret_cast<const LinuxDirent64*>(sBuffer.data() + pos);
+            pos += ent->d_reclen;
+            if (ent->d_name[0] == '.') {
+                continue;
+            }
+            // Same as fsutil::Dir::ReadNext(false), symbolic links and unknown types are left to the caller.
+            fsutil::Entry::Type type = fsutil::Entry::Type::UNKNOWN;
+            if (ent->d_type == DT_DIR) {
+                type = fsutil::Entry::Type::DIR;
+            } else if (ent->d_type == DT_REG) {
+                type = fsutil::Entry::Type::REG_FILE;
+            }
+            entries.emplace_back(ent->d_name, type, ent->d_type == DT_LNK);
+        }
+    }
+    close(fd);
+    return true;
+#elif defined(_MSC_VER)
+    fsutil::Dir dir(dirPath);
+    if (!dir.Open()) {
+        return false;
+    }
+    fsutil::Entry ent;
+    while ((ent = dir.ReadNext(false))) {
+        entries.push_back(ent);
+    }
+    return true;
+#endif
+}
+
+} // namespace logtail
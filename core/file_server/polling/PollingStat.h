@@ -0,0 +1,77 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/FileSystemUtil.h"
+
+namespace logtail {
+
+// PollingThrottle limits the CPU time consumed by a polling thread to a percentage of the
+// wall time of current round (flag polling_cpu_budget_percent). Unlike sleeping after a fixed
+// number of stats, time spent waiting for slow filesystems (NFS, overlayfs) is not penalized.
+class PollingThrottle {
+public:
+    // Start is called at the beginning of each round.
+    void Start();
+    // AddCpuTime accounts CPU time consumed by other threads on behalf of the polling thread.
+    void AddCpuTime(int64_t cpuTimeNs) { mExtraCpuTimeNs += cpuTimeNs; }
+    // Check sleeps if the budget is exceeded, it is cheap enough to be called for each stat.
+    void Check();
+
+    static int64_t GetThreadCpuTimeNs();
+
+private:
+    std::chrono::steady_clock::time_point mStartTime;
+    std::chrono::steady_clock::time_point mLastCheckTime;
+    int64_t mStartCpuTimeNs = 0;
+    int64_t mExtraCpuTimeNs = 0;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class PollingStatUnittest;
+#endif
+};
+
+// BatchPathStat stats a batch of paths concurrently in a pool of worker threads shared by all
+// polling threads, together with the calling thread (flag polling_stat_thread_count).
+// Most time of stat on network or overlay filesystems is spent on waiting, so issuing them in
+// parallel shortens a polling round roughly by the number of threads.
+class BatchPathStat {
+public:
+    struct Result {
+        bool mSucceeded = false;
+        // errno of the failed stat.
+        int mErrno = 0;
+        fsutil::PathStat mStat;
+    };
+
+    // @return CPU time consumed by worker threads in nanoseconds, 0 if all stats are done in
+    //   the calling thread.
+    static int64_t Stat(const std::vector<std::string>& paths, std::vector<Result>& results);
+};
+
+// ListDirEntries lists entries of @dirPath in the same way as fsutil::Dir::ReadNext(false).
+// On Linux, entries are read by getdents64 with a large buffer (flag polling_dir_entry_buffer_size),
+// so that a huge directory is listed with few syscalls.
+// @return false if the directory can not be opened, use GetErrno() to get the reason.
+bool ListDirEntries(const std::string& dirPath, std::vector<fsutil::Entry>& entries);
+
+} // namespace logtail
@@ -14,11 +14,106 @@
 
 #include "file_server/reader/JsonLogFileReader.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
 #include "logger/Logger.h"
 
 using namespace std;
 
 namespace logtail {
+
+namespace {
+
+const uint64_t kEvenBits = 0x5555555555555555ULL;
+const uint64_t kOddBits = ~kEvenBits;
+
+// Bitmaps of a block of 64 bytes, where bit i is set if byte i is the char.
+struct JsonBlockBits {
+    uint64_t mBackslash = 0;
+    uint64_t mQuote = 0;
+    uint64_t mOpenBrace = 0;
+    uint64_t mCloseBrace = 0;
+    uint64_t mLineFeed = 0;
+};
+
+inline void ClassifyJsonBlock(const char* block, JsonBlockBits& bits) {
+#if defined(__SSE2__)
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i openBrace = _mm_set1_epi8('{');
+    const __m128i closeBrace = _mm_set1_epi8('}');
+    const __m128i lineFeed = _mm_set1_epi8('\n');
+    for (int i = 0; i < 4; ++i) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i * 16));
+        int shift = i * 16;
+        bits.mBackslash |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, backslash)))) << shift;
+        bits.mQuote |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote)))) << shift;
+        bits.mOpenBrace |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, openBrace)))) << shift;
+        bits.mCloseBrace |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, closeBrace)))) << shift;
+        bits.mLineFeed |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, lineFeed)))) << shift;
+    }
+#else
+    for (int i = 0; i < 64; ++i) {
+        uint64_t bit = uint64_t(1) << i;
+        switch (block[i]) {
+            case '\\':
+                bits.mBackslash |= bit;
+                break;
+            case '"':
+                bits.mQuote |= bit;
+                break;
+            case '{':
+                bits.mOpenBrace |= bit;
+                break;
+            case '}':
+                bits.mCloseBrace |= bit;
+                break;
+            case '\n':
+                bits.mLineFeed |= bit;
+                break;
+            default:
+                break;
+        }
+    }
+#endif
+}
+
+// FindEscapedChars returns the bitmap of chars following an odd-length sequence of backslashes, which are escaped.
+// @prevEndsOddBackslash is 1 if the first char of the block is escaped by backslashes of previous blocks, and it is set
+// for the next block.
+inline uint64_t FindEscapedChars(uint64_t backslash, uint64_t& prevEndsOddBackslash) {
+    uint64_t startEdges = backslash & ~(backslash << 1);
+    uint64_t evenStartMask = kEvenBits ^ prevEndsOddBackslash;
+    uint64_t evenStarts = startEdges & evenStartMask;
+    uint64_t oddStarts = startEdges & ~evenStartMask;
+    uint64_t evenCarries = backslash + evenStarts;
+    uint64_t oddCarries = backslash + oddStarts;
+    bool endsOddBackslash = oddCarries < backslash;
+    oddCarries |= prevEndsOddBackslash;
+    prevEndsOddBackslash = endsOddBackslash ? 1 : 0;
+    uint64_t evenCarryEnds = evenCarries & ~backslash;
+    uint64_t oddCarryEnds = oddCarries & ~backslash;
+    return (evenCarryEnds & kOddBits) | (oddCarryEnds & kEvenBits);
+}
+
+// PrefixXor sets bit i to the xor of bits [0, i] of @bits.
+inline uint64_t PrefixXor(uint64_t bits) {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+} // namespace
+
 int32_t JsonLogFileReader::RemoveLastIncompleteLog(char* buffer,
                                                    int32_t size,
                                                    int32_t& rollbackLineFeedCount,
@@ -28,9 +123,19 @@ int32_t JsonLogFileReader::RemoveLastIncompleteLog(char* buffer,
     int32_t beginIdx = 0;
     rollbackLineFeedCount = 0;
     bool startWithBlock = false;
+    // The buffer starts with mCache, which holds the bytes rolled back last time. Bytes of other encodings are converted
+    // before, so the scan is only resumed for UTF8.
+    JsonScanState state;
+    if (mPendingScanOffset == mLastFilePos && mReaderConfig.first->mFileEncoding == FileReaderOptions::Encoding::UTF8
+        && static_cast<size_t>(mPendingScanState.mScannedSize) == mCache.size()
+        && mPendingScanState.mScannedSize <= size) {
+        state = mPendingScanState;
+    }
+    mPendingScanState = JsonScanState();
+    mPendingScanOffset = -1;
     // check if has json block in this buffer
     do {
-        if (!FindJsonMatch(buffer, beginIdx, size, endIdx, startWithBlock, allowRollback)) {
+        if (!FindJsonMatch(buffer, beginIdx, size, endIdx, startWithBlock, allowRollback, state)) {
             if (startWithBlock && allowRollback) { // may be the ending } has not been read, rollback
                 break;
             }
@@ -41,6 +146,7 @@ int32_t JsonLogFileReader::RemoveLastIncompleteLog(char* buffer,
             }
             endIdx = pos - buffer;
         }
+        state = JsonScanState();
         // advance if json is valid or impossible to be valid
         beginIdx = endIdx + 1;
         buffer[endIdx] = '\0';
@@ -48,7 +154,13 @@ int32_t JsonLogFileReader::RemoveLastIncompleteLog(char* buffer,
     readBytes = beginIdx;
 
     if (allowRollback) {
-        rollbackLineFeedCount = std::count(buffer + beginIdx, buffer + size, '\n');
+        if (state.mScannedSize > 0 && state.mScannedSize == size - beginIdx) {
+            mPendingScanState = state;
+            mPendingScanOffset = mLastFilePos + beginIdx;
+            rollbackLineFeedCount = state.mLineFeedCount;
+        } else {
+            rollbackLineFeedCount = std::count(buffer + beginIdx, buffer + size, '\n');
+        }
         if (beginIdx < size && buffer[size - 1] != '\n') {
             ++rollbackLineFeedCount;
         }
@@ -58,76 +170,114 @@ int32_t JsonLogFileReader::RemoveLastIncompleteLog(char* buffer,
     return readBytes;
 }
 
-bool JsonLogFileReader::FindJsonMatch(
-    char* buffer, int32_t beginIdx, int32_t size, int32_t& endIdx, bool& startWithBlock, bool allowRollback) {
+bool JsonLogFileReader::FindJsonMatch(char* buffer,
+                                      int32_t beginIdx,
+                                      int32_t size,
+                                      int32_t& endIdx,
+                                      bool& startWithBlock,
+                                      bool allowRollback,
+                                      JsonScanState& state) {
     int32_t idx = beginIdx;
-    while (idx < size) {
-        if (buffer[idx] == ' ' || buffer[idx] == '\n' || buffer[idx] == '\t' || buffer[idx] == '\0')
-            idx++;
-        else
-            break;
+    if (state.mScannedSize > 0) {
+        // resume the scan of the log
+        idx += state.mScannedSize;
+    } else {
+        while (idx < size) {
+            if (buffer[idx] == ' ' || buffer[idx] == '\n' || buffer[idx] == '\t' || buffer[idx] == '\0')
+                idx++;
+            else
+                break;
+        }
+        // return true when total buffer is empty
+        if (beginIdx == 0 && idx == size && size > 0) {
+            endIdx = size - 1;
+            LOG_DEBUG(sLogger, ("empty json content, skip from ", beginIdx)("to", size));
+            startWithBlock = false;
+            return true;
+        }
+        if (idx == size || buffer[idx] != '{') {
+            LOG_DEBUG(sLogger,
+                      ("invalid json begining", buffer + beginIdx)("project", mReaderConfig.second->GetProjectName())(
+                          "logstore", mReaderConfig.second->GetLogstoreName())("file", mHostLogPath));
+            startWithBlock = false;
+            return false;
+        }
+        // leading blanks are part of the log
+        state.mLineFeedCount = std::count(buffer + beginIdx, buffer + idx, '\n');
     }
-    // return true when total buffer is empty
-    if (beginIdx == 0 && idx == size && size > 0) {
-        endIdx = size - 1;
-        LOG_DEBUG(sLogger, ("empty json content, skip from ", beginIdx)("to", size));
-        startWithBlock = false;
+    startWithBlock = true;
+
+    idx = ScanJson(buffer, idx, size, state);
+    if (idx >= 0) {
+        endIdx = idx;
         return true;
     }
-    if (idx == size || buffer[idx] != '{') {
-        LOG_DEBUG(sLogger,
-                  ("invalid json begining", buffer + beginIdx)("project", mReaderConfig.second->GetProjectName())(
-                      "logstore", mReaderConfig.second->GetLogstoreName())("file", mHostLogPath));
-        startWithBlock = false;
+    if (idx == -2) {
+        LOG_WARNING(sLogger,
+                    ("brace count", state.mBraceCount)("brace not match, invalid json begining", buffer + beginIdx)(
+                        "project", mReaderConfig.second->GetProjectName())(
+                        "logstore", mReaderConfig.second->GetLogstoreName())("file", mHostLogPath));
+        state = JsonScanState();
         return false;
     }
-    startWithBlock = true;
-
-    int32_t braceCount = 0;
-    bool inQuote = false;
-    for (; idx < size; ++idx) {
-        switch (buffer[idx]) {
-            case '{':
-                if (!inQuote)
-                    braceCount++;
-                break;
-            case '}':
-                if (!inQuote)
-                    braceCount--;
-                if (braceCount < 0) {
-                    LOG_WARNING(sLogger,
-                                ("brace count", braceCount)("brace not match, invalid json begining",
-                                                            buffer + beginIdx)("project",
-                                                                               mReaderConfig.second->GetProjectName())(
-                                    "logstore", mReaderConfig.second->GetLogstoreName())("file", mHostLogPath));
-                    return false;
-                }
-                break;
-            case '\n':
-                if (braceCount == 0) {
-                    endIdx = idx;
-                    return true;
-                }
-                break;
-            case '"':
-                inQuote = !inQuote;
-                break;
-            case '\\':
-                ++idx; // skip next char after escape char
-                break;
-            default:
-                break;
-        }
-    }
-    if (!allowRollback && braceCount == 0) {
+    state.mScannedSize = size - beginIdx;
+    if (!allowRollback && state.mBraceCount == 0) {
         // when !allowRollback, we can return true because the tailing \n will be ignored in the next read
-        endIdx = idx; // assert idx == size
+        endIdx = size;
         return true;
     }
     LOG_DEBUG(sLogger,
-              ("find no match, beginIdx", beginIdx)("idx", idx)("project", mReaderConfig.second->GetProjectName())(
+              ("find no match, beginIdx", beginIdx)("idx", size)("project", mReaderConfig.second->GetProjectName())(
                   "logstore", mReaderConfig.second->GetLogstoreName())("file", mHostLogPath));
     return false;
 }
 
+// ScanJson classifies 64 bytes at a time into bitmaps, as the first stage of simdjson does. Escaped chars are found by
+// backslash sequences of odd length, and chars in quotes by the prefix xor of unescaped quotes, so that the bytes are
+// walked one by one only for braces out of quotes and line feeds.
+int32_t JsonLogFileReader::ScanJson(const char* buffer, int32_t idx, int32_t size, JsonScanState& state) {
+    uint64_t prevEscaped = state.mEscaped ? 1 : 0;
+    uint64_t prevInQuote = state.mInQuote ? ~uint64_t(0) : 0;
+    char tail[64];
+    while (idx < size) {
+        const char* block = buffer + idx;
+        int32_t len = std::min(size - idx, 64);
+        if (len < 64) {
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, block, len);
+            block = tail;
+        }
+        JsonBlockBits bits;
+        ClassifyJsonBlock(block, bits);
+        uint64_t escaped = FindEscapedChars(bits.mBackslash, prevEscaped);
+        uint64_t inQuote = PrefixXor(bits.mQuote & ~escaped) ^ prevInQuote;
+        uint64_t braces = (bits.mOpenBrace | bits.mCloseBrace) & ~inQuote;
+        uint64_t structurals = (braces | bits.mLineFeed) & ~escaped;
+        while (structurals != 0) {
+            int pos = __builtin_ctzll(structurals);
+            structurals &= structurals - 1;
+            if (block[pos] == '{') {
+                ++state.mBraceCount;
+            } else if (block[pos] == '}') {
+                if (--state.mBraceCount < 0) {
+                    return -2;
+                }
+            } else if (state.mBraceCount == 0) {
+                return idx + pos;
+            }
+        }
+        state.mLineFeedCount += __builtin_popcountll(bits.mLineFeed);
+        if (len < 64) {
+            state.mInQuote = (inQuote >> (len - 1)) & 1;
+            state.mEscaped = (escaped >> len) & 1;
+            return -1;
+        }
+        prevInQuote = static_cast<uint64_t>(static_cast<int64_t>(inQuote) >> 63);
+        idx += 64;
+    }
+    state.mInQuote = prevInQuote != 0;
+    state.mEscaped = prevEscaped != 0;
+    return -1;
+}
+
 } // namespace logtail
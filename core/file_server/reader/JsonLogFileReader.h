@@ -36,8 +36,35 @@ protected:
                                     bool allowRollback = true) override;
 
 private:
-    bool FindJsonMatch(
-        char* buffer, int32_t beginIdx, int32_t size, int32_t& endIdx, bool& startWithBlock, bool allowRollback = true);
+    // JsonScanState is the state of the structural scan of a json log, so that the scan of a log not complete in one
+    // read can be resumed in the next read.
+    struct JsonScanState {
+        // bytes of the log scanned, 0 if the scan has not started
+        int32_t mScannedSize = 0;
+        int32_t mBraceCount = 0;
+        bool mInQuote = false;
+        // whether the byte following the scanned ones is escaped
+        bool mEscaped = false;
+        // line feeds in the scanned bytes
+        int32_t mLineFeedCount = 0;
+    };
+
+    bool FindJsonMatch(char* buffer,
+                       int32_t beginIdx,
+                       int32_t size,
+                       int32_t& endIdx,
+                       bool& startWithBlock,
+                       bool allowRollback,
+                       JsonScanState& state);
+    // ScanJson scans [@idx, @size) of @buffer from @state, which is updated if the end is reached. It returns the index
+    // of the first line feed out of braces, -1 if there is none, or -2 if braces do not match.
+    static int32_t ScanJson(const char* buffer, int32_t idx, int32_t size, JsonScanState& state);
+
+    // State of the scan of the incomplete log rolled back to mCache in the last read, which starts at
+    // mPendingScanOffset. The rolled back bytes are the beginning of the next read, so their scan is resumed there
+    // instead of started over, which matters for multi-line json logs spanning many reads.
+    JsonScanState mPendingScanState;
+    int64_t mPendingScanOffset = -1;
 
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class JsonLogFileReaderUnittest;
@@ -47,6 +47,7 @@
 #include "file_server/reader/JsonLogFileReader.h"
 #include "logger/Logger.h"
 #include "monitor/AlarmManager.h"
+#include "monitor/LatencyTraceRecorder.h"
 #include "monitor/metric_constants/MetricConstants.h"
 #include "pipeline/queue/ExactlyOnceQueueManager.h"
 #include "pipeline/queue/ProcessQueueManager.h"
@@ -736,8 +737,8 @@ void LogFileReader::FixLastFilePos(LogFileOperator& op, int64_t endOffset) {
         for (size_t endPs = 0; endPs < readSizeReal - 1; ++endPs) {
             if (readBuf[endPs] == '\n') {
                 LineInfo line = GetLastLine(StringView(readBuf, readSizeReal - 1), endPs, true);
-                if (BoostRegexSearch(
-                        line.data.data(), line.data.size(), *mMultilineConfig.first->GetStartPatternReg(), exception)) {
+                if (mMultilineConfig.first->GetStartPatternReg()->Match(
+                        line.data.data(), line.data.size(), exception)) {
                     mLastFilePos += line.lineBegin;
                     mCache.clear();
                     free(readBuf);
@@ -945,6 +946,7 @@ bool LogFileReader::ReadLog(LogBuffer& logBuffer, const Event* event) {
     }
     bool moreData = GetRawData(logBuffer, mLastFileSize, tryRollback);
     if (!logBuffer.rawBuffer.empty() > 0) {
+        logBuffer.latencyTrace = LatencyTraceRecorder::StartTrace();
         if (mEOOption) {
             // This read was replayed by checkpoint, adjust mLastFilePos to skip hole.
             if (mEOOption->selectedCheckpoint->IsComplete()) {
@@ -1708,7 +1710,8 @@ void LogFileReader::ReadUTF8(LogBuffer& logBuffer, int64_t end, bool& moreData,
 }
 
 void LogFileReader::ReadGBK(LogBuffer& logBuffer, int64_t end, bool& moreData, bool tryRollback) {
-    std::unique_ptr<char[]> gbkMemory;
+    // GBK data is only needed until converted, so the buffer is reused by following reads in the same thread
+    static thread_local std::vector<char> gbkMemory;
     char* gbkBuffer = nullptr;
     size_t readCharCount = 0, originReadCount = 0;
     int64_t lastReadPos = 0;
@@ -1719,8 +1722,10 @@ void LogFileReader::ReadGBK(LogBuffer& logBuffer, int64_t end, bool& moreData, b
     if (!mLogFileOp.IsOpen()) {
         // read flush timeout
         readCharCount = mCache.size();
-        gbkMemory.reset(new char[readCharCount + 1]);
-        gbkBuffer = gbkMemory.get();
+        if (gbkMemory.size() < readCharCount + 1) {
+            gbkMemory.resize(readCharCount + 1);
+        }
+        gbkBuffer = gbkMemory.data();
         memcpy(gbkBuffer, mCache.data(), readCharCount);
         // Ignore \n if last is force read
         if (gbkBuffer[0] == '\n' && mLastForceRead) {
@@ -1740,8 +1745,10 @@ void LogFileReader::ReadGBK(LogBuffer& logBuffer, int64_t end, bool& moreData, b
         if (READ_BYTE < lastCacheSize) {
             READ_BYTE = lastCacheSize; // this should not happen, just avoid READ_BYTE >= 0 theoratically
         }
-        gbkMemory.reset(new char[READ_BYTE + 1]);
-        gbkBuffer = gbkMemory.get();
+        if (gbkMemory.size() < READ_BYTE + 1) {
+            gbkMemory.resize(READ_BYTE + 1);
+        }
+        gbkBuffer = gbkMemory.data();
         if (lastCacheSize) {
             READ_BYTE -= lastCacheSize; // reserve space to copy from cache if needed
         }
@@ -1794,19 +1801,14 @@ void LogFileReader::ReadGBK(LogBuffer& logBuffer, int64_t end, bool& moreData, b
     }
     gbkBuffer[readCharCount] = '\0';
 
-    vector<long> lineFeedPos = {-1}; // elements point to the last char of each line
-    for (long idx = 0; idx < long(readCharCount - 1); ++idx) {
-        if (gbkBuffer[idx] == '\n')
-            lineFeedPos.push_back(idx);
-    }
-    lineFeedPos.push_back(readCharCount - 1);
-
+    // line positions are ignored by the converter
+    static const vector<long> sLineFeedPos;
     size_t srcLength = readCharCount;
     size_t requiredLen
-        = EncodingConverter::GetInstance()->ConvertGbk2Utf8(gbkBuffer, &srcLength, nullptr, 0, lineFeedPos);
+        = EncodingConverter::GetInstance()->ConvertGbk2Utf8(gbkBuffer, &srcLength, nullptr, 0, sLineFeedPos);
     StringBuffer stringMemory = logBuffer.sourcebuffer->AllocateStringBuffer(requiredLen + 1);
     size_t resultCharCount = EncodingConverter::GetInstance()->ConvertGbk2Utf8(
-        gbkBuffer, &srcLength, stringMemory.data, stringMemory.capacity, lineFeedPos);
+        gbkBuffer, &srcLength, stringMemory.data, stringMemory.capacity, sLineFeedPos);
     char* stringBuffer = stringMemory.data; // utf8 buffer
     if (resultCharCount == 0) {
         if (readCharCount < originReadCount) {
@@ -1841,9 +1843,20 @@ void LogFileReader::ReadGBK(LogBuffer& logBuffer, int64_t end, bool& moreData, b
         }
     }
 
-    int32_t lineFeedCount = lineFeedPos.size();
-    if (rollbackLineFeedCount > 0 && lineFeedCount >= (1 + rollbackLineFeedCount)) {
-        readCharCount -= lineFeedPos[lineFeedCount - 1] - lineFeedPos[lineFeedCount - 1 - rollbackLineFeedCount];
+    if (rollbackLineFeedCount > 0) {
+        // find the rolled back lines in the GBK buffer by counting line feeds backwards, the last char is excluded
+        // since it ends the last line, and the buffer start counts as a line feed
+        long pos = long(readCharCount) - 1;
+        int32_t found = 0;
+        while (found < rollbackLineFeedCount && pos >= 0) {
+            do {
+                --pos;
+            } while (pos >= 0 && gbkBuffer[pos] != '\n');
+            ++found;
+        }
+        if (found == rollbackLineFeedCount) {
+            readCharCount = pos + 1;
+        }
     }
     if (readCharCount < originReadCount) {
         // rollback happend, put rollbacked part in cache
@@ -2015,20 +2028,16 @@ LogFileReader::RemoveLastIncompleteLog(char* buffer, int32_t size, int32_t& roll
             LineInfo content = GetLastLine(StringView(buffer, size), endPs, false);
             if (mMultilineConfig.first->GetEndPatternReg()) {
                 // start + end, continue + end, end
-                if (BoostRegexSearch(content.data.data(),
-                                     content.data.size(),
-                                     *mMultilineConfig.first->GetEndPatternReg(),
-                                     exception)) {
+                if (mMultilineConfig.first->GetEndPatternReg()->Match(
+                        content.data.data(), content.data.size(), exception)) {
                     // Ensure the end line is complete
                     if (buffer[content.lineEnd] == '\n') {
                         return content.lineEnd + 1;
                     }
                 }
             } else if (mMultilineConfig.first->GetStartPatternReg()
-                       && BoostRegexSearch(content.data.data(),
-                                           content.data.size(),
-                                           *mMultilineConfig.first->GetStartPatternReg(),
-                                           exception)) {
+                       && mMultilineConfig.first->GetStartPatternReg()->Match(
+                           content.data.data(), content.data.size(), exception)) {
                 // start + continue, start
                 rollbackLineFeedCount += content.rollbackLineFeedCount;
                 // Keep all the buffer if rollback all
@@ -2481,6 +2490,7 @@ PipelineEventGroup LogFileReader::GenerateEventGroup(LogFileReaderPtr reader, Lo
     event->SetTimestamp(logtime);
     event->SetContentNoCopy(DEFAULT_CONTENT_KEY, logBuffer->rawBuffer);
     event->SetPosition(logBuffer->readOffset, logBuffer->readLength);
+    group.SetLatencyTrace(logBuffer->latencyTrace);
 
     return group;
 }
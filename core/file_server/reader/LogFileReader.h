@@ -37,6 +37,7 @@
 #include "file_server/MultilineOptions.h"
 #include "protobuf/sls/sls_logs.pb.h"
 #include "logger/Logger.h"
+#include "models/LatencyTrace.h"
 #include "models/StringView.h"
 #include "pipeline/queue/QueueKey.h"
 #include "rapidjson/allocators.h"
@@ -690,6 +691,7 @@ private:
     friend class LastMatchedDockerJsonFileUnittest;
     friend class LastMatchedContainerdTextWithDockerJsonUnittest;
     friend class ForceReadUnittest;
+    friend class PipelineBenchmark;
 
 protected:
     void UpdateReaderManual();
@@ -706,6 +708,8 @@ struct LogBuffer {
     // Current buffer's offset in file, for log position meta feature.
     uint64_t readOffset = 0;
     uint64_t readLength = 0;
+    // not null if sampled for latency tracing, stamped with LatencyStage::READ when the buffer is read
+    LatencyTracePtr latencyTrace;
     std::unique_ptr<SourceBuffer> sourcebuffer;
 
     LogBuffer() : sourcebuffer(new SourceBuffer()) {}
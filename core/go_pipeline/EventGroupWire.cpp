@@ -0,0 +1,241 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "go_pipeline/EventGroupWire.h"
+
+#include <cstring>
+
+#include "protobuf/models/ProtocolConversion.h"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#error "event group wire format assumes a little endian host"
+#endif
+
+using namespace std;
+
+namespace logtail {
+
+const char kEventGroupWireMagic[4] = {'L', 'E', 'G', '1'};
+
+namespace {
+
+// only counts bytes, used to compute the exact size of the output before writing
+class SizeSink {
+public:
+    void Write(const void*, size_t size) { mSize += size; }
+    size_t GetSize() const { return mSize; }
+
+private:
+    size_t mSize = 0;
+};
+
+class BufferSink {
+public:
+    explicit BufferSink(char* buf) : mCur(buf) {}
+    void Write(const void* data, size_t size) {
+        if (size > 0) {
+            memcpy(mCur, data, size);
+            mCur += size;
+        }
+    }
+
+private:
+    char* mCur;
+};
+
+template <typename Sink>
+class WireWriter {
+public:
+    explicit WireWriter(Sink& sink) : mSink(sink) {}
+
+    template <typename T>
+    void Fixed(T val) {
+        mSink.Write(&val, sizeof(T));
+    }
+
+    void Str(StringView s) {
+        Fixed(static_cast<uint32_t>(s.size()));
+        mSink.Write(s.data(), s.size());
+    }
+
+    void Str(const char* s) { Str(StringView(s, strlen(s))); }
+
+    template <typename It>
+    void KVs(It begin, It end, size_t size) {
+        Fixed(static_cast<uint32_t>(size));
+        for (auto it = begin; it != end; ++it) {
+            Str(it->first);
+            Str(it->second);
+        }
+    }
+
+    void Timestamp(const PipelineEvent& e, bool enableNanosecond) {
+        Fixed(static_cast<int64_t>(e.GetTimestamp()));
+        bool hasNs = enableNanosecond && e.GetTimestampNanosecond().has_value();
+        Fixed(static_cast<uint32_t>(hasNs ? e.GetTimestampNanosecond().value() : 0));
+        Fixed(static_cast<uint8_t>(hasNs ? 1 : 0));
+    }
+
+    void Log(const LogEvent& e, bool enableNanosecond) {
+        Timestamp(e, enableNanosecond);
+        Str(e.GetLevel());
+        Fixed(static_cast<uint64_t>(e.GetPosition().first));
+        Fixed(static_cast<uint64_t>(e.GetPosition().second));
+        KVs(e.begin(), e.end(), e.Size());
+    }
+
+    void Metric(const MetricEvent& e, bool enableNanosecond) {
+        Timestamp(e, enableNanosecond);
+        Str(e.GetName());
+        KVs(e.TagsBegin(), e.TagsEnd(), e.TagsSize());
+        if (const auto* v = e.GetValue<UntypedSingleValue>()) {
+            Fixed(EventGroupWireValueType::SINGLE);
+            Fixed(v->mValue);
+        } else if (const auto* v = e.GetValue<UntypedMultiDoubleValues>()) {
+            Fixed(EventGroupWireValueType::MULTI);
+            Fixed(static_cast<uint32_t>(v->mValues.size()));
+            for (const auto& item : v->mValues) {
+                Str(item.first);
+                Fixed(item.second);
+            }
+        } else if (const auto* v = e.GetValue<HistogramValue>()) {
+            Fixed(EventGroupWireValueType::HISTOGRAM);
+            Fixed(v->mSum);
+            Fixed(v->mCount);
+            Fixed(static_cast<uint32_t>(v->mBuckets.size()));
+            for (const auto& bucket : v->mBuckets) {
+                Fixed(bucket.mUpperBound);
+                Fixed(bucket.mCount);
+            }
+        } else if (const auto* v = e.GetValue<SummaryValue>()) {
+            Fixed(EventGroupWireValueType::SUMMARY);
+            Fixed(v->mSum);
+            Fixed(v->mCount);
+            Fixed(static_cast<uint32_t>(v->mQuantiles.size()));
+            for (const auto& quantile : v->mQuantiles) {
+                Fixed(quantile.mQuantile);
+                Fixed(quantile.mValue);
+            }
+        } else {
+            Fixed(EventGroupWireValueType::NONE);
+        }
+    }
+
+    void Span(const SpanEvent& e, bool enableNanosecond) {
+        Timestamp(e, enableNanosecond);
+        Str(e.GetTraceId());
+        Str(e.GetSpanId());
+        Str(e.GetTraceState());
+        Str(e.GetParentSpanId());
+        Str(e.GetName());
+        Fixed(static_cast<uint8_t>(e.GetKind()));
+        Fixed(static_cast<uint64_t>(e.GetStartTimeNs()));
+        Fixed(static_cast<uint64_t>(e.GetEndTimeNs()));
+        Fixed(static_cast<uint8_t>(e.GetStatus()));
+        KVs(e.TagsBegin(), e.TagsEnd(), e.TagsSize());
+        KVs(e.ScopeTagsBegin(), e.ScopeTagsEnd(), e.ScopeTagsSize());
+        Fixed(static_cast<uint32_t>(e.GetEvents().size()));
+        for (const auto& inner : e.GetEvents()) {
+            Fixed(static_cast<uint64_t>(inner.GetTimestampNs()));
+            Str(inner.GetName());
+            KVs(inner.TagsBegin(), inner.TagsEnd(), inner.TagsSize());
+        }
+        Fixed(static_cast<uint32_t>(e.GetLinks().size()));
+        for (const auto& link : e.GetLinks()) {
+            Str(link.GetTraceId());
+            Str(link.GetSpanId());
+            Str(link.GetTraceState());
+            KVs(link.TagsBegin(), link.TagsEnd(), link.TagsSize());
+        }
+    }
+
+    void Group(const PipelineEventGroup& group, PipelineEvent::Type type, bool enableNanosecond) {
+        mSink.Write(kEventGroupWireMagic, sizeof(kEventGroupWireMagic));
+        Fixed(static_cast<uint8_t>(type));
+
+        uint32_t metaCnt = 0;
+        for (const auto& item : group.GetAllMetadata()) {
+            if (GetEventGroupMetaKeyName(item.first) != nullptr) {
+                ++metaCnt;
+            }
+        }
+        Fixed(metaCnt);
+        for (const auto& item : group.GetAllMetadata()) {
+            const char* name = GetEventGroupMetaKeyName(item.first);
+            if (name != nullptr) {
+                Str(name);
+                Str(item.second);
+            }
+        }
+        KVs(group.GetTags().begin(), group.GetTags().end(), group.GetTags().size());
+
+        Fixed(static_cast<uint32_t>(group.GetEvents().size()));
+        for (const auto& e : group.GetEvents()) {
+            switch (type) {
+                case PipelineEvent::Type::LOG:
+                    Log(e.Cast<LogEvent>(), enableNanosecond);
+                    break;
+                case PipelineEvent::Type::METRIC:
+                    Metric(e.Cast<MetricEvent>(), enableNanosecond);
+                    break;
+                case PipelineEvent::Type::SPAN:
+                    Span(e.Cast<SpanEvent>(), enableNanosecond);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+private:
+    Sink& mSink;
+};
+
+} // namespace
+
+bool SerializeEventGroupWire(const PipelineEventGroup& group,
+                             bool enableNanosecond,
+                             string& res,
+                             string& errorMsg) {
+    const auto& events = group.GetEvents();
+    if (events.empty()) {
+        errorMsg = "empty event group";
+        return false;
+    }
+    PipelineEvent::Type type = events[0]->GetType();
+    if (type != PipelineEvent::Type::LOG && type != PipelineEvent::Type::METRIC
+        && type != PipelineEvent::Type::SPAN) {
+        errorMsg = "unsupported event type in event group";
+        return false;
+    }
+    for (const auto& e : events) {
+        if (e->GetType() != type) {
+            errorMsg = "mixed event types in event group";
+            return false;
+        }
+    }
+
+    SizeSink sizeSink;
+    WireWriter<SizeSink>(sizeSink).Group(group, type, enableNanosecond);
+    if (sizeSink.GetSize() > UINT32_MAX) {
+        errorMsg = "event group is too large";
+        return false;
+    }
+    res.resize(sizeSink.GetSize());
+    BufferSink bufferSink(&res[0]);
+    WireWriter<BufferSink>(bufferSink).Group(group, type, enableNanosecond);
+    return true;
+}
+
+} // namespace logtail
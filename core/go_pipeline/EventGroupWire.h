@@ -0,0 +1,51 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "models/PipelineEventGroup.h"
+
+namespace logtail {
+
+// Flat event group layout passed to the Go pipeline by ProcessEventGroup, decoded by
+// pluginmanager/event_group_wire.go. All integers are little endian, doubles are IEEE 754.
+//   group   := magic u8(event type) u32(n) (str str)*n (metadata) u32(n) (str str)*n (tags) u32(n) event*n
+//   magic   := "LEG1"
+//   str     := u32(size) bytes
+//   ts      := i64(seconds) u32(nanoseconds) u8(1 if nanoseconds is set else 0)
+//   log     := ts str(level) u64(offset) u64(raw size) u32(n) (str str)*n
+//   metric  := ts str(name) u32(n) (str str)*n u8(value type) value
+//   value   := <none> | f64 | u32(n) (str f64)*n | f64(sum) f64(count) u32(n) (f64 f64)*n
+//   span    := ts str(trace id) str(span id) str(trace state) str(parent span id) str(name) u8(kind) u64(start ns)
+//              u64(end ns) u8(status) u32(n) (str str)*n (tags) u32(n) (str str)*n (scope tags)
+//              u32(n) (u64(ts ns) str(name) u32(n) (str str)*n)*n (inner events)
+//              u32(n) (str(trace id) str(span id) str(trace state) u32(n) (str str)*n)*n (links)
+// Histogram buckets are (upper bound, cumulative count), summary quantiles are (quantile, value).
+extern const char kEventGroupWireMagic[4];
+
+enum class EventGroupWireValueType : uint8_t { NONE, SINGLE, MULTI, HISTOGRAM, SUMMARY };
+
+// The exact size is computed first so that every string view is copied exactly once into res. Raw events are not
+// supported. Nanoseconds are dropped unless enableNanosecond is set, the same as the sls_logs::LogGroup path.
+bool SerializeEventGroupWire(const PipelineEventGroup& group,
+                             bool enableNanosecond,
+                             std::string& res,
+                             std::string& errorMsg);
+
+} // namespace logtail
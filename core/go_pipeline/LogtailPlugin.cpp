@@ -435,6 +435,13 @@ bool LogtailPlugin::LoadPluginBase() {
             LOG_ERROR(sLogger, ("load ProcessLogGroup error, Message", error));
             return mPluginValid;
         }
+        // C++传递任意类型的事件组到golang插件，旧版本插件不支持
+        mProcessEventGroupFun = (ProcessEventGroupFun)loader.LoadMethod("ProcessEventGroup", error);
+        if (!error.empty()) {
+            LOG_WARNING(sLogger, ("load ProcessEventGroup error, Message", error)("action", "use ProcessLogGroup"));
+            mProcessEventGroupFun = NULL;
+            error.clear();
+        }
         // 获取golang部分指标信息
         mGetGoMetricsFun = (GetGoMetricsFun)loader.LoadMethod("GetGoMetrics", error);
         if (!error.empty()) {
@@ -523,6 +530,29 @@ void LogtailPlugin::ProcessLogGroup(const std::string& configName,
     }
 }
 
+void LogtailPlugin::ProcessEventGroup(const std::string& configName,
+                                      const std::string& eventGroup,
+                                      const std::string& packId) {
+    if (eventGroup.empty() || !(mPluginValid && mProcessEventGroupFun != NULL)) {
+        return;
+    }
+    std::string realConfigName = configName + "/2";
+    std::string packIdPrefix = ToHexString(HashString(packId));
+    GoString goConfigName;
+    GoSlice goEventGroup;
+    GoString goPackId;
+    goConfigName.n = realConfigName.size();
+    goConfigName.p = realConfigName.c_str();
+    goPackId.n = packIdPrefix.size();
+    goPackId.p = packIdPrefix.c_str();
+    goEventGroup.len = goEventGroup.cap = eventGroup.length();
+    goEventGroup.data = (void*)eventGroup.c_str();
+    GoInt rst = mProcessEventGroupFun(goConfigName, goEventGroup, goPackId);
+    if (rst != (GoInt)0) {
+        LOG_WARNING(sLogger, ("process event group error", configName)("result", rst));
+    }
+}
+
 void LogtailPlugin::GetGoMetrics(std::vector<std::map<std::string, std::string>>& metircsList,
                                  const string& metricType) {
     if (mGetGoMetricsFun != nullptr) {
@@ -142,6 +142,7 @@ typedef GoInt (*InitPluginBaseFun)();
 typedef GoInt (*InitPluginBaseV2Fun)(GoString cfg);
 typedef GoInt (*ProcessLogsFun)(GoString c, GoSlice l, GoString p, GoString t, GoSlice tags);
 typedef GoInt (*ProcessLogGroupFun)(GoString c, GoSlice l, GoString p);
+typedef GoInt (*ProcessEventGroupFun)(GoString c, GoSlice g, GoString p);
 typedef struct innerContainerMeta* (*GetContainerMetaFun)(GoString containerID);
 typedef InnerPluginMetrics* (*GetGoMetricsFun)(GoString metricType);
 
@@ -229,6 +230,11 @@ public:
 
     void ProcessLogGroup(const std::string& configName, const std::string& logGroup, const std::string& packId);
 
+    // eventGroup is serialized by SerializeEventGroupWire
+    void ProcessEventGroup(const std::string& configName, const std::string& eventGroup, const std::string& packId);
+    // older plugin libraries only accept sls_logs::LogGroup via ProcessLogGroup
+    bool IsEventGroupSupported() const { return mProcessEventGroupFun != NULL; }
+
     static int IsValidToSend(long long logstoreKey);
 
     static int SendPb(const char* configName,
@@ -274,6 +280,7 @@ private:
     logtail::FlusherSLS mPluginContainerConfig;
     ProcessLogsFun mProcessLogsFun;
     ProcessLogGroupFun mProcessLogGroupFun;
+    ProcessEventGroupFun mProcessEventGroupFun = NULL;
     GetContainerMetaFun mGetContainerMetaFun;
     GetGoMetricsFun mGetGoMetricsFun;
 
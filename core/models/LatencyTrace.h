@@ -0,0 +1,61 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace logtail {
+
+// in the order data passes through them
+enum class LatencyStage : uint8_t {
+    READ, // data read by the input, e.g. when a file reader returns the buffer
+    PROCESS_QUEUE_PUSH,
+    PROCESS_QUEUE_POP,
+    PROCESS, // all processors finished
+    BATCH_FLUSH,
+    SERIALIZE,
+    COMPRESS,
+    SENDER_QUEUE_PUSH,
+    SENDER_QUEUE_POP,
+    SEND, // request handed to the http client
+    ACK, // successful response received
+    COUNT
+};
+
+// Timestamps at which a sampled event group, and the batch and sender queue item it ends up in, leave each stage.
+// Stages that are passed more than once, e.g. send on retry, keep the last time.
+class LatencyTrace {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void Stamp(LatencyStage stage) { mTimes[static_cast<size_t>(stage)] = Clock::now(); }
+    void Stamp(LatencyStage stage, Clock::time_point t) { mTimes[static_cast<size_t>(stage)] = t; }
+    bool HasStamp(LatencyStage stage) const {
+        return mTimes[static_cast<size_t>(stage)] != Clock::time_point();
+    }
+    Clock::time_point GetStamp(LatencyStage stage) const { return mTimes[static_cast<size_t>(stage)]; }
+
+private:
+    std::array<Clock::time_point, static_cast<size_t>(LatencyStage::COUNT)> mTimes{};
+};
+
+using LatencyTracePtr = std::shared_ptr<LatencyTrace>;
+
+} // namespace logtail
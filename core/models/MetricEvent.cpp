@@ -43,6 +43,18 @@ void MetricEvent::SetNameNoCopy(StringView name) {
     mName = name;
 }
 
+void MetricEvent::SetMultiDoubleValue(StringView key, double val) {
+    const StringBuffer& b = GetSourceBuffer()->CopyString(key);
+    SetMultiDoubleValueNoCopy(StringView(b.data, b.size), val);
+}
+
+void MetricEvent::SetMultiDoubleValueNoCopy(StringView key, double val) {
+    if (!Is<UntypedMultiDoubleValues>()) {
+        mValue = UntypedMultiDoubleValues();
+    }
+    get<UntypedMultiDoubleValues>(mValue).SetValueNoCopy(key, val);
+}
+
 StringView MetricEvent::GetTag(StringView key) const {
     auto it = mTags.mInner.find(key);
     if (it != mTags.mInner.end()) {
@@ -107,6 +119,12 @@ bool MetricEvent::FromJson(const Json::Value& root) {
     SetName(root["name"].asString());
     const Json::Value& value = root["value"];
     SetValue(JsonToMetricValue(value["type"].asString(), value["detail"]));
+    if (Is<UntypedMultiDoubleValues>()) {
+        const Json::Value& detail = value["detail"];
+        for (const auto& key : detail.getMemberNames()) {
+            SetMultiDoubleValue(key, detail[key].asDouble());
+        }
+    }
     if (root.isMember("tags")) {
         Json::Value tags = root["tags"];
         for (const auto& key : tags.getMemberNames()) {
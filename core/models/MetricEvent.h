@@ -43,6 +43,8 @@ public:
         return std::holds_alternative<T>(mValue);
     }
 
+    const MetricValue& GetMetricValue() const { return mValue; }
+
     template <typename T>
     constexpr std::add_pointer_t<const T> GetValue() const noexcept {
         return std::get_if<T>(&mValue);
@@ -58,6 +60,10 @@ public:
         mValue = T{std::forward<Args>(args)...};
     }
 
+    // set one value of UntypedMultiDoubleValues, the current value is replaced if it is of another type
+    void SetMultiDoubleValue(StringView key, double val);
+    void SetMultiDoubleValueNoCopy(StringView key, double val);
+
     StringView GetTag(StringView key) const;
     bool HasTag(StringView key) const;
     void SetTag(StringView key, StringView val);
@@ -16,10 +16,34 @@
 
 #include "models/MetricValue.h"
 
+#include <charconv>
+#include <cmath>
+
 using namespace std;
 
 namespace logtail {
 
+bool UntypedMultiDoubleValues::GetValue(StringView key, double& val) const {
+    auto it = mValues.find(key);
+    if (it == mValues.end()) {
+        return false;
+    }
+    val = it->second;
+    return true;
+}
+
+bool UntypedMultiDoubleValues::HasValue(StringView key) const {
+    return mValues.find(key) != mValues.end();
+}
+
+size_t UntypedMultiDoubleValues::DataSize() const {
+    size_t res = sizeof(UntypedMultiDoubleValues);
+    for (const auto& [k, v] : mValues) {
+        res += k.size() + sizeof(v);
+    }
+    return res;
+}
+
 size_t DataSize(const MetricValue& value) {
     return visit(
         [](auto&& arg) {
@@ -33,6 +57,37 @@ size_t DataSize(const MetricValue& value) {
         value);
 }
 
+size_t SeriesCount(const MetricValue& value) {
+    return visit(
+        [](auto&& arg) -> size_t {
+            using T = decay_t<decltype(arg)>;
+            if constexpr (is_same_v<T, monostate>) {
+                return 0;
+            } else if constexpr (is_same_v<T, UntypedSingleValue>) {
+                return 1;
+            } else if constexpr (is_same_v<T, UntypedMultiDoubleValues>) {
+                return arg.mValues.size();
+            } else if constexpr (is_same_v<T, HistogramValue>) {
+                return arg.mBuckets.size() + 2;
+            } else {
+                return arg.mQuantiles.size() + 2;
+            }
+        },
+        value);
+}
+
+string FormatMetricBoundary(double value) {
+    if (isinf(value)) {
+        return value > 0 ? "+Inf" : "-Inf";
+    }
+    if (isnan(value)) {
+        return "NaN";
+    }
+    char buf[32];
+    auto res = to_chars(buf, buf + sizeof(buf), value);
+    return string(buf, res.ptr);
+}
+
 #ifdef APSARA_UNIT_TEST_MAIN
 Json::Value UntypedSingleValue::ToJson() const {
     return Json::Value(mValue);
@@ -42,6 +97,62 @@ void UntypedSingleValue::FromJson(const Json::Value& value) {
     mValue = value.asFloat();
 }
 
+Json::Value UntypedMultiDoubleValues::ToJson() const {
+    Json::Value res(Json::objectValue);
+    for (const auto& [k, v] : mValues) {
+        res[k.to_string()] = v;
+    }
+    return res;
+}
+
+Json::Value HistogramValue::ToJson() const {
+    Json::Value res;
+    res["sum"] = mSum;
+    res["count"] = mCount;
+    Json::Value& buckets = res["buckets"];
+    buckets = Json::Value(Json::arrayValue);
+    for (const auto& b : mBuckets) {
+        Json::Value bucket;
+        bucket["le"] = FormatMetricBoundary(b.mUpperBound);
+        bucket["count"] = b.mCount;
+        buckets.append(bucket);
+    }
+    return res;
+}
+
+void HistogramValue::FromJson(const Json::Value& value) {
+    mSum = value["sum"].asDouble();
+    mCount = value["count"].asDouble();
+    mBuckets.clear();
+    for (const auto& bucket : value["buckets"]) {
+        mBuckets.push_back({stod(bucket["le"].asString()), bucket["count"].asDouble()});
+    }
+}
+
+Json::Value SummaryValue::ToJson() const {
+    Json::Value res;
+    res["sum"] = mSum;
+    res["count"] = mCount;
+    Json::Value& quantiles = res["quantiles"];
+    quantiles = Json::Value(Json::arrayValue);
+    for (const auto& q : mQuantiles) {
+        Json::Value quantile;
+        quantile["quantile"] = FormatMetricBoundary(q.mQuantile);
+        quantile["value"] = q.mValue;
+        quantiles.append(quantile);
+    }
+    return res;
+}
+
+void SummaryValue::FromJson(const Json::Value& value) {
+    mSum = value["sum"].asDouble();
+    mCount = value["count"].asDouble();
+    mQuantiles.clear();
+    for (const auto& quantile : value["quantiles"]) {
+        mQuantiles.push_back({stod(quantile["quantile"].asString()), quantile["value"].asDouble()});
+    }
+}
+
 Json::Value MetricValueToJson(const MetricValue& value) {
     Json::Value res;
     visit(
@@ -50,6 +161,15 @@ Json::Value MetricValueToJson(const MetricValue& value) {
             if constexpr (is_same_v<T, UntypedSingleValue>) {
                 res["type"] = "untyped_single_value";
                 res["detail"] = get<UntypedSingleValue>(value).ToJson();
+            } else if constexpr (is_same_v<T, UntypedMultiDoubleValues>) {
+                res["type"] = "untyped_multi_double_values";
+                res["detail"] = arg.ToJson();
+            } else if constexpr (is_same_v<T, HistogramValue>) {
+                res["type"] = "histogram";
+                res["detail"] = arg.ToJson();
+            } else if constexpr (is_same_v<T, SummaryValue>) {
+                res["type"] = "summary";
+                res["detail"] = arg.ToJson();
             } else if constexpr (is_same_v<T, monostate>) {
                 res["type"] = "unknown";
             }
@@ -63,6 +183,17 @@ MetricValue JsonToMetricValue(const string& type, const Json::Value& detail) {
         UntypedSingleValue v;
         v.FromJson(detail);
         return v;
+    } else if (type == "untyped_multi_double_values") {
+        // keys are not owned by the value, see MetricEvent::FromJson
+        return UntypedMultiDoubleValues();
+    } else if (type == "histogram") {
+        HistogramValue v;
+        v.FromJson(detail);
+        return v;
+    } else if (type == "summary") {
+        SummaryValue v;
+        v.FromJson(detail);
+        return v;
     } else {
         return MetricValue();
     }
@@ -16,14 +16,18 @@
 
 #pragma once
 
+#include <map>
+#include <string>
+#include <utility>
 #include <variant>
+#include <vector>
 
 #ifdef APSARA_UNIT_TEST_MAIN
 #include <json/json.h>
-
-#include <string>
 #endif
 
+#include "models/StringView.h"
+
 namespace logtail {
 
 struct UntypedSingleValue {
@@ -37,10 +41,73 @@ struct UntypedSingleValue {
 #endif
 };
 
-using MetricValue = std::variant<std::monostate, UntypedSingleValue>;
+// Several named values sharing the same name and tags, e.g. the user, system and idle time of one cpu. Keys are not
+// owned, use MetricEvent::SetMultiDoubleValue to store them in the source buffer of the event.
+struct UntypedMultiDoubleValues {
+    std::map<StringView, double> mValues;
+
+    bool GetValue(StringView key, double& val) const;
+    bool HasValue(StringView key) const;
+    void SetValueNoCopy(StringView key, double val) { mValues[key] = val; }
+    void DelValue(StringView key) { mValues.erase(key); }
+    size_t DataSize() const;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    Json::Value ToJson() const;
+#endif
+};
+
+// Prometheus style histogram, buckets are cumulative and sorted by upper bound.
+struct HistogramValue {
+    struct Bucket {
+        double mUpperBound;
+        double mCount;
+    };
+
+    double mSum = 0.0;
+    double mCount = 0.0;
+    std::vector<Bucket> mBuckets;
+
+    size_t DataSize() const { return sizeof(HistogramValue) + mBuckets.size() * sizeof(Bucket); }
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    Json::Value ToJson() const;
+    void FromJson(const Json::Value& value);
+#endif
+};
+
+// Prometheus style summary, quantiles are sorted in ascending order.
+struct SummaryValue {
+    struct Quantile {
+        double mQuantile;
+        double mValue;
+    };
+
+    double mSum = 0.0;
+    double mCount = 0.0;
+    std::vector<Quantile> mQuantiles;
+
+    size_t DataSize() const { return sizeof(SummaryValue) + mQuantiles.size() * sizeof(Quantile); }
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    Json::Value ToJson() const;
+    void FromJson(const Json::Value& value);
+#endif
+};
+
+using MetricValue
+    = std::variant<std::monostate, UntypedSingleValue, UntypedMultiDoubleValues, HistogramValue, SummaryValue>;
 
 size_t DataSize(const MetricValue& value);
 
+// number of plain series the value is flattened into when sent to backends without native support, e.g. a histogram
+// becomes one _bucket series per bucket plus _sum and _count
+size_t SeriesCount(const MetricValue& value);
+
+// shortest representation of a bucket upper bound or a quantile which reads back to the same double, infinities are
+// written as +Inf and -Inf as in the Prometheus text format
+std::string FormatMetricBoundary(double value);
+
 #ifdef APSARA_UNIT_TEST_MAIN
 Json::Value MetricValueToJson(const MetricValue& value);
 MetricValue JsonToMetricValue(const std::string& type, const Json::Value& detail);
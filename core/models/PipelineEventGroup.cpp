@@ -67,7 +67,8 @@ PipelineEventGroup::PipelineEventGroup(PipelineEventGroup&& rhs) noexcept
     : mMetadata(std::move(rhs.mMetadata)),
       mTags(std::move(rhs.mTags)),
       mEvents(std::move(rhs.mEvents)),
-      mSourceBuffer(std::move(rhs.mSourceBuffer)) {
+      mSourceBuffer(std::move(rhs.mSourceBuffer)),
+      mLatencyTrace(std::move(rhs.mLatencyTrace)) {
     for (auto& item : mEvents) {
         item->ResetPipelineEventGroup(this);
     }
@@ -101,6 +102,7 @@ PipelineEventGroup& PipelineEventGroup::operator=(PipelineEventGroup&& rhs) noex
         mTags = std::move(rhs.mTags);
         mEvents = std::move(rhs.mEvents);
         mSourceBuffer = std::move(rhs.mSourceBuffer);
+        mLatencyTrace = std::move(rhs.mLatencyTrace);
         for (auto& item : mEvents) {
             item->ResetPipelineEventGroup(this);
         }
@@ -113,6 +115,10 @@ PipelineEventGroup PipelineEventGroup::Copy() const {
     res.mMetadata = mMetadata;
     res.mTags = mTags;
     res.mExactlyOnceCheckpoint = mExactlyOnceCheckpoint;
+    if (mLatencyTrace) {
+        // each copy goes its own way from now on
+        res.mLatencyTrace = std::make_shared<LatencyTrace>(*mLatencyTrace);
+    }
     for (auto& event : mEvents) {
         res.mEvents.emplace_back(event.Copy());
         res.mEvents.back()->ResetPipelineEventGroup(&res);
@@ -22,6 +22,7 @@
 #include "checkpoint/RangeCheckpoint.h"
 #include "constants/Constants.h"
 #include "common/memory/SourceBuffer.h"
+#include "models/LatencyTrace.h"
 #include "models/PipelineEventPtr.h"
 
 namespace logtail {
@@ -121,6 +122,10 @@ public:
     RangeCheckpointPtr& GetExactlyOnceCheckpoint() { return mExactlyOnceCheckpoint; }
     bool IsReplay() const;
 
+    // only set for groups sampled for latency tracing
+    void SetLatencyTrace(const LatencyTracePtr& trace) { mLatencyTrace = trace; }
+    const LatencyTracePtr& GetLatencyTrace() const { return mLatencyTrace; }
+
     size_t DataSize() const;
 
 #ifdef APSARA_UNIT_TEST_MAIN
@@ -137,6 +142,7 @@ private:
     EventsContainer mEvents;
     std::shared_ptr<SourceBuffer> mSourceBuffer;
     RangeCheckpointPtr mExactlyOnceCheckpoint;
+    LatencyTracePtr mLatencyTrace;
 };
 
 } // namespace logtail
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "monitor/LatencyTraceRecorder.h"
+
+#include <atomic>
+
+#include "common/Flags.h"
+#include "common/StringTools.h"
+#include "monitor/metric_constants/MetricConstants.h"
+
+DEFINE_FLAG_INT32(pipeline_latency_trace_sample_interval,
+                  "trace the latency of one in every this many event groups through the pipeline, 0 to disable",
+                  0);
+DEFINE_FLAG_INT32(pipeline_latency_exemplar_window_secs, "how long the slowest traced event group is kept", 60);
+
+using namespace std;
+
+namespace logtail {
+
+static const array<const char*, static_cast<size_t>(LatencyStage::COUNT)> sStageNames = {"read",
+                                                                                        "process_queue_push",
+                                                                                        "process_queue_pop",
+                                                                                        "process",
+                                                                                        "batch_flush",
+                                                                                        "serialize",
+                                                                                        "compress",
+                                                                                        "sender_queue_push",
+                                                                                        "sender_queue_pop",
+                                                                                        "send",
+                                                                                        "ack"};
+
+LatencyTracePtr LatencyTraceRecorder::StartTrace() {
+    static atomic_uint64_t sCnt{0};
+    int32_t interval = INT32_FLAG(pipeline_latency_trace_sample_interval);
+    if (interval <= 0 || sCnt.fetch_add(1, memory_order_relaxed) % interval != 0) {
+        return nullptr;
+    }
+    auto trace = make_shared<LatencyTrace>();
+    trace->Stamp(LatencyStage::READ);
+    return trace;
+}
+
+bool LatencyTraceRecorder::IsEnabled() {
+    return INT32_FLAG(pipeline_latency_trace_sample_interval) > 0;
+}
+
+const char* LatencyTraceRecorder::GetStageName(LatencyStage stage) {
+    return sStageNames[static_cast<size_t>(stage)];
+}
+
+void LatencyTraceRecorder::Init(MetricsRecordRef& ref) {
+    for (size_t i = static_cast<size_t>(LatencyStage::READ) + 1; i < mStageLatencyUs.size(); ++i) {
+        mStageLatencyUs[i] = ref.CreateHistogram(string(sStageNames[i]) + "_latency_us");
+    }
+    mE2ELatencyUs = ref.CreateHistogram(METRIC_PIPELINE_E2E_LATENCY_US);
+}
+
+pair<string, function<string()>> LatencyTraceRecorder::GetExemplarLabel() const {
+    shared_ptr<Exemplar> exemplar = mExemplar;
+    return {METRIC_LABEL_KEY_LATENCY_EXEMPLAR, [exemplar]() {
+                lock_guard<mutex> lock(exemplar->mMux);
+                return exemplar->mTrace;
+            }};
+}
+
+void LatencyTraceRecorder::Record(const LatencyTrace& trace) {
+    if (!mE2ELatencyUs || !trace.HasStamp(LatencyStage::READ)) {
+        return;
+    }
+    string desc;
+    auto prev = trace.GetStamp(LatencyStage::READ);
+    for (size_t i = static_cast<size_t>(LatencyStage::READ) + 1; i < mStageLatencyUs.size(); ++i) {
+        auto stage = static_cast<LatencyStage>(i);
+        if (!trace.HasStamp(stage)) {
+            continue;
+        }
+        auto cur = trace.GetStamp(stage);
+        // stages may be stamped out of order on retry, e.g. send after a failed attempt
+        auto us = cur > prev ? chrono::duration_cast<chrono::microseconds>(cur - prev).count() : 0;
+        mStageLatencyUs[i]->Add(static_cast<uint64_t>(us));
+        desc += string(desc.empty() ? "" : ",") + sStageNames[i] + ":" + ToString(us);
+        prev = max(prev, cur);
+    }
+    auto total = prev - trace.GetStamp(LatencyStage::READ);
+    auto totalUs = chrono::duration_cast<chrono::microseconds>(total).count();
+    mE2ELatencyUs->Add(static_cast<uint64_t>(totalUs));
+    desc += ",e2e:" + ToString(totalUs);
+
+    auto now = chrono::steady_clock::now();
+    lock_guard<mutex> lock(mExemplar->mMux);
+    if (total > mExemplar->mTotal
+        || now - mExemplar->mWindowStart >= chrono::seconds(INT32_FLAG(pipeline_latency_exemplar_window_secs))) {
+        mExemplar->mTrace = std::move(desc);
+        mExemplar->mTotal = total;
+        mExemplar->mWindowStart = now;
+    }
+}
+
+} // namespace logtail
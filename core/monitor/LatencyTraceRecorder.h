@@ -0,0 +1,67 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "models/LatencyTrace.h"
+#include "monitor/MetricRecord.h"
+
+namespace logtail {
+
+// Aggregates finished latency traces of one pipeline into per-stage latency histograms, named
+// <stage>_latency_us and measured from the previous stage the trace passed, plus an end-to-end histogram. The slowest
+// trace of the last minute is kept as an exemplar and exported as a dynamic label of the pipeline metrics record.
+class LatencyTraceRecorder {
+public:
+    // returns a trace stamped with LatencyStage::READ for one in every pipeline_latency_trace_sample_interval calls,
+    // or nullptr
+    static LatencyTracePtr StartTrace();
+    static bool IsEnabled();
+    static const char* GetStageName(LatencyStage stage);
+
+    // should be called before the metrics record is committed, nothing is recorded if not called
+    void Init(MetricsRecordRef& ref);
+    // the dynamic label holding the exemplar, which stays valid after the recorder is destroyed
+    std::pair<std::string, std::function<std::string()>> GetExemplarLabel() const;
+    // should be called once the trace has been acked
+    void Record(const LatencyTrace& trace);
+
+private:
+    struct Exemplar {
+        mutable std::mutex mMux;
+        std::string mTrace;
+        std::chrono::steady_clock::duration mTotal{};
+        std::chrono::steady_clock::time_point mWindowStart;
+    };
+
+    std::array<HistogramPtr, static_cast<size_t>(LatencyStage::COUNT)> mStageLatencyUs;
+    HistogramPtr mE2ELatencyUs;
+    std::shared_ptr<Exemplar> mExemplar = std::make_shared<Exemplar>();
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class LatencyTraceRecorderUnittest;
+#endif
+};
+
+} // namespace logtail
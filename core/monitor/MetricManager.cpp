@@ -24,6 +24,24 @@ using namespace sls_logs;
 
 namespace logtail {
 
+namespace {
+
+// histograms are exported as their count, sum and a few quantiles, so that they fit in the flat key-value layout shared
+// with other metric types
+std::vector<std::pair<std::string, std::string>> FlattenHistogram(const Histogram& histogram) {
+    static const std::vector<std::pair<std::string, double>> sQuantiles
+        = {{"_p50", 0.5}, {"_p90", 0.9}, {"_p99", 0.99}, {"_max", 1.0}};
+    std::vector<std::pair<std::string, std::string>> res;
+    res.emplace_back(histogram.GetName() + "_count", ToString(histogram.GetCount()));
+    res.emplace_back(histogram.GetName() + "_sum", ToString(histogram.GetSum()));
+    for (const auto& item : sQuantiles) {
+        res.emplace_back(histogram.GetName() + item.first, ToString(histogram.GetQuantile(item.second)));
+    }
+    return res;
+}
+
+} // namespace
+
 WriteMetrics::~WriteMetrics() {
     Clear();
 }
@@ -236,6 +254,13 @@ void ReadMetrics::ReadAsLogGroup(const std::string& regionFieldName,
                 contentPtr->set_key(gauge->GetName());
                 contentPtr->set_value(ToString(gauge->GetValue()));
             }
+            for (auto& item : tmp->GetHistograms()) {
+                for (auto& kv : FlattenHistogram(*item)) {
+                    Log_Content* contentPtr = logPtr->add_contents();
+                    contentPtr->set_key(kv.first);
+                    contentPtr->set_value(kv.second);
+                }
+            }
         }
         tmp = tmp->GetNext();
     }
@@ -281,6 +306,11 @@ void ReadMetrics::ReadAsFileBuffer(std::string& metricsContent) const {
             DoubleGaugePtr gauge = item;
             metricsRecordJson[gauge->GetName()] = ToString(gauge->GetValue());
         }
+        for (auto& item : tmp->GetHistograms()) {
+            for (auto& kv : FlattenHistogram(*item)) {
+                metricsRecordJson[kv.first] = kv.second;
+            }
+        }
 
         Json::StreamWriterBuilder writer;
         writer["indentation"] = "";
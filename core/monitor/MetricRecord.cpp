@@ -33,8 +33,8 @@ MetricsRecord::MetricsRecord(const std::string& category, MetricLabelsPtr labels
     : mCategory(category), mLabels(labels), mDynamicLabels(dynamicLabels), mDeleted(false) {
 }
 
-CounterPtr MetricsRecord::CreateCounter(const std::string& name) {
-    CounterPtr counterPtr = std::make_shared<Counter>(name);
+CounterPtr MetricsRecord::CreateCounter(const std::string& name, bool sharded) {
+    CounterPtr counterPtr = std::make_shared<Counter>(name, 0, sharded);
     mCounters.emplace_back(counterPtr);
     return counterPtr;
 }
@@ -57,6 +57,12 @@ DoubleGaugePtr MetricsRecord::CreateDoubleGauge(const std::string& name) {
     return gaugePtr;
 }
 
+HistogramPtr MetricsRecord::CreateHistogram(const std::string& name) {
+    HistogramPtr histogramPtr = std::make_shared<Histogram>(name);
+    mHistograms.emplace_back(histogramPtr);
+    return histogramPtr;
+}
+
 void MetricsRecord::MarkDeleted() {
     mDeleted = true;
 }
@@ -93,6 +99,10 @@ const std::vector<DoubleGaugePtr>& MetricsRecord::GetDoubleGauges() const {
     return mDoubleGauges;
 }
 
+const std::vector<HistogramPtr>& MetricsRecord::GetHistograms() const {
+    return mHistograms;
+}
+
 MetricsRecord* MetricsRecord::Collect() {
     MetricsRecord* metrics = new MetricsRecord(mCategory, mLabels, mDynamicLabels);
     for (auto& item : mCounters) {
@@ -111,6 +121,10 @@ MetricsRecord* MetricsRecord::Collect() {
         DoubleGaugePtr newPtr(item->Collect());
         metrics->mDoubleGauges.emplace_back(newPtr);
     }
+    for (auto& item : mHistograms) {
+        HistogramPtr newPtr(item->Collect());
+        metrics->mHistograms.emplace_back(newPtr);
+    }
     return metrics;
 }
 
@@ -144,8 +158,8 @@ const DynamicMetricLabelsPtr& MetricsRecordRef::GetDynamicLabels() const {
     return mMetrics->GetDynamicLabels();
 }
 
-CounterPtr MetricsRecordRef::CreateCounter(const std::string& name) {
-    return mMetrics->CreateCounter(name);
+CounterPtr MetricsRecordRef::CreateCounter(const std::string& name, bool sharded) {
+    return mMetrics->CreateCounter(name, sharded);
 }
 
 TimeCounterPtr MetricsRecordRef::CreateTimeCounter(const std::string& name) {
@@ -160,6 +174,10 @@ DoubleGaugePtr MetricsRecordRef::CreateDoubleGauge(const std::string& name) {
     return mMetrics->CreateDoubleGauge(name);
 }
 
+HistogramPtr MetricsRecordRef::CreateHistogram(const std::string& name) {
+    return mMetrics->CreateHistogram(name);
+}
+
 const MetricsRecord* MetricsRecordRef::operator->() const {
     return mMetrics;
 }
@@ -42,6 +42,7 @@ private:
     std::vector<TimeCounterPtr> mTimeCounters;
     std::vector<IntGaugePtr> mIntGauges;
     std::vector<DoubleGaugePtr> mDoubleGauges;
+    std::vector<HistogramPtr> mHistograms;
 
     std::atomic_bool mDeleted;
     MetricsRecord* mNext = nullptr;
@@ -58,10 +59,13 @@ public:
     const std::vector<TimeCounterPtr>& GetTimeCounters() const;
     const std::vector<IntGaugePtr>& GetIntGauges() const;
     const std::vector<DoubleGaugePtr>& GetDoubleGauges() const;
-    CounterPtr CreateCounter(const std::string& name);
+    const std::vector<HistogramPtr>& GetHistograms() const;
+    // sharded counters take more memory, see ShardedCounter
+    CounterPtr CreateCounter(const std::string& name, bool sharded = false);
     TimeCounterPtr CreateTimeCounter(const std::string& name);
     IntGaugePtr CreateIntGauge(const std::string& name);
     DoubleGaugePtr CreateDoubleGauge(const std::string& name);
+    HistogramPtr CreateHistogram(const std::string& name);
     MetricsRecord* Collect();
     void SetNext(MetricsRecord* next);
     MetricsRecord* GetNext() const;
@@ -86,10 +90,11 @@ public:
     const std::string& GetCategory() const;
     const MetricLabelsPtr& GetLabels() const;
     const DynamicMetricLabelsPtr& GetDynamicLabels() const;
-    CounterPtr CreateCounter(const std::string& name);
+    CounterPtr CreateCounter(const std::string& name, bool sharded = false);
     TimeCounterPtr CreateTimeCounter(const std::string& name);
     IntGaugePtr CreateIntGauge(const std::string& name);
     DoubleGaugePtr CreateDoubleGauge(const std::string& name);
+    HistogramPtr CreateHistogram(const std::string& name);
     const MetricsRecord* operator->() const;
     // this is not thread-safe, and should be only used before WriteMetrics::CommitMetricsRecordRef
     void AddLabels(MetricLabels&& labels);
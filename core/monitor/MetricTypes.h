@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cstdint>
@@ -33,28 +34,170 @@ enum class MetricType {
     METRIC_TYPE_TIME_COUNTER,
     METRIC_TYPE_INT_GAUGE,
     METRIC_TYPE_DOUBLE_GAUGE,
+    METRIC_TYPE_HISTOGRAM,
 };
 
+// A counter split into cache line aligned shards. Each thread always adds to the same shard, so threads updating the
+// same counter concurrently do not contend on one cache line. Reads sum up all shards and are therefore more expensive
+// than updates, which is fine since metrics are read once per collection interval. A ShardedCounter takes 512 bytes, so
+// it is only used for counters updated by all processor threads per event group.
+class ShardedCounter {
+public:
+    static constexpr size_t sShardCnt = 8;
+
+    explicit ShardedCounter(uint64_t val = 0) { mShards[0].mVal.store(val, std::memory_order_relaxed); }
+
+    void Add(uint64_t val) { mShards[GetShardIndex()].mVal.fetch_add(val, std::memory_order_relaxed); }
+    uint64_t Load() const {
+        uint64_t res = 0;
+        for (const auto& shard : mShards) {
+            res += shard.mVal.load(std::memory_order_relaxed);
+        }
+        return res;
+    }
+    // reset all shards to 0 and return the sum before reset
+    uint64_t Exchange() {
+        uint64_t res = 0;
+        for (auto& shard : mShards) {
+            res += shard.mVal.exchange(0, std::memory_order_relaxed);
+        }
+        return res;
+    }
+
+private:
+    struct alignas(64) Shard {
+        std::atomic_uint64_t mVal{0};
+    };
+
+    static size_t GetShardIndex() {
+        static std::atomic_size_t sNextIndex{0};
+        thread_local size_t sIndex = sNextIndex.fetch_add(1, std::memory_order_relaxed) % sShardCnt;
+        return sIndex;
+    }
+
+    std::array<Shard, sShardCnt> mShards;
+};
+
+// sharded == true means spreading updates over a ShardedCounter, see ShardedCounter for when to use it
 class Counter {
 protected:
     std::string mName;
     std::atomic_uint64_t mVal;
+    std::unique_ptr<ShardedCounter> mShards;
+
+    uint64_t Exchange() { return mShards ? mShards->Exchange() : mVal.exchange(0); }
 
 public:
-    Counter(const std::string& name, uint64_t val = 0) : mName(name), mVal(val) {}
-    uint64_t GetValue() const { return mVal.load(); }
+    Counter(const std::string& name, uint64_t val = 0, bool sharded = false)
+        : mName(name), mVal(sharded ? 0 : val), mShards(sharded ? std::make_unique<ShardedCounter>(val) : nullptr) {}
+    uint64_t GetValue() const { return mShards ? mShards->Load() : mVal.load(); }
     const std::string& GetName() const { return mName; }
-    void Add(uint64_t val) { mVal.fetch_add(val); }
-    Counter* Collect() { return new Counter(mName, mVal.exchange(0)); }
+    bool IsSharded() const { return mShards != nullptr; }
+    void Add(uint64_t val) {
+        if (mShards) {
+            mShards->Add(val);
+        } else {
+            mVal.fetch_add(val);
+        }
+    }
+    Counter* Collect() { return new Counter(mName, Exchange()); }
 };
 
 // input: nanosecond, output: milisecond
 class TimeCounter : public Counter {
 public:
     TimeCounter(const std::string& name, uint64_t val = 0) : Counter(name, val) {}
-    uint64_t GetValue() const { return mVal.load()/1000000; }
-    void Add(std::chrono::nanoseconds val) { mVal.fetch_add(val.count()); }
-    TimeCounter* Collect() { return new TimeCounter(mName, mVal.exchange(0)); }
+    uint64_t GetValue() const { return Counter::GetValue() / 1000000; }
+    void Add(std::chrono::nanoseconds val) { Counter::Add(val.count()); }
+    TimeCounter* Collect() { return new TimeCounter(mName, Exchange()); }
+};
+
+// Distribution of non-negative integer samples, e.g. latencies in milliseconds, over log-linear buckets: values below 4
+// have a bucket of their own, and every power of 2 range above is split into 4 equal-width buckets, so the relative
+// error of a bucket bound is at most 25% while 64-bit values need only 252 buckets. Add is a few arithmetic
+// instructions plus two relaxed atomic adds.
+//
+// Collect resets the histogram. Since buckets are reset one by one, a sample added concurrently may be counted in the
+// next collection instead, but never lost.
+class Histogram {
+public:
+    static constexpr uint32_t sSubBucketBits = 2;
+    static constexpr uint32_t sSubBucketCnt = 1U << sSubBucketBits;
+    static constexpr uint32_t sBucketCnt = (64 - sSubBucketBits + 1) * sSubBucketCnt;
+
+    explicit Histogram(const std::string& name) : mName(name) {}
+
+    const std::string& GetName() const { return mName; }
+    void Add(uint64_t val) {
+        mBuckets[GetBucketIndex(val)].fetch_add(1, std::memory_order_relaxed);
+        mSum.fetch_add(val, std::memory_order_relaxed);
+    }
+    // input: nanosecond, recorded as microsecond, so latency histograms should be named with suffix _us
+    void Add(std::chrono::nanoseconds val) {
+        Add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(val).count()));
+    }
+    Histogram* Collect() {
+        auto* res = new Histogram(mName);
+        for (uint32_t i = 0; i < sBucketCnt; ++i) {
+            res->mBuckets[i].store(mBuckets[i].exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        res->mSum.store(mSum.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+        return res;
+    }
+
+    uint64_t GetCount() const {
+        uint64_t res = 0;
+        for (const auto& bucket : mBuckets) {
+            res += bucket.load(std::memory_order_relaxed);
+        }
+        return res;
+    }
+    uint64_t GetSum() const { return mSum.load(std::memory_order_relaxed); }
+    uint64_t GetBucketCount(uint32_t idx) const { return mBuckets[idx].load(std::memory_order_relaxed); }
+    // the upper bound (inclusive) of the value at quantile q (0 <= q <= 1), or 0 if the histogram is empty
+    uint64_t GetQuantile(double q) const {
+        uint64_t cnt = GetCount();
+        if (cnt == 0) {
+            return 0;
+        }
+        uint64_t rank = q <= 0 ? 1 : static_cast<uint64_t>(q * cnt + 0.999999);
+        if (rank > cnt) {
+            rank = cnt;
+        }
+        uint64_t acc = 0;
+        for (uint32_t i = 0; i < sBucketCnt; ++i) {
+            acc += mBuckets[i].load(std::memory_order_relaxed);
+            if (acc >= rank) {
+                return GetBucketUpperBound(i);
+            }
+        }
+        return GetBucketUpperBound(sBucketCnt - 1);
+    }
+
+    static uint32_t GetBucketIndex(uint64_t val) {
+        if (val < sSubBucketCnt) {
+            return static_cast<uint32_t>(val);
+        }
+        uint32_t msb = 63 - static_cast<uint32_t>(__builtin_clzll(val));
+        uint32_t sub = static_cast<uint32_t>(val >> (msb - sSubBucketBits)) & (sSubBucketCnt - 1);
+        return (msb - sSubBucketBits + 1) * sSubBucketCnt + sub;
+    }
+    static uint64_t GetBucketUpperBound(uint32_t idx) {
+        if (idx < sSubBucketCnt) {
+            return idx;
+        }
+        uint32_t shift = idx / sSubBucketCnt - 1;
+        uint64_t sub = idx % sSubBucketCnt;
+        if (shift + sSubBucketBits == 63 && sub == sSubBucketCnt - 1) {
+            return UINT64_MAX;
+        }
+        return ((sSubBucketCnt + sub + 1) << shift) - 1;
+    }
+
+private:
+    std::string mName;
+    std::array<std::atomic_uint64_t, sBucketCnt> mBuckets{};
+    std::atomic_uint64_t mSum{0};
 };
 
 template <typename T>
@@ -73,6 +216,7 @@ protected:
     std::atomic<T> mVal;
 };
 
+// Gauges stay on a single atomic: Set must overwrite the value as a whole, which sharding cannot provide cheaply.
 class IntGauge : public Gauge<uint64_t> {
 public:
     IntGauge(const std::string& name, uint64_t val = 0) : Gauge<uint64_t>(name, val) {}
@@ -87,6 +231,7 @@ using CounterPtr = std::shared_ptr<Counter>;
 using TimeCounterPtr = std::shared_ptr<TimeCounter>;
 using IntGaugePtr = std::shared_ptr<IntGauge>;
 using DoubleGaugePtr = std::shared_ptr<Gauge<double>>;
+using HistogramPtr = std::shared_ptr<Histogram>;
 
 using MetricLabels = std::vector<std::pair<std::string, std::string>>;
 using MetricLabelsPtr = std::shared_ptr<MetricLabels>;
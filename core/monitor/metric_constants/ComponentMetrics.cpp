@@ -51,6 +51,7 @@ const string& METRIC_COMPONENT_OUT_ITEMS_TOTAL = METRIC_OUT_ITEMS_TOTAL;
 const string& METRIC_COMPONENT_OUT_SIZE_BYTES = METRIC_OUT_SIZE_BYTES;
 const string& METRIC_COMPONENT_TOTAL_DELAY_MS = METRIC_TOTAL_DELAY_MS;
 const string& METRIC_COMPONENT_TOTAL_PROCESS_TIME_MS = METRIC_TOTAL_PROCESS_TIME_MS;
+const string& METRIC_COMPONENT_PROCESS_LATENCY_US = METRIC_PROCESS_LATENCY_US;
 const string& METRIC_COMPONENT_DISCARDED_ITEMS_TOTAL = METRIC_DISCARDED_ITEMS_TOTAL;
 const string& METRIC_COMPONENT_DISCARDED_SIZE_BYTES = METRIC_DISCARDED_SIZE_BYTES;
 
@@ -72,13 +73,19 @@ const string METRIC_COMPONENT_QUEUE_VALID_TO_PUSH_FLAG = "valid_to_push_status";
 const string METRIC_COMPONENT_QUEUE_EXTRA_BUFFER_SIZE = "extra_buffer_size";
 const string METRIC_COMPONENT_QUEUE_EXTRA_BUFFER_SIZE_BYTES = "extra_buffer_size_bytes";
 const string& METRIC_COMPONENT_QUEUE_DISCARDED_EVENTS_TOTAL = METRIC_DISCARDED_EVENTS_TOTAL;
+const string METRIC_COMPONENT_QUEUE_SPILLED_ITEMS_TOTAL = "spilled_items_total";
+const string METRIC_COMPONENT_QUEUE_SPILL_DISCARDED_ITEMS_TOTAL = "spill_discarded_items_total";
+const string METRIC_COMPONENT_QUEUE_SPILL_SIZE_BYTES = "spill_size_bytes";
 
 const string METRIC_COMPONENT_QUEUE_FETCHED_ITEMS_TOTAL = "fetched_items_total";
 const string METRIC_COMPONENT_QUEUE_FETCH_TIMES_TOTAL = "fetch_times_total";
 const string METRIC_COMPONENT_QUEUE_VALID_FETCH_TIMES_TOTAL = "valid_fetch_times_total";
+const string METRIC_COMPONENT_QUEUE_TOTAL_FETCH_WAIT_MS = "total_fetch_wait_ms";
 const string METRIC_COMPONENT_QUEUE_FETCH_REJECTED_BY_REGION_LIMITER_TIMES_TOTAL = "region_reject_times_total";
 const string METRIC_COMPONENT_QUEUE_FETCH_REJECTED_BY_PROJECT_LIMITER_TIMES_TOTAL = "project_reject_times_total";
 const string METRIC_COMPONENT_QUEUE_FETCH_REJECTED_BY_LOGSTORE_LIMITER_TIMES_TOTAL = "logstore_reject_times_total";
 const string METRIC_COMPONENT_QUEUE_FETCH_REJECTED_BY_RATE_LIMITER_TIMES_TOTAL = "rate_reject_times_total";
+const string METRIC_COMPONENT_QUEUE_FETCH_REJECTED_BY_REGION_RATE_LIMITER_TIMES_TOTAL = "region_rate_reject_times_total";
+const string METRIC_COMPONENT_QUEUE_FETCH_REJECTED_BY_GLOBAL_RATE_LIMITER_TIMES_TOTAL = "global_rate_reject_times_total";
 
 } // namespace logtail
@@ -31,5 +31,6 @@ const string METRIC_OUT_ITEMS_TOTAL = "out_items_total";
 const string METRIC_OUT_SIZE_BYTES = "out_size_bytes";
 const string METRIC_TOTAL_DELAY_MS = "total_delay_ms";
 const string METRIC_TOTAL_PROCESS_TIME_MS = "total_process_time_ms";
+const string METRIC_PROCESS_LATENCY_US = "process_latency_us";
 
 }
\ No newline at end of file
@@ -51,6 +51,7 @@ extern const std::string METRIC_AGENT_PIPELINE_CONFIG_TOTAL;
 extern const std::string METRIC_LABEL_KEY_LOGSTORE;
 extern const std::string METRIC_LABEL_KEY_PIPELINE_NAME;
 extern const std::string METRIC_LABEL_KEY_REGION;
+extern const std::string METRIC_LABEL_KEY_LATENCY_EXEMPLAR;
 
 // metric keys
 extern const std::string METRIC_PIPELINE_PROCESSORS_IN_EVENTS_TOTAL;
@@ -62,6 +63,7 @@ extern const std::string METRIC_PIPELINE_FLUSHERS_IN_EVENT_GROUPS_TOTAL;
 extern const std::string METRIC_PIPELINE_FLUSHERS_IN_SIZE_BYTES;
 extern const std::string METRIC_PIPELINE_FLUSHERS_TOTAL_PACKAGE_TIME_MS;
 extern const std::string METRIC_PIPELINE_START_TIME;
+extern const std::string METRIC_PIPELINE_E2E_LATENCY_US;
 
 //////////////////////////////////////////////////////////////////////////
 // plugin
@@ -80,6 +82,8 @@ extern const std::string& METRIC_PLUGIN_OUT_EVENT_GROUPS_TOTAL;
 extern const std::string& METRIC_PLUGIN_OUT_SIZE_BYTES;
 extern const std::string& METRIC_PLUGIN_TOTAL_DELAY_MS;
 extern const std::string& METRIC_PLUGIN_TOTAL_PROCESS_TIME_MS;
+extern const std::string& METRIC_PLUGIN_PROCESS_LATENCY_US;
+extern const std::string METRIC_PLUGIN_TRACED_PROCESS_LATENCY_US;
 
 /**********************************************************
  *   input_file
@@ -229,6 +233,7 @@ extern const std::string& METRIC_COMPONENT_OUT_ITEMS_TOTAL;
 extern const std::string& METRIC_COMPONENT_OUT_SIZE_BYTES;
 extern const std::string& METRIC_COMPONENT_TOTAL_DELAY_MS;
 extern const std::string& METRIC_COMPONENT_TOTAL_PROCESS_TIME_MS;
+extern const std::string& METRIC_COMPONENT_PROCESS_LATENCY_US;
 extern const std::string& METRIC_COMPONENT_DISCARDED_ITEMS_TOTAL;
 extern const std::string& METRIC_COMPONENT_DISCARDED_SIZE_BYTES;
 
@@ -250,14 +255,20 @@ extern const std::string METRIC_COMPONENT_QUEUE_VALID_TO_PUSH_FLAG;
 extern const std::string METRIC_COMPONENT_QUEUE_EXTRA_BUFFER_SIZE;
 extern const std::string METRIC_COMPONENT_QUEUE_EXTRA_BUFFER_SIZE_BYTES;
 extern const std::string& METRIC_COMPONENT_QUEUE_DISCARDED_EVENTS_TOTAL;
+extern const std::string METRIC_COMPONENT_QUEUE_SPILLED_ITEMS_TOTAL;
+extern const std::string METRIC_COMPONENT_QUEUE_SPILL_DISCARDED_ITEMS_TOTAL;
+extern const std::string METRIC_COMPONENT_QUEUE_SPILL_SIZE_BYTES;
 
 extern const std::string METRIC_COMPONENT_QUEUE_FETCHED_ITEMS_TOTAL;
 extern const std::string METRIC_COMPONENT_QUEUE_FETCH_TIMES_TOTAL;
 extern const std::string METRIC_COMPONENT_QUEUE_VALID_FETCH_TIMES_TOTAL;
+extern const std::string METRIC_COMPONENT_QUEUE_TOTAL_FETCH_WAIT_MS;
 extern const std::string METRIC_COMPONENT_QUEUE_FETCH_REJECTED_BY_REGION_LIMITER_TIMES_TOTAL;
 extern const std::string METRIC_COMPONENT_QUEUE_FETCH_REJECTED_BY_PROJECT_LIMITER_TIMES_TOTAL;
 extern const std::string METRIC_COMPONENT_QUEUE_FETCH_REJECTED_BY_LOGSTORE_LIMITER_TIMES_TOTAL;
 extern const std::string METRIC_COMPONENT_QUEUE_FETCH_REJECTED_BY_RATE_LIMITER_TIMES_TOTAL;
+extern const std::string METRIC_COMPONENT_QUEUE_FETCH_REJECTED_BY_REGION_RATE_LIMITER_TIMES_TOTAL;
+extern const std::string METRIC_COMPONENT_QUEUE_FETCH_REJECTED_BY_GLOBAL_RATE_LIMITER_TIMES_TOTAL;
 
 //////////////////////////////////////////////////////////////////////////
 // runner
@@ -294,6 +305,7 @@ extern const std::string METRIC_RUNNER_SINK_OUT_SUCCESSFUL_ITEMS_TOTAL;
 extern const std::string METRIC_RUNNER_SINK_OUT_FAILED_ITEMS_TOTAL;
 extern const std::string METRIC_RUNNER_SINK_SUCCESSFUL_ITEM_TOTAL_RESPONSE_TIME_MS;
 extern const std::string METRIC_RUNNER_SINK_FAILED_ITEM_TOTAL_RESPONSE_TIME_MS;
+extern const std::string METRIC_RUNNER_SINK_RESPONSE_TIME_US;
 extern const std::string METRIC_RUNNER_SINK_SENDING_ITEMS_TOTAL;
 extern const std::string METRIC_RUNNER_SINK_SEND_CONCURRENCY;
 
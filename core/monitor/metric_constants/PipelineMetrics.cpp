@@ -22,6 +22,7 @@ namespace logtail {
 const string METRIC_LABEL_KEY_LOGSTORE = "logstore";
 const string METRIC_LABEL_KEY_PIPELINE_NAME = "pipeline_name";
 const string METRIC_LABEL_KEY_REGION = "region";
+const string METRIC_LABEL_KEY_LATENCY_EXEMPLAR = "latency_exemplar";
 
 // metric keys
 const string METRIC_PIPELINE_PROCESSORS_IN_EVENTS_TOTAL = "processor_in_events_total";
@@ -33,5 +34,6 @@ const string METRIC_PIPELINE_FLUSHERS_IN_EVENT_GROUPS_TOTAL = "flusher_in_event_
 const string METRIC_PIPELINE_FLUSHERS_IN_SIZE_BYTES = "flusher_in_size_bytes";
 const string METRIC_PIPELINE_FLUSHERS_TOTAL_PACKAGE_TIME_MS = "flusher_total_package_time_ms";
 const string METRIC_PIPELINE_START_TIME = "start_time";
+const string METRIC_PIPELINE_E2E_LATENCY_US = "e2e_latency_us";
 
 } // namespace logtail
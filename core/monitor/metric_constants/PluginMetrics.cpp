@@ -32,6 +32,8 @@ const string& METRIC_PLUGIN_OUT_EVENT_GROUPS_TOTAL = METRIC_OUT_EVENT_GROUPS_TOT
 const string& METRIC_PLUGIN_OUT_SIZE_BYTES = METRIC_OUT_SIZE_BYTES;
 const string& METRIC_PLUGIN_TOTAL_DELAY_MS = METRIC_TOTAL_DELAY_MS;
 const string& METRIC_PLUGIN_TOTAL_PROCESS_TIME_MS = METRIC_TOTAL_PROCESS_TIME_MS;
+const string& METRIC_PLUGIN_PROCESS_LATENCY_US = METRIC_PROCESS_LATENCY_US;
+const string METRIC_PLUGIN_TRACED_PROCESS_LATENCY_US = "traced_process_latency_us";
 
 /**********************************************************
  *   input_file
@@ -19,13 +19,14 @@
 #include "common/ParamExtractor.h"
 #include "pipeline/PipelineContext.h"
 #include "pipeline/queue/ProcessQueueManager.h"
+#include "pipeline/queue/SenderQueueManager.h"
 
 using namespace std;
 
 namespace logtail {
 
 const unordered_set<string> GlobalConfig::sNativeParam
-    = {"TopicType", "TopicFormat", "Priority", "EnableTimestampNanosecond", "UsingOldContentTag"};
+    = {"TopicType", "TopicFormat", "Priority", "SendWeight", "EnableTimestampNanosecond", "UsingOldContentTag"};
 
 bool GlobalConfig::Init(const Json::Value& config, const PipelineContext& ctx, Json::Value& extendedParams) {
     const string moduleName = "global";
@@ -120,6 +121,33 @@ bool GlobalConfig::Init(const Json::Value& config, const PipelineContext& ctx, J
         mPriority = priority;
     }
 
+    // SendWeight
+    uint32_t sendWeight = 0;
+    if (!GetOptionalUIntParam(config, "SendWeight", sendWeight, errorMsg)) {
+        PARAM_WARNING_DEFAULT(ctx.GetLogger(),
+                              ctx.GetAlarm(),
+                              errorMsg,
+                              mSendWeight,
+                              moduleName,
+                              ctx.GetConfigName(),
+                              ctx.GetProjectName(),
+                              ctx.GetLogstoreName(),
+                              ctx.GetRegion());
+    } else if (sendWeight > SenderQueueManager::sMaxSendWeight) {
+        PARAM_WARNING_DEFAULT(ctx.GetLogger(),
+                              ctx.GetAlarm(),
+                              "param SendWeight is out of range",
+                              SenderQueueManager::sMaxSendWeight,
+                              moduleName,
+                              ctx.GetConfigName(),
+                              ctx.GetProjectName(),
+                              ctx.GetLogstoreName(),
+                              ctx.GetRegion());
+        mSendWeight = SenderQueueManager::sMaxSendWeight;
+    } else if (sendWeight > 0) {
+        mSendWeight = sendWeight;
+    }
+
     // EnableTimestampNanosecond
     if (!GetOptionalBoolParam(config, "EnableTimestampNanosecond", mEnableTimestampNanosecond, errorMsg)) {
         PARAM_WARNING_DEFAULT(ctx.GetLogger(),
@@ -36,6 +36,7 @@ struct GlobalConfig {
     TopicType mTopicType = TopicType::NONE;
     std::string mTopicFormat;
     uint32_t mPriority = 1U;
+    uint32_t mSendWeight = 1U;
     bool mEnableTimestampNanosecond = false;
     bool mUsingOldContentTag = false;
 };
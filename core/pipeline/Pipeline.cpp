@@ -128,7 +128,7 @@ bool Pipeline::Init(PipelineConfig&& config) {
             if (!processor->Init(detail, mContext)) {
                 return false;
             }
-            mProcessorLine.emplace_back(std::move(processor));
+            mProcessorLine->emplace_back(std::move(processor));
             // for special treatment of topicformat in apsara mode
             if (i == 0 && pluginType == ProcessorParseApsaraNative::sName) {
                 mContext.SetIsFirstProcessorApsaraFlag(true);
@@ -316,20 +316,29 @@ bool Pipeline::Init(PipelineConfig&& config) {
         ProcessQueueManager::GetInstance()->SetDownStreamQueues(mContext.GetProcessQueueKey(), std::move(senderQueues));
     }
 
+    DynamicMetricLabels dynamicLabels;
+    if (LatencyTraceRecorder::IsEnabled()) {
+        dynamicLabels.emplace_back(mLatencyTraceRecorder.GetExemplarLabel());
+    }
     WriteMetrics::GetInstance()->PrepareMetricsRecordRef(
         mMetricsRecordRef,
         MetricCategory::METRIC_CATEGORY_PIPELINE,
-        {{METRIC_LABEL_KEY_PROJECT, mContext.GetProjectName()}, {METRIC_LABEL_KEY_PIPELINE_NAME, mName}});
+        {{METRIC_LABEL_KEY_PROJECT, mContext.GetProjectName()}, {METRIC_LABEL_KEY_PIPELINE_NAME, mName}},
+        std::move(dynamicLabels));
     mStartTime = mMetricsRecordRef.CreateIntGauge(METRIC_PIPELINE_START_TIME);
-    mProcessorsInEventsTotal = mMetricsRecordRef.CreateCounter(METRIC_PIPELINE_PROCESSORS_IN_EVENTS_TOTAL);
-    mProcessorsInGroupsTotal = mMetricsRecordRef.CreateCounter(METRIC_PIPELINE_PROCESSORS_IN_EVENT_GROUPS_TOTAL);
-    mProcessorsInSizeBytes = mMetricsRecordRef.CreateCounter(METRIC_PIPELINE_PROCESSORS_IN_SIZE_BYTES);
+    // updated by all processor threads for each event group
+    mProcessorsInEventsTotal = mMetricsRecordRef.CreateCounter(METRIC_PIPELINE_PROCESSORS_IN_EVENTS_TOTAL, true);
+    mProcessorsInGroupsTotal = mMetricsRecordRef.CreateCounter(METRIC_PIPELINE_PROCESSORS_IN_EVENT_GROUPS_TOTAL, true);
+    mProcessorsInSizeBytes = mMetricsRecordRef.CreateCounter(METRIC_PIPELINE_PROCESSORS_IN_SIZE_BYTES, true);
     mProcessorsTotalProcessTimeMs
         = mMetricsRecordRef.CreateTimeCounter(METRIC_PIPELINE_PROCESSORS_TOTAL_PROCESS_TIME_MS);
     mFlushersInGroupsTotal = mMetricsRecordRef.CreateCounter(METRIC_PIPELINE_FLUSHERS_IN_EVENT_GROUPS_TOTAL);
     mFlushersInEventsTotal = mMetricsRecordRef.CreateCounter(METRIC_PIPELINE_FLUSHERS_IN_EVENTS_TOTAL);
     mFlushersInSizeBytes = mMetricsRecordRef.CreateCounter(METRIC_PIPELINE_FLUSHERS_IN_SIZE_BYTES);
     mFlushersTotalPackageTimeMs = mMetricsRecordRef.CreateTimeCounter(METRIC_PIPELINE_FLUSHERS_TOTAL_PACKAGE_TIME_MS);
+    if (LatencyTraceRecorder::IsEnabled()) {
+        mLatencyTraceRecorder.Init(mMetricsRecordRef);
+    }
 
     return true;
 }
@@ -367,14 +376,20 @@ void Pipeline::Process(vector<PipelineEventGroup>& logGroupList, size_t inputInd
     }
     mProcessorsInGroupsTotal->Add(logGroupList.size());
 
+    auto processorLine = GetProcessorLine();
     auto before = chrono::system_clock::now();
     for (auto& p : mInputs[inputIndex]->GetInnerProcessors()) {
         p->Process(logGroupList);
     }
-    for (auto& p : mProcessorLine) {
+    for (auto& p : *processorLine) {
         p->Process(logGroupList);
     }
     mProcessorsTotalProcessTimeMs->Add(chrono::system_clock::now() - before);
+    for (auto& logGroup : logGroupList) {
+        if (logGroup.GetLatencyTrace()) {
+            logGroup.GetLatencyTrace()->Stamp(LatencyStage::PROCESS);
+        }
+    }
 }
 
 bool Pipeline::Send(vector<PipelineEventGroup>&& groupList) {
@@ -448,6 +463,65 @@ void Pipeline::RemoveProcessQueue() const {
     ProcessQueueManager::GetInstance()->DeleteQueue(mContext.GetProcessQueueKey());
 }
 
+bool Pipeline::CanUpdateProcessorsInPlace(const PipelineConfig& config) const {
+    // Go pipelines are loaded as a whole, and reader types depend on the flags below.
+    if (HasGoPipelineWithInput() || HasGoPipelineWithoutInput() || config.HasGoPlugin()
+        || config.IsFlushingThroughGoPipelineExisted()) {
+        return false;
+    }
+    if (config.mIsFirstProcessorJson != mContext.IsFirstProcessorJson()
+        || config.mHasNativeProcessor != mContext.HasNativeProcessors()) {
+        return false;
+    }
+    bool isFirstProcessorApsara = !config.mProcessors.empty()
+        && (*config.mProcessors[0])["Type"].asString() == ProcessorParseApsaraNative::sName;
+    if (isFirstProcessorApsara != mContext.IsFirstProcessorApsara()) {
+        return false;
+    }
+
+    Json::Value oldConfig = *mConfig, newConfig = *config.mDetail;
+    for (auto& c : {&oldConfig, &newConfig}) {
+        c->removeMember("processors");
+        c->removeMember("createTime");
+    }
+    return oldConfig == newConfig;
+}
+
+bool Pipeline::UpdateProcessors(PipelineConfig&& config) {
+    auto processorLine = make_shared<ProcessorLine>();
+    unordered_map<string, uint32_t> processorCnt;
+    for (size_t i = 0; i < config.mProcessors.size(); ++i) {
+        const Json::Value& detail = *config.mProcessors[i];
+        string pluginType = detail["Type"].asString();
+        unique_ptr<ProcessorInstance> processor
+            = PluginRegistry::GetInstance()->CreateProcessor(pluginType, GenNextPluginMeta(false));
+        if (!processor || !processor->Init(detail, mContext)) {
+            return false;
+        }
+        processorLine->emplace_back(std::move(processor));
+        ++processorCnt[pluginType];
+    }
+
+    {
+        ScopedSpinLock lock(mProcessorLineLock);
+        mProcessorLine.swap(processorLine);
+    }
+    if (processorCnt.empty()) {
+        mPluginCntMap.erase("processors");
+    } else {
+        mPluginCntMap["processors"] = std::move(processorCnt);
+    }
+    mConfig = std::move(config.mDetail);
+    mContext.SetCreateTime(config.mCreateTime);
+    LOG_INFO(sLogger, ("pipeline update processors", "succeeded")("config", mName));
+    return true;
+}
+
+shared_ptr<ProcessorLine> Pipeline::GetProcessorLine() const {
+    ScopedSpinLock lock(mProcessorLineLock);
+    return mProcessorLine;
+}
+
 void Pipeline::MergeGoPipeline(const Json::Value& src, Json::Value& dst) {
     for (auto itr = src.begin(); itr != src.end(); ++itr) {
         if (itr->isArray()) {
@@ -23,8 +23,10 @@
 #include <unordered_map>
 #include <vector>
 
+#include "common/Lock.h"
 #include "config/PipelineConfig.h"
 #include "models/PipelineEventGroup.h"
+#include "monitor/LatencyTraceRecorder.h"
 #include "monitor/MetricManager.h"
 #include "pipeline/PipelineContext.h"
 #include "pipeline/plugin/instance/FlusherInstance.h"
@@ -36,6 +38,8 @@
 
 namespace logtail {
 
+using ProcessorLine = std::vector<std::unique_ptr<ProcessorInstance>>;
+
 class Pipeline {
 public:
     // copy/move control functions are deleted because of mContext
@@ -46,6 +50,12 @@ public:
     bool Send(std::vector<PipelineEventGroup>&& groupList);
     bool FlushBatch();
     void RemoveProcessQueue() const;
+    // CanUpdateProcessorsInPlace tells if @config differs from the current config only in native processors.
+    bool CanUpdateProcessorsInPlace(const PipelineConfig& config) const;
+    // UpdateProcessors replaces the processor line with the one built from @config, while inputs, queues and
+    // flushers (along with data in batchers) are kept. The old line is released by the last thread using it.
+    // On failure, the pipeline is left unchanged.
+    bool UpdateProcessors(PipelineConfig&& config);
     // Should add before or when item pop from ProcessorQueue, must be called in the lock of ProcessorQueue
     void AddInProcessCnt() { mInProcessCnt.fetch_add(1); }
     // Should sub when or after item push to SenderQueue
@@ -62,6 +72,7 @@ public:
     PipelineContext& GetContext() const { return mContext; }
     const Json::Value& GetConfig() const { return *mConfig; }
     const std::vector<std::unique_ptr<FlusherInstance>>& GetFlushers() const { return mFlushers; }
+    LatencyTraceRecorder& GetLatencyTraceRecorder() { return mLatencyTraceRecorder; }
     bool IsFlushingThroughGoPipeline() const { return !mGoPipelineWithoutInput.isNull(); }
     const std::unordered_map<std::string, std::unordered_map<std::string, uint32_t>>& GetPluginStatistics() const {
         return mPluginCntMap;
@@ -87,12 +98,15 @@ private:
                                const std::string& module,
                                Json::Value& dst);
     void CopyNativeGlobalParamToGoPipeline(Json::Value& root);
-    bool ShouldAddPluginToGoPipelineWithInput() const { return mInputs.empty() && mProcessorLine.empty(); }
+    bool ShouldAddPluginToGoPipelineWithInput() const { return mInputs.empty() && mProcessorLine->empty(); }
     void WaitAllItemsInProcessFinished();
+    std::shared_ptr<ProcessorLine> GetProcessorLine() const;
 
     std::string mName;
     std::vector<std::unique_ptr<InputInstance>> mInputs;
-    std::vector<std::unique_ptr<ProcessorInstance>> mProcessorLine;
+    // Readers take a reference under the lock, so that the line can be replaced while being used.
+    mutable SpinLock mProcessorLineLock;
+    std::shared_ptr<ProcessorLine> mProcessorLine = std::make_shared<ProcessorLine>();
     std::vector<std::unique_ptr<FlusherInstance>> mFlushers;
     Router mRouter;
     Json::Value mGoPipelineWithInput;
@@ -113,6 +127,7 @@ private:
     CounterPtr mFlushersInEventsTotal;
     CounterPtr mFlushersInSizeBytes;
     TimeCounterPtr mFlushersTotalPackageTimeMs;
+    LatencyTraceRecorder mLatencyTraceRecorder;
 
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class PipelineMock;
@@ -67,6 +67,7 @@ public:
     QueueKey GetProcessQueueKey() const { return mProcessQueueKey; }
     const Pipeline& GetPipeline() const { return *mPipeline; }
     Pipeline& GetPipeline() { return *mPipeline; }
+    bool HasPipeline() const { return mPipeline != nullptr; }
     void SetPipeline(Pipeline& pipeline) { mPipeline = &pipeline; }
 
     const std::string& GetProjectName() const;
@@ -16,6 +16,11 @@
 
 #include "pipeline/PipelineManager.h"
 
+#include <algorithm>
+#include <unordered_set>
+
+#include "common/Flags.h"
+#include "common/ParallelFor.h"
 #include "file_server/ConfigManager.h"
 #include "file_server/FileServer.h"
 #include "go_pipeline/LogtailPlugin.h"
@@ -34,6 +39,11 @@
 
 using namespace std;
 
+DEFINE_FLAG_BOOL(enable_pipeline_in_place_update,
+                 "apply processor-only config changes to the running pipeline without rebuilding it",
+                 true);
+DEFINE_FLAG_INT32(pipeline_build_thread_num, "max threads to build native pipelines, 1 for building one by one", 8);
+
 namespace logtail {
 
 PipelineManager::PipelineManager()
@@ -48,6 +58,14 @@ PipelineManager::PipelineManager()
 static shared_ptr<Pipeline> sEmptyPipeline;
 
 void logtail::PipelineManager::UpdatePipelines(PipelineConfigDiff& diff) {
+    // decided ahead, since configs are consumed once pipelines are built
+    unordered_set<string> inPlaceConfigs;
+    for (const auto& config : diff.mModified) {
+        if (CanUpdatePipelineInPlace(config)) {
+            inPlaceConfigs.insert(config.mName);
+        }
+    }
+
 #ifndef APSARA_UNIT_TEST_MAIN
     // 过渡使用
     static bool isFileServerStarted = false;
@@ -56,6 +74,10 @@ void logtail::PipelineManager::UpdatePipelines(PipelineConfigDiff& diff) {
         isFileServerInputChanged = CheckIfFileServerUpdated(mPipelineNameEntityMap[name]->GetConfig()["inputs"][0]);
     }
     for (const auto& config : diff.mModified) {
+        if (inPlaceConfigs.find(config.mName) != inPlaceConfigs.end()) {
+            // inputs are kept as they are
+            continue;
+        }
         isFileServerInputChanged = CheckIfFileServerUpdated(*config.mInputs[0]);
     }
     for (const auto& config : diff.mAdded) {
@@ -81,8 +103,50 @@ void logtail::PipelineManager::UpdatePipelines(PipelineConfigDiff& diff) {
         ConfigFeedbackReceiver::GetInstance().FeedbackContinuousPipelineConfigStatus(name,
                                                                                      ConfigFeedbackStatus::DELETED);
     }
+
+    vector<PipelineConfig*> configsToBuild;
     for (auto& config : diff.mModified) {
-        auto p = BuildPipeline(std::move(config)); // auto reuse old pipeline's process queue and sender queue
+        if (inPlaceConfigs.find(config.mName) == inPlaceConfigs.end() && CanBuildPipelineInParallel(config)) {
+            configsToBuild.push_back(&config);
+        }
+    }
+    for (auto& config : diff.mAdded) {
+        if (CanBuildPipelineInParallel(config)) {
+            configsToBuild.push_back(&config);
+        }
+    }
+    auto builtPipelines = BuildPipelines(configsToBuild);
+
+    for (auto& config : diff.mModified) {
+        if (inPlaceConfigs.find(config.mName) != inPlaceConfigs.end()) {
+            auto& pipeline = mPipelineNameEntityMap[config.mName];
+            auto oldStatistics = pipeline->GetPluginStatistics();
+            // only the detail of the config is consumed, the other fields are still valid afterwards
+            if (!pipeline->UpdateProcessors(std::move(config))) {
+                LOG_WARNING(sLogger,
+                            ("failed to update processors for existing config",
+                             "keep current pipeline running")("config", config.mName));
+                AlarmManager::GetInstance()->SendAlarm(
+                    CATEGORY_CONFIG_ALARM,
+                    "failed to update processors for existing config: keep current pipeline running, config: "
+                        + config.mName,
+                    config.mProject,
+                    config.mLogstore,
+                    config.mRegion);
+                ConfigFeedbackReceiver::GetInstance().FeedbackContinuousPipelineConfigStatus(
+                    config.mName, ConfigFeedbackStatus::FAILED);
+                continue;
+            }
+            DecreasePluginUsageCnt(oldStatistics);
+            IncreasePluginUsageCnt(pipeline->GetPluginStatistics());
+            ConfigFeedbackReceiver::GetInstance().FeedbackContinuousPipelineConfigStatus(config.mName,
+                                                                                         ConfigFeedbackStatus::APPLIED);
+            continue;
+        }
+        // the other pipelines are built right before they are started, since Go loads one pipeline at a time
+        auto builtIter = builtPipelines.find(config.mName);
+        // auto reuse old pipeline's process queue and sender queue
+        auto p = builtIter != builtPipelines.end() ? std::move(builtIter->second) : BuildPipeline(std::move(config));
         if (!p) {
             LOG_WARNING(sLogger,
                         ("failed to build pipeline for existing config",
@@ -111,7 +175,8 @@ void logtail::PipelineManager::UpdatePipelines(PipelineConfigDiff& diff) {
                                                                                      ConfigFeedbackStatus::APPLIED);
     }
     for (auto& config : diff.mAdded) {
-        auto p = BuildPipeline(std::move(config));
+        auto builtIter = builtPipelines.find(config.mName);
+        auto p = builtIter != builtPipelines.end() ? std::move(builtIter->second) : BuildPipeline(std::move(config));
         if (!p) {
             LOG_WARNING(sLogger,
                         ("failed to build pipeline for new config", "skip current object")("config", config.mName));
@@ -207,6 +272,50 @@ void PipelineManager::StopAllPipelines() {
     LOG_INFO(sLogger, ("stop all pipelines", "succeeded"));
 }
 
+bool PipelineManager::CanUpdatePipelineInPlace(const PipelineConfig& config) const {
+    if (!BOOL_FLAG(enable_pipeline_in_place_update)) {
+        return false;
+    }
+    auto iter = mPipelineNameEntityMap.find(config.mName);
+    return iter != mPipelineNameEntityMap.end() && iter->second->CanUpdateProcessorsInPlace(config);
+}
+
+bool PipelineManager::CanBuildPipelineInParallel(const PipelineConfig& config) {
+    // Go keeps a single pipeline loaded but not yet started, so a pipeline involving Go must be started before the
+    // next one is built. Container discovery generates a Go pipeline for container meta during initialization.
+    if (config.HasGoPlugin() || config.IsFlushingThroughGoPipelineExisted()) {
+        return false;
+    }
+    for (const auto* input : config.mInputs) {
+        string inputType = (*input)["Type"].asString();
+        if (inputType == "input_container_stdio") {
+            return false;
+        }
+        if (inputType == "input_file") {
+            const Json::Value& enableContainerDiscovery = (*input)["EnableContainerDiscovery"];
+            if (enableContainerDiscovery.isBool() && enableContainerDiscovery.asBool()) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+unordered_map<string, shared_ptr<Pipeline>> PipelineManager::BuildPipelines(const vector<PipelineConfig*>& configs) {
+    // Native pipelines are built in parallel, since initialization of thousands of them, e.g. compiling regexes and
+    // creating queues, may take long on startup.
+    vector<shared_ptr<Pipeline>> pipelines(configs.size());
+    ParallelFor(configs.size(), static_cast<size_t>(max(INT32_FLAG(pipeline_build_thread_num), 1)), [&](size_t i) {
+        pipelines[i] = BuildPipeline(std::move(*configs[i]));
+    });
+
+    unordered_map<string, shared_ptr<Pipeline>> res;
+    for (size_t i = 0; i < configs.size(); ++i) {
+        res[configs[i]->mName] = std::move(pipelines[i]);
+    }
+    return res;
+}
+
 shared_ptr<Pipeline> PipelineManager::BuildPipeline(PipelineConfig&& config) {
     shared_ptr<Pipeline> p = make_shared<Pipeline>();
     // only config.mDetail is removed, other members can be safely used later
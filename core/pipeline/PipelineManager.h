@@ -52,7 +52,12 @@ private:
     PipelineManager();
     ~PipelineManager() = default;
 
+    // @param configs must satisfy CanBuildPipelineInParallel
+    std::unordered_map<std::string, std::shared_ptr<Pipeline>>
+    BuildPipelines(const std::vector<PipelineConfig*>& configs);
+    static bool CanBuildPipelineInParallel(const PipelineConfig& config);
     virtual std::shared_ptr<Pipeline> BuildPipeline(PipelineConfig&& config); // virtual for ut
+    bool CanUpdatePipelineInPlace(const PipelineConfig& config) const;
     void IncreasePluginUsageCnt(
         const std::unordered_map<std::string, std::unordered_map<std::string, uint32_t>>& statistics);
     void DecreasePluginUsageCnt(
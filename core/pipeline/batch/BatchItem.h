@@ -43,6 +43,7 @@ public:
         if (mGroups.empty()) {
             return;
         }
+        StampLatencyTraces();
         for (auto& g : mGroups) {
             res.emplace_back(std::move(g));
         }
@@ -53,6 +54,7 @@ public:
         if (mGroups.empty()) {
             return;
         }
+        StampLatencyTraces();
         res.emplace_back(std::move(mGroups));
         Clear();
     }
@@ -66,6 +68,14 @@ public:
     bool IsEmpty() { return mGroups.empty(); }
 
 private:
+    void StampLatencyTraces() {
+        for (auto& g : mGroups) {
+            if (g.mLatencyTrace) {
+                g.mLatencyTrace->Stamp(LatencyStage::BATCH_FLUSH);
+            }
+        }
+    }
+
     void Clear() {
         mGroups.clear();
         mStatus.Reset();
@@ -107,6 +117,9 @@ public:
             UpdateExactlyOnceLogPosition();
         }
         mBatch.mSizeBytes = DataSize();
+        if (mBatch.mLatencyTrace) {
+            mBatch.mLatencyTrace->Stamp(LatencyStage::BATCH_FLUSH);
+        }
         res.Add(std::move(mBatch), mTotalEnqueTimeMs);
         Clear();
     }
@@ -119,6 +132,9 @@ public:
             UpdateExactlyOnceLogPosition();
         }
         mBatch.mSizeBytes = DataSize();
+        if (mBatch.mLatencyTrace) {
+            mBatch.mLatencyTrace->Stamp(LatencyStage::BATCH_FLUSH);
+        }
         res.emplace_back(std::move(mBatch));
         Clear();
     }
@@ -132,6 +148,9 @@ public:
             UpdateExactlyOnceLogPosition();
         }
         mBatch.mSizeBytes = DataSize();
+        if (mBatch.mLatencyTrace) {
+            mBatch.mLatencyTrace->Stamp(LatencyStage::BATCH_FLUSH);
+        }
         res.back().emplace_back(std::move(mBatch));
         Clear();
     }
@@ -148,6 +167,12 @@ public:
         AddSourceBuffer(sourceBuffer);
     }
 
+    void AddLatencyTrace(const LatencyTracePtr& trace) {
+        if (trace && !mBatch.mLatencyTrace) {
+            mBatch.mLatencyTrace = trace;
+        }
+    }
+
     void AddSourceBuffer(const std::shared_ptr<SourceBuffer>& sourceBuffer) {
         if (mSourceBuffers.find(sourceBuffer.get()) == mSourceBuffers.end()) {
             mSourceBuffers.insert(sourceBuffer.get());
@@ -97,6 +97,7 @@ void BatchedEvents::Clear() {
     mSizeBytes = 0;
     mExactlyOnceCheckpoint.reset();
     mPackIdPrefix = StringView();
+    mLatencyTrace.reset();
 }
 
 } // namespace logtail
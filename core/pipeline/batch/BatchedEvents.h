@@ -19,6 +19,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "models/LatencyTrace.h"
 #include "models/PipelineEventGroup.h"
 #include "models/StringView.h"
 
@@ -32,6 +33,8 @@ struct BatchedEvents {
     // for flusher_sls only
     RangeCheckpointPtr mExactlyOnceCheckpoint;
     StringView mPackIdPrefix;
+    // trace of the first sampled group in the batch, if any
+    LatencyTracePtr mLatencyTrace;
 
     BatchedEvents() = default;
     ~BatchedEvents();
@@ -153,6 +153,9 @@ public:
                                g.GetExactlyOnceCheckpoint(),
                                g.GetMetadata(EventGroupMetaKey::SOURCE_ID));
                 }
+                if (&e == &g.MutableEvents().front()) {
+                    item.AddLatencyTrace(g.GetLatencyTrace());
+                }
                 item.Add(std::move(e));
                 if (mEventFlushStrategy.SizeReachingUpperLimit(item.GetStatus())) {
                     mOutEventsTotal->Add(item.EventSize());
@@ -200,6 +203,9 @@ public:
                 } else if (i == 0) {
                     item.AddSourceBuffer(g.GetSourceBuffer());
                 }
+                if (i == 0) {
+                    item.AddLatencyTrace(g.GetLatencyTrace());
+                }
                 mBufferedEventsTotal->Add(1);
                 mBufferedDataSizeByte->Add(e->DataSize());
                 item.Add(std::move(e));
@@ -24,28 +24,44 @@ void TimeoutFlushManager::UpdateRecord(
     auto& item = mTimeoutRecords[config];
     auto it = item.find({index, key});
     if (it == item.end()) {
-        item.try_emplace({index, key}, f, key, timeoutSecs);
+        it = item.try_emplace({index, key}, f, key, timeoutSecs).first;
+        it->second.mTimerId = mTimeoutWheel.Add(chrono::steady_clock::now() + chrono::seconds(timeoutSecs),
+                                                {config, {index, key}});
     } else {
         it->second.Update();
+        mTimeoutWheel.Reschedule(it->second.mTimerId,
+                                 chrono::steady_clock::now() + chrono::seconds(it->second.mTimeoutSecs));
     }
+    mNextCheckTime = mTimeoutWheel.GetNextCheckTime().time_since_epoch().count();
 }
 
 void TimeoutFlushManager::FlushTimeoutBatch() {
+    auto now = chrono::steady_clock::now();
+    if (now.time_since_epoch().count() < mNextCheckTime.load()) {
+        return;
+    }
     vector<pair<Flusher*, size_t>> records;
     {
         lock_guard<mutex> lock(mMux);
-        for (auto& item : mTimeoutRecords) {
-            for (auto it = item.second.begin(); it != item.second.end();) {
-                if (time(nullptr) - it->second.mUpdateTime >= it->second.mTimeoutSecs) {
-                    // cannot flush here, since flush may also update record, which will lead to both deadlock and map
-                    // iterator invalidation problems
-                    records.emplace_back(it->second.mFlusher, it->second.mKey);
-                    it = item.second.erase(it);
-                } else {
-                    ++it;
-                }
+        vector<TimeoutRecordKey> expired;
+        mTimeoutWheel.Advance(now, expired);
+        for (auto& key : expired) {
+            auto item = mTimeoutRecords.find(key.mConfig);
+            if (item == mTimeoutRecords.end()) {
+                continue;
+            }
+            auto it = item->second.find(key.mKey);
+            if (it == item->second.end()) {
+                continue;
+            }
+            // cannot flush here, since flush may also update record, which will lead to deadlock
+            records.emplace_back(it->second.mFlusher, it->second.mKey);
+            item->second.erase(it);
+            if (item->second.empty()) {
+                mTimeoutRecords.erase(item);
             }
         }
+        mNextCheckTime = mTimeoutWheel.GetNextCheckTime().time_since_epoch().count();
     }
     for (auto& item : records) {
         item.first->Flush(item.second);
@@ -54,7 +70,15 @@ void TimeoutFlushManager::FlushTimeoutBatch() {
 
 void TimeoutFlushManager::ClearRecords(const string& config) {
     lock_guard<mutex> lock(mMux);
-    mTimeoutRecords.erase(config);
+    auto item = mTimeoutRecords.find(config);
+    if (item == mTimeoutRecords.end()) {
+        return;
+    }
+    for (auto& record : item->second) {
+        mTimeoutWheel.Cancel(record.second.mTimerId);
+    }
+    mTimeoutRecords.erase(item);
+    mNextCheckTime = mTimeoutWheel.GetNextCheckTime().time_since_epoch().count();
 }
 
 } // namespace logtail
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <ctime>
 #include <map>
@@ -23,6 +25,7 @@
 #include <string>
 #include <vector>
 
+#include "common/timer/TimingWheel.h"
 #include "pipeline/plugin/interface/Flusher.h"
 
 namespace logtail {
@@ -32,6 +35,7 @@ struct TimeoutRecord {
     size_t mKey;
     time_t mUpdateTime = 0;
     uint32_t mTimeoutSecs = 0;
+    uint64_t mTimerId = 0;
 
     TimeoutRecord(Flusher* flusher, size_t key, uint32_t timeoutSecs)
         : mFlusher(flusher), mKey(key), mUpdateTime(time(nullptr)), mTimeoutSecs(timeoutSecs) {}
@@ -57,8 +61,16 @@ private:
     TimeoutFlushManager() = default;
     ~TimeoutFlushManager() = default;
 
+    struct TimeoutRecordKey {
+        std::string mConfig;
+        std::pair<size_t, size_t> mKey;
+    };
+
     std::mutex mMux;
     std::map<std::string, std::map<std::pair<size_t, size_t>, TimeoutRecord>> mTimeoutRecords;
+    TimingWheel<TimeoutRecordKey> mTimeoutWheel;
+    // earliest steady clock time (in ns) at which some record may expire, so that callers can return without lock
+    std::atomic_int64_t mNextCheckTime{std::chrono::steady_clock::time_point::max().time_since_epoch().count()};
 
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class PipelineUnittest;
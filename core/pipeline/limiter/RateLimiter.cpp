@@ -14,45 +14,75 @@
 
 #include "pipeline/limiter/RateLimiter.h"
 
-#include "logger/Logger.h"
-// TODO: temporarily used
-#include "app_config/AppConfig.h"
-#include "common/TimeUtil.h"
+#include <algorithm>
+#include <utility>
+
+#include "common/Flags.h"
+#include "monitor/metric_constants/MetricConstants.h"
+
+DEFINE_FLAG_INT32(rate_limiter_burst_ms, "default burst of rate limiter, in milliseconds of max rate", 1000);
 
 using namespace std;
 
 namespace logtail {
 
-bool RateLimiter::IsValidToPop() {
-    if (time(nullptr) != mLastSendTimeSecond) {
-        mLastSecondTotalBytes = 0;
-        mLastSendTimeSecond = time(nullptr);
+RateLimiter::RateLimiter(uint64_t maxRate, uint64_t burstBytes, Clock clock) : mClock(std::move(clock)) {
+    if (!mClock) {
+        mClock = []() { return chrono::steady_clock::now(); };
     }
-    if (mLastSecondTotalBytes > mMaxSendBytesPerSecond) {
-        return false;
+    SetMaxRate(maxRate, burstBytes);
+}
+
+bool RateLimiter::IsValidToPop() {
+    lock_guard<mutex> lock(mMux);
+    if (mMaxSendBytesPerSecond == 0) {
+        return true;
     }
-    return true;
+    Refill(mClock());
+    return mTokens > 0.0;
 }
 
 void RateLimiter::PostPop(size_t size) {
-    mLastSecondTotalBytes += size;
+    lock_guard<mutex> lock(mMux);
+    if (mMaxSendBytesPerSecond == 0) {
+        return;
+    }
+    mTokens -= static_cast<double>(size);
+}
+
+void RateLimiter::SetMaxRate(uint64_t maxRate, uint64_t burstBytes) {
+    lock_guard<mutex> lock(mMux);
+    mMaxSendBytesPerSecond = maxRate;
+    if (burstBytes == 0) {
+        burstBytes = maxRate * static_cast<uint64_t>(max(INT32_FLAG(rate_limiter_burst_ms), 1)) / 1000;
+    }
+    mBurstBytes = max(burstBytes, static_cast<uint64_t>(1));
+    mTokens = static_cast<double>(mBurstBytes);
+    mLastRefillTime = mClock();
+}
+
+uint64_t RateLimiter::GetMaxRate() const {
+    lock_guard<mutex> lock(mMux);
+    return mMaxSendBytesPerSecond;
+}
+
+string RateLimiter::GetLimiterMetricName(const string& limiter) {
+    if (limiter == "global") {
+        return METRIC_COMPONENT_QUEUE_FETCH_REJECTED_BY_GLOBAL_RATE_LIMITER_TIMES_TOTAL;
+    } else if (limiter == "region") {
+        return METRIC_COMPONENT_QUEUE_FETCH_REJECTED_BY_REGION_RATE_LIMITER_TIMES_TOTAL;
+    }
+    return METRIC_COMPONENT_QUEUE_FETCH_REJECTED_BY_RATE_LIMITER_TIMES_TOTAL;
 }
 
-void RateLimiter::FlowControl(int32_t dataSize, int64_t& lastSendTime, int32_t& lastSendByte, bool isRealTime) {
-    int64_t curTime = GetCurrentTimeInMicroSeconds();
-    int32_t bps = isRealTime ? AppConfig::GetInstance()->GetMaxBytePerSec() : AppConfig::GetInstance()->GetBytePerSec();
-    if (curTime < lastSendTime || curTime - lastSendTime >= 1000 * 1000) {
-        lastSendTime = curTime;
-        lastSendByte = dataSize;
-    } else {
-        if (lastSendByte > bps) {
-            usleep(1000 * 1000 - (curTime - lastSendTime));
-            lastSendTime = GetCurrentTimeInMicroSeconds();
-            lastSendByte = dataSize;
-        } else {
-            lastSendByte += dataSize;
-        }
+void RateLimiter::Refill(chrono::steady_clock::time_point now) {
+    if (now <= mLastRefillTime) {
+        return;
     }
+    // nanosecond resolution, so that the refill stays precise when the flusher runner polls frequently
+    double elapsedSecs = chrono::duration<double>(now - mLastRefillTime).count();
+    mTokens = min(mTokens + elapsedSecs * static_cast<double>(mMaxSendBytesPerSecond), static_cast<double>(mBurstBytes));
+    mLastRefillTime = now;
 }
 
 } // namespace logtail
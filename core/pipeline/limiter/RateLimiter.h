@@ -16,28 +16,48 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstdint>
-#include <ctime>
+#include <functional>
+#include <mutex>
+#include <string>
 
 namespace logtail {
 
+// Token bucket limiter. Tokens are refilled continuously at mMaxSendBytesPerSecond up to the burst size, and an item
+// is allowed to pop as long as the bucket is not in debt, so items larger than the burst size can still be sent. The
+// debt is paid back before the next item is allowed, which keeps the long-term rate precise even at GB/s rates.
+// Instances can be shared among queues (e.g., global and region level), so all methods are thread-safe.
 class RateLimiter {
 public:
-    RateLimiter(uint32_t maxRate) : mMaxSendBytesPerSecond(maxRate) {}
+    using Clock = std::function<std::chrono::steady_clock::time_point()>;
+
+    // burstBytes == 0 means using default burst, which is determined by flag rate_limiter_burst_ms
+    // clock == nullptr means using std::chrono::steady_clock
+    explicit RateLimiter(uint64_t maxRate, uint64_t burstBytes = 0, Clock clock = nullptr);
 
     bool IsValidToPop();
     void PostPop(size_t size);
 
-    uint32_t mMaxSendBytesPerSecond = 0;
+    // maxRate == 0 means unlimited
+    void SetMaxRate(uint64_t maxRate, uint64_t burstBytes = 0);
+    uint64_t GetMaxRate() const;
+
+    static std::string GetLimiterMetricName(const std::string& limiter);
 
-    // TODO: temporarily used, should use rate limiter instead
-    static void FlowControl(int32_t dataSize, int64_t& lastSendTime, int32_t& lastSendByte, bool isRealTime);
+    uint64_t mMaxSendBytesPerSecond = 0;
 
 private:
-    time_t mLastSendTimeSecond = 0;
-    uint32_t mLastSecondTotalBytes = 0;
+    void Refill(std::chrono::steady_clock::time_point now);
+
+    mutable std::mutex mMux;
+    Clock mClock;
+    uint64_t mBurstBytes = 0;
+    double mTokens = 0.0;
+    std::chrono::steady_clock::time_point mLastRefillTime;
 
 #ifdef APSARA_UNIT_TEST_MAIN
+    friend class RateLimiterUnittest;
     friend class SenderQueueUnittest;
     friend class ExactlyOnceSenderQueueUnittest;
     friend class ExactlyOnceQueueManagerUnittest;
@@ -20,6 +20,7 @@
 
 #include "common/TimeUtil.h"
 #include "logger/Logger.h"
+#include "monitor/LatencyTraceRecorder.h"
 #include "monitor/metric_constants/MetricConstants.h"
 
 using namespace std;
@@ -34,11 +35,17 @@ bool ProcessorInstance::Init(const Json::Value& config, PipelineContext& context
     }
 
     // should init plugin first， then could GetMetricsRecordRef from plugin
-    mInEventsTotal = mPlugin->GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_IN_EVENTS_TOTAL);
-    mOutEventsTotal = mPlugin->GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_OUT_EVENTS_TOTAL);
-    mInSizeBytes = mPlugin->GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_IN_SIZE_BYTES);
-    mOutSizeBytes = mPlugin->GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_OUT_SIZE_BYTES);
+    // updated by all processor threads for each event group
+    mInEventsTotal = mPlugin->GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_IN_EVENTS_TOTAL, true);
+    mOutEventsTotal = mPlugin->GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_OUT_EVENTS_TOTAL, true);
+    mInSizeBytes = mPlugin->GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_IN_SIZE_BYTES, true);
+    mOutSizeBytes = mPlugin->GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_OUT_SIZE_BYTES, true);
     mTotalProcessTimeMs = mPlugin->GetMetricsRecordRef().CreateTimeCounter(METRIC_PLUGIN_TOTAL_PROCESS_TIME_MS);
+    mProcessLatencyUs = mPlugin->GetMetricsRecordRef().CreateHistogram(METRIC_PLUGIN_PROCESS_LATENCY_US);
+    if (LatencyTraceRecorder::IsEnabled()) {
+        mTracedProcessLatencyUs
+            = mPlugin->GetMetricsRecordRef().CreateHistogram(METRIC_PLUGIN_TRACED_PROCESS_LATENCY_US);
+    }
 
     return true;
 }
@@ -52,9 +59,25 @@ void ProcessorInstance::Process(vector<PipelineEventGroup>& eventGroupList) {
         mInSizeBytes->Add(eventGroup.DataSize());
     }
 
+    bool traced = false;
+    if (mTracedProcessLatencyUs) {
+        for (const auto& eventGroup : eventGroupList) {
+            if (eventGroup.GetLatencyTrace()) {
+                traced = true;
+                break;
+            }
+        }
+    }
+
     auto before = chrono::system_clock::now();
     mPlugin->Process(eventGroupList);
-    mTotalProcessTimeMs->Add(chrono::system_clock::now() - before);
+    auto cost = chrono::system_clock::now() - before;
+    mTotalProcessTimeMs->Add(cost);
+    mProcessLatencyUs->Add(cost);
+    if (traced) {
+        mTracedProcessLatencyUs->Add(
+            static_cast<uint64_t>(chrono::duration_cast<chrono::microseconds>(cost).count()));
+    }
 
     for (const auto& eventGroup : eventGroupList) {
         mOutEventsTotal->Add(eventGroup.GetEvents().size());
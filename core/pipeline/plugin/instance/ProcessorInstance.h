@@ -45,6 +45,9 @@ private:
     CounterPtr mInSizeBytes;
     CounterPtr mOutSizeBytes;
     TimeCounterPtr mTotalProcessTimeMs;
+    HistogramPtr mProcessLatencyUs;
+    // only created when latency tracing is enabled
+    HistogramPtr mTracedProcessLatencyUs;
 
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class ProcessorInstanceUnittest;
@@ -84,6 +84,20 @@ bool Flusher::PushToQueue(unique_ptr<SenderQueueItem>&& item, uint32_t retryTime
     return false;
 }
 
+void Flusher::RecordLatencyTrace(SenderQueueItem* item) {
+    if (!item->mLatencyTrace) {
+        return;
+    }
+    item->mLatencyTrace->Stamp(LatencyStage::ACK);
+    if (item->mPipeline) {
+        item->mPipeline->GetLatencyTraceRecorder().Record(*item->mLatencyTrace);
+    } else if (HasContext() && mContext->HasPipeline()) {
+        mContext->GetPipeline().GetLatencyTraceRecorder().Record(*item->mLatencyTrace);
+    }
+    // the item may be sent again by mistake, e.g. a duplicated retry, and should not be recorded twice
+    item->mLatencyTrace.reset();
+}
+
 void Flusher::DealSenderQueueItemAfterSend(SenderQueueItem* item, bool keep) {
     if (keep) {
         item->mStatus = SendingStatus::IDLE;
@@ -45,6 +45,8 @@ public:
     QueueKey GetQueueKey() const { return mQueueKey; }
     void SetPluginID(const std::string& pluginID) { mPluginID = pluginID; }
     const std::string& GetPluginID() const { return mPluginID; }
+    // should be called once the item has been accepted by the destination
+    void RecordLatencyTrace(SenderQueueItem* item);
 
 protected:
     void GenerateQueueKey(const std::string& target);
@@ -14,6 +14,25 @@
 
 #include "pipeline/queue/BoundedSenderQueueInterface.h"
 
+#include "application/Application.h"
+#include "common/Flags.h"
+#include "common/StringTools.h"
+#include "logger/Logger.h"
+#include "pipeline/queue/QueueKeyManager.h"
+
+DEFINE_FLAG_INT64(sender_queue_spill_memory_watermark_bytes,
+                  "payload bytes kept in memory by a sender queue beyond its capacity before spilling to disk",
+                  16 * 1024 * 1024);
+DEFINE_FLAG_INT64(sender_queue_spill_max_bytes,
+                  "max payload bytes spilled to disk by a sender queue",
+                  1024 * 1024 * 1024);
+DEFINE_FLAG_INT64(sender_queue_spill_total_max_bytes,
+                  "max payload bytes spilled to disk by all sender queues",
+                  4LL * 1024 * 1024 * 1024);
+DEFINE_FLAG_INT32(sender_queue_spill_max_age_secs, "spilled items older than this are discarded", 12 * 3600);
+DEFINE_FLAG_INT32(sender_queue_spill_segment_size_bytes,
+                  "max size of a spill file, a file is removed once all payloads in it are sent",
+                  64 * 1024 * 1024);
 
 using namespace std;
 
@@ -29,6 +48,9 @@ BoundedSenderQueueInterface::BoundedSenderQueueInterface(
     mExtraBufferSize = mMetricsRecordRef.CreateIntGauge(METRIC_COMPONENT_QUEUE_EXTRA_BUFFER_SIZE);
     mFetchRejectedByRateLimiterTimesCnt = mMetricsRecordRef.CreateCounter(METRIC_COMPONENT_QUEUE_FETCH_REJECTED_BY_RATE_LIMITER_TIMES_TOTAL);
     mExtraBufferDataSizeBytes = mMetricsRecordRef.CreateIntGauge(METRIC_COMPONENT_QUEUE_EXTRA_BUFFER_SIZE_BYTES);
+    mSpilledItemsTotal = mMetricsRecordRef.CreateCounter(METRIC_COMPONENT_QUEUE_SPILLED_ITEMS_TOTAL);
+    mSpillDiscardedItemsTotal = mMetricsRecordRef.CreateCounter(METRIC_COMPONENT_QUEUE_SPILL_DISCARDED_ITEMS_TOTAL);
+    mSpillSizeBytes = mMetricsRecordRef.CreateIntGauge(METRIC_COMPONENT_QUEUE_SPILL_SIZE_BYTES);
 }
 
 void BoundedSenderQueueInterface::SetFeedback(FeedbackInterface* feedback) {
@@ -41,7 +63,49 @@ void BoundedSenderQueueInterface::SetFeedback(FeedbackInterface* feedback) {
 
 void BoundedSenderQueueInterface::SetRateLimiter(uint32_t maxRate) {
     if (maxRate > 0) {
-        mRateLimiter = RateLimiter(maxRate);
+        mRateLimiter.emplace(maxRate);
+    }
+}
+
+void BoundedSenderQueueInterface::SetRateLimiters(
+    std::unordered_map<std::string, std::shared_ptr<RateLimiter>>&& rateLimitersMap) {
+    mRateLimiters.clear();
+    for (const auto& item : rateLimitersMap) {
+        if (item.second == nullptr) {
+            continue;
+        }
+        mRateLimiters.emplace_back(item.second,
+                                   mMetricsRecordRef.CreateCounter(RateLimiter::GetLimiterMetricName(item.first)));
+    }
+}
+
+bool BoundedSenderQueueInterface::IsValidToPopByRateLimiters() {
+    if (mRateLimiter && !mRateLimiter->IsValidToPop()) {
+        mFetchRejectedByRateLimiterTimesCnt->Add(1);
+        mIsRateLimited = true;
+        return false;
+    }
+    // shared limiters, i.e. global and region, are ignored while exiting, just like the concurrency limit, so that
+    // remaining data can be flushed in time
+    if (Application::GetInstance()->IsExiting()) {
+        return true;
+    }
+    for (auto& limiter : mRateLimiters) {
+        if (!limiter.first->IsValidToPop()) {
+            limiter.second->Add(1);
+            mIsRateLimited = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+void BoundedSenderQueueInterface::PostPopByRateLimiters(size_t size) {
+    if (mRateLimiter) {
+        mRateLimiter->PostPop(size);
+    }
+    for (auto& limiter : mRateLimiters) {
+        limiter.first->PostPop(size);
     }
 }
 
@@ -72,6 +136,120 @@ void BoundedSenderQueueInterface::DecreaseSendingCnt() {
     }
 }
 
+static atomic_uint64_t sSpillBufferCnt{0};
+
+static shared_ptr<SpillBuffer> CreateSpillBuffer(const string& dir, QueueKey key) {
+    // named uniquely, since the buffer replaced on reset may still be in use
+    return make_shared<SpillBuffer>(dir,
+                                    "sender_queue_" + ToString(key) + "_" + ToString(sSpillBufferCnt++),
+                                    static_cast<size_t>(INT32_FLAG(sender_queue_spill_segment_size_bytes)));
+}
+
+void BoundedSenderQueueInterface::EnableSpill(const string& dir) {
+    if (mSpillBuffer) {
+        return;
+    }
+    mSpillDir = dir;
+    mSpillBuffer = CreateSpillBuffer(dir, mKey);
+}
+
+bool BoundedSenderQueueInterface::IsValidToPush() const {
+    if (BoundedQueueInterface::IsValidToPush()) {
+        return true;
+    }
+    // payloads are kept in memory once spilling fails, in which case upstream queues should be blocked as usual
+    return mSpillBuffer && mSpillBuffer->Size() < static_cast<size_t>(INT64_FLAG(sender_queue_spill_max_bytes))
+        && SpillBuffer::TotalSize() < static_cast<size_t>(INT64_FLAG(sender_queue_spill_total_max_bytes))
+        && mExtraBufferBytes <= static_cast<size_t>(INT64_FLAG(sender_queue_spill_memory_watermark_bytes));
+}
+
+shared_ptr<SpillBuffer> BoundedSenderQueueInterface::GetSpillBufferWithPendingIO() const {
+    if (mSpillBuffer && mSpillBuffer->HasPendingIO()) {
+        return mSpillBuffer;
+    }
+    return nullptr;
+}
+
+void BoundedSenderQueueInterface::PushToExtraBuffer(unique_ptr<SenderQueueItem>&& item) {
+    auto size = item->mData.size();
+    auto watermark = static_cast<size_t>(INT64_FLAG(sender_queue_spill_memory_watermark_bytes));
+    if (!mSpillBuffer || (mSpilledItems.empty() && mExtraBufferBytes + size <= watermark)) {
+        mExtraBuffer.push_back(std::move(item));
+        mExtraBufferBytes += size;
+        UpdateExtraBufferMetrics();
+        return;
+    }
+    SpilledItem spilled;
+    if (mSpillBuffer->Size() + size <= static_cast<size_t>(INT64_FLAG(sender_queue_spill_max_bytes))
+        && SpillBuffer::TotalSize() + size <= static_cast<size_t>(INT64_FLAG(sender_queue_spill_total_max_bytes))) {
+        // only staged here, the payload is written by the caller after the queue manager lock is released
+        spilled.mSpillId = mNextSpillId++;
+        mSpillBuffer->Stage(spilled.mSpillId, std::move(item->mData));
+        item->mData.clear();
+        mSpilledItemsTotal->Add(1);
+    } else {
+        // keep the payload in memory, upstream queues are blocked by now
+        mExtraBufferBytes += size;
+    }
+    spilled.mItem = std::move(item);
+    mSpilledItems.push_back(std::move(spilled));
+    UpdateExtraBufferMetrics();
+}
+
+unique_ptr<SenderQueueItem> BoundedSenderQueueInterface::PopFromExtraBuffer() {
+    unique_ptr<SenderQueueItem> item;
+    if (!mExtraBuffer.empty()) {
+        item = std::move(mExtraBuffer.front());
+        mExtraBuffer.pop_front();
+        mExtraBufferBytes -= item->mData.size();
+        UpdateExtraBufferMetrics();
+        return item;
+    }
+    auto curTime = chrono::system_clock::now();
+    while (!mSpilledItems.empty()) {
+        bool loaded = true;
+        auto& front = mSpilledItems.front();
+        if (front.mSpillId > 0) {
+            auto res = mSpillBuffer->Take(front.mSpillId, front.mItem->mData);
+            if (res == SpillBuffer::TakeResult::NOT_READY) {
+                // to be loaded by the caller, see GetSpillBufferWithPendingIO
+                return item;
+            }
+            loaded = res == SpillBuffer::TakeResult::OK;
+        } else {
+            mExtraBufferBytes -= front.mItem->mData.size();
+        }
+        auto spilled = std::move(front);
+        mSpilledItems.pop_front();
+        UpdateExtraBufferMetrics();
+        if (!loaded) {
+            mSpillDiscardedItemsTotal->Add(1);
+            LOG_ERROR(sLogger,
+                      ("failed to load spilled item", "discard data")(
+                          "config-flusher-dst", QueueKeyManager::GetInstance()->GetName(mKey)));
+            continue;
+        }
+        if (curTime - spilled.mItem->mFirstEnqueTime > chrono::seconds(INT32_FLAG(sender_queue_spill_max_age_secs))) {
+            mSpillDiscardedItemsTotal->Add(1);
+            LOG_WARNING(sLogger,
+                        ("spilled item is too old", "discard data")(
+                            "config-flusher-dst", QueueKeyManager::GetInstance()->GetName(mKey))(
+                            "enqueue time",
+                            chrono::duration_cast<chrono::seconds>(spilled.mItem->mFirstEnqueTime.time_since_epoch())
+                                .count()));
+            continue;
+        }
+        return std::move(spilled.mItem);
+    }
+    return item;
+}
+
+void BoundedSenderQueueInterface::UpdateExtraBufferMetrics() {
+    mExtraBufferSize->Set(mExtraBuffer.size() + mSpilledItems.size());
+    mExtraBufferDataSizeBytes->Set(mExtraBufferBytes);
+    mSpillSizeBytes->Set(mSpillBuffer ? mSpillBuffer->Size() : 0);
+}
+
 void BoundedSenderQueueInterface::GiveFeedback() const {
     // 0 is just a placeholder
     sFeedback->Feedback(0);
@@ -79,7 +257,14 @@ void BoundedSenderQueueInterface::GiveFeedback() const {
 
 void BoundedSenderQueueInterface::Reset(size_t cap, size_t low, size_t high) {
     deque<unique_ptr<SenderQueueItem>>().swap(mExtraBuffer);
+    mExtraBufferBytes = 0;
+    deque<SpilledItem>().swap(mSpilledItems);
+    if (mSpillBuffer) {
+        mSpillBuffer = CreateSpillBuffer(mSpillDir, mKey);
+    }
     mRateLimiter.reset();
+    mRateLimiters.clear();
+    mIsRateLimited = false;
     mConcurrencyLimiters.clear();
     BoundedQueueInterface::Reset(low, high);
     QueueInterface::Reset(cap);
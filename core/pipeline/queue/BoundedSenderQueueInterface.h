@@ -19,6 +19,7 @@
 #include <memory>
 #include <optional>
 #include <queue>
+#include <string>
 #include <vector>
 #include <unordered_map>
 
@@ -28,6 +29,7 @@
 #include "pipeline/queue/BoundedQueueInterface.h"
 #include "pipeline/queue/QueueKey.h"
 #include "pipeline/queue/SenderQueueItem.h"
+#include "pipeline/queue/SpillFile.h"
 
 namespace logtail {
 
@@ -50,12 +52,27 @@ public:
     void DecreaseSendingCnt();
     void OnSendingSuccess();
     void SetRateLimiter(uint32_t maxRate);
+    void SetRateLimiters(std::unordered_map<std::string, std::shared_ptr<RateLimiter>>&& rateLimitersMap);
     void SetConcurrencyLimiters(std::unordered_map<std::string, std::shared_ptr<ConcurrencyLimiter>>&& concurrencyLimitersMap);
     virtual void SetPipelineForItems(const std::shared_ptr<Pipeline>& p) const = 0;
+    // whether the last GetAvailableItems stopped fetching because of rate limiters
+    bool IsRateLimited() const { return mIsRateLimited; }
+
+    // once the payloads of items beyond the capacity exceed the memory watermark, further payloads are spilled to
+    // files in dir, and the queue stays valid to push until the spill reaches its byte limit
+    void EnableSpill(const std::string& dir);
+    bool IsValidToPush() const override;
+    // returns the spill buffer if it has file I/O to do, which should be done by the caller after releasing the queue
+    // manager lock and followed by FillFromExtraBuffer
+    std::shared_ptr<SpillBuffer> GetSpillBufferWithPendingIO() const;
+    const std::shared_ptr<SpillBuffer>& GetSpillBuffer() const { return mSpillBuffer; }
+    // moves items beyond the capacity into free slots, which are left when spilled payloads are not loaded in time
+    virtual void FillFromExtraBuffer() {}
 
 #ifdef APSARA_UNIT_TEST_MAIN
     std::optional<RateLimiter>& GetRateLimiter() { return mRateLimiter; }
     std::vector<std::pair<std::shared_ptr<ConcurrencyLimiter>, CounterPtr>>& GetConcurrencyLimiters() { return mConcurrencyLimiters; }
+    std::vector<std::pair<std::shared_ptr<RateLimiter>, CounterPtr>>& GetRateLimiters() { return mRateLimiters; }
 #endif
 
 protected:
@@ -63,19 +80,48 @@ protected:
 
     void GiveFeedback() const override;
     void Reset(size_t cap, size_t low, size_t high);
-
+    bool IsValidToPopByRateLimiters();
+    void PostPopByRateLimiters(size_t size);
+    void PushToExtraBuffer(std::unique_ptr<SenderQueueItem>&& item);
+    // returns the oldest item beyond the capacity with its payload loaded, or nullptr if there is none. Spilled items
+    // that are too old or cannot be read back are discarded.
+    std::unique_ptr<SenderQueueItem> PopFromExtraBuffer();
+    bool HasExtraItems() const { return !mExtraBuffer.empty() || !mSpilledItems.empty(); }
+
+    // logstore level limiter, owned by the queue
     std::optional<RateLimiter> mRateLimiter;
+    // global and region level limiters, shared among queues
+    std::vector<std::pair<std::shared_ptr<RateLimiter>, CounterPtr>> mRateLimiters;
+    bool mIsRateLimited = false;
     std::vector<std::pair<std::shared_ptr<ConcurrencyLimiter>, CounterPtr>> mConcurrencyLimiters;
 
     std::deque<std::unique_ptr<SenderQueueItem>> mExtraBuffer;
+    size_t mExtraBufferBytes = 0;
+
+    struct SpilledItem {
+        std::unique_ptr<SenderQueueItem> mItem;
+        // id of the payload in mSpillBuffer, 0 if the payload is still in memory, which happens when the spill is full
+        uint64_t mSpillId = 0;
+    };
+    // all spilled items are newer than those in mExtraBuffer, so that items are sent in the order they are pushed
+    std::deque<SpilledItem> mSpilledItems;
+    // shared with callers doing its file I/O, which may outlive the queue or a reset
+    std::shared_ptr<SpillBuffer> mSpillBuffer;
+    std::string mSpillDir;
+    uint64_t mNextSpillId = 1;
 
     IntGaugePtr mExtraBufferSize;
     IntGaugePtr mExtraBufferDataSizeBytes;
     CounterPtr mFetchRejectedByRateLimiterTimesCnt;
+    CounterPtr mSpilledItemsTotal;
+    CounterPtr mSpillDiscardedItemsTotal;
+    IntGaugePtr mSpillSizeBytes;
 
 private:
     virtual void PushFromExtraBuffer(std::unique_ptr<SenderQueueItem>&& item) = 0;
 
+    void UpdateExtraBufferMetrics();
+
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class FlusherUnittest;
 #endif
@@ -210,6 +210,16 @@ bool ExactlyOnceQueueManager::IsAllSenderQueueEmpty() const {
     return true;
 }
 
+bool ExactlyOnceQueueManager::IsSenderQueueRateLimited() const {
+    lock_guard<mutex> lock(mSenderQueueMux);
+    for (const auto& q : mSenderQueues) {
+        if (q.second.IsRateLimited()) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void ExactlyOnceQueueManager::ClearTimeoutQueues() {
     auto const curTime = time(nullptr);
     const auto startTimeMs = GetCurrentTimeInMilliSeconds();
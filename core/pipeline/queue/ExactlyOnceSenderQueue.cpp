@@ -18,6 +18,7 @@
 
 #include "logger/Logger.h"
 #include "pipeline/queue/SLSSenderQueueItem.h"
+#include "pipeline/queue/SenderQueueManager.h"
 #include "plugin/flusher/sls/FlusherSLS.h"
 
 using namespace std;
@@ -44,8 +45,10 @@ bool ExactlyOnceSenderQueue::Push(unique_ptr<SenderQueueItem>&& item) {
     if (!mIsInitialised) {
         const auto f = static_cast<const FlusherSLS*>(item->mFlusher);
         if (f->mMaxSendRate > 0) {
-            mRateLimiter = RateLimiter(f->mMaxSendRate);
+            mRateLimiter.emplace(f->mMaxSendRate);
         }
+        SetRateLimiters({{"global", SenderQueueManager::GetInstance()->GetGlobalRateLimiter()},
+                         {"region", FlusherSLS::GetRegionRateLimiter(f->mRegion)}});
         mConcurrencyLimiters.emplace_back(
             FlusherSLS::GetRegionConcurrencyLimiter(f->mRegion),
             mMetricsRecordRef.CreateCounter(ConcurrencyLimiter::GetLimiterMetricName("region")));
@@ -119,6 +122,7 @@ bool ExactlyOnceSenderQueue::Remove(SenderQueueItem* item) {
 }
 
 void ExactlyOnceSenderQueue::GetAvailableItems(vector<SenderQueueItem*>& items, int32_t limit) {
+    mIsRateLimited = false;
     if (Empty()) {
         return;
     }
@@ -142,7 +146,7 @@ void ExactlyOnceSenderQueue::GetAvailableItems(vector<SenderQueueItem*>& items,
         if (limit == 0) {
             return;
         }
-        if (mRateLimiter && !mRateLimiter->IsValidToPop()) {
+        if (!IsValidToPopByRateLimiters()) {
             return;
         }
         for (auto& limiter : mConcurrencyLimiters) {
@@ -159,9 +163,7 @@ void ExactlyOnceSenderQueue::GetAvailableItems(vector<SenderQueueItem*>& items,
                     limiter.first->PostPop();
                 }
             }
-            if (mRateLimiter) {
-                mRateLimiter->PostPop(item->mRawSize);
-            }
+            PostPopByRateLimiters(item->mRawSize);
         }
     }
 }
@@ -110,6 +110,9 @@ bool ProcessQueueManager::IsValidToPush(QueueKey key) const {
 }
 
 int ProcessQueueManager::PushQueue(QueueKey key, unique_ptr<ProcessQueueItem>&& item) {
+    if (item->mEventGroup.GetLatencyTrace()) {
+        item->mEventGroup.GetLatencyTrace()->Stamp(LatencyStage::PROCESS_QUEUE_PUSH);
+    }
     {
         lock_guard<mutex> lock(mQueueMux);
         auto iter = mQueues.find(key);
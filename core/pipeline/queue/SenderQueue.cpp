@@ -27,6 +27,7 @@ SenderQueue::SenderQueue(
     mFetchTimesCnt = mMetricsRecordRef.CreateCounter(METRIC_COMPONENT_QUEUE_FETCH_TIMES_TOTAL);
     mValidFetchTimesCnt = mMetricsRecordRef.CreateCounter(METRIC_COMPONENT_QUEUE_VALID_FETCH_TIMES_TOTAL);
     mFetchedItemsCnt = mMetricsRecordRef.CreateCounter(METRIC_COMPONENT_QUEUE_FETCHED_ITEMS_TOTAL);
+    mTotalFetchWaitMs = mMetricsRecordRef.CreateTimeCounter(METRIC_COMPONENT_QUEUE_TOTAL_FETCH_WAIT_MS);
     WriteMetrics::GetInstance()->CommitMetricsRecordRef(mMetricsRecordRef);
 }
 
@@ -37,11 +38,10 @@ bool SenderQueue::Push(unique_ptr<SenderQueueItem>&& item) {
     mInItemsTotal->Add(1);
     mInItemDataSizeBytes->Add(size);
 
-    if (Full()) {
-        mExtraBuffer.push_back(std::move(item));
-
-        mExtraBufferSize->Set(mExtraBuffer.size());
-        mExtraBufferDataSizeBytes->Add(size);
+    // items beyond the capacity go first, even if there are free slots left by spilled items not loaded yet
+    if (Full() || HasExtraItems()) {
+        PushToExtraBuffer(std::move(item));
+        mValidToPushFlag->Set(IsValidToPush());
         return true;
     }
 
@@ -92,13 +92,21 @@ bool SenderQueue::Remove(SenderQueueItem* item) {
     mTotalDelayMs->Add(chrono::system_clock::now() - enQueuTime);
     mQueueDataSizeByte->Sub(size);
 
-    if (!mExtraBuffer.empty()) {
-        auto newSize = mExtraBuffer.front()->mData.size();
-        PushFromExtraBuffer(std::move(mExtraBuffer.front()));
-        mExtraBuffer.pop_front();
-
-        mExtraBufferSize->Set(mExtraBuffer.size());
-        mExtraBufferDataSizeBytes->Sub(newSize);
+    bool validToPush = IsValidToPush();
+    auto extraItem = PopFromExtraBuffer();
+    if (extraItem) {
+        PushFromExtraBuffer(std::move(extraItem));
+        // reading back a spilled item frees space in the spill
+        if (!validToPush && IsValidToPush()) {
+            GiveFeedback();
+        }
+        mValidToPushFlag->Set(IsValidToPush());
+        return true;
+    }
+    if (HasExtraItems()) {
+        // the spilled payload is not loaded yet, and the slot is left for FillFromExtraBuffer
+        mQueueSizeTotal->Set(Size());
+        mValidToPushFlag->Set(IsValidToPush());
         return true;
     }
     if (ChangeStateIfNeededAfterPop()) {
@@ -110,11 +118,61 @@ bool SenderQueue::Remove(SenderQueueItem* item) {
     return true;
 }
 
+void SenderQueue::FillFromExtraBuffer() {
+    bool validToPush = IsValidToPush();
+    while (!Full()) {
+        auto extraItem = PopFromExtraBuffer();
+        if (!extraItem) {
+            break;
+        }
+        PushFromExtraBuffer(std::move(extraItem));
+    }
+    if (!validToPush && IsValidToPush()) {
+        GiveFeedback();
+    }
+    mValidToPushFlag->Set(IsValidToPush());
+}
+
 void SenderQueue::GetAvailableItems(vector<SenderQueueItem*>& items, int32_t limit) {
+    FetchItems(items, limit, false);
+}
+
+void SenderQueue::GetAvailableItems(vector<SenderQueueItem*>& items, int32_t limit, int64_t quantum) {
+    // credit the queue only when it has some item to send, and never beyond what is needed for the first idle item,
+    // otherwise a queue blocked by limiters would accumulate credits and burst afterwards
+    SenderQueueItem* head = nullptr;
+    for (auto index = mRead; index < mWrite; ++index) {
+        SenderQueueItem* item = mQueue[index % mCapacity].get();
+        if (item != nullptr && item->mStatus.load() == SendingStatus::IDLE) {
+            head = item;
+            break;
+        }
+    }
+    if (head == nullptr) {
+        mDeficitBytes = 0;
+        mIsDeficitLimited = false;
+        mIsRateLimited = false;
+        mFetchTimesCnt->Add(1);
+        return;
+    }
+    int64_t credit = quantum * mWeight;
+    mDeficitBytes = min(mDeficitBytes + credit, max(credit, static_cast<int64_t>(head->mData.size())));
+    FetchItems(items, limit, true);
+}
+
+void SenderQueue::SetSchedulingParam(uint32_t weight, uint32_t priority) {
+    mWeight = max(weight, 1U);
+    mPriority = priority;
+}
+
+void SenderQueue::FetchItems(vector<SenderQueueItem*>& items, int32_t limit, bool useDeficit) {
     mFetchTimesCnt->Add(1);
+    mIsRateLimited = false;
+    mIsDeficitLimited = false;
     if (Empty()) {
         return;
     }
+    auto curTime = chrono::system_clock::now();
     bool hasAvailableItem = false;
     if (limit < 0) {
         for (auto index = mRead; index < mWrite; ++index) {
@@ -130,6 +188,7 @@ void SenderQueue::GetAvailableItems(vector<SenderQueueItem*>& items, int32_t lim
             }
         }
     } else {
+        bool hasIdleItemLeft = false;
         for (auto index = mRead; index < mWrite; ++index) {
             SenderQueueItem* item = mQueue[index % mCapacity].get();
             if (item == nullptr) {
@@ -139,11 +198,15 @@ void SenderQueue::GetAvailableItems(vector<SenderQueueItem*>& items, int32_t lim
                 continue;
             }
             hasAvailableItem = true;
+            hasIdleItemLeft = true;
             if (limit == 0) {
                 break;
             }
-            if (mRateLimiter && !mRateLimiter->IsValidToPop()) {
-                mFetchRejectedByRateLimiterTimesCnt->Add(1);
+            if (useDeficit && static_cast<int64_t>(item->mData.size()) > mDeficitBytes) {
+                mIsDeficitLimited = true;
+                break;
+            }
+            if (!IsValidToPopByRateLimiters()) {
                 break;
             }
             bool rejectedByConcurrencyLimiter = false;
@@ -159,6 +222,9 @@ void SenderQueue::GetAvailableItems(vector<SenderQueueItem*>& items, int32_t lim
             }
 
             mFetchedItemsCnt->Add(1);
+            if (item->mTryCnt == 1) {
+                mTotalFetchWaitMs->Add(curTime - item->mFirstEnqueTime);
+            }
             item->mStatus = SendingStatus::SENDING;
             items.emplace_back(item);
             for (auto& limiter : mConcurrencyLimiters) {
@@ -166,10 +232,16 @@ void SenderQueue::GetAvailableItems(vector<SenderQueueItem*>& items, int32_t lim
                     limiter.first->PostPop();
                 }
             }
-            if (mRateLimiter) {
-                mRateLimiter->PostPop(item->mRawSize);
+            PostPopByRateLimiters(item->mRawSize);
+            if (useDeficit) {
+                mDeficitBytes -= item->mData.size();
             }
             --limit;
+            hasIdleItemLeft = false;
+        }
+        if (useDeficit && !hasIdleItemLeft) {
+            // standard DRR: an idle queue should not keep its credits
+            mDeficitBytes = 0;
         }
     }
     if (hasAvailableItem) {
@@ -195,6 +267,11 @@ void SenderQueue::SetPipelineForItems(const std::shared_ptr<Pipeline>& p) const
             item->mPipeline = p;
         }
     }
+    for (auto& item : mSpilledItems) {
+        if (!item.mItem->mPipeline) {
+            item.mItem->mPipeline = p;
+        }
+    }
 }
 
 void SenderQueue::PushFromExtraBuffer(std::unique_ptr<SenderQueueItem>&& item) {
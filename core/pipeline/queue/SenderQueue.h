@@ -36,20 +36,37 @@ public:
     bool Push(std::unique_ptr<SenderQueueItem>&& item) override;
     bool Remove(SenderQueueItem* item) override;
     void GetAvailableItems(std::vector<SenderQueueItem*>& items, int32_t limit) override;
+    // deficit round robin: called once per scheduling round, quantum * weight bytes are credited to the queue, and
+    // items are fetched as long as the accumulated deficit covers their size
+    void GetAvailableItems(std::vector<SenderQueueItem*>& items, int32_t limit, int64_t quantum);
     void SetPipelineForItems(const std::shared_ptr<Pipeline>& p) const override;
+    void FillFromExtraBuffer() override;
+
+    void SetSchedulingParam(uint32_t weight, uint32_t priority);
+    uint32_t GetWeight() const { return mWeight; }
+    uint32_t GetPriority() const { return mPriority; }
+    // whether the last GetAvailableItems stopped fetching because the deficit is not enough for the next item
+    bool IsDeficitLimited() const { return mIsDeficitLimited; }
 
 private:
     size_t Size() const override { return mSize; }
     void PushFromExtraBuffer(std::unique_ptr<SenderQueueItem>&& item) override;
+    void FetchItems(std::vector<SenderQueueItem*>& items, int32_t limit, bool useDeficit);
 
     std::vector<std::unique_ptr<SenderQueueItem>> mQueue;
     size_t mWrite = 0;
     size_t mRead = 0;
     size_t mSize = 0;
 
+    uint32_t mWeight = 1;
+    uint32_t mPriority = 1;
+    int64_t mDeficitBytes = 0;
+    bool mIsDeficitLimited = false;
+
     CounterPtr mFetchTimesCnt;
     CounterPtr mValidFetchTimesCnt;
     CounterPtr mFetchedItemsCnt;
+    TimeCounterPtr mTotalFetchWaitMs;
 
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class SenderQueueUnittest;
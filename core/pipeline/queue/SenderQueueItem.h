@@ -22,6 +22,7 @@
 #include <memory>
 #include <string>
 
+#include "models/LatencyTrace.h"
 #include "pipeline/queue/QueueKey.h"
 
 namespace logtail {
@@ -45,6 +46,7 @@ struct SenderQueueItem {
     std::chrono::system_clock::time_point mFirstEnqueTime;
     std::chrono::system_clock::time_point mLastSendTime;
     uint32_t mTryCnt = 1;
+    LatencyTracePtr mLatencyTrace; // only set for items containing a group sampled for latency tracing
 
     SenderQueueItem(std::string&& data,
                     size_t rawSize,
@@ -73,7 +75,8 @@ struct SenderQueueItem {
           mStatus(item.mStatus.load()),
           mFirstEnqueTime(item.mFirstEnqueTime),
           mLastSendTime(item.mLastSendTime),
-          mTryCnt(item.mTryCnt) {}
+          mTryCnt(item.mTryCnt),
+          mLatencyTrace(item.mLatencyTrace) {}
 
     virtual SenderQueueItem* Clone() { return new SenderQueueItem(*this); }
 };
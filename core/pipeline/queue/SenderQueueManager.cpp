@@ -14,18 +14,28 @@
 
 #include "pipeline/queue/SenderQueueManager.h"
 
+#include "app_config/AppConfig.h"
+#include "common/FileSystemUtil.h"
 #include "common/Flags.h"
 #include "pipeline/queue/ExactlyOnceQueueManager.h"
+#include "pipeline/queue/ProcessQueueManager.h"
 #include "pipeline/queue/QueueKeyManager.h"
 
 DEFINE_FLAG_INT32(sender_queue_gc_threshold_sec, "30s", 30);
 DEFINE_FLAG_INT32(sender_queue_capacity, "", 15);
+DEFINE_FLAG_INT32(sender_queue_drr_quantum_bytes,
+                  "bytes credited to a sender queue of weight 1 in each deficit round robin round",
+                  256 * 1024);
+DEFINE_FLAG_BOOL(enable_sender_queue_spill,
+                 "spill payloads overflowing sender queues to disk instead of blocking upstream queues",
+                 false);
 
 using namespace std;
 
 namespace logtail {
 
-SenderQueueManager::SenderQueueManager() : mDefaultQueueParam(INT32_FLAG(sender_queue_capacity), 1.0) {
+SenderQueueManager::SenderQueueManager()
+    : mDefaultQueueParam(INT32_FLAG(sender_queue_capacity), 1.0), mGlobalRateLimiter(make_shared<RateLimiter>(0)) {
 }
 
 bool SenderQueueManager::CreateQueue(
@@ -33,7 +43,8 @@ bool SenderQueueManager::CreateQueue(
     const string& flusherId,
     const PipelineContext& ctx,
     std::unordered_map<std::string, std::shared_ptr<ConcurrencyLimiter>>&& concurrencyLimitersMap,
-    uint32_t maxRate) {
+    uint32_t maxRate,
+    std::unordered_map<std::string, std::shared_ptr<RateLimiter>>&& rateLimitersMap) {
     lock_guard<mutex> lock(mQueueMux);
     auto iter = mQueues.find(key);
     if (iter == mQueues.end()) {
@@ -46,8 +57,14 @@ bool SenderQueueManager::CreateQueue(
                             ctx);
         iter = mQueues.find(key);
     }
+    if (BOOL_FLAG(enable_sender_queue_spill)) {
+        iter->second.EnableSpill(GetSpillDir());
+    }
     iter->second.SetConcurrencyLimiters(std::move(concurrencyLimitersMap));
     iter->second.SetRateLimiter(maxRate);
+    iter->second.SetSchedulingParam(ctx.GetGlobalConfig().mSendWeight, ctx.GetGlobalConfig().mPriority);
+    rateLimitersMap["global"] = mGlobalRateLimiter;
+    iter->second.SetRateLimiters(std::move(rateLimitersMap));
     return true;
 }
 
@@ -89,6 +106,10 @@ bool SenderQueueManager::ReuseQueue(QueueKey key) {
 }
 
 int SenderQueueManager::PushQueue(QueueKey key, unique_ptr<SenderQueueItem>&& item) {
+    if (item->mLatencyTrace) {
+        item->mLatencyTrace->Stamp(LatencyStage::SENDER_QUEUE_PUSH);
+    }
+    shared_ptr<SpillBuffer> spillBuffer;
     {
         lock_guard<mutex> lock(mQueueMux);
         auto iter = mQueues.find(key);
@@ -96,6 +117,7 @@ int SenderQueueManager::PushQueue(QueueKey key, unique_ptr<SenderQueueItem>&& it
             if (!iter->second.Push(std::move(item))) {
                 return 1;
             }
+            spillBuffer = iter->second.GetSpillBufferWithPendingIO();
         } else {
             int res = ExactlyOnceQueueManager::GetInstance()->PushSenderQueue(key, std::move(item));
             if (res != 0) {
@@ -103,6 +125,9 @@ int SenderQueueManager::PushQueue(QueueKey key, unique_ptr<SenderQueueItem>&& it
             }
         }
     }
+    if (spillBuffer) {
+        DoSpillIO(key, spillBuffer);
+    }
     Trigger();
     return 0;
 }
@@ -110,6 +135,7 @@ int SenderQueueManager::PushQueue(QueueKey key, unique_ptr<SenderQueueItem>&& it
 void SenderQueueManager::GetAvailableItems(vector<SenderQueueItem*>& items, int32_t itemsCntLimit) {
     {
         lock_guard<mutex> lock(mQueueMux);
+        mIsRateLimited = false;
         if (mQueues.empty()) {
             return;
         }
@@ -118,34 +144,84 @@ void SenderQueueManager::GetAvailableItems(vector<SenderQueueItem*>& items, int3
                 iter->second.GetAvailableItems(items, -1);
             }
         } else {
-            int cntLimitPerQueue
-                = std::max((int)(mDefaultQueueParam.GetCapacity() * 0.3), (int)(itemsCntLimit / mQueues.size()));
-            // must check index before moving iterator
-            mSenderQueueBeginIndex = mSenderQueueBeginIndex % mQueues.size();
-            // here we set sender queue begin index, let the sender order be different each time
-            auto beginIter = mQueues.begin();
-            std::advance(beginIter, mSenderQueueBeginIndex++);
-
-            for (auto iter = beginIter; iter != mQueues.end(); ++iter) {
-                iter->second.GetAvailableItems(items, cntLimitPerQueue);
+            // queues with higher priority (i.e., smaller value) are scheduled first, and queues with the same priority
+            // share the sending window by deficit round robin, weighted by SendWeight of the pipeline
+            vector<SenderQueue*> priorityQueues[ProcessQueueManager::sMaxPriority + 1];
+            for (auto iter = mQueues.begin(); iter != mQueues.end(); ++iter) {
+                priorityQueues[min(iter->second.GetPriority(), ProcessQueueManager::sMaxPriority)].push_back(
+                    &iter->second);
             }
-            for (auto iter = mQueues.begin(); iter != beginIter; ++iter) {
-                iter->second.GetAvailableItems(items, cntLimitPerQueue);
+            int32_t remaining = itemsCntLimit;
+            const int64_t quantum = max(INT32_FLAG(sender_queue_drr_quantum_bytes), 1);
+            for (auto& queues : priorityQueues) {
+                if (queues.empty()) {
+                    continue;
+                }
+                // here we set sender queue begin index, let the sender order be different each time
+                size_t beginIndex = mSenderQueueBeginIndex % queues.size();
+                bool isDeficitLimited = true;
+                // keep scheduling rounds while some queue is only waiting for credits, so that the sending window is
+                // not left idle when there is only one busy queue
+                while (remaining > 0 && isDeficitLimited) {
+                    isDeficitLimited = false;
+                    for (size_t i = 0; i < queues.size() && remaining > 0; ++i) {
+                        auto queue = queues[(beginIndex + i) % queues.size()];
+                        size_t cnt = items.size();
+                        queue->GetAvailableItems(items, remaining, quantum);
+                        remaining -= static_cast<int32_t>(items.size() - cnt);
+                        isDeficitLimited |= queue->IsDeficitLimited();
+                        mIsRateLimited |= queue->IsRateLimited();
+                    }
+                }
             }
+            ++mSenderQueueBeginIndex;
         }
     }
     ExactlyOnceQueueManager::GetInstance()->GetAvailableSenderQueueItems(items, itemsCntLimit);
 }
 
 bool SenderQueueManager::RemoveItem(QueueKey key, SenderQueueItem* item) {
+    shared_ptr<SpillBuffer> spillBuffer;
+    bool found = false;
     {
         lock_guard<mutex> lock(mQueueMux);
         auto iter = mQueues.find(key);
         if (iter != mQueues.end()) {
-            return iter->second.Remove(item);
+            if (!iter->second.Remove(item)) {
+                return false;
+            }
+            found = true;
+            spillBuffer = iter->second.GetSpillBufferWithPendingIO();
+        }
+    }
+    if (!found) {
+        return ExactlyOnceQueueManager::GetInstance()->RemoveSenderQueueItem(key, item);
+    }
+    if (spillBuffer) {
+        DoSpillIO(key, spillBuffer);
+        // items loaded back are ready to send
+        Trigger();
+    }
+    return true;
+}
+
+void SenderQueueManager::DoSpillIO(QueueKey key, const shared_ptr<SpillBuffer>& spillBuffer) {
+    // file I/O is done without mQueueMux, so that other queues are not blocked by a slow disk
+    while (true) {
+        spillBuffer->Flush();
+        if (!spillBuffer->Load()) {
+            return;
+        }
+        lock_guard<mutex> lock(mQueueMux);
+        auto iter = mQueues.find(key);
+        if (iter == mQueues.end() || iter->second.GetSpillBuffer() != spillBuffer) {
+            return;
+        }
+        iter->second.FillFromExtraBuffer();
+        if (!spillBuffer->HasPendingIO()) {
+            return;
         }
     }
-    return ExactlyOnceQueueManager::GetInstance()->RemoveSenderQueueItem(key, item);
 }
 
 void SenderQueueManager::DecreaseConcurrencyLimiterInSendingCnt(QueueKey key) {
@@ -225,6 +301,20 @@ void SenderQueueManager::Trigger() {
     mCond.notify_one();
 }
 
+void SenderQueueManager::SetGlobalRateLimit(uint64_t maxRate, uint64_t burstBytes) {
+    mGlobalRateLimiter->SetMaxRate(maxRate, burstBytes);
+}
+
+bool SenderQueueManager::IsRateLimited() const {
+    {
+        lock_guard<mutex> lock(mQueueMux);
+        if (mIsRateLimited) {
+            return true;
+        }
+    }
+    return ExactlyOnceQueueManager::GetInstance()->IsSenderQueueRateLimited();
+}
+
 void SenderQueueManager::SetPipelineForItems(QueueKey key, const std::shared_ptr<Pipeline>& p) {
     lock_guard<mutex> lock(mQueueMux);
     auto iter = mQueues.find(key);
@@ -235,6 +325,24 @@ void SenderQueueManager::SetPipelineForItems(QueueKey key, const std::shared_ptr
     }
 }
 
+const string& SenderQueueManager::GetSpillDir() {
+    static const string sDir = [] {
+        string dir = PathJoin(GetAgentDataDir(), "sender_queue_spill");
+        // spilled payloads are loaded back before exit, so anything left belongs to a crashed process
+        fsutil::Dir d(dir);
+        if (d.Open()) {
+            fsutil::Entry entry;
+            while ((entry = d.ReadNext(false))) {
+                if (entry.IsRegFile()) {
+                    remove(PathJoin(dir, entry.Name()).c_str());
+                }
+            }
+        }
+        return dir;
+    }();
+    return sDir;
+}
+
 #ifdef APSARA_UNIT_TEST_MAIN
 void SenderQueueManager::Clear() {
     lock_guard<mutex> lock(mQueueMux);
@@ -39,6 +39,8 @@ public:
     SenderQueueManager(const SenderQueueManager&) = delete;
     SenderQueueManager& operator=(const SenderQueueManager&) = delete;
 
+    static constexpr uint32_t sMaxSendWeight = 100;
+
     static SenderQueueManager* GetInstance() {
         static SenderQueueManager instance;
         return &instance;
@@ -51,7 +53,9 @@ public:
                      const PipelineContext& ctx,
                      std::unordered_map<std::string, std::shared_ptr<ConcurrencyLimiter>>&& concurrencyLimitersMap
                      = std::unordered_map<std::string, std::shared_ptr<ConcurrencyLimiter>>(),
-                     uint32_t maxRate = 0);
+                     uint32_t maxRate = 0,
+                     std::unordered_map<std::string, std::shared_ptr<RateLimiter>>&& rateLimitersMap
+                     = std::unordered_map<std::string, std::shared_ptr<RateLimiter>>());
     SenderQueue* GetQueue(QueueKey key);
     bool DeleteQueue(QueueKey key);
     bool ReuseQueue(QueueKey key);
@@ -68,6 +72,12 @@ public:
     bool Wait(uint64_t ms);
     void Trigger();
 
+    // maxRate == 0 means unlimited
+    void SetGlobalRateLimit(uint64_t maxRate, uint64_t burstBytes = 0);
+    const std::shared_ptr<RateLimiter>& GetGlobalRateLimiter() const { return mGlobalRateLimiter; }
+    // whether some queue stopped fetching because of rate limiters in the last GetAvailableItems
+    bool IsRateLimited() const;
+
     // only used for go pipeline before flushing data to C++ flusher
     bool IsValidToPush(QueueKey key) const;
 
@@ -80,6 +90,9 @@ private:
     SenderQueueManager();
     ~SenderQueueManager() = default;
 
+    static const std::string& GetSpillDir();
+    void DoSpillIO(QueueKey key, const std::shared_ptr<SpillBuffer>& spillBuffer);
+
     BoundedQueueParam mDefaultQueueParam;
 
     mutable std::mutex mQueueMux;
@@ -88,7 +101,9 @@ private:
     mutable std::mutex mGCMux;
     std::unordered_map<QueueKey, time_t> mQueueDeletionTimeMap;
 
-    // RateLimiter mRateLimiter;
+    // shared by all sender queues, never reassigned after construction so that it can be read without lock
+    const std::shared_ptr<RateLimiter> mGlobalRateLimiter;
+    bool mIsRateLimited = false;
 
     mutable std::mutex mStateMux;
     mutable std::condition_variable mCond;
@@ -0,0 +1,206 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "pipeline/queue/SpillFile.h"
+
+#include <algorithm>
+
+#include "common/ErrorUtil.h"
+#include "common/FileSystemUtil.h"
+#include "common/StringTools.h"
+#include "logger/Logger.h"
+
+using namespace std;
+
+namespace logtail {
+
+SpillFile::SpillFile(const string& dir, const string& name, size_t maxSegmentSize)
+    : mDir(dir), mName(name), mMaxSegmentSize(maxSegmentSize) {
+}
+
+bool SpillFile::Write(const string& data) {
+    if (mSegments.empty()
+        || (mSegments.back().mWriteOffset > 0 && mSegments.back().mWriteOffset + data.size() > mMaxSegmentSize)) {
+        if (!AddSegment()) {
+            return false;
+        }
+    }
+    auto& segment = mSegments.back();
+    if (fseek(segment.mFile, static_cast<long>(segment.mWriteOffset), SEEK_SET) != 0
+        || fwrite(data.data(), 1, data.size(), segment.mFile) != data.size() || fflush(segment.mFile) != 0) {
+        LOG_WARNING(sLogger,
+                    ("failed to write spill file", segment.mPath)("error", ErrnoToString(GetErrno())));
+        // the partial payload is never read, since offsets are not advanced
+        return false;
+    }
+    segment.mWriteOffset += data.size();
+    mSize += data.size();
+    return true;
+}
+
+bool SpillFile::Read(size_t size, string& data) {
+    while (!mSegments.empty() && mSegments.front().mReadOffset == mSegments.front().mWriteOffset
+           && mSegments.size() > 1) {
+        RemoveFrontSegment();
+    }
+    if (mSegments.empty() || mSegments.front().mReadOffset + size > mSegments.front().mWriteOffset) {
+        return false;
+    }
+    auto& segment = mSegments.front();
+    data.resize(size);
+    bool res = fseek(segment.mFile, static_cast<long>(segment.mReadOffset), SEEK_SET) == 0
+        && fread(const_cast<char*>(data.data()), 1, size, segment.mFile) == size;
+    if (!res) {
+        LOG_WARNING(sLogger, ("failed to read spill file", segment.mPath)("error", ErrnoToString(GetErrno())));
+        data.clear();
+    }
+    // the payload is skipped even if it cannot be read, otherwise all following payloads would be blocked
+    segment.mReadOffset += size;
+    mSize -= size;
+    if (segment.mReadOffset == segment.mWriteOffset && mSegments.size() == 1) {
+        // reuse the only segment from the beginning instead of letting it grow
+        segment.mReadOffset = segment.mWriteOffset = 0;
+    }
+    return res;
+}
+
+void SpillFile::Clear() {
+    while (!mSegments.empty()) {
+        RemoveFrontSegment();
+    }
+    mSize = 0;
+}
+
+bool SpillFile::AddSegment() {
+    if (mSegments.empty() && !CheckExistance(mDir) && !Mkdirs(mDir)) {
+        LOG_WARNING(sLogger, ("failed to create spill dir", mDir)("error", ErrnoToString(GetErrno())));
+        return false;
+    }
+    Segment segment;
+    segment.mPath = PathJoin(mDir, mName + "_" + ToString(mNextSequence++));
+    segment.mFile = fopen(segment.mPath.c_str(), "wb+");
+    if (segment.mFile == nullptr) {
+        LOG_WARNING(sLogger,
+                    ("failed to create spill file", segment.mPath)("error", ErrnoToString(GetErrno())));
+        return false;
+    }
+    mSegments.push_back(std::move(segment));
+    return true;
+}
+
+void SpillFile::RemoveFrontSegment() {
+    auto& segment = mSegments.front();
+    fclose(segment.mFile);
+    remove(segment.mPath.c_str());
+    mSize -= segment.mWriteOffset - segment.mReadOffset;
+    mSegments.pop_front();
+}
+
+// payloads read ahead of Take by a single Load
+static const size_t kSpillLoadBatchSize = 8;
+
+atomic_size_t SpillBuffer::sTotalSize{0};
+
+void SpillBuffer::Stage(uint64_t id, string&& data) {
+    mSize += data.size();
+    sTotalSize += data.size();
+    lock_guard<mutex> lock(mMux);
+    mStaged.emplace_back(id, std::move(data));
+}
+
+SpillBuffer::TakeResult SpillBuffer::Take(uint64_t id, string& data) {
+    lock_guard<mutex> lock(mMux);
+    auto iter = mReady.find(id);
+    if (iter != mReady.end()) {
+        auto res = iter->second.mLost ? TakeResult::LOST : TakeResult::OK;
+        data.swap(iter->second.mData);
+        OnTaken(iter->second.mSize);
+        mReady.erase(iter);
+        // keep reading ahead
+        mIsLoadWanted = !mSpilled.empty();
+        return res;
+    }
+    // a payload not written yet is never written
+    auto staged = find_if(
+        mStaged.begin(), mStaged.end(), [id](const pair<uint64_t, string>& item) { return item.first == id; });
+    if (staged != mStaged.end()) {
+        data.swap(staged->second);
+        OnTaken(data.size());
+        mStaged.erase(staged);
+        return TakeResult::OK;
+    }
+    mIsLoadWanted = true;
+    return TakeResult::NOT_READY;
+}
+
+void SpillBuffer::Flush() {
+    lock_guard<mutex> ioLock(mIOMux);
+    while (true) {
+        deque<pair<uint64_t, string>> staged;
+        {
+            lock_guard<mutex> lock(mMux);
+            staged.swap(mStaged);
+        }
+        if (staged.empty()) {
+            return;
+        }
+        for (auto& item : staged) {
+            bool written = mFile.Write(item.second);
+            lock_guard<mutex> lock(mMux);
+            if (written) {
+                mSpilled.emplace_back(item.first, item.second.size());
+            } else {
+                auto& ready = mReady[item.first];
+                ready.mSize = item.second.size();
+                ready.mData.swap(item.second);
+            }
+        }
+    }
+}
+
+bool SpillBuffer::Load() {
+    lock_guard<mutex> ioLock(mIOMux);
+    deque<pair<uint64_t, size_t>> toLoad;
+    {
+        lock_guard<mutex> lock(mMux);
+        if (!mIsLoadWanted) {
+            return false;
+        }
+        mIsLoadWanted = false;
+        while (!mSpilled.empty() && toLoad.size() + mReady.size() < kSpillLoadBatchSize) {
+            toLoad.push_back(mSpilled.front());
+            mSpilled.pop_front();
+        }
+    }
+    for (const auto& item : toLoad) {
+        ReadyPayload ready;
+        ready.mSize = item.second;
+        ready.mLost = !mFile.Read(item.second, ready.mData);
+        lock_guard<mutex> lock(mMux);
+        mReady[item.first] = std::move(ready);
+    }
+    return !toLoad.empty();
+}
+
+bool SpillBuffer::HasPendingIO() const {
+    lock_guard<mutex> lock(mMux);
+    return !mStaged.empty() || (mIsLoadWanted && !mSpilled.empty());
+}
+
+void SpillBuffer::OnTaken(size_t size) {
+    mSize -= size;
+    sTotalSize -= size;
+}
+
+} // namespace logtail
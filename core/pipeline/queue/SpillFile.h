@@ -0,0 +1,127 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace logtail {
+
+// Append-only files holding payloads in FIFO order. Payloads are spread over segment files of limited size, and a
+// segment is removed as soon as all payloads in it are read, so that disk usage follows the backlog. The caller is
+// responsible for remembering the size of each payload. Not thread-safe.
+class SpillFile {
+public:
+    SpillFile(const std::string& dir, const std::string& name, size_t maxSegmentSize);
+    SpillFile(const SpillFile&) = delete;
+    SpillFile& operator=(const SpillFile&) = delete;
+    ~SpillFile() { Clear(); }
+
+    bool Write(const std::string& data);
+    // reads the oldest unread payload, which must be of the given size
+    bool Read(size_t size, std::string& data);
+    // removes all segments
+    void Clear();
+
+    // bytes written but not read yet
+    size_t Size() const { return mSize; }
+
+private:
+    struct Segment {
+        std::string mPath;
+        FILE* mFile = nullptr;
+        size_t mWriteOffset = 0;
+        size_t mReadOffset = 0;
+    };
+
+    bool AddSegment();
+    void RemoveFrontSegment();
+
+    std::string mDir;
+    std::string mName;
+    size_t mMaxSegmentSize = 0;
+    std::deque<Segment> mSegments;
+    uint64_t mNextSequence = 0;
+    size_t mSize = 0;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class SpillFileUnittest;
+#endif
+};
+
+// Payloads spilled by a sender queue, each identified by an id increasing in push order and taken back in the same
+// order. Stage and Take only move payloads in memory, so that they can be called under the queue manager lock, while
+// the file is only accessed by Flush and Load, which are called after the lock is released. Thread-safe.
+class SpillBuffer {
+public:
+    enum class TakeResult { OK, NOT_READY, LOST };
+
+    SpillBuffer(const std::string& dir, const std::string& name, size_t maxSegmentSize)
+        : mFile(dir, name, maxSegmentSize) {}
+    SpillBuffer(const SpillBuffer&) = delete;
+    SpillBuffer& operator=(const SpillBuffer&) = delete;
+    ~SpillBuffer() { sTotalSize -= mSize; }
+
+    void Stage(uint64_t id, std::string&& data);
+    // NOT_READY is returned if the payload is on disk or being written, and it should be loaded by Load then
+    TakeResult Take(uint64_t id, std::string& data);
+    // writes staged payloads to the file, payloads failed to write are kept in memory
+    void Flush();
+    // reads back payloads following the last one taken if some Take is waiting for them, returns true if any payload
+    // becomes ready to take
+    bool Load();
+    bool HasPendingIO() const;
+
+    // bytes staged or spilled but not taken yet
+    size_t Size() const { return mSize; }
+    // the same over all spill buffers in the process
+    static size_t TotalSize() { return sTotalSize; }
+
+private:
+    struct ReadyPayload {
+        std::string mData;
+        size_t mSize = 0;
+        bool mLost = false;
+    };
+
+    static std::atomic_size_t sTotalSize;
+
+    void OnTaken(size_t size);
+
+    mutable std::mutex mMux;
+    std::deque<std::pair<uint64_t, std::string>> mStaged;
+    // written to the file, in file order
+    std::deque<std::pair<uint64_t, size_t>> mSpilled;
+    std::unordered_map<uint64_t, ReadyPayload> mReady;
+    bool mIsLoadWanted = false;
+    std::atomic_size_t mSize{0};
+
+    // serializes Flush and Load, so that payloads are written and read in id order
+    std::mutex mIOMux;
+    SpillFile mFile;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class SenderQueueUnittest;
+#endif
+};
+
+} // namespace logtail
@@ -15,19 +15,100 @@
 #include "pipeline/serializer/SLSSerializer.h"
 
 #include "common/Flags.h"
+#include "common/Utf8Util.h"
 #include "constants/SpanConstants.h"
 #include "common/compression/CompressType.h"
 #include "plugin/flusher/sls/FlusherSLS.h"
+#include "prometheus/Constants.h"
 #include "protobuf/sls/LogGroupSerializer.h"
 #include <json/json.h>
 #include <array>
 
 DECLARE_FLAG_INT32(max_send_log_group_size);
+DEFINE_FLAG_BOOL(sls_serializer_replace_non_utf8,
+                 "replace bytes of invalid UTF-8 chars in log contents with spaces before serialization",
+                 false);
 
 using namespace std;
 
 namespace logtail {
 
+namespace {
+
+// SLS metricstore only accepts plain series, so compound metric values are flattened into one log per series, e.g.
+// a histogram becomes one <name>_bucket log for each bucket plus <name>_sum and <name>_count, and each value of
+// UntypedMultiDoubleValues becomes a <name>_<key> log
+struct MetricLogContent {
+    size_t mEventIdx = 0;
+    // empty if the name of the event is used as is
+    string mName;
+    string mValue;
+    StringView mExtraLabelKey;
+    string mExtraLabelValue;
+    size_t mLabelSZ = 0;
+    size_t mLogSZ = 0;
+};
+
+void AddMetricLogContent(vector<MetricLogContent>& res,
+                         size_t idx,
+                         const MetricEvent& e,
+                         const string& suffix,
+                         double value,
+                         StringView extraLabelKey = StringView(),
+                         string&& extraLabelValue = string()) {
+    auto& content = res.emplace_back();
+    content.mEventIdx = idx;
+    if (!suffix.empty()) {
+        content.mName.reserve(e.GetName().size() + suffix.size());
+        content.mName.append(e.GetName().data(), e.GetName().size()).append(suffix);
+    }
+    content.mValue = to_string(value);
+    content.mExtraLabelKey = extraLabelKey;
+    content.mExtraLabelValue = std::move(extraLabelValue);
+}
+
+bool FlattenMetricEvent(const MetricEvent& e, size_t idx, vector<MetricLogContent>& res) {
+    static const string sEmptySuffix;
+    if (e.Is<UntypedSingleValue>()) {
+        AddMetricLogContent(res, idx, e, sEmptySuffix, e.GetValue<UntypedSingleValue>()->mValue);
+    } else if (e.Is<UntypedMultiDoubleValues>()) {
+        for (const auto& [key, value] : e.GetValue<UntypedMultiDoubleValues>()->mValues) {
+            AddMetricLogContent(res, idx, e, "_" + key.to_string(), value);
+        }
+    } else if (e.Is<HistogramValue>()) {
+        const auto* v = e.GetValue<HistogramValue>();
+        for (const auto& bucket : v->mBuckets) {
+            AddMetricLogContent(res,
+                                idx,
+                                e,
+                                prometheus::BUCKET_SUFFIX,
+                                bucket.mCount,
+                                prometheus::BUCKET_LABEL,
+                                FormatMetricBoundary(bucket.mUpperBound));
+        }
+        AddMetricLogContent(res, idx, e, prometheus::SUM_SUFFIX, v->mSum);
+        AddMetricLogContent(res, idx, e, prometheus::COUNT_SUFFIX, v->mCount);
+    } else if (e.Is<SummaryValue>()) {
+        const auto* v = e.GetValue<SummaryValue>();
+        for (const auto& quantile : v->mQuantiles) {
+            AddMetricLogContent(res,
+                                idx,
+                                e,
+                                sEmptySuffix,
+                                quantile.mValue,
+                                prometheus::QUANTILE_LABEL,
+                                FormatMetricBoundary(quantile.mQuantile));
+        }
+        AddMetricLogContent(res, idx, e, prometheus::SUM_SUFFIX, v->mSum);
+        AddMetricLogContent(res, idx, e, prometheus::COUNT_SUFFIX, v->mCount);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
 std::string SerializeSpanLinksToString(const SpanEvent& event) {
     if (event.GetLinks().empty()) {
         return "";
@@ -64,7 +145,9 @@ bool Serializer<vector<CompressedLogGroup>>::DoSerialize(vector<CompressedLogGro
 
     auto before = std::chrono::system_clock::now();
     auto res = Serialize(std::move(p), output, errorMsg);
-    mTotalProcessMs->Add(std::chrono::system_clock::now() - before);
+    auto cost = std::chrono::system_clock::now() - before;
+    mTotalProcessMs->Add(cost);
+    mProcessLatencyUs->Add(cost);
 
     if (res) {
         mOutItemsTotal->Add(1);
@@ -93,16 +176,19 @@ bool SLSEventGroupSerializer::Serialize(BatchedEvents&& group, string& res, stri
 
     // caculate serialized logGroup size first, where some critical results can be cached
     vector<size_t> logSZ(group.mEvents.size());
-    vector<pair<string, size_t>> metricEventContentCache(group.mEvents.size());
+    vector<MetricLogContent> metricEventContentCache;
     vector<array<string, 6>> spanEventContentCache(group.mEvents.size());
     size_t logGroupSZ = 0;
     switch (eventType) {
         case PipelineEvent::Type::LOG:{
             for (size_t i = 0; i < group.mEvents.size(); ++i) {
-                const auto& e = group.mEvents[i].Cast<LogEvent>();
+                auto& e = group.mEvents[i].Cast<LogEvent>();
                 if (e.Empty()) {
                     continue;
                 }
+                if (BOOL_FLAG(sls_serializer_replace_non_utf8)) {
+                    ReplaceNonUtf8Contents(e);
+                }
                 size_t contentSZ = 0;
                 for (const auto& kv : e) {
                     contentSZ += GetLogContentSize(kv.first.size(), kv.second.size());
@@ -112,27 +198,30 @@ bool SLSEventGroupSerializer::Serialize(BatchedEvents&& group, string& res, stri
             break;
         }
         case PipelineEvent::Type::METRIC:{
+            metricEventContentCache.reserve(group.mEvents.size());
             for (size_t i = 0; i < group.mEvents.size(); ++i) {
                 const auto& e = group.mEvents[i].Cast<MetricEvent>();
-                if (e.Is<UntypedSingleValue>()) {
-                    metricEventContentCache[i].first = to_string(e.GetValue<UntypedSingleValue>()->mValue);
-                } else {
+                size_t begin = metricEventContentCache.size();
+                if (!FlattenMetricEvent(e, i, metricEventContentCache)) {
                     // should not happen
                     LOG_ERROR(sLogger,
                               ("unexpected error",
                                "invalid metric event type")("config", mFlusher->GetContext().GetConfigName()));
                     continue;
                 }
-                metricEventContentCache[i].second = GetMetricLabelSize(e);
+                for (size_t j = begin; j < metricEventContentCache.size(); ++j) {
+                    auto& content = metricEventContentCache[j];
+                    content.mLabelSZ = GetMetricLabelSize(e, content.mExtraLabelKey, content.mExtraLabelValue);
 
-                size_t contentSZ = 0;
-                contentSZ += GetLogContentSize(METRIC_RESERVED_KEY_NAME.size(), e.GetName().size());
-                contentSZ
-                    += GetLogContentSize(METRIC_RESERVED_KEY_VALUE.size(), metricEventContentCache[i].first.size());
-                contentSZ
-                    += GetLogContentSize(METRIC_RESERVED_KEY_TIME_NANO.size(), e.GetTimestampNanosecond() ? 19U : 10U);
-                contentSZ += GetLogContentSize(METRIC_RESERVED_KEY_LABELS.size(), metricEventContentCache[i].second);
-                logGroupSZ += GetLogSize(contentSZ, false, logSZ[i]);
+                    size_t contentSZ = 0;
+                    contentSZ += GetLogContentSize(METRIC_RESERVED_KEY_NAME.size(),
+                                                   content.mName.empty() ? e.GetName().size() : content.mName.size());
+                    contentSZ += GetLogContentSize(METRIC_RESERVED_KEY_VALUE.size(), content.mValue.size());
+                    contentSZ += GetLogContentSize(METRIC_RESERVED_KEY_TIME_NANO.size(),
+                                                   e.GetTimestampNanosecond() ? 19U : 10U);
+                    contentSZ += GetLogContentSize(METRIC_RESERVED_KEY_LABELS.size(), content.mLabelSZ);
+                    logGroupSZ += GetLogSize(contentSZ, false, content.mLogSZ);
+                }
             }
             break;
         }
@@ -232,17 +321,16 @@ bool SLSEventGroupSerializer::Serialize(BatchedEvents&& group, string& res, stri
             }
             break;
         case PipelineEvent::Type::METRIC:
-            for (size_t i = 0; i < group.mEvents.size(); ++i) {
-                const auto& e = group.mEvents[i].Cast<MetricEvent>();
-                if (e.Is<std::monostate>()) {
-                    continue;
-                }
-                serializer.StartToAddLog(logSZ[i]);
+            for (const auto& content : metricEventContentCache) {
+                const auto& e = group.mEvents[content.mEventIdx].Cast<MetricEvent>();
+                serializer.StartToAddLog(content.mLogSZ);
                 serializer.AddLogTime(e.GetTimestamp());
-                serializer.AddLogContentMetricLabel(e, metricEventContentCache[i].second);
+                serializer.AddLogContentMetricLabel(
+                    e, content.mLabelSZ, content.mExtraLabelKey, content.mExtraLabelValue);
                 serializer.AddLogContentMetricTimeNano(e);
-                serializer.AddLogContent(METRIC_RESERVED_KEY_VALUE, metricEventContentCache[i].first);
-                serializer.AddLogContent(METRIC_RESERVED_KEY_NAME, e.GetName());
+                serializer.AddLogContent(METRIC_RESERVED_KEY_VALUE, content.mValue);
+                serializer.AddLogContent(METRIC_RESERVED_KEY_NAME,
+                                         content.mName.empty() ? e.GetName() : StringView(content.mName));
             }
             break;
         case PipelineEvent::Type::SPAN:
@@ -59,6 +59,7 @@ public:
         mOutItemsTotal = mMetricsRecordRef.CreateCounter(METRIC_COMPONENT_OUT_ITEMS_TOTAL);
         mOutItemSizeBytes = mMetricsRecordRef.CreateCounter(METRIC_COMPONENT_OUT_SIZE_BYTES);
         mTotalProcessMs = mMetricsRecordRef.CreateTimeCounter(METRIC_COMPONENT_TOTAL_PROCESS_TIME_MS);
+        mProcessLatencyUs = mMetricsRecordRef.CreateHistogram(METRIC_COMPONENT_PROCESS_LATENCY_US);
         mDiscardedItemsTotal = mMetricsRecordRef.CreateCounter(METRIC_COMPONENT_DISCARDED_ITEMS_TOTAL);
         mDiscardedItemSizeBytes = mMetricsRecordRef.CreateCounter(METRIC_COMPONENT_DISCARDED_SIZE_BYTES);
     }
@@ -71,7 +72,9 @@ public:
 
         auto before = std::chrono::system_clock::now();
         auto res = Serialize(std::move(p), output, errorMsg);
-        mTotalProcessMs->Add(std::chrono::system_clock::now() - before);
+        auto cost = std::chrono::system_clock::now() - before;
+        mTotalProcessMs->Add(cost);
+        mProcessLatencyUs->Add(cost);
 
         if (res) {
             mOutItemsTotal->Add(1);
@@ -95,6 +98,7 @@ protected:
     CounterPtr mDiscardedItemsTotal;
     CounterPtr mDiscardedItemSizeBytes;
     TimeCounterPtr mTotalProcessMs;
+    HistogramPtr mProcessLatencyUs;
 
 private:
     virtual bool Serialize(T&& p, std::string& res, std::string& errorMsg) = 0;
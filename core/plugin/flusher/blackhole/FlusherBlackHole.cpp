@@ -30,7 +30,9 @@ bool FlusherBlackHole::Init(const Json::Value& config, Json::Value& optionalGoPi
 }
 
 bool FlusherBlackHole::Send(PipelineEventGroup&& g) {
-    return PushToQueue(make_unique<SenderQueueItem>("", 0, this, mQueueKey));
+    auto item = make_unique<SenderQueueItem>("", 0, this, mQueueKey);
+    item->mLatencyTrace = g.GetLatencyTrace();
+    return PushToQueue(std::move(item));
 }
 
 } // namespace logtail
@@ -14,6 +14,8 @@
 
 #include "plugin/flusher/sls/DiskBufferWriter.h"
 
+#include <atomic>
+
 #include "app_config/AppConfig.h"
 #include "application/Application.h"
 #include "common/CompressTools.h"
@@ -41,6 +43,10 @@ DEFINE_FLAG_INT32(quota_exceed_wait_interval, "when daemon buffer thread get quo
 DEFINE_FLAG_INT32(secondary_buffer_count_limit, "data ready for write buffer file", 20);
 DEFINE_FLAG_INT32(send_retry_sleep_interval, "sleep microseconds when sync send fail, 50ms", 50000);
 DEFINE_FLAG_INT32(buffer_check_period, "check logtail local storage buffer period", 60);
+DEFINE_FLAG_INT32(disk_buffer_replay_thread_count, "number of disk buffer segments replayed concurrently", 2);
+DEFINE_FLAG_INT32(disk_buffer_replay_commit_batch,
+                  "max number of records sent before the replayed offset of a disk buffer segment is persisted",
+                  64);
 
 using namespace std;
 
@@ -48,10 +54,16 @@ namespace logtail {
 
 const int32_t DiskBufferWriter::BUFFER_META_BASE_SIZE = 65536;
 
+static const string kWalSegmentPrefix = "disk_buffer_segment_";
+
 void DiskBufferWriter::Init() {
     mBufferDivideTime = time(NULL);
     mCheckPeriod = INT32_FLAG(buffer_check_period);
     SetBufferFilePath(AppConfig::GetInstance()->GetBufferFilePath());
+    mWal.Init(GetBufferFilePath(),
+              kWalSegmentPrefix,
+              AppConfig::GetInstance()->GetLocalFileSize(),
+              AppConfig::GetInstance()->GetNumOfBufferFile());
 
     mBufferSenderThreadRes = async(launch::async, &DiskBufferWriter::BufferSenderThread, this);
     mBufferWriterThreadRes = async(launch::async, &DiskBufferWriter::BufferWriterThread, this);
@@ -75,6 +87,7 @@ void DiskBufferWriter::Stop() {
             LOG_WARNING(sLogger, ("disk buffer writer", "forced to stopped"));
         }
     }
+    mWal.Stop();
     {
         // timeout should be larger than network timeout, which is 15 for now
         future_status s = mBufferSenderThreadRes.wait_for(chrono::seconds(20));
@@ -125,9 +138,9 @@ void DiskBufferWriter::BufferWriterThread() {
             }
         }
 
-        // update bufferDiveideTime to flush data; buffer file before bufferDiveideTime will be ready for read
+        // segments sealed before mBufferDivideTime are ready for replay
         if (time(NULL) - mBufferDivideTime > INT32_FLAG(buffer_file_alive_interval)) {
-            CreateNewFile();
+            SealSegment();
         }
 
         if (!res.empty()) {
@@ -136,8 +149,16 @@ void DiskBufferWriter::BufferWriterThread() {
                 delete *itr;
             }
             res.clear();
+            // group commit
+            if (!mWal.Sync()) {
+                string errorStr = ErrnoToString(GetErrno());
+                LOG_ERROR(sLogger, ("failed to sync disk buffer segment", errorStr));
+                AlarmManager::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
+                                                       "failed to sync disk buffer segment, error:" + errorStr);
+            }
         }
     }
+    SealSegment();
 }
 
 void DiskBufferWriter::BufferSenderThread() {
@@ -198,6 +219,7 @@ void DiskBufferWriter::BufferSenderThread() {
                                                        "check header of buffer file failed, delete file: " + fileName);
             }
         }
+        ReplaySegments();
         // mIsSendingBuffer = false;
         lock.lock();
         if (mStopCV.wait_for(lock, chrono::seconds(mCheckPeriod), [this]() { return !mIsSendBufferThreadRunning; })) {
@@ -215,7 +237,6 @@ void DiskBufferWriter::SetBufferFilePath(const std::string& bufferfilepath) {
 
     if (mBufferFilePath[mBufferFilePath.size() - 1] != PATH_SEPARATOR[0])
         mBufferFilePath += PATH_SEPARATOR;
-    mBufferFileName = "";
 }
 
 std::string DiskBufferWriter::GetBufferFilePath() {
@@ -223,16 +244,6 @@ std::string DiskBufferWriter::GetBufferFilePath() {
     return mBufferFilePath;
 }
 
-void DiskBufferWriter::SetBufferFileName(const std::string& filename) {
-    lock_guard<mutex> lock(mBufferFileLock);
-    mBufferFileName = filename;
-}
-
-std::string DiskBufferWriter::GetBufferFileName() {
-    lock_guard<mutex> lock(mBufferFileLock);
-    return mBufferFileName;
-}
-
 bool DiskBufferWriter::LoadFileToSend(time_t timeLine, std::vector<std::string>& filesToSend) {
     string bufferFilePath = GetBufferFilePath();
     if (!CheckExistance(bufferFilePath)) {
@@ -531,30 +542,6 @@ void DiskBufferWriter::SendEncryptionBuffer(const std::string& filename, int32_t
     }
 }
 
-// file is not really created when call CreateNewFile(), file created happened when SendToBufferFile() first called
-bool DiskBufferWriter::CreateNewFile() {
-    vector<string> filesToSend;
-    int64_t currentTime = time(NULL);
-    if (!LoadFileToSend(currentTime, filesToSend))
-        return false;
-    int32_t bufferFileNumValue = AppConfig::GetInstance()->GetNumOfBufferFile();
-    for (int32_t i = 0; i < (int32_t)filesToSend.size() - bufferFileNumValue; ++i) {
-        string fileName = GetBufferFilePath() + filesToSend[i];
-        if (CheckExistance(fileName)) {
-            remove(fileName.c_str());
-            LOG_ERROR(sLogger,
-                      ("buffer file count exceed limit",
-                       "file created earlier will be cleaned, and new file will create for new log data")("delete file",
-                                                                                                          fileName));
-            AlarmManager::GetInstance()->SendAlarm(DISCARD_SECONDARY_ALARM,
-                                                   "buffer file count exceed, delete file: " + fileName);
-        }
-    }
-    mBufferDivideTime = currentTime;
-    SetBufferFileName(GetBufferFilePath() + GetSendBufferFileNamePrefix() + ToString(currentTime));
-    return true;
-}
-
 bool DiskBufferWriter::WriteBackMeta(int32_t pos, const void* buf, int32_t length, const string& filename) {
     // TODO: Why not use fopen or fstream???
     // TODO: Make sure and merge them.
@@ -602,51 +589,13 @@ bool DiskBufferWriter::WriteBackMeta(int32_t pos, const void* buf, int32_t lengt
 #endif
 }
 
-string DiskBufferWriter::GetBufferFileHeader() {
-    string reserve = STRING_FLAG(file_encryption_field_key_version) + STRING_FLAG(file_encryption_key_value_splitter)
-        + ToString(FileEncryption::GetInstance()->GetDefaultKeyVersion());
-    string nullHeader = string(
-        (INT32_FLAG(file_encryption_header_length) - STRING_FLAG(file_encryption_magic_number).size() - reserve.size()),
-        '\0');
-    return (STRING_FLAG(file_encryption_magic_number) + reserve + nullHeader);
-}
-
 bool DiskBufferWriter::SendToBufferFile(SenderQueueItem* dataPtr) {
     auto data = static_cast<SLSSenderQueueItem*>(dataPtr);
     auto flusher = static_cast<const FlusherSLS*>(data->mFlusher);
-    string bufferFileName = GetBufferFileName();
-    if (bufferFileName.empty()) {
-        CreateNewFile();
-        bufferFileName = GetBufferFileName();
-    }
-    // if file not exist, create it new
-    FILE* fout = FileAppendOpen(bufferFileName.c_str(), "ab");
-    if (!fout) {
-        string errorStr = ErrnoToString(GetErrno());
-        AlarmManager::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
-                                               string("open file error:") + bufferFileName + ",error:" + errorStr);
-        LOG_ERROR(sLogger, ("open buffer file error", bufferFileName));
-        return false;
-    }
-
-    if (ftell(fout) == (streampos)0) {
-        string header = GetBufferFileHeader();
-        auto nbytes = fwrite(header.c_str(), 1, header.size(), fout);
-        if (header.size() != nbytes) {
-            string errorStr = ErrnoToString(GetErrno());
-            AlarmManager::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
-                                                   string("write file error:") + bufferFileName + ", error:" + errorStr
-                                                       + ", nbytes:" + ToString(nbytes));
-            LOG_ERROR(sLogger, ("error write encryption header", bufferFileName)("error", errorStr)("nbytes", nbytes));
-            fclose(fout);
-            return false;
-        }
-    }
 
     char* des;
     int32_t desLength;
     if (!FileEncryption::GetInstance()->Encrypt(data->mData.c_str(), data->mData.size(), des, desLength)) {
-        fclose(fout);
         LOG_ERROR(sLogger, ("encrypt error, project_name", flusher->mProject));
         AlarmManager::GetInstance()->SendAlarm(ENCRYPT_DECRYPT_FAIL_ALARM,
                                                string("encrypt error, project_name:" + flusher->mProject));
@@ -666,45 +615,205 @@ bool DiskBufferWriter::SendToBufferFile(SenderQueueItem* dataPtr) {
     string encodedInfo;
     bufferMeta.SerializeToString(&encodedInfo);
 
-    EncryptionStateMeta meta;
-    int32_t encodedInfoSize = encodedInfo.size();
-    meta.mEncodedInfoSize = encodedInfoSize + BUFFER_META_BASE_SIZE;
-    meta.mLogDataSize = data->mData.size();
+    WalRecordMeta meta;
     meta.mTimeStamp = time(NULL);
-    meta.mHandled = 0;
-    meta.mRetryTime = 0;
-    meta.mEncryptionSize = desLength;
-    char* buffer = new char[sizeof(meta) + encodedInfoSize + meta.mEncryptionSize];
-    memcpy(buffer, (char*)&meta, sizeof(meta));
-    memcpy(buffer + sizeof(meta), encodedInfo.c_str(), encodedInfoSize);
-    memcpy(buffer + sizeof(meta) + encodedInfoSize, des, desLength);
+    meta.mKeyVersion = FileEncryption::GetInstance()->GetDefaultKeyVersion();
+    meta.mLogDataSize = data->mData.size();
+    meta.mEncodedInfoSize = encodedInfo.size();
+    bool res = mWal.Append({StringView(reinterpret_cast<const char*>(&meta), sizeof(meta)),
+                            StringView(encodedInfo),
+                            StringView(des, desLength)});
     delete[] des;
-    const auto bytesToWrite = sizeof(meta) + encodedInfoSize + meta.mEncryptionSize;
-    auto nbytes = fwrite(buffer, 1, bytesToWrite, fout);
-    if (nbytes != bytesToWrite) {
+    if (!res) {
         string errorStr = ErrnoToString(GetErrno());
         AlarmManager::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
-                                               string("write file error:") + bufferFileName + ", error:" + errorStr
-                                                   + ", nbytes:" + ToString(nbytes));
-        LOG_ERROR(
-            sLogger,
-            ("write meta of buffer file", "fail")("filename", bufferFileName)("errorStr", errorStr)("nbytes", nbytes));
-        delete[] buffer;
-        fclose(fout);
+                                               string("write disk buffer segment error, dir:") + GetBufferFilePath()
+                                                   + ", error:" + errorStr + ", size:" + ToString(desLength),
+                                               flusher->mProject,
+                                               data->mLogstore,
+                                               flusher->mRegion);
+        LOG_ERROR(sLogger,
+                  ("write disk buffer segment", "fail")("dir", GetBufferFilePath())("errorStr", errorStr)("size",
+                                                                                                       desLength));
         return false;
     }
-    delete[] buffer;
-    if (ftell(fout) > AppConfig::GetInstance()->GetLocalFileSize())
-        CreateNewFile();
-    fclose(fout);
-    LOG_DEBUG(sLogger, ("write buffer file", bufferFileName));
+    LOG_DEBUG(sLogger, ("write disk buffer segment", GetBufferFilePath())("size", desLength));
     return true;
 }
 
+void DiskBufferWriter::SealSegment() {
+    mWal.Seal();
+    size_t removed = mWal.RemoveExcessSegments();
+    if (removed > 0) {
+        LOG_ERROR(sLogger,
+                  ("buffer file count exceed limit", "segments created earlier are deleted")("deleted segments",
+                                                                                              removed));
+        AlarmManager::GetInstance()->SendAlarm(DISCARD_SECONDARY_ALARM,
+                                               "buffer file count exceed, delete " + ToString(removed)
+                                                   + " disk buffer segments");
+    }
+    mBufferDivideTime = time(NULL);
+}
+
+bool DiskBufferWriter::IsSendBufferThreadRunning() const {
+    lock_guard<mutex> lock(mBufferSenderThreadRunningMux);
+    return mIsSendBufferThreadRunning;
+}
+
+void DiskBufferWriter::ReplaySegments() {
+    vector<string> segments = mWal.GetSealedSegments();
+    if (segments.empty()) {
+        return;
+    }
+    // segments are independent, so they are replayed concurrently, each in order
+    atomic_size_t next{0};
+    auto replay = [this, &segments, &next]() {
+        size_t idx = 0;
+        while ((idx = next.fetch_add(1)) < segments.size() && IsSendBufferThreadRunning()) {
+            ReplaySegment(segments[idx]);
+        }
+    };
+    size_t threadCnt = min(segments.size(), static_cast<size_t>(max(INT32_FLAG(disk_buffer_replay_thread_count), 1)));
+    vector<future<void>> res;
+    for (size_t i = 1; i < threadCnt; ++i) {
+        res.push_back(async(launch::async, replay));
+    }
+    replay();
+    for (auto& r : res) {
+        r.get();
+    }
+}
+
+void DiskBufferWriter::ReplaySegment(const string& path) {
+    WalSegment segment;
+    string errorMsg;
+    if (!segment.Open(path, errorMsg)) {
+        remove(path.c_str());
+        LOG_ERROR(sLogger, ("failed to open disk buffer segment", errorMsg)("delete segment", path));
+        AlarmManager::GetInstance()->SendAlarm(DISCARD_SECONDARY_ALARM,
+                                               "failed to open disk buffer segment, delete segment: " + path
+                                                   + ", error: " + errorMsg);
+        return;
+    }
+    int32_t discardCount = 0;
+    int32_t uncommittedCount = 0;
+    StringView record;
+    while (IsSendBufferThreadRunning()) {
+        if (!segment.Next(record)) {
+            if (segment.IsCorrupted()) {
+                LOG_ERROR(sLogger, ("disk buffer segment is corrupted", path));
+                AlarmManager::GetInstance()->SendAlarm(DISCARD_SECONDARY_ALARM,
+                                                       "disk buffer segment is corrupted, discard the rest: " + path);
+            }
+            segment.Close();
+            remove(path.c_str());
+            if (discardCount > 0) {
+                LOG_ERROR(sLogger,
+                          ("send disk buffer segment, discard LogGroup count", discardCount)("delete segment", path));
+                AlarmManager::GetInstance()->SendAlarm(DISCARD_SECONDARY_ALARM,
+                                                       "delete disk buffer segment: " + path + ", discard "
+                                                           + ToString(discardCount) + " logGroups");
+            } else {
+                LOG_INFO(sLogger, ("send disk buffer segment success, delete segment", path));
+            }
+            return;
+        }
+        if (!SendSegmentRecord(record, discardCount)) {
+            // the record is not marked as replayed, so it is sent again in the next round
+            segment.CommitReplayedOffset();
+            return;
+        }
+        segment.MarkReplayed();
+        // records sent but not committed are only sent again after a crash
+        if (++uncommittedCount >= INT32_FLAG(disk_buffer_replay_commit_batch)) {
+            segment.CommitReplayedOffset();
+            uncommittedCount = 0;
+        }
+    }
+    segment.CommitReplayedOffset();
+}
+
+bool DiskBufferWriter::SendSegmentRecord(StringView record, int32_t& discardCount) {
+    WalRecordMeta meta;
+    if (record.size() < sizeof(meta)) {
+        ++discardCount;
+        return true;
+    }
+    memcpy(&meta, record.data(), sizeof(meta));
+    if (meta.mEncodedInfoSize < 0 || meta.mLogDataSize <= 0
+        || static_cast<size_t>(meta.mEncodedInfoSize) > record.size() - sizeof(meta)) {
+        LOG_ERROR(sLogger,
+                  ("meta of disk buffer record invalid", "discard")("mEncodedInfoSize", meta.mEncodedInfoSize)(
+                      "mLogDataSize", meta.mLogDataSize));
+        ++discardCount;
+        return true;
+    }
+    if ((time(NULL) - meta.mTimeStamp) > INT32_FLAG(log_expire_time)) {
+        LOG_WARNING(sLogger, ("timeout disk buffer record, meta.mTimeStamp", meta.mTimeStamp));
+        ++discardCount;
+        return true;
+    }
+
+    sls_logs::LogtailBufferMeta bufferMeta;
+    if (!bufferMeta.ParseFromArray(record.data() + sizeof(meta), meta.mEncodedInfoSize)
+        || bufferMeta.project().empty()) {
+        AlarmManager::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM, "parse buffer meta from segment error");
+        LOG_ERROR(sLogger, ("parse buffer meta from segment error", "discard"));
+        ++discardCount;
+        return true;
+    }
+
+    // decrypted straight from the mapped segment into the payload to send
+    const char* encryption = record.data() + sizeof(meta) + meta.mEncodedInfoSize;
+    int32_t encryptionSize = static_cast<int32_t>(record.size() - sizeof(meta) - meta.mEncodedInfoSize);
+    string logData(meta.mLogDataSize, '\0');
+    if (!FileEncryption::GetInstance()->Decrypt(
+            encryption, encryptionSize, &logData[0], meta.mLogDataSize, meta.mKeyVersion)) {
+        LOG_ERROR(sLogger,
+                  ("decrypt error, project_name", bufferMeta.project())("key_version", meta.mKeyVersion)(
+                      "meta.mLogDataSize", meta.mLogDataSize));
+        AlarmManager::GetInstance()->SendAlarm(ENCRYPT_DECRYPT_FAIL_ALARM,
+                                               string("decrypt error, project_name:" + bufferMeta.project()
+                                                      + ", key_version:" + ToString(meta.mKeyVersion)
+                                                      + ", meta.mLogDataSize:" + ToString(meta.mLogDataSize)));
+        ++discardCount;
+        return true;
+    }
+
+    string errorCode;
+    SendResult res = SendBufferFileData(bufferMeta, logData, errorCode);
+    LOG_DEBUG(sLogger, ("send LogGroup from disk buffer segment, rawsize", bufferMeta.rawsize())("result", res));
+    if (res == SEND_OK) {
+        return true;
+    }
+    if (res == SEND_DISCARD_ERROR || res == SEND_UNAUTHORIZED) {
+        AlarmManager::GetInstance()->SendAlarm(SEND_DATA_FAIL_ALARM,
+                                               string("send buffer file fail, rawsize:")
+                                                   + ToString(bufferMeta.rawsize()) + "errorCode: " + errorCode,
+                                               bufferMeta.project(),
+                                               bufferMeta.logstore(),
+                                               "");
+        ++discardCount;
+        return true;
+    }
+    if (res == SEND_QUOTA_EXCEED && INT32_FLAG(quota_exceed_wait_interval) > 0) {
+        sleep(INT32_FLAG(quota_exceed_wait_interval));
+    }
+    return false;
+}
+
 SendResult DiskBufferWriter::SendBufferFileData(const sls_logs::LogtailBufferMeta& bufferMeta,
                                                 const std::string& logData,
                                                 std::string& errorCode) {
-    RateLimiter::FlowControl(bufferMeta.rawsize(), mSendLastTime, mSendLastByte, false);
+    // buffer files are sent synchronously in the dedicated thread, so it is fine to wait here
+    uint64_t maxRate = AppConfig::GetInstance()->GetBytePerSec();
+    if (mSendRateLimiter.GetMaxRate() != maxRate) {
+        mSendRateLimiter.SetMaxRate(maxRate);
+    }
+    while (!mSendRateLimiter.IsValidToPop()) {
+        this_thread::sleep_for(chrono::milliseconds(10));
+    }
+    mSendRateLimiter.PostPop(bufferMeta.rawsize());
     string region = bufferMeta.endpoint();
     if (region.find("http://") == 0) // old buffer file which record the endpoint
         region = SLSClientManager::GetInstance()->GetRegionFromEndpoint(region);
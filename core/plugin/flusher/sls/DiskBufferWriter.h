@@ -24,6 +24,8 @@
 #include <vector>
 
 #include "common/SafeQueue.h"
+#include "common/SegmentedWal.h"
+#include "pipeline/limiter/RateLimiter.h"
 #include "plugin/flusher/sls/SendResult.h"
 #include "protobuf/sls/logtail_buffer_meta.pb.h"
 #include "pipeline/queue/SenderQueueItem.h"
@@ -58,6 +60,14 @@ private:
         int32_t mRetryTime;
     };
 
+    // header of each record in the segmented wal, followed by the encoded buffer meta and the encrypted data
+    struct WalRecordMeta {
+        int32_t mTimeStamp;
+        int32_t mKeyVersion;
+        int32_t mLogDataSize;
+        int32_t mEncodedInfoSize;
+    };
+
     DiskBufferWriter() = default;
     ~DiskBufferWriter() = default;
 
@@ -72,8 +82,14 @@ private:
                                   const std::string& logData,
                                   std::string& errorCode);
     bool SendToBufferFile(SenderQueueItem* dataPtr);
+    void SealSegment();
+    void ReplaySegments();
+    void ReplaySegment(const std::string& path);
+    // returns false if the record should be retried later
+    bool SendSegmentRecord(StringView record, int32_t& discardCount);
+    bool IsSendBufferThreadRunning() const;
+    // buffer files written by older versions are still replayed
     bool LoadFileToSend(time_t timeLine, std::vector<std::string>& filesToSend);
-    bool CreateNewFile();
     bool WriteBackMeta(const int32_t pos, const void* buf, int32_t length, const std::string& filename);
     bool ReadNextEncryption(int32_t& pos,
                             const std::string& filename,
@@ -84,9 +100,6 @@ private:
     void SendEncryptionBuffer(const std::string& filename, int32_t keyVersion);
     void SetBufferFilePath(const std::string& bufferfilepath);
     std::string GetBufferFilePath();
-    std::string GetBufferFileName();
-    void SetBufferFileName(const std::string& filename);
-    std::string GetBufferFileHeader();
 
     SafeQueue<SenderQueueItem*> mQueue;
 
@@ -100,14 +113,14 @@ private:
 
     mutable std::mutex mBufferFileLock;
     std::string mBufferFilePath;
-    std::string mBufferFileName;
+
+    SegmentedWal mWal;
 
     volatile time_t mBufferDivideTime = 0;
     // volatile bool mIsSendingBuffer = false;
     int64_t mCheckPeriod = 0;
 
-    int64_t mSendLastTime = 0;
-    int32_t mSendLastByte = 0;
+    RateLimiter mSendRateLimiter{0};
 };
 
 } // namespace logtail
@@ -58,6 +58,7 @@ DEFINE_FLAG_INT32(discard_send_fail_interval, "discard data when send fail after
 DEFINE_FLAG_INT32(profile_data_send_retrytimes, "how many times should retry if profile data send fail", 5);
 DEFINE_FLAG_INT32(unknow_error_try_max, "discard data when try times > this value", 5);
 DEFINE_FLAG_BOOL(global_network_success, "global network success flag, default false", false);
+DEFINE_FLAG_INT64(sls_region_max_send_bytes_per_sec, "max send rate of each region, 0 means unlimited", 0);
 DEFINE_FLAG_BOOL(enable_metricstore_channel, "only works for metrics data for enhance metrics query performance", true);
 DEFINE_FLAG_INT32(max_send_log_group_size, "bytes", 10 * 1024 * 1024);
 DEFINE_FLAG_DOUBLE(sls_serialize_size_expansion_ratio, "", 1.2);
@@ -92,6 +93,12 @@ static OperationOnFail DefaultOperation(uint32_t retryTimes) {
     }
 }
 
+static void StampLatencyTrace(const LatencyTracePtr& trace, LatencyStage stage) {
+    if (trace) {
+        trace->Stamp(stage);
+    }
+}
+
 void FlusherSLS::InitResource() {
 #ifndef APSARA_UNIT_TEST_MAIN
     if (!sIsResourceInited) {
@@ -116,6 +123,7 @@ mutex FlusherSLS::sMux;
 unordered_map<string, weak_ptr<ConcurrencyLimiter>> FlusherSLS::sProjectConcurrencyLimiterMap;
 unordered_map<string, weak_ptr<ConcurrencyLimiter>> FlusherSLS::sRegionConcurrencyLimiterMap;
 unordered_map<string, weak_ptr<ConcurrencyLimiter>> FlusherSLS::sLogstoreConcurrencyLimiterMap;
+unordered_map<string, weak_ptr<RateLimiter>> FlusherSLS::sRegionRateLimiterMap;
 
 
 shared_ptr<ConcurrencyLimiter> GetConcurrencyLimiter() {
@@ -173,6 +181,20 @@ shared_ptr<ConcurrencyLimiter> FlusherSLS::GetRegionConcurrencyLimiter(const str
     return iter->second.lock();
 }
 
+shared_ptr<RateLimiter> FlusherSLS::GetRegionRateLimiter(const string& region) {
+    if (INT64_FLAG(sls_region_max_send_bytes_per_sec) <= 0) {
+        return nullptr;
+    }
+    lock_guard<mutex> lock(sMux);
+    auto iter = sRegionRateLimiterMap.find(region);
+    if (iter == sRegionRateLimiterMap.end() || iter->second.expired()) {
+        auto limiter = make_shared<RateLimiter>(static_cast<uint64_t>(INT64_FLAG(sls_region_max_send_bytes_per_sec)));
+        sRegionRateLimiterMap[region] = limiter;
+        return limiter;
+    }
+    return iter->second.lock();
+}
+
 void FlusherSLS::ClearInvalidConcurrencyLimiters() {
     lock_guard<mutex> lock(sMux);
     for (auto iter = sProjectConcurrencyLimiterMap.begin(); iter != sProjectConcurrencyLimiterMap.end();) {
@@ -196,6 +218,13 @@ void FlusherSLS::ClearInvalidConcurrencyLimiters() {
             ++iter;
         }
     }
+    for (auto iter = sRegionRateLimiterMap.begin(); iter != sRegionRateLimiterMap.end();) {
+        if (iter->second.expired()) {
+            iter = sRegionRateLimiterMap.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
 }
 
 mutex FlusherSLS::sDefaultRegionLock;
@@ -519,7 +548,8 @@ bool FlusherSLS::Init(const Json::Value& config, Json::Value& optionalGoPipeline
             {{"region", GetRegionConcurrencyLimiter(mRegion)},
              {"project", GetProjectConcurrencyLimiter(mProject)},
              {"logstore", GetLogstoreConcurrencyLimiter(mProject, mLogstore)}},
-            mMaxSendRate);
+            mMaxSendRate,
+            {{"region", GetRegionRateLimiter(mRegion)}});
     }
 
     GenerateGoPlugin(config, optionalGoPipeline);
@@ -975,6 +1005,7 @@ bool FlusherSLS::SerializeAndPush(PipelineEventGroup&& group) {
                     std::move(group.GetSourceBuffer()),
                     group.GetMetadata(EventGroupMetaKey::SOURCE_ID),
                     std::move(group.GetExactlyOnceCheckpoint()));
+    g.mLatencyTrace = group.GetLatencyTrace();
     AddPackId(g);
     string errorMsg;
     if (!mGroupSerializer->DoSerialize(std::move(g), serializedData, errorMsg)) {
@@ -990,6 +1021,7 @@ bool FlusherSLS::SerializeAndPush(PipelineEventGroup&& group) {
                                        mContext->GetRegion());
         return false;
     }
+    StampLatencyTrace(g.mLatencyTrace, LatencyStage::SERIALIZE);
     if (mCompressor) {
         if (!mCompressor->DoCompress(serializedData, compressedData, errorMsg)) {
             LOG_WARNING(mContext->GetLogger(),
@@ -1004,21 +1036,23 @@ bool FlusherSLS::SerializeAndPush(PipelineEventGroup&& group) {
                                            mContext->GetRegion());
             return false;
         }
+        StampLatencyTrace(g.mLatencyTrace, LatencyStage::COMPRESS);
     } else {
         compressedData = serializedData;
     }
     // must create a tmp, because eoo checkpoint is moved in second param
     auto fbKey = g.mExactlyOnceCheckpoint->fbKey;
-    return PushToQueue(fbKey,
-                       make_unique<SLSSenderQueueItem>(std::move(compressedData),
-                                                       serializedData.size(),
-                                                       this,
-                                                       fbKey,
-                                                       mLogstore,
-                                                       RawDataType::EVENT_GROUP,
-                                                       g.mExactlyOnceCheckpoint->data.hash_key(),
-                                                       std::move(g.mExactlyOnceCheckpoint),
-                                                       false));
+    auto item = make_unique<SLSSenderQueueItem>(std::move(compressedData),
+                                                serializedData.size(),
+                                                this,
+                                                fbKey,
+                                                mLogstore,
+                                                RawDataType::EVENT_GROUP,
+                                                g.mExactlyOnceCheckpoint->data.hash_key(),
+                                                std::move(g.mExactlyOnceCheckpoint),
+                                                false);
+    item->mLatencyTrace = std::move(g.mLatencyTrace);
+    return PushToQueue(fbKey, std::move(item));
 }
 
 bool FlusherSLS::SerializeAndPush(BatchedEventsList&& groupList) {
@@ -1029,6 +1063,7 @@ bool FlusherSLS::SerializeAndPush(BatchedEventsList&& groupList) {
     string shardHashKey, serializedData, compressedData;
     size_t packageSize = 0;
     bool enablePackageList = groupList.size() > 1;
+    LatencyTracePtr packageLatencyTrace;
 
     bool allSucceeded = true;
     for (auto& group : groupList) {
@@ -1051,6 +1086,7 @@ bool FlusherSLS::SerializeAndPush(BatchedEventsList&& groupList) {
             allSucceeded = false;
             continue;
         }
+        StampLatencyTrace(group.mLatencyTrace, LatencyStage::SERIALIZE);
         if (mCompressor) {
             if (!mCompressor->DoCompress(serializedData, compressedData, errorMsg)) {
                 LOG_WARNING(mContext->GetLogger(),
@@ -1066,47 +1102,51 @@ bool FlusherSLS::SerializeAndPush(BatchedEventsList&& groupList) {
                 allSucceeded = false;
                 continue;
             }
+            StampLatencyTrace(group.mLatencyTrace, LatencyStage::COMPRESS);
         } else {
             compressedData = serializedData;
         }
         if (enablePackageList) {
             packageSize += serializedData.size();
             compressedLogGroups.emplace_back(std::move(compressedData), serializedData.size());
+            if (!packageLatencyTrace) {
+                packageLatencyTrace = std::move(group.mLatencyTrace);
+            }
         } else {
             if (group.mExactlyOnceCheckpoint) {
                 // must create a tmp, because eoo checkpoint is moved in second param
                 auto fbKey = group.mExactlyOnceCheckpoint->fbKey;
-                allSucceeded
-                    = PushToQueue(fbKey,
-                                  make_unique<SLSSenderQueueItem>(std::move(compressedData),
-                                                                  serializedData.size(),
-                                                                  this,
-                                                                  fbKey,
-                                                                  mLogstore,
-                                                                  RawDataType::EVENT_GROUP,
-                                                                  group.mExactlyOnceCheckpoint->data.hash_key(),
-                                                                  std::move(group.mExactlyOnceCheckpoint),
-                                                                  false))
-                    && allSucceeded;
+                auto item = make_unique<SLSSenderQueueItem>(std::move(compressedData),
+                                                            serializedData.size(),
+                                                            this,
+                                                            fbKey,
+                                                            mLogstore,
+                                                            RawDataType::EVENT_GROUP,
+                                                            group.mExactlyOnceCheckpoint->data.hash_key(),
+                                                            std::move(group.mExactlyOnceCheckpoint),
+                                                            false);
+                item->mLatencyTrace = std::move(group.mLatencyTrace);
+                allSucceeded = PushToQueue(fbKey, std::move(item)) && allSucceeded;
             } else {
-                allSucceeded = Flusher::PushToQueue(make_unique<SLSSenderQueueItem>(std::move(compressedData),
-                                                                                    serializedData.size(),
-                                                                                    this,
-                                                                                    mQueueKey,
-                                                                                    mLogstore,
-                                                                                    RawDataType::EVENT_GROUP,
-                                                                                    shardHashKey))
-                    && allSucceeded;
+                auto item = make_unique<SLSSenderQueueItem>(std::move(compressedData),
+                                                            serializedData.size(),
+                                                            this,
+                                                            mQueueKey,
+                                                            mLogstore,
+                                                            RawDataType::EVENT_GROUP,
+                                                            shardHashKey);
+                item->mLatencyTrace = std::move(group.mLatencyTrace);
+                allSucceeded = Flusher::PushToQueue(std::move(item)) && allSucceeded;
             }
         }
     }
     if (enablePackageList) {
         string errorMsg;
         mGroupListSerializer->DoSerialize(std::move(compressedLogGroups), serializedData, errorMsg);
-        allSucceeded
-            = Flusher::PushToQueue(make_unique<SLSSenderQueueItem>(
-                  std::move(serializedData), packageSize, this, mQueueKey, mLogstore, RawDataType::EVENT_GROUP_LIST))
-            && allSucceeded;
+        auto item = make_unique<SLSSenderQueueItem>(
+            std::move(serializedData), packageSize, this, mQueueKey, mLogstore, RawDataType::EVENT_GROUP_LIST);
+        item->mLatencyTrace = std::move(packageLatencyTrace);
+        allSucceeded = Flusher::PushToQueue(std::move(item)) && allSucceeded;
     }
     return allSucceeded;
 }
@@ -29,6 +29,7 @@
 #include "pipeline/batch/BatchStatus.h"
 #include "pipeline/batch/Batcher.h"
 #include "pipeline/limiter/ConcurrencyLimiter.h"
+#include "pipeline/limiter/RateLimiter.h"
 #include "pipeline/plugin/interface/HttpFlusher.h"
 #include "pipeline/serializer/SLSSerializer.h"
 #include "protobuf/sls/sls_logs.pb.h"
@@ -42,6 +43,8 @@ public:
     static std::shared_ptr<ConcurrencyLimiter> GetProjectConcurrencyLimiter(const std::string& project);
     static std::shared_ptr<ConcurrencyLimiter> GetRegionConcurrencyLimiter(const std::string& region);
     static void ClearInvalidConcurrencyLimiters();
+    // return nullptr if region level rate limit is not set
+    static std::shared_ptr<RateLimiter> GetRegionRateLimiter(const std::string& region);
 
     static void RecycleResourceIfNotUsed();
 
@@ -99,6 +102,7 @@ private:
     static std::unordered_map<std::string, std::weak_ptr<ConcurrencyLimiter>> sProjectConcurrencyLimiterMap;
     static std::unordered_map<std::string, std::weak_ptr<ConcurrencyLimiter>> sRegionConcurrencyLimiterMap;
     static std::unordered_map<std::string, std::weak_ptr<ConcurrencyLimiter>> sLogstoreConcurrencyLimiterMap;
+    static std::unordered_map<std::string, std::weak_ptr<RateLimiter>> sRegionRateLimiterMap;
 
     static std::mutex sDefaultRegionLock;
     static std::string sDefaultRegion;
@@ -15,6 +15,10 @@
  */
 #include "plugin/processor/ProcessorDesensitizeNative.h"
 
+#include <algorithm>
+#include <cstring>
+
+#include "common/StringTools.h"
 #include "constants/Constants.h"
 #include "common/ParamExtractor.h"
 #include "models/LogEvent.h"
@@ -41,6 +45,74 @@ bool ProcessorDesensitizeNative::Init(const Json::Value& config) {
                            mContext->GetRegion());
     }
 
+    // Rules
+    const char* key = "Rules";
+    const Json::Value* itr = config.find(key, key + strlen(key));
+    if (itr == nullptr) {
+        mRules.resize(1);
+        if (!ParseRule(config, mRules[0])) {
+            return false;
+        }
+    } else {
+        if (!itr->isArray() || itr->empty()) {
+            PARAM_ERROR_RETURN(mContext->GetLogger(),
+                               mContext->GetAlarm(),
+                               "param Rules is not a non-empty array",
+                               sName,
+                               mContext->GetConfigName(),
+                               mContext->GetProjectName(),
+                               mContext->GetLogstoreName(),
+                               mContext->GetRegion());
+        }
+        mRules.resize(itr->size());
+        for (Json::Value::ArrayIndex i = 0; i < itr->size(); ++i) {
+            const Json::Value& ruleConfig = (*itr)[i];
+            if (!ruleConfig.isObject()) {
+                PARAM_ERROR_RETURN(mContext->GetLogger(),
+                                   mContext->GetAlarm(),
+                                   "param Rules[" + ToString(i) + "] is not of type object",
+                                   sName,
+                                   mContext->GetConfigName(),
+                                   mContext->GetProjectName(),
+                                   mContext->GetLogstoreName(),
+                                   mContext->GetRegion());
+            }
+            if (!ParseRule(ruleConfig, mRules[i])) {
+                return false;
+            }
+        }
+    }
+
+    if (mRules.size() > 1) {
+        // RE2::Set can only tell which rules match, but it does so in a single scan of the value
+        mRuleSet.reset(new re2::RE2::Set(re2::RE2::Options(), re2::RE2::UNANCHORED));
+        for (const auto& rule : mRules) {
+            if (mRuleSet->Add(rule.mRegex->pattern(), nullptr) < 0) {
+                mRuleSet.reset();
+                break;
+            }
+        }
+        if (mRuleSet && !mRuleSet->Compile()) {
+            mRuleSet.reset();
+        }
+        if (!mRuleSet) {
+            LOG_WARNING(mContext->GetLogger(),
+                        ("failed to build regex set of desensitize rules",
+                         "all rules will be tried on each value")("config", mContext->GetConfigName()));
+        }
+    }
+
+    mDiscardedEventsTotal = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_DISCARDED_EVENTS_TOTAL);
+    mOutFailedEventsTotal = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_OUT_FAILED_EVENTS_TOTAL);
+    mOutKeyNotFoundEventsTotal = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_OUT_KEY_NOT_FOUND_EVENTS_TOTAL);
+    mOutSuccessfulEventsTotal = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_OUT_SUCCESSFUL_EVENTS_TOTAL);
+
+    return true;
+}
+
+bool ProcessorDesensitizeNative::ParseRule(const Json::Value& config, Rule& rule) {
+    std::string errorMsg;
+
     // Method
     std::string method;
     if (!GetMandatoryStringParam(config, "Method", method, errorMsg)) {
@@ -54,9 +126,9 @@ bool ProcessorDesensitizeNative::Init(const Json::Value& config) {
                            mContext->GetRegion());
     }
     if (method == "const") {
-        mMethod = DesensitizeMethod::CONST_OPTION;
+        rule.mMethod = DesensitizeMethod::CONST_OPTION;
     } else if (method == "md5") {
-        mMethod = DesensitizeMethod::MD5_OPTION;
+        rule.mMethod = DesensitizeMethod::MD5_OPTION;
     } else {
         PARAM_ERROR_RETURN(mContext->GetLogger(),
                            mContext->GetAlarm(),
@@ -69,8 +141,8 @@ bool ProcessorDesensitizeNative::Init(const Json::Value& config) {
     }
 
     // ReplacingString
-    if (mMethod == DesensitizeMethod::CONST_OPTION) {
-        if (!GetMandatoryStringParam(config, "ReplacingString", mReplacingString, errorMsg)) {
+    if (rule.mMethod == DesensitizeMethod::CONST_OPTION) {
+        if (!GetMandatoryStringParam(config, "ReplacingString", rule.mReplacingString, errorMsg)) {
             PARAM_ERROR_RETURN(mContext->GetLogger(),
                                mContext->GetAlarm(),
                                errorMsg,
@@ -81,11 +153,11 @@ bool ProcessorDesensitizeNative::Init(const Json::Value& config) {
                                mContext->GetRegion());
         }
     }
-    mReplacingString = std::string("\\1") + mReplacingString;
+    rule.mLiteralReplacing = rule.mReplacingString.find('\\') == std::string::npos;
 
     // ContentPatternBeforeReplacedString
     if (!GetMandatoryStringParam(
-            config, "ContentPatternBeforeReplacedString", mContentPatternBeforeReplacedString, errorMsg)) {
+            config, "ContentPatternBeforeReplacedString", rule.mContentPatternBeforeReplacedString, errorMsg)) {
         PARAM_ERROR_RETURN(mContext->GetLogger(),
                            mContext->GetAlarm(),
                            errorMsg,
@@ -97,7 +169,7 @@ bool ProcessorDesensitizeNative::Init(const Json::Value& config) {
     }
 
     // ReplacedContentPattern
-    if (!GetMandatoryStringParam(config, "ReplacedContentPattern", mReplacedContentPattern, errorMsg)) {
+    if (!GetMandatoryStringParam(config, "ReplacedContentPattern", rule.mReplacedContentPattern, errorMsg)) {
         PARAM_ERROR_RETURN(mContext->GetLogger(),
                            mContext->GetAlarm(),
                            errorMsg,
@@ -108,10 +180,11 @@ bool ProcessorDesensitizeNative::Init(const Json::Value& config) {
                            mContext->GetRegion());
     }
 
-    std::string regexStr = std::string("(") + mContentPatternBeforeReplacedString + ")" + mReplacedContentPattern;
-    mRegex.reset(new re2::RE2(regexStr));
-    if (!mRegex->ok()) {
-        errorMsg = mRegex->error();
+    std::string regexStr
+        = std::string("(") + rule.mContentPatternBeforeReplacedString + ")" + rule.mReplacedContentPattern;
+    rule.mRegex.reset(new re2::RE2(regexStr));
+    if (!rule.mRegex->ok()) {
+        errorMsg = rule.mRegex->error();
         PARAM_ERROR_RETURN(mContext->GetLogger(),
                            mContext->GetAlarm(),
                            "param ContentPatternBeforeReplacedString or ReplacedContentPattern is not a valid regex: "
@@ -124,23 +197,17 @@ bool ProcessorDesensitizeNative::Init(const Json::Value& config) {
     }
 
     // ReplacingAll
-    if (!GetOptionalBoolParam(config, "ReplacingAll", mReplacingAll, errorMsg)) {
+    if (!GetOptionalBoolParam(config, "ReplacingAll", rule.mReplacingAll, errorMsg)) {
         PARAM_WARNING_DEFAULT(mContext->GetLogger(),
                               mContext->GetAlarm(),
                               errorMsg,
-                              mReplacingAll,
+                              rule.mReplacingAll,
                               sName,
                               mContext->GetConfigName(),
                               mContext->GetProjectName(),
                               mContext->GetLogstoreName(),
                               mContext->GetRegion());
     }
-
-    mDiscardedEventsTotal = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_DISCARDED_EVENTS_TOTAL);
-    mOutFailedEventsTotal = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_OUT_FAILED_EVENTS_TOTAL);
-    mOutKeyNotFoundEventsTotal = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_OUT_KEY_NOT_FOUND_EVENTS_TOTAL);
-    mOutSuccessfulEventsTotal = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_OUT_SUCCESSFUL_EVENTS_TOTAL);
-
     return true;
 }
 
@@ -179,10 +246,10 @@ void ProcessorDesensitizeNative::ProcessEvent(PipelineEventPtr& e) {
         if (item.second.empty()) {
             continue;
         }
-        std::string value = item.second.to_string();
-        CastOneSensitiveWord(&value);
-        StringBuffer valueBuffer = sourceEvent.GetSourceBuffer()->CopyString(value);
-        sourceEvent.SetContentNoCopy(item.first, StringView(valueBuffer.data, valueBuffer.size));
+        StringView res;
+        if (CastSensitiveWords(item.second, sourceEvent, res)) {
+            sourceEvent.SetContentNoCopy(item.first, res);
+        }
         processed = true;
     }
     if (processed) {
@@ -196,55 +263,184 @@ void ProcessorDesensitizeNative::ProcessEvent(PipelineEventPtr& e) {
     }
 }
 
-void ProcessorDesensitizeNative::CastOneSensitiveWord(std::string* value) {
-    std::string* pVal = value;
-    bool rst = false;
+bool ProcessorDesensitizeNative::CastSensitiveWords(StringView value, LogEvent& event, StringView& res) const {
+    // processors may run in several threads, so scratch buffers are thread local rather than members
+    static thread_local std::vector<Replacement> sReplacements;
+    sReplacements.clear();
+    FindReplacements(value, sReplacements);
+    if (sReplacements.empty()) {
+        return false;
+    }
 
-    if (mMethod == DesensitizeMethod::CONST_OPTION) {
-        if (mReplacingAll) {
-            rst = RE2::GlobalReplace(pVal, *mRegex, mReplacingString);
+    size_t size = value.size();
+    for (const auto& r : sReplacements) {
+        size -= r.mEnd - r.mBegin;
+        if (!mRules[r.mRuleIdx].mLiteralReplacing) {
+            size += r.mRewritten.size();
+        } else if (mRules[r.mRuleIdx].mMethod == DesensitizeMethod::MD5_OPTION) {
+            size += sdk::MD5_BYTES * 2;
         } else {
-            rst = RE2::Replace(pVal, *mRegex, mReplacingString);
+            size += mRules[r.mRuleIdx].mReplacingString.size();
         }
-    } else {
-        re2::StringPiece srcStr(*pVal);
-        size_t maxSize = pVal->size();
-        size_t beginPos = 0;
-        rst = true;
-        std::string destStr;
-        do {
-            re2::StringPiece findRst;
-            if (!re2::RE2::FindAndConsume(&srcStr, *mRegex, &findRst)) {
-                if (beginPos == (size_t)0) {
-                    rst = false;
+    }
+
+    static const char* kHexTable = "0123456789ABCDEF";
+    StringBuffer buffer = event.GetSourceBuffer()->AllocateStringBuffer(size);
+    char* dst = buffer.data;
+    size_t pos = 0;
+    for (const auto& r : sReplacements) {
+        memcpy(dst, value.data() + pos, r.mBegin - pos);
+        dst += r.mBegin - pos;
+        const Rule& rule = mRules[r.mRuleIdx];
+        if (!rule.mLiteralReplacing) {
+            memcpy(dst, r.mRewritten.data(), r.mRewritten.size());
+            dst += r.mRewritten.size();
+        } else if (rule.mMethod == DesensitizeMethod::MD5_OPTION) {
+            uint8_t md5[sdk::MD5_BYTES];
+            sdk::DoMd5(reinterpret_cast<const uint8_t*>(value.data() + r.mBegin), r.mEnd - r.mBegin, md5);
+            for (size_t i = 0; i < sdk::MD5_BYTES; ++i) {
+                *dst++ = kHexTable[md5[i] >> 4];
+                *dst++ = kHexTable[md5[i] & 0x0F];
+            }
+        } else {
+            memcpy(dst, rule.mReplacingString.data(), rule.mReplacingString.size());
+            dst += rule.mReplacingString.size();
+        }
+        pos = r.mEnd;
+    }
+    memcpy(dst, value.data() + pos, value.size() - pos);
+    res = StringView(buffer.data, size);
+    return true;
+}
+
+namespace {
+
+// the same as how RE2::GlobalReplace steps over an empty match, @pos must be less than the size of @value
+size_t NextCharLength(StringView value, size_t pos) {
+    unsigned char c = static_cast<unsigned char>(value[pos]);
+    size_t len = c < 0x80 ? 1 : (c >> 5) == 0x06 ? 2 : (c >> 4) == 0x0E ? 3 : (c >> 3) == 0x1E ? 4 : 1;
+    return std::min(len, value.size() - pos);
+}
+
+} // namespace
+
+void ProcessorDesensitizeNative::FindReplacements(StringView value, std::vector<Replacement>& replacements) const {
+    // the next match of each rule which may still match
+    struct Candidate {
+        size_t mRuleIdx = 0;
+        bool mValid = false;
+        std::vector<re2::StringPiece> mGroups;
+    };
+    static thread_local std::vector<Candidate> sCandidates;
+    static thread_local std::vector<int> sMatchedRules;
+
+    re2::StringPiece text(value.data(), value.size());
+    sCandidates.clear();
+    bool tryAllRules = !mRuleSet;
+    if (mRuleSet) {
+        sMatchedRules.clear();
+        re2::RE2::Set::ErrorInfo errorInfo{re2::RE2::Set::kNoError};
+        if (mRuleSet->Match(text, &sMatchedRules, &errorInfo)) {
+            std::sort(sMatchedRules.begin(), sMatchedRules.end());
+            for (int idx : sMatchedRules) {
+                sCandidates.emplace_back();
+                sCandidates.back().mRuleIdx = idx;
+            }
+        } else if (errorInfo.kind == re2::RE2::Set::kNoError) {
+            return;
+        } else {
+            // e.g. the DFA runs out of memory on a long value, which must not leave the value unmasked
+            tryAllRules = true;
+        }
+    }
+    if (tryAllRules) {
+        for (size_t idx = 0; idx < mRules.size(); ++idx) {
+            sCandidates.emplace_back();
+            sCandidates.back().mRuleIdx = idx;
+        }
+    }
+
+    auto search = [&](Candidate& c, size_t from) {
+        const Rule& rule = mRules[c.mRuleIdx];
+        // group 1 is all a literal replacement needs
+        int n = rule.mLiteralReplacing ? 2 : 1 + rule.mRegex->NumberOfCapturingGroups();
+        c.mGroups.resize(n);
+        c.mValid = from <= value.size()
+            && rule.mRegex->Match(text, from, value.size(), re2::RE2::UNANCHORED, c.mGroups.data(), n);
+    };
+    for (auto& c : sCandidates) {
+        search(c, 0);
+    }
+
+    // Matches of all rules are merged in a single left to right pass, as if RE2::GlobalReplace is applied with
+    // an alternation of all rules.
+    size_t pos = 0;
+    size_t lastEnd = std::string::npos;
+    while (true) {
+        Candidate* best = nullptr;
+        size_t bestBegin = 0;
+        for (auto& c : sCandidates) {
+            while (c.mValid) {
+                size_t begin = c.mGroups[0].data() - value.data();
+                if (begin < pos) {
+                    // overlaps the previous replacement
+                    search(c, pos);
+                } else if (c.mGroups[0].empty() && begin == lastEnd) {
+                    // empty match right after the previous replacement is not allowed, and nothing is left to match
+                    // at the end of the value
+                    if (begin >= value.size()) {
+                        c.mValid = false;
+                    } else {
+                        search(c, begin + NextCharLength(value, begin));
+                    }
+                } else {
+                    if (best == nullptr || begin < bestBegin) {
+                        best = &c;
+                        bestBegin = begin;
+                    }
+                    break;
                 }
-                break;
             }
-            // like  xxxx, psw=123abc,xx
-            size_t beginOffset = findRst.data() + findRst.size() - pVal->data();
-            size_t endOffset = srcStr.empty() ? maxSize : srcStr.data() - pVal->data();
-            if (beginOffset < beginPos || endOffset <= beginPos || endOffset > maxSize) {
-                rst = false;
-                break;
+        }
+        if (best == nullptr) {
+            break;
+        }
+
+        const Rule& rule = mRules[best->mRuleIdx];
+        const re2::StringPiece& match = best->mGroups[0];
+        size_t matchEnd = match.data() + match.size() - value.data();
+        if (!rule.mLiteralReplacing) {
+            replacements.emplace_back();
+            replacements.back().mBegin = bestBegin;
+            replacements.back().mEnd = matchEnd;
+            replacements.back().mRuleIdx = best->mRuleIdx;
+            rule.mRegex->Rewrite(&replacements.back().mRewritten,
+                                 "\\1" + rule.mReplacingString,
+                                 best->mGroups.data(),
+                                 static_cast<int>(best->mGroups.size()));
+        } else {
+            // content matching ContentPatternBeforeReplacedString is kept
+            size_t begin = best->mGroups[1].data() + best->mGroups[1].size() - value.data();
+            if (rule.mMethod == DesensitizeMethod::CONST_OPTION || begin < matchEnd) {
+                replacements.emplace_back();
+                replacements.back().mBegin = begin;
+                replacements.back().mEnd = matchEnd;
+                replacements.back().mRuleIdx = best->mRuleIdx;
             }
-            // add : xxxx, psw
-            destStr.append(pVal->substr(beginPos, beginOffset - beginPos));
-            // md5: 123abc
-            destStr.append(sdk::CalcMD5(pVal->substr(beginOffset, endOffset - beginOffset)));
-            beginPos = endOffset;
-            // refine for  : xxxx. psw=123abc
-            if (endOffset >= maxSize) {
+        }
+
+        lastEnd = matchEnd;
+        pos = matchEnd;
+        if (match.empty()) {
+            if (pos >= value.size()) {
                 break;
             }
-        } while (mReplacingAll);
-
-        if (rst && beginPos < pVal->size()) {
-            // add ,xx
-            destStr.append(pVal->substr(beginPos));
+            pos += NextCharLength(value, pos);
         }
-        if (rst) {
-            *value = destStr;
-            pVal = value;
+        if (rule.mReplacingAll) {
+            search(*best, pos);
+        } else {
+            best->mValid = false;
         }
     }
 }
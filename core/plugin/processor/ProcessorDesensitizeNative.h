@@ -17,6 +17,10 @@
 #pragma once
 
 #include <re2/re2.h>
+#include <re2/set.h>
+
+#include <memory>
+#include <vector>
 
 #include "pipeline/plugin/interface/Processor.h"
 
@@ -28,33 +32,59 @@ public:
 
     enum class DesensitizeMethod { MD5_OPTION, CONST_OPTION };
 
+    struct Rule {
+        // Desensitization method. Optional values include:
+        // ● const: Replace sensitive content with constants.
+        // ● md5: Replace the corresponding content with the MD5 value of the sensitive content.
+        DesensitizeMethod mMethod = DesensitizeMethod::CONST_OPTION;
+        // A constant string used to replace sensitive content.
+        std::string mReplacingString;
+        // Prefix regular expression for sensitive content.
+        std::string mContentPatternBeforeReplacedString;
+        // Regular expression for sensitive content.
+        std::string mReplacedContentPattern;
+        // Whether to replace all matching sensitive content.
+        bool mReplacingAll = true;
+
+        // (ContentPatternBeforeReplacedString)ReplacedContentPattern
+        std::shared_ptr<re2::RE2> mRegex;
+        // ReplacingString contains no rewrite sequences (e.g. \1), so it is copied as it is
+        bool mLiteralReplacing = true;
+    };
+
     const std::string& Name() const override { return sName; }
     bool Init(const Json::Value& config) override;
     void Process(PipelineEventGroup& logGroup) override;
 
     // Source field name.
     std::string mSourceKey;
-    // Desensitization method. Optional values include:
-    // ● const: Replace sensitive content with constants.
-    // ● md5: Replace the corresponding content with the MD5 value of the sensitive content.
-    DesensitizeMethod mMethod;
-    // A constant string used to replace sensitive content.
-    std::string mReplacingString;
-    // Prefix regular expression for sensitive content.
-    std::string mContentPatternBeforeReplacedString;
-    // Regular expression for sensitive content.
-    std::string mReplacedContentPattern;
-    // Whether to replace all matching sensitive content.
-    bool mReplacingAll = true;
+    // Rules given by param Rules, or the single rule given by top level params. All rules are applied in one pass
+    // over the value: at each position the leftmost match among all rules is replaced, and the earlier rule wins
+    // if several rules match at the same position.
+    std::vector<Rule> mRules;
 
 protected:
     bool IsSupportedEvent(const PipelineEventPtr& e) const override;
 
 private:
+    // A span of the value to be replaced, the text before mBegin is kept.
+    struct Replacement {
+        size_t mBegin = 0;
+        size_t mEnd = 0;
+        size_t mRuleIdx = 0;
+        // rewritten replacement if the rule is not mLiteralReplacing
+        std::string mRewritten;
+    };
+
+    bool ParseRule(const Json::Value& config, Rule& rule);
     void ProcessEvent(PipelineEventPtr& e);
-    void CastOneSensitiveWord(std::string* value);
+    // CastSensitiveWords writes the desensitized @value to the source buffer of @event, and returns false if there
+    // is nothing to replace.
+    bool CastSensitiveWords(StringView value, LogEvent& event, StringView& res) const;
+    void FindReplacements(StringView value, std::vector<Replacement>& replacements) const;
 
-    std::shared_ptr<re2::RE2> mRegex;
+    // only used if there are more than one rule, to skip rules not matching the value at all
+    std::unique_ptr<re2::RE2::Set> mRuleSet;
 
     CounterPtr mDiscardedEventsTotal;
     CounterPtr mOutFailedEventsTotal;
@@ -63,6 +93,7 @@ private:
 
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class ProcessorParseApsaraNativeUnittest;
+    friend class ProcessorDesensitizeNativeUnittest;
 #endif
 };
 
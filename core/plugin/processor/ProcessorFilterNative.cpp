@@ -19,6 +19,7 @@
 #include <vector>
 
 #include "common/ParamExtractor.h"
+#include "common/Utf8Util.h"
 #include "logger/Logger.h"
 #include "models/LogEvent.h"
 #include "monitor/metric_constants/MetricConstants.h"
@@ -217,27 +218,7 @@ bool ProcessorFilterNative::ProcessEvent(PipelineEventPtr& e) {
         res = FilterFilterRule(sourceEvent, mFilterRule.get());
     }
     if (res && mDiscardingNonUTF8) {
-        std::vector<std::pair<StringView, StringView> > newContents;
-        for (auto &content: sourceEvent) {
-            if (CheckNoneUtf8(content.second)) {
-                auto value = content.second.to_string();
-                FilterNoneUtf8(value);
-                StringBuffer valueBuffer = sourceEvent.GetSourceBuffer()->CopyString(value);
-                content.second = StringView(valueBuffer.data, valueBuffer.size);
-            }
-            if (CheckNoneUtf8(content.first)) {
-                // key
-                auto key = content.first.to_string();
-                FilterNoneUtf8(key);
-                StringBuffer keyBuffer = sourceEvent.GetSourceBuffer()->CopyString(key);
-
-                newContents.emplace_back(StringView(keyBuffer.data, keyBuffer.size), content.second);
-                sourceEvent.DelContent(content.first);
-                        }
-        }
-        for (auto& newContent : newContents) {
-            sourceEvent.SetContentNoCopy(newContent.first, newContent.second);
-        }
+        ReplaceNonUtf8Contents(sourceEvent);
     }
 
     return res;
@@ -309,97 +290,12 @@ bool ProcessorFilterNative::IsMatched(const LogEvent& contents, const LogFilterR
     return true;
 }
 
-static const char UTF8_BYTE_PREFIX = 0x80;
-static const char UTF8_BYTE_MASK = 0xc0;
-
 bool ProcessorFilterNative::CheckNoneUtf8(const StringView& strSrc) {
-    return noneUtf8(const_cast<StringView&>(strSrc), false);
+    return !IsValidUtf8(strSrc);
 }
 
 void ProcessorFilterNative::FilterNoneUtf8(std::string& strSrc) {
-    StringView strView(strSrc.data(), strSrc.size());
-    noneUtf8(strView, true);
-}
-
-bool ProcessorFilterNative::noneUtf8(StringView& str, bool modify) {
-#define FILL_BLUNK_AND_CONTINUE_IF_TRUE(stat) \
-    if (stat) { \
-        if (!modify) { \
-            return true; \
-        } \
-        const_cast<char&>(*iter) = ' '; \
-        ++iter; \
-        continue; \
-    };
-
-    auto iter = str.begin();
-    while (iter != str.end()) {
-        uint16_t unicode = 0;
-        char c;
-        if ((*iter & 0x80) == 0x00) // one byte
-        {
-            /**
-             * mapping rule: 0000 0000 - 0000 007F | 0xxxxxxx
-             */
-            // nothing to check
-        } else if ((*iter & 0xe0) == 0xc0) // two bytes
-        {
-            /**
-             * mapping rule: 0000 0080 - 0000 07FF | 110xxxxx 10xxxxxx
-             */
-            c = *iter;
-            FILL_BLUNK_AND_CONTINUE_IF_TRUE(iter + 1 == str.end());
-            /* check whether the byte is in format 10xxxxxx */
-            FILL_BLUNK_AND_CONTINUE_IF_TRUE((*(iter + 1) & UTF8_BYTE_MASK) != UTF8_BYTE_PREFIX);
-            /* get unicode value */
-            unicode = (((c & 0x1f) << 6) | (*(iter + 1) & 0x3f));
-            /* validate unicode range */
-            FILL_BLUNK_AND_CONTINUE_IF_TRUE(!(unicode >= 0x80 && unicode <= 0x7ff));
-            ++iter;
-        } else if ((*iter & 0xf0) == 0xe0) // three bytes
-        {
-            /**
-             * mapping rule: 0000 0800 - 0000 FFFF | 1110xxxx 10xxxxxx 10xxxxxx
-             */
-            c = *iter;
-            FILL_BLUNK_AND_CONTINUE_IF_TRUE((iter + 1 == str.end()) || (iter + 2 == str.end()));
-            /* check whether the byte is in format 10xxxxxx */
-            FILL_BLUNK_AND_CONTINUE_IF_TRUE((*(iter + 1) & UTF8_BYTE_MASK) != UTF8_BYTE_PREFIX);
-            FILL_BLUNK_AND_CONTINUE_IF_TRUE((*(iter + 2) & UTF8_BYTE_MASK) != UTF8_BYTE_PREFIX);
-            /* get unicode value */
-            unicode = (((c & 0x0f) << 12) | ((*(iter + 1) & 0x3f) << 6) | (*(iter + 2) & 0x3f));
-            /* validate unicode range */
-            FILL_BLUNK_AND_CONTINUE_IF_TRUE(!(unicode >= 0x800 /* && unicode <= 0xffff */));
-            ++iter;
-            ++iter;
-        } else if ((*iter & 0xf8) == 0xf0) // four bytes
-        {
-            /**
-             * mapping rule: 0001 0000 - 0010 FFFF | 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
-             */
-            c = *iter;
-            FILL_BLUNK_AND_CONTINUE_IF_TRUE((iter + 1 == str.end()) || (iter + 2 == str.end())
-                                            || (iter + 3 == str.end()));
-            /* check whether the byte is in format 10xxxxxx */
-            FILL_BLUNK_AND_CONTINUE_IF_TRUE((*(iter + 1) & UTF8_BYTE_MASK) != UTF8_BYTE_PREFIX);
-            FILL_BLUNK_AND_CONTINUE_IF_TRUE((*(iter + 2) & UTF8_BYTE_MASK) != UTF8_BYTE_PREFIX);
-            FILL_BLUNK_AND_CONTINUE_IF_TRUE((*(iter + 3) & UTF8_BYTE_MASK) != UTF8_BYTE_PREFIX);
-            /* get unicode value */
-            uint32_t unicode = 0x00000000; // for 4 bytes utf-8 encoding
-            unicode = ((c & 0x07) << 18) | ((*(iter + 1) & 0x3f) << 12) | ((*(iter + 2) & 0x3f) << 6)
-                | ((*(iter + 3) & 0x3f));
-            /* validate unicode range */
-            FILL_BLUNK_AND_CONTINUE_IF_TRUE(!(unicode >= 0x00010000 && unicode <= 0x0010ffff));
-            ++iter;
-            ++iter;
-            ++iter;
-        } else {
-            FILL_BLUNK_AND_CONTINUE_IF_TRUE(true);
-        }
-        ++iter;
-    }
-#undef FILL_BLUNK_AND_CONTINUE_IF_TRUE
-    return false;
+    ReplaceNonUtf8(&strSrc[0], strSrc.size());
 }
 
 BaseFilterNodePtr ParseExpressionFromJSON(const Json::Value& value) {
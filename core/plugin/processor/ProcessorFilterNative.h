@@ -133,7 +133,6 @@ private:
     bool FilterFilterRule(LogEvent& sourceEvent, const LogFilterRule* filterRule);
     bool IsMatched(const LogEvent& contents, const LogFilterRule& rule);
 
-    bool noneUtf8(StringView& strSrc, bool modify);
     bool CheckNoneUtf8(const StringView& strSrc);
     void FilterNoneUtf8(std::string& strSrc);
 
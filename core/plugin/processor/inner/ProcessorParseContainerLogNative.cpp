@@ -20,8 +20,11 @@
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
-#include <codecvt>
-#include <locale>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <cstring>
 
 #include "common/JsonUtil.h"
 #include "common/ParamExtractor.h"
@@ -184,8 +187,9 @@ bool ProcessorParseContainerLogNative::ParseContainerdTextLogLine(LogEvent& sour
 
     // 寻找第一个分隔符位置 时间 _time_
     StringView timeValue;
-    const char* pch1 = std::find(contentValue.begin(), contentValue.end(), CONTAINERD_DELIMITER);
-    if (pch1 == contentValue.end()) {
+    const char* pch1
+        = static_cast<const char*>(memchr(contentValue.data(), CONTAINERD_DELIMITER, contentValue.size()));
+    if (pch1 == nullptr) {
         std::ostringstream errorMsgStream;
         errorMsgStream << "time field cannot be found in log line."
                        << "\tfirst 1KB log:" << contentValue.substr(0, 1024).to_string();
@@ -196,8 +200,9 @@ bool ProcessorParseContainerLogNative::ParseContainerdTextLogLine(LogEvent& sour
 
     // 寻找第二个分隔符位置 容器标签 _source_
     StringView sourceValue;
-    const char* pch2 = std::find(pch1 + 1, contentValue.end(), CONTAINERD_DELIMITER);
-    if (pch2 == contentValue.end()) {
+    const char* pch2
+        = static_cast<const char*>(memchr(pch1 + 1, CONTAINERD_DELIMITER, contentValue.end() - pch1 - 1));
+    if (pch2 == nullptr) {
         std::ostringstream errorMsgStream;
         errorMsgStream << "source field cannot be found in log line."
                        << "\tfirst 1KB log:" << contentValue.substr(0, 1024).to_string();
@@ -235,9 +240,9 @@ bool ProcessorParseContainerLogNative::ParseContainerdTextLogLine(LogEvent& sour
         return true;
     }
 
-    // 寻找第三个分隔符位置
-    const char* pch3 = std::find(pch2 + 1, contentValue.end(), CONTAINERD_DELIMITER);
-    if (pch3 == contentValue.end() || pch3 != pch2 + 2) {
+    // 第三个分隔符须紧跟在标签之后
+    const char* pch3 = pch2 + 2;
+    if (pch3 >= contentValue.end() || *pch3 != CONTAINERD_DELIMITER) {
         // case: 2021-08-25T07:00:00.000000000Z stdout P
         // case: 2021-08-25T07:00:00.000000000Z stdout PP 1
         StringView content = StringView(pch2 + 1, contentValue.end() - pch2 - 1);
@@ -260,6 +265,10 @@ bool ProcessorParseContainerLogNative::ParseContainerdTextLogLine(LogEvent& sour
     }
 }
 
+static bool isValidStream(StringView stream) {
+    return stream == "stdout" || stream == "stderr";
+}
+
 static int32_t skipSpaces(char* buffer, int32_t idx, int32_t size) {
     while (idx < size && buffer[idx] == ' ') {
         ++idx;
@@ -295,168 +304,291 @@ static int32_t parseLogType(char* buffer, int32_t idx, int32_t size, DockerLogTy
     return idx;
 }
 
-std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t> convert;
+// findQuoteOrBackslash returns the first '"' or '\\' in [p, end), or end if there is none.
+static const char* findQuoteOrBackslash(const char* p, const char* end) {
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('\"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    while (end - p >= 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, backslash)));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+        p += 16;
+    }
+#else
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t highs = 0x8080808080808080ULL;
+    while (end - p >= 8) {
+        uint64_t block;
+        memcpy(&block, p, 8);
+        uint64_t q = block ^ (ones * '\"');
+        uint64_t b = block ^ (ones * '\\');
+        if ((((q - ones) & ~q) | ((b - ones) & ~b)) & highs) {
+            break;
+        }
+        p += 8;
+    }
+#endif
+    while (p < end && *p != '\"' && *p != '\\') {
+        ++p;
+    }
+    return p;
+}
 
-static int32_t parseValue(char* buffer, int32_t idx, int32_t size, DockerLogType logType, int32_t& endIndex) {
-    while (idx < size && buffer[idx] != '\"') {
-        if (buffer[idx] == '\\') {
-            if (logType != DockerLogType::Log) {
-                return -1;
-            }
-            ++idx; // skip escape char
-            if (idx >= size) {
-                return -1;
-            }
-            switch (buffer[idx]) {
-                case '\"':
-                    buffer[endIndex++] = '\"';
-                    break;
-                case '\\':
-                    buffer[endIndex++] = '\\';
-                    break;
-                case '/':
-                    buffer[endIndex++] = '/';
-                    break;
-                case 'b':
-                    buffer[endIndex++] = '\b';
-                    break;
-                case 'f':
-                    buffer[endIndex++] = '\f';
-                    break;
-                case 'n':
-                    buffer[endIndex++] = '\n';
-                    break;
-                case 'r':
-                    buffer[endIndex++] = '\r';
-                    break;
-                case 't':
-                    buffer[endIndex++] = '\t';
+// scanValue returns the index of the quote closing the string starting at @idx, or -1 if it is not closed. Escape
+// sequences are skipped but not decoded, and @hasEscape is set if there is any.
+static int32_t scanValue(const char* buffer, int32_t idx, int32_t size, bool& hasEscape) {
+    const char* p = buffer + idx;
+    const char* end = buffer + size;
+    while (true) {
+        p = findQuoteOrBackslash(p, end);
+        if (p == end) {
+            return -1;
+        }
+        if (*p == '\"') {
+            return p - buffer;
+        }
+        hasEscape = true;
+        if (end - p < 2) {
+            return -1;
+        }
+        p += 2;
+    }
+}
+
+static int32_t parseHex4(const char* p) {
+    int32_t res = 0;
+    for (int i = 0; i < 4; ++i) {
+        char c = p[i];
+        res <<= 4;
+        if (c >= '0' && c <= '9') {
+            res |= c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            res |= c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            res |= c - 'A' + 10;
+        } else {
+            return -1;
+        }
+    }
+    return res;
+}
+
+static char* writeUtf8(uint32_t codePoint, char* dst) {
+    if (codePoint < 0x80) {
+        *dst++ = static_cast<char>(codePoint);
+    } else if (codePoint < 0x800) {
+        *dst++ = static_cast<char>(0xC0 | (codePoint >> 6));
+        *dst++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else if (codePoint < 0x10000) {
+        *dst++ = static_cast<char>(0xE0 | (codePoint >> 12));
+        *dst++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        *dst++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else {
+        *dst++ = static_cast<char>(0xF0 | (codePoint >> 18));
+        *dst++ = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        *dst++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        *dst++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+    return dst;
+}
+
+// unescapeValue decodes escape sequences in [begin, end) in place and returns the new end. The decoded value is never
+// longer than the escaped one. Unknown or malformed escape sequences are kept as they are.
+static char* unescapeValue(char* begin, char* end) {
+    char* dst = begin;
+    const char* src = begin;
+    while (src < end) {
+        const char* bs = static_cast<const char*>(memchr(src, '\\', end - src));
+        if (bs == nullptr) {
+            memmove(dst, src, end - src);
+            dst += end - src;
+            break;
+        }
+        memmove(dst, src, bs - src);
+        dst += bs - src;
+        src = bs + 1;
+        if (src == end) {
+            *dst++ = '\\';
+            break;
+        }
+        switch (*src) {
+            case '\"':
+                *dst++ = '\"';
+                break;
+            case '\\':
+                *dst++ = '\\';
+                break;
+            case '/':
+                *dst++ = '/';
+                break;
+            case 'b':
+                *dst++ = '\b';
+                break;
+            case 'f':
+                *dst++ = '\f';
+                break;
+            case 'n':
+                *dst++ = '\n';
+                break;
+            case 'r':
+                *dst++ = '\r';
+                break;
+            case 't':
+                *dst++ = '\t';
+                break;
+            default: {
+                int32_t codePoint = -1;
+                if (*src == 'u' && end - src > 4) {
+                    codePoint = parseHex4(src + 1);
+                }
+                if (codePoint < 0) {
+                    *dst++ = '\\';
+                    *dst++ = *src;
                     break;
-                default:
-                    if (idx + 4 < size && buffer[idx] == 'u') {
-                        std::string unicode_seq;
-                        unicode_seq.append(buffer + idx + 1, 4);
-                        char32_t unicode_char = std::stoul(unicode_seq, nullptr, 16);
-                        std::string res = convert.to_bytes(unicode_char);
-                        for (size_t i = 0; i < res.size(); ++i) {
-                            buffer[endIndex++] = res[i];
-                        }
-                        idx += 4;
-                    } else {
-                        buffer[endIndex++] = '\\';
-                        buffer[endIndex++] = buffer[idx];
+                }
+                src += 4;
+                if (codePoint >= 0xD800 && codePoint <= 0xDBFF && end - src > 6 && src[1] == '\\' && src[2] == 'u') {
+                    int32_t low = parseHex4(src + 3);
+                    if (low >= 0xDC00 && low <= 0xDFFF) {
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                        src += 6;
                     }
-                    break;
+                }
+                if (codePoint >= 0xD800 && codePoint <= 0xDFFF) {
+                    // lone surrogate, which cannot be encoded in UTF-8
+                    codePoint = 0xFFFD;
+                }
+                dst = writeUtf8(codePoint, dst);
+                break;
             }
-        } else {
-            buffer[endIndex++] = buffer[idx];
         }
-        ++idx;
+        ++src;
     }
-    return idx;
+    return dst;
 }
 
 // buffer: {"log":"Hello, World!","stream":"stdout","time":"2021-12-01T00:00:00.000Z"}
+// Only the shape written by docker json-file driver is accepted: exactly the 3 fields in any order, separated by
+// spaces at most, escape sequences only in log, and stream being either stdout or stderr. The buffer is checked before
+// the log value is unescaped in place, so it is left untouched if false is returned.
 bool ProcessorParseContainerLogNative::ParseDockerLog(char* buffer, int32_t size, DockerLog& dockerLog) {
     if (size == 0 || buffer[0] != '{' || buffer[size - 1] != '}') {
         return false;
     }
-    int logTypeCnt = 0;
-    int32_t endIndex = 0;
+    bool seen[3] = {false, false, false};
+    StringView values[3];
+    bool logHasEscape = false;
     int32_t idx = 1; // skip '{'
-    DockerLogType logType;
-    while (idx < size) {
+    for (int cnt = 0; cnt < 3; ++cnt) {
         idx = skipSpaces(buffer, idx, size);
-        if (idx >= size) {
-            return false;
-        }
-        // skip '}'
-        if (buffer[idx] == '}') {
-            if (idx == size - 1) {
-                return true;
-            }
-            return false;
-        }
-
-        if (buffer[idx] != '\"') {
+        // skip '"'
+        if (idx >= size || buffer[idx] != '\"') {
             return false;
         }
         ++idx;
 
+        DockerLogType logType;
         idx = parseLogType(buffer, idx, size, logType);
         if (idx == -1) {
             return false;
         }
-        ++logTypeCnt;
+        int type = static_cast<int>(logType);
+        if (seen[type]) {
+            return false;
+        }
+        seen[type] = true;
 
-        // skip '\"'
+        // skip '"'
         if (buffer[idx] != '\"') {
             return false;
         }
         ++idx;
         idx = skipSpaces(buffer, idx, size);
-        if (idx >= size) {
-            return false;
-        }
-
         // skip ':'
-        if (buffer[idx] != ':') {
+        if (idx >= size || buffer[idx] != ':') {
             return false;
         }
         ++idx;
         idx = skipSpaces(buffer, idx, size);
-        if (idx >= size) {
-            return false;
-        }
-
         // skip '"'
-        if (buffer[idx] != '\"') {
+        if (idx >= size || buffer[idx] != '\"') {
             return false;
         }
         ++idx;
-        if (idx >= size) {
-            return false;
-        }
 
-        endIndex = idx;
-        char* valueBegion = buffer + endIndex;
-        idx = parseValue(buffer, idx, size, logType, endIndex);
-        if (idx == -1) {
+        bool hasEscape = false;
+        int32_t valueEnd = scanValue(buffer, idx, size, hasEscape);
+        if (valueEnd == -1 || (hasEscape && logType != DockerLogType::Log)) {
             return false;
         }
-
-        ++idx; // skip '\"'
-        idx = skipSpaces(buffer, idx, size);
+        if (logType == DockerLogType::Log) {
+            logHasEscape = hasEscape;
+        }
+        values[type] = StringView(buffer + idx, valueEnd - idx);
+        idx = skipSpaces(buffer, valueEnd + 1, size);
         if (idx >= size) {
             return false;
         }
-
-        // skip ','
-        if (logTypeCnt < 3) {
+        if (cnt < 2) {
+            // skip ','
             if (buffer[idx] != ',') {
                 return false;
-            } else {
-                ++idx;
             }
+            ++idx;
         }
-        idx = skipSpaces(buffer, idx, size);
-        if (idx >= size) {
-            return false;
-        }
+    }
+    if (idx != size - 1) {
+        return false;
+    }
+    if (!isValidStream(values[static_cast<int>(DockerLogType::Stream)])) {
+        return false;
+    }
 
-        switch (logType) {
-            case DockerLogType::Log:
-                dockerLog.log = StringView(valueBegion, endIndex - (valueBegion - buffer));
-                break;
-            case DockerLogType::Stream:
-                dockerLog.stream = StringView(valueBegion, endIndex - (valueBegion - buffer));
-                break;
-            case DockerLogType::Time:
-                dockerLog.time = StringView(valueBegion, endIndex - (valueBegion - buffer));
-                break;
-        }
+    StringView log = values[static_cast<int>(DockerLogType::Log)];
+    if (logHasEscape) {
+        char* begin = const_cast<char*>(log.data());
+        log = StringView(begin, unescapeValue(begin, begin + log.size()) - begin);
     }
+    dockerLog.log = log;
+    dockerLog.stream = values[static_cast<int>(DockerLogType::Stream)];
+    dockerLog.time = values[static_cast<int>(DockerLogType::Time)];
+    return true;
+}
 
+// ParseDockerLogByRapidJson is the fallback for lines in shapes ParseDockerLog does not accept, e.g. with extra
+// fields. Decoded values are written back to @buffer one after another, which is large enough since each of them is
+// no longer than its escaped form. Stream must be either stdout or stderr, and the buffer is left untouched if false is
+// returned.
+bool ProcessorParseContainerLogNative::ParseDockerLogByRapidJson(char* buffer, int32_t size, DockerLog& dockerLog) {
+    rapidjson::Document doc;
+    doc.Parse(buffer, size);
+    if (doc.HasParseError() || !doc.IsObject()) {
+        return false;
+    }
+    const rapidjson::Value* values[3];
+    const std::string* keys[3] = {&DOCKER_JSON_LOG, &DOCKER_JSON_STREAM_TYPE, &DOCKER_JSON_TIME};
+    for (int i = 0; i < 3; ++i) {
+        auto itr = doc.FindMember(rapidjson::StringRef(keys[i]->data(), keys[i]->size()));
+        if (itr == doc.MemberEnd() || !itr->value.IsString()) {
+            return false;
+        }
+        values[i] = &itr->value;
+    }
+    const rapidjson::Value* stream = values[static_cast<int>(DockerLogType::Stream)];
+    if (!isValidStream(StringView(stream->GetString(), stream->GetStringLength()))) {
+        return false;
+    }
+    StringView* fields[3] = {&dockerLog.log, &dockerLog.stream, &dockerLog.time};
+    char* dst = buffer;
+    for (int i = 0; i < 3; ++i) {
+        size_t len = values[i]->GetStringLength();
+        memcpy(dst, values[i]->GetString(), len);
+        *fields[i] = StringView(dst, len);
+        dst += len;
+    }
     return true;
 }
 
@@ -468,26 +600,18 @@ bool ProcessorParseContainerLogNative::ParseDockerJsonLogLine(LogEvent& sourceEv
 
     char* data = const_cast<char*>(buffer.data());
 
-    if (ParseDockerLog(data, buffer.size(), entry)) {
+    if (ParseDockerLog(data, buffer.size(), entry) || ParseDockerLogByRapidJson(data, buffer.size(), entry)) {
         timeValue = entry.time;
         content = entry.log;
         sourceValue = entry.stream;
     } else {
         std::ostringstream errorMsgStream;
-        errorMsgStream << "docker stdout json log line is not a valid json obejct."
+        errorMsgStream << "docker stdout json log line is not a valid json obejct, or stream is not stdout or stderr."
                        << "\tfirst 1KB log:" << buffer.substr(0, 1024);
         errorMsg = errorMsgStream.str();
         return mKeepingSourceWhenParseFail;
     }
 
-    if (sourceValue.empty() || (sourceValue != "stdout" && sourceValue != "stderr")) {
-        std::ostringstream errorMsgStream;
-        errorMsgStream << "source field cannot be found in log line."
-                       << "sourceValue:\t" << sourceValue << "\tfirst 1KB log:" << buffer.substr(0, 1024).to_string();
-        errorMsg = errorMsgStream.str();
-        return mKeepingSourceWhenParseFail;
-    }
-
     if (sourceValue == "stdout") {
         mParseStdoutTotal->Add(1);
         if (mIgnoringStdout) {
@@ -66,6 +66,7 @@ protected:
 
 private:
     static bool ParseDockerLog(char* buffer, int32_t size, DockerLog& dockerLog);
+    static bool ParseDockerLogByRapidJson(char* buffer, int32_t size, DockerLog& dockerLog);
     bool ProcessEvent(StringView containerType, PipelineEventPtr& e, PipelineEventGroup& logGroup);
     bool ProcessEvent(StringView containerType, PipelineEventPtr& e);
     void ResetDockerJsonLogField(char* data, StringView key, StringView value, LogEvent& targetEvent);
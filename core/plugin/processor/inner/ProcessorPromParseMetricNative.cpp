@@ -2,6 +2,9 @@
 
 #include <json/json.h>
 
+#include <cstdlib>
+#include <optional>
+
 #include "common/StringTools.h"
 #include "models/MetricEvent.h"
 #include "models/PipelineEventGroup.h"
@@ -12,6 +15,54 @@
 using namespace std;
 namespace logtail {
 
+namespace {
+
+// whether a and b have the same labels, ignoring __name__ and the bucket or quantile label
+bool HasSameLabels(const MetricEvent& a, const MetricEvent& b, StringView ignoredKey) {
+    auto ia = a.TagsBegin();
+    auto ib = b.TagsBegin();
+    while (true) {
+        while (ia != a.TagsEnd() && (ia->first == prometheus::NAME || ia->first == ignoredKey)) {
+            ++ia;
+        }
+        while (ib != b.TagsEnd() && (ib->first == prometheus::NAME || ib->first == ignoredKey)) {
+            ++ib;
+        }
+        if (ia == a.TagsEnd() || ib == b.TagsEnd()) {
+            return ia == a.TagsEnd() && ib == b.TagsEnd();
+        }
+        if (ia->first != ib->first || ia->second != ib->second) {
+            return false;
+        }
+        ++ia;
+        ++ib;
+    }
+}
+
+// only boundaries formatted back to the same text are accepted, so that flattening the merged value reproduces the
+// original label values exactly
+bool ParseBoundary(StringView s, double& res) {
+    if (s.empty()) {
+        return false;
+    }
+    string str = s.to_string();
+    char* end = nullptr;
+    res = strtod(str.c_str(), &end);
+    return end == str.c_str() + str.size() && FormatMetricBoundary(res) == s;
+}
+
+bool IsSameSample(const MetricEvent& first, const PipelineEventPtr& e, StringView ignoredKey) {
+    if (!e.Is<MetricEvent>()) {
+        return false;
+    }
+    const auto& metricEvent = e.Cast<MetricEvent>();
+    return metricEvent.Is<UntypedSingleValue>() && metricEvent.GetTimestamp() == first.GetTimestamp()
+        && metricEvent.GetTimestampNanosecond() == first.GetTimestampNanosecond()
+        && HasSameLabels(first, metricEvent, ignoredKey);
+}
+
+} // namespace
+
 const string ProcessorPromParseMetricNative::sName = "processor_prom_parse_metric_native";
 
 // only for inner processor
@@ -40,10 +91,104 @@ void ProcessorPromParseMetricNative::Process(PipelineEventGroup& eGroup) {
     }
     events.swap(newEvents);
     eGroup.SetMetadata(EventGroupMetaKey::PROMETHEUS_SAMPLES_SCRAPED, ToString(events.size()));
+    if (mScrapeConfigPtr->mMergeHistogramAndSummary) {
+        MergeHistogramAndSummary(events);
+    }
+}
+
+void ProcessorPromParseMetricNative::MergeHistogramAndSummary(EventsContainer& events) const {
+    size_t wIdx = 0;
+    for (size_t rIdx = 0; rIdx < events.size();) {
+        size_t next = max(TryMerge(events, rIdx), rIdx + 1);
+        if (wIdx != rIdx) {
+            events[wIdx] = std::move(events[rIdx]);
+        }
+        ++wIdx;
+        rIdx = next;
+    }
+    events.resize(wIdx);
+}
+
+size_t ProcessorPromParseMetricNative::TryMerge(EventsContainer& events, size_t begin) const {
+    if (!events[begin].Is<MetricEvent>()) {
+        return begin;
+    }
+    auto& first = events[begin].Cast<MetricEvent>();
+    if (!first.Is<UntypedSingleValue>()) {
+        return begin;
+    }
+    StringView name = first.GetName();
+    StringView label;
+    StringView base;
+    if (name.ends_with(prometheus::BUCKET_SUFFIX) && first.HasTag(prometheus::BUCKET_LABEL)) {
+        label = prometheus::BUCKET_LABEL;
+        base = name.substr(0, name.size() - prometheus::BUCKET_SUFFIX.size());
+    } else if (first.HasTag(prometheus::QUANTILE_LABEL)) {
+        label = prometheus::QUANTILE_LABEL;
+        base = name;
+    } else {
+        return begin;
+    }
+
+    // buckets or quantiles come first, followed by _sum and _count in either order
+    vector<pair<double, double>> points;
+    size_t i = begin;
+    for (; i < events.size() && IsSameSample(first, events[i], label); ++i) {
+        const auto& e = events[i].Cast<MetricEvent>();
+        double boundary = 0.0;
+        if (e.GetName() != name || !ParseBoundary(e.GetTag(label), boundary)) {
+            break;
+        }
+        points.emplace_back(boundary, e.GetValue<UntypedSingleValue>()->mValue);
+    }
+    optional<double> sum;
+    optional<double> count;
+    for (; i < events.size() && !(sum && count) && IsSameSample(first, events[i], label); ++i) {
+        const auto& e = events[i].Cast<MetricEvent>();
+        StringView n = e.GetName();
+        if (!n.starts_with(base)) {
+            break;
+        }
+        n.remove_prefix(base.size());
+        if (!sum && n == prometheus::SUM_SUFFIX) {
+            sum = e.GetValue<UntypedSingleValue>()->mValue;
+        } else if (!count && n == prometheus::COUNT_SUFFIX) {
+            count = e.GetValue<UntypedSingleValue>()->mValue;
+        } else {
+            break;
+        }
+    }
+    if (!sum || !count) {
+        return begin;
+    }
+
+    if (label == prometheus::BUCKET_LABEL) {
+        HistogramValue v;
+        v.mSum = *sum;
+        v.mCount = *count;
+        v.mBuckets.reserve(points.size());
+        for (const auto& [upperBound, cnt] : points) {
+            v.mBuckets.push_back({upperBound, cnt});
+        }
+        first.SetValue(std::move(v));
+    } else {
+        SummaryValue v;
+        v.mSum = *sum;
+        v.mCount = *count;
+        v.mQuantiles.reserve(points.size());
+        for (const auto& [quantile, value] : points) {
+            v.mQuantiles.push_back({quantile, value});
+        }
+        first.SetValue(std::move(v));
+    }
+    first.SetNameNoCopy(base);
+    first.DelTag(label);
+    first.SetTagNoCopy(StringView(prometheus::NAME), base);
+    return i;
 }
 
 bool ProcessorPromParseMetricNative::IsSupportedEvent(const PipelineEventPtr& e) const {
-    return e.Is<RawEvent>();
+    return e.Is<RawEvent>() || e.Is<MetricEvent>();
 }
 
 bool ProcessorPromParseMetricNative::ProcessEvent(PipelineEventPtr& e,
@@ -53,10 +198,17 @@ bool ProcessorPromParseMetricNative::ProcessEvent(PipelineEventPtr& e,
     if (!IsSupportedEvent(e)) {
         return false;
     }
+    // events have already been parsed while the response is being received
+    if (e.Is<MetricEvent>()) {
+        auto& metricEvent = e.Cast<MetricEvent>();
+        metricEvent.SetTagNoCopy(StringView(prometheus::NAME), metricEvent.GetName());
+        newEvents.emplace_back(std::move(e));
+        return true;
+    }
     auto& sourceEvent = e.Cast<RawEvent>();
     std::unique_ptr<MetricEvent> metricEvent = eGroup.CreateMetricEvent(true);
     if (parser.ParseLine(sourceEvent.GetContent(), *metricEvent)) {
-        metricEvent->SetTag(string(prometheus::NAME), metricEvent->GetName());
+        metricEvent->SetTagNoCopy(StringView(prometheus::NAME), metricEvent->GetName());
         newEvents.emplace_back(std::move(metricEvent), true, nullptr);
     }
     return true;
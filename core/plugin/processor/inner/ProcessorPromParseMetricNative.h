@@ -22,6 +22,9 @@ protected:
 
 private:
     bool ProcessEvent(PipelineEventPtr&, EventsContainer&, PipelineEventGroup&, TextParser& parser);
+    void MergeHistogramAndSummary(EventsContainer& events) const;
+    // returns the index after the merged samples, or begin if nothing is merged
+    size_t TryMerge(EventsContainer& events, size_t begin) const;
     std::unique_ptr<ScrapeConfig> mScrapeConfigPtr;
 
 #ifdef APSARA_UNIT_TEST_MAIN
@@ -17,7 +17,10 @@
 
 #include <json/json.h>
 
+#include <xxhash/xxhash.h>
+
 #include <cstddef>
+#include <mutex>
 
 #include "common/Flags.h"
 #include "common/StringTools.h"
@@ -51,10 +54,18 @@ void ProcessorPromRelabelMetricNative::Process(PipelineEventGroup& metricGroup)
     auto toDelete = GetToDeleteTargetLabels(targetTags);
 
     if (!mScrapeConfigPtr->mMetricRelabelConfigs.Empty() || !targetTags.empty()) {
+        // series of the same target are relabeled with the outcome memoized in previous scrapes
+        shared_ptr<SeriesRelabelCache> cache;
+        unique_lock<mutex> cacheLock;
+        if (!mScrapeConfigPtr->mMetricRelabelConfigs.Empty()) {
+            auto [seriesCache, mux] = mRelabelCache.GetSeriesCache(GetTargetHash(targetTags));
+            cache = std::move(seriesCache);
+            cacheLock = unique_lock<mutex>(*mux);
+        }
         EventsContainer& events = metricGroup.MutableEvents();
         size_t wIdx = 0;
         for (size_t rIdx = 0; rIdx < events.size(); ++rIdx) {
-            if (ProcessEvent(events[rIdx], targetTags, toDelete)) {
+            if (ProcessEvent(events[rIdx], targetTags, toDelete, cache.get())) {
                 if (wIdx != rIdx) {
                     events[wIdx] = std::move(events[rIdx]);
                 }
@@ -62,6 +73,9 @@ void ProcessorPromRelabelMetricNative::Process(PipelineEventGroup& metricGroup)
             }
         }
         events.resize(wIdx);
+        if (cache) {
+            cache->EndScrape();
+        }
     }
 
     // delete mTags when key starts with __
@@ -83,7 +97,8 @@ bool ProcessorPromRelabelMetricNative::IsSupportedEvent(const PipelineEventPtr&
 
 bool ProcessorPromRelabelMetricNative::ProcessEvent(PipelineEventPtr& e,
                                                     const GroupTags& targetTags,
-                                                    const vector<StringView>& toDelete) {
+                                                    const vector<StringView>& toDelete,
+                                                    SeriesRelabelCache* cache) {
     if (!IsSupportedEvent(e)) {
         return false;
     }
@@ -105,9 +120,12 @@ bool ProcessorPromRelabelMetricNative::ProcessEvent(PipelineEventPtr& e,
     }
 
     vector<string> toDeleteInRelabel;
-    if (!mScrapeConfigPtr->mMetricRelabelConfigs.Empty()
-        && !mScrapeConfigPtr->mMetricRelabelConfigs.Process(sourceEvent, toDeleteInRelabel)) {
-        return false;
+    if (!mScrapeConfigPtr->mMetricRelabelConfigs.Empty()) {
+        bool keep = cache ? cache->Process(mScrapeConfigPtr->mMetricRelabelConfigs, sourceEvent, toDeleteInRelabel)
+                          : mScrapeConfigPtr->mMetricRelabelConfigs.Process(sourceEvent, toDeleteInRelabel);
+        if (!keep) {
+            return false;
+        }
     }
     // set metricEvent name
     sourceEvent.SetNameNoCopy(sourceEvent.GetTag(prometheus::NAME));
@@ -125,6 +143,15 @@ bool ProcessorPromRelabelMetricNative::ProcessEvent(PipelineEventPtr& e,
     return true;
 }
 
+uint64_t ProcessorPromRelabelMetricNative::GetTargetHash(const GroupTags& targetTags) const {
+    uint64_t h = 0;
+    for (const auto& [k, v] : targetTags) {
+        h = XXH64(k.data(), k.size(), h);
+        h = XXH64(v.data(), v.size(), h);
+    }
+    return h;
+}
+
 vector<StringView> ProcessorPromRelabelMetricNative::GetToDeleteTargetLabels(const GroupTags& targetTags) const {
     // delete tag which starts with __
     vector<StringView> toDelete;
@@ -150,7 +177,10 @@ void ProcessorPromRelabelMetricNative::AddAutoMetrics(PipelineEventGroup& metric
     auto timestamp = timestampMilliSec / 1000;
     auto nanoSec = timestampMilliSec % 1000 * 1000000;
 
-    uint64_t samplesPostMetricRelabel = metricGroup.GetEvents().size();
+    uint64_t samplesPostMetricRelabel = 0;
+    for (const auto& e : metricGroup.GetEvents()) {
+        samplesPostMetricRelabel += e.Is<MetricEvent>() ? SeriesCount(e.Cast<MetricEvent>().GetMetricValue()) : 1;
+    }
 
     auto scrapeDurationSeconds
         = StringTo<double>(metricGroup.GetMetadata(EventGroupMetaKey::PROMETHEUS_SCRAPE_DURATION).to_string());
@@ -21,6 +21,7 @@
 #include "models/PipelineEventGroup.h"
 #include "models/PipelineEventPtr.h"
 #include "pipeline/plugin/interface/Processor.h"
+#include "prometheus/labels/RelabelCache.h"
 #include "prometheus/schedulers/ScrapeConfig.h"
 
 namespace logtail {
@@ -36,7 +37,11 @@ protected:
     bool IsSupportedEvent(const PipelineEventPtr& e) const override;
 
 private:
-    bool ProcessEvent(PipelineEventPtr& e, const GroupTags& targetTags, const std::vector<StringView>& toDelete);
+    bool ProcessEvent(PipelineEventPtr& e,
+                      const GroupTags& targetTags,
+                      const std::vector<StringView>& toDelete,
+                      SeriesRelabelCache* cache);
+    uint64_t GetTargetHash(const GroupTags& targetTags) const;
     std::vector<StringView> GetToDeleteTargetLabels(const GroupTags& targetTags) const;
 
     void AddAutoMetrics(PipelineEventGroup& metricGroup);
@@ -49,6 +54,7 @@ private:
 
     std::unique_ptr<ScrapeConfig> mScrapeConfigPtr;
     std::string mLoongCollectorScraper;
+    RelabelCache mRelabelCache;
 
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class ProcessorPromRelabelMetricNativeUnittest;
@@ -24,6 +24,13 @@ const char* const MODULUS = "modulus";
 const char* const NAME = "__name__";
 const std::string EXPORTED_PREFIX = "exported_";
 
+// histogram and summary
+const char* const BUCKET_LABEL = "le";
+const char* const QUANTILE_LABEL = "quantile";
+const std::string BUCKET_SUFFIX = "_bucket";
+const std::string SUM_SUFFIX = "_sum";
+const std::string COUNT_SUFFIX = "_count";
+
 // prometheus api
 const char* const PROMETHEUS_PREFIX = "prometheus_";
 const char* const REGISTER_COLLECTOR_PATH = "/register_collector";
@@ -55,6 +62,7 @@ const char* const SAMPLE_LIMIT = "sample_limit";
 const char* const SERIES_LIMIT = "series_limit";
 const char* const MAX_SCRAPE_SIZE = "max_scrape_size";
 const char* const METRIC_RELABEL_CONFIGS = "metric_relabel_configs";
+const char* const MERGE_HISTOGRAM_AND_SUMMARY = "merge_histogram_and_summary";
 const char* const AUTHORIZATION = "authorization";
 const char* const AUTHORIZATION_DEFAULT_TYEP = "Bearer";
 const char* const A_UTHORIZATION = "Authorization";
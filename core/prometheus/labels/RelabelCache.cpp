@@ -0,0 +1,209 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "prometheus/labels/RelabelCache.h"
+
+#include <xxhash/xxhash.h>
+
+#include "common/Flags.h"
+
+DEFINE_FLAG_INT32(prom_relabel_cache_max_series_per_target,
+                  "max number of series whose metric relabel result is cached for each target, 0 to disable the cache",
+                  200000);
+DEFINE_FLAG_INT32(prom_relabel_cache_target_expire_secs,
+                  "relabel cache of a target is released if the target has not been scraped for this long",
+                  600);
+
+using namespace std;
+
+namespace logtail {
+
+InternedString LabelStringPool::Intern(StringView s) {
+    lock_guard<mutex> lock(mMux);
+    auto it = mStrings.find(string_view(s.data(), s.size()));
+    if (it != mStrings.end()) {
+        return it->second;
+    }
+    auto str = make_shared<const string>(s.data(), s.size());
+    mStrings.try_emplace(string_view(*str), str);
+    return str;
+}
+
+void LabelStringPool::Compact() {
+    lock_guard<mutex> lock(mMux);
+    for (auto it = mStrings.begin(); it != mStrings.end();) {
+        if (it->second.use_count() == 1) {
+            it = mStrings.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+size_t LabelStringPool::Size() const {
+    lock_guard<mutex> lock(mMux);
+    return mStrings.size();
+}
+
+uint64_t SeriesRelabelCache::HashLabels(const MetricEvent& e) {
+    // the name is hashed as well, since relabeling exposes it as the __name__ label. Tags are sorted by key, and the
+    // separator keeps {a="bc"} and {ab="c"} apart
+    static const char sSeparator = '\xff';
+    uint64_t h = XXH64(e.GetName().data(), e.GetName().size(), 0);
+    h = XXH64(&sSeparator, 1, h);
+    for (auto it = e.TagsBegin(); it != e.TagsEnd(); ++it) {
+        h = XXH64(it->first.data(), it->first.size(), h);
+        h = XXH64(&sSeparator, 1, h);
+        h = XXH64(it->second.data(), it->second.size(), h);
+        h = XXH64(&sSeparator, 1, h);
+    }
+    return h;
+}
+
+bool SeriesRelabelCache::SameLabels(const RelabelResult& res, const MetricEvent& e) {
+    if (StringView(*res.mName) != e.GetName() || res.mLabels.size() != e.TagsSize()) {
+        return false;
+    }
+    auto tag = e.TagsBegin();
+    for (const auto& [key, value] : res.mLabels) {
+        if (StringView(*key) != tag->first || StringView(*value) != tag->second) {
+            return false;
+        }
+        ++tag;
+    }
+    return true;
+}
+
+bool SeriesRelabelCache::Process(const RelabelConfigList& configs, MetricEvent& e, vector<string>& toDelete) {
+    uint64_t hash = HashLabels(e);
+    auto it = mSeries.find(hash);
+    if (it != mSeries.end()) {
+        auto& res = it->second;
+        if (!SameLabels(res, e)) {
+            // hash collision, the entry belongs to another series
+            return configs.Process(e, toDelete);
+        }
+        if (res.mLastSeenRound != mRound) {
+            res.mLastSeenRound = mRound;
+            ++mSeenCnt;
+        }
+        if (res.mDropped) {
+            return false;
+        }
+        for (const auto& key : res.mDelTags) {
+            e.DelTag(StringView(*key));
+        }
+        for (const auto& [key, value] : res.mSetTags) {
+            e.SetTag(StringView(*key), StringView(*value));
+        }
+        for (const auto& key : res.mToDelete) {
+            toDelete.push_back(*key);
+        }
+        return true;
+    }
+
+    if (mSeries.size() >= static_cast<size_t>(INT32_FLAG(prom_relabel_cache_max_series_per_target))) {
+        return configs.Process(e, toDelete);
+    }
+
+    // tags before relabeling, sorted by key
+    RelabelResult res;
+    res.mName = mPool.Intern(e.GetName());
+    res.mLabels.reserve(e.TagsSize());
+    for (auto tag = e.TagsBegin(); tag != e.TagsEnd(); ++tag) {
+        res.mLabels.emplace_back(mPool.Intern(tag->first), mPool.Intern(tag->second));
+    }
+    size_t toDeleteBegin = toDelete.size();
+    bool keep = configs.Process(e, toDelete);
+
+    res.mDropped = !keep;
+    res.mLastSeenRound = mRound;
+    if (keep) {
+        auto prev = res.mLabels.begin();
+        auto cur = e.TagsBegin();
+        while (prev != res.mLabels.end() || cur != e.TagsEnd()) {
+            if (cur == e.TagsEnd() || (prev != res.mLabels.end() && StringView(*prev->first) < cur->first)) {
+                res.mDelTags.emplace_back(prev->first);
+                ++prev;
+            } else if (prev == res.mLabels.end() || cur->first < StringView(*prev->first)) {
+                res.mSetTags.emplace_back(mPool.Intern(cur->first), mPool.Intern(cur->second));
+                ++cur;
+            } else {
+                if (cur->second != StringView(*prev->second)) {
+                    res.mSetTags.emplace_back(mPool.Intern(cur->first), mPool.Intern(cur->second));
+                }
+                ++prev;
+                ++cur;
+            }
+        }
+        for (size_t i = toDeleteBegin; i < toDelete.size(); ++i) {
+            res.mToDelete.emplace_back(mPool.Intern(toDelete[i]));
+        }
+    }
+    mSeries.try_emplace(hash, std::move(res));
+    ++mSeenCnt;
+    return keep;
+}
+
+void SeriesRelabelCache::EndScrape() {
+    if (mSeenCnt < mSeries.size()) {
+        for (auto it = mSeries.begin(); it != mSeries.end();) {
+            if (it->second.mLastSeenRound != mRound) {
+                it = mSeries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    ++mRound;
+    mSeenCnt = 0;
+}
+
+pair<shared_ptr<SeriesRelabelCache>, shared_ptr<mutex>> RelabelCache::GetSeriesCache(uint64_t targetHash) {
+    time_t now = time(nullptr);
+    lock_guard<mutex> lock(mMux);
+    ClearExpiredTargetCaches(now);
+    auto& item = mTargetCaches[targetHash];
+    if (!item.mCache) {
+        item.mCache = make_shared<SeriesRelabelCache>(mPool);
+        item.mMux = make_shared<mutex>();
+    }
+    item.mLastUsedTime = now;
+    return {item.mCache, item.mMux};
+}
+
+size_t RelabelCache::Size() const {
+    lock_guard<mutex> lock(mMux);
+    return mTargetCaches.size();
+}
+
+void RelabelCache::ClearExpiredTargetCaches(time_t now) {
+    if (now - mLastClearTime < INT32_FLAG(prom_relabel_cache_target_expire_secs) / 10) {
+        return;
+    }
+    mLastClearTime = now;
+    for (auto it = mTargetCaches.begin(); it != mTargetCaches.end();) {
+        if (now - it->second.mLastUsedTime >= INT32_FLAG(prom_relabel_cache_target_expire_secs)) {
+            it = mTargetCaches.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    // strings of series evicted by EndScrape are released here as well
+    mPool.Compact();
+}
+
+} // namespace logtail
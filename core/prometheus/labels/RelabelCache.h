@@ -0,0 +1,114 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "models/MetricEvent.h"
+#include "prometheus/labels/Relabel.h"
+
+namespace logtail {
+
+using InternedString = std::shared_ptr<const std::string>;
+
+// Label names and values kept by the relabel cache are interned here, so that the same string is stored only once no
+// matter how many series or targets refer to it. Strings no longer referred to are released by Compact.
+class LabelStringPool {
+public:
+    InternedString Intern(StringView s);
+    void Compact();
+    size_t Size() const;
+
+private:
+    mutable std::mutex mMux;
+    // key points to the value, which is kept alive by the map itself
+    std::unordered_map<std::string_view, InternedString> mStrings;
+};
+
+// Memoizes the metric relabel outcome of each series of one target. Most series come back with identical labels in
+// every scrape, so the regex rules only need to run the first time a label set is seen. Not thread safe.
+class SeriesRelabelCache {
+public:
+    explicit SeriesRelabelCache(LabelStringPool& pool) : mPool(pool) {}
+
+    // same semantics as RelabelConfigList::Process
+    bool Process(const RelabelConfigList& configs, MetricEvent& e, std::vector<std::string>& toDelete);
+    // should be called after all series of a scrape have been processed, series not seen in this scrape are evicted
+    void EndScrape();
+    size_t Size() const { return mSeries.size(); }
+
+    static uint64_t HashLabels(const MetricEvent& e);
+
+private:
+    struct RelabelResult {
+        // labels before relabeling, compared on a hit so that a hash collision never applies another series' result
+        InternedString mName;
+        std::vector<std::pair<InternedString, InternedString>> mLabels;
+        bool mDropped = false;
+        std::vector<std::pair<InternedString, InternedString>> mSetTags;
+        std::vector<InternedString> mDelTags;
+        std::vector<InternedString> mToDelete;
+        uint32_t mLastSeenRound = 0;
+    };
+
+    static bool SameLabels(const RelabelResult& res, const MetricEvent& e);
+
+    LabelStringPool& mPool;
+    std::unordered_map<uint64_t, RelabelResult> mSeries;
+    uint32_t mRound = 0;
+    size_t mSeenCnt = 0;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class RelabelCacheUnittest;
+#endif
+};
+
+// Relabel caches of all targets of a scrape job.
+class RelabelCache {
+public:
+    // the returned cache should be locked by the caller before use
+    std::pair<std::shared_ptr<SeriesRelabelCache>, std::shared_ptr<std::mutex>> GetSeriesCache(uint64_t targetHash);
+    size_t Size() const;
+
+private:
+    struct TargetCache {
+        std::shared_ptr<SeriesRelabelCache> mCache;
+        std::shared_ptr<std::mutex> mMux;
+        time_t mLastUsedTime = 0;
+    };
+
+    void ClearExpiredTargetCaches(time_t now);
+
+    LabelStringPool mPool;
+    mutable std::mutex mMux;
+    std::unordered_map<uint64_t, TargetCache> mTargetCaches;
+    time_t mLastClearTime = 0;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class RelabelCacheUnittest;
+#endif
+};
+
+} // namespace logtail
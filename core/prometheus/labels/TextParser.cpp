@@ -17,8 +17,10 @@
 #include "prometheus/labels/TextParser.h"
 
 #include <boost/algorithm/string.hpp>
+#include <array>
 #include <charconv>
 #include <cmath>
+#include <cstring>
 #include <string>
 
 #include "common/StringTools.h"
@@ -33,11 +35,17 @@ using namespace std;
 
 namespace logtail {
 
+static array<bool, 256> BuildValidNumberCharTable() {
+    array<bool, 256> table{};
+    for (unsigned char c : string("0123456789.-+eEINFTYinftyXxAa")) {
+        table[c] = true;
+    }
+    return table;
+}
+
 bool IsValidNumberChar(char c) {
-    static const unordered_set<char> sValidChars
-        = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '.', '-', '+', 'e', 'E', 'I',
-           'N', 'F', 'T', 'Y', 'i', 'n', 'f', 't', 'y', 'X', 'x', 'N', 'n', 'A', 'a'};
-    return sValidChars.count(c);
+    static const array<bool, 256> sValidChars = BuildValidNumberCharTable();
+    return sValidChars[static_cast<unsigned char>(c)];
 };
 
 TextParser::TextParser(bool honorTimestamps) : mHonorTimestamps(honorTimestamps) {
@@ -160,6 +168,21 @@ void TextParser::HandleEqualSign(MetricEvent& metricEvent) {
 // parse:v1", k2="v2" } 9.9410452992e+10 1715829785083 # exemplarsxxx
 void TextParser::HandleLabelValue(MetricEvent& metricEvent) {
     // left quote has been consumed
+    // fast path: most label values contain no escape char, so the value ends at the next quote
+    const char* begin = mLine.data() + mPos;
+    const auto* quote = static_cast<const char*>(memchr(begin, '"', mLine.size() - mPos));
+    if (quote != nullptr && memchr(begin, '\\', quote - begin) == nullptr) {
+        metricEvent.SetTagNoCopy(mLabelName, StringView(begin, quote - begin));
+        mPos = quote - mLine.data() + 1;
+        SkipLeadingWhitespace();
+        if (mPos < mLine.size() && (mLine[mPos] == ',' || mLine[mPos] == '}')) {
+            HandleCommaOrCloseBrace(metricEvent);
+        } else {
+            HandleError("unexpected end of input in label value");
+        }
+        return;
+    }
+
     // LableValue supports escape char
     bool escaped = false;
     auto lPos = mPos;
@@ -180,7 +203,7 @@ void TextParser::HandleLabelValue(MetricEvent& metricEvent) {
                 // check next char, if it is valid escape char, we can consume two chars and push one escaped char
                 // if not, we neet to push the two chars
                 // valid escape char: \", \\, \n
-                switch (mLine[lPos + 1]) {
+                switch (mLine[mPos + 1]) {
                     case '\\':
                     case '\"':
                         mEscapedLabelValue.push_back(mLine[mPos + 1]);
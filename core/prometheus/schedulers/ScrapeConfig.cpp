@@ -24,7 +24,8 @@ ScrapeConfig::ScrapeConfig()
       mScheme("http"),
       mMaxScrapeSizeBytes(0),
       mSampleLimit(0),
-      mSeriesLimit(0) {
+      mSeriesLimit(0),
+      mMergeHistogramAndSummary(false) {
 }
 bool ScrapeConfig::Init(const Json::Value& scrapeConfig) {
     if (!InitStaticConfig(scrapeConfig)) {
@@ -156,6 +157,11 @@ bool ScrapeConfig::InitStaticConfig(const Json::Value& scrapeConfig) {
         mSeriesLimit = scrapeConfig[prometheus::SERIES_LIMIT].asUInt64();
     }
 
+    if (scrapeConfig.isMember(prometheus::MERGE_HISTOGRAM_AND_SUMMARY)
+        && scrapeConfig[prometheus::MERGE_HISTOGRAM_AND_SUMMARY].isBool()) {
+        mMergeHistogramAndSummary = scrapeConfig[prometheus::MERGE_HISTOGRAM_AND_SUMMARY].asBool();
+    }
+
     if (scrapeConfig.isMember(prometheus::RELABEL_CONFIGS)) {
         if (!mRelabelConfigs.Init(scrapeConfig[prometheus::RELABEL_CONFIGS])) {
             LOG_ERROR(sLogger, ("relabel config error", ""));
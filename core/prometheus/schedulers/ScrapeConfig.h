@@ -33,6 +33,9 @@ public:
     uint64_t mSeriesLimit;
     RelabelConfigList mRelabelConfigs;
     RelabelConfigList mMetricRelabelConfigs;
+    // store the series of one histogram or summary in a single event, metric relabel configs then see the metric name
+    // without the _bucket, _sum and _count suffixes
+    bool mMergeHistogramAndSummary;
 
     std::map<std::string, std::vector<std::string>> mParams;
 
@@ -17,6 +17,7 @@
 #include "prometheus/schedulers/ScrapeScheduler.h"
 
 #include <cstddef>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <utility>
@@ -25,6 +26,7 @@
 #include "common/TimeUtil.h"
 #include "common/timer/HttpRequestTimerEvent.h"
 #include "logger/Logger.h"
+#include "monitor/LatencyTraceRecorder.h"
 #include "pipeline/queue/ProcessQueueItem.h"
 #include "pipeline/queue/ProcessQueueManager.h"
 #include "pipeline/queue/QueueKey.h"
@@ -45,25 +47,58 @@ size_t PromMetricWriteCallback(char* buffer, size_t size, size_t nmemb, void* da
     }
 
     auto* body = static_cast<PromMetricResponseBody*>(data);
+    body->Append(buffer, sizes);
+    body->mRawSize += sizes;
+    return sizes;
+}
 
-    size_t begin = 0;
-    for (size_t end = begin; end < sizes; ++end) {
-        if (buffer[end] == '\n') {
-            if (begin == 0 && !body->mCache.empty()) {
-                body->mCache.append(buffer, end);
-                body->AddEvent(body->mCache.data(), body->mCache.size());
-                body->mCache.clear();
-            } else if (begin != end) {
-                body->AddEvent(buffer + begin, end - begin);
+void PromMetricResponseBody::Append(const char* buffer, size_t len) {
+    const char* begin = buffer;
+    const char* end = buffer + len;
+    const auto* firstLF = static_cast<const char*>(memchr(begin, '\n', len));
+    if (firstLF == nullptr) {
+        mCache.append(buffer, len);
+        return;
+    }
+    if (!mCache.empty()) {
+        mCache.append(begin, firstLF - begin);
+        AddEvent(mCache.data(), mCache.size());
+        mCache.clear();
+        begin = firstLF + 1;
+    }
+    const char* lastLF = end - 1;
+    while (lastLF >= begin && *lastLF != '\n') {
+        --lastLF;
+    }
+    if (lastLF >= begin) {
+        auto sb = mEventGroup.GetSourceBuffer()->CopyString(begin, lastLF - begin);
+        const char* lineBegin = sb.data;
+        const char* chunkEnd = sb.data + sb.size;
+        while (lineBegin < chunkEnd) {
+            const auto* lineEnd = static_cast<const char*>(memchr(lineBegin, '\n', chunkEnd - lineBegin));
+            if (lineEnd == nullptr) {
+                lineEnd = chunkEnd;
             }
-            begin = end + 1;
+            if (lineBegin != lineEnd) {
+                ParseLine(StringView(lineBegin, lineEnd - lineBegin));
+            }
+            lineBegin = lineEnd + 1;
         }
+        begin = lastLF + 1;
     }
-    if (begin < sizes) {
-        body->mCache.append(buffer + begin, sizes - begin);
+    if (begin < end) {
+        mCache.append(begin, end - begin);
+    }
+}
+
+void PromMetricResponseBody::ParseLine(StringView line) {
+    if (!IsValidMetric(line)) {
+        return;
+    }
+    auto metricEvent = mEventGroup.CreateMetricEvent(true, mEventPool);
+    if (mParser.ParseLine(line, *metricEvent)) {
+        mEventGroup.MutableEvents().emplace_back(std::move(metricEvent), true, mEventPool);
     }
-    body->mRawSize += sizes;
-    return sizes;
 }
 
 ScrapeScheduler::ScrapeScheduler(std::shared_ptr<ScrapeConfig> scrapeConfigPtr,
@@ -110,6 +145,15 @@ void ScrapeScheduler::OnMetricResult(HttpResponse& response, uint64_t timestampM
             ("scrape failed, status code", response.GetStatusCode())("target", mHash)("http header", headerStr));
     }
     auto& eventGroup = responseBody.mEventGroup;
+    eventGroup.SetLatencyTrace(LatencyTraceRecorder::StartTrace());
+    // samples without timestamps are stamped with the scrape time, which is only known when the response is done
+    time_t timestamp = timestampMilliSec / 1000;
+    uint32_t nanoSec = timestampMilliSec % 1000 * 1000000;
+    for (auto& e : eventGroup.MutableEvents()) {
+        if (e->GetTimestamp() == 0) {
+            e->SetTimestamp(timestamp, nanoSec);
+        }
+    }
 
     SetAutoMetricMeta(eventGroup);
     SetTargetLabels(eventGroup);
@@ -210,7 +254,7 @@ std::unique_ptr<TimerEvent> ScrapeScheduler::BuildScrapeTimerEvent(std::chrono::
                                             mScrapeConfigPtr->mRequestHeaders,
                                             "",
                                             HttpResponse(
-                                                new PromMetricResponseBody(mEventPool),
+                                                new PromMetricResponseBody(mEventPool, mScrapeConfigPtr->mHonorTimestamps),
                                                 [](void* ptr) { delete static_cast<PromMetricResponseBody*>(ptr); },
                                                 PromMetricWriteCallback),
                                             mScrapeConfigPtr->mScrapeTimeoutSeconds,
@@ -26,6 +26,7 @@
 #include "pipeline/queue/QueueKey.h"
 #include "prometheus/PromSelfMonitor.h"
 #include "prometheus/Utils.h"
+#include "prometheus/labels/TextParser.h"
 #include "prometheus/schedulers/ScrapeConfig.h"
 
 #ifdef APSARA_UNIT_TEST_MAIN
@@ -36,21 +37,26 @@ namespace logtail {
 
 size_t PromMetricWriteCallback(char* buffer, size_t size, size_t nmemb, void* data);
 
+// parses the response into metric events as curl delivers it, so that the whole response is never buffered as raw
+// lines. Complete lines of each chunk are copied into the source buffer of the event group at once, and the parsed
+// names, tags and values are StringViews over it.
 struct PromMetricResponseBody {
     PipelineEventGroup mEventGroup;
     std::string mCache;
     size_t mRawSize = 0;
     EventPool* mEventPool = nullptr;
+    TextParser mParser;
 
-    explicit PromMetricResponseBody(EventPool* eventPool)
-        : mEventGroup(std::make_shared<SourceBuffer>()), mEventPool(eventPool) {};
-    void AddEvent(char* line, size_t len) {
+    explicit PromMetricResponseBody(EventPool* eventPool, bool honorTimestamps = true)
+        : mEventGroup(std::make_shared<SourceBuffer>()), mEventPool(eventPool), mParser(honorTimestamps) {};
+    void Append(const char* buffer, size_t len);
+    void AddEvent(const char* line, size_t len) {
         if (IsValidMetric(StringView(line, len))) {
-            auto* e = mEventGroup.AddRawEvent(true, mEventPool);
             auto sb = mEventGroup.GetSourceBuffer()->CopyString(line, len);
-            e->SetContentNoCopy(sb);
+            ParseLine(StringView(sb.data, sb.size));
         }
     }
+    void ParseLine(StringView line);
     void FlushCache() {
         AddEvent(mCache.data(), mCache.size());
         mCache.clear();
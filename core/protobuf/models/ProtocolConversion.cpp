@@ -1,9 +1,49 @@
 #include "protobuf/models/ProtocolConversion.h"
 
+#include <map>
+
 using namespace std;
 
 namespace logtail {
 
+// metadata keys are exchanged by name, since the values of EventGroupMetaKey may change between releases
+static const std::map<logtail::EventGroupMetaKey, const char*> sMetaKeyNames = {
+    {logtail::EventGroupMetaKey::LOG_FILE_PATH, "log_file_path"},
+    {logtail::EventGroupMetaKey::LOG_FILE_PATH_RESOLVED, "log_file_path_resolved"},
+    {logtail::EventGroupMetaKey::LOG_FILE_INODE, "log_file_inode"},
+    {logtail::EventGroupMetaKey::LOG_FORMAT, "log_format"},
+    {logtail::EventGroupMetaKey::HAS_PART_LOG, "has_part_log"},
+    {logtail::EventGroupMetaKey::K8S_CLUSTER_ID, "k8s_cluster_id"},
+    {logtail::EventGroupMetaKey::K8S_NODE_NAME, "k8s_node_name"},
+    {logtail::EventGroupMetaKey::K8S_NODE_IP, "k8s_node_ip"},
+    {logtail::EventGroupMetaKey::K8S_NAMESPACE, "k8s_namespace"},
+    {logtail::EventGroupMetaKey::K8S_POD_UID, "k8s_pod_uid"},
+    {logtail::EventGroupMetaKey::K8S_POD_NAME, "k8s_pod_name"},
+    {logtail::EventGroupMetaKey::CONTAINER_NAME, "container_name"},
+    {logtail::EventGroupMetaKey::CONTAINER_IP, "container_ip"},
+    {logtail::EventGroupMetaKey::CONTAINER_IMAGE_NAME, "container_image_name"},
+    {logtail::EventGroupMetaKey::CONTAINER_IMAGE_ID, "container_image_id"},
+    {logtail::EventGroupMetaKey::PROMETHEUS_SCRAPE_DURATION, "prometheus_scrape_duration"},
+    {logtail::EventGroupMetaKey::PROMETHEUS_SCRAPE_RESPONSE_SIZE, "prometheus_scrape_response_size"},
+    {logtail::EventGroupMetaKey::PROMETHEUS_SAMPLES_SCRAPED, "prometheus_samples_scraped"},
+    {logtail::EventGroupMetaKey::PROMETHEUS_SCRAPE_TIMESTAMP_MILLISEC, "prometheus_scrape_timestamp_millisec"},
+    {logtail::EventGroupMetaKey::PROMETHEUS_UP_STATE, "prometheus_up_state"},
+    {logtail::EventGroupMetaKey::SOURCE_ID, "source_id"}};
+
+const char* GetEventGroupMetaKeyName(logtail::EventGroupMetaKey key) {
+    auto it = sMetaKeyNames.find(key);
+    return it == sMetaKeyNames.end() ? nullptr : it->second;
+}
+
+logtail::EventGroupMetaKey GetEventGroupMetaKey(const std::string& name) {
+    for (const auto& item : sMetaKeyNames) {
+        if (name == item.second) {
+            return item.first;
+        }
+    }
+    return logtail::EventGroupMetaKey::UNKNOWN;
+}
+
 bool TransferPBToPipelineEventGroup(const logtail::models::PipelineEventGroup& src, logtail::PipelineEventGroup& dst, std::string& errMsg) {
     // events
     switch (src.PipelineEvents_case())
@@ -57,12 +97,13 @@ bool TransferPBToPipelineEventGroup(const logtail::models::PipelineEventGroup& s
         dst.SetTag(tag.first, tag.second);
     }
 
-    // TODO: transfer metadatas
-    // for (auto& metaData : src.metadata()) {
-    //     if (metaData.first == "source_id") {
-    //         dst.SetMetadata(logtail::EventGroupMetaKey::SOURCE_ID, metaData.second);
-    //     }
-    // }
+    // metadata
+    for (auto& metaData : src.metadata()) {
+        auto key = GetEventGroupMetaKey(metaData.first);
+        if (key != logtail::EventGroupMetaKey::UNKNOWN) {
+            dst.SetMetadata(key, metaData.second);
+        }
+    }
 
     return true;
 }
@@ -215,11 +256,13 @@ bool TransferPipelineEventGroupToPB(const logtail::PipelineEventGroup& src, logt
         dst.mutable_tags()->insert({tag.first.to_string(), tag.second.to_string()});
     }
 
-    // TODO: transfer metadatas
-    // auto sourceId = src.GetMetadata(logtail::EventGroupMetaKey::SOURCE_ID);
-    // if (!sourceId.empty()) {
-    //     dst.mutable_metadata()->insert({"source_id", sourceId.to_string()});
-    // }
+    // metadata
+    for (const auto& metaData : src.GetAllMetadata()) {
+        const char* name = GetEventGroupMetaKeyName(metaData.first);
+        if (name != nullptr) {
+            dst.mutable_metadata()->insert({name, metaData.second.to_string()});
+        }
+    }
     return true;
 }
 
@@ -27,6 +27,11 @@
 
 namespace logtail {
 
+// nullptr for EventGroupMetaKey::UNKNOWN
+const char* GetEventGroupMetaKeyName(EventGroupMetaKey key);
+// EventGroupMetaKey::UNKNOWN if the name is unknown
+EventGroupMetaKey GetEventGroupMetaKey(const std::string& name);
+
 bool TransferPBToPipelineEventGroup(const models::PipelineEventGroup& src, PipelineEventGroup& dst, std::string& errMsg);
 bool TransferPBToLogEvent(const models::LogEvent& src, LogEvent& dst, std::string& errMsg);
 bool TransferPBToMetricEvent(const models::MetricEvent& src, MetricEvent& dst, std::string& errMsg);
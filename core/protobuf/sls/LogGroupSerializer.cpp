@@ -182,7 +182,10 @@ void LogGroupSerializer::AddString(StringView value) {
     mRes.append(value.data(), value.size());
 }
 
-void LogGroupSerializer::AddLogContentMetricLabel(const MetricEvent& e, size_t valueSZ) {
+void LogGroupSerializer::AddLogContentMetricLabel(const MetricEvent& e,
+                                                  size_t valueSZ,
+                                                  StringView extraKey,
+                                                  StringView extraVal) {
     // Contents
     mRes.push_back(0x12);
     uint32_pack(GetStringSize(METRIC_RESERVED_KEY_LABELS.size()) + GetStringSize(valueSZ), mRes);
@@ -194,14 +197,26 @@ void LogGroupSerializer::AddLogContentMetricLabel(const MetricEvent& e, size_t v
     mRes.push_back(0x12);
     uint32_pack(valueSZ, mRes);
     bool hasPrev = false;
-    for (auto it = e.TagsBegin(); it != e.TagsEnd(); ++it) {
+    auto appendLabel = [&](StringView key, StringView val) {
         if (hasPrev) {
             mRes.append(METRIC_LABELS_SEPARATOR);
         }
         hasPrev = true;
-        mRes.append(it->first.data(), it->first.size());
+        mRes.append(key.data(), key.size());
         mRes.append(METRIC_LABELS_KEY_VALUE_SEPARATOR);
-        mRes.append(it->second.data(), it->second.size());
+        mRes.append(val.data(), val.size());
+    };
+    // labels are sorted by key, so is the extra one
+    bool extraAdded = extraKey.empty();
+    for (auto it = e.TagsBegin(); it != e.TagsEnd(); ++it) {
+        if (!extraAdded && extraKey < it->first) {
+            appendLabel(extraKey, extraVal);
+            extraAdded = true;
+        }
+        appendLabel(it->first, it->second);
+    }
+    if (!extraAdded) {
+        appendLabel(extraKey, extraVal);
     }
 }
 
@@ -258,11 +273,15 @@ size_t GetLogTagSize(size_t keySZ, size_t valueSZ) {
     return res;
 }
 
-size_t GetMetricLabelSize(const MetricEvent& e) {
+size_t GetMetricLabelSize(const MetricEvent& e, StringView extraKey, StringView extraVal) {
     static size_t labelSepSZ = METRIC_LABELS_SEPARATOR.size();
     static size_t keyValSepSZ = METRIC_LABELS_KEY_VALUE_SEPARATOR.size();
 
-    size_t valueSZ = e.TagsSize() * keyValSepSZ + (e.TagsSize() - 1) * labelSepSZ;
+    size_t labelCnt = e.TagsSize() + (extraKey.empty() ? 0 : 1);
+    if (labelCnt == 0) {
+        return 0;
+    }
+    size_t valueSZ = labelCnt * keyValSepSZ + (labelCnt - 1) * labelSepSZ + extraKey.size() + extraVal.size();
     for (auto it = e.TagsBegin(); it != e.TagsEnd(); ++it) {
         valueSZ += it->first.size() + it->second.size();
     }
@@ -46,7 +46,11 @@ public:
     void AddLogTag(StringView key, StringView value);
     std::string& GetResult() { return mRes; }
 
-    void AddLogContentMetricLabel(const MetricEvent& e, size_t valueSZ);
+    // extraKey and extraVal, if not empty, are added as one more label, e.g. le of a histogram bucket
+    void AddLogContentMetricLabel(const MetricEvent& e,
+                                  size_t valueSZ,
+                                  StringView extraKey = StringView(),
+                                  StringView extraVal = StringView());
     void AddLogContentMetricTimeNano(const MetricEvent& e);
 
 private:
@@ -60,6 +64,6 @@ size_t GetLogSize(size_t contentSZ, bool hasNs, size_t& logSZ);
 size_t GetStringSize(size_t size);
 size_t GetLogTagSize(size_t keySZ, size_t valueSZ);
 
-size_t GetMetricLabelSize(const MetricEvent& e);
+size_t GetMetricLabelSize(const MetricEvent& e, StringView extraKey = StringView(), StringView extraVal = StringView());
 
 } // namespace logtail
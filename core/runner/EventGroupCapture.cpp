@@ -0,0 +1,238 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runner/EventGroupCapture.h"
+
+#include <cstring>
+
+#include "common/FileSystemUtil.h"
+#include "common/Flags.h"
+#include "common/StringTools.h"
+#include "logger/Logger.h"
+#include "protobuf/models/ProtocolConversion.h"
+
+DEFINE_FLAG_STRING(process_queue_capture_file,
+                   "debug only, event groups pushed to process queues are written to this file, empty to disable",
+                   "");
+DEFINE_FLAG_STRING(process_queue_capture_configs,
+                   "comma separated names of configs whose event groups are captured, empty for all configs",
+                   "");
+DEFINE_FLAG_INT64(process_queue_capture_max_size_bytes,
+                  "capture stops once the capture file reaches this size",
+                  1024 * 1024 * 1024);
+
+using namespace std;
+
+namespace logtail {
+
+const char kEventGroupCaptureMagic[8] = {'L', 'C', 'G', 'C', 'A', 'P', '0', '1'};
+
+// a record larger than this is regarded as corrupted when read
+static const uint32_t kMaxRecordSize = 256 * 1024 * 1024;
+
+static void AppendUint16(string& buf, uint16_t val) {
+    buf += static_cast<char>(val & 0xFF);
+    buf += static_cast<char>(val >> 8);
+}
+
+static void AppendUint32(string& buf, uint32_t val) {
+    for (int i = 0; i < 4; ++i) {
+        buf += static_cast<char>((val >> (8 * i)) & 0xFF);
+    }
+}
+
+static uint32_t ReadUint(const char* data, size_t size) {
+    uint32_t val = 0;
+    for (size_t i = 0; i < size; ++i) {
+        val |= static_cast<uint32_t>(static_cast<uint8_t>(data[i])) << (8 * i);
+    }
+    return val;
+}
+
+void EventGroupCapture::Init() {
+    const string& path = STRING_FLAG(process_queue_capture_file);
+    if (path.empty()) {
+        return;
+    }
+    lock_guard<mutex> lock(mMux);
+    mFile = FileWriteOnlyOpen(path.c_str(), "wb");
+    if (mFile == nullptr) {
+        LOG_ERROR(sLogger, ("failed to open capture file", path)("errno", errno));
+        return;
+    }
+    if (fwrite(kEventGroupCaptureMagic, sizeof(kEventGroupCaptureMagic), 1, mFile) != 1) {
+        LOG_ERROR(sLogger, ("failed to write capture file", path)("errno", errno));
+        fclose(mFile);
+        mFile = nullptr;
+        return;
+    }
+    mFileSize = sizeof(kEventGroupCaptureMagic);
+    mCapturedCnt = 0;
+    mSkippedCnt = 0;
+    mConfigs.clear();
+    for (const auto& config : SplitString(STRING_FLAG(process_queue_capture_configs), ",")) {
+        if (!config.empty()) {
+            mConfigs.insert(config);
+        }
+    }
+    mIsEnabled = true;
+    LOG_WARNING(sLogger,
+                ("event group capture", "started")("file", path)("configs",
+                                                                 STRING_FLAG(process_queue_capture_configs)));
+}
+
+void EventGroupCapture::Stop() {
+    lock_guard<mutex> lock(mMux);
+    mIsEnabled = false;
+    if (mFile == nullptr) {
+        return;
+    }
+    fclose(mFile);
+    mFile = nullptr;
+    LOG_INFO(sLogger,
+             ("event group capture", "stopped")("captured groups", mCapturedCnt)("skipped groups", mSkippedCnt)(
+                 "file size", mFileSize));
+}
+
+bool EventGroupCapture::Serialize(const string& configName,
+                                  size_t inputIndex,
+                                  const PipelineEventGroup& group,
+                                  string& record) {
+    if (!mConfigs.empty() && mConfigs.find(configName) == mConfigs.end()) {
+        return false;
+    }
+    if (group.GetEvents().empty()) {
+        return false;
+    }
+    // serialized outside the lock, since inputs may push concurrently
+    models::PipelineEventGroup pb;
+    string errorMsg;
+    if (!TransferPipelineEventGroupToPB(group, pb, errorMsg)) {
+        lock_guard<mutex> lock(mMux);
+        ++mSkippedCnt;
+        return false;
+    }
+    string payload;
+    AppendUint16(payload, static_cast<uint16_t>(min<size_t>(configName.size(), UINT16_MAX)));
+    payload.append(configName, 0, UINT16_MAX);
+    AppendUint32(payload, static_cast<uint32_t>(inputIndex));
+    if (!pb.AppendToString(&payload)) {
+        lock_guard<mutex> lock(mMux);
+        ++mSkippedCnt;
+        return false;
+    }
+    record.clear();
+    record.reserve(4 + payload.size());
+    AppendUint32(record, static_cast<uint32_t>(payload.size()));
+    record += payload;
+    return true;
+}
+
+void EventGroupCapture::Write(const string& record) {
+    lock_guard<mutex> lock(mMux);
+    if (mFile == nullptr) {
+        return;
+    }
+    if (mFileSize + record.size() > static_cast<uint64_t>(INT64_FLAG(process_queue_capture_max_size_bytes))) {
+        LOG_WARNING(sLogger,
+                    ("event group capture", "stopped")("reason", "max size reached")("captured groups", mCapturedCnt)(
+                        "skipped groups", mSkippedCnt)("file size", mFileSize));
+        mIsEnabled = false;
+        fclose(mFile);
+        mFile = nullptr;
+        return;
+    }
+    if (fwrite(record.data(), record.size(), 1, mFile) != 1) {
+        LOG_ERROR(sLogger, ("failed to write capture file", "stop capture")("errno", errno));
+        mIsEnabled = false;
+        fclose(mFile);
+        mFile = nullptr;
+        return;
+    }
+    mFileSize += record.size();
+    ++mCapturedCnt;
+}
+
+void EventGroupCapture::Capture(const string& configName, size_t inputIndex, const PipelineEventGroup& group) {
+    string record;
+    if (Serialize(configName, inputIndex, group, record)) {
+        Write(record);
+    }
+}
+
+EventGroupCaptureReader::~EventGroupCaptureReader() {
+    if (mFile != nullptr) {
+        fclose(mFile);
+    }
+}
+
+bool EventGroupCaptureReader::Open(const string& path) {
+    mFile = FileReadOnlyOpen(path.c_str(), "rb");
+    if (mFile == nullptr) {
+        mErrorMsg = "failed to open capture file " + path;
+        return false;
+    }
+    char magic[sizeof(kEventGroupCaptureMagic)];
+    if (fread(magic, sizeof(magic), 1, mFile) != 1 || memcmp(magic, kEventGroupCaptureMagic, sizeof(magic)) != 0) {
+        mErrorMsg = "not a capture file: " + path;
+        return false;
+    }
+    return true;
+}
+
+bool EventGroupCaptureReader::Next(string& configName, size_t& inputIndex, PipelineEventGroup& group) {
+    if (mFile == nullptr) {
+        return false;
+    }
+    char header[4];
+    size_t n = fread(header, 1, sizeof(header), mFile);
+    if (n == 0) {
+        return false;
+    }
+    // the last record may be incomplete if the capture was not stopped gracefully
+    if (n != sizeof(header)) {
+        mErrorMsg = "incomplete record header";
+        return false;
+    }
+    uint32_t size = ReadUint(header, sizeof(header));
+    if (size < 6 || size > kMaxRecordSize) {
+        mErrorMsg = "invalid record size " + ToString(size);
+        return false;
+    }
+    mBuffer.resize(size);
+    if (fread(&mBuffer[0], size, 1, mFile) != 1) {
+        mErrorMsg = "incomplete record";
+        return false;
+    }
+    uint32_t nameSize = ReadUint(mBuffer.data(), 2);
+    if (2 + nameSize + 4 > size) {
+        mErrorMsg = "invalid config name size " + ToString(nameSize);
+        return false;
+    }
+    configName.assign(mBuffer.data() + 2, nameSize);
+    inputIndex = ReadUint(mBuffer.data() + 2 + nameSize, 4);
+
+    models::PipelineEventGroup pb;
+    size_t offset = 2 + nameSize + 4;
+    if (!pb.ParseFromArray(mBuffer.data() + offset, static_cast<int>(size - offset))) {
+        mErrorMsg = "failed to parse event group";
+        return false;
+    }
+    if (!TransferPBToPipelineEventGroup(pb, group, mErrorMsg)) {
+        return false;
+    }
+    return true;
+}
+
+} // namespace logtail
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+#include "models/PipelineEventGroup.h"
+
+namespace logtail {
+
+// Capture file layout, all integers are little endian:
+//   file   := magic record*
+//   magic  := "LCGCAP01"
+//   record := uint32 payload size, payload
+//   payload := uint16 config name size, config name, uint32 input index, models::PipelineEventGroup protobuf
+extern const char kEventGroupCaptureMagic[8];
+
+// Debug tool which writes event groups pushed to process queues into a capture file, so that processor chains can be
+// profiled offline against real traffic with the replay benchmark. Enabled by setting process_queue_capture_file.
+class EventGroupCapture {
+public:
+    EventGroupCapture(const EventGroupCapture&) = delete;
+    EventGroupCapture& operator=(const EventGroupCapture&) = delete;
+
+    static EventGroupCapture* GetInstance() {
+        static EventGroupCapture instance;
+        return &instance;
+    }
+
+    void Init();
+    void Stop();
+
+    bool IsEnabled() const { return mIsEnabled.load(std::memory_order_relaxed); }
+    // returns false if the group is not to be captured, i.e. its config is filtered out, it is empty or it contains
+    // unsupported events, e.g. raw events
+    bool Serialize(const std::string& configName,
+                   size_t inputIndex,
+                   const PipelineEventGroup& group,
+                   std::string& record);
+    void Write(const std::string& record);
+    void Capture(const std::string& configName, size_t inputIndex, const PipelineEventGroup& group);
+
+private:
+    EventGroupCapture() = default;
+    ~EventGroupCapture() = default;
+
+    std::atomic_bool mIsEnabled = false;
+    std::mutex mMux;
+    FILE* mFile = nullptr;
+    std::unordered_set<std::string> mConfigs;
+    uint64_t mFileSize = 0;
+    uint64_t mCapturedCnt = 0;
+    uint64_t mSkippedCnt = 0;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class EventGroupCaptureUnittest;
+#endif
+};
+
+// Reads the records of a capture file in order.
+class EventGroupCaptureReader {
+public:
+    ~EventGroupCaptureReader();
+
+    bool Open(const std::string& path);
+    // returns false at the end of the file or on a corrupted record, in which case GetErrorMsg is not empty
+    bool Next(std::string& configName, size_t& inputIndex, PipelineEventGroup& group);
+    const std::string& GetErrorMsg() const { return mErrorMsg; }
+
+private:
+    FILE* mFile = nullptr;
+    std::string mBuffer;
+    std::string mErrorMsg;
+};
+
+} // namespace logtail
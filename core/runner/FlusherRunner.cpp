@@ -33,6 +33,9 @@
 
 DEFINE_FLAG_INT32(flusher_runner_exit_timeout_secs, "", 60);
 DEFINE_FLAG_INT32(check_send_client_timeout_interval, "", 600);
+DEFINE_FLAG_INT32(flusher_runner_rate_limited_wait_ms,
+                  "wait time before fetching again when items are held back by rate limiters",
+                  10);
 
 using namespace std;
 
@@ -82,13 +85,8 @@ bool FlusherRunner::LoadModuleConfig(bool isInit) {
 }
 
 void FlusherRunner::UpdateSendFlowControl() {
-    // when inflow exceed 30MB/s, FlowControl lose precision
-    if (AppConfig::GetInstance()->GetMaxBytePerSec() >= 30 * 1024 * 1024) {
-        mEnableRateLimiter = false;
-    }
-    LOG_INFO(sLogger,
-             ("send byte per second limit", AppConfig::GetInstance()->GetMaxBytePerSec())(
-                 "send flow control", mEnableRateLimiter ? "enable" : "disable"));
+    SenderQueueManager::GetInstance()->SetGlobalRateLimit(AppConfig::GetInstance()->GetMaxBytePerSec());
+    LOG_INFO(sLogger, ("send byte per second limit", AppConfig::GetInstance()->GetMaxBytePerSec()));
 }
 
 void FlusherRunner::Stop() {
@@ -135,7 +133,10 @@ void FlusherRunner::Run() {
             = Application::GetInstance()->IsExiting() ? -1 : AppConfig::GetInstance()->GetSendRequestConcurrency();
         SenderQueueManager::GetInstance()->GetAvailableItems(items, limit);
         if (items.empty()) {
-            SenderQueueManager::GetInstance()->Wait(1000);
+            // rate limited items are skipped instead of being slept on, so fetch again once tokens are refilled
+            SenderQueueManager::GetInstance()->Wait(SenderQueueManager::GetInstance()->IsRateLimited()
+                                                        ? INT32_FLAG(flusher_runner_rate_limited_wait_ms)
+                                                        : 1000);
         } else {
             LOG_DEBUG(sLogger, ("got items from sender queue, cnt", items.size()));
             for (auto itr = items.begin(); itr != items.end(); ++itr) {
@@ -155,11 +156,6 @@ void FlusherRunner::Run() {
                     ToString(chrono::duration_cast<chrono::milliseconds>(curTime - (*itr)->mFirstEnqueTime).count())
                         + "ms")("try cnt", ToString((*itr)->mTryCnt)));
 
-            // TODO: use rate limiter instead
-            if (!Application::GetInstance()->IsExiting() && mEnableRateLimiter) {
-                RateLimiter::FlowControl((*itr)->mRawSize, mSendLastTime, mSendLastByte, true);
-            }
-
             Dispatch(*itr);
             mWaitingItemsTotal->Sub(1);
             mOutItemsTotal->Add(1);
@@ -180,6 +176,9 @@ void FlusherRunner::Run() {
 }
 
 void FlusherRunner::Dispatch(SenderQueueItem* item) {
+    if (item->mLatencyTrace) {
+        item->mLatencyTrace->Stamp(LatencyStage::SENDER_QUEUE_POP);
+    }
     switch (item->mFlusher->GetSinkType()) {
         case SinkType::HTTP:
             // TODO: make it common for all http flushers
@@ -192,6 +191,8 @@ void FlusherRunner::Dispatch(SenderQueueItem* item) {
             }
             break;
         default:
+            // items of sinks other than http are done once dispatched
+            item->mFlusher->RecordLatencyTrace(item);
             SenderQueueManager::GetInstance()->RemoveItem(item->mFlusher->GetQueueKey(), item);
             break;
     }
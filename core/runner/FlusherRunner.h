@@ -65,10 +65,6 @@ private:
 
     // TODO: temporarily here
     int32_t mLastCheckSendClientTime = 0;
-    int64_t mSendLastTime = 0;
-    int32_t mSendLastByte = 0;
-
-    bool mEnableRateLimiter = true;
 
     mutable MetricsRecordRef mMetricsRecordRef;
     CounterPtr mInItemsTotal;
@@ -17,6 +17,7 @@
 #include "app_config/AppConfig.h"
 #include "batch/TimeoutFlushManager.h"
 #include "common/Flags.h"
+#include "go_pipeline/EventGroupWire.h"
 #include "go_pipeline/LogtailPlugin.h"
 #include "models/EventPool.h"
 #include "monitor/AlarmManager.h"
@@ -25,8 +26,8 @@
 #include "queue/ExactlyOnceQueueManager.h"
 #include "queue/ProcessQueueManager.h"
 #include "queue/QueueKeyManager.h"
+#include "runner/EventGroupCapture.h"
 
-DEFINE_FLAG_INT32(default_flush_merged_buffer_interval, "default flush merged buffer, seconds", 1);
 DEFINE_FLAG_INT32(processor_runner_exit_timeout_secs, "", 60);
 
 DECLARE_FLAG_INT32(max_send_log_group_size);
@@ -46,6 +47,7 @@ ProcessorRunner::ProcessorRunner()
 }
 
 void ProcessorRunner::Init() {
+    EventGroupCapture::GetInstance()->Init();
     for (uint32_t threadNo = 0; threadNo < mThreadCount; ++threadNo) {
         mThreadRes[threadNo] = async(launch::async, &ProcessorRunner::Run, this, threadNo);
     }
@@ -63,12 +65,23 @@ void ProcessorRunner::Stop() {
             LOG_WARNING(sLogger, ("processor runner", "forced to stopped")("threadNo", threadNo));
         }
     }
+    EventGroupCapture::GetInstance()->Stop();
 }
 
 bool ProcessorRunner::PushQueue(QueueKey key, size_t inputIndex, PipelineEventGroup&& group, uint32_t retryTimes) {
+    // the group is serialized before being moved into the item, but written only once the item is accepted, since
+    // callers keep retrying on failure
+    string captureRecord;
+    if (EventGroupCapture::GetInstance()->IsEnabled()) {
+        EventGroupCapture::GetInstance()->Serialize(
+            QueueKeyManager::GetInstance()->GetName(key), inputIndex, group, captureRecord);
+    }
     unique_ptr<ProcessQueueItem> item = make_unique<ProcessQueueItem>(std::move(group), inputIndex);
     for (size_t i = 0; i < retryTimes; ++i) {
         if (ProcessQueueManager::GetInstance()->PushQueue(key, std::move(item)) == 0) {
+            if (!captureRecord.empty()) {
+                EventGroupCapture::GetInstance()->Write(captureRecord);
+            }
             return true;
         }
         if (i % 100 == 0) {
@@ -96,13 +109,10 @@ void ProcessorRunner::Run(uint32_t threadNo) {
     sInGroupDataSizeBytes = sMetricsRecordRef.CreateCounter(METRIC_RUNNER_IN_SIZE_BYTES);
     sLastRunTime = sMetricsRecordRef.CreateIntGauge(METRIC_RUNNER_LAST_RUN_TIME);
 
-    static int32_t lastFlushBatchTime = 0;
     while (true) {
         int32_t curTime = time(nullptr);
-        if (threadNo == 0 && curTime - lastFlushBatchTime >= INT32_FLAG(default_flush_merged_buffer_interval)) {
-            TimeoutFlushManager::GetInstance()->FlushTimeoutBatch();
-            lastFlushBatchTime = curTime;
-        }
+        // returns immediately without lock when no batch is due, so every thread can drive timeout flush
+        TimeoutFlushManager::GetInstance()->FlushTimeoutBatch();
 
         sLastRunTime->Set(curTime);
         unique_ptr<ProcessQueueItem> item;
@@ -115,6 +125,9 @@ void ProcessorRunner::Run(uint32_t threadNo) {
             continue;
         }
 
+        if (item->mEventGroup.GetLatencyTrace()) {
+            item->mEventGroup.GetLatencyTrace()->Stamp(LatencyStage::PROCESS_QUEUE_POP);
+        }
         sInEventsCnt->Add(item->mEventGroup.GetEvents().size());
         sInGroupsCnt->Add(1);
         sInGroupDataSizeBytes->Add(item->mEventGroup.DataSize());
@@ -137,17 +150,25 @@ void ProcessorRunner::Run(uint32_t threadNo) {
         pipeline->Process(eventGroupList, item->mInputIndex);
 
         if (pipeline->IsFlushingThroughGoPipeline()) {
-            // TODO:
-            // 1. allow all event types to be sent to Go pipelines
-            // 2. use event group protobuf instead
-            if (isLog) {
+            // plugin libraries without ProcessEventGroup only accept logs
+            bool useEventGroupWire = LogtailPlugin::GetInstance()->IsEventGroupSupported();
+            if (useEventGroupWire || isLog) {
                 for (auto& group : eventGroupList) {
+                    if (group.GetEvents().empty()) {
+                        continue;
+                    }
                     string res, errorMsg;
-                    if (!Serialize(group,
-                                   pipeline->GetContext().GetGlobalConfig().mEnableTimestampNanosecond,
-                                   pipeline->GetContext().GetLogstoreName(),
-                                   res,
-                                   errorMsg)) {
+                    bool enableNanosecond = pipeline->GetContext().GetGlobalConfig().mEnableTimestampNanosecond;
+                    bool success = useEventGroupWire
+                        ? SerializeEventGroupWire(group, enableNanosecond, res, errorMsg)
+                        : Serialize(group, enableNanosecond, pipeline->GetContext().GetLogstoreName(), res, errorMsg);
+                    if (success && useEventGroupWire
+                        && static_cast<int64_t>(res.size()) > INT32_FLAG(max_send_log_group_size)) {
+                        errorMsg = "event group exceeds size limit\tgroup size: " + ToString(res.size())
+                            + "\tsize limit: " + ToString(INT32_FLAG(max_send_log_group_size));
+                        success = false;
+                    }
+                    if (!success) {
                         LOG_WARNING(pipeline->GetContext().GetLogger(),
                                     ("failed to serialize event group",
                                      errorMsg)("action", "discard data")("config", configName));
@@ -160,10 +181,17 @@ void ProcessorRunner::Run(uint32_t threadNo) {
                                                                     pipeline->GetContext().GetRegion());
                         continue;
                     }
-                    LogtailPlugin::GetInstance()->ProcessLogGroup(
-                        pipeline->GetContext().GetConfigName(),
-                        res,
-                        group.GetMetadata(EventGroupMetaKey::SOURCE_ID).to_string());
+                    if (useEventGroupWire) {
+                        LogtailPlugin::GetInstance()->ProcessEventGroup(
+                            pipeline->GetContext().GetConfigName(),
+                            res,
+                            group.GetMetadata(EventGroupMetaKey::SOURCE_ID).to_string());
+                    } else {
+                        LogtailPlugin::GetInstance()->ProcessLogGroup(
+                            pipeline->GetContext().GetConfigName(),
+                            res,
+                            group.GetMetadata(EventGroupMetaKey::SOURCE_ID).to_string());
+                    }
                 }
             }
         } else {
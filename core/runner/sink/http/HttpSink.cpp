@@ -50,6 +50,7 @@ bool HttpSink::Init() {
         = mMetricsRecordRef.CreateTimeCounter(METRIC_RUNNER_SINK_SUCCESSFUL_ITEM_TOTAL_RESPONSE_TIME_MS);
     mFailedItemTotalResponseTimeMs
         = mMetricsRecordRef.CreateTimeCounter(METRIC_RUNNER_SINK_FAILED_ITEM_TOTAL_RESPONSE_TIME_MS);
+    mResponseTimeUs = mMetricsRecordRef.CreateHistogram(METRIC_RUNNER_SINK_RESPONSE_TIME_US);
     mSendingItemsTotal = mMetricsRecordRef.CreateIntGauge(METRIC_RUNNER_SINK_SENDING_ITEMS_TOTAL);
     mSendConcurrency = mMetricsRecordRef.CreateIntGauge(METRIC_RUNNER_SINK_SEND_CONCURRENCY);
 
@@ -132,6 +133,9 @@ bool HttpSink::AddRequestToClient(unique_ptr<HttpSinkRequest>&& request) {
     request->mPrivateData = headers;
     curl_easy_setopt(curl, CURLOPT_PRIVATE, request.get());
     request->mLastSendTime = chrono::system_clock::now();
+    if (request->mItem->mLatencyTrace) {
+        request->mItem->mLatencyTrace->Stamp(LatencyStage::SEND);
+    }
 
     auto res = curl_multi_add_handle(mClient, curl);
     if (res != CURLM_OK) {
@@ -237,11 +241,15 @@ void HttpSink::HandleCompletedRequests(int& runningHandlers) {
             curl_easy_getinfo(handler, CURLINFO_PRIVATE, &request);
             auto responseTime = chrono::system_clock::now() - request->mLastSendTime;
             auto responseTimeMs = chrono::duration_cast<chrono::milliseconds>(responseTime).count();
+            mResponseTimeUs->Add(responseTime);
             switch (msg->data.result) {
                 case CURLE_OK: {
                     long statusCode = 0;
                     curl_easy_getinfo(handler, CURLINFO_RESPONSE_CODE, &statusCode);
                     request->mResponse.SetStatusCode(statusCode);
+                    if (statusCode / 100 == 2) {
+                        request->mItem->mFlusher->RecordLatencyTrace(request->mItem);
+                    }
                     static_cast<HttpFlusher*>(request->mItem->mFlusher)->OnSendDone(request->mResponse, request->mItem);
                     FlusherRunner::GetInstance()->DecreaseHttpSendingCnt();
                     mOutSuccessfulItemsTotal->Add(1);
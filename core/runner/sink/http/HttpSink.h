@@ -62,6 +62,7 @@ private:
     CounterPtr mOutFailedItemsTotal;
     TimeCounterPtr mSuccessfulItemTotalResponseTimeMs;
     TimeCounterPtr mFailedItemTotalResponseTimeMs;
+    HistogramPtr mResponseTimeUs;
     IntGaugePtr mSendingItemsTotal;
     IntGaugePtr mSendConcurrency;
     IntGaugePtr mLastRunTime;
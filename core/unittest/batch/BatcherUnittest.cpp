@@ -35,6 +35,7 @@ public:
     void TestFlushAllWithoutGroupBatch();
     void TestFlushAllWithGroupBatch();
     void TestMetric();
+    void TestLatencyTrace();
 
 protected:
     static void SetUpTestCase() { sFlusher = make_unique<FlusherMock>(); }
@@ -46,7 +47,10 @@ protected:
         sFlusher->SetPluginID("1");
     }
 
-    void TearDown() override { TimeoutFlushManager::GetInstance()->mTimeoutRecords.clear(); }
+    void TearDown() override {
+        TimeoutFlushManager::GetInstance()->mTimeoutRecords.clear();
+        TimeoutFlushManager::GetInstance()->mTimeoutWheel.Clear();
+    }
 
 private:
     PipelineEventGroup CreateEventGroup(size_t cnt);
@@ -656,6 +660,31 @@ void BatcherUnittest::TestMetric() {
     }
 }
 
+void BatcherUnittest::TestLatencyTrace() {
+    DefaultFlushStrategyOptions strategy;
+    strategy.mMinCnt = 3;
+    strategy.mMinSizeBytes = 1000;
+    strategy.mTimeoutSecs = 3;
+
+    Batcher<> batch;
+    batch.Init(Json::Value(), sFlusher.get(), strategy);
+
+    // the batch keeps the trace of the first traced group added
+    vector<BatchedEventsList> res;
+    PipelineEventGroup group1 = CreateEventGroup(1);
+    batch.Add(std::move(group1), res);
+    auto trace2 = make_shared<LatencyTrace>();
+    PipelineEventGroup group2 = CreateEventGroup(1);
+    group2.SetLatencyTrace(trace2);
+    batch.Add(std::move(group2), res);
+    PipelineEventGroup group3 = CreateEventGroup(1);
+    group3.SetLatencyTrace(make_shared<LatencyTrace>());
+    batch.Add(std::move(group3), res);
+    APSARA_TEST_EQUAL(1U, res.size());
+    APSARA_TEST_EQUAL(trace2, res[0][0].mLatencyTrace);
+    APSARA_TEST_TRUE(trace2->HasStamp(LatencyStage::BATCH_FLUSH));
+}
+
 PipelineEventGroup BatcherUnittest::CreateEventGroup(size_t cnt) {
     PipelineEventGroup group(make_shared<SourceBuffer>());
     group.SetTag(string("key"), string("val"));
@@ -680,6 +709,7 @@ UNIT_TEST_CASE(BatcherUnittest, TestFlushGroupQueue)
 UNIT_TEST_CASE(BatcherUnittest, TestFlushAllWithoutGroupBatch)
 UNIT_TEST_CASE(BatcherUnittest, TestFlushAllWithGroupBatch)
 UNIT_TEST_CASE(BatcherUnittest, TestMetric)
+UNIT_TEST_CASE(BatcherUnittest, TestLatencyTrace)
 
 } // namespace logtail
 
@@ -34,7 +34,10 @@ protected:
         sFlusher->SetMetricsRecordRef(FlusherMock::sName, "1");
     }
 
-    void TearDown() override { TimeoutFlushManager::GetInstance()->mTimeoutRecords.clear(); }
+    void TearDown() override {
+        TimeoutFlushManager::GetInstance()->mTimeoutRecords.clear();
+        TimeoutFlushManager::GetInstance()->mTimeoutWheel.Clear();
+    }
 
 private:
     static unique_ptr<FlusherMock> sFlusher;
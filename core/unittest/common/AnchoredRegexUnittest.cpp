@@ -0,0 +1,216 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <vector>
+
+#include "common/AnchoredRegex.h"
+#include "common/StringTools.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class AnchoredRegexUnittest : public ::testing::Test {
+public:
+    void TestSameAsBoostRegex();
+    void TestPrefilter();
+    void TestBoostFallback();
+    void TestBoostSemantics();
+};
+
+void AnchoredRegexUnittest::TestSameAsBoostRegex() {
+    const vector<string> patterns = {
+        R"(\d+-\d+-\d+ \d+:\d+:\d+)",
+        R"(\[\d+-\d+-\d+)",
+        R"(\s+at\s)",
+        R"(Caused by:)",
+        R"(\s*)",
+        R"((?i)error)",
+        R"(\S+\.(java|py):\d+)",
+        R"(end)",
+        R"(.)",
+    };
+    const vector<string> lines = {
+        "2024-05-01 10:00:00.123 ERROR [main] failed to start",
+        "[2024-05-01 10:00:00] INFO started",
+        "[INFO] started",
+        "java.lang.IllegalStateException: boom",
+        "\tat com.example.Main.run(Main.java:42)",
+        "    at com.example.Main.main(Main.java:10)",
+        "Caused by: java.io.IOException: broken pipe",
+        "\t... 12 more",
+        "ERROR unexpected",
+        "Error: unexpected",
+        "Main.java:42 in main",
+        "end",
+        "en",
+        "",
+        "\xff\xfe binary",
+    };
+    for (const auto& pattern : patterns) {
+        AnchoredRegex regex;
+        APSARA_TEST_TRUE_FATAL(regex.Init(pattern));
+        APSARA_TEST_TRUE(regex.IsDfaCompiled());
+        boost::regex boostRegex(pattern);
+        for (const auto& line : lines) {
+            string exception;
+            APSARA_TEST_EQUAL(BoostRegexSearch(line.data(), line.size(), boostRegex, exception),
+                              regex.Match(line.data(), line.size(), exception));
+        }
+    }
+}
+
+void AnchoredRegexUnittest::TestPrefilter() {
+    {
+        // timestamp, the first byte must be a digit
+        AnchoredRegex regex;
+        APSARA_TEST_TRUE(regex.Init(R"(\d+-\d+-\d+)"));
+        APSARA_TEST_EQUAL("", regex.mLiteralPrefix);
+        APSARA_TEST_TRUE(regex.mHasNextByteRange);
+        APSARA_TEST_EQUAL('0', regex.mNextByteMin);
+        APSARA_TEST_EQUAL('9', regex.mNextByteMax);
+        APSARA_TEST_FALSE(regex.Prefilter("\tat a.b.C", 9));
+        APSARA_TEST_FALSE(regex.Prefilter("", 0));
+        APSARA_TEST_TRUE(regex.Prefilter("2024-", 5));
+    }
+    {
+        AnchoredRegex regex;
+        APSARA_TEST_TRUE(regex.Init(R"(\[\d+)"));
+        APSARA_TEST_EQUAL("[", regex.mLiteralPrefix);
+        APSARA_TEST_TRUE(regex.mHasNextByteRange);
+        APSARA_TEST_FALSE(regex.Prefilter("[INFO]", 6));
+        APSARA_TEST_FALSE(regex.Prefilter("[", 1));
+        APSARA_TEST_TRUE(regex.Prefilter("[2", 2));
+    }
+    {
+        AnchoredRegex regex;
+        APSARA_TEST_TRUE(regex.Init("Caused by"));
+        APSARA_TEST_EQUAL("Caused by", regex.mLiteralPrefix);
+        APSARA_TEST_FALSE(regex.mHasNextByteRange);
+        string exception;
+        APSARA_TEST_TRUE(regex.Match("Caused by", 9, exception));
+    }
+    {
+        // a match can be empty, nothing to filter
+        AnchoredRegex regex;
+        APSARA_TEST_TRUE(regex.Init(R"(\s*)"));
+        APSARA_TEST_EQUAL("", regex.mLiteralPrefix);
+        APSARA_TEST_FALSE(regex.mHasNextByteRange);
+        APSARA_TEST_TRUE(regex.Prefilter("", 0));
+    }
+}
+
+void AnchoredRegexUnittest::TestBoostFallback() {
+    AnchoredRegex regex;
+    // backreferences are not supported by RE2
+    APSARA_TEST_TRUE(regex.Init(R"((\w)\1)"));
+    APSARA_TEST_FALSE(regex.IsDfaCompiled());
+    string exception;
+    APSARA_TEST_TRUE(regex.Match("aab", 3, exception));
+    APSARA_TEST_FALSE(regex.Match("abb", 3, exception));
+
+    APSARA_TEST_FALSE(regex.Init("("));
+    APSARA_TEST_FALSE(regex.Match("(", 1, exception));
+}
+
+void AnchoredRegexUnittest::TestBoostSemantics() {
+    // patterns RE2 interprets differently, which are translated, pin the result to boost::regex
+    const vector<string> translated = {
+        R"(\s)",
+        R"(\S)",
+        R"([\s])",
+        R"([^\s])",
+        R"(a\sb)",
+        R"(abc$)",
+        R"((abc$))",
+        R"(foo$|bar)",
+        R"((a$)|b)",
+        R"(^a|^b)",
+        R"((?i)error$)",
+        R"((?:a|^b)c)",
+        R"(\Q$\E)",
+    };
+    const vector<string> lines = {
+        "\v",
+        " ",
+        "x",
+        "a\vb",
+        "abc",
+        "abc\n",
+        "abc\r",
+        "abc\f",
+        "abc\r\n",
+        "abc\v",
+        "abc\x85",
+        "abcd",
+        "(abc)",
+        "foo",
+        "foo\r",
+        "foox",
+        "bar",
+        "a",
+        "a\n",
+        "b",
+        "ac",
+        "bc",
+        "ERROR\n",
+        "error",
+        "$",
+    };
+    for (const auto& pattern : translated) {
+        AnchoredRegex regex;
+        APSARA_TEST_TRUE_FATAL(regex.Init(pattern));
+        APSARA_TEST_TRUE_DESC(regex.IsDfaCompiled(), pattern);
+        boost::regex boostRegex(pattern);
+        for (const auto& line : lines) {
+            string exception;
+            APSARA_TEST_EQUAL_DESC(BoostRegexSearch(line.data(), line.size(), boostRegex, exception),
+                                   regex.Match(line.data(), line.size(), exception),
+                                   pattern + " " + line);
+        }
+    }
+
+    // patterns that cannot be translated are left to boost::regex
+    const vector<string> untranslated = {
+        "a$\nb",
+        "a\n^b",
+        R"(\v)",
+        R"([\S])",
+        R"(a\')",
+        "(?i)\xe9",
+        R"((?s)a)",
+    };
+    for (const auto& pattern : untranslated) {
+        AnchoredRegex regex;
+        APSARA_TEST_TRUE_FATAL(regex.Init(pattern));
+        APSARA_TEST_FALSE_DESC(regex.IsDfaCompiled(), pattern);
+    }
+    string exception;
+    AnchoredRegex regex;
+    APSARA_TEST_TRUE(regex.Init(R"(\v)"));
+    APSARA_TEST_TRUE(regex.Match("\n", 1, exception));
+    APSARA_TEST_TRUE(regex.Init("(?i)\xe9"));
+    APSARA_TEST_FALSE(regex.Match("\xc9", 1, exception));
+}
+
+UNIT_TEST_CASE(AnchoredRegexUnittest, TestSameAsBoostRegex)
+UNIT_TEST_CASE(AnchoredRegexUnittest, TestPrefilter)
+UNIT_TEST_CASE(AnchoredRegexUnittest, TestBoostFallback)
+UNIT_TEST_CASE(AnchoredRegexUnittest, TestBoostSemantics)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -15,6 +15,10 @@
 #include "unittest/Unittest.h"
 #include "common/EncodingConverter.h"
 #if defined(__linux__)
+#include <iconv.h>
+
+#include <random>
+
 #include "unittest/UnittestHelper.h"
 #endif
 
@@ -23,9 +27,23 @@ namespace logtail {
 class EncodingConverterUnittest : public ::testing::Test {
 public:
     void ConvertGbk2Utf8();
+#if defined(__linux__)
+    void ConvertGbk2Utf8WithInvalidLines();
+    void ConvertGbk2Utf8SameAsIconv();
+    void ConvertGbk2Utf8SingleByteChars();
+
+private:
+    std::string Convert(const std::string& gbk);
+    std::string ConvertWithIconv(const std::string& gbk);
+#endif
 };
 
 APSARA_UNIT_TEST_CASE(EncodingConverterUnittest, ConvertGbk2Utf8, 0);
+#if defined(__linux__)
+APSARA_UNIT_TEST_CASE(EncodingConverterUnittest, ConvertGbk2Utf8WithInvalidLines, 0);
+APSARA_UNIT_TEST_CASE(EncodingConverterUnittest, ConvertGbk2Utf8SameAsIconv, 0);
+APSARA_UNIT_TEST_CASE(EncodingConverterUnittest, ConvertGbk2Utf8SingleByteChars, 0);
+#endif
 
 void EncodingConverterUnittest::ConvertGbk2Utf8() {
     char gbkStr[] = "ilogtail\xbf\xc9\xb9\xdb\xb2\xe2\xd0\xd4\xb2\xc9\xbc\xaf\xc6\xf7";
@@ -41,6 +59,98 @@ void EncodingConverterUnittest::ConvertGbk2Utf8() {
     APSARA_TEST_STREQ("ilogtail可观测性采集器", destChar.get());
 }
 
+#if defined(__linux__)
+std::string EncodingConverterUnittest::Convert(const std::string& gbk) {
+    size_t srcLen = gbk.size();
+    std::vector<long> linePosVec;
+    size_t requireSize = EncodingConverter::GetInstance()->ConvertGbk2Utf8(gbk.data(), &srcLen, nullptr, 0, linePosVec);
+    std::string res(requireSize + 1, '\0');
+    size_t actualSize
+        = EncodingConverter::GetInstance()->ConvertGbk2Utf8(gbk.data(), &srcLen, &res[0], res.size(), linePosVec);
+    res.resize(actualSize);
+    return res;
+}
+
+// ConvertWithIconv converts @gbk line by line, and copies lines failed to convert as they are.
+std::string EncodingConverterUnittest::ConvertWithIconv(const std::string& gbk) {
+    iconv_t cd = iconv_open("UTF-8", "GBK");
+    std::string res;
+    size_t begin = 0;
+    while (begin < gbk.size()) {
+        size_t end = gbk.find('\n', begin);
+        end = end == std::string::npos ? gbk.size() : end + 1;
+        std::string out((end - begin) * 3, '\0');
+        char* src = const_cast<char*>(gbk.data() + begin);
+        char* des = &out[0];
+        size_t srcLeft = end - begin, desLeft = out.size();
+        iconv(cd, NULL, NULL, NULL, NULL);
+        if (iconv(cd, &src, &srcLeft, &des, &desLeft) == (size_t)(-1)) {
+            res.append(gbk, begin, end - begin);
+        } else {
+            res.append(out.data(), des - out.data());
+        }
+        begin = end;
+    }
+    iconv_close(cd);
+    return res;
+}
+
+void EncodingConverterUnittest::ConvertGbk2Utf8WithInvalidLines() {
+    // \xff is invalid, and \xbf at the end is an incomplete char
+    std::string gbk = "ilogtail\xbf\xc9\xb9\xdb\xb2\xe2\n"
+                      "\xbf\xc9\xff\xb9\xdb\n"
+                      "0123456789abcdef0123456789abcdef\xbf\xc9\n"
+                      "\xbf\xc9\xbf";
+    APSARA_TEST_EQUAL(std::string("ilogtail可观测\n"
+                                  "\xbf\xc9\xff\xb9\xdb\n"
+                                  "0123456789abcdef0123456789abcdef可\n"
+                                  "\xbf\xc9\xbf"),
+                      Convert(gbk));
+    // € is single byte in GBK of glibc
+    APSARA_TEST_EQUAL(std::string("a€b"), Convert("a\x80" "b"));
+}
+
+void EncodingConverterUnittest::ConvertGbk2Utf8SingleByteChars() {
+    // each byte takes 3 bytes in UTF-8, the worst case
+    for (size_t len : {1, 15, 16, 17, 100}) {
+        std::string gbk(len, '\x80');
+        std::string utf8;
+        for (size_t i = 0; i < len; ++i) {
+            utf8 += "€";
+        }
+        APSARA_TEST_EQUAL(utf8, Convert(gbk));
+        APSARA_TEST_EQUAL(utf8 + std::string(32, 'a'), Convert(gbk + std::string(32, 'a')));
+    }
+}
+
+void EncodingConverterUnittest::ConvertGbk2Utf8SameAsIconv() {
+    std::mt19937 rng(0);
+    for (int round = 0; round < 200; ++round) {
+        std::string gbk;
+        size_t len = rng() % 1024 + 1;
+        while (gbk.size() < len) {
+            switch (rng() % 4) {
+                case 0:
+                    gbk.append(rng() % 40, 'a' + rng() % 26);
+                    break;
+                case 1:
+                    // valid double byte chars mostly
+                    gbk += static_cast<char>(0xB0 + rng() % 0x40);
+                    gbk += static_cast<char>(0xA1 + rng() % 0x5E);
+                    break;
+                case 2:
+                    gbk += rng() % 8 == 0 ? static_cast<char>(0x80 + rng() % 0x80) : '\n';
+                    break;
+                default:
+                    gbk += static_cast<char>(0x81 + rng() % 0x7E);
+                    gbk += static_cast<char>(0x40 + rng() % 0xBF);
+            }
+        }
+        APSARA_TEST_EQUAL(ConvertWithIconv(gbk), Convert(gbk));
+    }
+}
+#endif
+
 } // namespace logtail
 
 int main(int argc, char** argv) {
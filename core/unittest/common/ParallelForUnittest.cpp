@@ -0,0 +1,68 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "common/ParallelFor.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class ParallelForUnittest : public ::testing::Test {
+public:
+    void TestAllCalled() const;
+    void TestThreadNum() const;
+};
+
+void ParallelForUnittest::TestAllCalled() const {
+    for (size_t threadNum : {0, 1, 4, 64}) {
+        vector<atomic_int> calls(100);
+        ParallelFor(calls.size(), threadNum, [&](size_t i) { ++calls[i]; });
+        for (const auto& cnt : calls) {
+            APSARA_TEST_EQUAL(1, cnt.load());
+        }
+    }
+    bool called = false;
+    ParallelFor(0, 4, [&](size_t) { called = true; });
+    APSARA_TEST_FALSE(called);
+}
+
+void ParallelForUnittest::TestThreadNum() const {
+    mutex mux;
+    set<thread::id> threadIds;
+    auto func = [&](size_t) {
+        lock_guard<mutex> lock(mux);
+        threadIds.insert(this_thread::get_id());
+    };
+    ParallelFor(100, 1, func);
+    APSARA_TEST_EQUAL(1U, threadIds.size());
+    APSARA_TEST_EQUAL(1U, threadIds.count(this_thread::get_id()));
+
+    threadIds.clear();
+    ParallelFor(100, 4, func);
+    APSARA_TEST_TRUE(threadIds.size() <= 4U);
+}
+
+UNIT_TEST_CASE(ParallelForUnittest, TestAllCalled)
+UNIT_TEST_CASE(ParallelForUnittest, TestThreadNum)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
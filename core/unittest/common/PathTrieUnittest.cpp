@@ -0,0 +1,100 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/PathTrie.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class PathTrieUnittest : public ::testing::Test {
+public:
+    void TestFindLongestPrefix();
+    void TestFindAllPrefixes();
+    void TestErase();
+};
+
+void PathTrieUnittest::TestFindLongestPrefix() {
+    PathTrie trie;
+    trie.Insert("/host/a", 0);
+    trie.Insert("/host/a/b", 1);
+    trie.Insert("/host/ab", 2);
+    APSARA_TEST_EQUAL(3U, trie.Size());
+
+    size_t value = 0;
+    APSARA_TEST_TRUE(trie.FindLongestPrefix("/host/a", value));
+    APSARA_TEST_EQUAL(0U, value);
+    APSARA_TEST_TRUE(trie.FindLongestPrefix("/host/a/c/d", value));
+    APSARA_TEST_EQUAL(0U, value);
+    APSARA_TEST_TRUE(trie.FindLongestPrefix("/host/a/b/c", value));
+    APSARA_TEST_EQUAL(1U, value);
+    APSARA_TEST_TRUE(trie.FindLongestPrefix("/host/ab/", value));
+    APSARA_TEST_EQUAL(2U, value);
+    // prefixes are matched by components
+    APSARA_TEST_FALSE(trie.FindLongestPrefix("/host/abc", value));
+    APSARA_TEST_FALSE(trie.FindLongestPrefix("/host", value));
+
+    // the smallest value is returned if a path has multiple values
+    trie.Insert("/host/a/b", 3);
+    trie.Insert("/host//a/b/", 0);
+    APSARA_TEST_TRUE(trie.FindLongestPrefix("/host/a/b/c", value));
+    APSARA_TEST_EQUAL(0U, value);
+}
+
+void PathTrieUnittest::TestFindAllPrefixes() {
+    PathTrie trie;
+    trie.Insert("/host/a/b", 1);
+    trie.Insert("/host/a", 0);
+    trie.Insert("/host/a", 2);
+    trie.Insert("/host/c", 3);
+
+    vector<size_t> values;
+    trie.FindAllPrefixes("/host/a/b/c", values);
+    APSARA_TEST_EQUAL(vector<size_t>({0, 2, 1}), values);
+    values.clear();
+    trie.FindAllPrefixes("/host/d", values);
+    APSARA_TEST_TRUE(values.empty());
+}
+
+void PathTrieUnittest::TestErase() {
+    PathTrie trie;
+    trie.Insert("/host/a/b", 0);
+    trie.Insert("/host/a", 1);
+    APSARA_TEST_FALSE(trie.Erase("/host/a/b", 1));
+    APSARA_TEST_FALSE(trie.Erase("/host/a/b/c", 0));
+    APSARA_TEST_TRUE(trie.Erase("/host/a/b", 0));
+    APSARA_TEST_EQUAL(1U, trie.Size());
+    // empty nodes are removed
+    APSARA_TEST_TRUE(trie.mRoot.mChildren["host"]->mChildren["a"]->mChildren.empty());
+    size_t value = 0;
+    APSARA_TEST_TRUE(trie.FindLongestPrefix("/host/a/b", value));
+    APSARA_TEST_EQUAL(1U, value);
+
+    APSARA_TEST_TRUE(trie.Erase("/host/a", 1));
+    APSARA_TEST_EQUAL(0U, trie.Size());
+    APSARA_TEST_TRUE(trie.mRoot.mChildren.empty());
+
+    trie.Insert("/host/a", 1);
+    trie.Clear();
+    APSARA_TEST_FALSE(trie.FindLongestPrefix("/host/a", value));
+}
+
+UNIT_TEST_CASE(PathTrieUnittest, TestFindLongestPrefix)
+UNIT_TEST_CASE(PathTrieUnittest, TestFindAllPrefixes)
+UNIT_TEST_CASE(PathTrieUnittest, TestErase)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -0,0 +1,186 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fstream>
+
+#include <boost/filesystem.hpp>
+
+#include "common/SegmentedWal.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class SegmentedWalUnittest : public ::testing::Test {
+public:
+    void TestAppendAndReplay();
+    void TestRotation();
+    void TestResumeReplay();
+    void TestCorruptedRecord();
+    void TestRemoveExcessSegments();
+
+protected:
+    void SetUp() override {
+        mDir = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+        boost::filesystem::create_directories(mDir);
+    }
+
+    void TearDown() override { boost::filesystem::remove_all(mDir); }
+
+private:
+    static vector<string> ReadAll(WalSegment& segment) {
+        vector<string> res;
+        StringView record;
+        while (segment.Next(record)) {
+            res.emplace_back(record.data(), record.size());
+        }
+        return res;
+    }
+
+    string mDir;
+};
+
+void SegmentedWalUnittest::TestAppendAndReplay() {
+    SegmentedWal wal;
+    APSARA_TEST_TRUE(wal.Init(mDir, "segment_", 4096, 10));
+    APSARA_TEST_TRUE(wal.Append({StringView("header|"), StringView("first")}));
+    APSARA_TEST_TRUE(wal.Append({StringView("second")}));
+    APSARA_TEST_TRUE(wal.Sync());
+    // the active segment is not replayed
+    APSARA_TEST_TRUE(wal.GetSealedSegments().empty());
+    wal.Seal();
+
+    auto segments = wal.GetSealedSegments();
+    APSARA_TEST_EQUAL(1U, segments.size());
+    APSARA_TEST_EQUAL(4096U, boost::filesystem::file_size(segments[0]));
+    WalSegment segment;
+    string errorMsg;
+    APSARA_TEST_TRUE(segment.Open(segments[0], errorMsg));
+    APSARA_TEST_EQUAL(vector<string>({"header|first", "second"}), ReadAll(segment));
+    APSARA_TEST_FALSE(segment.IsCorrupted());
+
+    // sequence numbers continue after restart
+    SegmentedWal restarted;
+    APSARA_TEST_TRUE(restarted.Init(mDir, "segment_", 4096, 10));
+    APSARA_TEST_TRUE(restarted.Append({StringView("third")}));
+    restarted.Seal();
+    segments = restarted.GetSealedSegments();
+    APSARA_TEST_EQUAL(2U, segments.size());
+    APSARA_TEST_TRUE(segments[0] < segments[1]);
+}
+
+void SegmentedWalUnittest::TestRotation() {
+    size_t segmentSize = WalSegment::kHeaderSize + 2 * (WalSegment::kRecordHeaderSize + 100);
+    SegmentedWal wal;
+    APSARA_TEST_TRUE(wal.Init(mDir, "segment_", segmentSize, 10));
+    string record(100, 'a');
+    for (int i = 0; i < 5; ++i) {
+        APSARA_TEST_TRUE(wal.Append({StringView(record)}));
+    }
+    // records larger than a segment are rejected
+    string large(segmentSize, 'b');
+    APSARA_TEST_FALSE(wal.Append({StringView(large)}));
+    APSARA_TEST_EQUAL(2U, wal.GetSealedSegments().size());
+    wal.Seal();
+
+    size_t cnt = 0;
+    for (const auto& path : wal.GetSealedSegments()) {
+        WalSegment segment;
+        string errorMsg;
+        APSARA_TEST_TRUE(segment.Open(path, errorMsg));
+        cnt += ReadAll(segment).size();
+    }
+    APSARA_TEST_EQUAL(5U, cnt);
+}
+
+void SegmentedWalUnittest::TestResumeReplay() {
+    SegmentedWal wal;
+    APSARA_TEST_TRUE(wal.Init(mDir, "segment_", 4096, 10));
+    for (const auto& s : {"first", "second", "third"}) {
+        APSARA_TEST_TRUE(wal.Append({StringView(s)}));
+    }
+    wal.Seal();
+    string path = wal.GetSealedSegments()[0];
+    string errorMsg;
+    {
+        WalSegment segment;
+        APSARA_TEST_TRUE(segment.Open(path, errorMsg));
+        StringView record;
+        APSARA_TEST_TRUE(segment.Next(record));
+        segment.MarkReplayed();
+        // read but not marked as replayed
+        APSARA_TEST_TRUE(segment.Next(record));
+        APSARA_TEST_TRUE(segment.CommitReplayedOffset());
+        APSARA_TEST_TRUE(segment.Next(record));
+        // marked as replayed but not committed
+        segment.MarkReplayed();
+    }
+    WalSegment segment;
+    APSARA_TEST_TRUE(segment.Open(path, errorMsg));
+    APSARA_TEST_EQUAL(vector<string>({"second", "third"}), ReadAll(segment));
+}
+
+void SegmentedWalUnittest::TestCorruptedRecord() {
+    SegmentedWal wal;
+    APSARA_TEST_TRUE(wal.Init(mDir, "segment_", 4096, 10));
+    APSARA_TEST_TRUE(wal.Append({StringView("first")}));
+    APSARA_TEST_TRUE(wal.Append({StringView("second")}));
+    wal.Seal();
+    string path = wal.GetSealedSegments()[0];
+    {
+        // flip a byte of the second payload
+        fstream f(path, ios::in | ios::out | ios::binary);
+        f.seekp(WalSegment::kHeaderSize + WalSegment::kRecordHeaderSize + 5 + WalSegment::kRecordHeaderSize);
+        f.put('S');
+    }
+    WalSegment segment;
+    string errorMsg;
+    APSARA_TEST_TRUE(segment.Open(path, errorMsg));
+    APSARA_TEST_EQUAL(vector<string>({"first"}), ReadAll(segment));
+    APSARA_TEST_TRUE(segment.IsCorrupted());
+
+    {
+        ofstream f(path, ios::binary | ios::trunc);
+        f << "not a segment file";
+    }
+    APSARA_TEST_FALSE(segment.Open(path, errorMsg));
+    APSARA_TEST_FALSE(errorMsg.empty());
+}
+
+void SegmentedWalUnittest::TestRemoveExcessSegments() {
+    SegmentedWal wal;
+    APSARA_TEST_TRUE(wal.Init(mDir, "segment_", 4096, 2));
+    for (int i = 0; i < 4; ++i) {
+        APSARA_TEST_TRUE(wal.Append({StringView("record")}));
+        wal.Seal();
+    }
+    auto segments = wal.GetSealedSegments();
+    APSARA_TEST_EQUAL(2U, wal.RemoveExcessSegments());
+    auto remained = wal.GetSealedSegments();
+    APSARA_TEST_EQUAL(vector<string>(segments.begin() + 2, segments.end()), remained);
+    // other files in the directory are left untouched
+    { ofstream(mDir + "/segment_other"); }
+    APSARA_TEST_EQUAL(2U, wal.GetSealedSegments().size());
+}
+
+UNIT_TEST_CASE(SegmentedWalUnittest, TestAppendAndReplay)
+UNIT_TEST_CASE(SegmentedWalUnittest, TestRotation)
+UNIT_TEST_CASE(SegmentedWalUnittest, TestResumeReplay)
+UNIT_TEST_CASE(SegmentedWalUnittest, TestCorruptedRecord)
+UNIT_TEST_CASE(SegmentedWalUnittest, TestRemoveExcessSegments)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
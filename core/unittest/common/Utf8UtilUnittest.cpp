@@ -0,0 +1,138 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <random>
+#include <string>
+
+#include "common/Utf8Util.h"
+#include "models/PipelineEventGroup.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class Utf8UtilUnittest : public testing::Test {
+public:
+    void TestFindNonUtf8();
+    void TestReplaceNonUtf8();
+    void TestSameAsDecoding();
+    void TestReplaceNonUtf8Contents();
+
+private:
+    // Replace replaces invalid bytes by decoding code points one by one.
+    static string Replace(string str);
+};
+
+void Utf8UtilUnittest::TestFindNonUtf8() {
+    APSARA_TEST_EQUAL(0U, FindNonUtf8("", 0));
+    string valid = "ascii only, long enough for a whole block 中文 \xf0\x9f\x98\x80 \xed\xa0\x80";
+    APSARA_TEST_EQUAL(valid.size(), FindNonUtf8(valid.data(), valid.size()));
+    APSARA_TEST_TRUE(IsValidUtf8(valid));
+
+    const vector<string> invalids = {"\x80",
+                                     "\xc0\xaf", // overlong
+                                     "\xe0\x80\xaf", // overlong
+                                     "\xf0\x80\x80\xaf", // overlong
+                                     "\xf4\x90\x80\x80", // beyond U+10FFFF
+                                     "\xf8\x88\x80\x80\x80",
+                                     "\xe4\xb8", // truncated
+                                     "\xe4\x41\xad"};
+    for (const auto& invalid : invalids) {
+        string str = "0123456789abcdef0123" + invalid + "tail";
+        APSARA_TEST_EQUAL(20U, FindNonUtf8(str.data(), str.size()));
+        APSARA_TEST_FALSE(IsValidUtf8(str));
+    }
+}
+
+void Utf8UtilUnittest::TestReplaceNonUtf8() {
+    string str = "0123456789abcdef\xe4\xb8\xad\xe4\xb8 \xff\xc3\x41\xf0\x9f\x98";
+    APSARA_TEST_EQUAL(7U, ReplaceNonUtf8(&str[0], str.size()));
+    APSARA_TEST_EQUAL("0123456789abcdef\xe4\xb8\xad   " "  A   ", str);
+
+    str = "\xe4\xb8\xad";
+    APSARA_TEST_EQUAL(0U, ReplaceNonUtf8(&str[0], str.size(), '?'));
+    APSARA_TEST_EQUAL("\xe4\xb8\xad", str);
+}
+
+string Utf8UtilUnittest::Replace(string str) {
+    size_t i = 0;
+    while (i < str.size()) {
+        uint8_t c = str[i];
+        size_t len = c < 0x80 ? 1 : (c & 0xe0) == 0xc0 ? 2 : (c & 0xf0) == 0xe0 ? 3 : (c & 0xf8) == 0xf0 ? 4 : 0;
+        bool valid = len > 0 && i + len <= str.size();
+        uint32_t unicode = len == 1 ? c : c & (0xff >> (len + 1));
+        for (size_t j = 1; valid && j < len; ++j) {
+            valid = (str[i + j] & 0xc0) == 0x80;
+            unicode = (unicode << 6) | (str[i + j] & 0x3f);
+        }
+        const uint32_t minUnicode[] = {0, 0, 0x80, 0x800, 0x10000};
+        if (valid && (unicode < minUnicode[len] || unicode > 0x10ffff)) {
+            valid = false;
+        }
+        if (valid) {
+            i += len;
+        } else {
+            str[i++] = ' ';
+        }
+    }
+    return str;
+}
+
+void Utf8UtilUnittest::TestSameAsDecoding() {
+    mt19937 rng(0);
+    const vector<string> pieces = {"a", "0123456789abcdefghijklmn", "\xe4\xb8\xad", "\xc3\xa9", "\xf0\x9f\x98\x80"};
+    for (int round = 0; round < 1000; ++round) {
+        string str;
+        size_t len = rng() % 256;
+        while (str.size() < len) {
+            if (rng() % 4 == 0) {
+                str += static_cast<char>(rng() % 256);
+            } else {
+                str += pieces[rng() % pieces.size()];
+            }
+        }
+        string expected = Replace(str);
+        APSARA_TEST_EQUAL(expected == str, IsValidUtf8(str));
+        ReplaceNonUtf8(&str[0], str.size());
+        APSARA_TEST_EQUAL(expected, str);
+    }
+}
+
+void Utf8UtilUnittest::TestReplaceNonUtf8Contents() {
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    LogEvent* e = group.AddLogEvent();
+    // contents referring to memory not owned by the event are left untouched
+    string value = "val\xffue";
+    e->SetContentNoCopy(StringView("key"), StringView(value));
+    e->SetContent(string("k\xc3y"), string("valid\xe4\xb8\xad"));
+    e->SetContent(string("valid"), string("\xe4\xb8\xad"));
+    ReplaceNonUtf8Contents(*e);
+    APSARA_TEST_EQUAL(3U, e->Size());
+    APSARA_TEST_EQUAL("val ue", e->GetContent("key").to_string());
+    APSARA_TEST_EQUAL("val\xffue", value);
+    APSARA_TEST_FALSE(e->HasContent("k\xc3y"));
+    APSARA_TEST_EQUAL("valid\xe4\xb8\xad", e->GetContent("k y").to_string());
+    APSARA_TEST_EQUAL("\xe4\xb8\xad", e->GetContent("valid").to_string());
+}
+
+UNIT_TEST_CASE(Utf8UtilUnittest, TestFindNonUtf8)
+UNIT_TEST_CASE(Utf8UtilUnittest, TestReplaceNonUtf8)
+UNIT_TEST_CASE(Utf8UtilUnittest, TestSameAsDecoding)
+UNIT_TEST_CASE(Utf8UtilUnittest, TestReplaceNonUtf8Contents)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -40,13 +40,18 @@ void TimerUnittest::TestPushEvent() {
     timer.PushEvent(make_unique<TimerEventMock>(now + chrono::seconds(1)));
     timer.PushEvent(make_unique<TimerEventMock>(now + chrono::seconds(3)));
 
-    APSARA_TEST_EQUAL(3U, timer.mQueue.size());
-    APSARA_TEST_EQUAL(now + chrono::seconds(1), timer.mQueue.top()->GetExecTime());
-    timer.mQueue.pop();
-    APSARA_TEST_EQUAL(now + chrono::seconds(2), timer.mQueue.top()->GetExecTime());
-    timer.mQueue.pop();
-    APSARA_TEST_EQUAL(now + chrono::seconds(3), timer.mQueue.top()->GetExecTime());
-    timer.mQueue.pop();
+    APSARA_TEST_EQUAL(3U, timer.mQueue.Size());
+    APSARA_TEST_EQUAL(now + chrono::seconds(1), timer.mNextWakeUpTime);
+
+    vector<unique_ptr<TimerEvent>> events;
+    timer.mQueue.Advance(now + chrono::milliseconds(500), events);
+    APSARA_TEST_TRUE(events.empty());
+    timer.mQueue.Advance(now + chrono::seconds(5), events);
+    APSARA_TEST_EQUAL(3U, events.size());
+    APSARA_TEST_EQUAL(now + chrono::seconds(1), events[0]->GetExecTime());
+    APSARA_TEST_EQUAL(now + chrono::seconds(2), events[1]->GetExecTime());
+    APSARA_TEST_EQUAL(now + chrono::seconds(3), events[2]->GetExecTime());
+    APSARA_TEST_TRUE(timer.mQueue.Empty());
 }
 
 UNIT_TEST_CASE(TimerUnittest, TestPushEvent)
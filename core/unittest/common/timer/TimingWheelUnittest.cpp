@@ -0,0 +1,144 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/timer/TimingWheel.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class TimingWheelUnittest : public ::testing::Test {
+public:
+    void TestAdvance();
+    void TestCascade();
+    void TestCancel();
+    void TestReschedule();
+    void TestGetNextCheckTime();
+
+protected:
+    void SetUp() override { mStart = chrono::steady_clock::now(); }
+
+    chrono::steady_clock::time_point mStart;
+};
+
+void TimingWheelUnittest::TestAdvance() {
+    TimingWheel<int> wheel(mStart);
+    wheel.Add(mStart + chrono::milliseconds(30), 3);
+    wheel.Add(mStart + chrono::milliseconds(10), 1);
+    wheel.Add(mStart + chrono::milliseconds(20), 2);
+    wheel.Add(mStart, 0);
+    APSARA_TEST_EQUAL(4U, wheel.Size());
+
+    vector<int> res;
+    wheel.Advance(mStart, res);
+    APSARA_TEST_EQUAL(vector<int>({0}), res);
+
+    res.clear();
+    wheel.Advance(mStart + chrono::milliseconds(9), res);
+    APSARA_TEST_TRUE(res.empty());
+
+    wheel.Advance(mStart + chrono::milliseconds(25), res);
+    APSARA_TEST_EQUAL(vector<int>({1, 2}), res);
+
+    // expired entries added after advance are returned by the next advance
+    res.clear();
+    wheel.Add(mStart + chrono::milliseconds(5), 4);
+    wheel.Advance(mStart + chrono::milliseconds(25), res);
+    APSARA_TEST_EQUAL(vector<int>({4}), res);
+
+    res.clear();
+    wheel.Advance(mStart + chrono::seconds(1), res);
+    APSARA_TEST_EQUAL(vector<int>({3}), res);
+    APSARA_TEST_TRUE(wheel.Empty());
+}
+
+void TimingWheelUnittest::TestCascade() {
+    TimingWheel<int> wheel(mStart);
+    vector<int64_t> delays = {63, 64, 65, 4095, 4096, 4097, 262143, 262144, 1000000, 16777215, 16777216, 20000000};
+    for (size_t i = 0; i < delays.size(); ++i) {
+        wheel.Add(mStart + chrono::milliseconds(delays[i]), i);
+    }
+    for (size_t i = 0; i < delays.size(); ++i) {
+        vector<int> res;
+        wheel.Advance(mStart + chrono::milliseconds(delays[i] - 1), res);
+        APSARA_TEST_TRUE(res.empty());
+        wheel.Advance(mStart + chrono::milliseconds(delays[i]), res);
+        APSARA_TEST_EQUAL(vector<int>({static_cast<int>(i)}), res);
+    }
+    APSARA_TEST_TRUE(wheel.Empty());
+}
+
+void TimingWheelUnittest::TestCancel() {
+    TimingWheel<int> wheel(mStart);
+    auto id1 = wheel.Add(mStart + chrono::milliseconds(10), 1);
+    auto id2 = wheel.Add(mStart + chrono::seconds(10), 2);
+    auto id3 = wheel.Add(mStart, 3);
+    APSARA_TEST_TRUE(wheel.Cancel(id1));
+    APSARA_TEST_TRUE(wheel.Cancel(id2));
+    APSARA_TEST_FALSE(wheel.Cancel(id2));
+    APSARA_TEST_EQUAL(1U, wheel.Size());
+
+    vector<int> res;
+    wheel.Advance(mStart + chrono::seconds(20), res);
+    APSARA_TEST_EQUAL(vector<int>({3}), res);
+    APSARA_TEST_FALSE(wheel.Cancel(id3));
+    APSARA_TEST_TRUE(wheel.Empty());
+}
+
+void TimingWheelUnittest::TestReschedule() {
+    TimingWheel<int> wheel(mStart);
+    auto id1 = wheel.Add(mStart + chrono::milliseconds(10), 1);
+    auto id2 = wheel.Add(mStart + chrono::seconds(10), 2);
+    APSARA_TEST_TRUE(wheel.Reschedule(id1, mStart + chrono::seconds(20)));
+    APSARA_TEST_TRUE(wheel.Reschedule(id2, mStart + chrono::milliseconds(100)));
+
+    vector<int> res;
+    wheel.Advance(mStart + chrono::seconds(1), res);
+    APSARA_TEST_EQUAL(vector<int>({2}), res);
+    APSARA_TEST_FALSE(wheel.Reschedule(id2, mStart + chrono::seconds(2)));
+
+    res.clear();
+    wheel.Advance(mStart + chrono::seconds(20), res);
+    APSARA_TEST_EQUAL(vector<int>({1}), res);
+}
+
+void TimingWheelUnittest::TestGetNextCheckTime() {
+    TimingWheel<int> wheel(mStart);
+    APSARA_TEST_EQUAL(chrono::steady_clock::time_point::max(), wheel.GetNextCheckTime());
+
+    wheel.Add(mStart + chrono::milliseconds(10), 1);
+    APSARA_TEST_EQUAL(mStart + chrono::milliseconds(10), wheel.GetNextCheckTime());
+
+    // the next check time of an entry in higher levels is when its slot cascades, which is never later than it expires
+    wheel.Add(mStart + chrono::milliseconds(5000), 2);
+    vector<int> res;
+    wheel.Advance(mStart + chrono::milliseconds(10), res);
+    auto next = wheel.GetNextCheckTime();
+    APSARA_TEST_GT(next, mStart + chrono::milliseconds(10));
+    APSARA_TEST_TRUE(next <= mStart + chrono::milliseconds(5000));
+
+    wheel.Add(mStart, 3);
+    APSARA_TEST_TRUE(wheel.GetNextCheckTime() <= mStart + chrono::milliseconds(10));
+}
+
+UNIT_TEST_CASE(TimingWheelUnittest, TestAdvance)
+UNIT_TEST_CASE(TimingWheelUnittest, TestCascade)
+UNIT_TEST_CASE(TimingWheelUnittest, TestCancel)
+UNIT_TEST_CASE(TimingWheelUnittest, TestReschedule)
+UNIT_TEST_CASE(TimingWheelUnittest, TestGetNextCheckTime)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
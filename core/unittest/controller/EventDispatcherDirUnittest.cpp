@@ -16,8 +16,12 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <stdlib.h>
+#include <climits>
+#include <filesystem>
+#include <fstream>
 #include <string>
 #include <memory>
+#include "common/FileSystemUtil.h"
 #include "common/Flags.h"
 #include "file_server/EventDispatcher.h"
 #include "file_server/event/Event.h"
@@ -25,6 +29,9 @@
 using namespace std;
 
 DECLARE_FLAG_STRING(ilogtail_config);
+DECLARE_FLAG_INT32(default_max_inotify_watch_num);
+DECLARE_FLAG_INT32(inotify_max_user_watches_usage_percent);
+DECLARE_FLAG_INT32(inotify_cold_dir_threshold);
 
 namespace logtail {
 class MockHandler : public EventHandler {
@@ -122,11 +129,70 @@ public:
             }
         }
     }
+
+    void TestInotifyWatchLimit() {
+        EventDispatcher* dispatcher = EventDispatcher::GetInstance();
+        int64_t maxUserWatches = dispatcher->mMaxUserWatches;
+        int32_t maxInotifyWatchNum = INT32_FLAG(default_max_inotify_watch_num);
+        INT32_FLAG(default_max_inotify_watch_num) = 3000;
+        INT32_FLAG(inotify_max_user_watches_usage_percent) = 50;
+
+        dispatcher->mMaxUserWatches = -1;
+        APSARA_TEST_EQUAL(3000, dispatcher->GetInotifyWatchLimit());
+        dispatcher->mMaxUserWatches = 8192;
+        APSARA_TEST_EQUAL(3000, dispatcher->GetInotifyWatchLimit());
+        dispatcher->mMaxUserWatches = 4000;
+        APSARA_TEST_EQUAL(2000, dispatcher->GetInotifyWatchLimit());
+        // capped after fs.inotify.max_user_watches is reached
+        dispatcher->mInotifyWatchCap = 1000;
+        APSARA_TEST_EQUAL(1000, dispatcher->GetInotifyWatchLimit());
+        // and lifted once one of our watchers is removed
+        if (dispatcher->mEventListener->IsInit()) {
+            int inotifyWatchNum = dispatcher->mInotifyWatchNum;
+            dispatcher->mInotifyWatchNum = 1;
+            ++dispatcher->mWatchNum;
+            dispatcher->UnregisterEventHandler("/basepath0/1");
+            APSARA_TEST_EQUAL(0, dispatcher->mInotifyWatchNum);
+            APSARA_TEST_EQUAL(INT_MAX, dispatcher->mInotifyWatchCap);
+            APSARA_TEST_EQUAL(2000, dispatcher->GetInotifyWatchLimit());
+            dispatcher->mInotifyWatchNum = inotifyWatchNum;
+        }
+
+        dispatcher->mInotifyWatchCap = INT_MAX;
+        dispatcher->mMaxUserWatches = maxUserWatches;
+        INT32_FLAG(default_max_inotify_watch_num) = maxInotifyWatchNum;
+    }
+
+    void TestIsColdDir() {
+        EventDispatcher* dispatcher = EventDispatcher::GetInstance();
+        std::filesystem::path dir = std::filesystem::absolute("event_dispatcher_cold_dir");
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        std::ofstream((dir / "a.log").string()) << "log\n";
+        INT32_FLAG(inotify_cold_dir_threshold) = 3600;
+
+        fsutil::PathStat statBuf;
+        APSARA_TEST_TRUE_FATAL(fsutil::PathStat::stat(dir.string(), statBuf));
+        APSARA_TEST_FALSE(dispatcher->IsColdDir(dir.string().c_str(), statBuf));
+
+        // dir is not modified for long, but a file in it is
+        auto oldTime = std::filesystem::last_write_time(dir) - std::chrono::hours(2);
+        std::filesystem::last_write_time(dir, oldTime);
+        APSARA_TEST_TRUE_FATAL(fsutil::PathStat::stat(dir.string(), statBuf));
+        APSARA_TEST_FALSE(dispatcher->IsColdDir(dir.string().c_str(), statBuf));
+
+        std::filesystem::last_write_time(dir / "a.log", oldTime);
+        APSARA_TEST_TRUE(dispatcher->IsColdDir(dir.string().c_str(), statBuf));
+
+        std::filesystem::remove_all(dir);
+    }
 };
 
 APSARA_UNIT_TEST_CASE(EventDispatcherDirUnittest, TestFindAllSubDirAndHandler, 0);
 APSARA_UNIT_TEST_CASE(EventDispatcherDirUnittest, TestUnregisterAllDir, 0);
 APSARA_UNIT_TEST_CASE(EventDispatcherDirUnittest, TestStopAllDir, 0);
+APSARA_UNIT_TEST_CASE(EventDispatcherDirUnittest, TestInotifyWatchLimit, 0);
+APSARA_UNIT_TEST_CASE(EventDispatcherDirUnittest, TestIsColdDir, 0);
 } // end of namespace logtail
 
 int main(int argc, char** argv) {
@@ -0,0 +1,51 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "file_server/event/Event.h"
+#include "file_server/event_listener/EventListener.h"
+#include "unittest/Unittest.h"
+
+namespace logtail {
+
+class EventListenerUnittest : public testing::Test {
+public:
+    void TestCoalesceModifyEvents();
+
+protected:
+    void SetUp() override { EventListener::GetInstance()->mModifiedObjects.clear(); }
+};
+
+void EventListenerUnittest::TestCoalesceModifyEvents() {
+    EventListener* listener = EventListener::GetInstance();
+    // repeated modify events of the same file are coalesced
+    APSARA_TEST_FALSE(listener->IsCoalesced(1, "a.log", EVENT_MODIFY));
+    APSARA_TEST_TRUE(listener->IsCoalesced(1, "a.log", EVENT_MODIFY));
+    // files of the same name in different dirs are different
+    APSARA_TEST_FALSE(listener->IsCoalesced(2, "a.log", EVENT_MODIFY));
+    APSARA_TEST_FALSE(listener->IsCoalesced(1, "b.log", EVENT_MODIFY));
+    APSARA_TEST_TRUE(listener->IsCoalesced(1, "b.log", EVENT_MODIFY));
+    // other events are never coalesced, and the next modify event after them is kept
+    APSARA_TEST_FALSE(listener->IsCoalesced(1, "a.log", EVENT_MOVE_FROM));
+    APSARA_TEST_FALSE(listener->IsCoalesced(1, "a.log", EVENT_CREATE));
+    APSARA_TEST_FALSE(listener->IsCoalesced(1, "a.log", EVENT_CREATE));
+    APSARA_TEST_FALSE(listener->IsCoalesced(1, "a.log", EVENT_MODIFY));
+    APSARA_TEST_TRUE(listener->IsCoalesced(1, "a.log", EVENT_MODIFY));
+    APSARA_TEST_FALSE(listener->IsCoalesced(1, "a.log", EVENT_MODIFY | EVENT_ISDIR));
+}
+
+UNIT_TEST_CASE(EventListenerUnittest, TestCoalesceModifyEvents)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
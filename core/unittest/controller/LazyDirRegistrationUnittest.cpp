@@ -0,0 +1,110 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "checkpoint/CheckPointManager.h"
+#include "common/Flags.h"
+#include "file_server/ConfigManager.h"
+#include "file_server/EventDispatcher.h"
+#include "file_server/FileDiscoveryOptions.h"
+#include "file_server/FileServer.h"
+#include "pipeline/PipelineContext.h"
+#include "unittest/Unittest.h"
+
+DECLARE_FLAG_BOOL(enable_lazy_dir_registration);
+DECLARE_FLAG_BOOL(enable_polling_discovery);
+
+using namespace std;
+
+namespace logtail {
+
+class LazyDirRegistrationUnittest : public testing::Test {
+public:
+    void TestConfigUpdateWithDeepCheckPoints();
+
+protected:
+    void SetUp() override {
+        BOOL_FLAG(enable_lazy_dir_registration) = true;
+        BOOL_FLAG(enable_polling_discovery) = false;
+        mRoot = filesystem::absolute("lazy_dir_registration");
+        filesystem::remove_all(mRoot);
+        filesystem::create_directories(mRoot / "a" / "b" / "c");
+        filesystem::create_directories(mRoot / "x" / "y" / "z");
+        mLogPath = (mRoot / "a" / "b" / "c" / "app.log").string();
+        ofstream(mLogPath) << "log\n";
+
+        Json::Value config;
+        config["FilePaths"].append(Json::Value((mRoot / "**" / "*.log").string()));
+        config["MaxDirSearchDepth"] = Json::Value(10);
+        mContext.SetConfigName(mConfigName);
+        APSARA_TEST_TRUE_FATAL(mOptions.Init(config, mContext, "input_file"));
+        FileServer::GetInstance()->AddFileDiscoveryConfig(mConfigName, &mOptions, &mContext);
+    }
+
+    void TearDown() override {
+        FileServer::GetInstance()->Pause(true);
+        FileServer::GetInstance()->RemoveFileDiscoveryConfig(mConfigName);
+        FileServer::GetInstance()->Resume(false);
+        CheckPointManager::Instance()->RemoveAllCheckPoint();
+        filesystem::remove_all(mRoot);
+    }
+
+private:
+    bool IsRegistered(const filesystem::path& dir) const {
+        return EventDispatcher::GetInstance()->IsRegistered(dir.string().c_str());
+    }
+
+    const string mConfigName = "lazy_dir_registration_config";
+    filesystem::path mRoot;
+    string mLogPath;
+    PipelineContext mContext;
+    FileDiscoveryOptions mOptions;
+};
+
+void LazyDirRegistrationUnittest::TestConfigUpdateWithDeepCheckPoints() {
+    CheckPointManager::Instance()->AddCheckPoint(
+        new CheckPoint(mLogPath, 0, 0, 0, DevInode(), mConfigName, mLogPath, false, false, false));
+
+    // start
+    ConfigManager::GetInstance()->RegisterHandlers();
+    ConfigManager::GetInstance()->RegisterCheckPointDirs();
+    APSARA_TEST_TRUE(IsRegistered(mRoot / "a" / "b" / "c"));
+    APSARA_TEST_FALSE(IsRegistered(mRoot / "x" / "y" / "z"));
+    APSARA_TEST_TRUE(ConfigManager::GetInstance()->HasPendingDirs());
+
+    // all dirs are unregistered for a config update, and the dir of the checkpointed file must be registered again
+    // before checkpoints are verified on resume
+    FileServer::GetInstance()->Pause(true);
+    APSARA_TEST_FALSE(IsRegistered(mRoot / "a" / "b" / "c"));
+    APSARA_TEST_FALSE(ConfigManager::GetInstance()->HasPendingDirs());
+    FileServer::GetInstance()->Resume(true);
+    APSARA_TEST_TRUE(IsRegistered(mRoot / "a" / "b" / "c"));
+    APSARA_TEST_FALSE(IsRegistered(mRoot / "x" / "y" / "z"));
+
+    // the others are left to the LogInput thread
+    while (ConfigManager::GetInstance()->HasPendingDirs()) {
+        ConfigManager::GetInstance()->RegisterPendingDirs(16);
+    }
+    APSARA_TEST_TRUE(IsRegistered(mRoot / "x" / "y" / "z"));
+}
+
+UNIT_TEST_CASE(LazyDirRegistrationUnittest, TestConfigUpdateWithDeepCheckPoints)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
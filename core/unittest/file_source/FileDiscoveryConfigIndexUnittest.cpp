@@ -0,0 +1,162 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <json/json.h>
+
+#include "file_server/FileDiscoveryConfigIndex.h"
+#include "pipeline/PipelineContext.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class FileDiscoveryConfigIndexUnittest : public testing::Test {
+public:
+    void TestGetLiteralDir() const;
+    void TestFindCandidates();
+    void TestUpdate();
+
+protected:
+    void SetUp() override { mOptions.clear(); }
+
+private:
+    FileDiscoveryConfig CreateConfig(const string& filePath, int32_t maxDepth = 0, bool container = false);
+    bool IsCandidate(const FileDiscoveryConfigIndex& index, const string& path, const FileDiscoveryConfig& config) const;
+
+    PipelineContext ctx;
+    vector<unique_ptr<FileDiscoveryOptions>> mOptions;
+};
+
+FileDiscoveryConfig
+FileDiscoveryConfigIndexUnittest::CreateConfig(const string& filePath, int32_t maxDepth, bool container) {
+    Json::Value configJson;
+    configJson["FilePaths"].append(Json::Value(filePath));
+    configJson["MaxDirSearchDepth"] = Json::Value(maxDepth);
+    mOptions.emplace_back(new FileDiscoveryOptions());
+    APSARA_TEST_TRUE(mOptions.back()->Init(configJson, ctx, "test"));
+    if (container) {
+        mOptions.back()->SetEnableContainerDiscoveryFlag(true);
+    }
+    return make_pair(mOptions.back().get(), &ctx);
+}
+
+bool FileDiscoveryConfigIndexUnittest::IsCandidate(const FileDiscoveryConfigIndex& index,
+                                                   const string& path,
+                                                   const FileDiscoveryConfig& config) const {
+    vector<FileDiscoveryConfig> candidates;
+    index.FindCandidates(path, candidates);
+    return find(candidates.begin(), candidates.end(), config) != candidates.end();
+}
+
+void FileDiscoveryConfigIndexUnittest::TestGetLiteralDir() const {
+    APSARA_TEST_EQUAL("/var/log/app", FileDiscoveryConfigIndex::GetLiteralDir("/var/log/app"));
+    APSARA_TEST_EQUAL("/var/log", FileDiscoveryConfigIndex::GetLiteralDir("/var/log/*/app"));
+    APSARA_TEST_EQUAL("/var/log", FileDiscoveryConfigIndex::GetLiteralDir("/var/log/app-?/**"));
+    APSARA_TEST_EQUAL("/var", FileDiscoveryConfigIndex::GetLiteralDir("/var/log[0-9]/app"));
+    APSARA_TEST_EQUAL("", FileDiscoveryConfigIndex::GetLiteralDir("/*/log"));
+}
+
+void FileDiscoveryConfigIndexUnittest::TestFindCandidates() {
+    FileDiscoveryConfigIndex index;
+    auto plain = CreateConfig("/var/log/app/*.log", -1);
+    auto nested = CreateConfig("/var/log/app/sub/*.log");
+    auto wildcard = CreateConfig("/var/log/*/app/*.log");
+    auto rootWildcard = CreateConfig("/*/logs/*.log");
+    auto other = CreateConfig("/home/admin/logs/*.log");
+    auto container = CreateConfig("/home/admin/logs/*.log", 0, true);
+    index.Add("plain", plain);
+    index.Add("nested", nested);
+    index.Add("wildcard", wildcard);
+    index.Add("rootWildcard", rootWildcard);
+    index.Add("other", other);
+    index.Add("container", container);
+    APSARA_TEST_EQUAL(6U, index.Size());
+
+    // every matched config is a candidate
+    const vector<pair<string, string>> objects = {{"/var/log/app", "a.log"},
+                                                  {"/var/log/app/sub", "a.log"},
+                                                  {"/var/log/app/sub/deep", "a.log"},
+                                                  {"/var/log/x/app", "a.log"},
+                                                  {"/opt/logs", "a.log"},
+                                                  {"/home/admin/logs", "a.log"},
+                                                  {"/var/log/app", ""}};
+    for (const auto& object : objects) {
+        for (const auto& config : {plain, nested, wildcard, rootWildcard, other}) {
+            if (config.first->IsMatch(object.first, object.second)) {
+                APSARA_TEST_TRUE(IsCandidate(index, object.first, config));
+            }
+        }
+    }
+
+    // configs under unrelated dirs are not candidates
+    APSARA_TEST_TRUE(IsCandidate(index, "/var/log/app/sub", plain));
+    APSARA_TEST_TRUE(IsCandidate(index, "/var/log/app/sub", nested));
+    APSARA_TEST_TRUE(IsCandidate(index, "/var/log/app/sub", wildcard));
+    APSARA_TEST_FALSE(IsCandidate(index, "/var/log/app/sub", other));
+    APSARA_TEST_FALSE(IsCandidate(index, "/var/log/application", plain));
+    APSARA_TEST_FALSE(IsCandidate(index, "/home/admin", other));
+    APSARA_TEST_FALSE(IsCandidate(index, "/home/admin/logs", plain));
+    // literal dir of /*/logs is /
+    APSARA_TEST_TRUE(IsCandidate(index, "/home/admin/logs", rootWildcard));
+    // containers dirs are unknown to the index
+    APSARA_TEST_TRUE(IsCandidate(index, "/var/log/app", container));
+    APSARA_TEST_TRUE(IsCandidate(index, "/any", container));
+}
+
+void FileDiscoveryConfigIndexUnittest::TestUpdate() {
+    FileDiscoveryConfigIndex index;
+    auto config1 = CreateConfig("/var/log/app/*.log");
+    auto config2 = CreateConfig("/home/admin/logs/*.log");
+    auto container = CreateConfig("/home/admin/logs/*.log", 0, true);
+    index.Add("test", config1);
+    index.Add("container", container);
+    APSARA_TEST_TRUE(IsCandidate(index, "/var/log/app", config1));
+
+    // replace
+    index.Add("test", config2);
+    APSARA_TEST_EQUAL(2U, index.Size());
+    APSARA_TEST_FALSE(IsCandidate(index, "/var/log/app", config1));
+    APSARA_TEST_TRUE(IsCandidate(index, "/home/admin/logs", config2));
+    APSARA_TEST_EQUAL(1U, index.mDirIndex.Size());
+
+    index.Remove("container");
+    APSARA_TEST_FALSE(IsCandidate(index, "/home/admin/logs", container));
+    index.Remove("test");
+    index.Remove("not_exist");
+    APSARA_TEST_EQUAL(0U, index.Size());
+    APSARA_TEST_EQUAL(0U, index.mDirIndex.Size());
+
+    // slots are reused
+    index.Add("test", config1);
+    APSARA_TEST_EQUAL(2U, index.mSlots.size());
+    APSARA_TEST_TRUE(IsCandidate(index, "/var/log/app", config1));
+
+    index.Clear();
+    APSARA_TEST_EQUAL(0U, index.Size());
+    APSARA_TEST_FALSE(IsCandidate(index, "/var/log/app", config1));
+}
+
+UNIT_TEST_CASE(FileDiscoveryConfigIndexUnittest, TestGetLiteralDir)
+UNIT_TEST_CASE(FileDiscoveryConfigIndexUnittest, TestFindCandidates)
+UNIT_TEST_CASE(FileDiscoveryConfigIndexUnittest, TestUpdate)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -32,6 +32,7 @@ public:
     void OnSuccessfulInit() const;
     void OnFailedInit() const;
     void TestFilePaths() const;
+    void TestContainerPathIndex() const;
 
 private:
     const string pluginType = "test";
@@ -282,9 +283,69 @@ void FileDiscoveryOptionsUnittest::TestFilePaths() const {
     APSARA_TEST_EQUAL("*.log", config->GetFilePattern());
 }
 
+void FileDiscoveryOptionsUnittest::TestContainerPathIndex() const {
+    FileDiscoveryOptions config;
+    config.SetContainerInfo(make_shared<vector<ContainerInfo>>());
+    config.SetDeduceAndSetContainerBaseDirFunc(
+        [](ContainerInfo& containerInfo, const PipelineContext*, const FileDiscoveryOptions*) {
+            containerInfo.mRealBaseDir = containerInfo.mUpperDir;
+            return true;
+        });
+    auto updateContainer = [&](const string& id, const string& upperDir) {
+        Json::Value params;
+        params["ID"] = Json::Value(id);
+        params["UpperDir"] = Json::Value(upperDir);
+        return config.UpdateContainerInfo(params, &ctx);
+    };
+    auto deleteContainer = [&](const string& id) {
+        Json::Value params;
+        params["ID"] = Json::Value(id);
+        return config.DeleteContainerInfo(params);
+    };
+    auto getContainerID = [&](const string& path) {
+        auto containerInfo = config.GetContainerPathByLogPath(path);
+        return containerInfo ? containerInfo->mID : string();
+    };
+
+    APSARA_TEST_TRUE(updateContainer("a", "/host/a"));
+    APSARA_TEST_TRUE(updateContainer("b", "/host/b"));
+    APSARA_TEST_TRUE(updateContainer("c", "/host/c"));
+    APSARA_TEST_EQUAL("a", getContainerID("/host/a/log"));
+    APSARA_TEST_EQUAL("b", getContainerID("/host/b"));
+    APSARA_TEST_EQUAL("", getContainerID("/host/bb/log"));
+
+    // update
+    APSARA_TEST_TRUE(updateContainer("b", "/host/bb"));
+    APSARA_TEST_EQUAL("", getContainerID("/host/b/log"));
+    APSARA_TEST_EQUAL("b", getContainerID("/host/bb/log"));
+
+    // delete, the last container is moved
+    APSARA_TEST_TRUE(deleteContainer("a"));
+    APSARA_TEST_EQUAL(2U, config.GetContainerInfo()->size());
+    APSARA_TEST_EQUAL("", getContainerID("/host/a/log"));
+    APSARA_TEST_EQUAL("b", getContainerID("/host/bb/log"));
+    APSARA_TEST_EQUAL("c", getContainerID("/host/c/log"));
+
+    // replace all
+    Json::Value allCmd;
+    allCmd["ID"] = Json::Value("d");
+    allCmd["UpperDir"] = Json::Value("/host/d");
+    Json::Value params;
+    params["AllCmd"].append(allCmd);
+    APSARA_TEST_TRUE(config.UpdateContainerInfo(params, &ctx));
+    APSARA_TEST_EQUAL("", getContainerID("/host/c/log"));
+    APSARA_TEST_EQUAL("d", getContainerID("/host/d/log"));
+
+    // reindexed when container info is handed over
+    FileDiscoveryOptions newConfig;
+    newConfig.SetContainerInfo(config.GetContainerInfo());
+    APSARA_TEST_EQUAL("d", newConfig.GetContainerPathByLogPath("/host/d/log")->mID);
+}
+
 UNIT_TEST_CASE(FileDiscoveryOptionsUnittest, OnSuccessfulInit)
 UNIT_TEST_CASE(FileDiscoveryOptionsUnittest, OnFailedInit)
 UNIT_TEST_CASE(FileDiscoveryOptionsUnittest, TestFilePaths)
+UNIT_TEST_CASE(FileDiscoveryOptionsUnittest, TestContainerPathIndex)
 
 } // namespace logtail
 
@@ -17,6 +17,7 @@
 #include "common/JsonUtil.h"
 #include "config/InstanceConfig.h"
 #include "config/InstanceConfigManager.h"
+#include "pipeline/queue/SenderQueueManager.h"
 #include "runner/FlusherRunner.h"
 #include "unittest/Unittest.h"
 
@@ -148,7 +149,8 @@ void InstanceConfigManagerUnittest::TestUpdateInstanceConfigs() {
         APSARA_TEST_EQUAL(nullptr, InstanceConfigManager::GetInstance()->FindConfigByName("test3"));
     }
     APSARA_TEST_EQUAL(kDefaultMaxSendBytePerSec, AppConfig::GetInstance()->GetMaxBytePerSec());
-    APSARA_TEST_EQUAL(true, FlusherRunner::GetInstance()->mEnableRateLimiter);
+    APSARA_TEST_EQUAL(static_cast<uint64_t>(kDefaultMaxSendBytePerSec),
+                      SenderQueueManager::GetInstance()->GetGlobalRateLimiter()->GetMaxRate());
     // Modified
     status = 1;
     {
@@ -202,7 +204,7 @@ void InstanceConfigManagerUnittest::TestUpdateInstanceConfigs() {
         APSARA_TEST_EQUAL(nullptr, InstanceConfigManager::GetInstance()->FindConfigByName("test3"));
     }
     APSARA_TEST_EQUAL(31457280, AppConfig::GetInstance()->GetMaxBytePerSec());
-    APSARA_TEST_EQUAL(false, FlusherRunner::GetInstance()->mEnableRateLimiter);
+    APSARA_TEST_EQUAL(31457280U, SenderQueueManager::GetInstance()->GetGlobalRateLimiter()->GetMaxRate());
     // Removed
     status = 2;
     {
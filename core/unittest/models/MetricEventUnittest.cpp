@@ -26,6 +26,7 @@ class MetricEventUnittest : public ::testing::Test {
 public:
     void TestName();
     void TestValue();
+    void TestMultiDoubleValues();
     void TestTag();
     void TestSize();
     void TestReset();
@@ -61,6 +62,30 @@ void MetricEventUnittest::TestValue() {
     APSARA_TEST_EQUAL(100.0, mMetricEvent->GetValue<UntypedSingleValue>()->mValue);
 }
 
+void MetricEventUnittest::TestMultiDoubleValues() {
+    mMetricEvent->SetValue(UntypedSingleValue{10.0});
+    {
+        string key = "user";
+        mMetricEvent->SetMultiDoubleValue(key, 0.5);
+    }
+    mMetricEvent->SetMultiDoubleValueNoCopy(StringView("idle"), 0.25);
+    APSARA_TEST_TRUE(mMetricEvent->Is<UntypedMultiDoubleValues>());
+    const auto* v = mMetricEvent->GetValue<UntypedMultiDoubleValues>();
+    APSARA_TEST_EQUAL(2U, v->mValues.size());
+    double val = 0.0;
+    APSARA_TEST_TRUE(v->GetValue("user", val));
+    APSARA_TEST_EQUAL(0.5, val);
+    APSARA_TEST_TRUE(v->HasValue("idle"));
+    APSARA_TEST_FALSE(v->HasValue("system"));
+
+    Json::Value res = mMetricEvent->ToJson();
+    auto event = mEventGroup->CreateMetricEvent();
+    event->FromJson(res);
+    APSARA_TEST_TRUE(event->Is<UntypedMultiDoubleValues>());
+    APSARA_TEST_TRUE(event->GetValue<UntypedMultiDoubleValues>()->GetValue("idle", val));
+    APSARA_TEST_EQUAL(0.25, val);
+}
+
 void MetricEventUnittest::TestTag() {
     {
         string key = "key1";
@@ -217,6 +242,7 @@ void MetricEventUnittest::TestTagsIterator() {
 
 UNIT_TEST_CASE(MetricEventUnittest, TestName)
 UNIT_TEST_CASE(MetricEventUnittest, TestValue)
+UNIT_TEST_CASE(MetricEventUnittest, TestMultiDoubleValues)
 UNIT_TEST_CASE(MetricEventUnittest, TestTag)
 UNIT_TEST_CASE(MetricEventUnittest, TestSize)
 UNIT_TEST_CASE(MetricEventUnittest, TestReset)
@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cmath>
+#include <limits>
+
 #include "common/JsonUtil.h"
 #include "unittest/Unittest.h"
 
@@ -76,6 +79,76 @@ void UntypedSingleValueUnittest::TestFromJson() {
 UNIT_TEST_CASE(UntypedSingleValueUnittest, TestToJson)
 UNIT_TEST_CASE(UntypedSingleValueUnittest, TestFromJson)
 
+class HistogramAndSummaryValueUnittest : public ::testing::Test {
+public:
+    void TestHistogramValue();
+    void TestSummaryValue();
+    void TestSeriesCount();
+    void TestFormatMetricBoundary();
+};
+
+void HistogramAndSummaryValueUnittest::TestHistogramValue() {
+    HistogramValue value;
+    value.mSum = 3.5;
+    value.mCount = 4;
+    value.mBuckets = {{0.5, 1}, {numeric_limits<double>::infinity(), 4}};
+    MetricValue res = JsonToMetricValue("histogram", MetricValueToJson(value)["detail"]);
+    APSARA_TEST_TRUE(holds_alternative<HistogramValue>(res));
+    const auto& h = get<HistogramValue>(res);
+    APSARA_TEST_EQUAL(3.5, h.mSum);
+    APSARA_TEST_EQUAL(4.0, h.mCount);
+    APSARA_TEST_EQUAL(2U, h.mBuckets.size());
+    APSARA_TEST_EQUAL(0.5, h.mBuckets[0].mUpperBound);
+    APSARA_TEST_TRUE(isinf(h.mBuckets[1].mUpperBound));
+    APSARA_TEST_EQUAL(4.0, h.mBuckets[1].mCount);
+    APSARA_TEST_EQUAL(sizeof(HistogramValue) + 2 * sizeof(HistogramValue::Bucket), DataSize(res));
+}
+
+void HistogramAndSummaryValueUnittest::TestSummaryValue() {
+    SummaryValue value;
+    value.mSum = 10;
+    value.mCount = 2;
+    value.mQuantiles = {{0.5, 2}, {0.99, 8}};
+    MetricValue res = JsonToMetricValue("summary", MetricValueToJson(value)["detail"]);
+    APSARA_TEST_TRUE(holds_alternative<SummaryValue>(res));
+    const auto& s = get<SummaryValue>(res);
+    APSARA_TEST_EQUAL(10.0, s.mSum);
+    APSARA_TEST_EQUAL(2.0, s.mCount);
+    APSARA_TEST_EQUAL(2U, s.mQuantiles.size());
+    APSARA_TEST_EQUAL(0.99, s.mQuantiles[1].mQuantile);
+    APSARA_TEST_EQUAL(8.0, s.mQuantiles[1].mValue);
+}
+
+void HistogramAndSummaryValueUnittest::TestSeriesCount() {
+    APSARA_TEST_EQUAL(0U, SeriesCount(MetricValue()));
+    APSARA_TEST_EQUAL(1U, SeriesCount(UntypedSingleValue{1.0}));
+    UntypedMultiDoubleValues multi;
+    multi.SetValueNoCopy("a", 1.0);
+    multi.SetValueNoCopy("b", 2.0);
+    APSARA_TEST_EQUAL(2U, SeriesCount(multi));
+    HistogramValue histogram;
+    histogram.mBuckets = {{1, 1}, {2, 2}, {numeric_limits<double>::infinity(), 3}};
+    APSARA_TEST_EQUAL(5U, SeriesCount(histogram));
+    SummaryValue summary;
+    summary.mQuantiles = {{0.5, 1}};
+    APSARA_TEST_EQUAL(3U, SeriesCount(summary));
+}
+
+void HistogramAndSummaryValueUnittest::TestFormatMetricBoundary() {
+    APSARA_TEST_EQUAL("0.005", FormatMetricBoundary(0.005));
+    APSARA_TEST_EQUAL("1", FormatMetricBoundary(1.0));
+    APSARA_TEST_EQUAL("2.5", FormatMetricBoundary(2.5));
+    APSARA_TEST_EQUAL("1e+06", FormatMetricBoundary(1e6));
+    APSARA_TEST_EQUAL("+Inf", FormatMetricBoundary(numeric_limits<double>::infinity()));
+    APSARA_TEST_EQUAL("-Inf", FormatMetricBoundary(-numeric_limits<double>::infinity()));
+    APSARA_TEST_EQUAL("NaN", FormatMetricBoundary(numeric_limits<double>::quiet_NaN()));
+}
+
+UNIT_TEST_CASE(HistogramAndSummaryValueUnittest, TestHistogramValue)
+UNIT_TEST_CASE(HistogramAndSummaryValueUnittest, TestSummaryValue)
+UNIT_TEST_CASE(HistogramAndSummaryValueUnittest, TestSeriesCount)
+UNIT_TEST_CASE(HistogramAndSummaryValueUnittest, TestFormatMetricBoundary)
+
 } // namespace logtail
 
 UNIT_TEST_MAIN
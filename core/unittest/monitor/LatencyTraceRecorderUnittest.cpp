@@ -0,0 +1,122 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/Flags.h"
+#include "monitor/LatencyTraceRecorder.h"
+#include "monitor/MetricManager.h"
+#include "unittest/Unittest.h"
+
+DECLARE_FLAG_INT32(pipeline_latency_trace_sample_interval);
+
+using namespace std;
+
+namespace logtail {
+
+class LatencyTraceRecorderUnittest : public ::testing::Test {
+public:
+    void TestStartTrace();
+    void TestRecord();
+    void TestExemplar();
+
+protected:
+    void TearDown() override { INT32_FLAG(pipeline_latency_trace_sample_interval) = 0; }
+};
+
+void LatencyTraceRecorderUnittest::TestStartTrace() {
+    APSARA_TEST_FALSE(LatencyTraceRecorder::IsEnabled());
+    APSARA_TEST_EQUAL(nullptr, LatencyTraceRecorder::StartTrace());
+
+    INT32_FLAG(pipeline_latency_trace_sample_interval) = 4;
+    APSARA_TEST_TRUE(LatencyTraceRecorder::IsEnabled());
+    size_t sampled = 0;
+    for (size_t i = 0; i < 100; ++i) {
+        auto trace = LatencyTraceRecorder::StartTrace();
+        if (trace) {
+            ++sampled;
+            APSARA_TEST_TRUE(trace->HasStamp(LatencyStage::READ));
+            APSARA_TEST_FALSE(trace->HasStamp(LatencyStage::ACK));
+        }
+    }
+    APSARA_TEST_EQUAL(25U, sampled);
+}
+
+void LatencyTraceRecorderUnittest::TestRecord() {
+    MetricsRecordRef ref;
+    WriteMetrics::GetInstance()->PrepareMetricsRecordRef(ref, MetricCategory::METRIC_CATEGORY_PIPELINE, {});
+    LatencyTraceRecorder recorder;
+    recorder.Init(ref);
+
+    auto start = LatencyTrace::Clock::now();
+    LatencyTrace trace;
+    trace.Stamp(LatencyStage::READ, start);
+    trace.Stamp(LatencyStage::PROCESS_QUEUE_PUSH, start + chrono::microseconds(10));
+    trace.Stamp(LatencyStage::PROCESS, start + chrono::microseconds(110));
+    trace.Stamp(LatencyStage::SEND, start + chrono::milliseconds(5));
+    // send stamped again on retry after ack would be out of order
+    trace.Stamp(LatencyStage::ACK, start + chrono::milliseconds(3));
+    recorder.Record(trace);
+
+    auto& stages = recorder.mStageLatencyUs;
+    APSARA_TEST_EQUAL(1U, stages[static_cast<size_t>(LatencyStage::PROCESS_QUEUE_PUSH)]->GetCount());
+    APSARA_TEST_EQUAL(10U, stages[static_cast<size_t>(LatencyStage::PROCESS_QUEUE_PUSH)]->GetSum());
+    APSARA_TEST_EQUAL(100U, stages[static_cast<size_t>(LatencyStage::PROCESS)]->GetSum());
+    APSARA_TEST_EQUAL(0U, stages[static_cast<size_t>(LatencyStage::PROCESS_QUEUE_POP)]->GetCount());
+    APSARA_TEST_EQUAL(4890U, stages[static_cast<size_t>(LatencyStage::SEND)]->GetSum());
+    APSARA_TEST_EQUAL(1U, stages[static_cast<size_t>(LatencyStage::ACK)]->GetCount());
+    APSARA_TEST_EQUAL(0U, stages[static_cast<size_t>(LatencyStage::ACK)]->GetSum());
+    APSARA_TEST_EQUAL(5000U, recorder.mE2ELatencyUs->GetSum());
+
+    // traces without read stamp are ignored
+    recorder.Record(LatencyTrace());
+    APSARA_TEST_EQUAL(1U, recorder.mE2ELatencyUs->GetCount());
+
+    // nothing is recorded before init
+    LatencyTraceRecorder uninited;
+    uninited.Record(trace);
+    APSARA_TEST_EQUAL(nullptr, uninited.mE2ELatencyUs);
+}
+
+void LatencyTraceRecorderUnittest::TestExemplar() {
+    MetricsRecordRef ref;
+    WriteMetrics::GetInstance()->PrepareMetricsRecordRef(ref, MetricCategory::METRIC_CATEGORY_PIPELINE, {});
+    auto recorder = make_unique<LatencyTraceRecorder>();
+    recorder->Init(ref);
+    auto label = recorder->GetExemplarLabel();
+    APSARA_TEST_EQUAL("latency_exemplar", label.first);
+    APSARA_TEST_EQUAL("", label.second());
+
+    auto start = LatencyTrace::Clock::now();
+    LatencyTrace slow;
+    slow.Stamp(LatencyStage::READ, start);
+    slow.Stamp(LatencyStage::ACK, start + chrono::milliseconds(20));
+    recorder->Record(slow);
+    LatencyTrace fast;
+    fast.Stamp(LatencyStage::READ, start);
+    fast.Stamp(LatencyStage::SERIALIZE, start + chrono::microseconds(300));
+    fast.Stamp(LatencyStage::ACK, start + chrono::milliseconds(1));
+    recorder->Record(fast);
+    APSARA_TEST_EQUAL("ack:20000,e2e:20000", label.second());
+
+    // the label outlives the recorder
+    recorder.reset();
+    APSARA_TEST_EQUAL("ack:20000,e2e:20000", label.second());
+}
+
+UNIT_TEST_CASE(LatencyTraceRecorderUnittest, TestStartTrace)
+UNIT_TEST_CASE(LatencyTraceRecorderUnittest, TestRecord)
+UNIT_TEST_CASE(LatencyTraceRecorderUnittest, TestExemplar)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
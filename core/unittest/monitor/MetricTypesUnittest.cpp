@@ -0,0 +1,145 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "monitor/MetricRecord.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class MetricTypesUnittest : public ::testing::Test {
+public:
+    void TestCounterMultiThread();
+    void TestTimeCounter();
+    void TestHistogramBucket();
+    void TestHistogramQuantile();
+    void TestCollect();
+};
+
+void MetricTypesUnittest::TestCounterMultiThread() {
+    for (bool sharded : {false, true}) {
+        Counter counter("counter", 5, sharded);
+        APSARA_TEST_EQUAL(sharded, counter.IsSharded());
+        vector<thread> threads;
+        for (int i = 0; i < 16; ++i) {
+            threads.emplace_back([&counter]() {
+                for (int j = 0; j < 10000; ++j) {
+                    counter.Add(1);
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        APSARA_TEST_EQUAL(160005U, counter.GetValue());
+
+        unique_ptr<Counter> snapshot(counter.Collect());
+        APSARA_TEST_EQUAL(160005U, snapshot->GetValue());
+        APSARA_TEST_EQUAL("counter", snapshot->GetName());
+        APSARA_TEST_FALSE(snapshot->IsSharded());
+        APSARA_TEST_EQUAL(0U, counter.GetValue());
+    }
+}
+
+void MetricTypesUnittest::TestTimeCounter() {
+    TimeCounter counter("time_counter");
+    counter.Add(chrono::milliseconds(3));
+    counter.Add(chrono::microseconds(2500));
+    APSARA_TEST_EQUAL(5U, counter.GetValue());
+    unique_ptr<TimeCounter> snapshot(counter.Collect());
+    APSARA_TEST_EQUAL(5U, snapshot->GetValue());
+    APSARA_TEST_EQUAL(0U, counter.GetValue());
+}
+
+void MetricTypesUnittest::TestHistogramBucket() {
+    for (uint64_t v = 0; v < 4; ++v) {
+        APSARA_TEST_EQUAL(v, Histogram::GetBucketIndex(v));
+    }
+    APSARA_TEST_EQUAL(4U, Histogram::GetBucketIndex(4));
+    APSARA_TEST_EQUAL(7U, Histogram::GetBucketIndex(7));
+    APSARA_TEST_EQUAL(8U, Histogram::GetBucketIndex(8));
+    APSARA_TEST_EQUAL(8U, Histogram::GetBucketIndex(9));
+    APSARA_TEST_EQUAL(9U, Histogram::GetBucketIndex(10));
+    APSARA_TEST_EQUAL(Histogram::sBucketCnt - 1, Histogram::GetBucketIndex(UINT64_MAX));
+    APSARA_TEST_EQUAL(UINT64_MAX, Histogram::GetBucketUpperBound(Histogram::sBucketCnt - 1));
+
+    // every value falls in the bucket whose bounds contain it, and bucket bounds grow strictly
+    uint64_t prevUpper = 0;
+    for (uint32_t i = 1; i < Histogram::sBucketCnt; ++i) {
+        uint64_t upper = Histogram::GetBucketUpperBound(i);
+        APSARA_TEST_GT(upper, prevUpper);
+        APSARA_TEST_EQUAL(i, Histogram::GetBucketIndex(prevUpper + 1));
+        APSARA_TEST_EQUAL(i, Histogram::GetBucketIndex(upper));
+        prevUpper = upper;
+    }
+}
+
+void MetricTypesUnittest::TestHistogramQuantile() {
+    Histogram histogram("latency");
+    APSARA_TEST_EQUAL(0U, histogram.GetQuantile(0.5));
+    for (uint64_t v = 1; v <= 100; ++v) {
+        histogram.Add(v);
+    }
+    APSARA_TEST_EQUAL(100U, histogram.GetCount());
+    APSARA_TEST_EQUAL(5050U, histogram.GetSum());
+    // quantiles are reported as the upper bound of the bucket, which is at most 25% larger than the real value
+    uint64_t p50 = histogram.GetQuantile(0.5);
+    APSARA_TEST_TRUE(p50 >= 50 && p50 <= 63);
+    uint64_t p99 = histogram.GetQuantile(0.99);
+    APSARA_TEST_TRUE(p99 >= 99 && p99 <= 127);
+    APSARA_TEST_EQUAL(111U, histogram.GetQuantile(1.0));
+
+    // durations are recorded in microseconds
+    histogram.Add(chrono::nanoseconds(2500));
+    APSARA_TEST_EQUAL(2U, histogram.GetBucketCount(2));
+}
+
+void MetricTypesUnittest::TestCollect() {
+    MetricsRecord record("test", make_shared<MetricLabels>());
+    auto counter = record.CreateCounter("counter");
+    auto shardedCounter = record.CreateCounter("sharded_counter", true);
+    auto histogram = record.CreateHistogram("histogram");
+    counter->Add(3);
+    shardedCounter->Add(4);
+    histogram->Add(10);
+    histogram->Add(1000);
+
+    unique_ptr<MetricsRecord> snapshot(record.Collect());
+    APSARA_TEST_EQUAL(1U, snapshot->GetHistograms().size());
+    auto& collected = snapshot->GetHistograms()[0];
+    APSARA_TEST_EQUAL("histogram", collected->GetName());
+    APSARA_TEST_EQUAL(2U, collected->GetCount());
+    APSARA_TEST_EQUAL(1010U, collected->GetSum());
+    APSARA_TEST_EQUAL(3U, snapshot->GetCounters()[0]->GetValue());
+    APSARA_TEST_EQUAL(4U, snapshot->GetCounters()[1]->GetValue());
+    APSARA_TEST_EQUAL(0U, shardedCounter->GetValue());
+    APSARA_TEST_EQUAL(0U, histogram->GetCount());
+    APSARA_TEST_EQUAL(0U, histogram->GetSum());
+    APSARA_TEST_EQUAL(0U, counter->GetValue());
+}
+
+UNIT_TEST_CASE(MetricTypesUnittest, TestCounterMultiThread)
+UNIT_TEST_CASE(MetricTypesUnittest, TestTimeCounter)
+UNIT_TEST_CASE(MetricTypesUnittest, TestHistogramBucket)
+UNIT_TEST_CASE(MetricTypesUnittest, TestHistogramQuantile)
+UNIT_TEST_CASE(MetricTypesUnittest, TestCollect)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
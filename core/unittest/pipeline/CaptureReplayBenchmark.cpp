@@ -0,0 +1,195 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/Flags.h"
+#include "common/JsonUtil.h"
+#include "config/PipelineConfig.h"
+#include "pipeline/Pipeline.h"
+#include "pipeline/plugin/PluginRegistry.h"
+#include "pipeline/queue/SenderQueueManager.h"
+#include "plugin/input/InputFeedbackInterfaceRegistry.h"
+#include "runner/EventGroupCapture.h"
+
+DEFINE_FLAG_STRING(replay_capture_file, "capture file written by process_queue_capture_file", "");
+DEFINE_FLAG_STRING(replay_config_file,
+                   "pipeline config the captured groups are replayed through, flusher_blackhole is recommended",
+                   "");
+DEFINE_FLAG_STRING(replay_config_name, "only groups captured from this config are replayed, empty for all", "");
+DEFINE_FLAG_INT32(replay_threads, "number of threads replaying groups concurrently", 1);
+DEFINE_FLAG_INT32(replay_loops, "how many times the captured groups are replayed", 1);
+
+using namespace std;
+
+namespace logtail {
+
+struct CapturedGroup {
+    size_t mInputIndex = 0;
+    PipelineEventGroup mGroup{make_shared<SourceBuffer>()};
+};
+
+// Replays captured event groups through a pipeline at max speed. Groups are copied before each loop, so that only
+// processing, routing and flushing are timed. Sender queue items are removed once pushed.
+class CaptureReplayBenchmark {
+public:
+    bool Init();
+    void Run();
+
+private:
+    void Replay(vector<CapturedGroup>& groups, size_t begin, uint32_t step);
+    static void DrainSenderQueue();
+
+    unique_ptr<Pipeline> mPipeline;
+    vector<CapturedGroup> mCapturedGroups;
+    uint64_t mEvents = 0;
+    uint64_t mBytes = 0;
+};
+
+bool CaptureReplayBenchmark::Init() {
+    ifstream fin(STRING_FLAG(replay_config_file));
+    if (!fin) {
+        printf("failed to open config file %s\n", STRING_FLAG(replay_config_file).c_str());
+        return false;
+    }
+    stringstream ss;
+    ss << fin.rdbuf();
+    string errorMsg;
+    auto configJson = make_unique<Json::Value>();
+    if (!ParseJsonTable(ss.str(), *configJson, errorMsg)) {
+        printf("invalid pipeline config: %s\n", errorMsg.c_str());
+        return false;
+    }
+    PipelineConfig config("replay", std::move(configJson));
+    mPipeline = make_unique<Pipeline>();
+    if (!config.Parse() || !mPipeline->Init(std::move(config))) {
+        printf("failed to init pipeline\n");
+        return false;
+    }
+
+    EventGroupCaptureReader reader;
+    if (!reader.Open(STRING_FLAG(replay_capture_file))) {
+        printf("%s\n", reader.GetErrorMsg().c_str());
+        return false;
+    }
+    string configName;
+    size_t inputIndex = 0;
+    CapturedGroup captured;
+    while (reader.Next(configName, inputIndex, captured.mGroup)) {
+        if (STRING_FLAG(replay_config_name).empty() || configName == STRING_FLAG(replay_config_name)) {
+            // groups captured from an input the replay config does not have are replayed through the first input
+            captured.mInputIndex = inputIndex < mPipeline->GetInputs().size() ? inputIndex : 0;
+            mEvents += captured.mGroup.GetEvents().size();
+            mBytes += captured.mGroup.DataSize();
+            mCapturedGroups.emplace_back(std::move(captured));
+        }
+        captured = CapturedGroup();
+    }
+    if (!reader.GetErrorMsg().empty()) {
+        printf("capture file is truncated: %s, %zu groups loaded\n",
+               reader.GetErrorMsg().c_str(),
+               mCapturedGroups.size());
+    }
+    if (mCapturedGroups.empty()) {
+        printf("no group to replay\n");
+        return false;
+    }
+    return true;
+}
+
+void CaptureReplayBenchmark::DrainSenderQueue() {
+    vector<SenderQueueItem*> items;
+    SenderQueueManager::GetInstance()->GetAvailableItems(items, -1);
+    for (auto item : items) {
+        SenderQueueManager::GetInstance()->RemoveItem(item->mFlusher->GetQueueKey(), item);
+    }
+}
+
+void CaptureReplayBenchmark::Replay(vector<CapturedGroup>& groups, size_t begin, uint32_t step) {
+    for (size_t i = begin; i < groups.size(); i += step) {
+        vector<PipelineEventGroup> groupList;
+        groupList.emplace_back(std::move(groups[i].mGroup));
+        mPipeline->Process(groupList, groups[i].mInputIndex);
+        mPipeline->Send(std::move(groupList));
+        DrainSenderQueue();
+    }
+}
+
+void CaptureReplayBenchmark::Run() {
+    uint32_t threadCnt = max(INT32_FLAG(replay_threads), 1);
+    int32_t loops = max(INT32_FLAG(replay_loops), 1);
+    chrono::steady_clock::duration elapsed{};
+    for (int32_t loop = 0; loop < loops; ++loop) {
+        vector<CapturedGroup> groups;
+        groups.reserve(mCapturedGroups.size());
+        for (const auto& captured : mCapturedGroups) {
+            groups.emplace_back();
+            groups.back().mInputIndex = captured.mInputIndex;
+            groups.back().mGroup = captured.mGroup.Copy();
+        }
+
+        auto start = chrono::steady_clock::now();
+        vector<thread> threads;
+        for (uint32_t i = 0; i < threadCnt; ++i) {
+            threads.emplace_back(&CaptureReplayBenchmark::Replay, this, ref(groups), i, threadCnt);
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        mPipeline->FlushBatch();
+        DrainSenderQueue();
+        elapsed += chrono::steady_clock::now() - start;
+    }
+
+    double seconds = chrono::duration<double>(elapsed).count();
+    double mb = mBytes * loops / 1024.0 / 1024.0;
+    printf("groups: %zu, events: %lu, size: %.1fMB, threads: %u, loops: %d, time: %.3fs\n",
+           mCapturedGroups.size(),
+           mEvents,
+           mBytes / 1024.0 / 1024.0,
+           threadCnt,
+           loops,
+           seconds);
+    printf("%.0f events/s, %.2f MB/s\n", mEvents * loops / seconds, mb / seconds);
+}
+
+} // namespace logtail
+
+using namespace logtail;
+
+int main(int argc, char* argv[]) {
+    google::ParseCommandLineFlags(&argc, &argv, true);
+    PluginRegistry::GetInstance()->LoadPlugins();
+    InputFeedbackInterfaceRegistry::GetInstance()->LoadFeedbackInterfaces();
+
+    int ret = 0;
+    {
+        CaptureReplayBenchmark benchmark;
+        if (benchmark.Init()) {
+            benchmark.Run();
+        } else {
+            ret = 1;
+        }
+    }
+    PluginRegistry::GetInstance()->UnloadPlugins();
+    return ret;
+}
@@ -0,0 +1,191 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdio>
+
+#include <boost/filesystem.hpp>
+
+#include "common/Flags.h"
+#include "runner/EventGroupCapture.h"
+#include "unittest/Unittest.h"
+
+DECLARE_FLAG_STRING(process_queue_capture_file);
+DECLARE_FLAG_STRING(process_queue_capture_configs);
+DECLARE_FLAG_INT64(process_queue_capture_max_size_bytes);
+
+using namespace std;
+
+namespace logtail {
+
+class EventGroupCaptureUnittest : public ::testing::Test {
+public:
+    void TestCaptureAndRead();
+    void TestConfigFilter();
+    void TestMaxSize();
+    void TestTruncatedFile();
+
+protected:
+    void SetUp() override {
+        mFilePath = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+        STRING_FLAG(process_queue_capture_file) = mFilePath;
+    }
+
+    void TearDown() override {
+        EventGroupCapture::GetInstance()->Stop();
+        STRING_FLAG(process_queue_capture_file) = "";
+        STRING_FLAG(process_queue_capture_configs) = "";
+        INT64_FLAG(process_queue_capture_max_size_bytes) = 1024 * 1024 * 1024;
+        remove(mFilePath.c_str());
+    }
+
+private:
+    static PipelineEventGroup CreateLogGroup(const string& content) {
+        PipelineEventGroup group(make_shared<SourceBuffer>());
+        group.SetMetadata(EventGroupMetaKey::LOG_FILE_PATH, string("/var/log/test.log"));
+        group.SetMetadata(EventGroupMetaKey::SOURCE_ID, string("source"));
+        group.SetTag(string("tag_key"), string("tag_value"));
+        auto e = group.AddLogEvent();
+        e->SetTimestamp(1729000000, 123);
+        e->SetContent(string("content"), content);
+        e->SetLevel("INFO");
+        e->SetPosition(100, 20);
+        return group;
+    }
+
+    string mFilePath;
+};
+
+void EventGroupCaptureUnittest::TestCaptureAndRead() {
+    EventGroupCapture::GetInstance()->Init();
+    APSARA_TEST_TRUE(EventGroupCapture::GetInstance()->IsEnabled());
+    EventGroupCapture::GetInstance()->Capture("config_1", 0, CreateLogGroup("first"));
+    {
+        // raw events are not supported
+        PipelineEventGroup group(make_shared<SourceBuffer>());
+        group.AddRawEvent();
+        EventGroupCapture::GetInstance()->Capture("config_1", 0, group);
+    }
+    {
+        // empty groups, e.g. those moved from by a failed push, are not captured
+        PipelineEventGroup group(make_shared<SourceBuffer>());
+        string record;
+        APSARA_TEST_FALSE(EventGroupCapture::GetInstance()->Serialize("config_1", 0, group, record));
+    }
+    {
+        // nothing is written until the serialized record is written, i.e. the group is pushed
+        string record;
+        APSARA_TEST_TRUE(EventGroupCapture::GetInstance()->Serialize("config_2", 1, CreateLogGroup("second"), record));
+        APSARA_TEST_EQUAL(1U, EventGroupCapture::GetInstance()->mCapturedCnt);
+        EventGroupCapture::GetInstance()->Write(record);
+    }
+    APSARA_TEST_EQUAL(2U, EventGroupCapture::GetInstance()->mCapturedCnt);
+    APSARA_TEST_EQUAL(1U, EventGroupCapture::GetInstance()->mSkippedCnt);
+    EventGroupCapture::GetInstance()->Stop();
+    APSARA_TEST_FALSE(EventGroupCapture::GetInstance()->IsEnabled());
+
+    EventGroupCaptureReader reader;
+    APSARA_TEST_TRUE(reader.Open(mFilePath));
+    string configName;
+    size_t inputIndex = 0;
+    {
+        PipelineEventGroup group(make_shared<SourceBuffer>());
+        APSARA_TEST_TRUE(reader.Next(configName, inputIndex, group));
+        APSARA_TEST_EQUAL("config_1", configName);
+        APSARA_TEST_EQUAL(0U, inputIndex);
+        APSARA_TEST_EQUAL("/var/log/test.log", group.GetMetadata(EventGroupMetaKey::LOG_FILE_PATH).to_string());
+        APSARA_TEST_EQUAL("source", group.GetMetadata(EventGroupMetaKey::SOURCE_ID).to_string());
+        APSARA_TEST_EQUAL("tag_value", group.GetTag("tag_key").to_string());
+        APSARA_TEST_EQUAL(1U, group.GetEvents().size());
+        const auto& e = group.GetEvents()[0].Cast<LogEvent>();
+        APSARA_TEST_EQUAL(1729000000, e.GetTimestamp());
+        APSARA_TEST_EQUAL(123U, e.GetTimestampNanosecond().value_or(0));
+        APSARA_TEST_EQUAL("first", e.GetContent("content").to_string());
+        APSARA_TEST_EQUAL("INFO", e.GetLevel().to_string());
+        APSARA_TEST_EQUAL(100U, e.GetPosition().first);
+        APSARA_TEST_EQUAL(20U, e.GetPosition().second);
+    }
+    {
+        PipelineEventGroup group(make_shared<SourceBuffer>());
+        APSARA_TEST_TRUE(reader.Next(configName, inputIndex, group));
+        APSARA_TEST_EQUAL("config_2", configName);
+        APSARA_TEST_EQUAL(1U, inputIndex);
+        APSARA_TEST_EQUAL("second", group.GetEvents()[0].Cast<LogEvent>().GetContent("content").to_string());
+    }
+    {
+        PipelineEventGroup group(make_shared<SourceBuffer>());
+        APSARA_TEST_FALSE(reader.Next(configName, inputIndex, group));
+        APSARA_TEST_TRUE(reader.GetErrorMsg().empty());
+    }
+}
+
+void EventGroupCaptureUnittest::TestConfigFilter() {
+    STRING_FLAG(process_queue_capture_configs) = "config_1,config_3";
+    EventGroupCapture::GetInstance()->Init();
+    EventGroupCapture::GetInstance()->Capture("config_1", 0, CreateLogGroup("first"));
+    EventGroupCapture::GetInstance()->Capture("config_2", 0, CreateLogGroup("second"));
+    EventGroupCapture::GetInstance()->Capture("config_3", 0, CreateLogGroup("third"));
+    EventGroupCapture::GetInstance()->Stop();
+
+    EventGroupCaptureReader reader;
+    APSARA_TEST_TRUE(reader.Open(mFilePath));
+    vector<string> configNames;
+    string configName;
+    size_t inputIndex = 0;
+    while (true) {
+        PipelineEventGroup group(make_shared<SourceBuffer>());
+        if (!reader.Next(configName, inputIndex, group)) {
+            break;
+        }
+        configNames.push_back(configName);
+    }
+    APSARA_TEST_EQUAL(vector<string>({"config_1", "config_3"}), configNames);
+}
+
+void EventGroupCaptureUnittest::TestMaxSize() {
+    INT64_FLAG(process_queue_capture_max_size_bytes) = 200;
+    EventGroupCapture::GetInstance()->Init();
+    for (int i = 0; i < 10; ++i) {
+        EventGroupCapture::GetInstance()->Capture("config", 0, CreateLogGroup("content"));
+    }
+    APSARA_TEST_FALSE(EventGroupCapture::GetInstance()->IsEnabled());
+    APSARA_TEST_TRUE(EventGroupCapture::GetInstance()->mFileSize <= 200U);
+    APSARA_TEST_TRUE(EventGroupCapture::GetInstance()->mCapturedCnt < 10U);
+}
+
+void EventGroupCaptureUnittest::TestTruncatedFile() {
+    EventGroupCapture::GetInstance()->Init();
+    EventGroupCapture::GetInstance()->Capture("config", 0, CreateLogGroup("content"));
+    EventGroupCapture::GetInstance()->Stop();
+    boost::filesystem::resize_file(mFilePath, boost::filesystem::file_size(mFilePath) - 1);
+
+    EventGroupCaptureReader reader;
+    APSARA_TEST_TRUE(reader.Open(mFilePath));
+    string configName;
+    size_t inputIndex = 0;
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    APSARA_TEST_FALSE(reader.Next(configName, inputIndex, group));
+    APSARA_TEST_FALSE(reader.GetErrorMsg().empty());
+
+    EventGroupCaptureReader invalidReader;
+    APSARA_TEST_FALSE(invalidReader.Open(mFilePath + ".not_exist"));
+}
+
+UNIT_TEST_CASE(EventGroupCaptureUnittest, TestCaptureAndRead)
+UNIT_TEST_CASE(EventGroupCaptureUnittest, TestConfigFilter)
+UNIT_TEST_CASE(EventGroupCaptureUnittest, TestMaxSize)
+UNIT_TEST_CASE(EventGroupCaptureUnittest, TestTruncatedFile)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
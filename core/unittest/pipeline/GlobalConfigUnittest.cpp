@@ -19,6 +19,7 @@
 
 #include "common/JsonUtil.h"
 #include "pipeline/GlobalConfig.h"
+#include "pipeline/queue/SenderQueueManager.h"
 #include "unittest/Unittest.h"
 
 using namespace std;
@@ -46,6 +47,7 @@ void GlobalConfigUnittest::OnSuccessfulInit() const {
     APSARA_TEST_EQUAL(GlobalConfig::TopicType::NONE, config->mTopicType);
     APSARA_TEST_EQUAL("", config->mTopicFormat);
     APSARA_TEST_EQUAL(1U, config->mPriority);
+    APSARA_TEST_EQUAL(1U, config->mSendWeight);
     APSARA_TEST_FALSE(config->mEnableTimestampNanosecond);
     APSARA_TEST_FALSE(config->mUsingOldContentTag);
 
@@ -55,6 +57,7 @@ void GlobalConfigUnittest::OnSuccessfulInit() const {
             "TopicType": "custom",
             "TopicFormat": "test_topic",
             "Priority": 1,
+            "SendWeight": 10,
             "EnableTimestampNanosecond": true,
             "UsingOldContentTag": true
         }
@@ -66,6 +69,7 @@ void GlobalConfigUnittest::OnSuccessfulInit() const {
     APSARA_TEST_EQUAL(GlobalConfig::TopicType::CUSTOM, config->mTopicType);
     APSARA_TEST_EQUAL("test_topic", config->mTopicFormat);
     APSARA_TEST_EQUAL(1U, config->mPriority);
+    APSARA_TEST_EQUAL(10U, config->mSendWeight);
     APSARA_TEST_TRUE(config->mEnableTimestampNanosecond);
     APSARA_TEST_TRUE(config->mUsingOldContentTag);
 
@@ -75,6 +79,7 @@ void GlobalConfigUnittest::OnSuccessfulInit() const {
             "TopicType": true,
             "TopicFormat": true,
             "Priority": "1",
+            "SendWeight": "10",
             "EnableTimestampNanosecond": "true",
             "UsingOldContentTag": "true"
         }
@@ -86,6 +91,7 @@ void GlobalConfigUnittest::OnSuccessfulInit() const {
     APSARA_TEST_EQUAL(GlobalConfig::TopicType::NONE, config->mTopicType);
     APSARA_TEST_EQUAL("", config->mTopicFormat);
     APSARA_TEST_EQUAL(1U, config->mPriority);
+    APSARA_TEST_EQUAL(1U, config->mSendWeight);
     APSARA_TEST_FALSE(config->mEnableTimestampNanosecond);
     APSARA_TEST_FALSE(config->mUsingOldContentTag);
 
@@ -194,6 +200,17 @@ void GlobalConfigUnittest::OnSuccessfulInit() const {
     APSARA_TEST_TRUE(config->Init(configJson, ctx, extendedParams));
     APSARA_TEST_EQUAL(2U, config->mPriority);
 
+    // SendWeight
+    configStr = R"(
+        {
+            "SendWeight": 1000
+        }
+    )";
+    APSARA_TEST_TRUE(ParseJsonTable(configStr, configJson, errorMsg));
+    config.reset(new GlobalConfig());
+    APSARA_TEST_TRUE(config->Init(configJson, ctx, extendedParams));
+    APSARA_TEST_EQUAL(SenderQueueManager::sMaxSendWeight, config->mSendWeight);
+
     // extendedParam
     configStr = R"(
         {
@@ -0,0 +1,462 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "common/Flags.h"
+#include "common/JsonUtil.h"
+#include "common/StringTools.h"
+#include "config/PipelineConfig.h"
+#include "file_server/reader/LogFileReader.h"
+#include "models/LatencyTrace.h"
+#include "monitor/LatencyTraceRecorder.h"
+#include "monitor/MetricTypes.h"
+#include "pipeline/Pipeline.h"
+#include "pipeline/plugin/PluginRegistry.h"
+#include "pipeline/queue/SenderQueueManager.h"
+#include "plugin/input/InputFeedbackInterfaceRegistry.h"
+#include "plugin/input/InputFile.h"
+
+DEFINE_FLAG_STRING(bench_formats, "comma separated log formats to run, among nginx, json, java and containerd", "all");
+DEFINE_FLAG_INT32(bench_lines, "number of lines generated for each format", 1000000);
+DEFINE_FLAG_INT32(bench_lines_per_sec,
+                  "rate at which lines are appended while the pipeline is running, 0 to generate the whole file "
+                  "before the pipeline starts",
+                  0);
+DEFINE_FLAG_STRING(bench_dir,
+                   "dir where log files are generated and kept, a temp dir is created and removed on exit if not set",
+                   "");
+
+DECLARE_FLAG_INT32(pipeline_latency_trace_sample_interval);
+
+using namespace std;
+
+namespace logtail {
+
+// Generates reproducible log lines of one format. Lines are numbered from 0 and the same seed is used in every run, so
+// that the files generated by different releases are identical.
+class LogGenerator {
+public:
+    explicit LogGenerator(const string& format) : mFormat(format) {}
+
+    // appends the lines of the next log to buf, returns the number of lines appended
+    size_t AppendLog(string& buf) {
+        uint64_t i = mLogCnt++;
+        uint32_t r = mRand();
+        if (mFormat == "nginx") {
+            AppendNginxLine(buf, i, r);
+            return 1;
+        }
+        if (mFormat == "json") {
+            buf += R"({"time":"2026-10-18T10:00:00.123Z","level":")";
+            buf += r % 10 == 0 ? "WARN" : "INFO";
+            buf += R"(","logger":"com.example.OrderService","thread":"worker-)" + ToString(r % 16)
+                + R"(","msg":"order )" + ToString(i) + R"( processed","latency_ms":)" + ToString(r % 1000) + "}\n";
+            return 1;
+        }
+        if (mFormat == "java") {
+            buf += "2026-10-18 10:00:00.123 ";
+            if (r % 10 != 0) {
+                buf += "INFO [worker-" + ToString(r % 16) + "] com.example.OrderService - order " + ToString(i)
+                    + " processed\n";
+                return 1;
+            }
+            buf += "ERROR [worker-" + ToString(r % 16) + "] com.example.OrderService - failed to process order "
+                + ToString(i) + "\n";
+            buf += "java.lang.IllegalStateException: inventory of item " + ToString(r % 100000) + " is locked\n";
+            buf += "\tat com.example.InventoryService.reserve(InventoryService.java:128)\n";
+            buf += "\tat com.example.OrderService.process(OrderService.java:64)\n";
+            buf += "\tat com.example.OrderWorker.run(OrderWorker.java:37)\n";
+            buf += "\tat java.base/java.lang.Thread.run(Thread.java:833)\n";
+            return 6;
+        }
+        // containerd
+        buf += "2026-10-18T10:00:00.123456789+08:00 ";
+        buf += r % 10 == 0 ? "stderr F " : "stdout F ";
+        AppendNginxLine(buf, i, r);
+        return 1;
+    }
+
+    static bool IsValidFormat(const string& format) {
+        return format == "nginx" || format == "json" || format == "java" || format == "containerd";
+    }
+
+private:
+    static void AppendNginxLine(string& buf, uint64_t i, uint32_t r) {
+        buf += "10.0." + ToString(r % 256) + "." + ToString((r >> 8) % 256)
+            + R"( - - [18/Oct/2026:10:00:00 +0800] "GET /api/v1/items/)" + ToString(i) + R"( HTTP/1.1" )"
+            + (r % 20 == 0 ? "500" : "200") + " " + ToString(r % 10000)
+            + R"( "-" "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0 Safari/537.36")"
+            + "\n";
+    }
+
+    string mFormat;
+    uint64_t mLogCnt = 0;
+    mt19937 mRand{0};
+};
+
+struct BenchmarkResult {
+    uint64_t mLines = 0;
+    uint64_t mBytes = 0;
+    uint64_t mEvents = 0;
+    double mSeconds = 0;
+    double mCpuSeconds = 0;
+    uint64_t mRssKB = 0;
+    uint64_t mMaxRssKB = 0;
+    Histogram mE2ELatencyUs{"e2e_latency_us"};
+};
+
+// Runs input_file -> native processors -> flusher_blackhole on a generated file. The file is read by a LogFileReader
+// the same way the file server does, and the sender queue is drained the same way the flusher runner does for non-http
+// sinks, all in the calling thread, so that results are not disturbed by thread scheduling.
+class PipelineBenchmark {
+public:
+    PipelineBenchmark(const string& dir, const string& format) : mDir(dir), mFormat(format) {}
+
+    bool Run(BenchmarkResult& res);
+
+private:
+    string GetProcessorsConfig() const;
+    void Generate(uint64_t lines, BenchmarkResult& res);
+    void ProcessBuffer(LogBuffer& logBuffer, BenchmarkResult& res);
+    void DrainSenderQueue(BenchmarkResult& res);
+
+    string mDir;
+    string mFormat;
+    string mFileName;
+    unique_ptr<Pipeline> mPipeline;
+    shared_ptr<LogFileReader> mReader;
+    LogGenerator mGenerator{mFormat};
+    ofstream mWriter;
+};
+
+string PipelineBenchmark::GetProcessorsConfig() const {
+    if (mFormat == "nginx") {
+        return R"json([
+            {
+                "Type": "processor_parse_regex_native",
+                "SourceKey": "content",
+                "Regex": "(\\S+) - (\\S+) \\[([^\\]]+)\\] \"(\\S+) (\\S+) (\\S+)\" (\\d+) (\\d+) \"([^\"]*)\" \"([^\"]*)\"",
+                "Keys": ["remote_addr", "remote_user", "time_local", "method", "url", "protocol", "status",
+                         "body_bytes_sent", "http_referer", "http_user_agent"]
+            }
+        ])json";
+    }
+    if (mFormat == "json") {
+        return R"json([
+            {
+                "Type": "processor_parse_json_native",
+                "SourceKey": "content"
+            }
+        ])json";
+    }
+    if (mFormat == "java") {
+        return R"json([
+            {
+                "Type": "processor_parse_regex_native",
+                "SourceKey": "content",
+                "Regex": "(\\S+ \\S+) (\\S+) \\[(\\S+)\\] (\\S+) - ([\\s\\S]*)",
+                "Keys": ["time", "level", "thread", "logger", "message"]
+            }
+        ])json";
+    }
+    // the cri format is parsed by regex, since the container log processor requires container discovery
+    return R"json([
+        {
+            "Type": "processor_parse_regex_native",
+            "SourceKey": "content",
+            "Regex": "(\\S+) (stdout|stderr) ([FP]) (.*)",
+            "Keys": ["_time_", "_source_", "_tag_", "message"]
+        },
+        {
+            "Type": "processor_parse_regex_native",
+            "SourceKey": "message",
+            "Regex": "(\\S+) - (\\S+) \\[([^\\]]+)\\] \"(\\S+) (\\S+) (\\S+)\" (\\d+) (\\d+) \"([^\"]*)\" \"([^\"]*)\"",
+            "Keys": ["remote_addr", "remote_user", "time_local", "method", "url", "protocol", "status",
+                     "body_bytes_sent", "http_referer", "http_user_agent"]
+        }
+    ])json";
+}
+
+void PipelineBenchmark::Generate(uint64_t lines, BenchmarkResult& res) {
+    string buf;
+    uint64_t cnt = 0;
+    while (cnt < lines) {
+        cnt += mGenerator.AppendLog(buf);
+    }
+    mWriter << buf;
+    mWriter.flush();
+    res.mLines += cnt;
+    res.mBytes += buf.size();
+}
+
+void PipelineBenchmark::ProcessBuffer(LogBuffer& logBuffer, BenchmarkResult& res) {
+    if (logBuffer.rawBuffer.empty()) {
+        return;
+    }
+    vector<PipelineEventGroup> groups;
+    groups.emplace_back(LogFileReader::GenerateEventGroup(mReader, &logBuffer));
+    mPipeline->Process(groups, 0);
+    for (const auto& group : groups) {
+        res.mEvents += group.GetEvents().size();
+    }
+    mPipeline->Send(std::move(groups));
+    DrainSenderQueue(res);
+}
+
+void PipelineBenchmark::DrainSenderQueue(BenchmarkResult& res) {
+    vector<SenderQueueItem*> items;
+    SenderQueueManager::GetInstance()->GetAvailableItems(items, -1);
+    for (auto item : items) {
+        if (item->mLatencyTrace) {
+            item->mLatencyTrace->Stamp(LatencyStage::SENDER_QUEUE_POP);
+            auto e2e = LatencyTrace::Clock::now() - item->mLatencyTrace->GetStamp(LatencyStage::READ);
+            res.mE2ELatencyUs.Add(static_cast<uint64_t>(chrono::duration_cast<chrono::microseconds>(e2e).count()));
+        }
+        item->mFlusher->RecordLatencyTrace(item);
+        SenderQueueManager::GetInstance()->RemoveItem(item->mFlusher->GetQueueKey(), item);
+    }
+}
+
+bool PipelineBenchmark::Run(BenchmarkResult& res) {
+    mFileName = mFormat + ".log";
+    string configStr = R"(
+        {
+            "inputs": [
+                {
+                    "Type": "input_file",
+                    "FilePaths": [")"
+        + mDir + "/" + mFileName + R"("])"
+        + (mFormat == "java" ? R"(,
+                    "Multiline": {
+                        "StartPattern": "\\d{4}-\\d{2}-\\d{2} .*"
+                    })"
+                             : "")
+        + R"(
+                }
+            ],
+            "processors": )"
+        + GetProcessorsConfig() + R"(,
+            "flushers": [
+                {
+                    "Type": "flusher_blackhole"
+                }
+            ]
+        }
+    )";
+    string errorMsg;
+    auto configJson = make_unique<Json::Value>();
+    if (!ParseJsonTable(configStr, *configJson, errorMsg)) {
+        printf("invalid pipeline config: %s\n", errorMsg.c_str());
+        return false;
+    }
+    PipelineConfig config("benchmark_" + mFormat, std::move(configJson));
+    mPipeline = make_unique<Pipeline>();
+    if (!config.Parse() || !mPipeline->Init(std::move(config))) {
+        printf("failed to init pipeline for format %s\n", mFormat.c_str());
+        return false;
+    }
+
+    mWriter.open(mDir + "/" + mFileName, ios::out | ios::trunc | ios::binary);
+    uint64_t totalLines = INT32_FLAG(bench_lines);
+    int32_t rate = INT32_FLAG(bench_lines_per_sec);
+    if (rate <= 0) {
+        Generate(totalLines, res);
+    }
+
+    const auto* input = static_cast<const InputFile*>(mPipeline->GetInputs()[0]->GetPlugin());
+    mReader = make_shared<LogFileReader>(mDir,
+                                         mFileName,
+                                         DevInode(),
+                                         make_pair(&input->mFileReader, &mPipeline->GetContext()),
+                                         make_pair(&input->mMultiline, &mPipeline->GetContext()));
+    mReader->UpdateReaderManual();
+    mReader->InitReader(true, LogFileReader::BACKWARD_TO_BEGINNING);
+
+    rusage usageBefore{};
+    getrusage(RUSAGE_SELF, &usageBefore);
+    auto start = chrono::steady_clock::now();
+
+    atomic_bool generated(rate <= 0);
+    thread generator;
+    if (!generated) {
+        generator = thread([&]() {
+            auto begin = chrono::steady_clock::now();
+            while (res.mLines < totalLines) {
+                this_thread::sleep_for(chrono::milliseconds(10));
+                auto elapsedMs = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - begin);
+                uint64_t expected = min<uint64_t>(totalLines, elapsedMs.count() * rate / 1000);
+                if (expected > res.mLines) {
+                    Generate(expected - res.mLines, res);
+                }
+            }
+            generated = true;
+        });
+    }
+    while (true) {
+        // checked before reading, so that lines written before the generator finishes are always read
+        bool done = generated;
+        mReader->CheckFileSignatureAndOffset(true);
+        bool hasMoreData = true;
+        bool hasRead = false;
+        while (hasMoreData) {
+            LogBuffer logBuffer;
+            hasMoreData = mReader->ReadLog(logBuffer, nullptr);
+            hasRead |= !logBuffer.rawBuffer.empty();
+            ProcessBuffer(logBuffer, res);
+        }
+        if (done) {
+            break;
+        }
+        if (!hasRead) {
+            this_thread::sleep_for(chrono::milliseconds(10));
+        }
+    }
+    if (generator.joinable()) {
+        generator.join();
+    }
+    // the last multiline log is kept by the reader until flush timeout
+    {
+        LogBuffer logBuffer;
+        auto event = mReader->CreateFlushTimeoutEvent();
+        mReader->ReadLog(logBuffer, event.get());
+        ProcessBuffer(logBuffer, res);
+    }
+    mPipeline->FlushBatch();
+    DrainSenderQueue(res);
+
+    res.mSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    rusage usageAfter{};
+    getrusage(RUSAGE_SELF, &usageAfter);
+    auto toSeconds = [](const timeval& t) { return t.tv_sec + t.tv_usec / 1e6; };
+    res.mCpuSeconds = toSeconds(usageAfter.ru_utime) + toSeconds(usageAfter.ru_stime) - toSeconds(usageBefore.ru_utime)
+        - toSeconds(usageBefore.ru_stime);
+    res.mMaxRssKB = usageAfter.ru_maxrss;
+    ifstream statm("/proc/self/statm");
+    uint64_t pages = 0;
+    if (statm >> pages >> pages) {
+        res.mRssKB = pages * sysconf(_SC_PAGESIZE) / 1024;
+    }
+
+    mReader.reset();
+    mPipeline.reset();
+    mWriter.close();
+    return true;
+}
+
+void PrintResult(const string& format, const BenchmarkResult& res) {
+    double mb = res.mBytes / 1024.0 / 1024.0;
+    double cpuPerGB = mb > 0 ? res.mCpuSeconds / (mb / 1024.0) : 0;
+    printf("%-10s lines: %lu, events: %lu, size: %.1fMB, time: %.3fs\n",
+           format.c_str(),
+           res.mLines,
+           res.mEvents,
+           mb,
+           res.mSeconds);
+    printf("%-10s %.0f lines/s, %.2f MB/s, %.2f cpu seconds/GB, rss: %luKB, max rss: %luKB\n",
+           format.c_str(),
+           res.mLines / res.mSeconds,
+           mb / res.mSeconds,
+           cpuPerGB,
+           res.mRssKB,
+           res.mMaxRssKB);
+    printf("%-10s e2e latency(us) p50: %lu, p90: %lu, p99: %lu, max: %lu, traced groups: %lu\n",
+           format.c_str(),
+           res.mE2ELatencyUs.GetQuantile(0.5),
+           res.mE2ELatencyUs.GetQuantile(0.9),
+           res.mE2ELatencyUs.GetQuantile(0.99),
+           res.mE2ELatencyUs.GetQuantile(1),
+           res.mE2ELatencyUs.GetCount());
+
+    // one line per format for comparing releases by script
+    Json::Value summary;
+    summary["format"] = format;
+    summary["lines_per_sec"] = res.mLines / res.mSeconds;
+    summary["mb_per_sec"] = mb / res.mSeconds;
+    summary["cpu_seconds_per_gb"] = cpuPerGB;
+    summary["rss_kb"] = Json::UInt64(res.mRssKB);
+    summary["max_rss_kb"] = Json::UInt64(res.mMaxRssKB);
+    summary["e2e_latency_us_p50"] = Json::UInt64(res.mE2ELatencyUs.GetQuantile(0.5));
+    summary["e2e_latency_us_p99"] = Json::UInt64(res.mE2ELatencyUs.GetQuantile(0.99));
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    printf("%s\n", Json::writeString(builder, summary).c_str());
+}
+
+} // namespace logtail
+
+using namespace logtail;
+
+int main(int argc, char* argv[]) {
+    google::ParseCommandLineFlags(&argc, &argv, true);
+    if (INT32_FLAG(pipeline_latency_trace_sample_interval) <= 0) {
+        INT32_FLAG(pipeline_latency_trace_sample_interval) = 1;
+    }
+    PluginRegistry::GetInstance()->LoadPlugins();
+    InputFeedbackInterfaceRegistry::GetInstance()->LoadFeedbackInterfaces();
+
+    vector<string> formats;
+    if (STRING_FLAG(bench_formats) == "all") {
+        formats = {"nginx", "json", "java", "containerd"};
+    } else {
+        formats = SplitString(STRING_FLAG(bench_formats), ",");
+    }
+
+    string dir = STRING_FLAG(bench_dir);
+    bool isTempDir = dir.empty();
+    if (isTempDir) {
+        char tmpl[] = "/tmp/pipeline_benchmark_XXXXXX";
+        if (mkdtemp(tmpl) == nullptr) {
+            printf("failed to create temp dir\n");
+            return 1;
+        }
+        dir = tmpl;
+    }
+
+    int ret = 0;
+    for (const auto& format : formats) {
+        if (!LogGenerator::IsValidFormat(format)) {
+            printf("unknown format %s\n", format.c_str());
+            ret = 1;
+            continue;
+        }
+        BenchmarkResult res;
+        PipelineBenchmark benchmark(dir, format);
+        if (!benchmark.Run(res)) {
+            ret = 1;
+            continue;
+        }
+        PrintResult(format, res);
+    }
+
+    if (isTempDir) {
+        boost::system::error_code ec;
+        boost::filesystem::remove_all(dir, ec);
+    }
+    PluginRegistry::GetInstance()->UnloadPlugins();
+    return ret;
+}
@@ -12,8 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "common/JsonUtil.h"
+#include "config/PipelineConfig.h"
 #include "pipeline/Pipeline.h"
 #include "pipeline/PipelineManager.h"
+#include "pipeline/plugin/PluginRegistry.h"
 #include "unittest/Unittest.h"
 
 using namespace std;
@@ -22,7 +25,21 @@ namespace logtail {
 
 class PipelineManagerUnittest : public testing::Test {
 public:
+    static void SetUpTestCase() { PluginRegistry::GetInstance()->LoadPlugins(); }
+
     void TestPipelineManagement() const;
+    void TestCanBuildPipelineInParallel() const;
+
+private:
+    bool CanBuildInParallel(const string& configStr) const {
+        unique_ptr<Json::Value> configJson(new Json::Value());
+        string errorMsg;
+        if (!ParseJsonTable(configStr, *configJson, errorMsg)) {
+            return false;
+        }
+        PipelineConfig config("test_config", std::move(configJson));
+        return config.Parse() && PipelineManager::CanBuildPipelineInParallel(config);
+    }
 };
 
 void PipelineManagerUnittest::TestPipelineManagement() const {
@@ -34,7 +51,34 @@ void PipelineManagerUnittest::TestPipelineManagement() const {
     APSARA_TEST_EQUAL(nullptr, PipelineManager::GetInstance()->FindConfigByName("test3"));
 }
 
+void PipelineManagerUnittest::TestCanBuildPipelineInParallel() const {
+    APSARA_TEST_TRUE(CanBuildInParallel(R"({
+        "inputs": [{"Type": "input_file", "FilePaths": ["/home/test.log"]}],
+        "flushers": [{"Type": "flusher_sls", "Project": "p", "Logstore": "l", "Region": "r", "Endpoint": "e"}]
+    })"));
+    APSARA_TEST_TRUE(CanBuildInParallel(R"({
+        "inputs": [{"Type": "input_file", "FilePaths": ["/home/test.log"], "EnableContainerDiscovery": false}],
+        "flushers": [{"Type": "flusher_sls", "Project": "p", "Logstore": "l", "Region": "r", "Endpoint": "e"}]
+    })"));
+    // Go pipelines are loaded one at a time
+    APSARA_TEST_FALSE(CanBuildInParallel(R"({
+        "inputs": [{"Type": "input_file", "FilePaths": ["/home/test.log"]}],
+        "processors": [{"Type": "processor_regex"}],
+        "flushers": [{"Type": "flusher_sls", "Project": "p", "Logstore": "l", "Region": "r", "Endpoint": "e"}]
+    })"));
+    // container discovery generates a Go pipeline
+    APSARA_TEST_FALSE(CanBuildInParallel(R"({
+        "inputs": [{"Type": "input_file", "FilePaths": ["/home/test.log"], "EnableContainerDiscovery": true}],
+        "flushers": [{"Type": "flusher_sls", "Project": "p", "Logstore": "l", "Region": "r", "Endpoint": "e"}]
+    })"));
+    APSARA_TEST_FALSE(CanBuildInParallel(R"({
+        "inputs": [{"Type": "input_container_stdio"}],
+        "flushers": [{"Type": "flusher_sls", "Project": "p", "Logstore": "l", "Region": "r", "Endpoint": "e"}]
+    })"));
+}
+
 UNIT_TEST_CASE(PipelineManagerUnittest, TestPipelineManagement)
+UNIT_TEST_CASE(PipelineManagerUnittest, TestCanBuildPipelineInParallel)
 
 } // namespace logtail
 
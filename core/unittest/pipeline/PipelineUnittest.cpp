@@ -51,6 +51,7 @@ public:
     void TestFlushBatch() const;
     void TestInProcessingCount() const;
     void TestWaitAllItemsInProcessFinished() const;
+    void TestUpdateProcessors() const;
 
 protected:
     static void SetUpTestCase() {
@@ -64,6 +65,7 @@ protected:
 
     void TearDown() override {
         TimeoutFlushManager::GetInstance()->mTimeoutRecords.clear();
+        TimeoutFlushManager::GetInstance()->mTimeoutWheel.Clear();
         QueueKeyManager::GetInstance()->Clear();
         ProcessQueueManager::GetInstance()->Clear();
     }
@@ -509,7 +511,7 @@ void PipelineUnittest::OnInitVariousTopology() const {
     pipeline.reset(new Pipeline());
     APSARA_TEST_TRUE(pipeline->Init(std::move(*config)));
     APSARA_TEST_EQUAL(1U, pipeline->mInputs.size());
-    APSARA_TEST_EQUAL(1U, pipeline->mProcessorLine.size());
+    APSARA_TEST_EQUAL(1U, pipeline->mProcessorLine->size());
     APSARA_TEST_EQUAL(1U, pipeline->GetFlushers().size());
     APSARA_TEST_TRUE(pipeline->mGoPipelineWithInput.isNull());
     APSARA_TEST_TRUE(pipeline->mGoPipelineWithoutInput.isNull());
@@ -649,7 +651,7 @@ void PipelineUnittest::OnInitVariousTopology() const {
     pipeline.reset(new Pipeline());
     APSARA_TEST_TRUE(pipeline->Init(std::move(*config)));
     APSARA_TEST_EQUAL(1U, pipeline->mInputs.size());
-    APSARA_TEST_EQUAL(0U, pipeline->mProcessorLine.size());
+    APSARA_TEST_EQUAL(0U, pipeline->mProcessorLine->size());
     APSARA_TEST_EQUAL(1U, pipeline->GetFlushers().size());
     APSARA_TEST_TRUE(pipeline->mGoPipelineWithInput.isNull());
     APSARA_TEST_EQUAL(goPipelineWithoutInput.toStyledString(), pipeline->mGoPipelineWithoutInput.toStyledString());
@@ -722,7 +724,7 @@ void PipelineUnittest::OnInitVariousTopology() const {
     pipeline.reset(new Pipeline());
     APSARA_TEST_TRUE(pipeline->Init(std::move(*config)));
     APSARA_TEST_EQUAL(0U, pipeline->mInputs.size());
-    APSARA_TEST_EQUAL(0U, pipeline->mProcessorLine.size());
+    APSARA_TEST_EQUAL(0U, pipeline->mProcessorLine->size());
     APSARA_TEST_EQUAL(1U, pipeline->GetFlushers().size());
     APSARA_TEST_EQUAL(goPipelineWithInput.toStyledString(), pipeline->mGoPipelineWithInput.toStyledString());
     APSARA_TEST_TRUE(pipeline->mGoPipelineWithoutInput.isNull());
@@ -835,7 +837,7 @@ void PipelineUnittest::OnInitVariousTopology() const {
     pipeline.reset(new Pipeline());
     APSARA_TEST_TRUE(pipeline->Init(std::move(*config)));
     APSARA_TEST_EQUAL(1U, pipeline->mInputs.size());
-    APSARA_TEST_EQUAL(1U, pipeline->mProcessorLine.size());
+    APSARA_TEST_EQUAL(1U, pipeline->mProcessorLine->size());
     APSARA_TEST_EQUAL(1U, pipeline->GetFlushers().size());
     APSARA_TEST_TRUE(pipeline->mGoPipelineWithInput.isNull());
     APSARA_TEST_EQUAL(goPipelineWithoutInput.toStyledString(), pipeline->mGoPipelineWithoutInput.toStyledString());
@@ -948,7 +950,7 @@ void PipelineUnittest::OnInitVariousTopology() const {
     pipeline.reset(new Pipeline());
     APSARA_TEST_TRUE(pipeline->Init(std::move(*config)));
     APSARA_TEST_EQUAL(1U, pipeline->mInputs.size());
-    APSARA_TEST_EQUAL(0U, pipeline->mProcessorLine.size());
+    APSARA_TEST_EQUAL(0U, pipeline->mProcessorLine->size());
     APSARA_TEST_EQUAL(1U, pipeline->GetFlushers().size());
     APSARA_TEST_TRUE(pipeline->mGoPipelineWithInput.isNull());
     APSARA_TEST_TRUE(pipeline->mGoPipelineWithoutInput.isNull());
@@ -1009,7 +1011,7 @@ void PipelineUnittest::OnInitVariousTopology() const {
     pipeline.reset(new Pipeline());
     APSARA_TEST_TRUE(pipeline->Init(std::move(*config)));
     APSARA_TEST_EQUAL(0U, pipeline->mInputs.size());
-    APSARA_TEST_EQUAL(0U, pipeline->mProcessorLine.size());
+    APSARA_TEST_EQUAL(0U, pipeline->mProcessorLine->size());
     APSARA_TEST_EQUAL(1U, pipeline->GetFlushers().size());
     APSARA_TEST_EQUAL(goPipelineWithInput.toStyledString(), pipeline->mGoPipelineWithInput.toStyledString());
     APSARA_TEST_TRUE(pipeline->mGoPipelineWithoutInput.isNull());
@@ -1101,7 +1103,7 @@ void PipelineUnittest::OnInitVariousTopology() const {
     pipeline.reset(new Pipeline());
     APSARA_TEST_TRUE(pipeline->Init(std::move(*config)));
     APSARA_TEST_EQUAL(1U, pipeline->mInputs.size());
-    APSARA_TEST_EQUAL(1U, pipeline->mProcessorLine.size());
+    APSARA_TEST_EQUAL(1U, pipeline->mProcessorLine->size());
     APSARA_TEST_EQUAL(0U, pipeline->GetFlushers().size());
     APSARA_TEST_TRUE(pipeline->mGoPipelineWithInput.isNull());
     APSARA_TEST_EQUAL(goPipelineWithoutInput.toStyledString(), pipeline->mGoPipelineWithoutInput.toStyledString());
@@ -1227,7 +1229,7 @@ void PipelineUnittest::OnInitVariousTopology() const {
     pipeline.reset(new Pipeline());
     APSARA_TEST_TRUE(pipeline->Init(std::move(*config)));
     APSARA_TEST_EQUAL(1U, pipeline->mInputs.size());
-    APSARA_TEST_EQUAL(0U, pipeline->mProcessorLine.size());
+    APSARA_TEST_EQUAL(0U, pipeline->mProcessorLine->size());
     APSARA_TEST_EQUAL(0U, pipeline->GetFlushers().size());
     APSARA_TEST_TRUE(pipeline->mGoPipelineWithInput.isNull());
     APSARA_TEST_EQUAL(goPipelineWithoutInput.toStyledString(), pipeline->mGoPipelineWithoutInput.toStyledString());
@@ -1293,7 +1295,7 @@ void PipelineUnittest::OnInitVariousTopology() const {
     pipeline.reset(new Pipeline());
     APSARA_TEST_TRUE(pipeline->Init(std::move(*config)));
     APSARA_TEST_EQUAL(0U, pipeline->mInputs.size());
-    APSARA_TEST_EQUAL(0U, pipeline->mProcessorLine.size());
+    APSARA_TEST_EQUAL(0U, pipeline->mProcessorLine->size());
     APSARA_TEST_EQUAL(0U, pipeline->GetFlushers().size());
     APSARA_TEST_EQUAL(goPipelineWithInput.toStyledString(), pipeline->mGoPipelineWithInput.toStyledString());
     APSARA_TEST_TRUE(pipeline->mGoPipelineWithoutInput.isNull());
@@ -1394,7 +1396,7 @@ void PipelineUnittest::OnInitVariousTopology() const {
     pipeline.reset(new Pipeline());
     APSARA_TEST_TRUE(pipeline->Init(std::move(*config)));
     APSARA_TEST_EQUAL(1U, pipeline->mInputs.size());
-    APSARA_TEST_EQUAL(1U, pipeline->mProcessorLine.size());
+    APSARA_TEST_EQUAL(1U, pipeline->mProcessorLine->size());
     APSARA_TEST_EQUAL(0U, pipeline->GetFlushers().size());
     APSARA_TEST_TRUE(pipeline->mGoPipelineWithInput.isNull());
     APSARA_TEST_EQUAL(goPipelineWithoutInput.toStyledString(), pipeline->mGoPipelineWithoutInput.toStyledString());
@@ -1515,7 +1517,7 @@ void PipelineUnittest::OnInitVariousTopology() const {
     pipeline.reset(new Pipeline());
     APSARA_TEST_TRUE(pipeline->Init(std::move(*config)));
     APSARA_TEST_EQUAL(1U, pipeline->mInputs.size());
-    APSARA_TEST_EQUAL(0U, pipeline->mProcessorLine.size());
+    APSARA_TEST_EQUAL(0U, pipeline->mProcessorLine->size());
     APSARA_TEST_EQUAL(0U, pipeline->GetFlushers().size());
     APSARA_TEST_TRUE(pipeline->mGoPipelineWithInput.isNull());
     APSARA_TEST_EQUAL(goPipelineWithoutInput.toStyledString(), pipeline->mGoPipelineWithoutInput.toStyledString());
@@ -1570,7 +1572,7 @@ void PipelineUnittest::OnInitVariousTopology() const {
     pipeline.reset(new Pipeline());
     APSARA_TEST_TRUE(pipeline->Init(std::move(*config)));
     APSARA_TEST_EQUAL(0U, pipeline->mInputs.size());
-    APSARA_TEST_EQUAL(0U, pipeline->mProcessorLine.size());
+    APSARA_TEST_EQUAL(0U, pipeline->mProcessorLine->size());
     APSARA_TEST_EQUAL(0U, pipeline->GetFlushers().size());
     APSARA_TEST_EQUAL(goPipelineWithInput.toStyledString(), pipeline->mGoPipelineWithInput.toStyledString());
     APSARA_TEST_TRUE(pipeline->mGoPipelineWithoutInput.isNull());
@@ -1671,7 +1673,7 @@ void PipelineUnittest::OnInitVariousTopology() const {
     pipeline.reset(new Pipeline());
     APSARA_TEST_TRUE(pipeline->Init(std::move(*config)));
     APSARA_TEST_EQUAL(1U, pipeline->mInputs.size());
-    APSARA_TEST_EQUAL(1U, pipeline->mProcessorLine.size());
+    APSARA_TEST_EQUAL(1U, pipeline->mProcessorLine->size());
     APSARA_TEST_EQUAL(1U, pipeline->GetFlushers().size());
     APSARA_TEST_TRUE(pipeline->mGoPipelineWithInput.isNull());
     APSARA_TEST_EQUAL(goPipelineWithoutInput.toStyledString(), pipeline->mGoPipelineWithoutInput.toStyledString());
@@ -1827,7 +1829,7 @@ void PipelineUnittest::OnInitVariousTopology() const {
     pipeline.reset(new Pipeline());
     APSARA_TEST_TRUE(pipeline->Init(std::move(*config)));
     APSARA_TEST_EQUAL(1U, pipeline->mInputs.size());
-    APSARA_TEST_EQUAL(0U, pipeline->mProcessorLine.size());
+    APSARA_TEST_EQUAL(0U, pipeline->mProcessorLine->size());
     APSARA_TEST_EQUAL(1U, pipeline->GetFlushers().size());
     APSARA_TEST_TRUE(pipeline->mGoPipelineWithInput.isNull());
     APSARA_TEST_EQUAL(goPipelineWithoutInput.toStyledString(), pipeline->mGoPipelineWithoutInput.toStyledString());
@@ -1907,7 +1909,7 @@ void PipelineUnittest::OnInitVariousTopology() const {
     pipeline.reset(new Pipeline());
     APSARA_TEST_TRUE(pipeline->Init(std::move(*config)));
     APSARA_TEST_EQUAL(0U, pipeline->mInputs.size());
-    APSARA_TEST_EQUAL(0U, pipeline->mProcessorLine.size());
+    APSARA_TEST_EQUAL(0U, pipeline->mProcessorLine->size());
     APSARA_TEST_EQUAL(1U, pipeline->GetFlushers().size());
     APSARA_TEST_EQUAL(goPipelineWithInput.toStyledString(), pipeline->mGoPipelineWithInput.toStyledString());
     APSARA_TEST_TRUE(pipeline->mGoPipelineWithoutInput.isNull());
@@ -2030,7 +2032,7 @@ void PipelineUnittest::OnInitVariousTopology() const {
     pipeline.reset(new Pipeline());
     APSARA_TEST_TRUE(pipeline->Init(std::move(*config)));
     APSARA_TEST_EQUAL(1U, pipeline->mInputs.size());
-    APSARA_TEST_EQUAL(1U, pipeline->mProcessorLine.size());
+    APSARA_TEST_EQUAL(1U, pipeline->mProcessorLine->size());
     APSARA_TEST_EQUAL(1U, pipeline->GetFlushers().size());
     APSARA_TEST_TRUE(pipeline->mGoPipelineWithInput.isNull());
     APSARA_TEST_EQUAL(goPipelineWithoutInput.toStyledString(), pipeline->mGoPipelineWithoutInput.toStyledString());
@@ -2181,7 +2183,7 @@ void PipelineUnittest::OnInitVariousTopology() const {
     pipeline.reset(new Pipeline());
     APSARA_TEST_TRUE(pipeline->Init(std::move(*config)));
     APSARA_TEST_EQUAL(1U, pipeline->mInputs.size());
-    APSARA_TEST_EQUAL(0U, pipeline->mProcessorLine.size());
+    APSARA_TEST_EQUAL(0U, pipeline->mProcessorLine->size());
     APSARA_TEST_EQUAL(1U, pipeline->GetFlushers().size());
     APSARA_TEST_TRUE(pipeline->mGoPipelineWithInput.isNull());
     APSARA_TEST_EQUAL(goPipelineWithoutInput.toStyledString(), pipeline->mGoPipelineWithoutInput.toStyledString());
@@ -2250,7 +2252,7 @@ void PipelineUnittest::OnInitVariousTopology() const {
     pipeline.reset(new Pipeline());
     APSARA_TEST_TRUE(pipeline->Init(std::move(*config)));
     APSARA_TEST_EQUAL(0U, pipeline->mInputs.size());
-    APSARA_TEST_EQUAL(0U, pipeline->mProcessorLine.size());
+    APSARA_TEST_EQUAL(0U, pipeline->mProcessorLine->size());
     APSARA_TEST_EQUAL(1U, pipeline->GetFlushers().size());
     APSARA_TEST_EQUAL(goPipelineWithInput.toStyledString(), pipeline->mGoPipelineWithInput.toStyledString());
     APSARA_TEST_TRUE(pipeline->mGoPipelineWithoutInput.isNull());
@@ -2700,7 +2702,7 @@ void PipelineUnittest::TestProcess() const {
     auto processor
         = PluginRegistry::GetInstance()->CreateProcessor(ProcessorMock::sName, pipeline.GenNextPluginMeta(false));
     processor->Init(Json::Value(), ctx);
-    pipeline.mProcessorLine.emplace_back(std::move(processor));
+    pipeline.mProcessorLine->emplace_back(std::move(processor));
 
     WriteMetrics::GetInstance()->PrepareMetricsRecordRef(pipeline.mMetricsRecordRef, MetricCategory::METRIC_CATEGORY_UNKNOWN, {});
     pipeline.mProcessorsInEventsTotal
@@ -2719,7 +2721,7 @@ void PipelineUnittest::TestProcess() const {
     pipeline.Process(groups, 0);
     APSARA_TEST_EQUAL(
         1U, static_cast<const ProcessorInnerMock*>(pipeline.mInputs[0]->GetInnerProcessors()[0]->mPlugin.get())->mCnt);
-    APSARA_TEST_EQUAL(1U, static_cast<const ProcessorMock*>(pipeline.mProcessorLine[0]->mPlugin.get())->mCnt);
+    APSARA_TEST_EQUAL(1U, static_cast<const ProcessorMock*>((*pipeline.mProcessorLine)[0]->mPlugin.get())->mCnt);
     APSARA_TEST_EQUAL(1U, pipeline.mProcessorsInEventsTotal->GetValue());
     APSARA_TEST_EQUAL(1U, pipeline.mProcessorsInGroupsTotal->GetValue());
     APSARA_TEST_EQUAL(size, pipeline.mProcessorsInSizeBytes->GetValue());
@@ -2920,6 +2922,77 @@ void PipelineUnittest::TestWaitAllItemsInProcessFinished() const {
     APSARA_TEST_EQUAL(std::future_status::ready, future.wait_for(std::chrono::seconds(0)));
 }
 
+void PipelineUnittest::TestUpdateProcessors() const {
+    const string configTemplate = R"(
+        {
+            "inputs": [
+                {
+                    "Type": "input_file",
+                    "FilePaths": [
+                        "/home/test.log"
+                    ]
+                }
+            ],
+            "processors": [
+                {
+                    "Type": "processor_parse_regex_native",
+                    "SourceKey": "content",
+                    "Regex": "REGEX",
+                    "Keys": ["key"]
+                }
+            ],
+            "flushers": [
+                {
+                    "Type": "flusher_sls",
+                    "Project": "test_project",
+                    "Logstore": "LOGSTORE",
+                    "Region": "test_region",
+                    "Endpoint": "test_endpoint"
+                }
+            ]
+        }
+    )";
+    auto generateConfig = [&](const string& regex, const string& logstore) {
+        string configStr = configTemplate, errorMsg;
+        configStr.replace(configStr.find("REGEX"), 5, regex);
+        configStr.replace(configStr.find("LOGSTORE"), 8, logstore);
+        unique_ptr<Json::Value> configJson(new Json::Value());
+        APSARA_TEST_TRUE(ParseJsonTable(configStr, *configJson, errorMsg));
+        unique_ptr<PipelineConfig> config(new PipelineConfig(configName, std::move(configJson)));
+        APSARA_TEST_TRUE(config->Parse());
+        return config;
+    };
+
+    auto pipeline = make_shared<Pipeline>();
+    APSARA_TEST_TRUE(pipeline->Init(std::move(*generateConfig("(.*)", "test_logstore"))));
+    const auto* flusher = pipeline->GetFlushers()[0].get();
+    auto oldLine = pipeline->GetProcessorLine();
+    APSARA_TEST_EQUAL(1U, oldLine->size());
+
+    // flusher changed, rebuild is needed
+    APSARA_TEST_FALSE(pipeline->CanUpdateProcessorsInPlace(*generateConfig("(.*)", "test_logstore_2")));
+
+    // processor param changed
+    auto config = generateConfig("(\\\\d+)", "test_logstore");
+    APSARA_TEST_TRUE(pipeline->CanUpdateProcessorsInPlace(*config));
+    APSARA_TEST_TRUE(pipeline->UpdateProcessors(std::move(*config)));
+    APSARA_TEST_EQUAL(1U, pipeline->mProcessorLine->size());
+    APSARA_TEST_NOT_EQUAL(oldLine.get(), pipeline->mProcessorLine.get());
+    APSARA_TEST_EQUAL(flusher, pipeline->GetFlushers()[0].get());
+    APSARA_TEST_EQUAL("(\\d+)", pipeline->GetConfig()["processors"][0]["Regex"].asString());
+    // the old line is still valid for the processing in progress
+    APSARA_TEST_EQUAL(1U, oldLine->size());
+    APSARA_TEST_EQUAL(1U, pipeline->GetPluginStatistics().at("processors").at("processor_parse_regex_native"));
+
+    // processor init failed, current processors are kept
+    auto currentLine = pipeline->GetProcessorLine();
+    config = generateConfig("(", "test_logstore");
+    APSARA_TEST_TRUE(pipeline->CanUpdateProcessorsInPlace(*config));
+    APSARA_TEST_FALSE(pipeline->UpdateProcessors(std::move(*config)));
+    APSARA_TEST_EQUAL(currentLine.get(), pipeline->mProcessorLine.get());
+    APSARA_TEST_EQUAL("(\\d+)", pipeline->GetConfig()["processors"][0]["Regex"].asString());
+}
+
 UNIT_TEST_CASE(PipelineUnittest, OnSuccessfulInit)
 UNIT_TEST_CASE(PipelineUnittest, OnFailedInit)
 UNIT_TEST_CASE(PipelineUnittest, TestProcessQueue)
@@ -2931,6 +3004,7 @@ UNIT_TEST_CASE(PipelineUnittest, TestSend)
 UNIT_TEST_CASE(PipelineUnittest, TestFlushBatch)
 UNIT_TEST_CASE(PipelineUnittest, TestInProcessingCount)
 UNIT_TEST_CASE(PipelineUnittest, TestWaitAllItemsInProcessFinished)
+UNIT_TEST_CASE(PipelineUnittest, TestUpdateProcessors)
 
 } // namespace logtail
 
@@ -0,0 +1,112 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+
+#include "pipeline/limiter/RateLimiter.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class RateLimiterUnittest : public testing::Test {
+public:
+    void TestUnlimited() const;
+    void TestBurst() const;
+    void TestRefill() const;
+    void TestHighRate() const;
+
+private:
+    // manual clock, advanced explicitly by tests
+    RateLimiter::Clock ManualClock() const {
+        return [this]() { return mNow; };
+    }
+
+    mutable chrono::steady_clock::time_point mNow = chrono::steady_clock::time_point(chrono::seconds(1));
+};
+
+void RateLimiterUnittest::TestUnlimited() const {
+    RateLimiter limiter(0);
+    for (int i = 0; i < 100; ++i) {
+        APSARA_TEST_TRUE(limiter.IsValidToPop());
+        limiter.PostPop(1024 * 1024);
+    }
+}
+
+void RateLimiterUnittest::TestBurst() const {
+    RateLimiter limiter(100, 300);
+    APSARA_TEST_EQUAL(300.0, limiter.mTokens);
+    for (int i = 0; i < 3; ++i) {
+        APSARA_TEST_TRUE(limiter.IsValidToPop());
+        limiter.PostPop(110);
+    }
+    APSARA_TEST_FALSE(limiter.IsValidToPop());
+
+    // item larger than burst is allowed, and the debt should be paid back before next pop
+    limiter.SetMaxRate(100, 50);
+    APSARA_TEST_TRUE(limiter.IsValidToPop());
+    limiter.PostPop(1000);
+    APSARA_TEST_FALSE(limiter.IsValidToPop());
+}
+
+void RateLimiterUnittest::TestRefill() const {
+    RateLimiter limiter(1000, 0, ManualClock());
+    APSARA_TEST_TRUE(limiter.IsValidToPop());
+    limiter.PostPop(1100);
+    APSARA_TEST_FALSE(limiter.IsValidToPop());
+    APSARA_TEST_EQUAL(-100.0, limiter.mTokens);
+    mNow += chrono::milliseconds(100);
+    APSARA_TEST_FALSE(limiter.IsValidToPop());
+    APSARA_TEST_EQUAL(0.0, limiter.mTokens);
+    mNow += chrono::milliseconds(200);
+    APSARA_TEST_TRUE(limiter.IsValidToPop());
+    APSARA_TEST_EQUAL(200.0, limiter.mTokens);
+
+    // tokens should never exceed burst
+    mNow += chrono::milliseconds(1200);
+    APSARA_TEST_TRUE(limiter.IsValidToPop());
+    APSARA_TEST_EQUAL(1000.0, limiter.mTokens);
+
+    // clock going backwards is ignored
+    mNow -= chrono::seconds(1);
+    limiter.PostPop(500);
+    APSARA_TEST_TRUE(limiter.IsValidToPop());
+    APSARA_TEST_EQUAL(500.0, limiter.mTokens);
+}
+
+void RateLimiterUnittest::TestHighRate() const {
+    // 4 GB/s with 1 MB items polled every 10us, 400 items are sent in 100ms besides the initial burst
+    const uint64_t rate = 4ULL * 1000 * 1000 * 1000;
+    const size_t itemSize = 1000 * 1000;
+    RateLimiter limiter(rate, itemSize, ManualClock());
+    size_t cnt = 0;
+    auto end = mNow + chrono::milliseconds(100);
+    for (; mNow < end; mNow += chrono::microseconds(10)) {
+        if (limiter.IsValidToPop()) {
+            limiter.PostPop(itemSize);
+            ++cnt;
+        }
+    }
+    APSARA_TEST_EQUAL(401U, cnt);
+}
+
+UNIT_TEST_CASE(RateLimiterUnittest, TestUnlimited)
+UNIT_TEST_CASE(RateLimiterUnittest, TestBurst)
+UNIT_TEST_CASE(RateLimiterUnittest, TestRefill)
+UNIT_TEST_CASE(RateLimiterUnittest, TestHighRate)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
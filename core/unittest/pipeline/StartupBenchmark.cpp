@@ -0,0 +1,207 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdlib.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "checkpoint/CheckPointManager.h"
+#include "common/Flags.h"
+#include "common/JsonUtil.h"
+#include "common/TimeUtil.h"
+#include "config/watcher/PipelineConfigWatcher.h"
+#include "file_server/ConfigManager.h"
+#include "file_server/FileDiscoveryOptions.h"
+#include "file_server/FileServer.h"
+#include "pipeline/PipelineContext.h"
+#include "pipeline/PipelineManager.h"
+#include "pipeline/plugin/PluginRegistry.h"
+#include "plugin/input/InputFeedbackInterfaceRegistry.h"
+
+DEFINE_FLAG_INT32(bench_config_count, "number of pipeline configs", 1000);
+DEFINE_FLAG_INT32(bench_dir_count, "number of dirs watched by all configs, for each registration mode", 100000);
+DEFINE_FLAG_STRING(bench_dir, "dir where configs and log dirs are generated, a temp dir is created if empty", "");
+
+DECLARE_FLAG_INT32(config_load_thread_num);
+DECLARE_FLAG_INT32(pipeline_build_thread_num);
+DECLARE_FLAG_BOOL(enable_lazy_dir_registration);
+DECLARE_FLAG_INT32(lazy_dir_registration_batch_size);
+DECLARE_FLAG_INT32(max_watch_dir_count);
+
+using namespace std;
+using namespace logtail;
+
+static const char* kConfigTemplate = R"json({
+    "inputs": [
+        {
+            "Type": "input_file",
+            "FilePaths": ["LOG_DIR/**/*.log"],
+            "MaxDirSearchDepth": 10
+        }
+    ],
+    "processors": [
+        {
+            "Type": "processor_parse_regex_native",
+            "SourceKey": "content",
+            "Regex": "(\\S+)\\s(\\S+)\\s\\[([^\\]]+)\\]\\s\"(\\w+)\\s(\\S+)[^\"]*\"\\s(\\d+)\\s(\\d+)",
+            "Keys": ["ip", "user", "time", "method", "url", "status", "size"]
+        }
+    ],
+    "flushers": [
+        {
+            "Type": "flusher_sls",
+            "Project": "test_project",
+            "Logstore": "test_logstore_INDEX",
+            "Region": "test_region",
+            "Endpoint": "test_endpoint"
+        }
+    ]
+})json";
+
+static string GenerateConfig(const string& logDir, int index) {
+    string config = kConfigTemplate;
+    config.replace(config.find("LOG_DIR"), 7, logDir);
+    config.replace(config.find("INDEX"), 5, to_string(index));
+    return config;
+}
+
+// Each config watches a tree of 2 levels, and a log file with checkpoint is placed in the last dir.
+static string GenerateDirTree(const filesystem::path& root, int dirCount) {
+    int firstLevelCount = 10;
+    int secondLevelCount = max(dirCount / firstLevelCount - 1, 0);
+    filesystem::path lastDir = root;
+    filesystem::create_directories(root);
+    for (int i = 0; i < firstLevelCount; ++i) {
+        for (int j = 0; j < secondLevelCount; ++j) {
+            lastDir = root / ("dir_" + to_string(i)) / ("dir_" + to_string(j));
+            filesystem::create_directories(lastDir);
+        }
+    }
+    string logPath = (lastDir / "app.log").string();
+    ofstream(logPath) << "log\n";
+    return logPath;
+}
+
+static void BM_LoadAndBuildPipelines(const filesystem::path& configDir, int threadNum) {
+    INT32_FLAG(config_load_thread_num) = threadNum;
+    INT32_FLAG(pipeline_build_thread_num) = threadNum;
+    auto watcher = PipelineConfigWatcher::GetInstance();
+    watcher->AddSource(configDir.string());
+
+    uint64_t startTime = GetCurrentTimeInMicroSeconds();
+    auto diff = watcher->CheckConfigDiff();
+    uint64_t loadTime = GetCurrentTimeInMicroSeconds() - startTime;
+    size_t configCount = diff.first.mAdded.size();
+    startTime = GetCurrentTimeInMicroSeconds();
+    PipelineManager::GetInstance()->UpdatePipelines(diff.first);
+    uint64_t buildTime = GetCurrentTimeInMicroSeconds() - startTime;
+    printf("threads: %d, configs: %zu, pipelines: %zu, load: %lums, build: %lums\n",
+           threadNum,
+           configCount,
+           PipelineManager::GetInstance()->GetAllConfigNames().size(),
+           loadTime / 1000,
+           buildTime / 1000);
+
+    PipelineConfigDiff removeDiff;
+    removeDiff.mRemoved = PipelineManager::GetInstance()->GetAllConfigNames();
+    PipelineManager::GetInstance()->UpdatePipelines(removeDiff);
+    watcher->ClearEnvironment();
+}
+
+static void BM_RegisterDirs(const filesystem::path& root, int configCount, int dirCount, bool lazy) {
+    BOOL_FLAG(enable_lazy_dir_registration) = lazy;
+    vector<unique_ptr<FileDiscoveryOptions>> options;
+    vector<unique_ptr<PipelineContext>> contexts;
+    for (int i = 0; i < configCount; ++i) {
+        string name = string(lazy ? "lazy_" : "eager_") + to_string(i);
+        filesystem::path logDir = root / name;
+        string logPath = GenerateDirTree(logDir, dirCount / configCount);
+        CheckPointManager::Instance()->AddCheckPoint(
+            new CheckPoint(logPath, 0, 0, 0, DevInode(), name, logPath, false, false, false));
+
+        Json::Value config;
+        config["FilePaths"].append(Json::Value((logDir / "**" / "*.log").string()));
+        config["MaxDirSearchDepth"] = Json::Value(10);
+        contexts.emplace_back(new PipelineContext());
+        contexts.back()->SetConfigName(name);
+        options.emplace_back(new FileDiscoveryOptions());
+        options.back()->Init(config, *contexts.back(), "input_file");
+        FileServer::GetInstance()->AddFileDiscoveryConfig(name, options.back().get(), contexts.back().get());
+    }
+
+    uint64_t startTime = GetCurrentTimeInMicroSeconds();
+    ConfigManager::GetInstance()->RegisterHandlers();
+    ConfigManager::GetInstance()->RegisterCheckPointDirs();
+    uint64_t startupTime = GetCurrentTimeInMicroSeconds() - startTime;
+    startTime = GetCurrentTimeInMicroSeconds();
+    while (ConfigManager::GetInstance()->HasPendingDirs()) {
+        ConfigManager::GetInstance()->RegisterPendingDirs(INT32_FLAG(lazy_dir_registration_batch_size));
+    }
+    uint64_t backgroundTime = GetCurrentTimeInMicroSeconds() - startTime;
+    printf("lazy: %d, configs: %d, dirs: %d, registration before reading: %lums, in background: %lums\n",
+           lazy,
+           configCount,
+           dirCount,
+           startupTime / 1000,
+           backgroundTime / 1000);
+
+    for (int i = 0; i < configCount; ++i) {
+        FileServer::GetInstance()->RemoveFileDiscoveryConfig(string(lazy ? "lazy_" : "eager_") + to_string(i));
+    }
+    CheckPointManager::Instance()->RemoveAllCheckPoint();
+}
+
+int main(int argc, char* argv[]) {
+    google::ParseCommandLineFlags(&argc, &argv, true);
+    PluginRegistry::GetInstance()->LoadPlugins();
+    InputFeedbackInterfaceRegistry::GetInstance()->LoadFeedbackInterfaces();
+    // both registration modes watch all dirs
+    INT32_FLAG(max_watch_dir_count) = max(INT32_FLAG(max_watch_dir_count), INT32_FLAG(bench_dir_count) * 3);
+
+    string dir = STRING_FLAG(bench_dir);
+    // only the temp dir created here is removed afterwards
+    bool isTempDir = dir.empty();
+    if (isTempDir) {
+        char tmpl[] = "/tmp/startup_benchmark_XXXXXX";
+        if (mkdtemp(tmpl) == nullptr) {
+            printf("failed to create temp dir\n");
+            return 1;
+        }
+        dir = tmpl;
+    }
+    filesystem::path root(dir);
+    filesystem::path configDir = root / "configs";
+    filesystem::create_directories(configDir);
+    for (int i = 0; i < INT32_FLAG(bench_config_count); ++i) {
+        ofstream((configDir / ("bench_" + to_string(i) + ".json")).string())
+            << GenerateConfig((root / "logs" / to_string(i)).string(), i);
+    }
+
+    BM_LoadAndBuildPipelines(configDir, 1);
+    BM_LoadAndBuildPipelines(configDir, static_cast<int>(max(thread::hardware_concurrency(), 1U)));
+
+    BM_RegisterDirs(root / "logs", INT32_FLAG(bench_config_count), INT32_FLAG(bench_dir_count), false);
+    BM_RegisterDirs(root / "logs", INT32_FLAG(bench_config_count), INT32_FLAG(bench_dir_count), true);
+
+    if (isTempDir) {
+        filesystem::remove_all(root);
+    }
+    return 0;
+}
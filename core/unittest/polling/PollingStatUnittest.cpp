@@ -0,0 +1,155 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cerrno>
+#include <fstream>
+#include <map>
+#include <thread>
+
+#include <boost/filesystem.hpp>
+
+#include "common/Flags.h"
+#include "file_server/polling/PollingStat.h"
+#include "unittest/Unittest.h"
+
+DECLARE_FLAG_INT32(polling_cpu_budget_percent);
+
+using namespace std;
+
+namespace logtail {
+
+class PollingStatUnittest : public ::testing::Test {
+public:
+    void TestListDirEntries();
+    void TestBatchPathStat();
+    void TestThrottle();
+
+protected:
+    void SetUp() override {
+        mDir = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+        boost::filesystem::create_directories(mDir);
+    }
+
+    void TearDown() override { boost::filesystem::remove_all(mDir); }
+
+private:
+    string mDir;
+};
+
+void PollingStatUnittest::TestListDirEntries() {
+    { ofstream(mDir + "/file") << "content"; }
+    { ofstream(mDir + "/.hidden"); }
+    boost::filesystem::create_directories(mDir + "/dir");
+    boost::filesystem::create_symlink(mDir + "/file", mDir + "/link");
+
+    vector<fsutil::Entry> entries;
+    APSARA_TEST_TRUE(ListDirEntries(mDir, entries));
+    map<string, fsutil::Entry> entryMap;
+    for (const auto& ent : entries) {
+        entryMap[ent.Name()] = ent;
+    }
+    APSARA_TEST_EQUAL(3U, entryMap.size());
+    APSARA_TEST_TRUE(entryMap["file"].IsRegFile());
+    APSARA_TEST_TRUE(entryMap["dir"].IsDir());
+    // symbolic links are resolved by the caller
+    APSARA_TEST_TRUE(entryMap["link"].IsSymbolic());
+    APSARA_TEST_FALSE(entryMap["link"].IsRegFile());
+
+    APSARA_TEST_FALSE(ListDirEntries(mDir + "/not_exist", entries));
+    APSARA_TEST_TRUE(fsutil::Dir::IsENOENT(GetErrno()));
+}
+
+void PollingStatUnittest::TestBatchPathStat() {
+    // enough paths to be stated by multiple threads
+    vector<string> paths;
+    for (size_t i = 0; i < 200; ++i) {
+        paths.push_back(mDir + "/file_" + to_string(i));
+        ofstream(paths.back()) << string(i, 'a');
+    }
+    paths.push_back(mDir + "/not_exist");
+
+    vector<BatchPathStat::Result> results;
+    BatchPathStat::Stat(paths, results);
+    APSARA_TEST_EQUAL(paths.size(), results.size());
+    for (size_t i = 0; i < 200; ++i) {
+        APSARA_TEST_TRUE(results[i].mSucceeded);
+        APSARA_TEST_EQUAL(static_cast<int64_t>(i), results[i].mStat.GetFileSize());
+    }
+    APSARA_TEST_FALSE(results.back().mSucceeded);
+    APSARA_TEST_EQUAL(ENOENT, results.back().mErrno);
+
+    // worker threads are shared by concurrent callers
+    vector<BatchPathStat::Result> otherResults;
+    thread other([&]() {
+        for (int i = 0; i < 10; ++i) {
+            BatchPathStat::Stat(paths, otherResults);
+        }
+    });
+    for (int i = 0; i < 10; ++i) {
+        BatchPathStat::Stat(paths, results);
+    }
+    other.join();
+    for (size_t i = 0; i < 200; ++i) {
+        APSARA_TEST_EQUAL(static_cast<int64_t>(i), results[i].mStat.GetFileSize());
+        APSARA_TEST_EQUAL(static_cast<int64_t>(i), otherResults[i].mStat.GetFileSize());
+    }
+}
+
+void PollingStatUnittest::TestThrottle() {
+    auto burnCpu = []() {
+        int64_t start = PollingThrottle::GetThreadCpuTimeNs();
+        volatile uint64_t sum = 0;
+        while (PollingThrottle::GetThreadCpuTimeNs() - start < 20 * 1000 * 1000) {
+            for (int i = 0; i < 10000; ++i) {
+                sum += i;
+            }
+        }
+    };
+
+    INT32_FLAG(polling_cpu_budget_percent) = 10;
+    PollingThrottle throttle;
+    throttle.Start();
+    burnCpu();
+    throttle.Check();
+    // sleep until cpu time is within 10% of wall time
+    int64_t cpuTimeNs = PollingThrottle::GetThreadCpuTimeNs() - throttle.mStartCpuTimeNs;
+    int64_t wallTimeNs
+        = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - throttle.mStartTime).count();
+    APSARA_TEST_TRUE(wallTimeNs >= cpuTimeNs * 9);
+
+    // cpu time of other threads is counted as well
+    throttle.Start();
+    throttle.AddCpuTime(20 * 1000 * 1000);
+    throttle.mLastCheckTime -= chrono::milliseconds(100);
+    throttle.Check();
+    wallTimeNs = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - throttle.mStartTime).count();
+    APSARA_TEST_TRUE(wallTimeNs >= 190 * 1000 * 1000);
+
+    // disabled
+    INT32_FLAG(polling_cpu_budget_percent) = 0;
+    throttle.Start();
+    burnCpu();
+    auto before = chrono::steady_clock::now();
+    throttle.Check();
+    APSARA_TEST_TRUE(chrono::steady_clock::now() - before < chrono::milliseconds(10));
+    INT32_FLAG(polling_cpu_budget_percent) = 10;
+}
+
+UNIT_TEST_CASE(PollingStatUnittest, TestListDirEntries)
+UNIT_TEST_CASE(PollingStatUnittest, TestBatchPathStat)
+UNIT_TEST_CASE(PollingStatUnittest, TestThrottle)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -75,8 +75,6 @@ DECLARE_FLAG_INT32(stat_notify_check_round);
 DECLARE_FLAG_INT32(check_not_exist_file_dir_round);
 DECLARE_FLAG_INT32(delete_dir_file_round);
 DECLARE_FLAG_INT32(dirfile_check_interval_ms);
-DECLARE_FLAG_INT32(dirfile_stat_count);
-DECLARE_FLAG_INT32(dirfile_stat_sleep);
 
 DECLARE_FLAG_INT32(modify_check_interval);
 DECLARE_FLAG_INT32(ignore_file_modify_timeout);
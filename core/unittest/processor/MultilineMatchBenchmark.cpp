@@ -0,0 +1,96 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <boost/regex.hpp>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "common/AnchoredRegex.h"
+#include "common/StringTools.h"
+#include "unittest/Unittest.h"
+
+using namespace logtail;
+
+// A java application log where most lines are stack frames of exceptions.
+static std::vector<std::string> BuildStackTraceCorpus(int logCount) {
+    std::vector<std::string> lines;
+    for (int i = 0; i < logCount; ++i) {
+        lines.push_back("2024-05-01 10:00:" + std::to_string(10 + i % 50)
+                        + ".123 ERROR [http-nio-8080-exec-" + std::to_string(i % 16)
+                        + "] c.e.s.OrderService - failed to process order " + std::to_string(i));
+        lines.push_back("java.lang.IllegalStateException: order " + std::to_string(i) + " is locked");
+        for (int j = 0; j < 12; ++j) {
+            lines.push_back("\tat com.example.service.OrderService.process" + std::to_string(j)
+                            + "(OrderService.java:" + std::to_string(100 + j) + ")");
+        }
+        lines.push_back("Caused by: java.util.concurrent.TimeoutException: lock wait timeout");
+        for (int j = 0; j < 6; ++j) {
+            lines.push_back("\tat java.util.concurrent.locks.ReentrantLock.tryLock(ReentrantLock.java:"
+                            + std::to_string(400 + j) + ")");
+        }
+        lines.push_back("\t... 24 more");
+    }
+    return lines;
+}
+
+static void BM_MultilineMatch(const std::string& pattern, const std::vector<std::string>& lines, int rounds) {
+    boost::regex boostRegex(pattern);
+    AnchoredRegex regex;
+    regex.Init(pattern);
+    std::string exception;
+
+    size_t boostMatched = 0;
+    uint64_t startTime = GetCurrentTimeInMicroSeconds();
+    for (int i = 0; i < rounds; ++i) {
+        for (const auto& line : lines) {
+            boostMatched += BoostRegexSearch(line.data(), line.size(), boostRegex, exception);
+        }
+    }
+    uint64_t boostDurationTime = GetCurrentTimeInMicroSeconds() - startTime + 1;
+
+    size_t matched = 0;
+    startTime = GetCurrentTimeInMicroSeconds();
+    for (int i = 0; i < rounds; ++i) {
+        for (const auto& line : lines) {
+            matched += regex.Match(line.data(), line.size(), exception);
+        }
+    }
+    uint64_t durationTime = GetCurrentTimeInMicroSeconds() - startTime + 1;
+
+    uint64_t lineCount = lines.size() * static_cast<uint64_t>(rounds);
+    std::cout << "pattern: " << pattern << (regex.IsDfaCompiled() ? "" : " (boost fallback)") << std::endl;
+    std::cout << "boost::regex lines/s: " << lineCount * 1000000 / boostDurationTime << std::endl;
+    std::cout << "AnchoredRegex lines/s: " << lineCount * 1000000 / durationTime << std::endl;
+    if (matched != boostMatched) {
+        std::cout << "error: matched " << matched << " lines, expected " << boostMatched << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    logtail::Logger::Instance().InitGlobalLoggers();
+#ifdef NDEBUG
+    std::cout << "release" << std::endl;
+#else
+    std::cout << "debug" << std::endl;
+#endif
+    std::vector<std::string> lines = BuildStackTraceCorpus(1000);
+    // start patterns
+    BM_MultilineMatch(R"(\d+-\d+-\d+\s\d+:\d+:\d+)", lines, 20);
+    BM_MultilineMatch(R"(\d{4}-\d{2}-\d{2} \d{2}:\d{2}:\d{2}\.\d{3} (ERROR|WARN|INFO))", lines, 20);
+    // continue patterns
+    BM_MultilineMatch(R"(\s+at\s.*)", lines, 20);
+    BM_MultilineMatch(R"((\s+at\s|Caused by:|\s+\.\.\.|\S+Exception))", lines, 20);
+    return 0;
+}
@@ -16,6 +16,7 @@
 #include <cstring>
 #include <iostream>
 #include <sstream>
+#include <vector>
 
 #include "config/PipelineConfig.h"
 #include "models/LogEvent.h"
@@ -40,7 +41,7 @@ std::string formatSize(long long size) {
     return ss.str();
 }
 
-static void BM_DockerJson(int size, int batchSize) {
+static void BM_DockerJson(const std::vector<std::string>& lines, int size, int batchSize) {
     logtail::Logger::Instance().InitGlobalLoggers();
 
     PipelineContext mContext;
@@ -53,65 +54,24 @@ static void BM_DockerJson(int size, int batchSize) {
     processor.SetContext(mContext);
     processor.SetMetricsRecordRef(ProcessorParseContainerLogNative::sName, "1");
 
-    std::string data1
-        = R"({"log":"Exception in thread \"main\" java.lang.NullPointerExceptionat  com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitle\n","stream":"stdout","time":"2024-04-07T08:02:40.873971412Z"})";
-    std::string data2
-        = R"({"log":"    at com.example.myproject.Book.getTitle\n","stream":"stdout","time":"2024-04-07T08:02:40.873976048Z"})";
-    std::string data3
-        = R"({"log":"    at com.example.myproject.Book.getTitle\n","stream":"stdout","time":"2024-04-07T08:02:40.873978568Z"})";
-    std::string data4
-        = R"({"log":"    at com.example.myproject.Book.getTitle\n","stream":"stdout","time":"2024-04-07T08:02:40.87398107Z"})";
-    std::cout << "log size:\t" << formatSize((data1.size() + data2.size() + data3.size() + data4.size() + 7 * 4) * size)
-              << std::endl;
+    size_t linesSize = 0;
+    for (const auto& line : lines) {
+        linesSize += line.size() + 7;
+    }
+    std::cout << "log size:\t" << formatSize(linesSize * size) << std::endl;
 
     // make events
     Json::Value root;
     Json::Value events;
     for (int i = 0; i < size; i++) {
-        {
-            Json::Value event;
-            event["type"] = 1;
-            event["timestamp"] = 1234567890;
-            event["timestampNanosecond"] = 0;
-            {
-                Json::Value contents;
-                contents["content"] = data1;
-                event["contents"] = std::move(contents);
-            }
-            events.append(event);
-        }
-        {
+        for (const auto& line : lines) {
             Json::Value event;
             event["type"] = 1;
             event["timestamp"] = 1234567890;
             event["timestampNanosecond"] = 0;
             {
                 Json::Value contents;
-                contents["content"] = data2;
-                event["contents"] = std::move(contents);
-            }
-            events.append(event);
-        }
-        {
-            Json::Value event;
-            event["type"] = 1;
-            event["timestamp"] = 1234567890;
-            event["timestampNanosecond"] = 0;
-            {
-                Json::Value contents;
-                contents["content"] = data3;
-                event["contents"] = std::move(contents);
-            }
-            events.append(event);
-        }
-        {
-            Json::Value event;
-            event["type"] = 1;
-            event["timestamp"] = 1234567890;
-            event["timestampNanosecond"] = 0;
-            {
-                Json::Value contents;
-                contents["content"] = data4;
+                contents["content"] = line;
                 event["contents"] = std::move(contents);
             }
             events.append(event);
@@ -147,9 +107,7 @@ static void BM_DockerJson(int size, int batchSize) {
         }
         std::cout << "durationTime: " << durationTime << std::endl;
         std::cout << "process: "
-                  << formatSize((data1.size() + data2.size() + data3.size() + data4.size() + 7 * 4) * (uint64_t)count
-                                * 1000000 * (uint64_t)size / durationTime)
-                  << std::endl;
+                  << formatSize(linesSize * (uint64_t)count * 1000000 * (uint64_t)size / durationTime) << std::endl;
     }
 }
 
@@ -273,8 +231,26 @@ int main(int argc, char** argv) {
 #else
     std::cout << "debug" << std::endl;
 #endif
+    std::string dockerData1
+        = R"({"log":"Exception in thread \"main\" java.lang.NullPointerExceptionat  com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitleat com.example.myproject.Book.getTitle\n","stream":"stdout","time":"2024-04-07T08:02:40.873971412Z"})";
+    std::string dockerData2
+        = R"({"log":"    at com.example.myproject.Book.getTitle\n","stream":"stdout","time":"2024-04-07T08:02:40.873976048Z"})";
+    std::string dockerData3
+        = R"({"log":"    at com.example.myproject.Book.getTitle\n","stream":"stdout","time":"2024-04-07T08:02:40.873978568Z"})";
+    std::string dockerData4
+        = R"({"log":"    at com.example.myproject.Book.getTitle\n","stream":"stdout","time":"2024-04-07T08:02:40.87398107Z"})";
     std::cout << "docker json" << std::endl;
-    BM_DockerJson(512, 100);
+    BM_DockerJson({dockerData1, dockerData2, dockerData3, dockerData4}, 512, 100);
+    // unicode escapes written by docker for non-ASCII and control chars
+    std::string escapedData
+        = R"({"log":"\u001b[32mINFO\u001b[0m 你好, \"user\":\"abc\" 🌍\t\\path\\to\\file\n","stream":"stderr","time":"2024-04-07T08:02:40.873971412Z"})";
+    std::cout << "docker json with escapes" << std::endl;
+    BM_DockerJson({escapedData}, 2048, 100);
+    // fields added by docker log-opts, which are parsed by rapidjson
+    std::string attrsData
+        = R"({"log":"    at com.example.myproject.Book.getTitle\n","stream":"stdout","attrs":{"app":"book","env":"prod"},"time":"2024-04-07T08:02:40.87398107Z"})";
+    std::cout << "docker json with extra fields" << std::endl;
+    BM_DockerJson({attrsData}, 2048, 100);
     std::cout << "containerdText" << std::endl;
     BM_ContainerdText(512, 100);
     return 0;
@@ -32,6 +32,9 @@ public:
     void TestCastSensWordFail();
     void TestCastSensWordLoggroup();
     void TestCastSensWordMulti();
+    void TestCastSensWordRules();
+    void TestCastSensWordEmptyMatch();
+    void TestCastSensWordRuleSetError();
     void TestMultipleLines();
     void TestMultipleLinesWithProcessorMergeMultilineLogNative();
 
@@ -50,6 +53,12 @@ UNIT_TEST_CASE(ProcessorDesensitizeNativeUnittest, TestCastSensWordLoggroup);
 
 UNIT_TEST_CASE(ProcessorDesensitizeNativeUnittest, TestCastSensWordMulti);
 
+UNIT_TEST_CASE(ProcessorDesensitizeNativeUnittest, TestCastSensWordRules);
+
+UNIT_TEST_CASE(ProcessorDesensitizeNativeUnittest, TestCastSensWordEmptyMatch);
+
+UNIT_TEST_CASE(ProcessorDesensitizeNativeUnittest, TestCastSensWordRuleSetError);
+
 UNIT_TEST_CASE(ProcessorDesensitizeNativeUnittest, TestMultipleLines);
 
 UNIT_TEST_CASE(ProcessorDesensitizeNativeUnittest, TestMultipleLinesWithProcessorMergeMultilineLogNative);
@@ -78,6 +87,146 @@ ProcessorDesensitizeNativeUnittest::GetCastSensWordConfig(std::string sourceKey
     return config;
 }
 
+void ProcessorDesensitizeNativeUnittest::TestCastSensWordRules() {
+    Json::Value config;
+    config["SourceKey"] = Json::Value("content");
+    config["Rules"].append(GetCastSensWordConfig("", "const", "********", "pwd=", "[^,]+", true));
+    config["Rules"].append(GetCastSensWordConfig("", "md5", "", "id=\\d{3}", "\\d+", true));
+    config["Rules"].append(GetCastSensWordConfig("", "const", "***", "pw", "d=\\w+", true));
+    config["Rules"].append(GetCastSensWordConfig("", "const", "\\2_", "(token)=", "\\w+", false));
+    for (auto& rule : config["Rules"]) {
+        rule.removeMember("SourceKey");
+    }
+    ProcessorDesensitizeNative& processor = *(new ProcessorDesensitizeNative);
+    ProcessorInstance processorInstance(&processor, getPluginMeta());
+    APSARA_TEST_TRUE_FATAL(processorInstance.Init(config, mContext));
+    APSARA_TEST_EQUAL(4U, processor.mRules.size());
+    APSARA_TEST_TRUE(processor.mRuleSet != nullptr);
+
+    // make events
+    auto sourceBuffer = std::make_shared<SourceBuffer>();
+    PipelineEventGroup eventGroup(sourceBuffer);
+    std::string inJson = R"({
+        "events" :
+        [
+            {
+                "contents" :
+                {
+                    "content" : "id=123456,pwd=abc,token=t1,pwd=def,token=t2"
+                },
+                "timestampNanosecond" : 0,
+                "timestamp" : 12345678901,
+                "type" : 1
+            },
+            {
+                "contents" :
+                {
+                    "content" : "nothing sensitive"
+                },
+                "timestampNanosecond" : 0,
+                "timestamp" : 12345678901,
+                "type" : 1
+            }
+        ]
+    })";
+    eventGroup.FromJsonString(inJson);
+    // run function
+    std::vector<PipelineEventGroup> eventGroupList;
+    eventGroupList.emplace_back(std::move(eventGroup));
+    processorInstance.Process(eventGroupList);
+
+    // earlier rule wins if rules match at the same position, and rules without ReplacingAll replace only once
+    std::string expectJson = R"({
+        "events" :
+        [
+            {
+                "contents" :
+                {
+                    "content" : "id=123250CF8B51C773F3F8DC8B4BE867A9A02,pwd=********,token=token_,pwd=********,token=t2"
+                },
+                "timestamp" : 12345678901,
+                "timestampNanosecond" : 0,
+                "type" : 1
+            },
+            {
+                "contents" :
+                {
+                    "content" : "nothing sensitive"
+                },
+                "timestamp" : 12345678901,
+                "timestampNanosecond" : 0,
+                "type" : 1
+            }
+        ]
+    })";
+    std::string outJson = eventGroupList[0].ToJsonString();
+    APSARA_TEST_STREQ_FATAL(CompactJson(expectJson).c_str(), CompactJson(outJson).c_str());
+
+    // invalid rules
+    config["Rules"] = Json::Value(Json::arrayValue);
+    ProcessorDesensitizeNative& processor2 = *(new ProcessorDesensitizeNative);
+    ProcessorInstance processorInstance2(&processor2, getPluginMeta());
+    APSARA_TEST_FALSE(processorInstance2.Init(config, mContext));
+}
+
+void ProcessorDesensitizeNativeUnittest::TestCastSensWordEmptyMatch() {
+    // patterns matching empty strings, which used to step beyond the end of the value forever
+    for (const std::string prefix : {"x*", "\\s*"}) {
+        Json::Value config = GetCastSensWordConfig("content", "const", "***", prefix, "[^,]*", true);
+        ProcessorDesensitizeNative& processor = *(new ProcessorDesensitizeNative);
+        ProcessorInstance processorInstance(&processor, getPluginMeta());
+        APSARA_TEST_TRUE_FATAL(processorInstance.Init(config, mContext));
+
+        // expected results are the same as RE2::GlobalReplace
+        const std::vector<std::pair<std::string, std::string>> cases = {
+            {"2", "***"},
+            {"ax\xc3\xa9", "***"},
+            {"a,b", "***,***"},
+            {",", "***,***"},
+        };
+        for (const auto& item : cases) {
+            PipelineEventGroup eventGroup(std::make_shared<SourceBuffer>());
+            LogEvent* event = eventGroup.AddLogEvent();
+            event->SetContent(std::string("content"), item.first);
+            std::vector<PipelineEventGroup> eventGroupList;
+            eventGroupList.emplace_back(std::move(eventGroup));
+            processorInstance.Process(eventGroupList);
+            APSARA_TEST_EQUAL(item.second,
+                              eventGroupList[0].GetEvents()[0].Cast<LogEvent>().GetContent("content").to_string());
+        }
+    }
+}
+
+void ProcessorDesensitizeNativeUnittest::TestCastSensWordRuleSetError() {
+    Json::Value config;
+    config["SourceKey"] = Json::Value("content");
+    config["Rules"].append(GetCastSensWordConfig("", "const", "********", "pwd=", "[^,]+", true));
+    config["Rules"].append(GetCastSensWordConfig("", "const", "***", "token=", "\\w+", true));
+    for (auto& rule : config["Rules"]) {
+        rule.removeMember("SourceKey");
+    }
+    ProcessorDesensitizeNative& processor = *(new ProcessorDesensitizeNative);
+    ProcessorInstance processorInstance(&processor, getPluginMeta());
+    APSARA_TEST_TRUE_FATAL(processorInstance.Init(config, mContext));
+    APSARA_TEST_TRUE_FATAL(processor.mRuleSet != nullptr);
+
+    // an uncompiled set fails to match with an error, just like a set whose DFA runs out of memory
+    processor.mRuleSet.reset(new re2::RE2::Set(re2::RE2::Options(), re2::RE2::UNANCHORED));
+    for (const auto& rule : processor.mRules) {
+        processor.mRuleSet->Add(rule.mRegex->pattern(), nullptr);
+    }
+
+    // all rules are tried then, so that the value is not left unmasked
+    PipelineEventGroup eventGroup(std::make_shared<SourceBuffer>());
+    LogEvent* event = eventGroup.AddLogEvent();
+    event->SetContent(std::string("content"), std::string("pwd=abc,token=t1"));
+    std::vector<PipelineEventGroup> eventGroupList;
+    eventGroupList.emplace_back(std::move(eventGroup));
+    processorInstance.Process(eventGroupList);
+    APSARA_TEST_EQUAL("pwd=********,token=***",
+                      eventGroupList[0].GetEvents()[0].Cast<LogEvent>().GetContent("content").to_string());
+}
+
 void ProcessorDesensitizeNativeUnittest::TestMultipleLines() {
     std::string inJson = R"({
         "events" :
@@ -52,6 +52,7 @@ public:
     void TestDockerJsonLogLineParser();
     void TestKeepingSourceWhenParseFail();
     void TestParseDockerLog();
+    void TestParseDockerLogByRapidJson();
 
     PipelineContext mContext;
 };
@@ -64,6 +65,7 @@ UNIT_TEST_CASE(ProcessorParseContainerLogNativeUnittest, TestDockerJsonLogLinePa
 UNIT_TEST_CASE(ProcessorParseContainerLogNativeUnittest, TestDockerJsonLogLineParser);
 UNIT_TEST_CASE(ProcessorParseContainerLogNativeUnittest, TestKeepingSourceWhenParseFail);
 UNIT_TEST_CASE(ProcessorParseContainerLogNativeUnittest, TestParseDockerLog);
+UNIT_TEST_CASE(ProcessorParseContainerLogNativeUnittest, TestParseDockerLogByRapidJson);
 // UNIT_TEST_CASE(ProcessorParseContainerLogNativeUnittest, TestFindAndSearchPerformance);
 
 // 生成一个随机字符串
@@ -1391,7 +1393,7 @@ void ProcessorParseContainerLogNativeUnittest::TestDockerJsonLogLineParser() {
                     {
                         "contents" :
                         {
-                            "content": "{\"log\":\"Exception in thread  \"main\" java.lang.NullPoinntterException\nn\\n\",\"stream\":\"stdout\",\"time\":\"2024-02-19T03:49:37.793533014Z\"}\n{\"log\":\"     at com.example.myproject.Book.getTitle\\n\",\"stream\":\"stdout\",\"time1\":\"2024-02-19T03:49:37.793559367Z\"}"
+                            "content": "{\"log\":\"Exception in thread  \\\"main\\\" java.lang.NullPoinntterException\\n\",\"stream\":\"stdout\",\"time\":\"2024-02-19T03:49:37.793533014Z\"}\n{\"log\":\"     at com.example.myproject.Book.getTitle\\n\",\"stream\":\"stdout\",\"time1\":\"2024-02-19T03:49:37.793559367Z\"}"
                         },
                         "timestamp" : 12345678901,
                         "timestampNanosecond" : 0,
@@ -1436,7 +1438,7 @@ void ProcessorParseContainerLogNativeUnittest::TestDockerJsonLogLineParser() {
                     {
                         "contents" :
                         {
-                            "content": "{\"log\":\"Exception in thread  \"main\" java.lang.NullPoinntterException\nn\\n\",\"stream\":\"stdout\",\"time\":\"2024-02-19T03:49:37.793533014Z\"}\n{\"log\":\"     at com.example.myproject.Book.getTitle\\n\",\"stream\":\"stdout\",\"time\":\"\"}"
+                            "content": "{\"log\":\"Exception in thread  \\\"main\\\" java.lang.NullPoinntterException\\n\",\"stream\":\"stdout\",\"time\":\"2024-02-19T03:49:37.793533014Z\"}\n{\"log\":\"     at com.example.myproject.Book.getTitle\\n\",\"stream\":\"stdout\",\"time\":\"\"}"
                         },
                         "timestamp" : 12345678901,
                         "timestampNanosecond" : 0,
@@ -1481,7 +1483,7 @@ void ProcessorParseContainerLogNativeUnittest::TestDockerJsonLogLineParser() {
                     {
                         "contents" :
                         {
-                            "content": "{\"log\":\"Exception in thread  \"main\" java.lang.NullPoinntterException\nn\\n\",\"stream\":\"stdout\",\"time\":\"2024-02-19T03:49:37.793533014Z\"}\n{\"log\":\"     at com.example.myproject.Book.getTitle\\n\",\"stream\":\"stdout\",\"time\":1}"
+                            "content": "{\"log\":\"Exception in thread  \\\"main\\\" java.lang.NullPoinntterException\\n\",\"stream\":\"stdout\",\"time\":\"2024-02-19T03:49:37.793533014Z\"}\n{\"log\":\"     at com.example.myproject.Book.getTitle\\n\",\"stream\":\"stdout\",\"time\":1}"
                         },
                         "timestamp" : 12345678901,
                         "timestampNanosecond" : 0,
@@ -1529,7 +1531,7 @@ void ProcessorParseContainerLogNativeUnittest::TestDockerJsonLogLineParser() {
                     {
                         "contents" :
                         {
-                            "content": "{\"log\":\"Exception in thread  \"main\" java.lang.NullPoinntterException\nn\\n\",\"stream\":\"stdout\",\"time\":\"2024-02-19T03:49:37.793533014Z\"}\n{\"log\":\"     at com.example.myproject.Book.getTitle\\n\",\"stream1\":\"stdout\",\"time\":\"2024-02-19T03:49:37.793559367Z\"}"
+                            "content": "{\"log\":\"Exception in thread  \\\"main\\\" java.lang.NullPoinntterException\\n\",\"stream\":\"stdout\",\"time\":\"2024-02-19T03:49:37.793533014Z\"}\n{\"log\":\"     at com.example.myproject.Book.getTitle\\n\",\"stream1\":\"stdout\",\"time\":\"2024-02-19T03:49:37.793559367Z\"}"
                         },
                         "timestamp" : 12345678901,
                         "timestampNanosecond" : 0,
@@ -1574,7 +1576,7 @@ void ProcessorParseContainerLogNativeUnittest::TestDockerJsonLogLineParser() {
                     {
                         "contents" :
                         {
-                            "content": "{\"log\":\"Exception in thread  \"main\" java.lang.NullPoinntterException\nn\\n\",\"stream\":\"stdout\",\"time\":\"2024-02-19T03:49:37.793533014Z\"}\n{\"log\":\"     at com.example.myproject.Book.getTitle\\n\",\"stream\":\"std\",\"time\":\"2024-02-19T03:49:37.793559367Z\"}"
+                            "content": "{\"log\":\"Exception in thread  \\\"main\\\" java.lang.NullPoinntterException\\n\",\"stream\":\"stdout\",\"time\":\"2024-02-19T03:49:37.793533014Z\"}\n{\"log\":\"     at com.example.myproject.Book.getTitle\\n\",\"stream\":\"std\",\"time\":\"2024-02-19T03:49:37.793559367Z\"}"
                         },
                         "timestamp" : 12345678901,
                         "timestampNanosecond" : 0,
@@ -1619,7 +1621,7 @@ void ProcessorParseContainerLogNativeUnittest::TestDockerJsonLogLineParser() {
                     {
                         "contents" :
                         {
-                            "content": "{\"log\":\"Exception in thread  \"main\" java.lang.NullPoinntterException\nn\\n\",\"stream\":1,\"time\":\"2024-02-19T03:49:37.793533014Z\"}\n{\"log\":\"     at com.example.myproject.Book.getTitle\\n\",\"stream\":\"std\",\"time\":\"2024-02-19T03:49:37.793559367Z\"}"
+                            "content": "{\"log\":\"Exception in thread  \\\"main\\\" java.lang.NullPoinntterException\\n\",\"stream\":1,\"time\":\"2024-02-19T03:49:37.793533014Z\"}\n{\"log\":\"     at com.example.myproject.Book.getTitle\\n\",\"stream\":\"std\",\"time\":\"2024-02-19T03:49:37.793559367Z\"}"
                         },
                         "timestamp" : 12345678901,
                         "timestampNanosecond" : 0,
@@ -2089,6 +2091,30 @@ void ProcessorParseContainerLogNativeUnittest::TestKeepingSourceWhenParseFail()
             }
         }
     }
+
+    // docker, the source is kept as is when stream is invalid, though log contains escape sequences
+    {
+        Json::Value config;
+        config["KeepingSourceWhenParseFail"] = true;
+        ProcessorParseContainerLogNative processor;
+        processor.SetContext(mContext);
+        processor.SetMetricsRecordRef(ProcessorParseContainerLogNative::sName, "1");
+        APSARA_TEST_TRUE_FATAL(processor.Init(config));
+
+        const std::vector<std::string> lines = {
+            R"({"log":"Hello, \"World\"\n","stream":"std","time":"2021-12-01T00:00:00.000Z"})",
+            // with an extra field
+            R"({"log":"Hello, \"World\"\n","stream":"std","attrs":{"tag":"a"},"time":"2021-12-01T00:00:00.000Z"})",
+        };
+        for (const auto& line : lines) {
+            PipelineEventGroup eventGroup(std::make_shared<SourceBuffer>());
+            eventGroup.SetMetadata(EventGroupMetaKey::LOG_FORMAT, ProcessorParseContainerLogNative::DOCKER_JSON_FILE);
+            eventGroup.AddLogEvent()->SetContent(std::string("content"), line);
+            processor.Process(eventGroup);
+            APSARA_TEST_EQUAL_FATAL(1U, eventGroup.GetEvents().size());
+            APSARA_TEST_EQUAL(line, eventGroup.GetEvents()[0].Cast<LogEvent>().GetContent("content").to_string());
+        }
+    }
 }
 
 void ProcessorParseContainerLogNativeUnittest::TestParseDockerLog() {
@@ -2262,6 +2288,133 @@ void ProcessorParseContainerLogNativeUnittest::TestParseDockerLog() {
         APSARA_TEST_FALSE(result);
         delete[] buffer;
     }
+    // Test with surrogate pairs, lone surrogates and malformed unicode escapes
+    {
+        DockerLog dockerLog;
+        std::string str = R"({"time":"2021-12-01T00:00:00.000Z", "stream" : "stderr", "log":"🌍 \ud83c \u12 \uzzzz"})";
+        std::string buffer = str;
+
+        bool result = ProcessorParseContainerLogNative::ParseDockerLog(&buffer[0], buffer.size(), dockerLog);
+
+        APSARA_TEST_TRUE(result);
+        APSARA_TEST_EQUAL("🌍 \xEF\xBF\xBD \\u12 \\uzzzz", dockerLog.log.to_string());
+        APSARA_TEST_EQUAL("stderr", dockerLog.stream);
+        APSARA_TEST_EQUAL("2021-12-01T00:00:00.000Z", dockerLog.time);
+    }
+    // Test that the buffer is left untouched if stream is invalid
+    {
+        DockerLog dockerLog;
+        std::string str = R"({"log":"Hello, \"World\"\n","stream":"std","time":"2021-12-01T00:00:00.000Z"})";
+        std::string buffer = str;
+
+        bool result = ProcessorParseContainerLogNative::ParseDockerLog(&buffer[0], buffer.size(), dockerLog);
+
+        APSARA_TEST_FALSE(result);
+        APSARA_TEST_EQUAL(str, buffer);
+    }
+    // Test that the buffer is left untouched if the log is not in the expected shape
+    {
+        DockerLog dockerLog;
+        std::string str = R"({"log":"Hello, \"World\"\n","stream":"stdout","time":"2021-12-01T00:00:00.000Z"} {})";
+        std::string buffer = str;
+
+        bool result = ProcessorParseContainerLogNative::ParseDockerLog(&buffer[0], buffer.size(), dockerLog);
+
+        APSARA_TEST_FALSE(result);
+        APSARA_TEST_EQUAL(str, buffer);
+    }
+}
+
+void ProcessorParseContainerLogNativeUnittest::TestParseDockerLogByRapidJson() {
+    // Test with extra fields and escape sequences in all fields
+    {
+        DockerLog dockerLog;
+        std::string str
+            = R"({"log":"Hello, \"World\"\n","stream":"stdout","attrs":{"tag":"a"},"time":"2021-12-01T00:00:00.000Z"})";
+        std::string buffer = str;
+
+        APSARA_TEST_FALSE(ProcessorParseContainerLogNative::ParseDockerLog(&buffer[0], buffer.size(), dockerLog));
+        APSARA_TEST_EQUAL(str, buffer);
+        bool result
+            = ProcessorParseContainerLogNative::ParseDockerLogByRapidJson(&buffer[0], buffer.size(), dockerLog);
+
+        APSARA_TEST_TRUE(result);
+        APSARA_TEST_EQUAL("Hello, \"World\"\n", dockerLog.log.to_string());
+        APSARA_TEST_EQUAL("stdout", dockerLog.stream);
+        APSARA_TEST_EQUAL("2021-12-01T00:00:00.000Z", dockerLog.time);
+    }
+    // Test with an invalid stream
+    {
+        DockerLog dockerLog;
+        std::string str
+            = R"({"log":"Hello, \"World\"\n","stream":"std","attrs":{"tag":"a"},"time":"2021-12-01T00:00:00.000Z"})";
+        std::string buffer = str;
+
+        bool result
+            = ProcessorParseContainerLogNative::ParseDockerLogByRapidJson(&buffer[0], buffer.size(), dockerLog);
+
+        APSARA_TEST_FALSE(result);
+        APSARA_TEST_EQUAL(str, buffer);
+    }
+    // Test with missing fields
+    {
+        DockerLog dockerLog;
+        std::string str = R"({"log":"Hello, World!","stream":"stdout","attrs":{"tag":"a"}})";
+        std::string buffer = str;
+
+        bool result
+            = ProcessorParseContainerLogNative::ParseDockerLogByRapidJson(&buffer[0], buffer.size(), dockerLog);
+
+        APSARA_TEST_FALSE(result);
+        APSARA_TEST_EQUAL(str, buffer);
+    }
+    // Test with the processor
+    {
+        Json::Value config;
+        ProcessorParseContainerLogNative processor;
+        processor.SetContext(mContext);
+        processor.SetMetricsRecordRef(ProcessorParseContainerLogNative::sName, "1");
+        APSARA_TEST_TRUE_FATAL(processor.Init(config));
+
+        auto sourceBuffer = std::make_shared<SourceBuffer>();
+        PipelineEventGroup eventGroup(sourceBuffer);
+        eventGroup.SetMetadata(EventGroupMetaKey::LOG_FORMAT, ProcessorParseContainerLogNative::DOCKER_JSON_FILE);
+        std::string inJson = R"({
+            "events": [
+                {
+                    "contents": {
+                        "content": "{\"log\":\"Hello, World!\\n\",\"stream\":\"stdout\",\"attrs\":{\"tag\":\"a\"},\"time\":\"2024-02-19T03:49:37.793559367Z\"}"
+                    },
+                    "timestamp": 12345678901,
+                    "timestampNanosecond": 0,
+                    "type": 1
+                }
+            ]
+        })";
+        eventGroup.FromJsonString(inJson);
+        processor.Process(eventGroup);
+        std::string expectJson = R"({
+            "events" :
+            [
+                {
+                    "contents" :
+                    {
+                        "_source_": "stdout",
+                        "_time_": "2024-02-19T03:49:37.793559367Z",
+                        "content": "Hello, World!"
+                    },
+                    "timestamp" : 12345678901,
+                    "timestampNanosecond" : 0,
+                    "type" : 1
+                }
+            ],
+            "metadata":{
+                "container.type":"docker_json-file"
+            }
+        })";
+        std::string outJson = eventGroup.ToJsonString();
+        APSARA_TEST_STREQ(CompactJson(expectJson).c_str(), CompactJson(outJson).c_str());
+    }
 }
 
 } // namespace logtail
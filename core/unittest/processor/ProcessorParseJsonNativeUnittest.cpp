@@ -315,6 +315,7 @@ void ProcessorParseJsonNativeUnittest::TestProcessJsonEscapedNullByte() {
     std::string outJson = eventGroupList[0].ToJsonString();
     APSARA_TEST_STREQ_FATAL(CompactJson(expectJson).c_str(), CompactJson(outJson).c_str());
     APSARA_TEST_GE_FATAL(processorInstance.mTotalProcessTimeMs->GetValue(), uint64_t(0));
+    APSARA_TEST_EQUAL_FATAL(1U, processorInstance.mProcessLatencyUs->GetCount());
 }
 
 void ProcessorParseJsonNativeUnittest::TestProcessJson() {
@@ -395,6 +396,7 @@ void ProcessorParseJsonNativeUnittest::TestProcessJson() {
     std::string outJson = eventGroupList[0].ToJsonString();
     APSARA_TEST_STREQ_FATAL(CompactJson(expectJson).c_str(), CompactJson(outJson).c_str());
     APSARA_TEST_GE_FATAL(processorInstance.mTotalProcessTimeMs->GetValue(), uint64_t(0));
+    APSARA_TEST_EQUAL_FATAL(1U, processorInstance.mProcessLatencyUs->GetCount());
 }
 
 void ProcessorParseJsonNativeUnittest::TestProcessJsonContent() {
@@ -486,6 +488,7 @@ void ProcessorParseJsonNativeUnittest::TestProcessJsonContent() {
     std::string outJson = eventGroupList[0].ToJsonString();
     APSARA_TEST_STREQ_FATAL(CompactJson(expectJson).c_str(), CompactJson(outJson).c_str());
     APSARA_TEST_GE_FATAL(processorInstance.mTotalProcessTimeMs->GetValue(), uint64_t(0));
+    APSARA_TEST_EQUAL_FATAL(1U, processorInstance.mProcessLatencyUs->GetCount());
 }
 
 void ProcessorParseJsonNativeUnittest::TestProcessJsonRaw() {
@@ -575,6 +578,7 @@ void ProcessorParseJsonNativeUnittest::TestProcessJsonRaw() {
     std::string outJson = eventGroupList[0].ToJsonString();
     APSARA_TEST_STREQ_FATAL(CompactJson(expectJson).c_str(), CompactJson(outJson).c_str());
     APSARA_TEST_GE_FATAL(processorInstance.mTotalProcessTimeMs->GetValue(), uint64_t(0));
+    APSARA_TEST_EQUAL_FATAL(1U, processorInstance.mProcessLatencyUs->GetCount());
 }
 
 void ProcessorParseJsonNativeUnittest::TestProcessEventKeepUnmatch() {
@@ -642,6 +646,7 @@ void ProcessorParseJsonNativeUnittest::TestProcessEventKeepUnmatch() {
     std::string outJson = eventGroupList[0].ToJsonString();
     APSARA_TEST_STREQ_FATAL(CompactJson(expectJson).c_str(), CompactJson(outJson).c_str());
     APSARA_TEST_GE_FATAL(processorInstance.mTotalProcessTimeMs->GetValue(), uint64_t(0));
+    APSARA_TEST_EQUAL_FATAL(1U, processorInstance.mProcessLatencyUs->GetCount());
 }
 
 void ProcessorParseJsonNativeUnittest::TestProcessEventDiscardUnmatch() {
@@ -696,6 +701,7 @@ void ProcessorParseJsonNativeUnittest::TestProcessEventDiscardUnmatch() {
     std::string outJson = eventGroupList[0].ToJsonString();
     APSARA_TEST_STREQ_FATAL("null", CompactJson(outJson).c_str());
     APSARA_TEST_GE_FATAL(processorInstance.mTotalProcessTimeMs->GetValue(), uint64_t(0));
+    APSARA_TEST_EQUAL_FATAL(1U, processorInstance.mProcessLatencyUs->GetCount());
 }
 
 } // namespace logtail
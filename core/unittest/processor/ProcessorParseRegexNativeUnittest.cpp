@@ -223,7 +223,8 @@ void ProcessorParseRegexNativeUnittest::TestProcessRegex() {
     })";
     std::string outJson = eventGroupList[0].ToJsonString();
     APSARA_TEST_STREQ_FATAL(CompactJson(expectJson).c_str(), CompactJson(outJson).c_str());
-    APSARA_TEST_GE_FATAL(processorInstance.mTotalProcessTimeMs->GetValue(), 0);
+    APSARA_TEST_GE_FATAL(processorInstance.mTotalProcessTimeMs->GetValue(), uint64_t(0));
+    APSARA_TEST_EQUAL_FATAL(1U, processorInstance.mProcessLatencyUs->GetCount());
 }
 
 void ProcessorParseRegexNativeUnittest::TestProcessRegexRaw() {
@@ -297,7 +298,8 @@ void ProcessorParseRegexNativeUnittest::TestProcessRegexRaw() {
     })";
     std::string outJson = eventGroupList[0].ToJsonString();
     APSARA_TEST_STREQ_FATAL(CompactJson(expectJson).c_str(), CompactJson(outJson).c_str());
-    APSARA_TEST_GE_FATAL(processorInstance.mTotalProcessTimeMs->GetValue(), 0);
+    APSARA_TEST_GE_FATAL(processorInstance.mTotalProcessTimeMs->GetValue(), uint64_t(0));
+    APSARA_TEST_EQUAL_FATAL(1U, processorInstance.mProcessLatencyUs->GetCount());
 }
 
 void ProcessorParseRegexNativeUnittest::TestProcessRegexContent() {
@@ -373,7 +375,8 @@ void ProcessorParseRegexNativeUnittest::TestProcessRegexContent() {
     })";
     std::string outJson = eventGroupList[0].ToJsonString();
     APSARA_TEST_STREQ_FATAL(CompactJson(expectJson).c_str(), CompactJson(outJson).c_str());
-    APSARA_TEST_GE_FATAL(processorInstance.mTotalProcessTimeMs->GetValue(), 0);
+    APSARA_TEST_GE_FATAL(processorInstance.mTotalProcessTimeMs->GetValue(), uint64_t(0));
+    APSARA_TEST_EQUAL_FATAL(1U, processorInstance.mProcessLatencyUs->GetCount());
 }
 
 void ProcessorParseRegexNativeUnittest::TestAddLog() {
@@ -34,6 +34,8 @@ public:
 
     void TestInit();
     void TestProcess();
+    void TestProcessParsedEvents();
+    void TestMergeHistogramAndSummary();
 
     PipelineContext mContext;
 };
@@ -129,8 +131,132 @@ void ProcessorParsePrometheusMetricUnittest::TestProcess() {
                       eventGroup.GetEvents().at(0).Cast<MetricEvent>().GetTimestamp());
 }
 
+void ProcessorParsePrometheusMetricUnittest::TestProcessParsedEvents() {
+    Json::Value config;
+    ProcessorPromParseMetricNative processor;
+    processor.SetContext(mContext);
+    string configStr = R"(
+        {
+            "job_name": "test_job"
+        }
+    )";
+    string errorMsg;
+    APSARA_TEST_TRUE(ParseJsonTable(configStr, config, errorMsg));
+    APSARA_TEST_TRUE(processor.Init(config));
+
+    // events parsed while receiving the scrape response are kept as they are
+    EventPool eventPool{true};
+    PromMetricResponseBody body(&eventPool);
+    string content = "# TYPE test_metric1 gauge\n"
+                     "test_metric1{k1=\"v1\", k2=\"v2\"} 1.0\n"
+                     "test_metric2{k1=\"v1\", k2=\"v2\"} 2.0 1234567890\n";
+    body.Append(content.data(), content.size());
+    auto& eventGroup = body.mEventGroup;
+    eventGroup.SetMetadata(EventGroupMetaKey::PROMETHEUS_SCRAPE_TIMESTAMP_MILLISEC, string("1715829785083"));
+    APSARA_TEST_EQUAL((size_t)2, eventGroup.GetEvents().size());
+    processor.Process(eventGroup);
+
+    APSARA_TEST_EQUAL((size_t)2, eventGroup.GetEvents().size());
+    APSARA_TEST_EQUAL("test_metric1", eventGroup.GetEvents().at(0).Cast<MetricEvent>().GetName());
+    APSARA_TEST_EQUAL("test_metric1", eventGroup.GetEvents().at(0).Cast<MetricEvent>().GetTag(prometheus::NAME));
+    APSARA_TEST_EQUAL("v2", eventGroup.GetEvents().at(0).Cast<MetricEvent>().GetTag("k2"));
+    APSARA_TEST_EQUAL("test_metric2", eventGroup.GetEvents().at(1).Cast<MetricEvent>().GetTag(prometheus::NAME));
+    APSARA_TEST_EQUAL(1234567890, eventGroup.GetEvents().at(1).Cast<MetricEvent>().GetTimestamp());
+    APSARA_TEST_EQUAL("2", eventGroup.GetMetadata(EventGroupMetaKey::PROMETHEUS_SAMPLES_SCRAPED));
+}
+
+void ProcessorParsePrometheusMetricUnittest::TestMergeHistogramAndSummary() {
+    Json::Value config;
+    ProcessorPromParseMetricNative processor;
+    processor.SetContext(mContext);
+    string configStr = R"(
+        {
+            "job_name": "test_job",
+            "merge_histogram_and_summary": true
+        }
+    )";
+    string errorMsg;
+    APSARA_TEST_TRUE(ParseJsonTable(configStr, config, errorMsg));
+    APSARA_TEST_TRUE(processor.Init(config));
+
+    EventPool eventPool{true};
+    PromMetricResponseBody body(&eventPool);
+    string content = "# TYPE latency histogram\n"
+                     "latency_bucket{path=\"/a\",le=\"0.5\"} 1\n"
+                     "latency_bucket{path=\"/a\",le=\"1\"} 3\n"
+                     "latency_bucket{path=\"/a\",le=\"+Inf\"} 4\n"
+                     "latency_sum{path=\"/a\"} 3.5\n"
+                     "latency_count{path=\"/a\"} 4\n"
+                     "latency_bucket{path=\"/b\",le=\"0.5\"} 0\n"
+                     "latency_bucket{path=\"/b\",le=\"1\"} 0\n"
+                     "latency_bucket{path=\"/b\",le=\"+Inf\"} 0\n"
+                     "latency_count{path=\"/b\"} 0\n"
+                     "latency_sum{path=\"/b\"} 0\n"
+                     "# TYPE rpc summary\n"
+                     "rpc{quantile=\"0.5\"} 2\n"
+                     "rpc{quantile=\"0.99\"} 8\n"
+                     "rpc_sum 10\n"
+                     "rpc_count 2\n"
+                     // _count is missing
+                     "size_bucket{le=\"+Inf\"} 1\n"
+                     "size_sum 1\n"
+                     // not formatted back to the same text
+                     "py_bucket{le=\"1.0\"} 1\n"
+                     "py_bucket{le=\"+Inf\"} 1\n"
+                     "py_sum 1\n"
+                     "py_count 1\n"
+                     "up 1\n";
+    body.Append(content.data(), content.size());
+    auto& eventGroup = body.mEventGroup;
+    eventGroup.SetMetadata(EventGroupMetaKey::PROMETHEUS_SCRAPE_TIMESTAMP_MILLISEC, string("1715829785083"));
+    processor.Process(eventGroup);
+
+    APSARA_TEST_EQUAL("21", eventGroup.GetMetadata(EventGroupMetaKey::PROMETHEUS_SAMPLES_SCRAPED));
+    const auto& events = eventGroup.GetEvents();
+    APSARA_TEST_EQUAL((size_t)10, events.size());
+
+    const auto& h1 = events[0].Cast<MetricEvent>();
+    APSARA_TEST_EQUAL("latency", h1.GetName());
+    APSARA_TEST_EQUAL("latency", h1.GetTag(prometheus::NAME));
+    APSARA_TEST_EQUAL("/a", h1.GetTag("path"));
+    APSARA_TEST_FALSE(h1.HasTag("le"));
+    APSARA_TEST_TRUE(h1.Is<HistogramValue>());
+    const auto* v1 = h1.GetValue<HistogramValue>();
+    APSARA_TEST_EQUAL(3.5, v1->mSum);
+    APSARA_TEST_EQUAL(4.0, v1->mCount);
+    APSARA_TEST_EQUAL((size_t)3, v1->mBuckets.size());
+    APSARA_TEST_EQUAL(0.5, v1->mBuckets[0].mUpperBound);
+    APSARA_TEST_EQUAL(1.0, v1->mBuckets[0].mCount);
+    APSARA_TEST_EQUAL(3.0, v1->mBuckets[1].mCount);
+    APSARA_TEST_TRUE(isinf(v1->mBuckets[2].mUpperBound));
+
+    const auto& h2 = events[1].Cast<MetricEvent>();
+    APSARA_TEST_EQUAL("/b", h2.GetTag("path"));
+    APSARA_TEST_TRUE(h2.Is<HistogramValue>());
+
+    const auto& s = events[2].Cast<MetricEvent>();
+    APSARA_TEST_EQUAL("rpc", s.GetName());
+    APSARA_TEST_FALSE(s.HasTag("quantile"));
+    APSARA_TEST_TRUE(s.Is<SummaryValue>());
+    const auto* sv = s.GetValue<SummaryValue>();
+    APSARA_TEST_EQUAL(10.0, sv->mSum);
+    APSARA_TEST_EQUAL(2.0, sv->mCount);
+    APSARA_TEST_EQUAL((size_t)2, sv->mQuantiles.size());
+    APSARA_TEST_EQUAL(0.99, sv->mQuantiles[1].mQuantile);
+    APSARA_TEST_EQUAL(8.0, sv->mQuantiles[1].mValue);
+
+    vector<string> names = {"size_bucket", "size_sum", "py_bucket", "py_bucket", "py_sum", "py_count", "up"};
+    for (size_t i = 0; i < names.size(); ++i) {
+        const auto& e = events[i + 3].Cast<MetricEvent>();
+        APSARA_TEST_EQUAL(names[i], e.GetName().to_string());
+        APSARA_TEST_TRUE(e.Is<UntypedSingleValue>());
+    }
+}
+
 UNIT_TEST_CASE(ProcessorParsePrometheusMetricUnittest, TestInit)
 UNIT_TEST_CASE(ProcessorParsePrometheusMetricUnittest, TestProcess)
+UNIT_TEST_CASE(ProcessorParsePrometheusMetricUnittest, TestProcessParsedEvents)
+UNIT_TEST_CASE(ProcessorParsePrometheusMetricUnittest, TestMergeHistogramAndSummary)
 
 } // namespace logtail
 
@@ -263,14 +263,14 @@ test_metric8{k1="v1", k3="v2", } 9.9410452992e+10 1715829785083
     auto targetTags = eventGroup.GetTags();
     auto toDelete = processor.GetToDeleteTargetLabels(targetTags);
     // honor_labels is true
-    processor.ProcessEvent(eventGroup.MutableEvents()[0], targetTags, toDelete);
+    processor.ProcessEvent(eventGroup.MutableEvents()[0], targetTags, toDelete, nullptr);
     APSARA_TEST_EQUAL("v3", eventGroup.GetEvents().at(0).Cast<MetricEvent>().GetTag(string("k3")));
-    processor.ProcessEvent(eventGroup.MutableEvents()[6], targetTags, toDelete);
+    processor.ProcessEvent(eventGroup.MutableEvents()[6], targetTags, toDelete, nullptr);
     APSARA_TEST_EQUAL("2", eventGroup.GetEvents().at(6).Cast<MetricEvent>().GetTag(string("k3")).to_string());
 
     // honor_labels is false
     processor.mScrapeConfigPtr->mHonorLabels = false;
-    processor.ProcessEvent(eventGroup.MutableEvents()[7], targetTags, toDelete);
+    processor.ProcessEvent(eventGroup.MutableEvents()[7], targetTags, toDelete, nullptr);
     APSARA_TEST_EQUAL("v3", eventGroup.GetEvents().at(7).Cast<MetricEvent>().GetTag(string("k3")).to_string());
     APSARA_TEST_EQUAL("v2", eventGroup.GetEvents().at(7).Cast<MetricEvent>().GetTag(string("exported_k3")).to_string());
 }
@@ -0,0 +1,263 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <json/json.h>
+
+#include <string>
+
+#include "common/Flags.h"
+#include "common/JsonUtil.h"
+#include "models/PipelineEventGroup.h"
+#include "prometheus/labels/RelabelCache.h"
+#include "unittest/Unittest.h"
+
+DECLARE_FLAG_INT32(prom_relabel_cache_max_series_per_target);
+DECLARE_FLAG_INT32(prom_relabel_cache_target_expire_secs);
+
+using namespace std;
+
+namespace logtail {
+
+class RelabelCacheUnittest : public testing::Test {
+public:
+    void TestProcess();
+    void TestDrop();
+    void TestEndScrape();
+    void TestHashCollision();
+    void TestCacheFull();
+    void TestStringPool();
+    void TestTargetExpire();
+
+protected:
+    void SetUp() override {
+        string configStr = R"JSON(
+            [
+                {
+                    "action": "drop",
+                    "regex": "drop_.*",
+                    "source_labels": ["__name__"]
+                },
+                {
+                    "action": "replace",
+                    "regex": "(.*)",
+                    "replacement": "${1}:9100",
+                    "source_labels": ["instance"],
+                    "target_label": "address"
+                },
+                {
+                    "action": "labeldrop",
+                    "regex": "tmp"
+                },
+                {
+                    "action": "replace",
+                    "regex": "(.*)",
+                    "replacement": "${1}",
+                    "source_labels": ["job"],
+                    "target_label": "__tmp_job"
+                }
+            ]
+        )JSON";
+        Json::Value configJson;
+        string errorMsg;
+        APSARA_TEST_TRUE(ParseJsonTable(configStr, configJson, errorMsg));
+        APSARA_TEST_TRUE(mConfigs.Init(configJson));
+    }
+
+    void TearDown() override {
+        INT32_FLAG(prom_relabel_cache_max_series_per_target) = 200000;
+        INT32_FLAG(prom_relabel_cache_target_expire_secs) = 600;
+    }
+
+    MetricEvent* AddEvent(PipelineEventGroup& group, const string& name, const string& instance) {
+        auto e = group.AddMetricEvent();
+        e->SetName(name);
+        e->SetTag(string("instance"), instance);
+        e->SetTag(string("job"), string("node"));
+        e->SetTag(string("tmp"), string("v"));
+        return e;
+    }
+
+    static map<string, string> GetTags(const MetricEvent& e) {
+        map<string, string> res;
+        for (auto it = e.TagsBegin(); it != e.TagsEnd(); ++it) {
+            res.emplace(it->first.to_string(), it->second.to_string());
+        }
+        return res;
+    }
+
+    RelabelConfigList mConfigs;
+};
+
+void RelabelCacheUnittest::TestProcess() {
+    LabelStringPool pool;
+    SeriesRelabelCache cache(pool);
+    for (int round = 0; round < 3; ++round) {
+        PipelineEventGroup group(make_shared<SourceBuffer>());
+        auto e1 = AddEvent(group, "up", "127.0.0.1");
+        auto e2 = AddEvent(group, "up", "127.0.0.2");
+        auto e3 = AddEvent(group, "up", "127.0.0.1");
+
+        vector<string> toDelete1, toDelete2, toDelete3;
+        APSARA_TEST_TRUE(cache.Process(mConfigs, *e1, toDelete1));
+        APSARA_TEST_TRUE(cache.Process(mConfigs, *e2, toDelete2));
+        APSARA_TEST_TRUE(cache.Process(mConfigs, *e3, toDelete3));
+        cache.EndScrape();
+        APSARA_TEST_EQUAL(2U, cache.Size());
+
+        // the outcome must be the same as running the rules directly
+        auto expected = AddEvent(group, "up", "127.0.0.1");
+        vector<string> expectedToDelete;
+        APSARA_TEST_TRUE(mConfigs.Process(*expected, expectedToDelete));
+        APSARA_TEST_EQUAL(GetTags(*expected), GetTags(*e1));
+        APSARA_TEST_EQUAL(GetTags(*expected), GetTags(*e3));
+        APSARA_TEST_EQUAL(expectedToDelete, toDelete1);
+        APSARA_TEST_EQUAL(expectedToDelete, toDelete3);
+        APSARA_TEST_EQUAL("127.0.0.1:9100", e1->GetTag(string("address")).to_string());
+        APSARA_TEST_FALSE(e1->HasTag(string("tmp")));
+        APSARA_TEST_EQUAL("127.0.0.2:9100", e2->GetTag(string("address")).to_string());
+    }
+}
+
+void RelabelCacheUnittest::TestDrop() {
+    LabelStringPool pool;
+    SeriesRelabelCache cache(pool);
+    for (int round = 0; round < 2; ++round) {
+        PipelineEventGroup group(make_shared<SourceBuffer>());
+        auto e = AddEvent(group, "drop_me", "127.0.0.1");
+        vector<string> toDelete;
+        APSARA_TEST_FALSE(cache.Process(mConfigs, *e, toDelete));
+        APSARA_TEST_TRUE(toDelete.empty());
+        cache.EndScrape();
+    }
+    APSARA_TEST_EQUAL(1U, cache.Size());
+    APSARA_TEST_TRUE(cache.mSeries.begin()->second.mDropped);
+}
+
+void RelabelCacheUnittest::TestEndScrape() {
+    LabelStringPool pool;
+    SeriesRelabelCache cache(pool);
+    {
+        PipelineEventGroup group(make_shared<SourceBuffer>());
+        vector<string> toDelete;
+        cache.Process(mConfigs, *AddEvent(group, "up", "127.0.0.1"), toDelete);
+        cache.Process(mConfigs, *AddEvent(group, "up", "127.0.0.2"), toDelete);
+        cache.EndScrape();
+        APSARA_TEST_EQUAL(2U, cache.Size());
+    }
+    {
+        // series disappeared from the scrape are evicted
+        PipelineEventGroup group(make_shared<SourceBuffer>());
+        vector<string> toDelete;
+        cache.Process(mConfigs, *AddEvent(group, "up", "127.0.0.2"), toDelete);
+        cache.EndScrape();
+        APSARA_TEST_EQUAL(1U, cache.Size());
+        APSARA_TEST_EQUAL(1U, cache.mSeries.count(SeriesRelabelCache::HashLabels(*AddEvent(group, "up", "127.0.0.2"))));
+    }
+}
+
+void RelabelCacheUnittest::TestHashCollision() {
+    LabelStringPool pool;
+    SeriesRelabelCache cache(pool);
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    vector<string> toDelete;
+    auto e1 = AddEvent(group, "up", "127.0.0.1");
+    uint64_t hash1 = SeriesRelabelCache::HashLabels(*e1);
+    APSARA_TEST_FALSE(cache.Process(mConfigs, *AddEvent(group, "drop_me", "127.0.0.2"), toDelete));
+    // pretend the dropped series has the same hash as e1
+    auto node = cache.mSeries.extract(cache.mSeries.begin());
+    node.key() = hash1;
+    cache.mSeries.insert(std::move(node));
+
+    toDelete.clear();
+    APSARA_TEST_TRUE(cache.Process(mConfigs, *e1, toDelete));
+    APSARA_TEST_EQUAL("127.0.0.1:9100", e1->GetTag(string("address")).to_string());
+    APSARA_TEST_FALSE(e1->HasTag(string("tmp")));
+    APSARA_TEST_EQUAL(1U, cache.Size());
+    APSARA_TEST_TRUE(cache.mSeries[hash1].mDropped);
+}
+
+void RelabelCacheUnittest::TestCacheFull() {
+    INT32_FLAG(prom_relabel_cache_max_series_per_target) = 1;
+    LabelStringPool pool;
+    SeriesRelabelCache cache(pool);
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    vector<string> toDelete;
+    APSARA_TEST_TRUE(cache.Process(mConfigs, *AddEvent(group, "up", "127.0.0.1"), toDelete));
+    auto e = AddEvent(group, "up", "127.0.0.2");
+    APSARA_TEST_TRUE(cache.Process(mConfigs, *e, toDelete));
+    APSARA_TEST_EQUAL("127.0.0.2:9100", e->GetTag(string("address")).to_string());
+    APSARA_TEST_EQUAL(1U, cache.Size());
+
+    INT32_FLAG(prom_relabel_cache_max_series_per_target) = 0;
+    SeriesRelabelCache disabled(pool);
+    APSARA_TEST_TRUE(disabled.Process(mConfigs, *AddEvent(group, "up", "127.0.0.1"), toDelete));
+    APSARA_TEST_EQUAL(0U, disabled.Size());
+}
+
+void RelabelCacheUnittest::TestStringPool() {
+    LabelStringPool pool;
+    auto s1 = pool.Intern(StringView("127.0.0.1:9100"));
+    auto s2 = pool.Intern(StringView(string("127.0.0.1:9100")));
+    APSARA_TEST_EQUAL(s1.get(), s2.get());
+    APSARA_TEST_EQUAL(1U, pool.Size());
+
+    {
+        SeriesRelabelCache cache(pool);
+        PipelineEventGroup group(make_shared<SourceBuffer>());
+        vector<string> toDelete;
+        cache.Process(mConfigs, *AddEvent(group, "up", "127.0.0.1"), toDelete);
+        cache.Process(mConfigs, *AddEvent(group, "up", "127.0.0.2"), toDelete);
+        // up, instance, job, node, tmp, v, __name__, address and __tmp_job are shared by both series, plus one
+        // instance value and one address value each
+        APSARA_TEST_EQUAL(13U, pool.Size());
+    }
+    pool.Compact();
+    APSARA_TEST_EQUAL(1U, pool.Size());
+    s1.reset();
+    s2.reset();
+    pool.Compact();
+    APSARA_TEST_EQUAL(0U, pool.Size());
+}
+
+void RelabelCacheUnittest::TestTargetExpire() {
+    INT32_FLAG(prom_relabel_cache_target_expire_secs) = 100;
+    RelabelCache cache;
+    auto [c1, m1] = cache.GetSeriesCache(1);
+    auto [c2, m2] = cache.GetSeriesCache(2);
+    auto [c3, m3] = cache.GetSeriesCache(1);
+    APSARA_TEST_EQUAL(c1.get(), c3.get());
+    APSARA_TEST_EQUAL(m1.get(), m3.get());
+    APSARA_TEST_NOT_EQUAL(c1.get(), c2.get());
+    APSARA_TEST_EQUAL(2U, cache.Size());
+
+    cache.mTargetCaches[2].mLastUsedTime -= 100;
+    cache.mLastClearTime -= 10;
+    cache.GetSeriesCache(1);
+    APSARA_TEST_EQUAL(1U, cache.Size());
+    APSARA_TEST_EQUAL(1U, cache.mTargetCaches.count(1));
+}
+
+UNIT_TEST_CASE(RelabelCacheUnittest, TestProcess)
+UNIT_TEST_CASE(RelabelCacheUnittest, TestDrop)
+UNIT_TEST_CASE(RelabelCacheUnittest, TestEndScrape)
+UNIT_TEST_CASE(RelabelCacheUnittest, TestHashCollision)
+UNIT_TEST_CASE(RelabelCacheUnittest, TestCacheFull)
+UNIT_TEST_CASE(RelabelCacheUnittest, TestStringPool)
+UNIT_TEST_CASE(RelabelCacheUnittest, TestTargetExpire)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -110,9 +110,12 @@ void ScrapeSchedulerUnittest::TestProcess() {
                    "go_memstats_alloc_bytes_total 1.5159292e+08";
     PromMetricWriteCallback(
         body1.data(), (size_t)1, (size_t)body1.length(), (void*)httpResponse.GetBody<PromMetricResponseBody>());
-    event.OnMetricResult(httpResponse, 0);
+    event.OnMetricResult(httpResponse, 1715829785083);
     APSARA_TEST_EQUAL(1UL, event.mItem.size());
     APSARA_TEST_EQUAL(11UL, event.mItem[0]->mEventGroup.GetEvents().size());
+    APSARA_TEST_TRUE(event.mItem[0]->mEventGroup.GetEvents()[0].Is<MetricEvent>());
+    APSARA_TEST_EQUAL(1715829785, event.mItem[0]->mEventGroup.GetEvents()[0]->GetTimestamp());
+    APSARA_TEST_EQUAL(83000000U, event.mItem[0]->mEventGroup.GetEvents()[0]->GetTimestampNanosecond().value());
 }
 
 void ScrapeSchedulerUnittest::TestStreamMetricWriteCallback() {
@@ -154,28 +157,35 @@ void ScrapeSchedulerUnittest::TestStreamMetricWriteCallback() {
         body1.data(), (size_t)1, (size_t)body1.length(), (void*)httpResponse.GetBody<PromMetricResponseBody>());
     auto& res = httpResponse.GetBody<PromMetricResponseBody>()->mEventGroup;
     APSARA_TEST_EQUAL(7UL, res.GetEvents().size());
-    APSARA_TEST_EQUAL("go_gc_duration_seconds{quantile=\"0\"} 1.5531e-05",
-                      res.GetEvents()[0].Cast<RawEvent>().GetContent());
-    APSARA_TEST_EQUAL("go_gc_duration_seconds{quantile=\"0.25\"} 3.9357e-05",
-                      res.GetEvents()[1].Cast<RawEvent>().GetContent());
-    APSARA_TEST_EQUAL("go_gc_duration_seconds{quantile=\"0.5\"} 4.1114e-05",
-                      res.GetEvents()[2].Cast<RawEvent>().GetContent());
-    APSARA_TEST_EQUAL("go_gc_duration_seconds{quantile=\"0.75\"} 4.3372e-05",
-                      res.GetEvents()[3].Cast<RawEvent>().GetContent());
-    APSARA_TEST_EQUAL("go_gc_duration_seconds{quantile=\"1\"} 0.000112326",
-                      res.GetEvents()[4].Cast<RawEvent>().GetContent());
-    APSARA_TEST_EQUAL("go_gc_duration_seconds_sum 0.034885631", res.GetEvents()[5].Cast<RawEvent>().GetContent());
-    APSARA_TEST_EQUAL("go_gc_duration_seconds_count 850", res.GetEvents()[6].Cast<RawEvent>().GetContent());
+    APSARA_TEST_EQUAL("go_gc_duration_seconds", res.GetEvents()[0].Cast<MetricEvent>().GetName());
+    APSARA_TEST_EQUAL("0", res.GetEvents()[0].Cast<MetricEvent>().GetTag("quantile"));
+    APSARA_TEST_EQUAL(1.5531e-05, res.GetEvents()[0].Cast<MetricEvent>().GetValue<UntypedSingleValue>()->mValue);
+    APSARA_TEST_EQUAL("0.25", res.GetEvents()[1].Cast<MetricEvent>().GetTag("quantile"));
+    APSARA_TEST_EQUAL("0.5", res.GetEvents()[2].Cast<MetricEvent>().GetTag("quantile"));
+    APSARA_TEST_EQUAL("0.75", res.GetEvents()[3].Cast<MetricEvent>().GetTag("quantile"));
+    APSARA_TEST_EQUAL("1", res.GetEvents()[4].Cast<MetricEvent>().GetTag("quantile"));
+    APSARA_TEST_EQUAL(0.000112326, res.GetEvents()[4].Cast<MetricEvent>().GetValue<UntypedSingleValue>()->mValue);
+    APSARA_TEST_EQUAL("go_gc_duration_seconds_sum", res.GetEvents()[5].Cast<MetricEvent>().GetName());
+    APSARA_TEST_EQUAL("go_gc_duration_seconds_count", res.GetEvents()[6].Cast<MetricEvent>().GetName());
+    APSARA_TEST_EQUAL(850.0, res.GetEvents()[6].Cast<MetricEvent>().GetValue<UntypedSingleValue>()->mValue);
     // httpResponse.GetBody<MetricResponseBody>()->mEventGroup = PipelineEventGroup(std::make_shared<SourceBuffer>());
     PromMetricWriteCallback(
         body2.data(), (size_t)1, (size_t)body2.length(), (void*)httpResponse.GetBody<PromMetricResponseBody>());
     httpResponse.GetBody<PromMetricResponseBody>()->FlushCache();
     APSARA_TEST_EQUAL(11UL, res.GetEvents().size());
 
-    APSARA_TEST_EQUAL("go_goroutines 7", res.GetEvents()[7].Cast<RawEvent>().GetContent());
-    APSARA_TEST_EQUAL("go_info{version=\"go1.22.3\"} 1", res.GetEvents()[8].Cast<RawEvent>().GetContent());
-    APSARA_TEST_EQUAL("go_memstats_alloc_bytes 6.742688e+06", res.GetEvents()[9].Cast<RawEvent>().GetContent());
-    APSARA_TEST_EQUAL("go_memstats_alloc_bytes_total 1.5159292e+08", res.GetEvents()[10].Cast<RawEvent>().GetContent());
+    // line split across chunks
+    APSARA_TEST_EQUAL("go_goroutines", res.GetEvents()[7].Cast<MetricEvent>().GetName());
+    APSARA_TEST_EQUAL(7.0, res.GetEvents()[7].Cast<MetricEvent>().GetValue<UntypedSingleValue>()->mValue);
+    APSARA_TEST_EQUAL("go_info", res.GetEvents()[8].Cast<MetricEvent>().GetName());
+    APSARA_TEST_EQUAL("go1.22.3", res.GetEvents()[8].Cast<MetricEvent>().GetTag("version"));
+    APSARA_TEST_EQUAL("go_memstats_alloc_bytes", res.GetEvents()[9].Cast<MetricEvent>().GetName());
+    APSARA_TEST_EQUAL(6.742688e+06, res.GetEvents()[9].Cast<MetricEvent>().GetValue<UntypedSingleValue>()->mValue);
+    // last line without line feed
+    APSARA_TEST_EQUAL("go_memstats_alloc_bytes_total", res.GetEvents()[10].Cast<MetricEvent>().GetName());
+    APSARA_TEST_EQUAL(1.5159292e+08, res.GetEvents()[10].Cast<MetricEvent>().GetValue<UntypedSingleValue>()->mValue);
+    // timestamps are set when the response is done
+    APSARA_TEST_EQUAL(0, res.GetEvents()[10].Cast<MetricEvent>().GetTimestamp());
 }
 
 void ScrapeSchedulerUnittest::TestReceiveMessage() {
@@ -202,7 +212,7 @@ void ScrapeSchedulerUnittest::TestScheduler() {
     event.SetComponent(timer, &eventPool);
     event.ScheduleNext();
 
-    APSARA_TEST_TRUE(timer->mQueue.size() == 1);
+    APSARA_TEST_TRUE(timer->mQueue.Size() == 1);
 
     event.Cancel();
 
@@ -223,16 +233,20 @@ void ScrapeSchedulerUnittest::TestQueueIsFull() {
     event.SetFirstExecTime(now);
     event.ScheduleNext();
 
-    APSARA_TEST_TRUE(timer->mQueue.size() == 1);
+    APSARA_TEST_TRUE(timer->mQueue.Size() == 1);
 
-    const auto& e = timer->mQueue.top();
+    vector<unique_ptr<TimerEvent>> events;
+    timer->mQueue.Advance(now, events);
+    APSARA_TEST_EQUAL(1UL, events.size());
+    const auto& e = events[0];
     APSARA_TEST_EQUAL(now, e->GetExecTime());
     APSARA_TEST_FALSE(e->IsValid());
-    timer->mQueue.pop();
     // queue is full, so it should schedule next after 1 second
-    APSARA_TEST_EQUAL(1UL, timer->mQueue.size());
-    const auto& next = timer->mQueue.top();
-    APSARA_TEST_EQUAL(now + std::chrono::seconds(1), next->GetExecTime());
+    APSARA_TEST_EQUAL(1UL, timer->mQueue.Size());
+    events.clear();
+    timer->mQueue.Advance(now + std::chrono::seconds(1), events);
+    APSARA_TEST_EQUAL(1UL, events.size());
+    APSARA_TEST_EQUAL(now + std::chrono::seconds(1), events[0]->GetExecTime());
 }
 
 UNIT_TEST_CASE(ScrapeSchedulerUnittest, TestInitscrapeScheduler)
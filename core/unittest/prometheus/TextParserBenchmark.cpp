@@ -17,6 +17,7 @@
 #include <string>
 
 #include "prometheus/labels/TextParser.h"
+#include "prometheus/schedulers/ScrapeScheduler.h"
 #include "unittest/Unittest.h"
 
 using namespace std;
@@ -27,6 +28,8 @@ class TextParserBenchmark : public testing::Test {
 public:
     void TestParse100M() const;
     void TestParse1000M() const;
+    void TestParseKubeStateMetrics() const;
+    void TestStreamParseKubeStateMetrics() const;
 
 protected:
     void SetUp() override {
@@ -44,6 +47,25 @@ protected:
             m1000MData += mRawData;
             repeatCnt -= 1;
         }
+
+        // kube-state-metrics like payload of 32MB: few metric families, many series with long label sets
+        const size_t ksmSize = 32 * 1024 * 1024;
+        mKsmData.reserve(ksmSize + 4096);
+        for (size_t pod = 0; mKsmData.size() < ksmSize; ++pod) {
+            string podLabels = "namespace=\"namespace-" + to_string(pod % 100) + "\",pod=\"deployment-" + to_string(pod)
+                + "-7d9f8b6c5d-x2k4p\",uid=\"3f1c2a4e-8b7d-4c6e-9a1f-" + to_string(100000000000 + pod) + "\"";
+            mKsmData += "# HELP kube_pod_info Information about pod.\n# TYPE kube_pod_info gauge\n";
+            mKsmData += "kube_pod_info{" + podLabels
+                + ",host_ip=\"10.0.0.1\",pod_ip=\"172.16.0.1\",node=\"cn-hangzhou.10.0.0.1\",created_by_kind=\"ReplicaSet\","
+                  "created_by_name=\"deployment-7d9f8b6c5d\",priority_class=\"\",host_network=\"false\"} 1\n";
+            for (const char* phase : {"Pending", "Succeeded", "Failed", "Unknown", "Running"}) {
+                mKsmData += "kube_pod_status_phase{" + podLabels + ",phase=\"" + phase + "\"} "
+                    + (string(phase) == "Running" ? "1" : "0") + "\n";
+            }
+            mKsmData += "kube_pod_container_resource_requests{" + podLabels
+                + ",container=\"app\",node=\"cn-hangzhou.10.0.0.1\",resource=\"cpu\",unit=\"core\"} 0.25\n";
+            mKsmData += "kube_pod_created{" + podLabels + "} 1.715829785e+09\n";
+        }
     }
 
 private:
@@ -59,6 +81,7 @@ test_metric8{k1="v1", k2="v2", } 9.9410452992e+10 1715829785083
 )""";
     std::string m100MData;
     std::string m1000MData;
+    std::string mKsmData;
 };
 
 void TextParserBenchmark::TestParse100M() const {
@@ -87,8 +110,40 @@ void TextParserBenchmark::TestParse1000M() const {
     // elapsed: 4960MB in release mode
 }
 
+void TextParserBenchmark::TestParseKubeStateMetrics() const {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    TextParser parser;
+    auto res = parser.Parse(mKsmData, 0, 0);
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed = end - start;
+    cout << "events: " << res.GetEvents().size() << ", elapsed: " << elapsed.count() << " seconds" << endl;
+}
+
+void TextParserBenchmark::TestStreamParseKubeStateMetrics() const {
+    // same payload fed in the chunk size of curl
+    const size_t chunkSize = 16 * 1024;
+    auto start = std::chrono::high_resolution_clock::now();
+
+    EventPool eventPool{true};
+    PromMetricResponseBody body(&eventPool);
+    for (size_t pos = 0; pos < mKsmData.size(); pos += chunkSize) {
+        string_view chunk = string_view(mKsmData).substr(pos, chunkSize);
+        PromMetricWriteCallback(const_cast<char*>(chunk.data()), 1, chunk.size(), &body);
+    }
+    body.FlushCache();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed = end - start;
+    cout << "events: " << body.mEventGroup.GetEvents().size() << ", elapsed: " << elapsed.count() << " seconds"
+         << endl;
+}
+
 UNIT_TEST_CASE(TextParserBenchmark, TestParse100M)
 UNIT_TEST_CASE(TextParserBenchmark, TestParse1000M)
+UNIT_TEST_CASE(TextParserBenchmark, TestParseKubeStateMetrics)
+UNIT_TEST_CASE(TextParserBenchmark, TestStreamParseKubeStateMetrics)
 
 } // namespace logtail
 
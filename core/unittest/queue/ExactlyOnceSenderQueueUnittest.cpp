@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <chrono>
+
 #include "plugin/flusher/sls/FlusherSLS.h"
 #include "pipeline/queue/ExactlyOnceSenderQueue.h"
 #include "pipeline/queue/SLSSenderQueueItem.h"
@@ -136,40 +138,40 @@ void ExactlyOnceSenderQueueUnittest::TestGetAvailableItems() {
     }
     {
         // with limits, limited by concurrency limiter
-        mQueue->mRateLimiter->mMaxSendBytesPerSecond = 100;
+        // freeze the clock so that no tokens are refilled while fetching
+        mQueue->mRateLimiter->mClock = []() { return chrono::steady_clock::time_point(); };
+        mQueue->mRateLimiter->SetMaxRate(100);
         mQueue->mConcurrencyLimiters[0].first->SetCurrentLimit(1);
         mQueue->mConcurrencyLimiters[0].first->SetInSendingCount(0);
         vector<SenderQueueItem*> items;
         mQueue->GetAvailableItems(items, 80);
         APSARA_TEST_EQUAL(1U, items.size());
-        APSARA_TEST_EQUAL(sDataSize, mQueue->mRateLimiter->mLastSecondTotalBytes);
+        APSARA_TEST_EQUAL(100.0 - sDataSize, mQueue->mRateLimiter->mTokens);
         APSARA_TEST_EQUAL(1U, mQueue->mConcurrencyLimiters[0].first->GetInSendingCount());
         for (auto& item : items) {
             item->mStatus = SendingStatus::IDLE;
         }
-        mQueue->mRateLimiter->mLastSecondTotalBytes = 0;
     }
     {
         // with limits, limited by rate limiter
-        mQueue->mRateLimiter->mMaxSendBytesPerSecond = 5;
+        mQueue->mRateLimiter->SetMaxRate(5);
         mQueue->mConcurrencyLimiters[0].first->SetCurrentLimit(3);
         mQueue->mConcurrencyLimiters[0].first->SetInSendingCount(0);
         vector<SenderQueueItem*> items;
         mQueue->GetAvailableItems(items, 80);
         APSARA_TEST_EQUAL(1U, items.size());
-        APSARA_TEST_EQUAL(sDataSize, mQueue->mRateLimiter->mLastSecondTotalBytes);
+        APSARA_TEST_EQUAL(5.0 - sDataSize, mQueue->mRateLimiter->mTokens);
         APSARA_TEST_EQUAL(1U, mQueue->mConcurrencyLimiters[0].first->GetInSendingCount());
-        mQueue->mRateLimiter->mLastSecondTotalBytes = 0;
     }
     {
         // with limits, does not work
-        mQueue->mRateLimiter->mMaxSendBytesPerSecond = 100;
+        mQueue->mRateLimiter->SetMaxRate(100);
         mQueue->mConcurrencyLimiters[0].first->SetCurrentLimit(3);
         mQueue->mConcurrencyLimiters[0].first->SetInSendingCount(0);
         vector<SenderQueueItem*> items;
         mQueue->GetAvailableItems(items, 80);
         APSARA_TEST_EQUAL(1U, items.size());
-        APSARA_TEST_EQUAL(sDataSize, mQueue->mRateLimiter->mLastSecondTotalBytes);
+        APSARA_TEST_EQUAL(100.0 - sDataSize, mQueue->mRateLimiter->mTokens);
         APSARA_TEST_EQUAL(1U, mQueue->mConcurrencyLimiters[0].first->GetInSendingCount());
     }
 }
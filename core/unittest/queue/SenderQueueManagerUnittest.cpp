@@ -21,6 +21,7 @@
 #include "unittest/Unittest.h"
 
 DECLARE_FLAG_INT32(sender_queue_gc_threshold_sec);
+DECLARE_FLAG_INT32(sender_queue_drr_quantum_bytes);
 
 using namespace std;
 
@@ -33,6 +34,7 @@ public:
     void TestGetQueue();
     void TestPushQueue();
     void TestGetAvailableItems();
+    void TestGetAvailableItemsWithPriorityAndWeight();
     void TestRemoveItem();
     void TestIsAllQueueEmpty();
 
@@ -103,6 +105,8 @@ void SenderQueueManagerUnittest::TestCreateQueue() {
         //APSARA_TEST_EQUAL(sConcurrencyLimiter, queue.mConcurrencyLimiters[0]);
         APSARA_TEST_TRUE(queue.mRateLimiter.has_value());
         APSARA_TEST_EQUAL(maxRate, queue.mRateLimiter->mMaxSendBytesPerSecond);
+        APSARA_TEST_EQUAL(1U, queue.mRateLimiters.size());
+        APSARA_TEST_EQUAL(sManager->mGlobalRateLimiter, queue.mRateLimiters[0].first);
     }
     {
         // resued queue
@@ -229,6 +233,45 @@ void SenderQueueManagerUnittest::TestGetAvailableItems() {
     }
 }
 
+void SenderQueueManagerUnittest::TestGetAvailableItemsWithPriorityAndWeight() {
+    INT32_FLAG(sender_queue_drr_quantum_bytes) = 1;
+    vector<vector<SenderQueueItem*>> queueItems(3);
+    for (QueueKey key = 0; key < 3; ++key) {
+        sManager->CreateQueue(key, sFlusherId, sCtx);
+        for (size_t i = 0; i < sManager->mDefaultQueueParam.GetCapacity(); ++i) {
+            auto item = GenerateItem();
+            queueItems[key].emplace_back(item.get());
+            sManager->PushQueue(key, std::move(item));
+        }
+    }
+    sManager->mQueues.at(0).SetSchedulingParam(1, 2);
+    sManager->mQueues.at(1).SetSchedulingParam(1, 1);
+    sManager->mQueues.at(2).SetSchedulingParam(3, 1);
+    {
+        // queues with higher priority are served first
+        vector<SenderQueueItem*> items;
+        sManager->GetAvailableItems(items, 4);
+        APSARA_TEST_EQUAL(4U, items.size());
+        for (auto& item : items) {
+            APSARA_TEST_TRUE(find(queueItems[0].begin(), queueItems[0].end(), item) == queueItems[0].end());
+            item->mStatus = SendingStatus::IDLE;
+        }
+    }
+    {
+        // queues with the same priority share the window according to their weights, each item needs credits of 7
+        // rounds for queue 1 and 3 rounds for queue 2, so queue 2 gets both of its items first
+        sManager->mQueues.at(1).mDeficitBytes = 0;
+        sManager->mQueues.at(2).mDeficitBytes = 0;
+        vector<SenderQueueItem*> items;
+        sManager->GetAvailableItems(items, 2);
+        APSARA_TEST_EQUAL(2U, items.size());
+        for (auto& item : items) {
+            APSARA_TEST_TRUE(find(queueItems[2].begin(), queueItems[2].end(), item) != queueItems[2].end());
+        }
+    }
+    INT32_FLAG(sender_queue_drr_quantum_bytes) = 256 * 1024;
+}
+
 void SenderQueueManagerUnittest::TestRemoveItem() {
     sManager->CreateQueue(0, sFlusherId, sCtx, {{"region", sConcurrencyLimiter}}, sMaxRate);
     ExactlyOnceQueueManager::GetInstance()->CreateOrUpdateQueue(1, 0, sCtx, sCheckpoints);
@@ -298,6 +341,7 @@ UNIT_TEST_CASE(SenderQueueManagerUnittest, TestDeleteQueue)
 UNIT_TEST_CASE(SenderQueueManagerUnittest, TestGetQueue)
 UNIT_TEST_CASE(SenderQueueManagerUnittest, TestPushQueue)
 UNIT_TEST_CASE(SenderQueueManagerUnittest, TestGetAvailableItems)
+UNIT_TEST_CASE(SenderQueueManagerUnittest, TestGetAvailableItemsWithPriorityAndWeight)
 UNIT_TEST_CASE(SenderQueueManagerUnittest, TestRemoveItem)
 UNIT_TEST_CASE(SenderQueueManagerUnittest, TestIsAllQueueEmpty)
 
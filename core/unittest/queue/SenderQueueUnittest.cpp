@@ -12,10 +12,24 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <chrono>
+
+#include <boost/filesystem.hpp>
+
+#include "application/Application.h"
+#include "common/Flags.h"
+#include "common/StringTools.h"
+#include "pipeline/limiter/RateLimiter.h"
 #include "pipeline/queue/SenderQueue.h"
 #include "unittest/Unittest.h"
 #include "unittest/queue/FeedbackInterfaceMock.h"
 
+DECLARE_FLAG_INT64(sender_queue_spill_memory_watermark_bytes);
+DECLARE_FLAG_INT64(sender_queue_spill_max_bytes);
+DECLARE_FLAG_INT64(sender_queue_spill_total_max_bytes);
+DECLARE_FLAG_INT32(sender_queue_spill_max_age_secs);
+DECLARE_FLAG_INT32(sender_queue_spill_segment_size_bytes);
+
 using namespace std;
 
 namespace logtail {
@@ -25,6 +39,9 @@ public:
     void TestPush();
     void TestRemove();
     void TestGetAvailableItems();
+    void TestGetAvailableItemsByDeficit();
+    void TestSpill();
+    void TestSpillTotalLimit();
     void TestMetric();
 
 protected:
@@ -36,7 +53,7 @@ protected:
     void SetUp() override {
         mQueue.reset(new SenderQueue(sCap, sLowWatermark, sHighWatermark, sKey, sFlusherId, sCtx));
         mQueue->SetConcurrencyLimiters({{"region", sConcurrencyLimiter}});
-        mQueue->mRateLimiter = RateLimiter(100);
+        mQueue->mRateLimiter.emplace(100);
         mQueue->SetFeedback(&sFeedback);
     }
 
@@ -59,6 +76,8 @@ private:
     static shared_ptr<ConcurrencyLimiter> sConcurrencyLimiter;
 
     unique_ptr<SenderQueueItem> GenerateItem();
+    // what the queue manager does after releasing its lock
+    void DoSpillIO(SenderQueue& queue);
 
     unique_ptr<SenderQueue> mQueue;
 };
@@ -135,42 +154,222 @@ void SenderQueueUnittest::TestGetAvailableItems() {
     }
     {
         // with limits, limited by concurrency limiter
-        mQueue->mRateLimiter->mMaxSendBytesPerSecond = 100;
+        // freeze the clock so that no tokens are refilled while fetching
+        mQueue->mRateLimiter->mClock = []() { return chrono::steady_clock::time_point(); };
+        mQueue->mRateLimiter->SetMaxRate(100);
         sConcurrencyLimiter->SetCurrentLimit(1);
         sConcurrencyLimiter->SetInSendingCount(0);
         vector<SenderQueueItem*> items;
         mQueue->GetAvailableItems(items, 80);
         APSARA_TEST_EQUAL(1U, items.size());
-        APSARA_TEST_EQUAL(sDataSize, mQueue->mRateLimiter->mLastSecondTotalBytes);
+        APSARA_TEST_EQUAL(100.0 - sDataSize, mQueue->mRateLimiter->mTokens);
         APSARA_TEST_EQUAL(1U, sConcurrencyLimiter->GetInSendingCount());
         for (auto& item : items) {
             item->mStatus = SendingStatus::IDLE;
         }
-        mQueue->mRateLimiter->mLastSecondTotalBytes = 0;
     }
     {
         // with limits, limited by rate limiter
-        mQueue->mRateLimiter->mMaxSendBytesPerSecond = 5;
+        mQueue->mRateLimiter->SetMaxRate(5);
         sConcurrencyLimiter->SetCurrentLimit(3);
         sConcurrencyLimiter->SetInSendingCount(0);
         vector<SenderQueueItem*> items;
         mQueue->GetAvailableItems(items, 80);
         APSARA_TEST_EQUAL(1U, items.size());
-        APSARA_TEST_EQUAL(sDataSize, mQueue->mRateLimiter->mLastSecondTotalBytes);
+        APSARA_TEST_EQUAL(5.0 - sDataSize, mQueue->mRateLimiter->mTokens);
+        APSARA_TEST_TRUE(mQueue->IsRateLimited());
         APSARA_TEST_EQUAL(1U, sConcurrencyLimiter->GetInSendingCount());
-        mQueue->mRateLimiter->mLastSecondTotalBytes = 0;
     }
     {
         // with limits, does not work
-        mQueue->mRateLimiter->mMaxSendBytesPerSecond = 100;
+        mQueue->mRateLimiter->SetMaxRate(100);
         sConcurrencyLimiter->SetCurrentLimit(3);
         sConcurrencyLimiter->SetInSendingCount(0);
         vector<SenderQueueItem*> items;
         mQueue->GetAvailableItems(items, 80);
         APSARA_TEST_EQUAL(1U, items.size());
-        APSARA_TEST_EQUAL(sDataSize, mQueue->mRateLimiter->mLastSecondTotalBytes);
+        APSARA_TEST_EQUAL(100.0 - sDataSize, mQueue->mRateLimiter->mTokens);
         APSARA_TEST_EQUAL(1U, sConcurrencyLimiter->GetInSendingCount());
+        for (auto& item : items) {
+            item->mStatus = SendingStatus::IDLE;
+        }
+    }
+    {
+        // with limits, shared rate limiters are ignored while exiting
+        auto globalLimiter = make_shared<RateLimiter>(5, 0, []() { return chrono::steady_clock::time_point(); });
+        mQueue->SetRateLimiters({{"global", globalLimiter}});
+        globalLimiter->PostPop(sDataSize);
+        mQueue->mRateLimiter->SetMaxRate(100);
+        sConcurrencyLimiter->SetCurrentLimit(3);
+        sConcurrencyLimiter->SetInSendingCount(0);
+        vector<SenderQueueItem*> items;
+        mQueue->GetAvailableItems(items, 80);
+        APSARA_TEST_TRUE(items.empty());
+        APSARA_TEST_TRUE(mQueue->IsRateLimited());
+
+        Application::GetInstance()->SetSigTermSignalFlag(true);
+        mQueue->GetAvailableItems(items, 80);
+        Application::GetInstance()->SetSigTermSignalFlag(false);
+        APSARA_TEST_EQUAL(1U, items.size());
+        APSARA_TEST_FALSE(mQueue->IsRateLimited());
+    }
+}
+
+void SenderQueueUnittest::TestGetAvailableItemsByDeficit() {
+    for (size_t i = 0; i < sCap; ++i) {
+        mQueue->Push(GenerateItem());
+    }
+    const int64_t itemSize = mQueue->mQueue[0]->mData.size();
+    {
+        // credit is not enough for the first item
+        vector<SenderQueueItem*> items;
+        mQueue->GetAvailableItems(items, 80, itemSize - 2);
+        APSARA_TEST_TRUE(items.empty());
+        APSARA_TEST_TRUE(mQueue->IsDeficitLimited());
+        APSARA_TEST_EQUAL(itemSize - 2, mQueue->mDeficitBytes);
+    }
+    {
+        // credit is accumulated, but capped at the size of the first item
+        vector<SenderQueueItem*> items;
+        mQueue->GetAvailableItems(items, 80, itemSize - 2);
+        APSARA_TEST_EQUAL(1U, items.size());
+        APSARA_TEST_TRUE(mQueue->IsDeficitLimited());
+        APSARA_TEST_EQUAL(0, mQueue->mDeficitBytes);
+        for (auto& item : items) {
+            item->mStatus = SendingStatus::IDLE;
+        }
+    }
+    {
+        // weight multiplies the credit
+        mQueue->SetSchedulingParam(2, 1);
+        mQueue->mDeficitBytes = 0;
+        vector<SenderQueueItem*> items;
+        mQueue->GetAvailableItems(items, 80, itemSize);
+        APSARA_TEST_EQUAL(2U, items.size());
+        APSARA_TEST_FALSE(mQueue->IsDeficitLimited());
+        // no idle item left, credit should be cleared
+        APSARA_TEST_EQUAL(0, mQueue->mDeficitBytes);
+        APSARA_TEST_EQUAL(3U, mQueue->mFetchedItemsCnt->GetValue());
+    }
+}
+
+void SenderQueueUnittest::TestSpill() {
+    INT64_FLAG(sender_queue_spill_memory_watermark_bytes) = 10;
+    INT64_FLAG(sender_queue_spill_max_bytes) = 20;
+    // one payload per segment
+    INT32_FLAG(sender_queue_spill_segment_size_bytes) = 10;
+    string dir = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+    mQueue->EnableSpill(dir);
+
+    vector<SenderQueueItem*> items;
+    for (size_t i = 0; i < 6; ++i) {
+        auto item = make_unique<SenderQueueItem>("content" + ToString(i), sDataSize, nullptr, sKey);
+        items.emplace_back(item.get());
+        APSARA_TEST_TRUE(mQueue->Push(std::move(item)));
+        if (i == 2) {
+            // kept in memory under the watermark, upstream is not blocked
+            APSARA_TEST_EQUAL(1U, mQueue->mExtraBuffer.size());
+            APSARA_TEST_TRUE(mQueue->IsValidToPush());
+        }
+    }
+    // the last item exceeds the spill limit and is kept in memory
+    APSARA_TEST_EQUAL(1U, mQueue->mExtraBuffer.size());
+    APSARA_TEST_EQUAL(3U, mQueue->mSpilledItems.size());
+    APSARA_TEST_EQUAL(16U, mQueue->mSpillBuffer->Size());
+    APSARA_TEST_EQUAL(2U, mQueue->mSpilledItemsTotal->GetValue());
+    APSARA_TEST_TRUE(items[3]->mData.empty());
+    APSARA_TEST_FALSE(mQueue->IsValidToPush());
+    APSARA_TEST_EQUAL(4U, mQueue->mExtraBufferSize->GetValue());
+    // payloads are only staged under the lock
+    APSARA_TEST_EQUAL(2U, mQueue->mSpillBuffer->mStaged.size());
+    APSARA_TEST_TRUE(mQueue->GetSpillBufferWithPendingIO() != nullptr);
+    DoSpillIO(*mQueue);
+    APSARA_TEST_TRUE(mQueue->mSpillBuffer->mStaged.empty());
+    APSARA_TEST_EQUAL(16U, mQueue->mSpillBuffer->mFile.Size());
+    APSARA_TEST_TRUE(mQueue->GetSpillBufferWithPendingIO() == nullptr);
+
+    // items are moved back in the order they are pushed
+    APSARA_TEST_TRUE(mQueue->Remove(items[0]));
+    APSARA_TEST_EQUAL("content2", mQueue->mQueue[2 % sCap]->mData);
+    // payloads kept in memory are back under the watermark
+    APSARA_TEST_TRUE(mQueue->IsValidToPush());
+    APSARA_TEST_TRUE(sFeedback.HasFeedback(0));
+    // the spilled payload is not loaded yet, so the slot is left free and later items still go after it
+    APSARA_TEST_TRUE(mQueue->Remove(items[1]));
+    APSARA_TEST_EQUAL(1U, mQueue->Size());
+    APSARA_TEST_TRUE(mQueue->Push(make_unique<SenderQueueItem>("content6", sDataSize, nullptr, sKey)));
+    APSARA_TEST_EQUAL(1U, mQueue->Size());
+    APSARA_TEST_TRUE(mQueue->GetSpillBufferWithPendingIO() != nullptr);
+    DoSpillIO(*mQueue);
+    APSARA_TEST_EQUAL(2U, mQueue->Size());
+    APSARA_TEST_EQUAL("content3", items[3]->mData);
+    // the next payload is read ahead
+    APSARA_TEST_EQUAL(1U, mQueue->mSpillBuffer->mReady.size());
+    APSARA_TEST_EQUAL(8U, mQueue->mSpillBuffer->Size());
+    APSARA_TEST_TRUE(mQueue->Remove(items[2]));
+    APSARA_TEST_EQUAL("content4", items[4]->mData);
+    APSARA_TEST_EQUAL(0U, mQueue->mSpillBuffer->Size());
+    APSARA_TEST_TRUE(mQueue->Remove(items[3]));
+    APSARA_TEST_EQUAL("content5", items[5]->mData);
+    APSARA_TEST_TRUE(mQueue->Remove(items[4]));
+    APSARA_TEST_EQUAL(2U, mQueue->Size());
+    APSARA_TEST_TRUE(mQueue->mSpilledItems.empty());
+    APSARA_TEST_EQUAL(0U, mQueue->mSpillBuffer->Size());
+    // segments fully read are removed
+    APSARA_TEST_EQUAL(1, distance(boost::filesystem::directory_iterator(dir), boost::filesystem::directory_iterator()));
+
+    // too old
+    for (size_t i = 0; i < 3; ++i) {
+        mQueue->Push(make_unique<SenderQueueItem>("content" + ToString(i), sDataSize, nullptr, sKey));
     }
+    APSARA_TEST_EQUAL(2U, mQueue->mSpilledItems.size());
+    mQueue->mSpilledItems.front().mItem->mFirstEnqueTime
+        -= chrono::seconds(INT32_FLAG(sender_queue_spill_max_age_secs) + 1);
+    // staged payloads are taken back without being written
+    APSARA_TEST_TRUE(mQueue->Remove(items[5]));
+    APSARA_TEST_TRUE(mQueue->Remove(mQueue->mQueue[6 % sCap].get()));
+    APSARA_TEST_EQUAL(1U, mQueue->mSpillDiscardedItemsTotal->GetValue());
+    APSARA_TEST_EQUAL(2U, mQueue->Size());
+    APSARA_TEST_TRUE(mQueue->mSpilledItems.empty());
+    APSARA_TEST_EQUAL(0U, mQueue->mSpillBuffer->mFile.Size());
+
+    mQueue.reset();
+    APSARA_TEST_TRUE(boost::filesystem::is_empty(dir));
+    APSARA_TEST_EQUAL(0U, SpillBuffer::TotalSize());
+    boost::filesystem::remove_all(dir);
+    INT64_FLAG(sender_queue_spill_memory_watermark_bytes) = 16 * 1024 * 1024;
+    INT64_FLAG(sender_queue_spill_max_bytes) = 1024 * 1024 * 1024;
+    INT32_FLAG(sender_queue_spill_segment_size_bytes) = 64 * 1024 * 1024;
+}
+
+void SenderQueueUnittest::TestSpillTotalLimit() {
+    INT64_FLAG(sender_queue_spill_memory_watermark_bytes) = 0;
+    INT64_FLAG(sender_queue_spill_total_max_bytes) = 7;
+    string dir = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+    SenderQueue queue(sCap, sLowWatermark, sHighWatermark, 1, sFlusherId, sCtx);
+    mQueue->EnableSpill(dir);
+    queue.EnableSpill(dir);
+    for (size_t i = 0; i <= sCap; ++i) {
+        APSARA_TEST_TRUE(mQueue->Push(GenerateItem()));
+    }
+    APSARA_TEST_EQUAL(7U, mQueue->mSpillBuffer->Size());
+    APSARA_TEST_EQUAL(7U, SpillBuffer::TotalSize());
+    APSARA_TEST_FALSE(mQueue->IsValidToPush());
+
+    // the process-wide limit is reached by the other queue
+    for (size_t i = 0; i <= sCap; ++i) {
+        APSARA_TEST_TRUE(queue.Push(GenerateItem()));
+    }
+    APSARA_TEST_EQUAL(0U, queue.mSpillBuffer->Size());
+    APSARA_TEST_EQUAL(7U, queue.mExtraBufferBytes);
+
+    APSARA_TEST_TRUE(mQueue->Remove(mQueue->mQueue[0].get()));
+    APSARA_TEST_EQUAL(0U, SpillBuffer::TotalSize());
+    APSARA_TEST_TRUE(mQueue->IsValidToPush());
+
+    boost::filesystem::remove_all(dir);
+    INT64_FLAG(sender_queue_spill_memory_watermark_bytes) = 16 * 1024 * 1024;
+    INT64_FLAG(sender_queue_spill_total_max_bytes) = 4LL * 1024 * 1024 * 1024;
 }
 
 void SenderQueueUnittest::TestMetric() {
@@ -225,9 +424,24 @@ unique_ptr<SenderQueueItem> SenderQueueUnittest::GenerateItem() {
     return make_unique<SenderQueueItem>("content", sDataSize, nullptr, sKey);
 }
 
+void SenderQueueUnittest::DoSpillIO(SenderQueue& queue) {
+    auto spillBuffer = queue.GetSpillBufferWithPendingIO();
+    while (spillBuffer) {
+        spillBuffer->Flush();
+        if (!spillBuffer->Load()) {
+            break;
+        }
+        queue.FillFromExtraBuffer();
+        spillBuffer = queue.GetSpillBufferWithPendingIO();
+    }
+}
+
 UNIT_TEST_CASE(SenderQueueUnittest, TestPush)
 UNIT_TEST_CASE(SenderQueueUnittest, TestRemove)
 UNIT_TEST_CASE(SenderQueueUnittest, TestGetAvailableItems)
+UNIT_TEST_CASE(SenderQueueUnittest, TestGetAvailableItemsByDeficit)
+UNIT_TEST_CASE(SenderQueueUnittest, TestSpill)
+UNIT_TEST_CASE(SenderQueueUnittest, TestSpillTotalLimit)
 UNIT_TEST_CASE(SenderQueueUnittest, TestMetric)
 
 } // namespace logtail
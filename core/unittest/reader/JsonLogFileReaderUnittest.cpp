@@ -244,6 +244,7 @@ public:
     void TestRemoveLastIncompleteLogMultilineIncompleteNoRollback();
     void TestRemoveLastIncompleteLogNotValidJson();
     void TestRemoveLastIncompleteLogNotValidJsonNoRollback();
+    void TestRemoveLastIncompleteLogResumeScan();
 
     std::unique_ptr<JsonLogFileReader> mLogFileReader;
     MultilineOptions multilineOpts;
@@ -259,6 +260,7 @@ UNIT_TEST_CASE(RemoveLastIncompleteLogUnittest, TestRemoveLastIncompleteLogMulti
 UNIT_TEST_CASE(RemoveLastIncompleteLogUnittest, TestRemoveLastIncompleteLogMultilineIncompleteNoRollback)
 UNIT_TEST_CASE(RemoveLastIncompleteLogUnittest, TestRemoveLastIncompleteLogNotValidJson)
 UNIT_TEST_CASE(RemoveLastIncompleteLogUnittest, TestRemoveLastIncompleteLogNotValidJsonNoRollback)
+UNIT_TEST_CASE(RemoveLastIncompleteLogUnittest, TestRemoveLastIncompleteLogResumeScan)
 
 void RemoveLastIncompleteLogUnittest::TestRemoveLastIncompleteLogSingleLine() {
     { // case single line
@@ -519,6 +521,59 @@ void RemoveLastIncompleteLogUnittest::TestRemoveLastIncompleteLogNotValidJsonNoR
     }
 }
 
+void RemoveLastIncompleteLogUnittest::TestRemoveLastIncompleteLogResumeScan() {
+    std::string firstLog = R"({"key": "first value"})";
+    // long enough to be scanned in several blocks, and split in a string right after an escape char
+    std::string secondLogPart1 = "{\n    \"key\": {\n        \"nested_key\": \"" + std::string(100, 'a') + "{ \\";
+    std::string secondLogPart2 = "\" }\"\n    }\n}";
+    std::string thirdLog = R"({"key": "third value"})";
+    { // resume the scan of the rolled back log
+        mLogFileReader->mLastFilePos = 100;
+        mLogFileReader->mCache.clear();
+        std::string testLog = firstLog + '\n' + secondLogPart1;
+        int32_t rollbackLineFeedCount = 0;
+        size_t matchSize = mLogFileReader->RemoveLastIncompleteLog(
+            const_cast<char*>(testLog.data()), testLog.size(), rollbackLineFeedCount);
+        APSARA_TEST_EQUAL_FATAL(firstLog.size() + 1, matchSize);
+        APSARA_TEST_EQUAL_FATAL(3, rollbackLineFeedCount);
+        APSARA_TEST_EQUAL_FATAL(100 + int64_t(matchSize), mLogFileReader->mPendingScanOffset);
+        APSARA_TEST_EQUAL_FATAL(int32_t(secondLogPart1.size()), mLogFileReader->mPendingScanState.mScannedSize);
+        APSARA_TEST_EQUAL_FATAL(2, mLogFileReader->mPendingScanState.mBraceCount);
+        APSARA_TEST_TRUE_FATAL(mLogFileReader->mPendingScanState.mInQuote);
+        APSARA_TEST_TRUE_FATAL(mLogFileReader->mPendingScanState.mEscaped);
+
+        // what LogFileReader::ReadUTF8 does after rollback
+        mLogFileReader->mLastFilePos += matchSize;
+        mLogFileReader->mCache.assign(testLog.data() + matchSize, testLog.size() - matchSize);
+        testLog = secondLogPart1 + secondLogPart2 + '\n' + thirdLog + '\n';
+        std::string expectMatch = secondLogPart1 + secondLogPart2 + '\0' + thirdLog + '\0';
+        matchSize = mLogFileReader->RemoveLastIncompleteLog(
+            const_cast<char*>(testLog.data()), testLog.size(), rollbackLineFeedCount);
+        APSARA_TEST_EQUAL_FATAL(expectMatch.size(), matchSize);
+        APSARA_TEST_EQUAL_FATAL(std::string(testLog.data(), matchSize), expectMatch);
+        APSARA_TEST_EQUAL_FATAL(0, rollbackLineFeedCount);
+        APSARA_TEST_EQUAL_FATAL(-1, mLogFileReader->mPendingScanOffset);
+    }
+    { // the scan is started over if the buffer does not start with the rolled back log
+        mLogFileReader->mLastFilePos = 0;
+        mLogFileReader->mCache.clear();
+        std::string testLog = firstLog + '\n' + secondLogPart1;
+        int32_t rollbackLineFeedCount = 0;
+        size_t matchSize = mLogFileReader->RemoveLastIncompleteLog(
+            const_cast<char*>(testLog.data()), testLog.size(), rollbackLineFeedCount);
+        APSARA_TEST_EQUAL_FATAL(firstLog.size() + 1, matchSize);
+
+        mLogFileReader->mLastFilePos = 0;
+        testLog = thirdLog + '\n' + firstLog + '\n';
+        std::string expectMatch = thirdLog + '\0' + firstLog + '\0';
+        matchSize = mLogFileReader->RemoveLastIncompleteLog(
+            const_cast<char*>(testLog.data()), testLog.size(), rollbackLineFeedCount);
+        APSARA_TEST_EQUAL_FATAL(expectMatch.size(), matchSize);
+        APSARA_TEST_EQUAL_FATAL(std::string(testLog.data(), matchSize), expectMatch);
+        APSARA_TEST_EQUAL_FATAL(0, rollbackLineFeedCount);
+    }
+}
+
 } // namespace logtail
 
 UNIT_TEST_MAIN
@@ -26,6 +26,7 @@
 #include "unittest/Unittest.h"
 
 DECLARE_FLAG_INT32(force_release_deleted_file_fd_timeout);
+DECLARE_FLAG_INT32(pipeline_latency_trace_sample_interval);
 
 namespace logtail {
 
@@ -70,6 +71,7 @@ public:
     }
     void TestReadGBK();
     void TestReadUTF8();
+    void TestReadLogLatencyTrace();
 
     std::unique_ptr<char[]> expectedContent;
     static std::string logPathDir;
@@ -82,6 +84,7 @@ public:
 
 UNIT_TEST_CASE(LogFileReaderUnittest, TestReadGBK);
 UNIT_TEST_CASE(LogFileReaderUnittest, TestReadUTF8);
+UNIT_TEST_CASE(LogFileReaderUnittest, TestReadLogLatencyTrace);
 
 std::string LogFileReaderUnittest::logPathDir;
 std::string LogFileReaderUnittest::gbkFile;
@@ -506,6 +509,28 @@ void LogFileReaderUnittest::TestReadUTF8() {
     }
 }
 
+void LogFileReaderUnittest::TestReadLogLatencyTrace() {
+    INT32_FLAG(pipeline_latency_trace_sample_interval) = 1;
+    MultilineOptions multilineOpts;
+    LogFileReaderPtr reader(new LogFileReader(
+        logPathDir, utf8File, DevInode(), std::make_pair(&readerOpts, &ctx), std::make_pair(&multilineOpts, &ctx)));
+    reader->UpdateReaderManual();
+    reader->InitReader(true, LogFileReader::BACKWARD_TO_BEGINNING);
+    reader->CheckFileSignatureAndOffset(true);
+    LogBuffer logBuffer;
+    auto before = LatencyTrace::Clock::now();
+    reader->ReadLog(logBuffer, nullptr);
+    auto after = LatencyTrace::Clock::now();
+    // the read stage is stamped when the buffer is read, not when it is pushed to the process queue
+    APSARA_TEST_NOT_EQUAL_FATAL(nullptr, logBuffer.latencyTrace);
+    APSARA_TEST_TRUE(logBuffer.latencyTrace->GetStamp(LatencyStage::READ) >= before);
+    APSARA_TEST_TRUE(logBuffer.latencyTrace->GetStamp(LatencyStage::READ) <= after);
+    auto trace = logBuffer.latencyTrace;
+    PipelineEventGroup group = LogFileReader::GenerateEventGroup(reader, &logBuffer);
+    APSARA_TEST_EQUAL(trace, group.GetLatencyTrace());
+    INT32_FLAG(pipeline_latency_trace_sample_interval) = 0;
+}
+
 class LogMultiBytesUnittest : public ::testing::Test {
 public:
     static void SetUpTestCase() {
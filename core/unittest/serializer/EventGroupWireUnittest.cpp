@@ -0,0 +1,264 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstring>
+
+#include "go_pipeline/EventGroupWire.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+// reads the layout back in the same order as pluginmanager/event_group_wire.go
+class WireReader {
+public:
+    explicit WireReader(const string& buf) : mBuf(buf) {}
+
+    template <typename T>
+    T Fixed() {
+        T val{};
+        if (mPos + sizeof(T) <= mBuf.size()) {
+            memcpy(&val, mBuf.data() + mPos, sizeof(T));
+        }
+        mPos += sizeof(T);
+        return val;
+    }
+
+    string Str() {
+        auto size = Fixed<uint32_t>();
+        string s = mBuf.substr(mPos, size);
+        mPos += size;
+        return s;
+    }
+
+    map<string, string> KVs() {
+        map<string, string> res;
+        auto n = Fixed<uint32_t>();
+        for (uint32_t i = 0; i < n; ++i) {
+            auto key = Str();
+            res[key] = Str();
+        }
+        return res;
+    }
+
+    bool AtEnd() const { return mPos == mBuf.size(); }
+
+private:
+    const string& mBuf;
+    size_t mPos = 0;
+};
+
+class EventGroupWireUnittest : public ::testing::Test {
+public:
+    void TestLogGroup();
+    void TestMetricGroup();
+    void TestSpanGroup();
+    void TestUnsupportedGroup();
+
+private:
+    static void CheckHeader(WireReader& reader, PipelineEvent::Type type, uint32_t eventCnt) {
+        char magic[4];
+        for (auto& c : magic) {
+            c = reader.Fixed<char>();
+        }
+        APSARA_TEST_EQUAL(0, memcmp(magic, kEventGroupWireMagic, sizeof(magic)));
+        APSARA_TEST_EQUAL(static_cast<uint8_t>(type), reader.Fixed<uint8_t>());
+        APSARA_TEST_EQUAL((map<string, string>{{"source_id", "source"}}), reader.KVs());
+        APSARA_TEST_EQUAL((map<string, string>{{"tag_key", "tag_value"}}), reader.KVs());
+        APSARA_TEST_EQUAL(eventCnt, reader.Fixed<uint32_t>());
+    }
+
+    static PipelineEventGroup CreateGroup() {
+        PipelineEventGroup group(make_shared<SourceBuffer>());
+        group.SetMetadata(EventGroupMetaKey::SOURCE_ID, string("source"));
+        group.SetTag(string("tag_key"), string("tag_value"));
+        return group;
+    }
+};
+
+void EventGroupWireUnittest::TestLogGroup() {
+    auto group = CreateGroup();
+    auto e = group.AddLogEvent();
+    e->SetTimestamp(1729000000, 123);
+    e->SetContent(string("content"), string("first"));
+    e->SetLevel("INFO");
+    e->SetPosition(100, 20);
+    e = group.AddLogEvent();
+    e->SetTimestamp(1729000001);
+    e->SetContent(string("content"), string("second"));
+
+    string res, errorMsg;
+    APSARA_TEST_TRUE(SerializeEventGroupWire(group, true, res, errorMsg));
+    {
+        WireReader reader(res);
+        CheckHeader(reader, PipelineEvent::Type::LOG, 2);
+        APSARA_TEST_EQUAL(1729000000, reader.Fixed<int64_t>());
+        APSARA_TEST_EQUAL(123U, reader.Fixed<uint32_t>());
+        APSARA_TEST_EQUAL(1U, reader.Fixed<uint8_t>());
+        APSARA_TEST_EQUAL("INFO", reader.Str());
+        APSARA_TEST_EQUAL(100U, reader.Fixed<uint64_t>());
+        APSARA_TEST_EQUAL(20U, reader.Fixed<uint64_t>());
+        APSARA_TEST_EQUAL((map<string, string>{{"content", "first"}}), reader.KVs());
+        APSARA_TEST_EQUAL(1729000001, reader.Fixed<int64_t>());
+        APSARA_TEST_EQUAL(0U, reader.Fixed<uint32_t>());
+        APSARA_TEST_EQUAL(0U, reader.Fixed<uint8_t>());
+        APSARA_TEST_EQUAL("", reader.Str());
+        reader.Fixed<uint64_t>();
+        reader.Fixed<uint64_t>();
+        APSARA_TEST_EQUAL((map<string, string>{{"content", "second"}}), reader.KVs());
+        APSARA_TEST_TRUE(reader.AtEnd());
+    }
+    // nanoseconds are dropped unless enabled
+    APSARA_TEST_TRUE(SerializeEventGroupWire(group, false, res, errorMsg));
+    {
+        WireReader reader(res);
+        CheckHeader(reader, PipelineEvent::Type::LOG, 2);
+        APSARA_TEST_EQUAL(1729000000, reader.Fixed<int64_t>());
+        APSARA_TEST_EQUAL(0U, reader.Fixed<uint32_t>());
+        APSARA_TEST_EQUAL(0U, reader.Fixed<uint8_t>());
+    }
+}
+
+void EventGroupWireUnittest::TestMetricGroup() {
+    auto group = CreateGroup();
+    auto e = group.AddMetricEvent();
+    e->SetTimestamp(1729000000);
+    e->SetName("single");
+    e->SetTag(string("host"), string("a"));
+    e->SetValue(UntypedSingleValue{1.5});
+    e = group.AddMetricEvent();
+    e->SetTimestamp(1729000000);
+    e->SetName("histogram");
+    e->SetValue(HistogramValue{30.0, 6.0, {{1.0, 2.0}, {10.0, 6.0}}});
+    e = group.AddMetricEvent();
+    e->SetTimestamp(1729000000);
+    e->SetName("none");
+
+    string res, errorMsg;
+    APSARA_TEST_TRUE(SerializeEventGroupWire(group, false, res, errorMsg));
+    WireReader reader(res);
+    CheckHeader(reader, PipelineEvent::Type::METRIC, 3);
+
+    reader.Fixed<int64_t>();
+    reader.Fixed<uint32_t>();
+    reader.Fixed<uint8_t>();
+    APSARA_TEST_EQUAL("single", reader.Str());
+    APSARA_TEST_EQUAL((map<string, string>{{"host", "a"}}), reader.KVs());
+    APSARA_TEST_EQUAL(static_cast<uint8_t>(EventGroupWireValueType::SINGLE), reader.Fixed<uint8_t>());
+    APSARA_TEST_EQUAL(1.5, reader.Fixed<double>());
+
+    reader.Fixed<int64_t>();
+    reader.Fixed<uint32_t>();
+    reader.Fixed<uint8_t>();
+    APSARA_TEST_EQUAL("histogram", reader.Str());
+    APSARA_TEST_TRUE(reader.KVs().empty());
+    APSARA_TEST_EQUAL(static_cast<uint8_t>(EventGroupWireValueType::HISTOGRAM), reader.Fixed<uint8_t>());
+    APSARA_TEST_EQUAL(30.0, reader.Fixed<double>());
+    APSARA_TEST_EQUAL(6.0, reader.Fixed<double>());
+    APSARA_TEST_EQUAL(2U, reader.Fixed<uint32_t>());
+    APSARA_TEST_EQUAL(1.0, reader.Fixed<double>());
+    APSARA_TEST_EQUAL(2.0, reader.Fixed<double>());
+    APSARA_TEST_EQUAL(10.0, reader.Fixed<double>());
+    APSARA_TEST_EQUAL(6.0, reader.Fixed<double>());
+
+    reader.Fixed<int64_t>();
+    reader.Fixed<uint32_t>();
+    reader.Fixed<uint8_t>();
+    APSARA_TEST_EQUAL("none", reader.Str());
+    APSARA_TEST_TRUE(reader.KVs().empty());
+    APSARA_TEST_EQUAL(static_cast<uint8_t>(EventGroupWireValueType::NONE), reader.Fixed<uint8_t>());
+    APSARA_TEST_TRUE(reader.AtEnd());
+}
+
+void EventGroupWireUnittest::TestSpanGroup() {
+    auto group = CreateGroup();
+    auto e = group.AddSpanEvent();
+    e->SetTimestamp(1729000000);
+    e->SetTraceId("trace");
+    e->SetSpanId("span");
+    e->SetTraceState("state");
+    e->SetParentSpanId("parent");
+    e->SetName("name");
+    e->SetKind(SpanEvent::Kind::Server);
+    e->SetStartTimeNs(100);
+    e->SetEndTimeNs(200);
+    e->SetStatus(SpanEvent::StatusCode::Error);
+    e->SetTag(string("key"), string("value"));
+    e->SetScopeTag(string("scope_key"), string("scope_value"));
+    auto inner = e->AddEvent();
+    inner->SetTimestampNs(150);
+    inner->SetName("event");
+    auto link = e->AddLink();
+    link->SetTraceId("link_trace");
+    link->SetSpanId("link_span");
+
+    string res, errorMsg;
+    APSARA_TEST_TRUE(SerializeEventGroupWire(group, false, res, errorMsg));
+    WireReader reader(res);
+    CheckHeader(reader, PipelineEvent::Type::SPAN, 1);
+    reader.Fixed<int64_t>();
+    reader.Fixed<uint32_t>();
+    reader.Fixed<uint8_t>();
+    APSARA_TEST_EQUAL("trace", reader.Str());
+    APSARA_TEST_EQUAL("span", reader.Str());
+    APSARA_TEST_EQUAL("state", reader.Str());
+    APSARA_TEST_EQUAL("parent", reader.Str());
+    APSARA_TEST_EQUAL("name", reader.Str());
+    APSARA_TEST_EQUAL(static_cast<uint8_t>(SpanEvent::Kind::Server), reader.Fixed<uint8_t>());
+    APSARA_TEST_EQUAL(100U, reader.Fixed<uint64_t>());
+    APSARA_TEST_EQUAL(200U, reader.Fixed<uint64_t>());
+    APSARA_TEST_EQUAL(static_cast<uint8_t>(SpanEvent::StatusCode::Error), reader.Fixed<uint8_t>());
+    APSARA_TEST_EQUAL((map<string, string>{{"key", "value"}}), reader.KVs());
+    APSARA_TEST_EQUAL((map<string, string>{{"scope_key", "scope_value"}}), reader.KVs());
+    APSARA_TEST_EQUAL(1U, reader.Fixed<uint32_t>());
+    APSARA_TEST_EQUAL(150U, reader.Fixed<uint64_t>());
+    APSARA_TEST_EQUAL("event", reader.Str());
+    APSARA_TEST_TRUE(reader.KVs().empty());
+    APSARA_TEST_EQUAL(1U, reader.Fixed<uint32_t>());
+    APSARA_TEST_EQUAL("link_trace", reader.Str());
+    APSARA_TEST_EQUAL("link_span", reader.Str());
+    APSARA_TEST_EQUAL("", reader.Str());
+    APSARA_TEST_TRUE(reader.KVs().empty());
+    APSARA_TEST_TRUE(reader.AtEnd());
+}
+
+void EventGroupWireUnittest::TestUnsupportedGroup() {
+    string res, errorMsg;
+    {
+        auto group = CreateGroup();
+        APSARA_TEST_FALSE(SerializeEventGroupWire(group, false, res, errorMsg));
+    }
+    {
+        auto group = CreateGroup();
+        group.AddRawEvent();
+        APSARA_TEST_FALSE(SerializeEventGroupWire(group, false, res, errorMsg));
+    }
+    {
+        auto group = CreateGroup();
+        group.AddLogEvent();
+        group.AddMetricEvent();
+        APSARA_TEST_FALSE(SerializeEventGroupWire(group, false, res, errorMsg));
+        APSARA_TEST_EQUAL("mixed event types in event group", errorMsg);
+    }
+}
+
+UNIT_TEST_CASE(EventGroupWireUnittest, TestLogGroup)
+UNIT_TEST_CASE(EventGroupWireUnittest, TestMetricGroup)
+UNIT_TEST_CASE(EventGroupWireUnittest, TestSpanGroup)
+UNIT_TEST_CASE(EventGroupWireUnittest, TestUnsupportedGroup)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -12,11 +12,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <array>
+#include <limits>
+
 #include "pipeline/serializer/SLSSerializer.h"
 #include "plugin/flusher/sls/FlusherSLS.h"
 #include "unittest/Unittest.h"
 
 DECLARE_FLAG_INT32(max_send_log_group_size);
+DECLARE_FLAG_BOOL(sls_serializer_replace_non_utf8);
 
 using namespace std;
 
@@ -26,6 +30,8 @@ class SLSSerializerUnittest : public ::testing::Test {
 public:
     void TestSerializeEventGroup();
     void TestSerializeEventGroupList();
+    void TestSerializeCompoundMetricValues();
+    void TestReplaceNonUtf8();
 
 protected:
     static void SetUpTestCase() { sFlusher = make_unique<FlusherSLS>(); }
@@ -366,6 +372,113 @@ void SLSSerializerUnittest::TestSerializeEventGroup() {
     }
 }
 
+void SLSSerializerUnittest::TestSerializeCompoundMetricValues() {
+    SLSEventGroupSerializer serializer(sFlusher.get());
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    {
+        MetricEvent* e = group.AddMetricEvent();
+        e->SetName("latency");
+        e->SetTimestamp(1234567890);
+        e->SetTag(string("a"), string("1"));
+        e->SetTag(string("z"), string("2"));
+        HistogramValue v;
+        v.mSum = 3.5;
+        v.mCount = 4;
+        v.mBuckets = {{0.5, 1}, {1, 3}, {numeric_limits<double>::infinity(), 4}};
+        e->SetValue(v);
+    }
+    {
+        MetricEvent* e = group.AddMetricEvent();
+        e->SetName("rpc");
+        e->SetTimestamp(1234567890);
+        SummaryValue v;
+        v.mSum = 10;
+        v.mCount = 2;
+        v.mQuantiles = {{0.99, 8}};
+        e->SetValue(v);
+    }
+    {
+        MetricEvent* e = group.AddMetricEvent();
+        e->SetName("cpu");
+        e->SetTimestamp(1234567890);
+        e->SetTag(string("a"), string("1"));
+        e->SetMultiDoubleValue(string("user"), 0.5);
+        e->SetMultiDoubleValue(string("idle"), 0.25);
+    }
+    BatchedEvents batch(std::move(group.MutableEvents()),
+                        std::move(group.GetSizedTags()),
+                        std::move(group.GetSourceBuffer()),
+                        group.GetMetadata(EventGroupMetaKey::SOURCE_ID),
+                        std::move(group.GetExactlyOnceCheckpoint()));
+    string res, errorMsg;
+    APSARA_TEST_TRUE(serializer.DoSerialize(std::move(batch), res, errorMsg));
+    sls_logs::LogGroup logGroup;
+    APSARA_TEST_TRUE(logGroup.ParseFromString(res));
+
+    vector<array<string, 3>> expected = {{"latency_bucket", "a#$#1|le#$#0.5|z#$#2", "1.000000"},
+                                         {"latency_bucket", "a#$#1|le#$#1|z#$#2", "3.000000"},
+                                         {"latency_bucket", "a#$#1|le#$#+Inf|z#$#2", "4.000000"},
+                                         {"latency_sum", "a#$#1|z#$#2", "3.500000"},
+                                         {"latency_count", "a#$#1|z#$#2", "4.000000"},
+                                         {"rpc", "quantile#$#0.99", "8.000000"},
+                                         {"rpc_sum", "", "10.000000"},
+                                         {"rpc_count", "", "2.000000"},
+                                         {"cpu_idle", "a#$#1", "0.250000"},
+                                         {"cpu_user", "a#$#1", "0.500000"}};
+    APSARA_TEST_EQUAL(static_cast<int>(expected.size()), logGroup.logs_size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        const auto& log = logGroup.logs(i);
+        APSARA_TEST_EQUAL(1234567890U, log.time());
+        APSARA_TEST_EQUAL(log.contents_size(), 4);
+        APSARA_TEST_EQUAL(log.contents(0).key(), "__labels__");
+        APSARA_TEST_EQUAL(log.contents(0).value(), expected[i][1]);
+        APSARA_TEST_EQUAL(log.contents(1).value(), "1234567890");
+        APSARA_TEST_EQUAL(log.contents(2).key(), "__value__");
+        APSARA_TEST_EQUAL(log.contents(2).value(), expected[i][2]);
+        APSARA_TEST_EQUAL(log.contents(3).key(), "__name__");
+        APSARA_TEST_EQUAL(log.contents(3).value(), expected[i][0]);
+    }
+}
+
+void SLSSerializerUnittest::TestReplaceNonUtf8() {
+    auto createBatch = []() {
+        PipelineEventGroup group(make_shared<SourceBuffer>());
+        LogEvent* e = group.AddLogEvent();
+        e->SetTimestamp(1234567890);
+        e->SetContent(string("key"), string("val\xffue"));
+        e->SetContent(string("k\xc3y"), string("valid\xe4\xb8\xad"));
+        return BatchedEvents(std::move(group.MutableEvents()),
+                             std::move(group.GetSizedTags()),
+                             std::move(group.GetSourceBuffer()),
+                             StringView(),
+                             RangeCheckpointPtr());
+    };
+
+    SLSEventGroupSerializer serializer(sFlusher.get());
+    {
+        // disabled
+        string res, errorMsg;
+        APSARA_TEST_TRUE(serializer.DoSerialize(createBatch(), res, errorMsg));
+        sls_logs::LogGroup logGroup;
+        APSARA_TEST_TRUE(logGroup.ParseFromString(res));
+        APSARA_TEST_EQUAL("val\xffue", logGroup.logs(0).contents(0).value());
+    }
+    {
+        // enabled
+        BOOL_FLAG(sls_serializer_replace_non_utf8) = true;
+        string res, errorMsg;
+        APSARA_TEST_TRUE(serializer.DoSerialize(createBatch(), res, errorMsg));
+        sls_logs::LogGroup logGroup;
+        APSARA_TEST_TRUE(logGroup.ParseFromString(res));
+        APSARA_TEST_EQUAL(2, logGroup.logs(0).contents_size());
+        APSARA_TEST_EQUAL("key", logGroup.logs(0).contents(0).key());
+        APSARA_TEST_EQUAL("val ue", logGroup.logs(0).contents(0).value());
+        APSARA_TEST_EQUAL("k y", logGroup.logs(0).contents(1).key());
+        APSARA_TEST_EQUAL("valid\xe4\xb8\xad", logGroup.logs(0).contents(1).value());
+        BOOL_FLAG(sls_serializer_replace_non_utf8) = false;
+    }
+}
+
 void SLSSerializerUnittest::TestSerializeEventGroupList() {
     vector<CompressedLogGroup> v;
     v.emplace_back("data1", 10);
@@ -527,6 +640,8 @@ BatchedEvents SLSSerializerUnittest::CreateBatchedSpanEvents() {
 
 UNIT_TEST_CASE(SLSSerializerUnittest, TestSerializeEventGroup)
 UNIT_TEST_CASE(SLSSerializerUnittest, TestSerializeEventGroupList)
+UNIT_TEST_CASE(SLSSerializerUnittest, TestSerializeCompoundMetricValues)
+UNIT_TEST_CASE(SLSSerializerUnittest, TestReplaceNonUtf8)
 
 } // namespace logtail
 
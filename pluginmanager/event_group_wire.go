@@ -0,0 +1,300 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package pluginmanager
+
+import (
+	"encoding/binary"
+	"errors"
+	"fmt"
+	"math"
+	"strconv"
+
+	"github.com/alibaba/ilogtail/pkg/models"
+	"github.com/alibaba/ilogtail/pkg/protocol"
+	"github.com/alibaba/ilogtail/pkg/protocol/otlp"
+	"github.com/alibaba/ilogtail/pkg/util"
+)
+
+// The flat event group layout is documented in core/go_pipeline/EventGroupWire.h.
+const eventGroupWireMagic = "LEG1"
+
+// event types, the same as PipelineEvent::Type in C++
+const (
+	wireEventTypeLog    = 1
+	wireEventTypeMetric = 2
+	wireEventTypeSpan   = 3
+)
+
+// metric value types, the same as EventGroupWireValueType in C++
+const (
+	wireValueTypeNone = iota
+	wireValueTypeSingle
+	wireValueTypeMulti
+	wireValueTypeHistogram
+	wireValueTypeSummary
+)
+
+const logTopicTagKey = "__topic__"
+
+var errEventGroupWireTruncated = errors.New("truncated event group")
+
+type eventGroupWireReader struct {
+	buf []byte
+	pos int
+	err error
+}
+
+func (r *eventGroupWireReader) next(n int) []byte {
+	if r.err != nil {
+		return nil
+	}
+	if n < 0 || len(r.buf)-r.pos < n {
+		r.err = errEventGroupWireTruncated
+		return nil
+	}
+	b := r.buf[r.pos : r.pos+n]
+	r.pos += n
+	return b
+}
+
+func (r *eventGroupWireReader) u8() uint8 {
+	if b := r.next(1); b != nil {
+		return b[0]
+	}
+	return 0
+}
+
+func (r *eventGroupWireReader) u32() uint32 {
+	if b := r.next(4); b != nil {
+		return binary.LittleEndian.Uint32(b)
+	}
+	return 0
+}
+
+func (r *eventGroupWireReader) u64() uint64 {
+	if b := r.next(8); b != nil {
+		return binary.LittleEndian.Uint64(b)
+	}
+	return 0
+}
+
+func (r *eventGroupWireReader) f64() float64 {
+	return math.Float64frombits(r.u64())
+}
+
+// str references the underlying buffer without copying.
+func (r *eventGroupWireReader) str() string {
+	size := r.u32()
+	if size == 0 {
+		return ""
+	}
+	return util.ZeroCopyBytesToString(r.next(int(size)))
+}
+
+// count returns the element count of a list, each element of which takes at least minSize bytes, so that a corrupted
+// count cannot cause a huge allocation.
+func (r *eventGroupWireReader) count(minSize int) int {
+	n := int(r.u32())
+	if r.err == nil && n*minSize > len(r.buf)-r.pos {
+		r.err = errEventGroupWireTruncated
+		return 0
+	}
+	return n
+}
+
+func (r *eventGroupWireReader) tags() models.Tags {
+	n := r.count(8)
+	tags := models.NewTags()
+	for i := 0; i < n && r.err == nil; i++ {
+		key := r.str()
+		tags.Add(key, r.str())
+	}
+	return tags
+}
+
+// timestamp returns seconds, nanoseconds and whether nanoseconds is set.
+func (r *eventGroupWireReader) timestamp() (int64, uint32, bool) {
+	sec := int64(r.u64())
+	ns := r.u32()
+	return sec, ns, r.u8() != 0
+}
+
+// eventGroupWire is a decoded flat event group. Log groups are decoded into logGroup, so that they are received the
+// same way as sls_logs::LogGroup passed by ProcessLogGroup, other groups are decoded into pipeline events.
+type eventGroupWire struct {
+	logGroup *protocol.LogGroup
+	group    *models.PipelineGroupEvents
+}
+
+// decodeEventGroupWire decodes buf without copying strings, so buf must not be modified or reused afterwards.
+func decodeEventGroupWire(buf []byte) (*eventGroupWire, error) {
+	if len(buf) < len(eventGroupWireMagic) || string(buf[:len(eventGroupWireMagic)]) != eventGroupWireMagic {
+		return nil, errors.New("invalid event group magic")
+	}
+	r := &eventGroupWireReader{buf: buf, pos: len(eventGroupWireMagic)}
+	eventType := r.u8()
+	n := r.count(8)
+	meta := models.NewMetadata()
+	for i := 0; i < n && r.err == nil; i++ {
+		key := r.str()
+		meta.Add(key, r.str())
+	}
+	res := &eventGroupWire{}
+	if eventType == wireEventTypeLog {
+		res.logGroup = decodeWireLogGroup(r)
+	} else {
+		tags := r.tags()
+		n = r.count(1)
+		res.group = &models.PipelineGroupEvents{Group: models.NewGroup(meta, tags), Events: make([]models.PipelineEvent, 0, n)}
+		switch eventType {
+		case wireEventTypeMetric:
+			for i := 0; i < n && r.err == nil; i++ {
+				res.group.Events = append(res.group.Events, decodeWireMetric(r))
+			}
+		case wireEventTypeSpan:
+			for i := 0; i < n && r.err == nil; i++ {
+				res.group.Events = append(res.group.Events, decodeWireSpan(r, tags))
+			}
+		default:
+			return nil, fmt.Errorf("unsupported event type %d", eventType)
+		}
+	}
+	if r.err != nil {
+		return nil, r.err
+	}
+	if r.pos != len(buf) {
+		return nil, fmt.Errorf("%d trailing bytes in event group", len(buf)-r.pos)
+	}
+	return res, nil
+}
+
+// decodeWireLogGroup appends group tags to LogTags in the order they are written, as sls_logs::LogGroup does.
+func decodeWireLogGroup(r *eventGroupWireReader) *protocol.LogGroup {
+	logGroup := &protocol.LogGroup{}
+	n := r.count(8)
+	logGroup.LogTags = make([]*protocol.LogTag, 0, n)
+	for i := 0; i < n && r.err == nil; i++ {
+		key := r.str()
+		value := r.str()
+		if key == logTopicTagKey {
+			logGroup.Topic = value
+		} else {
+			logGroup.LogTags = append(logGroup.LogTags, &protocol.LogTag{Key: key, Value: value})
+		}
+	}
+	n = r.count(1)
+	logGroup.Logs = make([]*protocol.Log, 0, n)
+	for i := 0; i < n && r.err == nil; i++ {
+		sec, ns, hasNs := r.timestamp()
+		log := &protocol.Log{Time: uint32(sec)}
+		if hasNs {
+			log.TimeNs = &ns
+		}
+		// level, offset and raw size are not carried by sls_logs::Log
+		r.str()
+		r.u64()
+		r.u64()
+		cnt := r.count(8)
+		log.Contents = make([]*protocol.Log_Content, 0, cnt)
+		for j := 0; j < cnt && r.err == nil; j++ {
+			key := r.str()
+			log.Contents = append(log.Contents, &protocol.Log_Content{Key: key, Value: r.str()})
+		}
+		logGroup.Logs = append(logGroup.Logs, log)
+	}
+	return logGroup
+}
+
+func decodeWireMetric(r *eventGroupWireReader) models.PipelineEvent {
+	sec, ns, _ := r.timestamp()
+	timestamp := sec*1e9 + int64(ns)
+	name := r.str()
+	tags := r.tags()
+	switch r.u8() {
+	case wireValueTypeSingle:
+		return models.NewSingleValueMetric(name, models.MetricTypeUntyped, tags, timestamp, r.f64())
+	case wireValueTypeMulti:
+		n := r.count(12)
+		values := models.NewMetricMultiValue()
+		for i := 0; i < n && r.err == nil; i++ {
+			key := r.str()
+			values.Add(key, r.f64())
+		}
+		return models.NewMultiValuesMetric(name, models.MetricTypeUntyped, tags, timestamp, values.GetMultiValues())
+	case wireValueTypeHistogram:
+		values := models.NewMetricMultiValue()
+		values.Add(otlp.FieldSum, r.f64())
+		values.Add(otlp.FieldCount, r.f64())
+		// buckets are cumulative in C++, while each field holds the count of a single bucket in Go
+		n := r.count(16)
+		lowerBound, lowerCount := math.Inf(-1), 0.0
+		for i := 0; i < n && r.err == nil; i++ {
+			upperBound, count := r.f64(), r.f64()
+			values.Add(otlp.ComposeBucketFieldName(lowerBound, upperBound, true), count-lowerCount)
+			lowerBound, lowerCount = upperBound, count
+		}
+		return models.NewMultiValuesMetric(name, models.MetricTypeHistogram, tags, timestamp, values.GetMultiValues())
+	case wireValueTypeSummary:
+		values := models.NewMetricMultiValue()
+		values.Add(otlp.FieldSum, r.f64())
+		values.Add(otlp.FieldCount, r.f64())
+		n := r.count(16)
+		for i := 0; i < n && r.err == nil; i++ {
+			quantile := r.f64()
+			values.Add(strconv.FormatFloat(quantile, 'f', -1, 64), r.f64())
+		}
+		return models.NewMultiValuesMetric(name, models.MetricTypeSummary, tags, timestamp, values.GetMultiValues())
+	default:
+		return models.NewMultiValuesMetric(name, models.MetricTypeUntyped, tags, timestamp, models.NewMetricMultiValue().GetMultiValues())
+	}
+}
+
+// scope tags are merged into group tags, which is how the opentelemetry decoder keeps them.
+func decodeWireSpan(r *eventGroupWireReader, groupTags models.Tags) models.PipelineEvent {
+	sec, ns, _ := r.timestamp()
+	span := &models.Span{
+		TraceID:           r.str(),
+		SpanID:            r.str(),
+		TraceState:        r.str(),
+		ParentSpanID:      r.str(),
+		Name:              r.str(),
+		Kind:              models.SpanKind(r.u8()),
+		StartTime:         r.u64(),
+		EndTime:           r.u64(),
+		Status:            models.StatusCode(r.u8()),
+		ObservedTimestamp: uint64(sec*1e9 + int64(ns)),
+	}
+	span.Tags = r.tags()
+	for k, v := range r.tags().Iterator() {
+		if !groupTags.Contains(k) {
+			groupTags.Add(k, v)
+		}
+	}
+	n := r.count(16)
+	span.Events = make([]*models.SpanEvent, 0, n)
+	for i := 0; i < n && r.err == nil; i++ {
+		e := &models.SpanEvent{Timestamp: int64(r.u64()), Name: r.str()}
+		e.Tags = r.tags()
+		span.Events = append(span.Events, e)
+	}
+	n = r.count(16)
+	span.Links = make([]*models.SpanLink, 0, n)
+	for i := 0; i < n && r.err == nil; i++ {
+		link := &models.SpanLink{TraceID: r.str(), SpanID: r.str(), TraceState: r.str()}
+		link.Tags = r.tags()
+		span.Links = append(span.Links, link)
+	}
+	return span
+}
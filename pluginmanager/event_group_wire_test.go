@@ -0,0 +1,196 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package pluginmanager
+
+import (
+	"encoding/binary"
+	"math"
+	"testing"
+
+	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
+
+	"github.com/alibaba/ilogtail/pkg/models"
+)
+
+// wireBuilder writes the layout produced by core/go_pipeline/EventGroupWire.cpp.
+type wireBuilder struct {
+	buf []byte
+}
+
+func (b *wireBuilder) u8(v uint8) *wireBuilder {
+	b.buf = append(b.buf, v)
+	return b
+}
+
+func (b *wireBuilder) u32(v uint32) *wireBuilder {
+	b.buf = binary.LittleEndian.AppendUint32(b.buf, v)
+	return b
+}
+
+func (b *wireBuilder) u64(v uint64) *wireBuilder {
+	b.buf = binary.LittleEndian.AppendUint64(b.buf, v)
+	return b
+}
+
+func (b *wireBuilder) f64(v float64) *wireBuilder {
+	return b.u64(math.Float64bits(v))
+}
+
+func (b *wireBuilder) str(s string) *wireBuilder {
+	b.u32(uint32(len(s)))
+	b.buf = append(b.buf, s...)
+	return b
+}
+
+func (b *wireBuilder) kvs(kvs ...string) *wireBuilder {
+	b.u32(uint32(len(kvs) / 2))
+	for _, s := range kvs {
+		b.str(s)
+	}
+	return b
+}
+
+func (b *wireBuilder) header(eventType uint8, eventCnt uint32) *wireBuilder {
+	b.buf = append(b.buf, eventGroupWireMagic...)
+	return b.u8(eventType).kvs("source_id", "source").kvs("__topic__", "topic", "tag_key", "tag_value").u32(eventCnt)
+}
+
+func TestDecodeEventGroupWire_Log(t *testing.T) {
+	b := &wireBuilder{}
+	b.header(wireEventTypeLog, 2)
+	b.u64(1729000000).u32(123).u8(1).str("INFO").u64(100).u64(20).kvs("content", "first", "key", "value")
+	b.u64(1729000001).u32(0).u8(0).str("").u64(0).u64(0).kvs("content", "second")
+
+	res, err := decodeEventGroupWire(b.buf)
+	require.NoError(t, err)
+	require.Nil(t, res.group)
+	logGroup := res.logGroup
+	assert.Equal(t, "topic", logGroup.Topic)
+	require.Len(t, logGroup.LogTags, 1)
+	assert.Equal(t, "tag_key", logGroup.LogTags[0].Key)
+	assert.Equal(t, "tag_value", logGroup.LogTags[0].Value)
+	require.Len(t, logGroup.Logs, 2)
+	assert.Equal(t, uint32(1729000000), logGroup.Logs[0].Time)
+	require.NotNil(t, logGroup.Logs[0].TimeNs)
+	assert.Equal(t, uint32(123), *logGroup.Logs[0].TimeNs)
+	require.Len(t, logGroup.Logs[0].Contents, 2)
+	assert.Equal(t, "content", logGroup.Logs[0].Contents[0].Key)
+	assert.Equal(t, "first", logGroup.Logs[0].Contents[0].Value)
+	assert.Equal(t, "value", logGroup.Logs[0].Contents[1].Value)
+	assert.Nil(t, logGroup.Logs[1].TimeNs)
+	assert.Equal(t, "second", logGroup.Logs[1].Contents[0].Value)
+}
+
+func TestDecodeEventGroupWire_LogTagOrder(t *testing.T) {
+	b := &wireBuilder{}
+	b.buf = append(b.buf, eventGroupWireMagic...)
+	b.u8(wireEventTypeLog).kvs().kvs("k3", "v3", "k1", "v1", "__topic__", "topic", "k2", "v2", "k0", "v0").u32(0)
+
+	for i := 0; i < 10; i++ {
+		res, err := decodeEventGroupWire(b.buf)
+		require.NoError(t, err)
+		logGroup := res.logGroup
+		assert.Equal(t, "topic", logGroup.Topic)
+		require.Len(t, logGroup.LogTags, 4)
+		for j, key := range []string{"k3", "k1", "k2", "k0"} {
+			assert.Equal(t, key, logGroup.LogTags[j].Key)
+			assert.Equal(t, "v"+key[1:], logGroup.LogTags[j].Value)
+		}
+	}
+}
+
+func TestDecodeEventGroupWire_Metric(t *testing.T) {
+	b := &wireBuilder{}
+	b.header(wireEventTypeMetric, 3)
+	b.u64(1729000000).u32(5).u8(1).str("single").kvs("host", "a").u8(wireValueTypeSingle).f64(1.5)
+	b.u64(1729000000).u32(0).u8(0).str("histogram").kvs().u8(wireValueTypeHistogram).f64(30).f64(6)
+	b.u32(2).f64(1).f64(2).f64(10).f64(6)
+	b.u64(1729000000).u32(0).u8(0).str("summary").kvs().u8(wireValueTypeSummary).f64(30).f64(6)
+	b.u32(1).f64(0.5).f64(4)
+
+	res, err := decodeEventGroupWire(b.buf)
+	require.NoError(t, err)
+	require.Nil(t, res.logGroup)
+	assert.Equal(t, "source", res.group.Group.Metadata.Get("source_id"))
+	assert.Equal(t, "tag_value", res.group.Group.Tags.Get("tag_key"))
+	require.Len(t, res.group.Events, 3)
+
+	single := res.group.Events[0].(*models.Metric)
+	assert.Equal(t, "single", single.Name)
+	assert.Equal(t, uint64(1729000000*1e9+5), single.Timestamp)
+	assert.Equal(t, "a", single.Tags.Get("host"))
+	assert.Equal(t, 1.5, single.Value.GetSingleValue())
+
+	histogram := res.group.Events[1].(*models.Metric)
+	assert.Equal(t, models.MetricTypeHistogram, histogram.MetricType)
+	values := histogram.Value.GetMultiValues()
+	assert.Equal(t, 30.0, values.Get("sum"))
+	assert.Equal(t, 6.0, values.Get("count"))
+	assert.Equal(t, 2.0, values.Get("(-Inf,1]"))
+	assert.Equal(t, 4.0, values.Get("(1,10]"))
+
+	summary := res.group.Events[2].(*models.Metric)
+	assert.Equal(t, models.MetricTypeSummary, summary.MetricType)
+	assert.Equal(t, 4.0, summary.Value.GetMultiValues().Get("0.5"))
+}
+
+func TestDecodeEventGroupWire_Span(t *testing.T) {
+	b := &wireBuilder{}
+	b.header(wireEventTypeSpan, 1)
+	b.u64(1729000000).u32(0).u8(0)
+	b.str("trace").str("span").str("state").str("parent").str("name").u8(uint8(models.SpanKindServer))
+	b.u64(100).u64(200).u8(uint8(models.StatusCodeError))
+	b.kvs("key", "value").kvs("otlp.scope.name", "scope")
+	b.u32(1).u64(150).str("event").kvs("event_key", "event_value")
+	b.u32(1).str("link_trace").str("link_span").str("link_state").kvs()
+
+	res, err := decodeEventGroupWire(b.buf)
+	require.NoError(t, err)
+	require.Len(t, res.group.Events, 1)
+	assert.Equal(t, "scope", res.group.Group.Tags.Get("otlp.scope.name"))
+	span := res.group.Events[0].(*models.Span)
+	assert.Equal(t, "trace", span.TraceID)
+	assert.Equal(t, "span", span.SpanID)
+	assert.Equal(t, "state", span.TraceState)
+	assert.Equal(t, "parent", span.ParentSpanID)
+	assert.Equal(t, "name", span.Name)
+	assert.Equal(t, models.SpanKindServer, span.Kind)
+	assert.Equal(t, uint64(100), span.StartTime)
+	assert.Equal(t, uint64(200), span.EndTime)
+	assert.Equal(t, models.StatusCodeError, span.Status)
+	assert.Equal(t, "value", span.Tags.Get("key"))
+	require.Len(t, span.Events, 1)
+	assert.Equal(t, int64(150), span.Events[0].Timestamp)
+	assert.Equal(t, "event_value", span.Events[0].Tags.Get("event_key"))
+	require.Len(t, span.Links, 1)
+	assert.Equal(t, "link_span", span.Links[0].SpanID)
+}
+
+func TestDecodeEventGroupWire_Invalid(t *testing.T) {
+	_, err := decodeEventGroupWire([]byte("LEG"))
+	assert.Error(t, err)
+
+	b := &wireBuilder{}
+	b.header(wireEventTypeLog, 1)
+	b.u64(1729000000).u32(0).u8(0).str("").u64(0).u64(0).kvs("content", "value")
+	_, err = decodeEventGroupWire(b.buf[:len(b.buf)-1])
+	assert.Error(t, err)
+
+	b = &wireBuilder{}
+	b.header(wireEventTypeLog, 0xFFFFFFFF)
+	_, err = decodeEventGroupWire(b.buf)
+	assert.Error(t, err)
+}
@@ -297,6 +297,30 @@ func (lc *LogstoreConfig) ProcessLogGroup(logByte []byte, packID string) int {
 	return 0
 }
 
+// ProcessEventGroup receives a flat event group serialized by core, see event_group_wire.go.
+// data is owned by core and freed once the call returns, so it is copied once here and all strings of the decoded
+// events reference the copy.
+func (lc *LogstoreConfig) ProcessEventGroup(data []byte, packID string) int {
+	buf := make([]byte, len(data))
+	copy(buf, data)
+	res, err := decodeEventGroupWire(buf)
+	if err != nil {
+		logger.Error(lc.Context.GetRuntimeContext(), "WRONG_PROTOBUF_ALARM",
+			"cannot process event group passed by core, err", err)
+		return -1
+	}
+	if res.logGroup != nil {
+		lc.PluginRunner.ReceiveLogGroup(pipeline.LogGroupWithContext{
+			LogGroup: res.logGroup,
+			Context:  map[string]interface{}{ctxKeySource: packID}},
+		)
+		return 0
+	}
+	res.group.Group.Metadata.Add(ctxKeySource, packID)
+	lc.PluginRunner.ReceiveEventGroup(res.group)
+	return 0
+}
+
 func hasDockerStdoutInput(plugins map[string]interface{}) bool {
 	inputs, exists := plugins["inputs"]
 	if !exists {
@@ -15,6 +15,7 @@
 package pluginmanager
 
 import (
+	"github.com/alibaba/ilogtail/pkg/models"
 	"github.com/alibaba/ilogtail/pkg/pipeline"
 )
 
@@ -48,6 +49,9 @@ type PluginRunner interface {
 
 	ReceiveLogGroup(logGroup pipeline.LogGroupWithContext)
 
+	// ReceiveEventGroup receives non-log event groups passed by core.
+	ReceiveEventGroup(group *models.PipelineGroupEvents)
+
 	AddPlugin(pluginMeta *pipeline.PluginMeta, category pluginCategory, plugin interface{}, config map[string]interface{}) error
 
 	GetExtension(name string) (pipeline.Extension, bool)
@@ -20,6 +20,7 @@ import (
 	"github.com/alibaba/ilogtail/pkg/flags"
 	"github.com/alibaba/ilogtail/pkg/helper"
 	"github.com/alibaba/ilogtail/pkg/logger"
+	"github.com/alibaba/ilogtail/pkg/models"
 	"github.com/alibaba/ilogtail/pkg/pipeline"
 	"github.com/alibaba/ilogtail/pkg/protocol"
 	"github.com/alibaba/ilogtail/pkg/util"
@@ -466,6 +467,10 @@ func (p *pluginv1Runner) ReceiveLogGroup(logGroup pipeline.LogGroupWithContext)
 	}
 }
 
+func (p *pluginv1Runner) ReceiveEventGroup(group *models.PipelineGroupEvents) {
+	logger.Warningf(p.LogstoreConfig.Context.GetRuntimeContext(), "RECEIVE_EVENT_GROUP_ALARM", "pipeline v1 only accepts logs, %d events are discarded", len(group.Events))
+}
+
 func (p *pluginv1Runner) Merge(r PluginRunner) {
 	if other, ok := r.(*pluginv1Runner); ok {
 		p.FlushOutStore.Merge(other.FlushOutStore)